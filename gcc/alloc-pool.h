@@ -370,6 +370,7 @@ base_pool_allocator <TBlockAllocator>::allocate ()
 
 	  /* Make the block.  */
 	  block = reinterpret_cast<char *> (TBlockAllocator::allocate ());
+	  mem_profile_alloc (MEM_PROFILE_POOL, TBlockAllocator::block_size);
 	  block_header = new (block) allocation_pool_list;
 	  block += align_eight (sizeof (allocation_pool_list));
 
@@ -42,6 +42,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "alias.h"
 #include "fold-const.h"
 #include "cfganal.h"
+#include "tree-eh.h"
 #include "gimplify.h"
 #include "gimple-iterator.h"
 #include "varasm.h"
@@ -1738,6 +1739,33 @@ maybe_cast_to_ptrmode (location_t loc, tree len, gimple_stmt_iterator *iter,
   return gimple_assign_lhs (g);
 }
 
+/* Return true if an access of SIZE_IN_BYTES bytes whose address is
+   aligned to ALIGN bits (or 0 if unknown) can be checked by looking at
+   a single shadow memory location.  */
+
+static bool
+asan_scalar_access_size_p (HOST_WIDE_INT size_in_bytes, unsigned int align)
+{
+  if (size_in_bytes <= 1)
+    return true;
+  if ((size_in_bytes & (size_in_bytes - 1)) != 0
+      || size_in_bytes > 16)
+    return false;
+  if (align && align < size_in_bytes * BITS_PER_UNIT)
+    {
+      /* On non-strict alignment targets, if
+	 16-byte access is just 8-byte aligned,
+	 this will result in misaligned shadow
+	 memory 2 byte load, but otherwise can
+	 be handled using one read.  */
+      if (size_in_bytes != 16
+	  || STRICT_ALIGNMENT
+	  || align < 8 * BITS_PER_UNIT)
+	return false;
+    }
+  return true;
+}
+
 /* Instrument the memory access instruction BASE.  Insert new
    statements before or after ITER.
 
@@ -1755,16 +1783,18 @@ maybe_cast_to_ptrmode (location_t loc, tree len, gimple_stmt_iterator *iter,
 
    If BEFORE_P is TRUE, *ITER is arranged to still point to the
    statement it was pointing to prior to calling this function,
-   otherwise, it points to the statement logically following it.  */
+   otherwise, it points to the statement logically following it.
 
-static void
+   Return the ASAN_CHECK call that was built.  */
+
+static gcall *
 build_check_stmt (location_t loc, tree base, tree len,
 		  HOST_WIDE_INT size_in_bytes, gimple_stmt_iterator *iter,
 		  bool is_non_zero_len, bool before_p, bool is_store,
 		  bool is_scalar_access, unsigned int align = 0)
 {
   gimple_stmt_iterator gsi = *iter;
-  gimple *g;
+  gcall *g;
 
   gcc_assert (!(size_in_bytes > 0 && !is_non_zero_len));
 
@@ -1784,24 +1814,8 @@ build_check_stmt (location_t loc, tree base, tree len,
       len = build_int_cst (pointer_sized_int_node, size_in_bytes);
     }
 
-  if (size_in_bytes > 1)
-    {
-      if ((size_in_bytes & (size_in_bytes - 1)) != 0
-	  || size_in_bytes > 16)
-	is_scalar_access = false;
-      else if (align && align < size_in_bytes * BITS_PER_UNIT)
-	{
-	  /* On non-strict alignment targets, if
-	     16-byte access is just 8-byte aligned,
-	     this will result in misaligned shadow
-	     memory 2 byte load, but otherwise can
-	     be handled using one read.  */
-	  if (size_in_bytes != 16
-	      || STRICT_ALIGNMENT
-	      || align < 8 * BITS_PER_UNIT)
-	    is_scalar_access = false;
-	}
-    }
+  if (!asan_scalar_access_size_p (size_in_bytes, align))
+    is_scalar_access = false;
 
   HOST_WIDE_INT flags = 0;
   if (is_store)
@@ -1825,6 +1839,100 @@ build_check_stmt (location_t loc, tree base, tree len,
       gsi_next (&gsi);
       *iter = gsi;
     }
+  return g;
+}
+
+/* The ASAN_CHECK most recently built by instrument_derefs in the
+   current basic block, as long as every statement seen since then is
+   known to fall through to the next one.  A later access of the same
+   kind that overlaps or is adjacent to the checked bytes is then
+   certainly executed whenever the check is, so it can be folded into
+   the check by widening it instead of getting a check of its own.  */
+
+struct asan_last_check
+{
+  /* The ASAN_CHECK call, or NULL if there is no candidate.  */
+  gcall *check;
+  /* The object (or the pointer to it) and the variable offset the
+     checked bytes are relative to.  */
+  tree base, offset;
+  /* The checked bytes, [START, END) relative to BASE and OFFSET.  */
+  HOST_WIDE_INT start, end;
+  /* Alignment in bits of the byte at START.  */
+  unsigned int align;
+  bool is_store;
+};
+
+static asan_last_check last_check;
+
+/* Try to fold the check of the access of SIZE_IN_BYTES bytes at byte
+   offset START from BASE and OFFSET, whose address is aligned to ALIGN
+   bits, into LAST_CHECK.  Return true on success.  */
+
+static bool
+maybe_merge_with_last_check (gimple_stmt_iterator *iter, tree base,
+			     tree offset, HOST_WIDE_INT start,
+			     HOST_WIDE_INT size_in_bytes, unsigned int align,
+			     bool is_store)
+{
+  gcall *g = last_check.check;
+  if (!ASAN_MERGE_CHECKS
+      || g == NULL
+      || gimple_bb (g) != gsi_bb (*iter)
+      || last_check.is_store != is_store
+      || !operand_equal_p (last_check.base, base, 0)
+      || (last_check.offset == NULL_TREE) != (offset == NULL_TREE)
+      || (offset && !operand_equal_p (last_check.offset, offset, 0)))
+    return false;
+
+  /* Never check bytes that are not accessed.  */
+  HOST_WIDE_INT end = start + size_in_bytes;
+  if (start > last_check.end || end < last_check.start)
+    return false;
+
+  HOST_WIDE_INT new_start = MIN (start, last_check.start);
+  HOST_WIDE_INT new_end = MAX (end, last_check.end);
+  unsigned int new_align
+    = new_start == last_check.start ? last_check.align : align;
+
+  /* Unless it is a scalar access, the merged check only tests the shadow
+     of its first and last byte, so it must not span more than two shadow
+     granules.  */
+  HOST_WIDE_INT granule = ASAN_SHADOW_GRANULARITY;
+  if (new_end - new_start
+      > granule + MIN ((HOST_WIDE_INT) (new_align / BITS_PER_UNIT), granule))
+    return false;
+
+  if (new_start != last_check.start)
+    {
+      tree ptr = gimple_call_arg (g, 1);
+      gimple_stmt_iterator gsi = gsi_for_stmt (g);
+      gimple *a
+	= gimple_build_assign (make_ssa_name (TREE_TYPE (ptr)),
+			       POINTER_PLUS_EXPR, ptr,
+			       build_int_cst (sizetype,
+					      new_start - last_check.start));
+      gimple_set_location (a, gimple_location (g));
+      gsi_insert_before (&gsi, a, GSI_SAME_STMT);
+      gimple_call_set_arg (g, 1, gimple_assign_lhs (a));
+    }
+
+  HOST_WIDE_INT flags = ASAN_CHECK_NON_ZERO_LEN;
+  if (is_store)
+    flags |= ASAN_CHECK_STORE;
+  if (asan_scalar_access_size_p (new_end - new_start, new_align))
+    flags |= ASAN_CHECK_SCALAR_ACCESS;
+  gimple_call_set_arg (g, 0, build_int_cst (integer_type_node, flags));
+  gimple_call_set_arg (g, 2, build_int_cst (pointer_sized_int_node,
+					    new_end - new_start));
+  gimple_call_set_arg (g, 3, build_int_cst (integer_type_node,
+					    new_align / BITS_PER_UNIT));
+  update_stmt (g);
+
+  last_check.start = new_start;
+  last_check.end = new_end;
+  last_check.align = new_align;
+  return true;
 }
 
 /* If T represents a memory access, add instrumentation code before ITER.
@@ -1917,13 +2025,39 @@ instrument_derefs (gimple_stmt_iterator *iter, tree t,
 	}
     }
 
+  /* Describe the access relative to the pointer rather than to the
+     MEM_REF, so that accesses at different constant offsets from the
+     same pointer can be merged.  */
+  HOST_WIDE_INT bytepos = bitpos / BITS_PER_UNIT;
+  if (TREE_CODE (inner) == MEM_REF)
+    {
+      offset_int moff = mem_ref_offset (inner) + bytepos;
+      if (wi::fits_shwi_p (moff))
+	{
+	  inner = TREE_OPERAND (inner, 0);
+	  bytepos = moff.to_shwi ();
+	}
+    }
+
   base = build_fold_addr_expr (t);
   if (!has_mem_ref_been_instrumented (base, size_in_bytes))
     {
       unsigned int align = get_object_alignment (t);
-      build_check_stmt (location, base, NULL_TREE, size_in_bytes, iter,
-			/*is_non_zero_len*/size_in_bytes > 0, /*before_p=*/true,
-			is_store, /*is_scalar_access*/true, align);
+      if (!maybe_merge_with_last_check (iter, inner, offset, bytepos,
+					size_in_bytes, align, is_store))
+	{
+	  last_check.check
+	    = build_check_stmt (location, base, NULL_TREE, size_in_bytes,
+				iter, /*is_non_zero_len*/size_in_bytes > 0,
+				/*before_p=*/true, is_store,
+				/*is_scalar_access*/true, align);
+	  last_check.base = inner;
+	  last_check.offset = offset;
+	  last_check.start = bytepos;
+	  last_check.end = bytepos + size_in_bytes;
+	  last_check.align = align;
+	  last_check.is_store = is_store;
+	}
       update_mem_ref_hash_table (base, size_in_bytes);
       update_mem_ref_hash_table (t, size_in_bytes);
     }
@@ -2195,6 +2329,7 @@ transform_statements (void)
       if (prev_bb != last_bb)
 	empty_mem_ref_hash_table ();
       last_bb = bb;
+      last_check.check = NULL;
 
       for (i = gsi_start_bb (bb); !gsi_end_p (i);)
 	{
@@ -2226,8 +2361,16 @@ transform_statements (void)
 
 	      gsi_next (&i);
 	    }
+
+	  /* Accesses after a statement that might not fall through to
+	     the next one must not be merged into checks before it.  */
+	  if (is_gimple_call (s)
+	      || gimple_code (s) == GIMPLE_ASM
+	      || stmt_could_throw_p (s))
+	    last_check.check = NULL;
 	}
     }
+  last_check.check = NULL;
   free_mem_ref_resources ();
 }
 
@@ -2867,6 +3010,7 @@ asan_expand_check_ifn (gimple_stmt_iterator *iter, bool use_calls)
   bool is_scalar_access = (flags & ASAN_CHECK_SCALAR_ACCESS) != 0;
   bool is_store = (flags & ASAN_CHECK_STORE) != 0;
   bool is_non_zero_len = (flags & ASAN_CHECK_NON_ZERO_LEN) != 0;
+  bool is_range = (flags & ASAN_CHECK_RANGE) != 0;
 
   tree base = gimple_call_arg (g, 1);
   tree len = gimple_call_arg (g, 2);
@@ -2875,7 +3019,10 @@ asan_expand_check_ifn (gimple_stmt_iterator *iter, bool use_calls)
   HOST_WIDE_INT size_in_bytes
     = is_scalar_access && tree_fits_shwi_p (len) ? tree_to_shwi (len) : -1;
 
-  if (use_calls)
+  /* The inline sequence below only tests the first and the last byte of
+     a region, so ranges standing for many accesses always use the
+     callbacks, which test all of it.  */
+  if (use_calls || is_range)
     {
       /* Instrument using callbacks.  */
       gimple *g = gimple_build_assign (make_ssa_name (pointer_sized_int_node),
@@ -71,7 +71,11 @@ enum asan_check_flags
   ASAN_CHECK_STORE = 1 << 0,
   ASAN_CHECK_SCALAR_ACCESS = 1 << 1,
   ASAN_CHECK_NON_ZERO_LEN = 1 << 2,
-  ASAN_CHECK_LAST = 1 << 3
+  /* The check stands for a whole range of accesses, e.g. all iterations
+     of a loop, and is always expanded to a call that checks every byte
+     of it.  */
+  ASAN_CHECK_RANGE = 1 << 3,
+  ASAN_CHECK_LAST = 1 << 4
 };
 
 /* Flags for Asan check builtins.  */
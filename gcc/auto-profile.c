@@ -21,6 +21,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "config.h"
 #define INCLUDE_MAP
 #define INCLUDE_SET
+#define INCLUDE_VECTOR
 #include "system.h"
 #include "coretypes.h"
 #include "backend.h"
@@ -49,6 +50,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "auto-profile.h"
 #include "tree-pretty-print.h"
 #include "gimple-pretty-print.h"
+#include "backtrace.h"
 
 /* The following routines implements AutoFDO optimization.
 
@@ -88,6 +90,15 @@ along with GCC; see the file COPYING3.  If not see
         * Annotate basic block count
         * Estimate branch probability
 
+   The profile data file is either the gcov-like file produced by the
+   create_gcov tool, or a perf.data file recorded by "perf record".  In the
+   latter case the sampled addresses are symbolized directly from the debug
+   info of the profiled executable.  When the samples carry Last Branch
+   Records (perf record -b), each pair of consecutive branches delimits an
+   address range executed exactly once, which gives per-line execution
+   counts much more precise than the raw sample IPs, and the taken calls
+   give the entry counts of functions and the targets of indirect calls.
+
    After the above 3 phases, all profile is readily annotated on the GCC IR.
    AutoFDO tries to reuse all FDO infrastructure as much as possible to make
    use of the profile. E.g. it uses existing mechanism to calculate the basic
@@ -97,6 +108,14 @@ along with GCC; see the file COPYING3.  If not see
 #define DEFAULT_AUTO_PROFILE_FILE "fbdata.afdo"
 #define AUTO_PROFILE_VERSION 1
 
+/* Magic at the start of a perf.data file.  */
+#define PERF_FILE_MAGIC "PERFILE2"
+
+/* The longest address range, in bytes, executed between two branch records
+   that is attributed to source lines.  Longer ranges are bogus, e.g. they
+   span an interrupt.  */
+#define PERF_MAX_RANGE_LENGTH 4096
+
 namespace autofdo
 {
 
@@ -106,6 +125,11 @@ typedef std::pair<tree, unsigned> decl_lineno;
 /* Represent an inline stack. vector[0] is the leaf node.  */
 typedef auto_vec<decl_lineno> inline_stack;
 
+/* Represent an inline stack of a sampled address in a perf.data file:
+   pairs of (function name index in string_table, combined location).
+   vector[0] is the leaf node.  */
+typedef std::vector<std::pair<unsigned, unsigned> > name_inline_stack;
+
 /* String array that stores function names.  */
 typedef auto_vec<char *> string_vector;
 
@@ -161,6 +185,9 @@ public:
   /* For a given index, returns the string.  */
   const char *get_name (int index) const;
 
+  /* Return the index of NAME, adding it to the table if needed.  */
+  unsigned add_name (const char *name);
+
   /* Read profile, return TRUE on success.  */
   bool read ();
 
@@ -228,7 +255,37 @@ public:
   /* Mark LOC as annotated.  */
   void mark_annotated (location_t loc);
 
+  /* Return the function_instance inlined at callsite OFFSET with callee
+     NAME, creating an empty one if needed.  */
+  function_instance *get_or_create_callsite (unsigned offset, unsigned name);
+
+  /* Add COUNT samples at location OFFSET.  */
+  void add_pos_count (unsigned offset, gcov_type count);
+
+  /* Add COUNT calls of TARGET to the indirect call at location OFFSET.  */
+  void add_icall_target (unsigned offset, unsigned target, gcov_type count);
+
+  /* Add COUNT to the total count.  */
+  void
+  add_total_count (gcov_type count)
+  {
+    total_count_ += count;
+  }
+
+  /* Add COUNT to the entry basic block count.  */
+  void
+  add_head_count (gcov_type count)
+  {
+    head_count_ += count;
+  }
+
+  /* Add the position counts of this instance and of its callsites to the
+     histogram of SUMMARY.  */
+  void add_to_histogram (gcov_ctr_summary *summary) const;
+
 private:
+  friend class autofdo_source_profile;
+
   /* Callsite, represented as (decl_lineno, callee_function_name_index).  */
   typedef std::pair<unsigned, unsigned> callsite;
 
@@ -274,6 +331,18 @@ public:
     return NULL;
   }
 
+  /* Create the profile from the perf.data file FILENAME.  */
+  static autofdo_source_profile *
+  create_from_perf_data (const char *filename)
+  {
+    autofdo_source_profile *map = new autofdo_source_profile ();
+
+    if (map->read_perf_data (filename))
+      return map;
+    delete map;
+    return NULL;
+  }
+
   ~autofdo_source_profile ();
 
   /* For a given DECL, returns the top-level function_instance.  */
@@ -303,6 +372,18 @@ private:
   /* Read AutoFDO profile and returns TRUE on success.  */
   bool read ();
 
+  /* Read the perf.data file FILENAME and returns TRUE on success.  */
+  bool read_perf_data (const char *filename);
+
+  /* Return the top-level function_instance of NAME, creating an empty one
+     if needed.  */
+  function_instance *get_or_create_function_instance (unsigned name);
+
+  /* Add COUNT samples at the inline STACK and return the leaf
+     function_instance.  */
+  function_instance *add_perf_count (const name_inline_stack &stack,
+				     gcov_type count);
+
   /* Return the function_instance in the profile that correspond to the
      inline STACK.  */
   function_instance *
@@ -320,6 +401,11 @@ static autofdo_source_profile *afdo_source_profile;
 /* gcov_ctr_summary structure to store the profile_info.  */
 static struct gcov_ctr_summary *afdo_profile_info;
 
+/* True if the profile was read from a perf.data file.  Its line numbers
+   are then absolute, as the debug info does not record the start line of
+   the functions.  */
+static bool afdo_absolute_lines;
+
 /* Helper functions.  */
 
 /* Return the original name of NAME: strip the suffix that starts
@@ -342,10 +428,13 @@ get_original_name (const char *name)
 static unsigned
 get_combined_location (location_t loc, tree decl)
 {
+  unsigned offset = LOCATION_LINE (loc);
+  if (!afdo_absolute_lines)
+    offset -= DECL_SOURCE_LINE (decl);
   /* TODO: allow more bits for line and less bits for discriminator.  */
-  if (LOCATION_LINE (loc) - DECL_SOURCE_LINE (decl) >= (1<<16))
+  if (offset >= (1<<16))
     warning_at (loc, OPT_Woverflow, "Offset exceeds 16 bytes.");
-  return ((LOCATION_LINE (loc) - DECL_SOURCE_LINE (decl)) << 16);
+  return offset << 16;
 }
 
 /* Return the function decl of a given lexical BLOCK.  */
@@ -491,6 +580,23 @@ string_table::get_name (int index) const
   return vector_[index];
 }
 
+/* Return the index of NAME, adding it to the table if needed.  */
+
+unsigned
+string_table::add_name (const char *name)
+{
+  char *original = get_original_name (name);
+  string_index_map::const_iterator iter = map_.find (original);
+  if (iter != map_.end ())
+    {
+      free (original);
+      return iter->second;
+    }
+  vector_.safe_push (original);
+  map_[original] = vector_.length () - 1;
+  return vector_.length () - 1;
+}
+
 /* Read the string table. Return TRUE if reading is successful.  */
 
 bool
@@ -602,6 +708,61 @@ function_instance::find_icall_target_map (gcall *stmt,
   return ret;
 }
 
+/* Return the function_instance inlined at callsite OFFSET with callee
+   NAME, creating an empty one if needed.  */
+
+function_instance *
+function_instance::get_or_create_callsite (unsigned offset, unsigned name)
+{
+  function_instance *&callee = callsites[std::make_pair (offset, name)];
+  if (callee == NULL)
+    callee = new function_instance (name, 0);
+  return callee;
+}
+
+/* Add COUNT samples at location OFFSET.  */
+
+void
+function_instance::add_pos_count (unsigned offset, gcov_type count)
+{
+  pos_counts[offset].count += count;
+}
+
+/* Add COUNT calls of TARGET to the indirect call at location OFFSET.  */
+
+void
+function_instance::add_icall_target (unsigned offset, unsigned target,
+				     gcov_type count)
+{
+  pos_counts[offset].targets[target] += count;
+}
+
+/* Add the position counts of this instance and of its callsites to the
+   histogram of SUMMARY.  */
+
+void
+function_instance::add_to_histogram (gcov_ctr_summary *summary) const
+{
+  for (callsite_map::const_iterator iter = callsites.begin ();
+       iter != callsites.end (); ++iter)
+    iter->second->add_to_histogram (summary);
+  for (position_count_map::const_iterator iter = pos_counts.begin ();
+       iter != pos_counts.end (); ++iter)
+    {
+      gcov_type count = iter->second.count;
+      if (count == 0)
+	continue;
+      gcov_bucket_type *bucket
+	= &summary->histogram[gcov_histo_index (count)];
+      if (bucket->num_counters == 0 || count < bucket->min_value)
+	bucket->min_value = count;
+      bucket->num_counters++;
+      bucket->cum_value += count;
+      if (count > summary->run_max)
+	summary->run_max = count;
+    }
+}
+
 /* Read the profile and create a function_instance with head count as
    HEAD_COUNT. Recursively read callsites to create nested function_instances
    too. STACK is used to track the recursive creation process.  */
@@ -894,6 +1055,655 @@ autofdo_source_profile::get_function_instance_by_inline_stack (
   return s;
 }
 
+/* The perf.data definitions used below, from the perf_event ABI in
+   include/uapi/linux/perf_event.h and tools/perf/util/header.h of the
+   Linux sources.  The file is expected to be in the byte order of the
+   host.  */
+
+enum perf_data_constants
+{
+  /* Sample formats (perf_event_attr.sample_type).  */
+  PERF_SAMPLE_IP = 1U << 0,
+  PERF_SAMPLE_TID = 1U << 1,
+  PERF_SAMPLE_TIME = 1U << 2,
+  PERF_SAMPLE_ADDR = 1U << 3,
+  PERF_SAMPLE_READ = 1U << 4,
+  PERF_SAMPLE_CALLCHAIN = 1U << 5,
+  PERF_SAMPLE_ID = 1U << 6,
+  PERF_SAMPLE_CPU = 1U << 7,
+  PERF_SAMPLE_PERIOD = 1U << 8,
+  PERF_SAMPLE_STREAM_ID = 1U << 9,
+  PERF_SAMPLE_RAW = 1U << 10,
+  PERF_SAMPLE_BRANCH_STACK = 1U << 11,
+  PERF_SAMPLE_IDENTIFIER = 1U << 16,
+
+  /* Branch stack formats (perf_event_attr.branch_sample_type).  */
+  PERF_SAMPLE_BRANCH_HW_INDEX = 1U << 17,
+
+  /* Record types (perf_event_header.type).  */
+  PERF_RECORD_MMAP = 1,
+  PERF_RECORD_SAMPLE = 9,
+  PERF_RECORD_MMAP2 = 10,
+
+  /* Flags of the mapping records (perf_event_header.misc).  */
+  PERF_RECORD_MISC_MMAP_DATA = 1 << 13,
+
+  /* Type of a branch record, in bits 20-23 of its flags.  */
+  PERF_BR_IND_CALL = 5,
+
+  /* PROT_EXEC of the mapping records.  */
+  PERF_PROT_EXEC = 4,
+
+  /* Sizes and offsets in the file header and the records.  */
+  PERF_FILE_HEADER_SIZE = 104,
+  PERF_ATTR_SIZE_VER2 = 80,
+  PERF_BRANCH_ENTRY_SIZE = 24
+};
+
+/* An executable sampled in the perf.data file.  */
+
+struct perf_object
+{
+  /* Path of the executable, as recorded by perf.  */
+  char *filename;
+
+  /* libbacktrace state used to symbolize its addresses, or NULL if the
+     object cannot be symbolized.  */
+  struct backtrace_state *state;
+};
+
+/* An executable mapping recorded by a PERF_RECORD_MMAP or PERF_RECORD_MMAP2
+   event.  */
+
+struct perf_mapping
+{
+  unsigned pid;
+  uint64_t start;
+  uint64_t end;
+  perf_object *object;
+};
+
+/* A pair of addresses in OBJECT: either an address range [FROM, TO]
+   executed without taken branches, or a branch from FROM to TO with type
+   TYPE (0 if unknown).  */
+
+struct perf_address_pair
+{
+  perf_object *object;
+  uint64_t from;
+  uint64_t to;
+  unsigned type;
+
+  bool
+  operator< (const perf_address_pair &other) const
+  {
+    if (object != other.object)
+      return object < other.object;
+    if (from != other.from)
+      return from < other.from;
+    if (to != other.to)
+      return to < other.to;
+    return type < other.type;
+  }
+};
+
+/* Map from a perf_address_pair to its sample count.  */
+typedef std::map<perf_address_pair, gcov_type> perf_count_map;
+
+/* Reader of a perf.data file.  It aggregates the samples of the
+   executables the file refers to and symbolizes their addresses.  */
+
+class perf_data_reader
+{
+public:
+  perf_data_reader ()
+      : file_ (NULL), sample_type_ (0), branch_sample_type_ (0)
+  {
+  }
+
+  ~perf_data_reader ();
+
+  /* Read FILENAME and aggregate its samples, return TRUE on success.  */
+  bool read (const char *filename);
+
+  /* Store the inline stack of ADDR in OBJECT in STACK.  Return TRUE if
+     ADDR has line info.  */
+  bool get_inline_stack (perf_object *object, uint64_t addr,
+			 name_inline_stack *stack) const;
+
+  /* Return the name index of the function starting at ADDR in OBJECT, or
+     -1 if ADDR is not the start of a function.  */
+  int get_function_at (perf_object *object, uint64_t addr) const;
+
+  /* Accessors.  */
+  const perf_count_map &
+  ranges () const
+  {
+    return ranges_;
+  }
+  const perf_count_map &
+  branches () const
+  {
+    return branches_;
+  }
+
+private:
+  bool read_attrs (uint64_t offset, uint64_t size, uint64_t attr_size);
+  void read_mapping (const char *buf, unsigned size, unsigned misc,
+		     bool mmap2);
+  void read_sample (const char *buf, unsigned size);
+  perf_object *get_object (const char *filename);
+  perf_object *find_object (unsigned pid, uint64_t addr) const;
+
+  FILE *file_;
+  uint64_t sample_type_;
+  uint64_t branch_sample_type_;
+
+  /* The executable mappings, in the order they were recorded.  */
+  auto_vec<perf_mapping> mappings_;
+
+  /* The executables the mappings refer to.  */
+  auto_vec<perf_object *> objects_;
+
+  /* Counts of the address ranges executed without taken branches.
+     Without branch records, each sampled IP is a range of its own.  */
+  perf_count_map ranges_;
+
+  /* Counts of the taken branches.  */
+  perf_count_map branches_;
+};
+
+/* Return TRUE if FILENAME is a perf.data file.  */
+
+static bool
+perf_data_file_p (const char *filename)
+{
+  char magic[8];
+  FILE *file = fopen (filename, "rb");
+  if (file == NULL)
+    return false;
+  bool ret = (fread (magic, sizeof (magic), 1, file) == 1
+	      && memcmp (magic, PERF_FILE_MAGIC, sizeof (magic)) == 0);
+  fclose (file);
+  return ret;
+}
+
+/* Read the unsigned integer of SIZE bytes at *POS of the record BUF of
+   LENGTH bytes into *VAL and advance *POS.  Return FALSE if the record is
+   too short.  */
+
+static bool
+perf_read_field (const char *buf, unsigned length, unsigned *pos,
+		 unsigned size, uint64_t *val)
+{
+  if (*pos + size > length)
+    return false;
+  if (size == 4)
+    {
+      uint32_t val32;
+      memcpy (&val32, buf + *pos, 4);
+      *val = val32;
+    }
+  else
+    memcpy (val, buf + *pos, 8);
+  *pos += size;
+  return true;
+}
+
+/* Error callback of libbacktrace.  Objects without debug info are simply
+   not annotated.  */
+
+static void
+perf_backtrace_error (void *, const char *, int)
+{
+}
+
+perf_data_reader::~perf_data_reader ()
+{
+  if (file_ != NULL)
+    fclose (file_);
+  for (unsigned i = 0; i < objects_.length (); i++)
+    {
+      free (objects_[i]->filename);
+      delete objects_[i];
+    }
+}
+
+/* Read the ATTR_SIZE bytes entries of the attribute section at OFFSET of
+   SIZE bytes.  All the events must share the same sample format.  Return
+   TRUE on success.  */
+
+bool
+perf_data_reader::read_attrs (uint64_t offset, uint64_t size,
+			      uint64_t attr_size)
+{
+  if (attr_size < PERF_ATTR_SIZE_VER2 || size < attr_size)
+    return false;
+
+  char attr[PERF_ATTR_SIZE_VER2];
+  for (uint64_t i = 0; i < size / attr_size; i++)
+    {
+      if (fseek (file_, offset + i * attr_size, SEEK_SET) != 0
+	  || fread (attr, sizeof (attr), 1, file_) != 1)
+	return false;
+
+      uint64_t sample_type, branch_sample_type = 0;
+      uint32_t attr_len;
+      memcpy (&attr_len, attr + 4, 4);
+      memcpy (&sample_type, attr + 24, 8);
+      if (attr_len >= PERF_ATTR_SIZE_VER2)
+	memcpy (&branch_sample_type, attr + 72, 8);
+      if (i == 0)
+	{
+	  sample_type_ = sample_type;
+	  branch_sample_type_ = branch_sample_type;
+	}
+      else if (sample_type != sample_type_
+	       || branch_sample_type != branch_sample_type_)
+	return false;
+    }
+
+  /* The layout of the read values depends on the read format, which is not
+     worth supporting as they carry no address.  */
+  return (sample_type_ & PERF_SAMPLE_READ) == 0;
+}
+
+/* Return the perf_object for the executable FILENAME.  Only ELF
+   position-dependent executables can be symbolized, as libbacktrace maps
+   the addresses of other objects at the place they are loaded in the
+   compiler itself.  */
+
+perf_object *
+perf_data_reader::get_object (const char *filename)
+{
+  for (unsigned i = 0; i < objects_.length (); i++)
+    if (strcmp (objects_[i]->filename, filename) == 0)
+      return objects_[i];
+
+  perf_object *object = new perf_object;
+  object->filename = xstrdup (filename);
+  object->state = NULL;
+  objects_.safe_push (object);
+
+  /* Check for an ET_EXEC ELF file.  */
+  unsigned char ehdr[18];
+  FILE *file = fopen (filename, "rb");
+  if (file == NULL)
+    return object;
+  bool exec_p = (fread (ehdr, sizeof (ehdr), 1, file) == 1
+		 && memcmp (ehdr, "\177ELF", 4) == 0
+		 && (ehdr[16] | (ehdr[17] << 8)) == 2);
+  fclose (file);
+
+  if (exec_p)
+    object->state = backtrace_create_state (object->filename, 0,
+					    perf_backtrace_error, NULL);
+  return object;
+}
+
+/* Record the mapping in BUF of SIZE bytes with header flags MISC.  MMAP2
+   is TRUE for a PERF_RECORD_MMAP2 record.  */
+
+void
+perf_data_reader::read_mapping (const char *buf, unsigned size,
+				unsigned misc, bool mmap2)
+{
+  /* Both records start with pid, tid, addr, len and pgoff, followed by
+     the device, inode and protection for PERF_RECORD_MMAP2, then by the
+     file name.  */
+  unsigned filename_pos = mmap2 ? 64 : 32;
+  if (size <= filename_pos || (misc & PERF_RECORD_MISC_MMAP_DATA))
+    return;
+  if (mmap2)
+    {
+      uint32_t prot;
+      memcpy (&prot, buf + 56, 4);
+      if ((prot & PERF_PROT_EXEC) == 0)
+	return;
+    }
+
+  const char *filename = buf + filename_pos;
+  if (strnlen (filename, size - filename_pos) == size - filename_pos
+      || filename[0] != '/')
+    return;
+
+  perf_mapping mapping;
+  uint32_t pid;
+  uint64_t len;
+  memcpy (&pid, buf, 4);
+  memcpy (&mapping.start, buf + 8, 8);
+  memcpy (&len, buf + 16, 8);
+  mapping.pid = pid;
+  mapping.end = mapping.start + len;
+  mapping.object = get_object (filename);
+  if (mapping.object->state != NULL)
+    mappings_.safe_push (mapping);
+}
+
+/* Return the object mapped at ADDR in process PID, or in any process if
+   PID is -1.  Return NULL if ADDR is not in a symbolizable object.  */
+
+perf_object *
+perf_data_reader::find_object (unsigned pid, uint64_t addr) const
+{
+  for (unsigned i = mappings_.length (); i-- > 0;)
+    if ((pid == -1U || mappings_[i].pid == pid)
+	&& addr >= mappings_[i].start && addr < mappings_[i].end)
+      return mappings_[i].object;
+  return NULL;
+}
+
+/* Aggregate the sample in BUF of SIZE bytes.  */
+
+void
+perf_data_reader::read_sample (const char *buf, unsigned size)
+{
+  unsigned pos = 0;
+  uint64_t ip = 0, pid = -1U, val;
+
+  if ((sample_type_ & PERF_SAMPLE_IDENTIFIER)
+      && !perf_read_field (buf, size, &pos, 8, &val))
+    return;
+  if ((sample_type_ & PERF_SAMPLE_IP)
+      && !perf_read_field (buf, size, &pos, 8, &ip))
+    return;
+  if (sample_type_ & PERF_SAMPLE_TID)
+    {
+      if (!perf_read_field (buf, size, &pos, 4, &pid)
+	  || !perf_read_field (buf, size, &pos, 4, &val))
+	return;
+    }
+  /* Skip time, addr, id, stream_id, cpu and period.  */
+  pos += 8 * popcount_hwi (sample_type_ & (PERF_SAMPLE_TIME
+					   | PERF_SAMPLE_ADDR
+					   | PERF_SAMPLE_ID
+					   | PERF_SAMPLE_STREAM_ID
+					   | PERF_SAMPLE_CPU
+					   | PERF_SAMPLE_PERIOD));
+  if (sample_type_ & PERF_SAMPLE_CALLCHAIN)
+    {
+      if (!perf_read_field (buf, size, &pos, 8, &val) || val > size)
+	return;
+      pos += 8 * val;
+    }
+  if (sample_type_ & PERF_SAMPLE_RAW)
+    {
+      if (!perf_read_field (buf, size, &pos, 4, &val) || val > size)
+	return;
+      pos += val;
+    }
+
+  if ((sample_type_ & PERF_SAMPLE_BRANCH_STACK) == 0)
+    {
+      perf_address_pair range;
+      range.object = find_object (pid, ip);
+      range.from = range.to = ip;
+      range.type = 0;
+      if ((sample_type_ & PERF_SAMPLE_IP) && range.object != NULL)
+	ranges_[range]++;
+      return;
+    }
+
+  uint64_t nr;
+  if (!perf_read_field (buf, size, &pos, 8, &nr))
+    return;
+  if (branch_sample_type_ & PERF_SAMPLE_BRANCH_HW_INDEX)
+    pos += 8;
+  if (pos > size || nr > (size - pos) / PERF_BRANCH_ENTRY_SIZE)
+    return;
+
+  /* The branch stack is ordered from the most recent branch.  The code
+     from the target of a branch up to the source of the next one was
+     executed without any taken branch.  */
+  uint64_t prev_from = 0;
+  perf_object *prev_object = NULL;
+  for (uint64_t i = 0; i < nr; i++, pos += PERF_BRANCH_ENTRY_SIZE)
+    {
+      uint64_t from, to, flags;
+      memcpy (&from, buf + pos, 8);
+      memcpy (&to, buf + pos + 8, 8);
+      memcpy (&flags, buf + pos + 16, 8);
+
+      perf_object *from_object = find_object (pid, from);
+      perf_object *to_object = find_object (pid, to);
+
+      if (to_object != NULL && to_object == prev_object
+	  && to <= prev_from && prev_from - to < PERF_MAX_RANGE_LENGTH)
+	{
+	  perf_address_pair range;
+	  range.object = to_object;
+	  range.from = to;
+	  range.to = prev_from;
+	  range.type = 0;
+	  ranges_[range]++;
+	}
+
+      if (from_object != NULL && from_object == to_object)
+	{
+	  perf_address_pair branch;
+	  branch.object = from_object;
+	  branch.from = from;
+	  branch.to = to;
+	  branch.type = (flags >> 20) & 0xf;
+	  branches_[branch]++;
+	}
+
+      prev_from = from;
+      prev_object = from_object;
+    }
+}
+
+/* Read FILENAME and aggregate its samples, return TRUE on success.  */
+
+bool
+perf_data_reader::read (const char *filename)
+{
+  file_ = fopen (filename, "rb");
+  if (file_ == NULL)
+    return false;
+
+  /* The file header: magic, size, attr_size, then the attrs and data
+     sections as (offset, size) pairs.  */
+  uint64_t header[7];
+  if (fread (header, sizeof (header), 1, file_) != 1
+      || header[1] != PERF_FILE_HEADER_SIZE
+      || !read_attrs (header[3], header[4], header[2]))
+    return false;
+
+  uint64_t offset = header[5];
+  uint64_t end = header[5] + header[6];
+  auto_vec<char> buf;
+  while (offset + 8 <= end)
+    {
+      uint32_t type;
+      uint16_t misc, size;
+      char record_header[8];
+      if (fseek (file_, offset, SEEK_SET) != 0
+	  || fread (record_header, sizeof (record_header), 1, file_) != 1)
+	return false;
+      memcpy (&type, record_header, 4);
+      memcpy (&misc, record_header + 4, 2);
+      memcpy (&size, record_header + 6, 2);
+      if (size < 8 || offset + size > end)
+	return false;
+      offset += size;
+      size -= 8;
+
+      if (type != PERF_RECORD_SAMPLE && type != PERF_RECORD_MMAP
+	  && type != PERF_RECORD_MMAP2)
+	continue;
+      if (buf.length () < size + 1u)
+	buf.safe_grow (size + 1);
+      if (size != 0 && fread (buf.address (), size, 1, file_) != 1)
+	return false;
+      buf[size] = 0;
+      if (type == PERF_RECORD_SAMPLE)
+	read_sample (buf.address (), size);
+      else
+	read_mapping (buf.address (), size, misc, type == PERF_RECORD_MMAP2);
+    }
+  return true;
+}
+
+/* Callback of backtrace_pcinfo, push the frame to the name_inline_stack
+   DATA.  Frames are reported from the innermost inlined function.  */
+
+static int
+perf_pcinfo_callback (void *data, uintptr_t, const char *,
+		      int lineno, const char *function)
+{
+  name_inline_stack *stack = (name_inline_stack *) data;
+  if (function == NULL || lineno <= 0 || lineno >= (1 << 16))
+    {
+      stack->clear ();
+      return 1;
+    }
+  stack->push_back (std::make_pair (afdo_string_table->add_name (function),
+				    (unsigned) lineno << 16));
+  return 0;
+}
+
+/* Store the inline stack of ADDR in OBJECT in STACK.  Return TRUE if
+   ADDR has line info.  */
+
+bool
+perf_data_reader::get_inline_stack (perf_object *object, uint64_t addr,
+				    name_inline_stack *stack) const
+{
+  stack->clear ();
+  backtrace_pcinfo (object->state, addr, perf_pcinfo_callback,
+		    perf_backtrace_error, stack);
+  return !stack->empty ();
+}
+
+/* The symbol found by backtrace_syminfo.  */
+
+struct perf_symbol
+{
+  const char *name;
+  uintptr_t value;
+};
+
+/* Callback of backtrace_syminfo, store the symbol in the perf_symbol
+   DATA.  */
+
+static void
+perf_syminfo_callback (void *data, uintptr_t, const char *symname,
+		       uintptr_t symval, uintptr_t)
+{
+  perf_symbol *symbol = (perf_symbol *) data;
+  symbol->name = symname;
+  symbol->value = symval;
+}
+
+/* Return the name index of the function starting at ADDR in OBJECT, or
+   -1 if ADDR is not the start of a function.  */
+
+int
+perf_data_reader::get_function_at (perf_object *object, uint64_t addr) const
+{
+  perf_symbol symbol = { NULL, 0 };
+  backtrace_syminfo (object->state, addr, perf_syminfo_callback,
+		     perf_backtrace_error, &symbol);
+  if (symbol.name == NULL || symbol.value != addr)
+    return -1;
+  return afdo_string_table->add_name (symbol.name);
+}
+
+/* Return the top-level function_instance of NAME, creating an empty one
+   if needed.  */
+
+function_instance *
+autofdo_source_profile::get_or_create_function_instance (unsigned name)
+{
+  function_instance *&s = map_[name];
+  if (s == NULL)
+    s = new function_instance (name, 0);
+  return s;
+}
+
+/* Add COUNT samples at the inline STACK and return the leaf
+   function_instance.  */
+
+function_instance *
+autofdo_source_profile::add_perf_count (const name_inline_stack &stack,
+					gcov_type count)
+{
+  unsigned i = stack.size () - 1;
+  function_instance *s = get_or_create_function_instance (stack[i].first);
+  s->add_total_count (count);
+  for (; i > 0; i--)
+    {
+      s = s->get_or_create_callsite (stack[i].second, stack[i - 1].first);
+      s->add_total_count (count);
+    }
+  s->add_pos_count (stack[0].second, count);
+  return s;
+}
+
+/* Read the perf.data file FILENAME and returns TRUE on success.  */
+
+bool
+autofdo_source_profile::read_perf_data (const char *filename)
+{
+  perf_data_reader reader;
+  if (!reader.read (filename))
+    return false;
+
+  /* Every source location in a range was executed once each time the
+     range was; count it once per range even if its instructions are not
+     contiguous.  Line info is looked up at each byte, as instruction
+     boundaries are not known.  */
+  for (perf_count_map::const_iterator iter = reader.ranges ().begin ();
+       iter != reader.ranges ().end (); ++iter)
+    {
+      const perf_address_pair &range = iter->first;
+      std::set<name_inline_stack> seen;
+      for (uint64_t addr = range.from; addr <= range.to; addr++)
+	{
+	  name_inline_stack stack;
+	  if (reader.get_inline_stack (range.object, addr, &stack)
+	      && seen.insert (stack).second)
+	    add_perf_count (stack, iter->second);
+	}
+    }
+
+  /* Calls give the entry counts of the callees, and the targets of the
+     indirect calls.  When the branch type is not recorded, every call is
+     recorded as a potential target; those of direct calls are ignored
+     during annotation.  */
+  for (perf_count_map::const_iterator iter = reader.branches ().begin ();
+       iter != reader.branches ().end (); ++iter)
+    {
+      const perf_address_pair &branch = iter->first;
+      int callee = reader.get_function_at (branch.object, branch.to);
+      if (callee == -1)
+	continue;
+      get_or_create_function_instance (callee)->add_head_count (iter->second);
+
+      name_inline_stack stack;
+      if ((branch.type != 0 && branch.type != PERF_BR_IND_CALL)
+	  || !reader.get_inline_stack (branch.object, branch.from, &stack))
+	continue;
+      add_perf_count (stack, 0)->add_icall_target (stack[0].second, callee,
+						   iter->second);
+    }
+
+  for (name_function_instance_map::const_iterator iter = map_.begin ();
+       iter != map_.end (); ++iter)
+    {
+      afdo_profile_info->sum_all += iter->second->total_count ();
+      iter->second->add_to_histogram (afdo_profile_info);
+    }
+  afdo_profile_info->sum_max = afdo_profile_info->run_max;
+
+  /* perf.data has no working set, compute it from the histogram.  */
+  gcov_working_set_t set[NUM_GCOV_WORKING_SETS];
+  compute_working_sets (afdo_profile_info, set);
+  add_working_set (set);
+  return true;
+}
+
 /* Module profile is only used by LIPO. Here we simply ignore it.  */
 
 static void
@@ -910,11 +1720,38 @@ fake_read_autofdo_module_profile ()
   gcc_assert (total_module_num == 0);
 }
 
+/* Read the profile from the perf.data file AUTO_PROFILE_FILE.  */
+
+static void
+read_perf_profile (void)
+{
+  afdo_absolute_lines = true;
+
+  /* string_table::get_name does not accept index 0.  */
+  afdo_string_table = new string_table ();
+  afdo_string_table->add_name ("");
+
+  afdo_source_profile
+      = autofdo_source_profile::create_from_perf_data (auto_profile_file);
+  if (afdo_source_profile == NULL)
+    {
+      error ("Cannot read perf.data file %s.", auto_profile_file);
+      return;
+    }
+
+}
+
 /* Read data from profile data file.  */
 
 static void
 read_profile (void)
 {
+  if (perf_data_file_p (auto_profile_file))
+    {
+      read_perf_profile ();
+      return;
+    }
+
   if (gcov_open (auto_profile_file, 1) == 0)
     {
       error ("Cannot open profile file %s.", auto_profile_file);
@@ -1034,7 +1871,8 @@ afdo_indirect_call (gimple_stmt_iterator *gsi, const icall_target_map &map,
       fprintf (dump_file, "Indirect call -> direct call ");
       print_generic_expr (dump_file, callee, TDF_SLIM);
       fprintf (dump_file, " => ");
-      print_generic_expr (dump_file, direct_call->decl, TDF_SLIM);
+      /* The target may not be defined in this unit.  */
+      fprintf (dump_file, "%s", (const char *) hist->hvalue.counters[0]);
     }
 
   if (direct_call == NULL || !check_ic_target (stmt, direct_call))
@@ -23,11 +23,13 @@
    which are kept separate; and the "duplicate computed gotos" pass, which
    duplicates blocks ending in an indirect jump.
 
-   There are two algorithms for "reorder blocks": the "simple" algorithm,
+   There are three algorithms for "reorder blocks": the "simple" algorithm,
    which just rearranges blocks, trying to minimize the number of executed
-   unconditional branches; and the "software trace cache" algorithm, which
+   unconditional branches; the "software trace cache" algorithm, which
    also copies code, and in general tries a lot harder to have long linear
-   pieces of machine code executed.  This algorithm is described next.  */
+   pieces of machine code executed; and the "Ext-TSP" algorithm, which
+   rearranges blocks to favor short jumps as well as fallthroughs.  The
+   software trace cache algorithm is described next.  */
 
 /* This (greedy) algorithm constructs traces in several rounds.
    The construction starts from "seeds".  The seed for the first round
@@ -2450,6 +2452,313 @@ reorder_basic_blocks_simple (void)
     }
 }
 
+/* Ext-TSP layout.  Unlike the algorithms above, which only count
+   fallthrough edges, this one also rewards short jumps, which are more
+   likely to stay within the same instruction cache line or page.  The
+   score of a layout is the sum over all edges of the edge frequency
+   times a weight depending on the jump distance: full weight for a
+   fallthrough, and a tenth of it decreasing linearly to zero for
+   forward jumps up to EXT_TSP_FORWARD_DISTANCE bytes and backward jumps
+   up to EXT_TSP_BACKWARD_DISTANCE bytes.
+
+   Every block starts in a chain of its own.  We then repeatedly
+   concatenate the two chains whose concatenation increases the score
+   the most, until no concatenation helps.  Since concatenation does not
+   change the distances within either chain, the gain only depends on
+   the edges between the two.  Finally the chains are emitted entry
+   chain first, then by decreasing execution density.
+
+   Reference: "Improved Basic Block Reordering", A. Newell and S. Pupyrev;
+   IEEE Transactions on Computers, 2020.  */
+
+#define EXT_TSP_FALLTHROUGH_WEIGHT 10
+#define EXT_TSP_FORWARD_DISTANCE 1024
+#define EXT_TSP_BACKWARD_DISTANCE 640
+
+/* Per-block data for the Ext-TSP layout, indexed by block index.  */
+
+struct ext_tsp_bb_data
+{
+  /* The chain the block is in, identified by the index of its first
+     block when the algorithm started.  */
+  int chain;
+
+  /* The offset of the block within its chain and its size, in bytes.  */
+  HOST_WIDE_INT offset;
+  HOST_WIDE_INT size;
+};
+
+/* A chain of blocks laid out consecutively.  */
+
+struct ext_tsp_chain
+{
+  vec<basic_block> blocks;
+  HOST_WIDE_INT size;
+  HOST_WIDE_INT frequency;
+};
+
+/* The gain of concatenating chains A and B, in either order.  */
+
+struct ext_tsp_pair
+{
+  int a, b;
+  HOST_WIDE_INT gain_ab;
+  HOST_WIDE_INT gain_ba;
+};
+
+static ext_tsp_bb_data *ext_tsp_bbd;
+static ext_tsp_chain *ext_tsp_chains;
+
+/* Return the score of an edge executed FREQ times that jumps DISTANCE
+   bytes forward, if FORWARD, or backward otherwise.  */
+
+static HOST_WIDE_INT
+ext_tsp_edge_score (HOST_WIDE_INT freq, bool forward, HOST_WIDE_INT distance)
+{
+  if (forward)
+    {
+      if (distance == 0)
+	return freq * EXT_TSP_FALLTHROUGH_WEIGHT * EXT_TSP_FORWARD_DISTANCE;
+      if (distance < EXT_TSP_FORWARD_DISTANCE)
+	return freq * (EXT_TSP_FORWARD_DISTANCE - distance);
+    }
+  else if (distance < EXT_TSP_BACKWARD_DISTANCE)
+    return (freq * (EXT_TSP_BACKWARD_DISTANCE - distance)
+	    * EXT_TSP_FORWARD_DISTANCE / EXT_TSP_BACKWARD_DISTANCE);
+  return 0;
+}
+
+/* Return the score of edge E when the chain of its source is laid out
+   immediately before the chain of its destination if SRC_FIRST, and
+   immediately after it otherwise.  */
+
+static HOST_WIDE_INT
+ext_tsp_cross_edge_score (edge e, bool src_first)
+{
+  ext_tsp_bb_data *src = &ext_tsp_bbd[e->src->index];
+  ext_tsp_bb_data *dest = &ext_tsp_bbd[e->dest->index];
+  HOST_WIDE_INT freq = EDGE_FREQUENCY (e);
+
+  if (src_first)
+    {
+      HOST_WIDE_INT from = src->offset + src->size;
+      HOST_WIDE_INT to = ext_tsp_chains[src->chain].size + dest->offset;
+      return ext_tsp_edge_score (freq, true, to - from);
+    }
+  else
+    {
+      HOST_WIDE_INT from = (ext_tsp_chains[dest->chain].size
+			    + src->offset + src->size);
+      return ext_tsp_edge_score (freq, false, from - dest->offset);
+    }
+}
+
+/* Comparison function for sorting ext_tsp_pair by chains.  */
+
+static int
+ext_tsp_pair_cmp (const void *p1, const void *p2)
+{
+  const ext_tsp_pair *x = (const ext_tsp_pair *) p1;
+  const ext_tsp_pair *y = (const ext_tsp_pair *) p2;
+
+  if (x->a != y->a)
+    return x->a < y->a ? -1 : 1;
+  if (x->b != y->b)
+    return x->b < y->b ? -1 : 1;
+  return 0;
+}
+
+/* Order for emitting the final chains: those in the partition PARTITION
+   first, then denser chains first, then by chain id.  */
+
+struct ext_tsp_chain_order
+{
+  int partition;
+
+  bool operator () (int c1, int c2) const
+  {
+    ext_tsp_chain *x = &ext_tsp_chains[c1];
+    ext_tsp_chain *y = &ext_tsp_chains[c2];
+    bool in1 = BB_PARTITION (x->blocks[0]) == partition;
+    bool in2 = BB_PARTITION (y->blocks[0]) == partition;
+
+    if (in1 != in2)
+      return in1;
+    if (x->frequency * y->size != y->frequency * x->size)
+      return x->frequency * y->size > y->frequency * x->size;
+    return c1 < c2;
+  }
+};
+
+/* Reorder basic blocks using the Ext-TSP algorithm.  */
+
+static void
+reorder_basic_blocks_ext_tsp (void)
+{
+  if (dump_file)
+    fprintf (dump_file, "\nReordering with the Ext-TSP algorithm.\n\n");
+
+  basic_block first = EDGE_SUCC (ENTRY_BLOCK_PTR_FOR_FN (cfun), 0)->dest;
+  int n = last_basic_block_for_fn (cfun);
+  ext_tsp_bbd = XNEWVEC (ext_tsp_bb_data, n);
+  ext_tsp_chains = XCNEWVEC (ext_tsp_chain, n);
+
+  basic_block bb;
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      rtx_insn *insn;
+      HOST_WIDE_INT size = 0;
+
+      FOR_BB_INSNS (bb, insn)
+	if (INSN_P (insn))
+	  size += get_attr_min_length (insn);
+
+      ext_tsp_bbd[bb->index].chain = bb->index;
+      ext_tsp_bbd[bb->index].offset = 0;
+      ext_tsp_bbd[bb->index].size = size;
+      ext_tsp_chains[bb->index].blocks.safe_push (bb);
+      ext_tsp_chains[bb->index].size = size;
+      ext_tsp_chains[bb->index].frequency = bb->frequency;
+    }
+
+  /* Collect the edges that reordering can turn into fallthrough edges
+     or short jumps, as in reorder_basic_blocks_simple.  */
+  auto_vec<edge> edges;
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      rtx_insn *end = BB_END (bb);
+      edge e;
+      edge_iterator ei;
+
+      if (computed_jump_p (end) || tablejump_p (end, NULL, NULL))
+	continue;
+      if (JUMP_P (end) && extract_asm_operands (end))
+	continue;
+      if (!single_succ_p (bb) && !any_condjump_p (end))
+	continue;
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (e->dest != EXIT_BLOCK_PTR_FOR_FN (cfun)
+	    && e->dest != bb
+	    && !(e->flags & (EDGE_COMPLEX | EDGE_CROSSING))
+	    && BB_PARTITION (e->src) == BB_PARTITION (e->dest))
+	  edges.safe_push (e);
+    }
+
+  /* Greedily concatenate the pair of chains with the largest gain.  */
+  auto_vec<ext_tsp_pair> pairs;
+  while (true)
+    {
+      unsigned i;
+      edge e;
+
+      pairs.truncate (0);
+      FOR_EACH_VEC_ELT (edges, i, e)
+	{
+	  int src_chain = ext_tsp_bbd[e->src->index].chain;
+	  int dest_chain = ext_tsp_bbd[e->dest->index].chain;
+	  if (src_chain == dest_chain)
+	    continue;
+
+	  ext_tsp_pair p;
+	  HOST_WIDE_INT src_first = ext_tsp_cross_edge_score (e, true);
+	  HOST_WIDE_INT dest_first = ext_tsp_cross_edge_score (e, false);
+	  if (src_chain < dest_chain)
+	    {
+	      p.a = src_chain;
+	      p.b = dest_chain;
+	      p.gain_ab = src_first;
+	      p.gain_ba = dest_first;
+	    }
+	  else
+	    {
+	      p.a = dest_chain;
+	      p.b = src_chain;
+	      p.gain_ab = dest_first;
+	      p.gain_ba = src_first;
+	    }
+	  pairs.safe_push (p);
+	}
+      if (pairs.is_empty ())
+	break;
+
+      pairs.qsort (ext_tsp_pair_cmp);
+
+      /* Sum up the gains of all edges between the same two chains and
+	 find the best concatenation.  The chain holding the first block
+	 must stay at the start of the function.  */
+      int first_chain = ext_tsp_bbd[first->index].chain;
+      int best_first = -1, best_second = -1;
+      HOST_WIDE_INT best_gain = 0;
+      for (i = 0; i < pairs.length (); )
+	{
+	  ext_tsp_pair sum = pairs[i];
+	  for (i++; i < pairs.length ()
+		    && pairs[i].a == sum.a && pairs[i].b == sum.b; i++)
+	    {
+	      sum.gain_ab += pairs[i].gain_ab;
+	      sum.gain_ba += pairs[i].gain_ba;
+	    }
+	  if (sum.b != first_chain && sum.gain_ab > best_gain)
+	    {
+	      best_gain = sum.gain_ab;
+	      best_first = sum.a;
+	      best_second = sum.b;
+	    }
+	  if (sum.a != first_chain && sum.gain_ba > best_gain)
+	    {
+	      best_gain = sum.gain_ba;
+	      best_first = sum.b;
+	      best_second = sum.a;
+	    }
+	}
+      if (best_first < 0)
+	break;
+
+      /* Append the second chain to the first.  */
+      ext_tsp_chain *c1 = &ext_tsp_chains[best_first];
+      ext_tsp_chain *c2 = &ext_tsp_chains[best_second];
+      FOR_EACH_VEC_ELT (c2->blocks, i, bb)
+	{
+	  ext_tsp_bbd[bb->index].chain = best_first;
+	  ext_tsp_bbd[bb->index].offset += c1->size;
+	  c1->blocks.safe_push (bb);
+	}
+      c1->size += c2->size;
+      c1->frequency += c2->frequency;
+      c2->blocks.release ();
+    }
+
+  /* Emit the chain of the first block, then the others.  */
+  auto_vec<int> order;
+  int first_chain = ext_tsp_bbd[first->index].chain;
+  FOR_EACH_BB_FN (bb, cfun)
+    if (!ext_tsp_chains[bb->index].blocks.is_empty ()
+	&& bb->index != first_chain)
+      order.safe_push (bb->index);
+  ext_tsp_chain_order cmp;
+  cmp.partition = BB_PARTITION (first);
+  std::stable_sort (order.address (), order.address () + order.length (),
+		    cmp);
+
+  basic_block last = ENTRY_BLOCK_PTR_FOR_FN (cfun);
+  for (int j = -1; j < (int) order.length (); j++)
+    {
+      ext_tsp_chain *c = &ext_tsp_chains[j < 0 ? first_chain : order[j]];
+      unsigned i;
+      FOR_EACH_VEC_ELT (c->blocks, i, bb)
+	{
+	  last->aux = bb;
+	  last = bb;
+	}
+      c->blocks.release ();
+    }
+  last->aux = NULL;
+
+  free (ext_tsp_chains);
+  free (ext_tsp_bbd);
+}
+
 /* Reorder basic blocks.  The main entry point to this file.  */
 
 static void
@@ -2473,6 +2782,14 @@ reorder_basic_blocks (void)
       reorder_basic_blocks_software_trace_cache ();
       break;
 
+    case REORDER_BLOCKS_ALGORITHM_EXT_TSP:
+      if (n_basic_blocks_for_fn (cfun)
+	  <= PARAM_VALUE (PARAM_EXT_TSP_MAX_BLOCKS))
+	reorder_basic_blocks_ext_tsp ();
+      else
+	reorder_basic_blocks_simple ();
+      break;
+
     default:
       gcc_unreachable ();
     }
@@ -57,6 +57,7 @@ static void bitmap_element_link (bitmap, bitmap_element *);
 static bitmap_element *bitmap_elt_insert_after (bitmap, bitmap_element *, unsigned int);
 static void bitmap_elt_clear_from (bitmap, bitmap_element *);
 static bitmap_element *bitmap_find_bit (bitmap, unsigned int);
+static void bitmap_tree_to_list (bitmap);
 
 
 /* Add ELEM to the appropriate freelist.  */
@@ -220,7 +221,11 @@ void
 bitmap_clear (bitmap head)
 {
   if (head->first)
-    bitmap_elt_clear_from (head, head->first);
+    {
+      if (head->tree_form)
+	bitmap_tree_to_list (head);
+      bitmap_elt_clear_from (head, head->first);
+    }
 }
 
 /* Initialize a bitmap obstack.  If BIT_OBSTACK is NULL, initialize
@@ -439,6 +444,7 @@ bitmap_elt_insert_after (bitmap head, bitmap_element *elt, unsigned int indx)
 void
 bitmap_copy (bitmap to, const_bitmap from)
 {
+  gcc_checking_assert (!to->tree_form && !from->tree_form);
   const bitmap_element *from_ptr;
   bitmap_element *to_ptr = 0;
 
@@ -476,6 +482,7 @@ bitmap_copy (bitmap to, const_bitmap from)
 void
 bitmap_move (bitmap to, bitmap from)
 {
+  gcc_checking_assert (!to->tree_form && !from->tree_form);
   gcc_assert (to->obstack == from->obstack);
 
   bitmap_clear (to);
@@ -492,6 +499,254 @@ bitmap_move (bitmap to, bitmap from)
     }
 }
 
+/* Splay tree support for bitmaps in tree form.  The elements of such a
+   bitmap form a binary search tree ordered by index, with the prev field
+   of an element pointing to its left child and the next field to its
+   right child.  The root is HEAD->first and every lookup splays the
+   element it finds (or a neighbour of the index it looked for) to the
+   root, so HEAD->current is always the root as well.  This makes
+   random accesses to a bitmap with many elements O(log E) amortized,
+   where the linked list needs O(E).  */
+
+/* Splay the tree rooted at T so that the element with index INDX, or
+   the last element seen on the path to where it would be, becomes the
+   root.  Return the new root.  This is the top-down splay of Sleator
+   and Tarjan.  */
+
+static bitmap_element *
+bitmap_tree_splay (bitmap head, bitmap_element *t, unsigned int indx)
+{
+  bitmap_element N, *l, *r;
+
+  if (t == NULL)
+    return NULL;
+
+  bitmap_usage *usage = NULL;
+  if (GATHER_STATISTICS)
+    usage = bitmap_mem_desc.get_descriptor_for_instance (head);
+
+  /* Count the splay as a search, like bitmap_find_bit does for
+     walking the list.  */
+  if (GATHER_STATISTICS && usage)
+    usage->m_nsearches++;
+
+  N.prev = N.next = NULL;
+  l = r = &N;
+
+  while (indx != t->indx)
+    {
+      if (GATHER_STATISTICS && usage)
+	usage->m_search_iter++;
+
+      if (indx < t->indx)
+	{
+	  if (t->prev != NULL && indx < t->prev->indx)
+	    {
+	      /* Rotate right.  */
+	      bitmap_element *y = t->prev;
+	      t->prev = y->next;
+	      y->next = t;
+	      t = y;
+	    }
+	  if (t->prev == NULL)
+	    break;
+	  /* Link right.  */
+	  r->prev = t;
+	  r = t;
+	  t = t->prev;
+	}
+      else
+	{
+	  if (t->next != NULL && indx > t->next->indx)
+	    {
+	      /* Rotate left.  */
+	      bitmap_element *y = t->next;
+	      t->next = y->prev;
+	      y->prev = t;
+	      t = y;
+	    }
+	  if (t->next == NULL)
+	    break;
+	  /* Link left.  */
+	  l->next = t;
+	  l = t;
+	  t = t->next;
+	}
+    }
+
+  /* Reassemble.  */
+  l->next = t->prev;
+  r->prev = t->next;
+  t->prev = N.next;
+  t->next = N.prev;
+  return t;
+}
+
+/* Make ELT the root of the tree of HEAD.  */
+
+static inline void
+bitmap_tree_set_root (bitmap head, bitmap_element *elt)
+{
+  head->first = head->current = elt;
+  head->indx = elt ? elt->indx : 0;
+}
+
+/* Find the element with index INDX in the tree of HEAD and return it,
+   or NULL if there is none.  */
+
+static bitmap_element *
+bitmap_tree_find_element (bitmap head, unsigned int indx)
+{
+  bitmap_element *element = bitmap_tree_splay (head, head->first, indx);
+
+  bitmap_tree_set_root (head, element);
+  if (element && element->indx != indx)
+    element = NULL;
+
+  return element;
+}
+
+/* Insert ELT, whose index is not yet in the tree of HEAD, into it.  */
+
+static void
+bitmap_tree_link_element (bitmap head, bitmap_element *elt)
+{
+  bitmap_element *t = bitmap_tree_splay (head, head->first, elt->indx);
+
+  if (t == NULL)
+    elt->prev = elt->next = NULL;
+  else if (elt->indx < t->indx)
+    {
+      elt->prev = t->prev;
+      elt->next = t;
+      t->prev = NULL;
+    }
+  else
+    {
+      gcc_checking_assert (elt->indx > t->indx);
+      elt->next = t->next;
+      elt->prev = t;
+      t->next = NULL;
+    }
+
+  bitmap_tree_set_root (head, elt);
+}
+
+/* Remove ELT from the tree of HEAD and free it.  */
+
+static void
+bitmap_tree_unlink_element (bitmap head, bitmap_element *elt)
+{
+  bitmap_element *t = bitmap_tree_splay (head, head->first, elt->indx);
+
+  gcc_checking_assert (t == elt);
+
+  if (t->prev == NULL)
+    t = t->next;
+  else
+    {
+      /* Splaying the left subtree for ELT's index brings its largest
+	 element to the top, which leaves no right child to replace.  */
+      bitmap_element *left = bitmap_tree_splay (head, t->prev, elt->indx);
+      left->next = t->next;
+      t = left;
+    }
+
+  bitmap_tree_set_root (head, t);
+
+  if (GATHER_STATISTICS)
+    register_overhead (head, -((int)sizeof (bitmap_element)));
+
+  bitmap_elem_to_freelist (head, elt);
+}
+
+/* Turn the tree of HEAD back into a sorted doubly-linked list, leaving
+   HEAD->tree_form alone.  */
+
+static void
+bitmap_tree_to_list (bitmap head)
+{
+  bitmap_element **link = &head->first;
+  bitmap_element *elt, *prev;
+
+  /* Rotate right at each element until it has no left child; what is
+     left is a list linked through the next fields.  */
+  while ((elt = *link) != NULL)
+    {
+      bitmap_element *left = elt->prev;
+      if (left)
+	{
+	  elt->prev = left->next;
+	  left->next = elt;
+	  *link = left;
+	}
+      else
+	link = &elt->next;
+    }
+
+  prev = NULL;
+  for (elt = head->first; elt; elt = elt->next)
+    {
+      elt->prev = prev;
+      prev = elt;
+    }
+}
+
+/* Build a balanced tree from the first N elements of the sorted list
+   starting at *LIST and advance *LIST past them.  Return the root.  */
+
+static bitmap_element *
+bitmap_list_to_tree (bitmap_element **list, unsigned int n)
+{
+  if (n == 0)
+    return NULL;
+
+  bitmap_element *left = bitmap_list_to_tree (list, n / 2);
+  bitmap_element *root = *list;
+  *list = root->next;
+  root->prev = left;
+  root->next = bitmap_list_to_tree (list, n - n / 2 - 1);
+  return root;
+}
+
+/* Switch HEAD to tree form.  Only bitmap_clear, bitmap_set_bit,
+   bitmap_clear_bit, bitmap_bit_p and bitmap_empty_p can be used on it
+   until bitmap_list_view switches it back, which suits bitmaps with
+   many elements that are accessed in random order.  The tree is
+   walked differently from the list by the garbage collector, so the
+   bitmap has to be allocated on an obstack.  */
+
+void
+bitmap_tree_view (bitmap head)
+{
+  gcc_assert (!head->tree_form && head->obstack);
+
+  unsigned int n = 0;
+  for (bitmap_element *elt = head->first; elt; elt = elt->next)
+    n++;
+
+  bitmap_element *list = head->first;
+  bitmap_tree_set_root (head, bitmap_list_to_tree (&list, n));
+  head->tree_form = true;
+}
+
+/* Switch HEAD, which must be in tree form, back to a linked list.  */
+
+void
+bitmap_list_view (bitmap head)
+{
+  gcc_assert (head->tree_form);
+
+  bitmap_tree_to_list (head);
+  head->tree_form = false;
+  if (head->first)
+    {
+      /* Keep the most recently accessed element as the current one.  */
+      gcc_checking_assert (head->current);
+      head->indx = head->current->indx;
+    }
+}
+
 /* Find a bitmap element that would hold a bitmap's bit.
    Update the `current' field even if we can't find an element that
    would hold the bitmap's bit to make eventual allocation
@@ -506,6 +761,8 @@ bitmap_find_bit (bitmap head, unsigned int bit)
   if (head->current == NULL
       || head->indx == indx)
     return head->current;
+  if (head->tree_form)
+    return bitmap_tree_find_element (head, indx);
   if (head->current == head->first
       && head->first->next == NULL)
     return NULL;
@@ -583,7 +840,12 @@ bitmap_clear_bit (bitmap head, int bit)
 	  /* If we cleared the entire word, free up the element.  */
 	  if (!ptr->bits[word_num]
 	      && bitmap_element_zerop (ptr))
-	    bitmap_element_free (head, ptr);
+	    {
+	      if (head->tree_form)
+		bitmap_tree_unlink_element (head, ptr);
+	      else
+		bitmap_element_free (head, ptr);
+	    }
 	}
 
       return res;
@@ -607,7 +869,10 @@ bitmap_set_bit (bitmap head, int bit)
       ptr = bitmap_element_allocate (head);
       ptr->indx = bit / BITMAP_ELEMENT_ALL_BITS;
       ptr->bits[word_num] = bit_val;
-      bitmap_element_link (head, ptr);
+      if (head->tree_form)
+	bitmap_tree_link_element (head, ptr);
+      else
+	bitmap_element_link (head, ptr);
       return true;
     }
   else
@@ -689,6 +954,7 @@ bitmap_count_bits_in_word (const BITMAP_WORD *bits)
 unsigned long
 bitmap_count_bits (const_bitmap a)
 {
+  gcc_checking_assert (!a->tree_form);
   unsigned long count = 0;
   const bitmap_element *elt;
 
@@ -703,6 +969,7 @@ bitmap_count_bits (const_bitmap a)
 unsigned long
 bitmap_count_unique_bits (const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   unsigned long count = 0;
   const bitmap_element *elt_a, *elt_b;
 
@@ -740,6 +1007,7 @@ bitmap_count_unique_bits (const_bitmap a, const_bitmap b)
 bool
 bitmap_single_bit_set_p (const_bitmap a)
 {
+  gcc_checking_assert (!a->tree_form);
   unsigned long count = 0;
   const bitmap_element *elt;
   unsigned ix;
@@ -776,6 +1044,7 @@ bitmap_single_bit_set_p (const_bitmap a)
 unsigned
 bitmap_first_set_bit (const_bitmap a)
 {
+  gcc_checking_assert (!a->tree_form);
   const bitmap_element *elt = a->first;
   unsigned bit_no;
   BITMAP_WORD word;
@@ -827,6 +1096,7 @@ bitmap_first_set_bit (const_bitmap a)
 unsigned
 bitmap_last_set_bit (const_bitmap a)
 {
+  gcc_checking_assert (!a->tree_form);
   const bitmap_element *elt = a->current ? a->current : a->first;
   unsigned bit_no;
   BITMAP_WORD word;
@@ -871,6 +1141,7 @@ bitmap_last_set_bit (const_bitmap a)
 void
 bitmap_and (bitmap dst, const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   bitmap_element *dst_elt = dst->first;
   const bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
@@ -929,6 +1200,7 @@ bitmap_and (bitmap dst, const_bitmap a, const_bitmap b)
 bool
 bitmap_and_into (bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
   bitmap_element *next;
@@ -1021,6 +1293,7 @@ bitmap_elt_copy (bitmap dst, bitmap_element *dst_elt, bitmap_element *dst_prev,
 bool
 bitmap_and_compl (bitmap dst, const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   bitmap_element *dst_elt = dst->first;
   const bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
@@ -1134,6 +1407,7 @@ bitmap_and_compl (bitmap dst, const_bitmap a, const_bitmap b)
 bool
 bitmap_and_compl_into (bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
   bitmap_element *next;
@@ -1187,6 +1461,7 @@ bitmap_and_compl_into (bitmap a, const_bitmap b)
 void
 bitmap_set_range (bitmap head, unsigned int start, unsigned int count)
 {
+  gcc_checking_assert (!head->tree_form);
   unsigned int first_index, end_bit_plus1, last_index;
   bitmap_element *elt, *elt_prev;
   unsigned int i;
@@ -1293,6 +1568,7 @@ bitmap_set_range (bitmap head, unsigned int start, unsigned int count)
 void
 bitmap_clear_range (bitmap head, unsigned int start, unsigned int count)
 {
+  gcc_checking_assert (!head->tree_form);
   unsigned int first_index, end_bit_plus1, last_index;
   bitmap_element *elt;
 
@@ -1426,6 +1702,7 @@ bitmap_clear_range (bitmap head, unsigned int start, unsigned int count)
 void
 bitmap_compl_and_into (bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
   bitmap_element *a_prev = NULL;
@@ -1555,6 +1832,7 @@ bitmap_elt_ior (bitmap dst, bitmap_element *dst_elt, bitmap_element *dst_prev,
 bool
 bitmap_ior (bitmap dst, const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   bitmap_element *dst_elt = dst->first;
   const bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
@@ -1604,6 +1882,7 @@ bitmap_ior (bitmap dst, const_bitmap a, const_bitmap b)
 bool
 bitmap_ior_into (bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
   bitmap_element *a_prev = NULL;
@@ -1643,6 +1922,7 @@ bitmap_ior_into (bitmap a, const_bitmap b)
 void
 bitmap_xor (bitmap dst, const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   bitmap_element *dst_elt = dst->first;
   const bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
@@ -1720,6 +2000,7 @@ bitmap_xor (bitmap dst, const_bitmap a, const_bitmap b)
 void
 bitmap_xor_into (bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
   bitmap_element *a_prev = NULL;
@@ -1779,6 +2060,7 @@ bitmap_xor_into (bitmap a, const_bitmap b)
 bool
 bitmap_equal_p (const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   const bitmap_element *a_elt;
   const bitmap_element *b_elt;
   unsigned ix;
@@ -1801,6 +2083,7 @@ bitmap_equal_p (const_bitmap a, const_bitmap b)
 bool
 bitmap_intersect_p (const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   const bitmap_element *a_elt;
   const bitmap_element *b_elt;
   unsigned ix;
@@ -1829,6 +2112,7 @@ bitmap_intersect_p (const_bitmap a, const_bitmap b)
 bool
 bitmap_intersect_compl_p (const_bitmap a, const_bitmap b)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   const bitmap_element *a_elt;
   const bitmap_element *b_elt;
   unsigned ix;
@@ -1857,6 +2141,8 @@ bitmap_intersect_compl_p (const_bitmap a, const_bitmap b)
 bool
 bitmap_ior_and_compl (bitmap dst, const_bitmap a, const_bitmap b, const_bitmap kill)
 {
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form
+		       && !kill->tree_form);
   bool changed = false;
 
   bitmap_element *dst_elt = dst->first;
@@ -1979,6 +2265,7 @@ bitmap_ior_and_compl_into (bitmap a, const_bitmap from1, const_bitmap from2)
 bool
 bitmap_ior_and_into (bitmap a, const_bitmap b, const_bitmap c)
 {
+  gcc_checking_assert (!a->tree_form && !b->tree_form && !c->tree_form);
   bitmap_element *a_elt = a->first;
   const bitmap_element *b_elt = b->first;
   const bitmap_element *c_elt = c->first;
@@ -2057,6 +2344,7 @@ bitmap_ior_and_into (bitmap a, const_bitmap b, const_bitmap c)
 hashval_t
 bitmap_hash (const_bitmap head)
 {
+  gcc_checking_assert (!head->tree_form);
   const bitmap_element *ptr;
   BITMAP_WORD hash = 0;
   int ix;
@@ -2076,6 +2364,7 @@ bitmap_hash (const_bitmap head)
 DEBUG_FUNCTION void
 debug_bitmap_file (FILE *file, const_bitmap head)
 {
+  gcc_checking_assert (!head->tree_form);
   const bitmap_element *ptr;
 
   fprintf (file, "\nfirst = " HOST_PTR_PRINTF
@@ -2262,6 +2551,55 @@ test_bitmap_single_bit_set_p ()
   ASSERT_EQ (1066, bitmap_first_set_bit (b));
 }
 
+/* Verify that a bitmap in tree form holds the same bits as one in list
+   form under a random mix of insertions and removals, and that
+   switching back to the list form keeps the bits.  */
+
+static void
+test_tree_view ()
+{
+  bitmap_obstack ob;
+  bitmap_obstack_initialize (&ob);
+  bitmap t = BITMAP_ALLOC (&ob);
+  bitmap l = BITMAP_ALLOC (&ob);
+  const unsigned int n = 20000;
+
+  bitmap_set_range (t, 1000, 300);
+  bitmap_set_range (l, 1000, 300);
+  bitmap_tree_view (t);
+  ASSERT_TRUE (bitmap_bit_p (t, 1000));
+  ASSERT_TRUE (bitmap_bit_p (t, 1299));
+  ASSERT_FALSE (bitmap_bit_p (t, 1300));
+
+  /* Visit the bits below N in a scrambled order.  */
+  unsigned int bit = 0;
+  for (unsigned int i = 0; i < n; i++)
+    {
+      bit = (bit + 7919) % n;
+      if (i % 3 == 2)
+	ASSERT_EQ (bitmap_clear_bit (l, bit), bitmap_clear_bit (t, bit));
+      else
+	ASSERT_EQ (bitmap_set_bit (l, bit), bitmap_set_bit (t, bit));
+    }
+  for (unsigned int i = 0; i < n; i++)
+    ASSERT_EQ (bitmap_bit_p (l, i), bitmap_bit_p (t, i));
+
+  bitmap_list_view (t);
+  ASSERT_TRUE (bitmap_equal_p (l, t));
+  ASSERT_EQ (bitmap_count_bits (l), bitmap_count_bits (t));
+
+  /* A bitmap in tree form can be cleared and reused.  */
+  bitmap_tree_view (t);
+  bitmap_clear (t);
+  ASSERT_TRUE (bitmap_empty_p (t));
+  ASSERT_TRUE (bitmap_set_bit (t, 5));
+  ASSERT_FALSE (bitmap_set_bit (t, 5));
+  ASSERT_TRUE (bitmap_clear_bit (t, 5));
+  ASSERT_TRUE (bitmap_empty_p (t));
+
+  bitmap_obstack_release (&ob);
+}
+
 /* Run all of the selftests within this file.  */
 
 void
@@ -2272,6 +2610,7 @@ bitmap_c_tests ()
   test_clear_bit_in_middle ();
   test_copying ();
   test_bitmap_single_bit_set_p ();
+  test_tree_view ();
 }
 
 } // namespace selftest
@@ -50,6 +50,13 @@ along with GCC; see the file COPYING3.  If not see
    the cached last element improves membership test to a constant-time
    operation.
 
+   For sets that are accessed in random order, bitmap_tree_view switches
+   the representation to a splay tree of the same elements, in which
+   member_p/add_member/remove_member take O(log E) amortized time.  Only
+   those operations and clear are available in tree form, so such a set
+   is switched back with bitmap_list_view before it is iterated over or
+   combined with other sets.
+
    The following operations can always be performed in O(1) time:
 
      * clear			: bitmap_clear
@@ -232,14 +239,21 @@ struct GTY((chain_next ("%h.next"), chain_prev ("%h.prev"))) bitmap_element {
 };
 
 /* Head of bitmap linked list.  The 'current' member points to something
-   already pointed to by the chain started by first, so GTY((skip)) it.  */
+   already pointed to by the chain started by first, so GTY((skip)) it.
+
+   A bitmap can also be put in tree form (see bitmap_tree_view).  The
+   elements are then kept in a splay tree ordered by index, with prev
+   and next as the left and right children, FIRST as the root and
+   CURRENT equal to FIRST.  */
 
 struct GTY(()) bitmap_head {
   unsigned int indx;			/* Index of last element looked at.  */
-  unsigned int descriptor_id;		/* Unique identifier for the allocation
+  unsigned int tree_form : 1;		/* The elements form a splay tree.  */
+  unsigned int descriptor_id : 31;	/* Unique identifier for the allocation
 					   site of this bitmap, for detailed
 					   statistics gathering.  */
-  bitmap_element *first;		/* First element in linked list.  */
+  bitmap_element *first;		/* First element in linked list, or
+					   root of the tree.  */
   bitmap_element * GTY((skip(""))) current; /* Last element looked at.  */
   bitmap_obstack *obstack;		/* Obstack to allocate elements from.
 					   If NULL, then use GGC allocation.  */
@@ -309,6 +323,10 @@ extern bool bitmap_ior_and_compl (bitmap DST, const_bitmap A,
 extern bool bitmap_ior_and_compl_into (bitmap A,
 				       const_bitmap B, const_bitmap C);
 
+/* Switch a bitmap between the linked list and the splay tree form.  */
+extern void bitmap_tree_view (bitmap);
+extern void bitmap_list_view (bitmap);
+
 /* Clear a single bit in a bitmap.  Return true if the bit changed.  */
 extern bool bitmap_clear_bit (bitmap, int);
 
@@ -338,6 +356,7 @@ static inline void
 bitmap_initialize_stat (bitmap head, bitmap_obstack *obstack MEM_STAT_DECL)
 {
   head->first = head->current = NULL;
+  head->tree_form = false;
   head->obstack = obstack;
   if (GATHER_STATISTICS)
     bitmap_register (head PASS_MEM_STAT);
@@ -401,6 +420,7 @@ static inline void
 bmp_iter_set_init (bitmap_iterator *bi, const_bitmap map,
 		   unsigned start_bit, unsigned *bit_no)
 {
+  gcc_checking_assert (!map->tree_form);
   bi->elt1 = map->first;
   bi->elt2 = NULL;
 
@@ -443,6 +463,7 @@ static inline void
 bmp_iter_and_init (bitmap_iterator *bi, const_bitmap map1, const_bitmap map2,
 		   unsigned start_bit, unsigned *bit_no)
 {
+  gcc_checking_assert (!map1->tree_form && !map2->tree_form);
   bi->elt1 = map1->first;
   bi->elt2 = map2->first;
 
@@ -512,6 +533,7 @@ bmp_iter_and_compl_init (bitmap_iterator *bi,
 			 const_bitmap map1, const_bitmap map2,
 			 unsigned start_bit, unsigned *bit_no)
 {
+  gcc_checking_assert (!map1->tree_form && !map2->tree_form);
   bi->elt1 = map1->first;
   bi->elt2 = map2->first;
 
@@ -420,6 +420,10 @@ c_common_handle_option (size_t scode, const char *arg, int value,
 	flag_abi_compat_version = value;
       break;
 
+    case OPT_fcache_include_dirs:
+      cpp_opts->cache_include_dirs = value;
+      break;
+
     case OPT_fcanonical_system_headers:
       cpp_opts->canonical_system_headers = value;
       break;
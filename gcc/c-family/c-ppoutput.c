@@ -53,6 +53,7 @@ static macro_queue *define_queue, *undef_queue;
 static void scan_translation_unit (cpp_reader *);
 static void print_lines_directives_only (int, const void *, size_t);
 static void scan_translation_unit_directives_only (cpp_reader *);
+static void scan_directives_only_nooutput (cpp_reader *);
 static void scan_translation_unit_trad (cpp_reader *);
 static void account_for_newlines (const unsigned char *, size_t);
 static int dump_macro (cpp_reader *, cpp_hashnode *, void *);
@@ -85,7 +86,12 @@ preprocess_file (cpp_reader *pfile)
 {
   /* A successful cpp_read_main_file guarantees that we can call
      cpp_scan_nooutput or cpp_get_token next.  */
-  if (flag_no_output && pfile->buffer)
+  if (flag_no_output && pfile->buffer
+      && cpp_get_options (pfile)->directives_only
+      && !cpp_get_options (pfile)->preprocessed
+      && !cpp_get_options (pfile)->traditional)
+    scan_directives_only_nooutput (pfile);
+  else if (flag_no_output && pfile->buffer)
     {
       /* Scan -included buffers, then the main file.  */
       while (pfile->buffer->prev)
@@ -304,6 +310,31 @@ scan_translation_unit_directives_only (cpp_reader *pfile)
   _cpp_preprocess_dir_only (pfile, &cb);
 }
 
+static void
+discard_lines_directives_only (int, const void *, size_t)
+{
+}
+
+static void
+discard_line_directives_only (source_location)
+{
+}
+
+/* Scan the translation unit for its directives only, without output.
+   This is what -fdirectives-only does together with -M, -MM or -dM:
+   only the directives matter, so the other lines are skipped without
+   being tokenized.  */
+static void
+scan_directives_only_nooutput (cpp_reader *pfile)
+{
+  struct _cpp_dir_only_callbacks cb;
+
+  cb.print_lines = discard_lines_directives_only;
+  cb.maybe_print_line = discard_line_directives_only;
+
+  _cpp_preprocess_dir_only (pfile, &cb);
+}
+
 /* Adjust print.src_line for newlines embedded in output.  */
 static void
 account_for_newlines (const unsigned char *str, size_t len)
@@ -897,28 +897,28 @@ partition_stack_vars (void)
 
   qsort (stack_vars_sorted, n, sizeof (size_t), stack_var_cmp);
 
+  /* REPS holds the partition representatives in sorted order.  Objects
+     merged into a partition are dropped from it as we go, so that later
+     objects do not walk over them again; with thousands of variables
+     most of them end up merged.  */
+  size_t *reps = XNEWVEC (size_t, n);
+  memcpy (reps, stack_vars_sorted, n * sizeof (size_t));
+
   for (si = 0; si < n; ++si)
     {
-      size_t i = stack_vars_sorted[si];
+      size_t i = reps[si];
       unsigned int ialign = stack_vars[i].alignb;
       HOST_WIDE_INT isize = stack_vars[i].size;
+      size_t dst = si + 1;
 
-      /* Ignore objects that aren't partition representatives. If we
-         see a var that is not a partition representative, it must
-         have been merged earlier.  */
-      if (stack_vars[i].representative != i)
-        continue;
+      gcc_checking_assert (stack_vars[i].representative == i);
 
       for (sj = si + 1; sj < n; ++sj)
 	{
-	  size_t j = stack_vars_sorted[sj];
+	  size_t j = reps[sj];
 	  unsigned int jalign = stack_vars[j].alignb;
 	  HOST_WIDE_INT jsize = stack_vars[j].size;
 
-	  /* Ignore objects that aren't partition representatives.  */
-	  if (stack_vars[j].representative != j)
-	    continue;
-
 	  /* Do not mix objects of "small" (supported) alignment
 	     and "large" (unsupported) alignment.  */
 	  if ((ialign * BITS_PER_UNIT <= MAX_SUPPORTED_STACK_ALIGNMENT)
@@ -936,13 +936,23 @@ partition_stack_vars (void)
 
 	  /* Ignore conflicting objects.  */
 	  if (stack_var_conflict_p (i, j))
-	    continue;
+	    {
+	      reps[dst++] = j;
+	      continue;
+	    }
 
 	  /* UNION the objects, placing J at OFFSET.  */
 	  union_stack_vars (i, j);
 	}
+
+      /* Keep the representatives we did not get to.  */
+      for (; sj < n; ++sj)
+	reps[dst++] = reps[sj];
+      n = dst;
     }
 
+  XDELETEVEC (reps);
+
   update_alias_info_with_stack_vars ();
 }
 
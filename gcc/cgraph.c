@@ -1996,6 +1996,23 @@ cgraph_inline_failed_string (cgraph_inline_failed_t reason)
   return cif_string_table[reason];
 }
 
+/* Return the name of the failure REASON, as spelled in cif-code.def,
+   for use as a reason code in optimization records.  */
+
+const char*
+cgraph_inline_failed_name (cgraph_inline_failed_t reason)
+{
+#undef DEFCIFCODE
+#define DEFCIFCODE(code, type, string)	#code,
+
+  static const char *cif_name_table[CIF_N_REASONS] = {
+#include "cif-code.def"
+  };
+
+  gcc_assert ((unsigned) reason < CIF_N_REASONS);
+  return cif_name_table[reason];
+}
+
 /* Return a type describing the failure REASON.  */
 
 cgraph_inline_failed_type_t
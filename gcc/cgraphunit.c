@@ -204,6 +204,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "dbgcnt.h"
 #include "tree-chkp.h"
 #include "lto-section-names.h"
+#include "tree-inline.h"
+#include "params.h"
 
 /* Queue of cgraph nodes scheduled to be added into cgraph.  This is a
    secondary queue used during optimization to accommodate passes that
@@ -1974,6 +1976,14 @@ cgraph_node::expand (void)
 
   timevar_push (TV_REST_OF_COMPILATION);
 
+  /* With -ftime-report-format=json, stream the time spent on each
+     function as soon as it has been compiled.  */
+  bool report_function_time
+    = (g_timer && flag_time_report_format == TIME_REPORT_FORMAT_JSON
+       && (time_report || !quiet_flag || flag_detailed_statistics));
+  if (report_function_time)
+    g_timer->start_function_report (asm_name ());
+
   gcc_assert (symtab->global_info_ready);
 
   /* Initialize the default bitmap obstack.  */
@@ -2048,6 +2058,8 @@ cgraph_node::expand (void)
   input_location = saved_loc;
 
   ggc_collect ();
+  if (report_function_time)
+    g_timer->end_function_report (stderr);
   timevar_pop (TV_REST_OF_COMPILATION);
 
   /* Make sure that BE didn't give up on compiling.  */
@@ -2087,6 +2099,184 @@ node_cmp (const void *pa, const void *pb)
 	 : b->order - a->order;
 }
 
+/* A cluster of functions to be laid out next to each other by
+   call-chain clustering.  COUNT is the sum of the entry counts of the
+   functions and SIZE the sum of their estimated sizes.  */
+
+struct function_cluster
+{
+  vec<cgraph_node *> nodes;
+  gcov_type count;
+  HOST_WIDE_INT size;
+};
+
+/* Return the estimated size of NODE for call-chain clustering, or 0 when
+   its body is not in memory, as in LTRANS where the bodies are read in
+   only when they are expanded.  */
+
+static HOST_WIDE_INT
+function_cluster_size (cgraph_node *node)
+{
+  function *fn = DECL_STRUCT_FUNCTION (node->decl);
+  if (!fn || !fn->cfg)
+    return 0;
+  return estimate_num_insns_fn (node->decl, &eni_size_weights);
+}
+
+/* Compare functions by decreasing entry count and then by order.  */
+
+static int
+node_count_cmp (const void *pa, const void *pb)
+{
+  const cgraph_node *a = *(const cgraph_node * const *) pa;
+  const cgraph_node *b = *(const cgraph_node * const *) pb;
+
+  if (a->count != b->count)
+    return a->count > b->count ? -1 : 1;
+  return a->order - b->order;
+}
+
+/* Compare clusters by decreasing density, that is entry count per unit
+   of size, and then by the order of their first function.  */
+
+static int
+function_cluster_cmp (const void *pa, const void *pb)
+{
+  const function_cluster *a = *(const function_cluster * const *) pa;
+  const function_cluster *b = *(const function_cluster * const *) pb;
+  double da = (double) a->count / MAX (a->size, 1);
+  double db = (double) b->count / MAX (b->size, 1);
+
+  if (da != db)
+    return da > db ? -1 : 1;
+  return a->nodes[0]->order - b->nodes[0]->order;
+}
+
+/* Reorder the N functions in ORDER by call-chain clustering of the profiled
+   call graph, so that functions and their hottest callers end up next to
+   each other.  ORDER is expanded from its end, so the clusters are stored
+   in reverse.  Functions that were never executed are kept in their
+   original relative order and are output after the clustered ones.
+
+   Each executed function starts in its own cluster.  Visiting functions
+   by decreasing entry count, the cluster of a function is appended to
+   the cluster of its most frequent caller, unless the merged cluster
+   would be larger than PARAM_FUNCTION_CLUSTER_SIZE.  The clusters are
+   finally laid out by decreasing density.  */
+
+static void
+call_chain_clustering (cgraph_node **order, int n)
+{
+  hash_map<cgraph_node *, function_cluster *> cluster_of;
+  auto_vec<cgraph_node *> hot;
+  auto_vec<cgraph_node *> cold;
+  auto_vec<function_cluster *> clusters;
+  HOST_WIDE_INT max_size = PARAM_VALUE (PARAM_FUNCTION_CLUSTER_SIZE);
+  int i;
+
+  /* ORDER is in reverse output order.  */
+  for (i = n - 1; i >= 0; i--)
+    {
+      cgraph_node *node = order[i];
+      if (node->count <= 0)
+	{
+	  cold.safe_push (node);
+	  continue;
+	}
+      function_cluster *cluster = new function_cluster;
+      cluster->nodes.create (1);
+      cluster->nodes.quick_push (node);
+      cluster->count = node->count;
+      cluster->size = function_cluster_size (node);
+      cluster_of.put (node, cluster);
+      hot.safe_push (node);
+    }
+
+  hot.qsort (node_count_cmp);
+
+  cgraph_node *node;
+  FOR_EACH_VEC_ELT (hot, i, node)
+    {
+      /* Find the most frequent caller of NODE.  Calls from functions
+	 inlined into a caller count for that caller.  */
+      hash_map<cgraph_node *, gcov_type> weights;
+      cgraph_node *best = NULL;
+      gcov_type best_weight = 0;
+      for (cgraph_edge *e = node->callers; e; e = e->next_caller)
+	{
+	  if (!e->inline_failed || e->count <= 0)
+	    continue;
+	  cgraph_node *caller = (e->caller->global.inlined_to
+				 ? e->caller->global.inlined_to : e->caller);
+	  if (caller == node || !cluster_of.get (caller))
+	    continue;
+	  gcov_type &weight = weights.get_or_insert (caller);
+	  weight += e->count;
+	  if (weight > best_weight
+	      || (weight == best_weight && caller->order < best->order))
+	    {
+	      best = caller;
+	      best_weight = weight;
+	    }
+	}
+      if (!best)
+	continue;
+
+      function_cluster *to = *cluster_of.get (best);
+      function_cluster *from = *cluster_of.get (node);
+      if (to == from
+	  || (max_size && to->size + from->size > max_size))
+	continue;
+
+      if (symtab->dump_file)
+	fprintf (symtab->dump_file,
+		 "Call-chain clustering: appending cluster of %s to cluster "
+		 "of %s, edge count %" PRId64 "\n",
+		 node->asm_name (), best->asm_name (), (int64_t) best_weight);
+
+      unsigned int j;
+      cgraph_node *moved;
+      FOR_EACH_VEC_ELT (from->nodes, j, moved)
+	{
+	  to->nodes.safe_push (moved);
+	  cluster_of.put (moved, to);
+	}
+      to->count += from->count;
+      to->size += from->size;
+      from->nodes.release ();
+      delete from;
+    }
+
+  /* Collect the clusters that are left, each once.  */
+  FOR_EACH_VEC_ELT (hot, i, node)
+    {
+      function_cluster *cluster = *cluster_of.get (node);
+      if (cluster->nodes[0] == node)
+	clusters.safe_push (cluster);
+    }
+  clusters.qsort (function_cluster_cmp);
+
+  int pos = n;
+  function_cluster *cluster;
+  FOR_EACH_VEC_ELT (clusters, i, cluster)
+    {
+      unsigned int j;
+      FOR_EACH_VEC_ELT (cluster->nodes, j, node)
+	{
+	  if (symtab->dump_file)
+	    fprintf (symtab->dump_file,
+		     "Call-chain clustering order:%s:%" PRId64 "\n",
+		     node->asm_name (), (int64_t) node->count);
+	  order[--pos] = node;
+	}
+      cluster->nodes.release ();
+      delete cluster;
+    }
+  FOR_EACH_VEC_ELT (cold, i, node)
+    order[--pos] = node;
+  gcc_assert (pos == 0);
+}
+
 /* Expand all functions that must be output.
 
    Attempt to topologically sort the nodes so function is output when
@@ -2117,7 +2307,12 @@ expand_all_functions (void)
       order[new_order_pos++] = order[i];
 
   if (flag_profile_reorder_functions)
-    qsort (order, new_order_pos, sizeof (cgraph_node *), node_cmp);
+    {
+      if (flag_reorder_functions_algorithm == REORDER_FUNCTIONS_CALL_CHAIN)
+	call_chain_clustering (order, new_order_pos);
+      else
+	qsort (order, new_order_pos, sizeof (cgraph_node *), node_cmp);
+    }
 
   for (i = new_order_pos - 1; i >= 0; i--)
     {
@@ -104,6 +104,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "valtrack.h"
 #include "rtl-iter.h"
 #include "print-rtl.h"
+#include "rtlhash.h"
 
 /* Number of attempts to combine instructions in this function.  */
 
@@ -409,6 +410,24 @@ struct undobuf
 
 static struct undobuf undobuf;
 
+/* A small direct-mapped cache of patterns that recog has already failed
+   to match during the current combine pass.  try_combine often builds the
+   same candidate pattern more than once, for example when a pair of insns
+   is retried after a later combination succeeds, or when the clobber-free
+   form of a PARALLEL is tried again, and failing to match is by far the
+   most common outcome.  Only failures are cached, so a stale entry can
+   at worst lose a combination, never produce a wrong one.  */
+
+#define RECOG_FAIL_CACHE_SIZE 256
+
+struct recog_fail_entry
+{
+  hashval_t hash;
+  rtx pat;
+};
+
+static struct recog_fail_entry recog_fail_cache[RECOG_FAIL_CACHE_SIZE];
+
 /* Number of times the pseudo being substituted for
    was found and replaced.  */
 
@@ -1156,6 +1175,7 @@ combine_instructions (rtx_insn *f, unsigned int nregs)
   uid_log_links = XCNEWVEC (struct insn_link *, max_uid_known + 1);
   uid_insn_cost = XCNEWVEC (int, max_uid_known + 1);
   gcc_obstack_init (&insn_link_obstack);
+  memset (recog_fail_cache, 0, sizeof recog_fail_cache);
 
   nonzero_bits_mode = mode_for_size (HOST_BITS_PER_WIDE_INT, MODE_INT, 0);
 
@@ -1505,6 +1525,7 @@ retry:
 
   /* Clean up.  */
   obstack_free (&insn_link_obstack, NULL);
+  memset (recog_fail_cache, 0, sizeof recog_fail_cache);
   free (uid_log_links);
   free (uid_insn_cost);
   reg_stat.release ();
@@ -11074,6 +11095,38 @@ simplify_shift_const (rtx x, enum rtx_code code, machine_mode result_mode,
 }
 
 
+/* Like recog, but first look PAT up in recog_fail_cache, and record it
+   there if it does not match.  Patterns with volatile references are
+   never cached, since rtx_equal_p does not distinguish them from their
+   non-volatile counterparts.  */
+
+static int
+recog_with_fail_cache (rtx pat, rtx_insn *insn, int *pnum_clobbers)
+{
+  inchash::hash hstate;
+  inchash::add_rtx (pat, hstate);
+  hashval_t hash = hstate.end ();
+  struct recog_fail_entry *entry
+    = &recog_fail_cache[hash % RECOG_FAIL_CACHE_SIZE];
+
+  if (entry->pat
+      && entry->hash == hash
+      && rtx_equal_p (entry->pat, pat))
+    {
+      statistics_counter_event (cfun, "recog failure cache hits", 1);
+      return -1;
+    }
+
+  int insn_code_number = recog (pat, insn, pnum_clobbers);
+  if (insn_code_number < 0 && !volatile_refs_p (pat))
+    {
+      /* PAT may still be changed by undo_all, so keep a private copy.  */
+      entry->hash = hash;
+      entry->pat = copy_rtx (pat);
+    }
+  return insn_code_number;
+}
+
 /* A subroutine of recog_for_combine.  See there for arguments and
    return value.  */
 
@@ -11103,7 +11156,8 @@ recog_for_combine_1 (rtx *pnewpat, rtx_insn *insn, rtx *pnotes)
   PATTERN (insn) = pat;
   REG_NOTES (insn) = NULL_RTX;
 
-  insn_code_number = recog (pat, insn, &num_clobbers_to_add);
+  insn_code_number = recog_with_fail_cache (pat, insn,
+					    &num_clobbers_to_add);
   if (dump_file && (dump_flags & TDF_DETAILS))
     {
       if (insn_code_number < 0)
@@ -11137,7 +11191,8 @@ recog_for_combine_1 (rtx *pnewpat, rtx_insn *insn, rtx *pnotes)
 	pat = XVECEXP (pat, 0, 0);
 
       PATTERN (insn) = pat;
-      insn_code_number = recog (pat, insn, &num_clobbers_to_add);
+      insn_code_number = recog_with_fail_cache (pat, insn,
+						&num_clobbers_to_add);
       if (dump_file && (dump_flags & TDF_DETAILS))
 	{
 	  if (insn_code_number < 0)
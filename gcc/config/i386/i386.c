@@ -181,6 +181,10 @@ struct processor_costs ix86_size_cost = {/* costs for tuning for size */
   1,					/* vec_align_load_cost.  */
   1,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  1,					/* gather_static_cost.  */
+  0,					/* gather_per_elt_cost.  */
+  1,					/* scatter_static_cost.  */
+  0,					/* scatter_per_elt_cost.  */
   1,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -257,6 +261,10 @@ struct processor_costs i386_cost = {	/* 386 specific costs */
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -334,6 +342,10 @@ struct processor_costs i486_cost = {	/* 486 specific costs */
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -409,6 +421,10 @@ struct processor_costs pentium_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -477,6 +493,10 @@ struct processor_costs lakemont_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -560,6 +580,10 @@ struct processor_costs pentiumpro_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -635,6 +659,10 @@ struct processor_costs geode_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -712,6 +740,10 @@ struct processor_costs k6_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -789,6 +821,10 @@ struct processor_costs athlon_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -876,6 +912,10 @@ struct processor_costs k8_cost = {
   2,					/* vec_align_load_cost.  */
   3,					/* vec_unalign_load_cost.  */
   3,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   2,					/* cond_not_taken_branch_cost.  */
 };
@@ -970,6 +1010,10 @@ struct processor_costs amdfam10_cost = {
   2,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   2,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   2,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1065,6 +1109,10 @@ const struct processor_costs bdver1_cost = {
   4,					/* vec_align_load_cost.  */
   4,					/* vec_unalign_load_cost.  */
   4,					/* vec_store_cost.  */
+  8,					/* gather_static_cost.  */
+  4,					/* gather_per_elt_cost.  */
+  8,					/* scatter_static_cost.  */
+  4,					/* scatter_per_elt_cost.  */
   4,					/* cond_taken_branch_cost.  */
   2,					/* cond_not_taken_branch_cost.  */
 };
@@ -1161,6 +1209,10 @@ const struct processor_costs bdver2_cost = {
   4,					/* vec_align_load_cost.  */
   4,					/* vec_unalign_load_cost.  */
   4,					/* vec_store_cost.  */
+  8,					/* gather_static_cost.  */
+  4,					/* gather_per_elt_cost.  */
+  8,					/* scatter_static_cost.  */
+  4,					/* scatter_per_elt_cost.  */
   4,					/* cond_taken_branch_cost.  */
   2,					/* cond_not_taken_branch_cost.  */
 };
@@ -1248,6 +1300,10 @@ struct processor_costs bdver3_cost = {
   4,					/* vec_align_load_cost.  */
   4,					/* vec_unalign_load_cost.  */
   4,					/* vec_store_cost.  */
+  8,					/* gather_static_cost.  */
+  4,					/* gather_per_elt_cost.  */
+  8,					/* scatter_static_cost.  */
+  4,					/* scatter_per_elt_cost.  */
   4,					/* cond_taken_branch_cost.  */
   2,					/* cond_not_taken_branch_cost.  */
 };
@@ -1334,6 +1390,10 @@ struct processor_costs bdver4_cost = {
   4,					/* vec_align_load_cost.  */
   4,					/* vec_unalign_load_cost.  */
   4,					/* vec_store_cost.  */
+  8,					/* gather_static_cost.  */
+  4,					/* gather_per_elt_cost.  */
+  8,					/* scatter_static_cost.  */
+  4,					/* scatter_per_elt_cost.  */
   4,					/* cond_taken_branch_cost.  */
   2,					/* cond_not_taken_branch_cost.  */
 };
@@ -1424,6 +1484,10 @@ struct processor_costs znver1_cost = {
   4,					/* vec_align_load_cost.  */
   4,					/* vec_unalign_load_cost.  */
   4,					/* vec_store_cost.  */
+  8,					/* gather_static_cost.  */
+  4,					/* gather_per_elt_cost.  */
+  8,					/* scatter_static_cost.  */
+  4,					/* scatter_per_elt_cost.  */
   4,					/* cond_taken_branch_cost.  */
   2,					/* cond_not_taken_branch_cost.  */
 };
@@ -1513,6 +1577,10 @@ const struct processor_costs btver1_cost = {
   2,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   2,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   2,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1598,6 +1666,10 @@ const struct processor_costs btver2_cost = {
   2,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   2,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   2,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1674,6 +1746,10 @@ struct processor_costs pentium4_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1753,6 +1829,10 @@ struct processor_costs nocona_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1830,6 +1910,10 @@ struct processor_costs atom_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1907,6 +1991,10 @@ struct processor_costs slm_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -1984,6 +2072,10 @@ struct processor_costs intel_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -2071,6 +2163,10 @@ struct processor_costs generic_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -2157,6 +2253,10 @@ struct processor_costs core_cost = {
   1,					/* vec_align_load_cost.  */
   2,					/* vec_unalign_load_cost.  */
   1,					/* vec_store_cost.  */
+  2,					/* gather_static_cost.  */
+  1,					/* gather_per_elt_cost.  */
+  2,					/* scatter_static_cost.  */
+  2,					/* scatter_per_elt_cost.  */
   3,					/* cond_taken_branch_cost.  */
   1,					/* cond_not_taken_branch_cost.  */
 };
@@ -2628,6 +2728,7 @@ static tree (*ix86_veclib_handler) (combined_fn, tree, tree);
 
 static tree ix86_veclibabi_svml (combined_fn, tree, tree);
 static tree ix86_veclibabi_acml (combined_fn, tree, tree);
+static tree ix86_veclibabi_libmvec (combined_fn, tree, tree);
 
 /* Processor target table, indexed by processor number */
 struct ptt
@@ -5987,6 +6088,10 @@ ix86_option_override_internal (bool main_args_p,
 	ix86_veclib_handler = ix86_veclibabi_acml;
 	break;
 
+      case ix86_veclibabi_type_libmvec:
+	ix86_veclib_handler = ix86_veclibabi_libmvec;
+	break;
+
       default:
 	gcc_unreachable ();
       }
@@ -27099,6 +27204,16 @@ alg_usable_p (enum stringop_alg alg, bool memset, bool have_as)
   return true;
 }
 
+/* Return true if ALGS hand blocks larger than the I-th size bucket
+   to the library.  */
+static bool
+decide_alg_libcall_above_p (const struct stringop_algs *algs, int i)
+{
+  if (i + 1 < MAX_STRINGOP_ALGS && algs->size[i + 1].max != 0)
+    return algs->size[i + 1].alg == libcall;
+  return algs->unknown_size == libcall;
+}
+
 /* Given COUNT and EXPECTED_SIZE, decide on codegen of string operation.  */
 static enum stringop_alg
 decide_alg (HOST_WIDE_INT count, HOST_WIDE_INT expected_size,
@@ -27209,6 +27324,16 @@ decide_alg (HOST_WIDE_INT count, HOST_WIDE_INT expected_size,
 	      else if (alg_usable_p (candidate, memset, have_as))
 		{
 		  *noalign = algs->size[i].noalign;
+		  /* When EXPECTED_SIZE comes from profile feedback but the
+		     block may be larger than this bucket, guard the inline
+		     expansion by a runtime check and dispatch the blocks
+		     the tables would hand to the library to a libcall.  */
+		  if (!recur
+		      && profile_status_for_fn (cfun) == PROFILE_READ
+		      && algs->size[i].max != -1
+		      && max_size > (unsigned HOST_WIDE_INT) algs->size[i].max
+		      && decide_alg_libcall_above_p (algs, i))
+		    *dynamic_check = algs->size[i].max + 1;
 		  return candidate;
 		}
 	    }
@@ -39240,6 +39365,95 @@ ix86_veclibabi_acml (combined_fn fn, tree type_out, tree type_in)
   return new_fndecl;
 }
 
+/* Handler for the x86-64 vector function ABI used by glibc's libmvec,
+   whose entry points are named _ZGV<isa>N<lanes><args>_<function>.  */
+
+static tree
+ix86_veclibabi_libmvec (combined_fn fn, tree type_out, tree type_in)
+{
+  char name[32];
+  tree fntype, new_fndecl;
+  const char *bname;
+  machine_mode el_mode, in_mode;
+  int n, in_n;
+  char isa;
+  bool binary_p = false;
+
+  /* libmvec only exists for x86-64, and its routines are not correctly
+     rounded, so glibc itself only uses them with -ffast-math.  */
+  if (!TARGET_64BIT
+      || !flag_unsafe_math_optimizations)
+    return NULL_TREE;
+
+  el_mode = TYPE_MODE (TREE_TYPE (type_out));
+  n = TYPE_VECTOR_SUBPARTS (type_out);
+  in_mode = TYPE_MODE (TREE_TYPE (type_in));
+  in_n = TYPE_VECTOR_SUBPARTS (type_in);
+  if (el_mode != in_mode
+      || n != in_n
+      || (el_mode != DFmode && el_mode != SFmode))
+    return NULL_TREE;
+
+  switch (fn)
+    {
+    CASE_CFN_POW:
+      binary_p = true;
+      /* FALLTHRU */
+    CASE_CFN_EXP:
+    CASE_CFN_LOG:
+    CASE_CFN_SIN:
+    CASE_CFN_COS:
+      break;
+
+    default:
+      return NULL_TREE;
+    }
+
+  /* Pick the variant for the vector size: SSE2 for 128 bits, AVX2 or
+     AVX for 256 bits and AVX-512 for 512 bits.  */
+  switch (GET_MODE_BITSIZE (TYPE_MODE (type_out)))
+    {
+    case 128:
+      isa = 'b';
+      break;
+    case 256:
+      if (TARGET_AVX2)
+	isa = 'd';
+      else if (TARGET_AVX)
+	isa = 'c';
+      else
+	return NULL_TREE;
+      break;
+    case 512:
+      if (!TARGET_AVX512F)
+	return NULL_TREE;
+      isa = 'e';
+      break;
+    default:
+      return NULL_TREE;
+    }
+
+  tree fndecl = mathfn_built_in (TREE_TYPE (type_in), fn);
+  bname = IDENTIFIER_POINTER (DECL_NAME (fndecl));
+  sprintf (name, "_ZGV%cN%d%s_%s", isa, n, binary_p ? "vv" : "v",
+	   bname + 10);
+
+  if (binary_p)
+    fntype = build_function_type_list (type_out, type_in, type_in, NULL);
+  else
+    fntype = build_function_type_list (type_out, type_in, NULL);
+
+  /* Build a function declaration for the vectorized function.  */
+  new_fndecl = build_decl (BUILTINS_LOCATION,
+			   FUNCTION_DECL, get_identifier (name), fntype);
+  TREE_PUBLIC (new_fndecl) = 1;
+  DECL_EXTERNAL (new_fndecl) = 1;
+  DECL_IS_NOVOPS (new_fndecl) = 1;
+  TREE_READONLY (new_fndecl) = 1;
+
+  return new_fndecl;
+}
+
 /* Returns a decl of a function that implements gather load with
    memory type MEM_VECTYPE and index type INDEX_VECTYPE and SCALE.
    Return NULL_TREE if it is not available.  */
@@ -45544,6 +45758,16 @@ ix86_builtin_vectorization_cost (enum vect_cost_for_stmt type_of_cost,
       case vec_construct:
 	return ix86_cost->vec_stmt_cost * (TYPE_VECTOR_SUBPARTS (vectype) - 1);
 
+      case vector_gather_load:
+	return (ix86_cost->gather_static_cost
+		+ ix86_cost->gather_per_elt_cost
+		  * TYPE_VECTOR_SUBPARTS (vectype));
+
+      case vector_scatter_store:
+	return (ix86_cost->scatter_static_cost
+		+ ix86_cost->scatter_per_elt_cost
+		  * TYPE_VECTOR_SUBPARTS (vectype));
+
       default:
         gcc_unreachable ();
     }
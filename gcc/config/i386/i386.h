@@ -270,6 +270,12 @@ struct processor_costs {
   const int vec_align_load_cost;   /* Cost of aligned vector load.  */
   const int vec_unalign_load_cost; /* Cost of unaligned vector load.  */
   const int vec_store_cost;        /* Cost of vector store.  */
+  const int gather_static_cost;    /* Cost of a vector gather load, in
+				      addition to the per element cost.  */
+  const int gather_per_elt_cost;   /* Cost of each gathered element.  */
+  const int scatter_static_cost;   /* Cost of a vector scatter store, in
+				      addition to the per element cost.  */
+  const int scatter_per_elt_cost;  /* Cost of each scattered element.  */
   const int cond_taken_branch_cost;    /* Cost of taken branch for vectorizer
 					  cost model.  */
   const int cond_not_taken_branch_cost;/* Cost of not taken branch for
@@ -60,6 +60,7 @@ struct GTY((chain_next ("%h.next"))) coverage_data
   unsigned cfg_checksum;	 /* function cfg checksum */
   tree fn_decl;			 /* the function decl */
   tree ctr_vars[GCOV_COUNTERS];	 /* counter variables.  */
+  unsigned n_arcs;		 /* number of arc counters per shard.  */
 };
 
 /* Counts information for a function.  */
@@ -96,6 +97,7 @@ static unsigned fn_b_ctrs[GCOV_COUNTERS]; /* Allocation base.  */
 
 /* Coverage info VAR_DECL and function info type nodes.  */
 static GTY(()) tree gcov_info_var;
+static GTY(()) tree gcov_bias_var;
 static GTY(()) tree gcov_fn_info_type;
 static GTY(()) tree gcov_fn_info_ptr_type;
 
@@ -485,6 +487,54 @@ tree_coverage_counter_addr (unsigned counter, unsigned no)
 				       NULL, NULL));
 }
 
+/* Return the number of thread shards of the edge counters.  With
+   -fprofile-update=sharded, the copies of the edge counters of each
+   function follow each other, and libgcov adds them together before
+   writing the profile.  */
+
+unsigned
+coverage_counter_shards (void)
+{
+  if (flag_profile_update != PROFILE_UPDATE_SHARDED)
+    return 1;
+  return 1u << floor_log2 (PARAM_VALUE (PARAM_PROFILE_UPDATE_SHARDS));
+}
+
+/* Return the number of counters between two thread shards of COUNTER in
+   the current function.  */
+
+unsigned
+coverage_counter_shard_stride (unsigned counter)
+{
+  return GCOV_SHARD_STRIDE (fn_n_ctrs[counter]);
+}
+
+/* Return the variable holding the offset from the edge counter variables
+   to the edge counters that the code updates, creating it if needed.
+   With -fprofile-continuous, libgcov sets it when it maps the counter
+   file of the object.  It is volatile, so that the compiler does not
+   assume it stays zero.  */
+
+tree
+coverage_counter_bias (void)
+{
+  if (!gcov_bias_var)
+    {
+      char name_buf[32];
+
+      gcov_bias_var = build_decl (BUILTINS_LOCATION, VAR_DECL, NULL_TREE,
+				  sizetype);
+      TREE_STATIC (gcov_bias_var) = 1;
+      TREE_ADDRESSABLE (gcov_bias_var) = 1;
+      TREE_THIS_VOLATILE (gcov_bias_var) = 1;
+      DECL_ARTIFICIAL (gcov_bias_var) = 1;
+      DECL_IGNORED_P (gcov_bias_var) = 1;
+      ASM_GENERATE_INTERNAL_LABEL (name_buf, "LPBX", 2);
+      DECL_NAME (gcov_bias_var) = get_identifier (name_buf);
+      varpool_node::finalize_decl (gcov_bias_var);
+    }
+  return gcov_bias_var;
+}
 
 /* Generate a checksum for a string.  CHKSUM is the current
    checksum.  */
@@ -701,6 +751,7 @@ coverage_end_function (unsigned lineno_checksum, unsigned cfg_checksum)
       item->cfg_checksum = cfg_checksum;
 
       item->fn_decl = current_function_decl;
+      item->n_arcs = fn_n_ctrs[GCOV_COUNTER_ARCS];
       item->next = 0;
       *functions_tail = item;
       functions_tail = &item->next;
@@ -713,7 +764,17 @@ coverage_end_function (unsigned lineno_checksum, unsigned cfg_checksum)
 	    item->ctr_vars[i] = var;
 	  if (var)
 	    {
-	      tree array_type = build_index_type (size_int (fn_n_ctrs[i] - 1));
+	      unsigned n_ctrs = fn_n_ctrs[i];
+	      unsigned shards = coverage_counter_shards ();
+	      if (i == GCOV_COUNTER_ARCS && shards > 1)
+		{
+		  n_ctrs = GCOV_SHARD_STRIDE (n_ctrs) * shards;
+		  SET_DECL_ALIGN (var, MAX (DECL_ALIGN (var),
+					    MIN (64 * BITS_PER_UNIT,
+						 MAX_OFILE_ALIGNMENT)));
+		  DECL_USER_ALIGN (var) = 1;
+		}
+	      tree array_type = build_index_type (size_int (n_ctrs - 1));
 	      array_type = build_array_type (get_gcov_type (), array_type);
 	      TREE_TYPE (var) = array_type;
 	      DECL_SIZE (var) = TYPE_SIZE (array_type);
@@ -864,7 +925,9 @@ build_fn_info (const struct coverage_data *data, tree type, tree key)
 	tree var = data->ctr_vars[ix];
 	unsigned count = 0;
 
-	if (var)
+	if (var && ix == GCOV_COUNTER_ARCS)
+	  count = data->n_arcs;
+	else if (var)
 	  count
 	    = tree_to_shwi (TYPE_MAX_VALUE (TYPE_DOMAIN (TREE_TYPE (var))))
 	    + 1;
@@ -948,6 +1011,18 @@ build_info_type (tree type, tree fn_info_ptr_type)
   DECL_CHAIN (field) = fields;
   fields = field;
 
+  /* n_shards */
+  field = build_decl (BUILTINS_LOCATION, FIELD_DECL, NULL_TREE,
+		      get_gcov_unsigned_t ());
+  DECL_CHAIN (field) = fields;
+  fields = field;
+
+  /* bias pointer */
+  field = build_decl (BUILTINS_LOCATION, FIELD_DECL, NULL_TREE,
+		      build_pointer_type (sizetype));
+  DECL_CHAIN (field) = fields;
+  fields = field;
+
   finish_builtin_struct (type, "__gcov_info", fields, NULL_TREE);
 }
 
@@ -1030,6 +1105,20 @@ build_info (tree info_type, tree fn_ary)
 			  build1 (ADDR_EXPR, TREE_TYPE (info_fields), fn_ary));
   info_fields = DECL_CHAIN (info_fields);
 
+  /* n_shards */
+  CONSTRUCTOR_APPEND_ELT (v1, info_fields,
+			  build_int_cstu (TREE_TYPE (info_fields),
+					  coverage_counter_shards ()));
+  info_fields = DECL_CHAIN (info_fields);
+
+  /* bias -- NULL unless the edge counters are relocated */
+  CONSTRUCTOR_APPEND_ELT (v1, info_fields,
+			  gcov_bias_var
+			  ? build1 (ADDR_EXPR, TREE_TYPE (info_fields),
+				    gcov_bias_var)
+			  : null_pointer_node);
+  info_fields = DECL_CHAIN (info_fields);
+
   gcc_assert (!info_fields);
   return build_constructor (info_type, v1);
 }
@@ -47,6 +47,12 @@ extern int coverage_counter_alloc (unsigned /*counter*/, unsigned/*num*/);
 extern tree tree_coverage_counter_ref (unsigned /*counter*/, unsigned/*num*/);
 /* Use a counter address from the most recent allocation.  */
 extern tree tree_coverage_counter_addr (unsigned /*counter*/, unsigned/*num*/);
+/* Number of thread shards of the edge counters.  */
+extern unsigned coverage_counter_shards (void);
+/* Number of counters between two thread shards in the current function.  */
+extern unsigned coverage_counter_shard_stride (unsigned /*counter*/);
+/* Offset of the edge counters in the memory-mapped counter file.  */
+extern tree coverage_counter_bias (void);
 
 /* Get all the counters for the current function.  */
 extern gcov_type *get_coverage_counts (unsigned /*counter*/,
@@ -1001,6 +1001,120 @@ modify_vtable_entry (tree t,
 }
 
 
+/* Until finish_struct_methods sorts it, the CLASSTYPE_METHOD_VEC of a
+   class being defined is in declaration order, so finding the slot for
+   a name takes a linear scan, and declaring the members of a class with
+   many member functions is quadratic.  For such classes we keep a hash
+   index from the names of the member functions to their slots while the
+   class is incomplete.  */
+
+/* Don't bother indexing method vectors shorter than this.  */
+#define METHOD_VEC_INDEX_MIN 16
+
+struct method_vec_index
+{
+  /* The method vector and the length it had when last indexed.  */
+  vec<tree, va_gc> *methods;
+  unsigned len;
+  hash_map<tree, unsigned> slots;
+};
+
+static hash_map<tree, method_vec_index *> *method_vec_indexes;
+
+/* Discard the method vector index of TYPE, if any.  */
+
+static void
+drop_method_vec_index (tree type)
+{
+  if (!method_vec_indexes)
+    return;
+  if (method_vec_index **idx = method_vec_indexes->get (type))
+    {
+      delete *idx;
+      method_vec_indexes->remove (type);
+    }
+}
+
+/* Return the method vector index of TYPE, building it from scratch if
+   the method vector changed other than by add_method appending to it.  */
+
+static method_vec_index *
+get_method_vec_index (tree type)
+{
+  vec<tree, va_gc> *methods = CLASSTYPE_METHOD_VEC (type);
+  unsigned len = methods->length ();
+
+  if (!method_vec_indexes)
+    method_vec_indexes = new hash_map<tree, method_vec_index *>;
+
+  bool existed;
+  method_vec_index *&idx = method_vec_indexes->get_or_insert (type, &existed);
+  if (existed && idx->methods == methods && idx->len == len)
+    return idx;
+
+  if (existed)
+    delete idx;
+  idx = new method_vec_index;
+  idx->methods = methods;
+  idx->len = len;
+  for (unsigned slot = CLASSTYPE_FIRST_CONVERSION_SLOT; slot < len; ++slot)
+    {
+      tree fn = (*methods)[slot];
+      if (fn && !DECL_CONV_FN_P (OVL_CURRENT (fn)))
+	idx->slots.put (DECL_NAME (OVL_CURRENT (fn)), slot);
+    }
+  return idx;
+}
+
+/* TYPE is an incomplete class type.  Return the slot of its method vector
+   holding the member functions named NAME, which must not name a
+   conversion operator, or -1 if there is none.  */
+
+int
+incomplete_method_vec_slot (tree type, tree name)
+{
+  vec<tree, va_gc> *methods = CLASSTYPE_METHOD_VEC (type);
+  unsigned len = vec_safe_length (methods);
+
+  if (len < METHOD_VEC_INDEX_MIN)
+    {
+      for (unsigned slot = CLASSTYPE_FIRST_CONVERSION_SLOT; slot < len; ++slot)
+	{
+	  tree fn = (*methods)[slot];
+	  if (fn
+	      && !DECL_CONV_FN_P (OVL_CURRENT (fn))
+	      && DECL_NAME (OVL_CURRENT (fn)) == name)
+	    return slot;
+	}
+      return -1;
+    }
+
+  unsigned *slot = get_method_vec_index (type)->slots.get (name);
+  return slot ? *slot : -1;
+}
+
+/* Note that add_method appended a slot for NAME to the method vector of
+   the incomplete class TYPE.  */
+
+static void
+note_method_vec_append (tree type, tree name)
+{
+  if (!method_vec_indexes)
+    return;
+  method_vec_index **idx = method_vec_indexes->get (type);
+  if (!idx)
+    return;
+
+  vec<tree, va_gc> *methods = CLASSTYPE_METHOD_VEC (type);
+  unsigned len = methods->length ();
+  if ((*idx)->len + 1 != len)
+    /* Out of date anyway; let get_method_vec_index rebuild it.  */
+    return;
+  (*idx)->methods = methods;
+  (*idx)->len = len;
+  (*idx)->slots.put (name, len - 1);
+}
+
 /* Add method METHOD to class TYPE.  If USING_DECL is non-null, it is
    the USING_DECL naming METHOD.  Returns true if the method could be
    added to the method vec.  */
@@ -1048,6 +1162,13 @@ add_method (tree type, tree method, tree using_decl)
     slot = CLASSTYPE_CONSTRUCTOR_SLOT;
   else if (DECL_MAYBE_IN_CHARGE_DESTRUCTOR_P (method))
     slot = CLASSTYPE_DESTRUCTOR_SLOT;
+  else if (!conv_p && !complete_p)
+    {
+      /* Look the name up in the index of the incomplete class.  */
+      int ix = incomplete_method_vec_slot (type, DECL_NAME (method));
+      insert_p = ix < 0;
+      slot = insert_p ? method_vec->length () : ix;
+    }
   else
     {
       tree m;
@@ -1280,7 +1401,11 @@ add_method (tree type, tree method, tree using_decl)
       if (reallocated)
 	CLASSTYPE_METHOD_VEC (type) = method_vec;
       if (slot == method_vec->length ())
-	method_vec->quick_push (overload);
+	{
+	  method_vec->quick_push (overload);
+	  if (!complete_p)
+	    note_method_vec_append (type, DECL_NAME (method));
+	}
       else
 	method_vec->quick_insert (slot, overload);
     }
@@ -2381,6 +2506,9 @@ finish_struct_methods (tree t)
   if (!method_vec)
     return;
 
+  /* We are about to sort the method vector.  */
+  drop_method_vec_index (t);
+
   len = method_vec->length ();
 
   /* Clear DECL_IN_AGGR_P for all functions.  */
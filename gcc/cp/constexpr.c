@@ -2817,7 +2817,11 @@ cxx_eval_vec_init_1 (const constexpr_ctx *ctx, tree atype, tree init,
 	CONSTRUCTOR_APPEND_ELT (*p, idx, eltinit);
       /* Reuse the result of cxx_eval_constant_expression call
 	  from the first iteration to all others if it is a constant
-	  initializer that doesn't require relocations.  */
+	  initializer that doesn't require relocations.  Represent the
+	  remaining elements with a single RANGE_EXPR rather than one
+	  element per index, so that large arrays stay cheap;
+	  find_array_ctor_elt splits the range if an element is later
+	  modified.  */
       if (reuse
 	  && max > 1
 	  && (initializer_constant_valid_p (eltinit, TREE_TYPE (eltinit))
@@ -2825,11 +2829,13 @@ cxx_eval_vec_init_1 (const constexpr_ctx *ctx, tree atype, tree init,
 	{
 	  if (new_ctx.ctor != ctx->ctor)
 	    eltinit = new_ctx.ctor;
-	  for (i = 1; i < max; ++i)
-	    {
-	      idx = build_int_cst (size_type_node, i);
-	      CONSTRUCTOR_APPEND_ELT (*p, idx, unshare_constructor (eltinit));
-	    }
+	  if (max > 2)
+	    idx = build2 (RANGE_EXPR, size_type_node,
+			  build_int_cst (size_type_node, 1),
+			  build_int_cst (size_type_node, max - 1));
+	  else
+	    idx = build_int_cst (size_type_node, 1);
+	  CONSTRUCTOR_APPEND_ELT (*p, idx, unshare_constructor (eltinit));
 	  break;
 	}
     }
@@ -5691,6 +5691,7 @@ extern tree build_vfn_ref			(tree, tree);
 extern tree get_vtable_decl			(tree, int);
 extern void resort_type_method_vec		(void *, void *,
 						 gt_pointer_operator, void *);
+extern int incomplete_method_vec_slot		(tree, tree);
 extern bool add_method				(tree, tree, tree);
 extern tree declared_access			(tree);
 extern tree currently_open_class		(tree);
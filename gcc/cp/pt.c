@@ -88,6 +88,64 @@ local_specialization_stack::~local_specialization_stack ()
   local_specializations = saved;
 }
 
+/* While the members of a class template specialization are being
+   instantiated, the same types are substituted into the same arguments
+   over and over -- think of every member of std::vector that mentions
+   value_type or const_reference.  A class_tsubst_memo records those
+   results for one class instantiation; see instantiate_class_template_1
+   and tsubst.  */
+
+struct class_tsubst_memo
+{
+  /* The arguments of the class being instantiated.  */
+  tree args;
+  /* The scope the members are instantiated in.  */
+  struct saved_scope *scope;
+  hash_map<tree, tree> map;
+};
+
+static class_tsubst_memo *current_class_tsubst_memo;
+
+/* Statistics for -fstats.  */
+static unsigned HOST_WIDE_INT class_tsubst_memo_hits;
+static unsigned HOST_WIDE_INT class_tsubst_memo_misses;
+
+/* Return true if the result of substituting ARGS into T under COMPLAIN
+   can be looked up in and recorded in current_class_tsubst_memo.  We
+   only remember types that are built from T and ARGS alone, and only
+   while still in the class scope that set up the memo, outside of any
+   function body or member template.  */
+
+static bool
+class_tsubst_memo_p (tree t, tree args, tsubst_flags_t complain)
+{
+  class_tsubst_memo *memo = current_class_tsubst_memo;
+
+  if (memo == NULL
+      || t == NULL_TREE
+      || args != memo->args
+      || scope_chain != memo->scope
+      || complain != tf_warning_or_error
+      || processing_template_decl
+      || local_specializations)
+    return false;
+
+  switch (TREE_CODE (t))
+    {
+    case RECORD_TYPE:
+      return !LAMBDA_TYPE_P (t);
+
+    case UNION_TYPE:
+    case POINTER_TYPE:
+    case REFERENCE_TYPE:
+    case TYPENAME_TYPE:
+      return true;
+
+    default:
+      return false;
+    }
+}
+
 /* True if we've recursed into fn_type_unification too many times.  */
 static bool excessive_deduction_depth;
 
@@ -10335,6 +10393,18 @@ instantiate_class_template_1 (tree type)
      class, except we also need to push the enclosing classes.  */
   push_nested_class (type);
 
+  /* Remember the types substituted while instantiating the members of a
+     non-local class.  */
+  class_tsubst_memo *saved_class_tsubst_memo = current_class_tsubst_memo;
+  class_tsubst_memo *memo = NULL;
+  if (!fn_context)
+    {
+      memo = new class_tsubst_memo;
+      memo->args = args;
+      memo->scope = scope_chain;
+    }
+  current_class_tsubst_memo = memo;
+
   /* Now members are processed in the order of declaration.  */
   for (member = CLASSTYPE_DECL_LIST (pattern);
        member; member = TREE_CHAIN (member))
@@ -10644,6 +10714,9 @@ instantiate_class_template_1 (tree type)
 	}
     }
 
+  current_class_tsubst_memo = saved_class_tsubst_memo;
+  delete memo;
+
   if (fn_context)
     {
       /* Restore these before substituting into the lambda capture
@@ -13226,24 +13299,10 @@ tsubst_exception_specification (tree fntype,
   return new_specs;
 }
 
-/* Take the tree structure T and replace template parameters used
-   therein with the argument vector ARGS.  IN_DECL is an associated
-   decl for diagnostics.  If an error occurs, returns ERROR_MARK_NODE.
-   Issue error and warning messages under control of COMPLAIN.  Note
-   that we must be relatively non-tolerant of extensions here, in
-   order to preserve conformance; if we allow substitutions that
-   should not be allowed, we may allow argument deductions that should
-   not succeed, and therefore report ambiguous overload situations
-   where there are none.  In theory, we could allow the substitution,
-   but indicate that it should have failed, and allow our caller to
-   make sure that the right thing happens, but we don't try to do this
-   yet.
-
-   This function is used for dealing with types, decls and the like;
-   for expressions, use tsubst_expr or tsubst_copy.  */
+/* Subroutine of tsubst, which see.  */
 
-tree
-tsubst (tree t, tree args, tsubst_flags_t complain, tree in_decl)
+static tree
+tsubst_1 (tree t, tree args, tsubst_flags_t complain, tree in_decl)
 {
   enum tree_code code;
   tree type, r = NULL_TREE;
@@ -14086,6 +14145,47 @@ tsubst (tree t, tree args, tsubst_flags_t complain, tree in_decl)
     }
 }
 
+/* Take the tree structure T and replace template parameters used
+   therein with the argument vector ARGS.  IN_DECL is an associated
+   decl for diagnostics.  If an error occurs, returns ERROR_MARK_NODE.
+   Issue error and warning messages under control of COMPLAIN.  Note
+   that we must be relatively non-tolerant of extensions here, in
+   order to preserve conformance; if we allow substitutions that
+   should not be allowed, we may allow argument deductions that should
+   not succeed, and therefore report ambiguous overload situations
+   where there are none.  In theory, we could allow the substitution,
+   but indicate that it should have failed, and allow our caller to
+   make sure that the right thing happens, but we don't try to do this
+   yet.
+
+   This function is used for dealing with types, decls and the like;
+   for expressions, use tsubst_expr or tsubst_copy.  */
+
+tree
+tsubst (tree t, tree args, tsubst_flags_t complain, tree in_decl)
+{
+  if (!class_tsubst_memo_p (t, args, complain))
+    return tsubst_1 (t, args, complain, in_decl);
+
+  class_tsubst_memo *memo = current_class_tsubst_memo;
+  if (tree *slot = memo->map.get (t))
+    {
+      ++class_tsubst_memo_hits;
+      return *slot;
+    }
+
+  /* Don't remember a substitution that issued diagnostics, so that
+     repeating it diagnoses again.  */
+  int errs = errorcount, warns = warningcount + werrorcount;
+  ++class_tsubst_memo_misses;
+  tree r = tsubst_1 (t, args, complain, in_decl);
+  if (r != error_mark_node
+      && errorcount == errs
+      && warningcount + werrorcount == warns)
+    memo->map.put (t, r);
+  return r;
+}
+
 /* Like tsubst_expr for a BASELINK.  OBJECT_TYPE, if non-NULL, is the
    type of the expression on the left-hand side of the "." or "->"
    operator.  */
@@ -25836,6 +25936,9 @@ print_template_statistics (void)
 	   "%f collisions\n", (long) type_specializations->size (),
 	   (long) type_specializations->elements (),
 	   type_specializations->collisions ());
+  fprintf (stderr, "class member type substitutions: %lu reused, "
+	   "%lu computed\n", (unsigned long) class_tsubst_memo_hits,
+	   (unsigned long) class_tsubst_memo_misses);
 }
 
 #include "gt-cp-pt.h"
@@ -30,6 +30,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "cp-tree.h"
 #include "stringpool.h"
 #include "toplev.h"
+#include "md5.h"
 
 static const char *extract_string (const char **);
 static const char *get_base_filename (const char *);
@@ -45,6 +46,10 @@ static const char *old_args, *old_dir, *old_main;
 static struct obstack temporary_obstack;
 static bool temporary_obstack_initialized_p;
 
+/* Name identifying this translation unit in the template instantiation
+   registry, or NULL if it has not been computed yet.  */
+static char *registry_owner;
+
 /* Parse a reasonable subset of shell quoting syntax.  */
 
 static const char *
@@ -274,6 +279,129 @@ finish_repo (void)
     fclose (repo_file);
 }
 
+/* Return the name of the file recording who emits DECL in the
+   template instantiation registry.  Entries are named after the MD5
+   sum of the mangled name, which by the ODR identifies the contents
+   of the instantiation as well.  The result must be freed.  */
+
+static char *
+registry_entry_name (tree decl)
+{
+  const char *name = IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (decl));
+  unsigned char sum[16];
+  char hex[2 * sizeof (sum) + 1];
+  unsigned ix;
+
+  md5_buffer (name, strlen (name), sum);
+  for (ix = 0; ix < sizeof (sum); ix++)
+    sprintf (hex + 2 * ix, "%02x", sum[ix]);
+
+  return concat (template_registry_dir, "/", hex, NULL);
+}
+
+/* Return 1 if the registry entry in file ENTRY names this translation
+   unit as the one emitting the instantiation.  An entry which is still
+   being written by its owner names another translation unit.  */
+
+static bool
+registry_entry_owned_p (const char *entry)
+{
+  size_t len = strlen (registry_owner);
+  char *buf = XNEWVEC (char, len + 2);
+  FILE *file = fopen (entry, "r");
+  bool owned = false;
+
+  if (file)
+    {
+      owned = (fgets (buf, len + 2, file)
+	       && strlen (buf) == len
+	       && memcmp (buf, registry_owner, len) == 0);
+      fclose (file);
+    }
+
+  XDELETEVEC (buf);
+  return owned;
+}
+
+/* The -ftemplate-registry variant of repo_emit_p.  The first
+   translation unit instantiating a function template specialization
+   atomically creates its registry entry and becomes responsible for
+   emitting it; all other translation units treat the specialization as
+   provided elsewhere and only instantiate it if it may be inlined.
+   Creating the entry with O_EXCL keeps the registry consistent when
+   several compilers share it in a parallel build.
+
+   The owner still emits the instantiation as a COMDAT, so an entity
+   emitted by an object outside the registry does not cause duplicate
+   definitions.  The registry has to be cleared whenever a translation
+   unit stops instantiating an entity it owns.  */
+
+static int
+registry_emit_p (tree decl)
+{
+  static bool registry_warned_p;
+  tree name;
+  char *entry;
+  int fd;
+
+  if (TREE_CODE (decl) != FUNCTION_DECL
+      || !DECL_TEMPLATE_INSTANTIATION (decl)
+      || DECL_EXPLICIT_INSTANTIATION (decl)
+      /* Constructor and destructor clones may share one definition
+	 through aliases, keep them together.  */
+      || DECL_MAYBE_IN_CHARGE_CONSTRUCTOR_P (decl)
+      || DECL_MAYBE_IN_CHARGE_DESTRUCTOR_P (decl)
+      || DECL_CLONED_FUNCTION_P (decl)
+      || flag_compare_debug)
+    return 2;
+
+  name = DECL_ASSEMBLER_NAME (decl);
+  if (IDENTIFIER_REPO_CHOSEN (name))
+    return 2;
+
+  if (!registry_owner)
+    registry_owner = IS_ABSOLUTE_PATH (main_input_filename)
+		     ? xstrdup (main_input_filename)
+		     : concat (getpwd (), "/", main_input_filename, NULL);
+
+  entry = registry_entry_name (decl);
+  fd = open (entry, O_WRONLY | O_CREAT | O_EXCL, 0666);
+  if (fd >= 0)
+    {
+      size_t len = strlen (registry_owner);
+      bool written = (write (fd, registry_owner, len) == (ssize_t) len);
+
+      if (close (fd) || !written)
+	{
+	  unlink (entry);
+	  free (entry);
+	  return 2;
+	}
+    }
+  else if (errno != EEXIST)
+    {
+      if (!registry_warned_p)
+	warning (0, "cannot use template instantiation registry %qs: %m",
+		 template_registry_dir);
+      registry_warned_p = true;
+      free (entry);
+      return 2;
+    }
+  else if (!registry_entry_owned_p (entry))
+    {
+      free (entry);
+      return 0;
+    }
+
+  free (entry);
+
+  /* This translation unit provides DECL for everybody else; make sure
+     it is emitted even if all local uses are inlined.  */
+  IDENTIFIER_REPO_CHOSEN (name) = 1;
+  mark_needed (decl);
+  return 2;
+}
+
 /* DECL is a FUNCTION_DECL or VAR_DECL with vague linkage whose
    definition is available in this translation unit.  Returns 0 if
    this definition should not be emitted in this translation unit
@@ -293,9 +421,10 @@ repo_emit_p (tree decl)
 		 maybe_clone_body.  */
 	      || DECL_ABSTRACT_ORIGIN (decl));
 
-  /* When not using the repository, emit everything.  */
+  /* When not using the repository, emit everything unless the
+     instantiation registry says otherwise.  */
   if (!flag_use_repository)
-    return 2;
+    return template_registry_dir ? registry_emit_p (decl) : 2;
 
   /* Only template instantiations are managed by the repository.  This
      is an artificial restriction; the code in the prelinker and here
@@ -747,6 +747,42 @@ build_dynamic_cast_1 (tree type, tree expr, tsubst_flags_t complain)
 	    }
 	  result = build_cxx_call (dcast_fn, 4, elems, complain);
 
+	  /* A final TARGET_TYPE can only be a complete object, so if
+	     STATIC_TYPE is its unique public non-virtual base at offset BOFF,
+	     the cast succeeds when the vtable says the complete object is a
+	     TARGET_TYPE that starts BOFF bytes before EXPR.  Check that
+	     inline and only call the runtime if it doesn't match, which
+	     includes the case where the type_info objects aren't merged.  */
+	  if (CLASSTYPE_FINAL (target_type)
+	      && tree_int_cst_sgn (boff) >= 0
+	      && optimize && !optimize_size)
+	    {
+	      tree obj = cp_build_indirect_ref (expr1, RO_NULL, complain);
+	      tree off = fold_build1 (NEGATE_EXPR, ssizetype,
+				      fold_convert (ssizetype, boff));
+	      tree index, ti, top, cond, hit;
+
+	      /* The RTTI information is at index -1.  */
+	      index = build_int_cst (NULL_TREE,
+				     -1 * TARGET_VTABLE_DATA_ENTRY_DISTANCE);
+	      ti = build_vtbl_ref (obj, index);
+	      /* The offset-to-top field is at index -2.  */
+	      index = build_int_cst (NULL_TREE,
+				     -2 * TARGET_VTABLE_DATA_ENTRY_DISTANCE);
+	      top = build_vtbl_ref (obj, index);
+
+	      cond = build2 (TRUTH_ANDIF_EXPR, boolean_type_node,
+			     build2 (EQ_EXPR, boolean_type_node,
+				     build_nop (ptr_type_node, ti),
+				     build_nop (ptr_type_node, td2)),
+			     build2 (EQ_EXPR, boolean_type_node,
+				     fold_convert (ssizetype, top), off));
+	      TREE_NO_WARNING (cond) = 1;
+	      hit = fold_build_pointer_plus (build_nop (ptr_type_node, expr1),
+					     off);
+	      result = build3 (COND_EXPR, ptr_type_node, cond, hit, result);
+	    }
+
 	  if (tc == REFERENCE_TYPE)
 	    {
 	      tree bad = throw_bad_cast ();
@@ -1631,13 +1631,7 @@ lookup_fnfields_idx_nolazy (tree type, tree name)
 	}
     }
   else
-    for (; vec_safe_iterate (method_vec, i, &fn); ++i)
-      {
-	if (GATHER_STATISTICS)
-	  n_outer_fields_searched++;
-	if (DECL_NAME (OVL_CURRENT (fn)) == name)
-	  return i;
-      }
+    return incomplete_method_vec_slot (type, name);
 
   return -1;
 }
@@ -20,12 +20,14 @@ along with GCC; see the file COPYING3.  If not see
 #include "config.h"
 #include "system.h"
 #include "coretypes.h"
+#include "backend.h"
 #include "options.h"
 #include "tree.h"
 #include "gimple-pretty-print.h"
 #include "diagnostic-core.h"
 #include "dumpfile.h"
 #include "context.h"
+#include "langhooks.h"
 
 /* If non-NULL, return one past-the-end of the matching SUBPART of
    the WHOLE string.  */
@@ -37,12 +39,19 @@ static int alt_flags;                /* current opt_info flags */
 
 static void dump_loc (int, FILE *, source_location);
 static FILE *dump_open_alternate_stream (struct dump_file_info *);
+static void opt_record_start (struct dump_file_info *);
+static void opt_record_finish (void);
+static bool opt_record_appending_p (int);
+static void opt_record_vprintf (const char *, va_list);
+static void opt_record_gimple_stmt (gimple *, int);
+static void opt_record_generic_expr (tree, int);
 
 /* These are currently used for communicating between passes.
    However, instead of accessing them directly, the passes can use
    dump_printf () for dumps.  */
 FILE *dump_file = NULL;
 FILE *alt_dump_file = NULL;
+FILE *opt_record_file = NULL;
 const char *dump_file_name;
 int dump_flags;
 
@@ -354,6 +363,9 @@ dump_gimple_stmt (int dump_kind, int extra_dump_flags, gimple *gs, int spc)
 
   if (alt_dump_file && (dump_kind & alt_flags))
     print_gimple_stmt (alt_dump_file, gs, spc, dump_flags | extra_dump_flags);
+
+  if (opt_record_appending_p (dump_kind))
+    opt_record_gimple_stmt (gs, dump_flags | extra_dump_flags);
 }
 
 /* Similar to dump_gimple_stmt, except additionally print source location.  */
@@ -373,6 +385,13 @@ dump_gimple_stmt_loc (int dump_kind, source_location loc, int extra_dump_flags,
       dump_loc (dump_kind, alt_dump_file, loc);
       print_gimple_stmt (alt_dump_file, gs, spc, dump_flags | extra_dump_flags);
     }
+
+  if (opt_record_file)
+    {
+      opt_record_begin (dump_kind, loc, current_function_decl);
+      if (opt_record_appending_p (dump_kind))
+	opt_record_gimple_stmt (gs, dump_flags | extra_dump_flags);
+    }
 }
 
 /* Dump expression tree T using EXTRA_DUMP_FLAGS on dump streams if
@@ -386,6 +405,9 @@ dump_generic_expr (int dump_kind, int extra_dump_flags, tree t)
 
   if (alt_dump_file && (dump_kind & alt_flags))
       print_generic_expr (alt_dump_file, t, dump_flags | extra_dump_flags);
+
+  if (opt_record_appending_p (dump_kind))
+    opt_record_generic_expr (t, dump_flags | extra_dump_flags);
 }
 
 
@@ -407,6 +429,13 @@ dump_generic_expr_loc (int dump_kind, source_location loc,
       dump_loc (dump_kind, alt_dump_file, loc);
       print_generic_expr (alt_dump_file, t, dump_flags | extra_dump_flags);
     }
+
+  if (opt_record_file)
+    {
+      opt_record_begin (dump_kind, loc, current_function_decl);
+      if (opt_record_appending_p (dump_kind))
+	opt_record_generic_expr (t, dump_flags | extra_dump_flags);
+    }
 }
 
 /* Output a formatted message using FORMAT on appropriate dump streams.  */
@@ -429,6 +458,14 @@ dump_printf (int dump_kind, const char *format, ...)
       vfprintf (alt_dump_file, format, ap);
       va_end (ap);
     }
+
+  if (opt_record_appending_p (dump_kind))
+    {
+      va_list ap;
+      va_start (ap, format);
+      opt_record_vprintf (format, ap);
+      va_end (ap);
+    }
 }
 
 /* Similar to dump_printf, except source location is also printed.  */
@@ -453,6 +490,332 @@ dump_printf_loc (int dump_kind, source_location loc, const char *format, ...)
       vfprintf (alt_dump_file, format, ap);
       va_end (ap);
     }
+
+  if (opt_record_file)
+    {
+      opt_record_begin (dump_kind, loc, current_function_decl);
+      if (opt_record_appending_p (dump_kind))
+	{
+	  va_list ap;
+	  va_start (ap, format);
+	  opt_record_vprintf (format, ap);
+	  va_end (ap);
+	}
+    }
+}
+
+/* The -fopt-record machinery.  Every optimized or missed-optimization
+   remark issued through the dump_*_loc functions, or through
+   opt_record_begin, by a pass belonging to an -fopt-info group becomes
+   one line of JSON in the record file, of the form
+
+     {"pass":"tree-vect","kind":"missed","file":"t.c","line":4,
+      "column":3,"function":"f","symbol":"f","hotness":1000,
+      "reason":"cost-model","message":"not vectorized: ...",
+      "params":{"min_profitable_iters":-1}}
+
+   The message holds the text printed by dump_printf and friends until
+   the next remark starts; the hotness, reason and params fields are
+   only present when known.  */
+
+/* The kinds of remarks which are recorded.  */
+#define OPT_RECORD_KINDS (MSG_OPTIMIZED_LOCATIONS | MSG_MISSED_OPTIMIZATION)
+
+/* A named number attached to a remark.  */
+struct opt_record_param_info
+{
+  const char *name;
+  HOST_WIDE_INT value;
+};
+
+/* The record file, open for the whole compilation.  OPT_RECORD_FILE
+   is set to it only while a pass that can issue remarks runs.  */
+static FILE *opt_record_stream;
+static int opt_record_state;
+
+/* The switch of the running pass, used as the "pass" field.  */
+static const char *opt_record_pass;
+
+/* The hotness given to the remarks to come, if OPT_RECORD_HAVE_HOTNESS.  */
+static bool opt_record_have_hotness;
+static gcov_type opt_record_cur_hotness;
+
+/* The remark being built.  */
+static struct
+{
+  bool pending;
+  int kind;
+  source_location loc;
+  tree fndecl;
+  bool have_hotness;
+  gcov_type hotness;
+  const char *reason;
+  vec<opt_record_param_info> params;
+  pretty_printer *text;
+} opt_record_cur;
+
+/* Open the record file if needed, and enable the remarks of the pass
+   dumping to DFI, if it belongs to an -fopt-info group.  */
+
+static void
+opt_record_start (struct dump_file_info *dfi)
+{
+  if (dfi->optgroup_flags == OPTGROUP_NONE)
+    return;
+
+  if (!opt_record_state)
+    {
+      opt_record_stream = strcmp ("stderr", flag_opt_record) == 0
+	? stderr
+	: strcmp ("stdout", flag_opt_record) == 0
+	? stdout
+	: fopen (flag_opt_record, "w");
+      if (!opt_record_stream)
+	error ("could not open optimization record file %qs: %m",
+	       flag_opt_record);
+      opt_record_state = 1;
+    }
+
+  opt_record_file = opt_record_stream;
+  opt_record_pass = dfi->swtch;
+}
+
+/* Return true if text dumped with DUMP_KIND belongs to the remark being
+   built.  */
+
+static bool
+opt_record_appending_p (int dump_kind)
+{
+  return opt_record_cur.pending && (dump_kind & opt_record_cur.kind);
+}
+
+/* Write the string STR to the record file as a JSON string, dropping
+   trailing white space.  */
+
+static void
+opt_record_write_string (const char *str)
+{
+  size_t len = strlen (str);
+  while (len && ISSPACE (str[len - 1]))
+    len--;
+
+  putc ('"', opt_record_stream);
+  for (size_t i = 0; i < len; i++)
+    {
+      unsigned char c = str[i];
+      if (c == '"' || c == '\\')
+	fprintf (opt_record_stream, "\\%c", c);
+      else if (c == '\n')
+	fputs ("\\n", opt_record_stream);
+      else if (c == '\t')
+	fputs ("\\t", opt_record_stream);
+      else if (c < 0x20)
+	fprintf (opt_record_stream, "\\u%04x", c);
+      else
+	putc (c, opt_record_stream);
+    }
+  putc ('"', opt_record_stream);
+}
+
+/* Write out the remark being built, if any.  */
+
+static void
+opt_record_flush (void)
+{
+  if (!opt_record_cur.pending)
+    return;
+  opt_record_cur.pending = false;
+
+  FILE *f = opt_record_stream;
+  tree fndecl = opt_record_cur.fndecl;
+  source_location loc = opt_record_cur.loc;
+  if (LOCATION_LOCUS (loc) <= BUILTINS_LOCATION && fndecl)
+    loc = DECL_SOURCE_LOCATION (fndecl);
+
+  fputs ("{\"pass\":", f);
+  opt_record_write_string (opt_record_pass);
+  fprintf (f, ",\"kind\":\"%s\"",
+	   opt_record_cur.kind == MSG_OPTIMIZED_LOCATIONS
+	   ? "optimized" : "missed");
+  if (LOCATION_LOCUS (loc) > BUILTINS_LOCATION)
+    {
+      expanded_location xloc = expand_location (loc);
+      fputs (",\"file\":", f);
+      opt_record_write_string (xloc.file);
+      fprintf (f, ",\"line\":%d,\"column\":%d", xloc.line, xloc.column);
+    }
+  if (fndecl)
+    {
+      fputs (",\"function\":", f);
+      opt_record_write_string (lang_hooks.decl_printable_name (fndecl, 2));
+      tree id = (DECL_ASSEMBLER_NAME_SET_P (fndecl)
+		 ? DECL_ASSEMBLER_NAME (fndecl) : DECL_NAME (fndecl));
+      if (id)
+	{
+	  fputs (",\"symbol\":", f);
+	  opt_record_write_string (IDENTIFIER_POINTER (id));
+	}
+    }
+  if (opt_record_cur.have_hotness)
+    fprintf (f, ",\"hotness\":%" PRId64, (int64_t) opt_record_cur.hotness);
+  if (opt_record_cur.reason)
+    {
+      fputs (",\"reason\":", f);
+      opt_record_write_string (opt_record_cur.reason);
+    }
+  fputs (",\"message\":", f);
+  opt_record_write_string (pp_formatted_text (opt_record_cur.text));
+  if (!opt_record_cur.params.is_empty ())
+    {
+      unsigned i;
+      opt_record_param_info *param;
+      fputs (",\"params\":{", f);
+      FOR_EACH_VEC_ELT (opt_record_cur.params, i, param)
+	{
+	  if (i)
+	    putc (',', f);
+	  opt_record_write_string (param->name);
+	  fprintf (f, ":" HOST_WIDE_INT_PRINT_DEC, param->value);
+	}
+      putc ('}', f);
+    }
+  fputs ("}\n", f);
+  fflush (f);
+}
+
+/* Write out the last remark of the running pass, and disable the
+   remarks until the next pass starts.  */
+
+static void
+opt_record_finish (void)
+{
+  if (!opt_record_file)
+    return;
+  opt_record_flush ();
+  opt_record_file = NULL;
+  opt_record_pass = NULL;
+  opt_record_have_hotness = false;
+}
+
+/* Start a remark of DUMP_KIND at LOC about function FNDECL (which may
+   be NULL), for the -fopt-record file.  Remarks which are neither
+   optimized nor missed-optimization ones are not recorded.  */
+
+void
+opt_record_begin (int dump_kind, source_location loc, tree fndecl)
+{
+  if (!opt_record_file)
+    return;
+  opt_record_flush ();
+  if (!(dump_kind & OPT_RECORD_KINDS))
+    return;
+
+  if (!opt_record_cur.text)
+    opt_record_cur.text = new pretty_printer ();
+  pp_clear_output_area (opt_record_cur.text);
+  opt_record_cur.params.truncate (0);
+  opt_record_cur.pending = true;
+  opt_record_cur.kind = (dump_kind & MSG_OPTIMIZED_LOCATIONS
+			 ? MSG_OPTIMIZED_LOCATIONS : MSG_MISSED_OPTIMIZATION);
+  opt_record_cur.loc = loc;
+  opt_record_cur.fndecl = fndecl;
+  opt_record_cur.reason = NULL;
+  opt_record_cur.have_hotness = opt_record_have_hotness;
+  opt_record_cur.hotness = opt_record_cur_hotness;
+  if (!opt_record_have_hotness
+      && fndecl && fndecl == current_function_decl
+      && cfun && cfun->cfg && profile_status_for_fn (cfun) == PROFILE_READ)
+    {
+      opt_record_cur.have_hotness = true;
+      opt_record_cur.hotness = ENTRY_BLOCK_PTR_FOR_FN (cfun)->count;
+    }
+}
+
+/* Append text formatted from FORMAT and AP to the remark being
+   built.  */
+
+static void
+opt_record_vprintf (const char *format, va_list ap)
+{
+  char *str = xvasprintf (format, ap);
+  pp_string (opt_record_cur.text, str);
+  free (str);
+}
+
+/* Append text formatted from FORMAT to the remark being built, if
+   any.  */
+
+void
+opt_record_printf (const char *format, ...)
+{
+  if (!opt_record_cur.pending)
+    return;
+  va_list ap;
+  va_start (ap, format);
+  opt_record_vprintf (format, ap);
+  va_end (ap);
+}
+
+/* Append statement GS, printed with FLAGS, to the remark being built.  */
+
+static void
+opt_record_gimple_stmt (gimple *gs, int flags)
+{
+  pp_gimple_stmt_1 (opt_record_cur.text, gs, 0, flags);
+}
+
+/* Append expression T, printed with FLAGS, to the remark being built.  */
+
+static void
+opt_record_generic_expr (tree t, int flags)
+{
+  dump_generic_node (opt_record_cur.text, t, 0, flags, false);
+}
+
+/* Set the reason code of the remark being built to REASON, a string
+   which must live until the end of the pass.  */
+
+void
+opt_record_reason (const char *reason)
+{
+  if (opt_record_cur.pending)
+    opt_record_cur.reason = reason;
+}
+
+/* Attach the number VALUE called NAME to the remark being built.  */
+
+void
+opt_record_param (const char *name, HOST_WIDE_INT value)
+{
+  if (!opt_record_cur.pending)
+    return;
+  opt_record_param_info param = { name, value };
+  opt_record_cur.params.safe_push (param);
+}
+
+/* Set the hotness of the remark being built to the profile count
+   COUNT.  */
+
+void
+opt_record_hotness (gcov_type count)
+{
+  if (!opt_record_cur.pending)
+    return;
+  opt_record_cur.have_hotness = true;
+  opt_record_cur.hotness = count;
+}
+
+/* Give the remarks started from now on, until the end of the pass or
+   the next call, the profile count COUNT as their hotness.  */
+
+void
+opt_record_default_hotness (gcov_type count)
+{
+  if (!opt_record_file)
+    return;
+  opt_record_flush ();
+  opt_record_have_hotness = true;
+  opt_record_cur_hotness = count;
 }
 
 /* Start a dump for PHASE. Store user-supplied dump flags in
@@ -469,6 +832,9 @@ dump_start (int phase, int *flag_ptr)
   char *name;
   struct dump_file_info *dfi;
   FILE *stream;
+  if (flag_opt_record && phase != TDI_none)
+    opt_record_start (get_dump_file_info (phase));
+
   if (phase == TDI_none || !dump_phase_enabled_p (phase))
     return 0;
 
@@ -520,6 +886,8 @@ dump_finish (int phase)
 {
   struct dump_file_info *dfi;
 
+  opt_record_finish ();
+
   if (phase < 0)
     return;
   dfi = get_dump_file_info (phase);
@@ -144,6 +144,12 @@ extern void dump_gimple_stmt_loc (int, source_location, int, gimple *, int);
 extern void dump_gimple_stmt (int, int, gimple *, int);
 extern void print_combine_total_stats (void);
 extern bool enable_rtl_dump_file (void);
+extern void opt_record_begin (int, source_location, tree);
+extern void opt_record_printf (const char *, ...) ATTRIBUTE_PRINTF_1;
+extern void opt_record_reason (const char *);
+extern void opt_record_param (const char *, HOST_WIDE_INT);
+extern void opt_record_hotness (gcov_type);
+extern void opt_record_default_hotness (gcov_type);
 
 /* In tree-dump.c  */
 extern void dump_node (const_tree, int, FILE *);
@@ -156,6 +162,7 @@ extern void dump_bb (FILE *, basic_block, int, int);
 /* Global variables used to communicate with passes.  */
 extern FILE *dump_file;
 extern FILE *alt_dump_file;
+extern FILE *opt_record_file;
 extern int dump_flags;
 extern const char *dump_file_name;
 
@@ -163,7 +170,7 @@ extern const char *dump_file_name;
 static inline bool
 dump_enabled_p (void)
 {
-  return (dump_file || alt_dump_file);
+  return (dump_file || alt_dump_file || opt_record_file);
 }
 
 namespace gcc {
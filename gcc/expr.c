@@ -1405,13 +1405,17 @@ clear_by_pieces (rtx to, unsigned HOST_WIDE_INT len, unsigned int align)
 /* Context used by compare_by_pieces_genfn.  It stores the fail label
    to jump to in case of miscomparison, and for branch ratios greater than 1,
    it stores an accumulator and the current and maximum counts before
-   emitting another branch.  */
+   emitting another branch.  For ordered comparisons, M_DIFF0 and M_DIFF1
+   are the word_mode registers that hold the last pieces compared, in an
+   order such that an unsigned comparison of them gives the sign of the
+   result.  */
 
 class compare_by_pieces_d : public op_by_pieces_d
 {
   rtx_code_label *m_fail_label;
   rtx m_accumulator;
   int m_count, m_batch;
+  rtx m_diff0, m_diff1;
 
   void generate (rtx, rtx, machine_mode);
   bool prepare_mode (machine_mode, unsigned int);
@@ -1419,10 +1423,12 @@ class compare_by_pieces_d : public op_by_pieces_d
  public:
   compare_by_pieces_d (rtx op0, rtx op1, by_pieces_constfn op1_cfn,
 		       void *op1_cfn_data, HOST_WIDE_INT len, int align,
-		       rtx_code_label *fail_label)
+		       rtx_code_label *fail_label, rtx diff0, rtx diff1)
     : op_by_pieces_d (op0, true, op1, true, op1_cfn, op1_cfn_data, len, align)
   {
     m_fail_label = fail_label;
+    m_diff0 = diff0;
+    m_diff1 = diff1;
   }
 };
 
@@ -1434,6 +1440,24 @@ class compare_by_pieces_d : public op_by_pieces_d
 void
 compare_by_pieces_d::generate (rtx op0, rtx op1, machine_mode mode)
 {
+  if (m_diff0)
+    {
+      /* memcmp orders by the first differing byte, so make it the most
+	 significant one.  */
+      op0 = force_reg (mode, op0);
+      op1 = force_reg (mode, op1);
+      if (!BYTES_BIG_ENDIAN && GET_MODE_SIZE (mode) > 1)
+	{
+	  op0 = expand_unop (mode, bswap_optab, op0, NULL_RTX, 1);
+	  op1 = expand_unop (mode, bswap_optab, op1, NULL_RTX, 1);
+	}
+      convert_move (m_diff0, op0, 1);
+      convert_move (m_diff1, op1, 1);
+      do_compare_rtx_and_jump (m_diff0, m_diff1, NE, true, word_mode,
+			       NULL_RTX, NULL, m_fail_label, -1);
+      return;
+    }
+
   if (m_batch > 1)
     {
       rtx temp = expand_binop (mode, sub_optab, op0, op1, NULL_RTX,
@@ -1467,6 +1491,18 @@ compare_by_pieces_d::prepare_mode (machine_mode mode, unsigned int align)
       || align < GET_MODE_ALIGNMENT (mode)
       || !can_compare_p (EQ, mode, ccp_jump))
     return false;
+  /* Ordered comparisons are done one piece at a time in word_mode,
+     after byte-swapping the pieces on little-endian targets.  */
+  if (m_diff0)
+    {
+      if (GET_MODE_SIZE (mode) > UNITS_PER_WORD
+	  || (!BYTES_BIG_ENDIAN
+	      && GET_MODE_SIZE (mode) > 1
+	      && optab_handler (bswap_optab, mode) == CODE_FOR_nothing))
+	return false;
+      m_batch = 1;
+      return true;
+    }
   m_batch = targetm.compare_by_pieces_branch_ratio (mode);
   if (m_batch < 0)
     return false;
@@ -1497,22 +1533,32 @@ compare_by_pieces_d::finish_mode (machine_mode mode)
 
    Optionally, the caller can pass a constfn and associated data in A1_CFN
    and A1_CFN_DATA. describing that the second operand being compared is a
-   known constant and how to obtain its data.  */
+   known constant and how to obtain its data.
+
+   If ORDERED, the result is negative, zero or positive like that of
+   memcmp rather than just zero or nonzero.  */
 
 static rtx
 compare_by_pieces (rtx arg0, rtx arg1, unsigned HOST_WIDE_INT len,
 		   rtx target, unsigned int align,
-		   by_pieces_constfn a1_cfn, void *a1_cfn_data)
+		   by_pieces_constfn a1_cfn, void *a1_cfn_data, bool ordered)
 {
   rtx_code_label *fail_label = gen_label_rtx ();
   rtx_code_label *end_label = gen_label_rtx ();
+  rtx diff0 = NULL_RTX, diff1 = NULL_RTX;
 
   if (target == NULL_RTX
       || !REG_P (target) || REGNO (target) < FIRST_PSEUDO_REGISTER)
     target = gen_reg_rtx (TYPE_MODE (integer_type_node));
 
+  if (ordered)
+    {
+      diff0 = gen_reg_rtx (word_mode);
+      diff1 = gen_reg_rtx (word_mode);
+    }
+
   compare_by_pieces_d data (arg0, arg1, a1_cfn, a1_cfn_data, len, align,
-			    fail_label);
+			    fail_label, diff0, diff1);
 
   data.run ();
 
@@ -1521,6 +1567,12 @@ compare_by_pieces (rtx arg0, rtx arg1, unsigned HOST_WIDE_INT len,
   emit_barrier ();
   emit_label (fail_label);
   emit_move_insn (target, const1_rtx);
+  if (ordered)
+    {
+      do_compare_rtx_and_jump (diff0, diff1, GTU, true, word_mode,
+			       NULL_RTX, NULL, end_label, -1);
+      emit_move_insn (target, constm1_rtx);
+    }
   emit_label (end_label);
 
   return target;
@@ -1967,7 +2019,15 @@ emit_block_cmp_hints (rtx x, rtx y, rtx len, tree len_type, rtx target,
       && CONST_INT_P (len)
       && can_do_by_pieces (INTVAL (len), align, COMPARE_BY_PIECES))
     result = compare_by_pieces (x, y, INTVAL (len), target, align,
-				y_cfn, y_cfndata);
+				y_cfn, y_cfndata, false);
+  /* The ordered comparison needs a branch per piece and byte swaps
+     on little-endian targets, only use it when optimizing for speed.  */
+  else if (!equality_only
+	   && CONST_INT_P (len)
+	   && optimize_insn_for_speed_p ()
+	   && can_do_by_pieces (INTVAL (len), align, COMPARE_BY_PIECES))
+    result = compare_by_pieces (x, y, INTVAL (len), target, align,
+				y_cfn, y_cfndata, true);
   else
     result = emit_block_cmp_via_cmpmem (x, y, len, len_type, target, align);
 
@@ -128,7 +128,8 @@ enum stack_reuse_level
 enum reorder_blocks_algorithm
 {
   REORDER_BLOCKS_ALGORITHM_SIMPLE,
-  REORDER_BLOCKS_ALGORITHM_STC
+  REORDER_BLOCKS_ALGORITHM_STC,
+  REORDER_BLOCKS_ALGORITHM_EXT_TSP
 };
 
 /* The algorithm used for the integrated register allocator (IRA).  */
@@ -275,6 +276,18 @@ enum lto_linker_output {
   LTO_LINKER_OUTPUT_EXEC
 };
 
+/* flag_reorder_functions_algorithm initialization values.  */
+enum reorder_functions_algorithm {
+  REORDER_FUNCTIONS_TIME_PROFILE,
+  REORDER_FUNCTIONS_CALL_CHAIN
+};
+
+/* flag_time_report_format initialization values.  */
+enum time_report_format {
+  TIME_REPORT_FORMAT_TEXT,
+  TIME_REPORT_FORMAT_JSON
+};
+
 /* gfortran -finit-real= values.  */
 
 enum gfc_init_local_real
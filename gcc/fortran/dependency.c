@@ -1395,6 +1395,27 @@ gfc_check_dependency (gfc_expr *expr1, gfc_expr *expr2, bool identical)
 }
 
 
+/* Compare two bounds or strides of array references like
+   gfc_dep_compare_expr, but also order integer expressions whose
+   difference is a known constant, such as X - 1 and X + 1.  */
+
+static int
+compare_bounds (gfc_expr *e1, gfc_expr *e2)
+{
+  mpz_t diff;
+  int result;
+
+  if (gfc_dep_difference (e1, e2, &diff))
+    {
+      result = mpz_sgn (diff);
+      mpz_clear (diff);
+      return result;
+    }
+
+  return gfc_dep_compare_expr (e1, e2);
+}
+
+
 /* Determines overlapping for two array sections.  */
 
 static gfc_dependency
@@ -1451,7 +1472,7 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
 	   && l_stride->ts.type == BT_INTEGER)
     l_dir = mpz_sgn (l_stride->value.integer);
   else if (l_start && l_end)
-    l_dir = gfc_dep_compare_expr (l_end, l_start);
+    l_dir = compare_bounds (l_end, l_start);
   else
     l_dir = -2;
 
@@ -1462,7 +1483,7 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
 	   && r_stride->ts.type == BT_INTEGER)
     r_dir = mpz_sgn (r_stride->value.integer);
   else if (r_start && r_end)
-    r_dir = gfc_dep_compare_expr (r_end, r_start);
+    r_dir = compare_bounds (r_end, r_start);
   else
     r_dir = -2;
 
@@ -1479,11 +1500,11 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
 
   one_expr = gfc_get_int_expr (gfc_index_integer_kind, NULL, 1);
 
-  stride_comparison = gfc_dep_compare_expr (l_stride ? l_stride : one_expr,
-					    r_stride ? r_stride : one_expr);
+  stride_comparison = compare_bounds (l_stride ? l_stride : one_expr,
+				      r_stride ? r_stride : one_expr);
 
   if (l_start && r_start)
-    start_comparison = gfc_dep_compare_expr (l_start, r_start);
+    start_comparison = compare_bounds (l_start, r_start);
   else
     start_comparison = -2;
 
@@ -1524,13 +1545,13 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
     }
 
   /* Check whether the ranges are disjoint.  */
-  if (l_upper && r_lower && gfc_dep_compare_expr (l_upper, r_lower) == -1)
+  if (l_upper && r_lower && compare_bounds (l_upper, r_lower) == -1)
     return GFC_DEP_NODEP;
-  if (r_upper && l_lower && gfc_dep_compare_expr (r_upper, l_lower) == -1)
+  if (r_upper && l_lower && compare_bounds (r_upper, l_lower) == -1)
     return GFC_DEP_NODEP;
 
   /* Handle cases like x:y:1 vs. x:z:-1 as GFC_DEP_EQUAL.  */
-  if (l_start && r_start && gfc_dep_compare_expr (l_start, r_start) == 0)
+  if (l_start && r_start && compare_bounds (l_start, r_start) == 0)
     {
       if (l_dir == 1 && r_dir == -1)
 	return GFC_DEP_EQUAL;
@@ -1539,7 +1560,7 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
     }
 
   /* Handle cases like x:y:1 vs. z:y:-1 as GFC_DEP_EQUAL.  */
-  if (l_end && r_end && gfc_dep_compare_expr (l_end, r_end) == 0)
+  if (l_end && r_end && compare_bounds (l_end, r_end) == 0)
     {
       if (l_dir == 1 && r_dir == -1)
 	return GFC_DEP_EQUAL;
@@ -1603,7 +1624,7 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
 	     of low, which is always at least a forward dependence.  */
 
 	  if (r_dir == 1
-	      && gfc_dep_compare_expr (l_start, l_ar->as->lower[n]) == 0)
+	      && compare_bounds (l_start, l_ar->as->lower[n]) == 0)
 	    return GFC_DEP_FORWARD;
 	}
     }
@@ -1618,7 +1639,7 @@ check_section_vs_section (gfc_array_ref *l_ar, gfc_array_ref *r_ar, int n)
 	     of high, which is always at least a forward dependence.  */
 
 	  if (r_dir == -1
-	      && gfc_dep_compare_expr (l_start, l_ar->as->upper[n]) == 0)
+	      && compare_bounds (l_start, l_ar->as->upper[n]) == 0)
 	    return GFC_DEP_FORWARD;
 	}
     }
@@ -1683,19 +1704,19 @@ gfc_check_element_vs_section( gfc_ref *lref, gfc_ref *rref, int n)
   if (s == 1)
     {
       /* Check for elem < lower.  */
-      if (start && gfc_dep_compare_expr (elem, start) == -1)
+      if (start && compare_bounds (elem, start) == -1)
 	return GFC_DEP_NODEP;
       /* Check for elem > upper.  */
-      if (end && gfc_dep_compare_expr (elem, end) == 1)
+      if (end && compare_bounds (elem, end) == 1)
 	return GFC_DEP_NODEP;
 
       if (start && end)
 	{
-	  s = gfc_dep_compare_expr (start, end);
+	  s = compare_bounds (start, end);
 	  /* Check for an empty range.  */
 	  if (s == 1)
 	    return GFC_DEP_NODEP;
-	  if (s == 0 && gfc_dep_compare_expr (elem, start) == 0)
+	  if (s == 0 && compare_bounds (elem, start) == 0)
 	    return GFC_DEP_EQUAL;
 	}
     }
@@ -1703,19 +1724,19 @@ gfc_check_element_vs_section( gfc_ref *lref, gfc_ref *rref, int n)
   else if (s == -1)
     {
       /* Check for elem > upper.  */
-      if (end && gfc_dep_compare_expr (elem, start) == 1)
+      if (end && compare_bounds (elem, start) == 1)
 	return GFC_DEP_NODEP;
       /* Check for elem < lower.  */
-      if (start && gfc_dep_compare_expr (elem, end) == -1)
+      if (start && compare_bounds (elem, end) == -1)
 	return GFC_DEP_NODEP;
 
       if (start && end)
 	{
-	  s = gfc_dep_compare_expr (start, end);
+	  s = compare_bounds (start, end);
 	  /* Check for an empty range.  */
 	  if (s == -1)
 	    return GFC_DEP_NODEP;
-	  if (s == 0 && gfc_dep_compare_expr (elem, start) == 0)
+	  if (s == 0 && compare_bounds (elem, start) == 0)
 	    return GFC_DEP_EQUAL;
 	}
     }
@@ -1724,33 +1745,33 @@ gfc_check_element_vs_section( gfc_ref *lref, gfc_ref *rref, int n)
     {
       if (!start || !end)
 	return GFC_DEP_OVERLAP;
-      s = gfc_dep_compare_expr (start, end);
+      s = compare_bounds (start, end);
       if (s <= -2)
 	return GFC_DEP_OVERLAP;
       /* Assume positive stride.  */
       if (s == -1)
 	{
 	  /* Check for elem < lower.  */
-	  if (gfc_dep_compare_expr (elem, start) == -1)
+	  if (compare_bounds (elem, start) == -1)
 	    return GFC_DEP_NODEP;
 	  /* Check for elem > upper.  */
-	  if (gfc_dep_compare_expr (elem, end) == 1)
+	  if (compare_bounds (elem, end) == 1)
 	    return GFC_DEP_NODEP;
 	}
       /* Assume negative stride.  */
       else if (s == 1)
 	{
 	  /* Check for elem > upper.  */
-	  if (gfc_dep_compare_expr (elem, start) == 1)
+	  if (compare_bounds (elem, start) == 1)
 	    return GFC_DEP_NODEP;
 	  /* Check for elem < lower.  */
-	  if (gfc_dep_compare_expr (elem, end) == -1)
+	  if (compare_bounds (elem, end) == -1)
 	    return GFC_DEP_NODEP;
 	}
       /* Equal bounds.  */
       else if (s == 0)
 	{
-	  s = gfc_dep_compare_expr (elem, start);
+	  s = compare_bounds (elem, start);
 	  if (s == 0)
 	    return GFC_DEP_EQUAL;
 	  if (s == 1 || s == -1)
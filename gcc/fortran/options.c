@@ -387,6 +387,14 @@ gfc_post_options (const char **pfilename)
   /* Implement -fno-automatic as -fmax-stack-var-size=0.  */
   if (!flag_automatic)
     flag_max_stack_var_size = 0;
+
+  /* Set the default size of the stack buffer for array temporaries and
+     keep it within the stack size limit for variables.  */
+  if (flag_stack_temporary_size == -1)
+    flag_stack_temporary_size = 1024;
+  if (flag_max_stack_var_size >= 0
+      && flag_stack_temporary_size > flag_max_stack_var_size)
+    flag_stack_temporary_size = flag_max_stack_var_size;
   
   /* If we call BLAS directly, only inline up to the BLAS limit.  */
 
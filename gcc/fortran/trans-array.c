@@ -795,6 +795,39 @@ gfc_set_loop_bounds_from_array_spec (gfc_interface_mapping * mapping,
 }
 
 
+/* Return a stack buffer of -fstack-temporary-size bytes for the data of
+   the temporary DESC, whose size is not known at compile time, or
+   NULL_TREE if the elements do not fit into it.  */
+
+static tree
+get_temporary_buffer (tree desc)
+{
+  tree elem_type;
+  unsigned HOST_WIDE_INT elem_size;
+  unsigned HOST_WIDE_INT nelem;
+  tree type;
+
+  if (flag_stack_temporary_size <= 0)
+    return NULL_TREE;
+
+  elem_type = gfc_get_element_type (TREE_TYPE (desc));
+  if (!TYPE_SIZE_UNIT (elem_type)
+      || !tree_fits_uhwi_p (TYPE_SIZE_UNIT (elem_type))
+      || integer_zerop (TYPE_SIZE_UNIT (elem_type)))
+    return NULL_TREE;
+
+  elem_size = tree_to_uhwi (TYPE_SIZE_UNIT (elem_type));
+  nelem = (unsigned HOST_WIDE_INT) flag_stack_temporary_size / elem_size;
+  if (nelem == 0)
+    return NULL_TREE;
+
+  type = build_range_type (gfc_array_index_type, gfc_index_zero_node,
+			   build_int_cst (gfc_array_index_type, nelem - 1));
+  type = build_array_type (elem_type, type);
+  return gfc_create_var (type, "A");
+}
+
+
 /* Generate code to allocate an array temporary, or create a variable to
    hold the data.  If size is NULL, zero the descriptor so that the
    callee will allocate the array.  If DEALLOC is true, also generate code to
@@ -814,6 +847,7 @@ gfc_trans_allocate_array_storage (stmtblock_t * pre, stmtblock_t * post,
 {
   tree tmp;
   tree desc;
+  tree buffer = NULL_TREE;
   bool onstack;
 
   desc = info->descriptor;
@@ -855,7 +889,38 @@ gfc_trans_allocate_array_storage (stmtblock_t * pre, stmtblock_t * post,
       else
 	{
 	  /* Allocate memory to hold the data or call internal_pack.  */
-	  if (initial == NULL_TREE)
+	  if (initial == NULL_TREE && !dynamic && dealloc
+	      && !INTEGER_CST_P (size))
+	    buffer = get_temporary_buffer (desc);
+
+	  if (buffer != NULL_TREE)
+	    {
+	      stmtblock_t do_malloc;
+	      tree data;
+	      tree fits;
+
+	      /* Use the buffer if the data fits into it, and the heap
+		 otherwise.  */
+	      data = gfc_create_var (pvoid_type_node, "data");
+	      gfc_start_block (&do_malloc);
+	      tmp = gfc_call_malloc (&do_malloc, pvoid_type_node, size);
+	      gfc_add_modify (&do_malloc, data, tmp);
+	      fits = fold_build2_loc (input_location, LE_EXPR,
+				      boolean_type_node,
+				      fold_convert (size_type_node, size),
+				      fold_convert (size_type_node,
+						    TYPE_SIZE_UNIT
+						    (TREE_TYPE (buffer))));
+	      tmp = fold_build2_loc (input_location, MODIFY_EXPR,
+				     void_type_node, data,
+				     gfc_build_addr_expr (pvoid_type_node,
+							  buffer));
+	      tmp = build3_v (COND_EXPR, fits, tmp,
+			      gfc_finish_block (&do_malloc));
+	      gfc_add_expr_to_block (pre, tmp);
+	      tmp = data;
+	    }
+	  else if (initial == NULL_TREE)
 	    {
 	      tmp = gfc_call_malloc (pre, NULL, size);
 	      tmp = gfc_evaluate_now (tmp, pre);
@@ -918,7 +983,20 @@ gfc_trans_allocate_array_storage (stmtblock_t * pre, stmtblock_t * post,
     {
       /* Free the temporary.  */
       tmp = gfc_conv_descriptor_data_get (desc);
-      tmp = gfc_call_free (tmp);
+      if (buffer != NULL_TREE)
+	{
+	  tree on_heap;
+
+	  on_heap = fold_build2_loc (input_location, NE_EXPR,
+				     boolean_type_node,
+				     fold_convert (pvoid_type_node, tmp),
+				     gfc_build_addr_expr (pvoid_type_node,
+							  buffer));
+	  tmp = build3_v (COND_EXPR, on_heap, gfc_call_free (tmp),
+			  build_empty_stmt (input_location));
+	}
+      else
+	tmp = gfc_call_free (tmp);
       gfc_add_expr_to_block (post, tmp);
     }
 }
@@ -1143,8 +1143,8 @@ static const char *cc1_options =
  %{fsyntax-only:-o %j} %{-param*}\
  %{coverage:-fprofile-arcs -ftest-coverage}\
  %{fprofile-arcs|fprofile-generate*|coverage:\
-   %{!fprofile-update=single:\
-     %{pthread:-fprofile-update=prefer-atomic}}}";
+   %{!fprofile-update=single:%{!fprofile-update=sharded:\
+     %{pthread:-fprofile-update=prefer-atomic}}}}";
 
 static const char *asm_options =
 "%{-target-help:%:print-asm-header()} "
@@ -3993,6 +3993,11 @@ driver_handle_option (struct gcc_options *opts,
       do_save = false;
       break;
 
+    case OPT_fcompile_jobs_:
+      /* Only the driver uses this; don't pass it to the compilers.  */
+      do_save = false;
+      break;
+
     case OPT_pipe:
       validated = true;
       /* These options set the variables specified in common.opt
@@ -8048,125 +8053,244 @@ driver::prepare_infiles ()
   return false;
 }
 
-/* Run the spec machinery on each input file.  */
+/* Run the spec machinery on input file I.  */
 
-void
-driver::do_spec_on_infiles () const
+static void
+do_spec_on_infile (int i)
 {
-  size_t i;
+  int this_file_error = 0;
 
-  for (i = 0; (int) i < n_infiles; i++)
-    {
-      int this_file_error = 0;
+  /* Tell do_spec what to substitute for %i.  */
 
-      /* Tell do_spec what to substitute for %i.  */
+  input_file_number = i;
+  set_input (infiles[i].name);
 
-      input_file_number = i;
-      set_input (infiles[i].name);
+  if (infiles[i].compiled)
+    return;
 
-      if (infiles[i].compiled)
-	continue;
+  /* Use the same thing in %o, unless cp->spec says otherwise.  */
 
-      /* Use the same thing in %o, unless cp->spec says otherwise.  */
+  outfiles[i] = gcc_input_filename;
 
-      outfiles[i] = gcc_input_filename;
+  /* Figure out which compiler from the file's suffix.  */
 
-      /* Figure out which compiler from the file's suffix.  */
+  input_file_compiler
+    = lookup_compiler (infiles[i].name, input_filename_length,
+		       infiles[i].language);
 
-      input_file_compiler
-	= lookup_compiler (infiles[i].name, input_filename_length,
-			   infiles[i].language);
+  if (input_file_compiler)
+    {
+      /* Ok, we found an applicable compiler.  Run its spec.  */
 
-      if (input_file_compiler)
+      if (input_file_compiler->spec[0] == '#')
+	{
+	  error ("%s: %s compiler not installed on this system",
+		 gcc_input_filename, &input_file_compiler->spec[1]);
+	  this_file_error = 1;
+	}
+      else
 	{
-	  /* Ok, we found an applicable compiler.  Run its spec.  */
+	  int value;
 
-	  if (input_file_compiler->spec[0] == '#')
+	  if (compare_debug)
 	    {
-	      error ("%s: %s compiler not installed on this system",
-		     gcc_input_filename, &input_file_compiler->spec[1]);
-	      this_file_error = 1;
+	      free (debug_check_temp_file[0]);
+	      debug_check_temp_file[0] = NULL;
+
+	      free (debug_check_temp_file[1]);
+	      debug_check_temp_file[1] = NULL;
 	    }
-	  else
-	    {
-	      int value;
 
-	      if (compare_debug)
-		{
-		  free (debug_check_temp_file[0]);
-		  debug_check_temp_file[0] = NULL;
+	  value = do_spec (input_file_compiler->spec);
+	  infiles[i].compiled = true;
+	  if (value < 0)
+	    this_file_error = 1;
+	  else if (compare_debug && debug_check_temp_file[0])
+	    {
+	      if (verbose_flag)
+		inform (0, "recompiling with -fcompare-debug");
 
-		  free (debug_check_temp_file[1]);
-		  debug_check_temp_file[1] = NULL;
-		}
+	      compare_debug = -compare_debug;
+	      n_switches = n_switches_debug_check[1];
+	      n_switches_alloc = n_switches_alloc_debug_check[1];
+	      switches = switches_debug_check[1];
 
 	      value = do_spec (input_file_compiler->spec);
-	      infiles[i].compiled = true;
+
+	      compare_debug = -compare_debug;
+	      n_switches = n_switches_debug_check[0];
+	      n_switches_alloc = n_switches_alloc_debug_check[0];
+	      switches = switches_debug_check[0];
+
 	      if (value < 0)
-		this_file_error = 1;
-	      else if (compare_debug && debug_check_temp_file[0])
 		{
-		  if (verbose_flag)
-		    inform (0, "recompiling with -fcompare-debug");
+		  error ("during -fcompare-debug recompilation");
+		  this_file_error = 1;
+		}
 
-		  compare_debug = -compare_debug;
-		  n_switches = n_switches_debug_check[1];
-		  n_switches_alloc = n_switches_alloc_debug_check[1];
-		  switches = switches_debug_check[1];
+	      gcc_assert (debug_check_temp_file[1]
+			  && filename_cmp (debug_check_temp_file[0],
+					   debug_check_temp_file[1]));
 
-		  value = do_spec (input_file_compiler->spec);
+	      if (verbose_flag)
+		inform (0, "comparing final insns dumps");
 
-		  compare_debug = -compare_debug;
-		  n_switches = n_switches_debug_check[0];
-		  n_switches_alloc = n_switches_alloc_debug_check[0];
-		  switches = switches_debug_check[0];
+	      if (compare_files (debug_check_temp_file))
+		this_file_error = 1;
+	    }
 
-		  if (value < 0)
-		    {
-		      error ("during -fcompare-debug recompilation");
-		      this_file_error = 1;
-		    }
+	  if (compare_debug)
+	    {
+	      free (debug_check_temp_file[0]);
+	      debug_check_temp_file[0] = NULL;
 
-		  gcc_assert (debug_check_temp_file[1]
-			      && filename_cmp (debug_check_temp_file[0],
-					       debug_check_temp_file[1]));
+	      free (debug_check_temp_file[1]);
+	      debug_check_temp_file[1] = NULL;
+	    }
+	}
+    }
 
-		  if (verbose_flag)
-		    inform (0, "comparing final insns dumps");
+  /* If this file's name does not contain a recognized suffix,
+     record it as explicit linker input.  */
 
-		  if (compare_files (debug_check_temp_file))
-		    this_file_error = 1;
-		}
+  else
+    explicit_link_files[i] = 1;
 
-	      if (compare_debug)
-		{
-		  free (debug_check_temp_file[0]);
-		  debug_check_temp_file[0] = NULL;
+  /* Clear the delete-on-failure queue, deleting the files in it
+     if this compilation failed.  */
 
-		  free (debug_check_temp_file[1]);
-		  debug_check_temp_file[1] = NULL;
-		}
-	    }
-	}
+  if (this_file_error)
+    {
+      delete_failure_queue ();
+      errorcount++;
+    }
+  /* If this compilation succeeded, don't delete those files later.  */
+  clear_failure_queue ();
+}
 
-      /* If this file's name does not contain a recognized suffix,
-	 record it as explicit linker input.  */
+#ifdef HAVE_WORKING_FORK
+/* Wait for a child of compile_infiles_in_parallel to finish and account
+   for its exit status as if its compilation had run in this process.  */
 
-      else
-	explicit_link_files[i] = 1;
+static void
+wait_for_compile_job (void)
+{
+  int status;
+  pid_t pid;
+
+  do
+    pid = waitpid (-1, &status, 0);
+  while (pid < 0 && errno == EINTR);
+
+  if (pid < 0)
+    {
+      errorcount++;
+      return;
+    }
+
+  if (WIFSIGNALED (status))
+    {
+      signal_count++;
+      errorcount++;
+    }
+  else if (WIFEXITED (status) && WEXITSTATUS (status) != 0)
+    {
+      int code = WEXITSTATUS (status);
+
+      /* Without -pass-exit-codes, a child only exits with 2 when one
+	 of its subprocesses was killed by a signal.  */
+      if (code == 2 && !pass_exit_codes)
+	signal_count++;
+      if (code > greatest_status)
+	greatest_status = code;
+      errorcount++;
+    }
+}
+
+/* Run the spec machinery on the input files in up to
+   flag_compile_jobs forked copies of the driver at a time, one per
+   input file that has a compiler.  Only used when nothing is linked,
+   so that the children need not report their output files back.  */
+
+static void
+compile_infiles_in_parallel (void)
+{
+  int i, running = 0;
+
+  for (i = 0; i < n_infiles; i++)
+    {
+      struct compiler *cp;
+      pid_t pid;
+
+      if (infiles[i].compiled)
+	continue;
+
+      set_input (infiles[i].name);
+      cp = lookup_compiler (infiles[i].name, input_filename_length,
+			    infiles[i].language);
+      if (cp == NULL || cp->spec[0] == '#')
+	{
+	  /* Let the usual path diagnose or record the file.  */
+	  do_spec_on_infile (i);
+	  continue;
+	}
 
-      /* Clear the delete-on-failure queue, deleting the files in it
-	 if this compilation failed.  */
+      if (running >= flag_compile_jobs)
+	{
+	  wait_for_compile_job ();
+	  running--;
+	}
 
-      if (this_file_error)
+      fflush (stdout);
+      fflush (stderr);
+      pid = fork ();
+      if (pid == 0)
+	{
+	  /* The temporary files made so far belong to the parent; the
+	     child only deletes its own, from the atexit handler.  */
+	  always_delete_queue = NULL;
+	  failure_delete_queue = NULL;
+	  do_spec_on_infile (i);
+	  exit (signal_count != 0 ? 2
+		: seen_error () ? (pass_exit_codes ? greatest_status : 1)
+		: 0);
+	}
+
+      if (pid < 0)
+	do_spec_on_infile (i);
+      else
 	{
-	  delete_failure_queue ();
-	  errorcount++;
+	  running++;
+	  outfiles[i] = gcc_input_filename;
+	  infiles[i].compiled = true;
 	}
-      /* If this compilation succeeded, don't delete those files later.  */
-      clear_failure_queue ();
     }
 
+  while (running-- > 0)
+    wait_for_compile_job ();
+}
+#endif
+
+/* Run the spec machinery on each input file.  */
+
+void
+driver::do_spec_on_infiles () const
+{
+  int i;
+
+#ifdef HAVE_WORKING_FORK
+  if (flag_compile_jobs > 1
+      && have_c && !have_E
+      && !combine_inputs
+      && !compare_debug
+      && !verbose_only_flag
+      && n_infiles > 1)
+    compile_infiles_in_parallel ();
+  else
+#endif
+    for (i = 0; i < n_infiles; i++)
+      do_spec_on_infile (i);
+
   /* Reset the input file name to the first compile/object file name, for use
      with %b in LINK_SPEC. We use the first input file that we can find
      a compiler to compile it instead of using infiles.language since for
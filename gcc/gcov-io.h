@@ -256,6 +256,11 @@ GCOV_COUNTERS
 };
 #undef DEF_GCOV_COUNTER
 
+/* Number of counters between two thread shards of an array of NUM edge
+   counters updated with -fprofile-update=sharded.  Shards are padded to
+   64 bytes so that threads do not share cache lines.  */
+#define GCOV_SHARD_STRIDE(NUM) (((NUM) + 7) & ~7u)
+
 /* Counters which can be summaried.  */
 #define GCOV_COUNTERS_SUMMABLE	(GCOV_COUNTER_ARCS + 1)
 
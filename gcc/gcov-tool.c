@@ -75,6 +75,25 @@ unlink_gcda_file (const char *name,
 }
 #endif
 
+#if HAVE_FTW_H
+
+/* Remove file NAME if it has a gcda suffix, and directory NAME if it is
+   empty.  */
+
+static int
+remove_profile_dir_entry (const char *name, const struct stat *status,
+			  int type, struct FTW *ftwbuf)
+{
+  if (type == FTW_DP)
+    {
+      rmdir (name);
+      return 0;
+    }
+
+  return unlink_gcda_file (name, status, type, ftwbuf);
+}
+#endif
+
 /* Remove the gcda files in PATH recursively.  */
 
 static int
@@ -87,6 +106,18 @@ unlink_profile_dir (const char *path ATTRIBUTE_UNUSED)
 #endif
 }
 
+/* Remove the gcda files in PATH recursively, and PATH itself.  */
+
+static int
+remove_profile_dir (const char *path ATTRIBUTE_UNUSED)
+{
+#if HAVE_FTW_H
+    return nftw(path, remove_profile_dir_entry, 64, FTW_DEPTH | FTW_PHYS);
+#else
+    return -1;
+#endif
+}
+
 /* Output GCOV_INFO lists PROFILE to directory OUT. Note that
    we will remove all the gcda files in OUT.  */
 
@@ -123,35 +154,137 @@ gcov_output_files (const char *out, struct gcov_info *profile)
   free (pwd);
 }
 
-/* Merging profile D1 and D2 with weight as W1 and W2, respectively.
-   The result profile is written to directory OUT.
-   Return 0 on success.  */
+/* Merge the profiles in the N directories DIRS, the first one with
+   weight W1 and the others with weight W2.  Return the merged profile,
+   or NULL on error.  */
 
-static int
-profile_merge (const char *d1, const char *d2, const char *out, int w1, int w2)
+static struct gcov_info *
+merge_profile_dirs (char **dirs, int n, int w1, int w2)
 {
   struct gcov_info *d1_profile;
-  struct gcov_info *d2_profile;
-  int ret;
+  int i;
 
-  d1_profile = gcov_read_profile_dir (d1, 0);
+  d1_profile = gcov_read_profile_dir (dirs[0], 0);
   if (!d1_profile)
-    return 1;
+    return NULL;
 
-  if (d2)
+  for (i = 1; i < n; i++)
     {
-      d2_profile = gcov_read_profile_dir (d2, 0);
+      struct gcov_info *d2_profile;
+
+      d2_profile = gcov_read_profile_dir (dirs[i], 0);
       if (!d2_profile)
-        return 1;
+        return NULL;
+
+      /* The actual merge: we overwrite to d1_profile.  The weight of
+	 d1_profile only applies once.  */
+      if (gcov_profile_merge (d1_profile, d2_profile, i == 1 ? w1 : 1, w2))
+        return NULL;
+    }
+
+  return d1_profile;
+}
+
+/* Wait for forked process and signal errors.  */
+#ifdef HAVE_WORKING_FORK
+static void
+wait_for_child ()
+{
+  int status;
+  do
+    {
+#ifndef WCONTINUED
+#define WCONTINUED 0
+#endif
+      int w = waitpid (0, &status, WUNTRACED | WCONTINUED);
+      if (w == -1)
+	fatal_error (input_location, "waitpid failed");
+
+      if (WIFEXITED (status) && WEXITSTATUS (status))
+	fatal_error (input_location, "merging subprocess failed");
+      else if (WIFSIGNALED (status))
+	fatal_error (input_location,
+		     "merging subprocess was killed by signal");
+    }
+  while (!WIFEXITED (status) && !WIFSIGNALED (status));
+}
+#endif
 
-      /* The actual merge: we overwrite to d1_profile.  */
-      ret = gcov_profile_merge (d1_profile, d2_profile, w1, w2);
+/* Merging the profiles in the N directories DIRS, the first one with
+   weight W1 and the others with weight W2.  The result profile is
+   written to directory OUT.  With JOBS greater than 1, the directories
+   are split into JOBS groups merged by forked processes into temporary
+   directories, which are then merged together.
+   Return 0 on success.  */
+
+static int
+profile_merge (char **dirs, int n, const char *out, int w1, int w2,
+	       int jobs ATTRIBUTE_UNUSED)
+{
+  struct gcov_info *profile;
 
-      if (ret)
-        return ret;
+#ifdef HAVE_WORKING_FORK
+  /* Give each process at least two directories.  */
+  if (MIN (jobs, n / 2) > 1)
+    {
+      int chunk = CEIL (n, MIN (jobs, n / 2));
+      int nparts = CEIL (n, chunk);
+      char **parts = XNEWVEC (char *, nparts);
+      int i, nruns = 0;
+
+      for (i = 0; i < nparts; i++)
+	{
+	  int first = i * chunk;
+	  int count = MIN (chunk, n - first);
+	  pid_t cpid;
+
+	  parts[i] = xasprintf ("%s.part%d", out, i);
+	  cpid = fork ();
+	  if (cpid > 0)
+	    {
+	      nruns++;
+	      continue;
+	    }
+
+	  profile = merge_profile_dirs (dirs + first, count,
+					first ? w2 : w1, w2);
+	  if (!cpid)
+	    {
+	      if (!profile)
+		exit (FATAL_EXIT_CODE);
+	      gcov_output_files (parts[i], profile);
+	      exit (SUCCESS_EXIT_CODE);
+	    }
+
+	  /* Fork failed; lets do the job ourseleves.  */
+	  if (!profile)
+	    return 1;
+	  gcov_output_files (parts[i], profile);
+	}
+
+      for (i = 0; i < nruns; i++)
+	wait_for_child ();
+
+      profile = merge_profile_dirs (parts, nparts, 1, 1);
+      if (profile)
+	gcov_output_files (out, profile);
+
+      for (i = 0; i < nparts; i++)
+	{
+	  remove_profile_dir (parts[i]);
+	  free (parts[i]);
+	}
+      free (parts);
+
+      return profile ? 0 : 1;
     }
+#endif
 
-  gcov_output_files (out, d1_profile);
+  profile = merge_profile_dirs (dirs, n, w1, w2);
+  if (!profile)
+    return 1;
+
+  gcov_output_files (out, profile);
 
   return 0;
 }
@@ -163,10 +296,11 @@ print_merge_usage_message (int error_p)
 {
   FILE *file = error_p ? stderr : stdout;
 
-  fnotice (file, "  merge [options] <dir1> <dir2>         Merge coverage file contents\n");
+  fnotice (file, "  merge [options] <dir1> <dir2> ...     Merge coverage file contents\n");
   fnotice (file, "    -v, --verbose                       Verbose mode\n");
   fnotice (file, "    -o, --output <dir>                  Output directory\n");
   fnotice (file, "    -w, --weight <w1,w2>                Set weights (float point values)\n");
+  fnotice (file, "    -j, --jobs <n>                      Merge with <n> processes\n");
 }
 
 static const struct option merge_options[] =
@@ -174,6 +308,7 @@ static const struct option merge_options[] =
   { "verbose",                no_argument,       NULL, 'v' },
   { "output",                 required_argument, NULL, 'o' },
   { "weight",                 required_argument, NULL, 'w' },
+  { "jobs",                   required_argument, NULL, 'j' },
   { 0, 0, 0, 0 }
 };
 
@@ -195,9 +330,10 @@ do_merge (int argc, char **argv)
   int opt;
   const char *output_dir = 0;
   int w1 = 1, w2 = 1;
+  int jobs = 1;
 
   optind = 0;
-  while ((opt = getopt_long (argc, argv, "vo:w:", merge_options, NULL)) != -1)
+  while ((opt = getopt_long (argc, argv, "vo:w:j:", merge_options, NULL)) != -1)
     {
       switch (opt)
         {
@@ -213,6 +349,11 @@ do_merge (int argc, char **argv)
           if (w1 < 0 || w2 < 0)
             fatal_error (input_location, "weights need to be non-negative\n");
           break;
+        case 'j':
+          jobs = atoi (optarg);
+          if (jobs < 1)
+            fatal_error (input_location, "number of jobs needs to be positive\n");
+          break;
         default:
           merge_usage ();
         }
@@ -221,10 +362,11 @@ do_merge (int argc, char **argv)
   if (output_dir == NULL)
     output_dir = "merged_profile";
 
-  if (argc - optind != 2)
+  if (argc - optind < 2)
     merge_usage ();
 
-  return profile_merge (argv[optind], argv[optind+1], output_dir, w1, w2);
+  return profile_merge (argv + optind, argc - optind, output_dir, w1, w2,
+			jobs);
 }
 
 /* If N_VAL is no-zero, normalize the profile by setting the largest counter
@@ -350,6 +350,17 @@ static int flag_display_progress = 0;
 
 static int flag_intermediate_format = 0;
 
+/* Write the output to stdout instead of .gcov files.  Together with
+   the intermediate format this gives a stream which can be piped
+   directly into a report generator.  */
+
+static int flag_use_stdout = 0;
+
+/* Do not regenerate the intermediate output file when it is newer
+   than the notes and data files it was produced from.  */
+
+static int flag_skip_unchanged = 0;
+
 /* Output demangled function names.  */
 
 static int flag_demangled_names = 0;
@@ -408,6 +419,7 @@ static void print_version (void) ATTRIBUTE_NORETURN;
 static void process_file (const char *);
 static void generate_results (const char *);
 static void create_file_names (const char *);
+static bool intermediate_file_up_to_date_p (const char *);
 static int name_search (const void *, const void *);
 static int name_sort (const void *, const void *);
 static char *canonicalize_name (const char *);
@@ -629,6 +641,14 @@ main (int argc, char **argv)
 
   first_arg = argno;
 
+  if (flag_skip_unchanged && !multiple_files
+      && intermediate_file_up_to_date_p (argv[first_arg]))
+    {
+      fnotice (stdout, "'%s' is up to date\n", argv[first_arg]);
+      release_structures ();
+      return 0;
+    }
+
   for (; argno != argc; argno++)
     {
       if (flag_display_progress)
@@ -661,6 +681,8 @@ print_usage (int error_p)
   fnotice (file, "  -c, --branch-counts             Output counts of branches taken\n\
                                     rather than percentages\n");
   fnotice (file, "  -d, --display-progress          Display progress information\n");
+  fnotice (file, "  -e, --skip-unchanged            Do not regenerate up to date intermediate\n\
+                                    output files\n");
   fnotice (file, "  -f, --function-summaries        Output summaries for each function\n");
   fnotice (file, "  -i, --intermediate-format       Output .gcov file in intermediate text format\n");
   fnotice (file, "  -l, --long-file-names           Use long output file names for included\n\
@@ -671,6 +693,7 @@ print_usage (int error_p)
   fnotice (file, "  -p, --preserve-paths            Preserve all pathname components\n");
   fnotice (file, "  -r, --relative-only             Only show data for relative sources\n");
   fnotice (file, "  -s, --source-prefix DIR         Source prefix to elide\n");
+  fnotice (file, "  -t, --stdout                    Output to stdout instead of a file\n");
   fnotice (file, "  -u, --unconditional-branches    Show unconditional branch counts too\n");
   fnotice (file, "  -v, --version                   Print version number, then exit\n");
   fnotice (file, "  -x, --hash-filenames            Hash long pathnames\n");
@@ -714,6 +737,8 @@ static const struct option options[] =
   { "unconditional-branches", no_argument,     NULL, 'u' },
   { "display-progress",     no_argument,       NULL, 'd' },
   { "hash-filenames",	    no_argument,       NULL, 'x' },
+  { "skip-unchanged",       no_argument,       NULL, 'e' },
+  { "stdout",               no_argument,       NULL, 't' },
   { 0, 0, 0, 0 }
 };
 
@@ -724,7 +749,7 @@ process_args (int argc, char **argv)
 {
   int opt;
 
-  const char *opts = "abcdfhilmno:prs:uvx";
+  const char *opts = "abcdefhilmno:prs:tuvx";
   while ((opt = getopt_long (argc, argv, opts, options, NULL)) != -1)
     {
       switch (opt)
@@ -776,6 +801,12 @@ process_args (int argc, char **argv)
         case 'd':
           flag_display_progress = 1;
           break;
+	case 'e':
+	  flag_skip_unchanged = 1;
+	  break;
+	case 't':
+	  flag_use_stdout = 1;
+	  break;
 	case 'v':
 	  print_version ();
 	case 'x':
@@ -1016,7 +1047,7 @@ generate_results (const char *file_name)
       memset (&coverage, 0, sizeof (coverage));
       coverage.name = flag_demangled_names ? fn->demangled_name : fn->name;
       add_line_counts (flag_function_summary ? &coverage : NULL, fn);
-      if (flag_function_summary)
+      if (flag_function_summary && !flag_use_stdout)
 	{
 	  function_summary (&coverage, "Function");
 	  fnotice (stdout, "\n");
@@ -1033,7 +1064,9 @@ generate_results (const char *file_name)
 	file_name = canonicalize_name (file_name);
     }
 
-  if (flag_gcov_file && flag_intermediate_format)
+  if (flag_gcov_file && flag_intermediate_format && flag_use_stdout)
+    gcov_intermediate_file = stdout;
+  else if (flag_gcov_file && flag_intermediate_format)
     {
       /* Open the intermediate file.  */
       gcov_intermediate_filename = get_gcov_intermediate_filename (file_name);
@@ -1063,7 +1096,8 @@ generate_results (const char *file_name)
 	}
 
       accumulate_line_counts (src);
-      function_summary (&src->coverage, "File");
+      if (!flag_use_stdout)
+	function_summary (&src->coverage, "File");
       total_lines += src->coverage.lines;
       total_executed += src->coverage.lines_executed;
       if (flag_gcov_file)
@@ -1072,20 +1106,26 @@ generate_results (const char *file_name)
             /* Output the intermediate format without requiring source
                files.  This outputs a section to a *single* file.  */
             output_intermediate_file (gcov_intermediate_file, src);
+	  else if (flag_use_stdout)
+	    {
+	      if (src->coverage.lines)
+		output_lines (stdout, src);
+	    }
           else
             output_gcov_file (file_name, src);
-          fnotice (stdout, "\n");
+	  if (!flag_use_stdout)
+	    fnotice (stdout, "\n");
         }
     }
 
-  if (flag_gcov_file && flag_intermediate_format)
+  if (flag_gcov_file && flag_intermediate_format && !flag_use_stdout)
     {
       /* Now we've finished writing the intermediate file.  */
       fclose (gcov_intermediate_file);
       XDELETEVEC (gcov_intermediate_filename);
     }
 
-  if (!file_name)
+  if (!file_name && !flag_use_stdout)
     executed_summary (total_lines, total_executed);
 }
 
@@ -1205,6 +1245,35 @@ create_file_names (const char *file_name)
   return;
 }
 
+/* Return true if the intermediate output file for FILE_NAME exists and
+   is newer than both the notes and the data file, so that regenerating
+   it would produce the same contents.  Large projects usually rerun
+   gcov on every object file although only a few of them changed.  */
+
+static bool
+intermediate_file_up_to_date_p (const char *file_name)
+{
+  struct stat out_status, status;
+  char *out_name;
+  bool up_to_date = false;
+
+  if (!flag_gcov_file || !flag_intermediate_format || flag_use_stdout)
+    return false;
+
+  create_file_names (file_name);
+  out_name = get_gcov_intermediate_filename (file_name);
+
+  if (!stat (out_name, &out_status)
+      && !stat (bbg_file_name, &status)
+      && status.st_mtime < out_status.st_mtime
+      && !stat (da_file_name, &status)
+      && status.st_mtime < out_status.st_mtime)
+    up_to_date = true;
+
+  free (out_name);
+  return up_to_date;
+}
+
 /* A is a string and B is a pointer to name_map_t.  Compare for file
    name orderability.  */
 
@@ -3668,9 +3668,16 @@ write_types (outf_p output_header, type_p structures,
 	oprintf (output_header, "#define gt_%s_", wtd->prefix);
 	output_mangled_typename (output_header, s);
 	oprintf (output_header, "(X) do { \\\n");
-	oprintf (output_header,
-		 "  if (X != NULL) gt_%sx_%s (X);\\\n", wtd->prefix,
-		 s_id_for_tag);
+	/* GC marking goes through an explicit mark stack so that long
+	   or deep structures do not recurse on the host stack.  */
+	if (wtd->kind == WTK_GGC)
+	  oprintf (output_header,
+		   "  if (X != NULL) ggc_mark_push ((void *) (X), "
+		   "gt_%sx_%s);\\\n", wtd->prefix, s_id_for_tag);
+	else
+	  oprintf (output_header,
+		   "  if (X != NULL) gt_%sx_%s (X);\\\n", wtd->prefix,
+		   s_id_for_tag);
 	oprintf (output_header, "  } while (0)\n");
 
 	for (opt = s->u.s.opt; opt; opt = opt->next)
@@ -3171,8 +3171,11 @@ dt_simplify::gen_1 (FILE *f, int indent, bool gimple, operand *result)
 	}
     }
 
-  fprintf_indent (f, indent, "if (dump_file && (dump_flags & TDF_DETAILS)) "
-	   "fprintf (dump_file, \"Applying pattern ");
+  /* Dumping is the cold path of every leaf; keep it out of line so the
+     matching code around it stays compact.  */
+  fprintf_indent (f, indent, "if (__builtin_expect (dump_file && "
+		  "(dump_flags & TDF_DETAILS), 0)) "
+		  "fprintf (dump_file, \"Applying pattern ");
   output_line_directive (f,
 			 result ? result->location : s->match->location, true);
   fprintf (f, ", %%s:%%d\\n\", __FILE__, __LINE__);\n");
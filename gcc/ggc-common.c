@@ -65,6 +65,53 @@ ggc_register_root_tab (const struct ggc_root_tab* rt)
     extra_root_vec.safe_push (rt);
 }
 
+/* The explicit mark stack.  Marker routines queue the objects they
+   point to here instead of recursing into them, so marking long or
+   deeply nested structures needs no host stack.  */
+struct ggc_mark_entry
+{
+  void *obj;
+  gt_pointer_walker fn;
+};
+static vec<ggc_mark_entry> ggc_mark_stack;
+
+/* True while the mark stack is being drained.  */
+static bool ggc_mark_stack_active;
+
+#if (GCC_VERSION < 3001)
+#define prefetch(X) ((void) X)
+#else
+#define prefetch(X) __builtin_prefetch (X)
+#endif
+
+/* Mark OBJ using FN.  Inside a marker routine just queue it, fetching
+   it into the cache while the routine finishes with its other fields;
+   at the outermost level walk it and everything it reaches, so that
+   the marks are complete when we return.  */
+
+void
+ggc_mark_push (void *obj, gt_pointer_walker fn)
+{
+  if (ggc_mark_stack_active)
+    {
+      ggc_mark_entry e = { obj, fn };
+      prefetch (obj);
+      ggc_mark_stack.safe_push (e);
+      return;
+    }
+
+  ggc_mark_stack_active = true;
+  (*fn) (obj);
+  while (!ggc_mark_stack.is_empty ())
+    {
+      ggc_mark_entry e = ggc_mark_stack.pop ();
+      if (!ggc_mark_stack.is_empty ())
+	prefetch (ggc_mark_stack.last ().obj);
+      (*e.fn) (e.obj);
+    }
+  ggc_mark_stack_active = false;
+}
+
 /* Mark all the roots in the table RT.  */
 
 static void
@@ -74,7 +121,7 @@ ggc_mark_root_tab (const_ggc_root_tab_t rt)
 
   for ( ; rt->base != NULL; rt++)
     for (i = 0; i < rt->nelt; i++)
-      (*rt->cb) (*(void **) ((char *)rt->base + rt->stride * i));
+      ggc_mark_push (*(void **) ((char *)rt->base + rt->stride * i), rt->cb);
 }
 
 /* Iterate through all registered roots and mark each element.  */
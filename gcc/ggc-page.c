@@ -1407,6 +1407,8 @@ ggc_internal_alloc (size_t size, void (*f)(void *), size_t s, size_t n
   /* For timevar statistics.  */
   timevar_ggc_mem_total += object_size;
 
+  mem_profile_alloc (MEM_PROFILE_GGC, object_size);
+
   if (f)
     add_finalizer (result, f, s, n);
 
@@ -1586,6 +1588,14 @@ ggc_get_size (const void *p)
   return OBJECT_SIZE (pe->order);
 }
 
+/* Return the number of bytes allocated in the GC heap.  */
+
+size_t
+ggc_allocated_bytes (void)
+{
+  return G.allocated;
+}
+
 /* Release the memory for object P.  */
 
 void
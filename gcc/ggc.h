@@ -86,6 +86,11 @@ extern const struct ggc_root_tab * const gt_pch_scalar_rtab[];
       ggc_set_mark (a__);			\
   } while (0)
 
+/* Mark the object X using the marker routine FN.  Called from inside
+   another marker routine, this only queues X on the mark stack;
+   otherwise it runs FN and drains the stack before returning.  */
+extern void ggc_mark_push (void *, gt_pointer_walker);
+
 /* Actually set the mark on a particular region of memory, but don't
    follow pointers.  This function is called by ggc_mark_*.  It
    returns zero if the object was not previously marked; nonzero if
@@ -263,6 +268,10 @@ extern void gt_pch_restore (FILE *f);
 /* Print allocation statistics.  */
 extern void ggc_print_statistics (void);
 
+/* Return the number of bytes allocated in the GC heap, including those
+   of objects which are no longer live but not yet collected.  */
+extern size_t ggc_allocated_bytes (void);
+
 extern void stringpool_statistics (void);
 
 /* Heuristics.  */
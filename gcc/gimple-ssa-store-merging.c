@@ -100,7 +100,23 @@
 
   Whereas for big-endian we emit:
   [p]      (32-bit) := 0x12345678; // (val & 0xffffffff0000) >> 16;
-  [p + 4B] (16-bit) := 0xabcd;     //  val & 0x00000000ffff;  */
+  [p + 4B] (16-bit) := 0xabcd;     //  val & 0x00000000ffff;
+
+  Besides constants the pass also handles copies of adjacent fields, that
+  is stores whose value is the result of a load from memory at the same
+  relative position from a common base:
+   _1 := [q     ];
+   [p     ] := _1;
+   _2 := [q + 1B];
+   [p + 1B] := _2;
+  Such stores are merged the same way, except that instead of building the
+  merged value at compile time a wide load from the source is emitted in
+  place of the first of the original loads:
+   _3 := [q] (16-bit);
+   [p] (16-bit) := _3;
+  Combining narrow loads with shifts and bitwise ORs into wider (possibly
+  byte-swapped) loads is done separately by the bswap pass in
+  tree-ssa-math-opts.c.  */
 
 #include "config.h"
 #include "system.h"
@@ -144,18 +160,43 @@ struct store_immediate_info
   unsigned HOST_WIDE_INT bitpos;
   gimple *stmt;
   unsigned int order;
+  /* INTEGER_CST for stores of constants, MEM_REF for stores of a value
+     loaded from memory by LOAD_STMT.  */
+  enum tree_code rhs_code;
+  /* For MEM_REF stores the base address and the bit position of the
+     load relative to it.  */
+  gimple *load_stmt;
+  tree load_base;
+  unsigned HOST_WIDE_INT load_bitpos;
   store_immediate_info (unsigned HOST_WIDE_INT, unsigned HOST_WIDE_INT,
 			gimple *, unsigned int);
+  void set_load (tree, unsigned HOST_WIDE_INT);
 };
 
 store_immediate_info::store_immediate_info (unsigned HOST_WIDE_INT bs,
 					    unsigned HOST_WIDE_INT bp,
 					    gimple *st,
 					    unsigned int ord)
-  : bitsize (bs), bitpos (bp), stmt (st), order (ord)
+  : bitsize (bs), bitpos (bp), stmt (st), order (ord), rhs_code (INTEGER_CST),
+    load_stmt (NULL), load_base (NULL_TREE), load_bitpos (0)
 {
 }
 
+/* Record that the stored value is loaded from LB at bit position LBP,
+   if LB is non-NULL.  */
+
+void
+store_immediate_info::set_load (tree lb, unsigned HOST_WIDE_INT lbp)
+{
+  if (lb == NULL_TREE)
+    return;
+
+  rhs_code = MEM_REF;
+  load_stmt = SSA_NAME_DEF_STMT (gimple_assign_rhs1 (stmt));
+  load_base = lb;
+  load_bitpos = lbp;
+}
+
 /* Struct representing a group of stores to contiguous memory locations.
    These are produced by the second phase (coalescing) and consumed in the
    third phase that outputs the widened stores.  */
@@ -179,11 +220,22 @@ struct merged_store_group
   gimple *first_stmt;
   unsigned char *val;
 
+  /* INTEGER_CST or MEM_REF, see store_immediate_info.  For MEM_REF
+     groups LOAD_BASE and LOAD_DELTA describe the source region: the load
+     for a store at bit position P is at P + LOAD_DELTA from LOAD_BASE.
+     FIRST_LOAD is the load that comes first in the statement stream.  */
+  enum tree_code rhs_code;
+  tree load_base;
+  HOST_WIDE_INT load_delta;
+  gimple *first_load;
+
   merged_store_group (store_immediate_info *);
   ~merged_store_group ();
+  bool compatible_store_p (store_immediate_info *);
   void merge_into (store_immediate_info *);
   void merge_overlapping (store_immediate_info *);
   bool apply_stores ();
+  bool check_loads ();
 };
 
 /* Debug helper.  Dump LEN elements of byte array PTR to FD in hex.  */
@@ -556,6 +608,15 @@ merged_store_group::merged_store_group (store_immediate_info *info)
   first_stmt = last_stmt;
   first_order = last_order;
   buf_size = 0;
+  rhs_code = info->rhs_code;
+  load_base = info->load_base;
+  load_delta
+    = (HOST_WIDE_INT) info->load_bitpos - (HOST_WIDE_INT) info->bitpos;
+  first_load = info->load_stmt;
+  /* The wide loads have to respect the alignment of the source too.  */
+  if (rhs_code == MEM_REF)
+    align = MIN (align,
+		 get_object_alignment (gimple_assign_rhs1 (info->load_stmt)));
 }
 
 merged_store_group::~merged_store_group ()
@@ -564,6 +625,23 @@ merged_store_group::~merged_store_group ()
     XDELETEVEC (val);
 }
 
+/* Return true if the store recorded by INFO can be merged into this
+   group, that is if it stores the same kind of value and, for copies,
+   loads it from the same relative position in the same object.  */
+
+bool
+merged_store_group::compatible_store_p (store_immediate_info *info)
+{
+  if (info->rhs_code != rhs_code)
+    return false;
+  if (rhs_code != MEM_REF)
+    return true;
+
+  return (operand_equal_p (info->load_base, load_base, 0)
+	  && ((HOST_WIDE_INT) info->load_bitpos
+	      - (HOST_WIDE_INT) info->bitpos) == load_delta);
+}
+
 /* Merge a store recorded by INFO into this merged store.
    The store is not overlapping with the existing recorded
    stores.  */
@@ -588,6 +666,10 @@ merged_store_group::merge_into (store_immediate_info *info)
       first_order = info->order;
       first_stmt = stmt;
     }
+  if (info->load_stmt
+      && first_load
+      && gimple_uid (info->load_stmt) < gimple_uid (first_load))
+    first_load = info->load_stmt;
 }
 
 /* Merge a store described by INFO into this merged store.
@@ -614,6 +696,10 @@ merged_store_group::merge_overlapping (store_immediate_info *info)
       first_order = info->order;
       first_stmt = stmt;
     }
+  if (info->load_stmt
+      && first_load
+      && gimple_uid (info->load_stmt) < gimple_uid (first_load))
+    first_load = info->load_stmt;
 }
 
 /* Go through all the recorded stores in this group in program order and
@@ -629,12 +715,25 @@ merged_store_group::apply_stores ()
      in the group, otherwise we cannot merge anything.  */
   if (width % BITS_PER_UNIT != 0
       || start % BITS_PER_UNIT != 0
-      || stores.length () == 1)
+      || stores.length () == 1
+      || rhs_code == ERROR_MARK)
     return false;
 
   stores.qsort (sort_by_order);
   struct store_immediate_info *info;
   unsigned int i;
+
+  /* Copies are output as wide loads and stores, there is no value to
+     build here.  Just make sure that the stores don't overlap and that
+     the loads can be combined.  */
+  if (rhs_code == MEM_REF)
+    {
+      unsigned HOST_WIDE_INT total = 0;
+      FOR_EACH_VEC_ELT (stores, i, info)
+	total += info->bitsize;
+      return total == width && check_loads ();
+    }
+
   /* Create a buffer of a size that is 2 times the number of bytes we're
      storing.  That way native_encode_expr can write power-of-2-sized
      chunks without overrunning.  */
@@ -668,6 +767,42 @@ merged_store_group::apply_stores ()
   return true;
 }
 
+/* Return true if a single wide load placed before FIRST_LOAD reads the
+   same values as the original loads of the copies in this group.  That
+   is the case unless a statement between FIRST_LOAD and one of the other
+   loads may clobber the memory that load reads.  */
+
+bool
+merged_store_group::check_loads ()
+{
+  struct store_immediate_info *info;
+  unsigned int i;
+  FOR_EACH_VEC_ELT (stores, i, info)
+    {
+      gimple *load = info->load_stmt;
+      if (load == first_load
+	  || gimple_vuse (load) == gimple_vuse (first_load))
+	continue;
+
+      tree ref = gimple_assign_rhs1 (load);
+      for (gimple_stmt_iterator gsi = gsi_for_stmt (first_load);
+	   gsi_stmt (gsi) != load; gsi_next (&gsi))
+	{
+	  gimple *stmt = gsi_stmt (gsi);
+	  if (gimple_vdef (stmt) && stmt_may_clobber_ref_p (stmt, ref))
+	    {
+	      if (dump_file && (dump_flags & TDF_DETAILS))
+		{
+		  fprintf (dump_file, "Load clobbered by stmt:\n");
+		  print_gimple_stmt (dump_file, stmt, 0, 0);
+		}
+	      return false;
+	    }
+	}
+    }
+  return true;
+}
+
 /* Structure describing the store chain.  */
 
 struct imm_store_chain_info
@@ -884,13 +1019,20 @@ imm_store_chain_info::coalesce_immediate_stores ()
       if (IN_RANGE (start, merged_store->start,
 		    merged_store->start + merged_store->width - 1))
 	{
+	  /* A constant overlapping a copy or copies from different places
+	     can't be merged.  Keep absorbing the overlapping stores into
+	     the group so that none of them is moved, but give up on it.  */
+	  if (!merged_store->compatible_store_p (info))
+	    merged_store->rhs_code = ERROR_MARK;
 	  merged_store->merge_overlapping (info);
 	  continue;
 	}
 
       /* |---store 1---| <gap> |---store 2---|.
-	 Gap between stores.  Start a new group.  */
-      if (start != merged_store->start + merged_store->width)
+	 Gap between stores or a store of a different kind.
+	 Start a new group.  */
+      if (start != merged_store->start + merged_store->width
+	  || !merged_store->compatible_store_p (info))
 	{
 	  /* Try to apply all the stores recorded for the group to determine
 	     the bitpattern they write and discard it if that fails.
@@ -930,15 +1072,17 @@ imm_store_chain_info::coalesce_immediate_stores ()
   return success;
 }
 
-/* Return the type to use for the merged stores described by STMTS.
+/* Return the type to use for the merged stores described by STMTS,
+   or for the merged loads if IS_LOAD.
    This is needed to get the alias sets right.  */
 
 static tree
-get_alias_type_for_stmts (auto_vec<gimple *> &stmts)
+get_alias_type_for_stmts (auto_vec<gimple *> &stmts, bool is_load)
 {
   gimple *stmt;
   unsigned int i;
-  tree lhs = gimple_assign_lhs (stmts[0]);
+  tree lhs = (is_load ? gimple_assign_rhs1 (stmts[0])
+	      : gimple_assign_lhs (stmts[0]));
   tree type = reference_alias_ptr_type (lhs);
 
   FOR_EACH_VEC_ELT (stmts, i, stmt)
@@ -946,7 +1090,7 @@ get_alias_type_for_stmts (auto_vec<gimple *> &stmts)
       if (i == 0)
 	continue;
 
-      lhs = gimple_assign_lhs (stmt);
+      lhs = is_load ? gimple_assign_rhs1 (stmt) : gimple_assign_lhs (stmt);
       tree type1 = reference_alias_ptr_type (lhs);
       if (!alias_ptr_types_compatible_p (type, type1))
 	return ptr_type_node;
@@ -979,6 +1123,7 @@ struct split_store
   unsigned HOST_WIDE_INT size;
   unsigned HOST_WIDE_INT align;
   auto_vec<gimple *> orig_stmts;
+  auto_vec<gimple *> orig_loads;
   split_store (unsigned HOST_WIDE_INT, unsigned HOST_WIDE_INT,
 	       unsigned HOST_WIDE_INT);
 };
@@ -991,16 +1136,18 @@ split_store::split_store (unsigned HOST_WIDE_INT bp,
 			  : bytepos (bp), size (sz), align (al)
 {
   orig_stmts.create (0);
+  orig_loads.create (0);
 }
 
 /* Record all statements corresponding to stores in GROUP that write to
    the region starting at BITPOS and is of size BITSIZE.  Record such
-   statements in STMTS.  The stores in GROUP must be sorted by
-   bitposition.  */
+   statements in STMTS and the loads feeding them, if any, in LOADS.
+   The stores in GROUP must be sorted by bitposition.  */
 
 static void
 find_constituent_stmts (struct merged_store_group *group,
 			 auto_vec<gimple *> &stmts,
+			 auto_vec<gimple *> &loads,
 			 unsigned HOST_WIDE_INT bitpos,
 			 unsigned HOST_WIDE_INT bitsize)
 {
@@ -1024,7 +1171,11 @@ find_constituent_stmts (struct merged_store_group *group,
 	     that this group writes.  Unlikely to occur but let's
 	     handle it.  */
 	  || IN_RANGE (bitpos, stmt_start, stmt_end))
-	stmts.safe_push (info->stmt);
+	{
+	  stmts.safe_push (info->stmt);
+	  if (info->load_stmt)
+	    loads.safe_push (info->load_stmt);
+	}
     }
 }
 
@@ -1071,7 +1222,8 @@ split_group (merged_store_group *group,
     {
       struct split_store *store = new split_store (try_pos, try_size, align);
       unsigned HOST_WIDE_INT try_bitpos = try_pos * BITS_PER_UNIT;
-      find_constituent_stmts (group, store->orig_stmts, try_bitpos, try_size);
+      find_constituent_stmts (group, store->orig_stmts, store->orig_loads,
+			      try_bitpos, try_size);
       split_stores.safe_push (store);
 
       try_pos += try_size / BITS_PER_UNIT;
@@ -1123,12 +1275,23 @@ imm_store_chain_info::output_merged_store (merged_store_group *group)
 
   tree addr = force_gimple_operand_1 (unshare_expr (base_addr), &seq,
 				      is_gimple_mem_ref_addr, NULL_TREE);
+
+  /* For copies the wide loads go before the first of the original loads,
+     in LOAD_SEQ.  */
+  gimple_seq load_seq = NULL;
+  tree load_addr = NULL_TREE;
+  if (group->rhs_code == MEM_REF)
+    load_addr = force_gimple_operand_1 (unshare_expr (group->load_base),
+					&load_seq, is_gimple_mem_ref_addr,
+					NULL_TREE);
+
   FOR_EACH_VEC_ELT (split_stores, i, split_store)
     {
       unsigned HOST_WIDE_INT try_size = split_store->size;
       unsigned HOST_WIDE_INT try_pos = split_store->bytepos;
       unsigned HOST_WIDE_INT align = split_store->align;
-      tree offset_type = get_alias_type_for_stmts (split_store->orig_stmts);
+      tree offset_type
+	= get_alias_type_for_stmts (split_store->orig_stmts, false);
       location_t loc = get_location_for_stmts (split_store->orig_stmts);
 
       tree int_type = build_nonstandard_integer_type (try_size, UNSIGNED);
@@ -1136,9 +1299,26 @@ imm_store_chain_info::output_merged_store (merged_store_group *group)
       tree dest = fold_build2 (MEM_REF, int_type, addr,
 			       build_int_cst (offset_type, try_pos));
 
-      tree src = native_interpret_expr (int_type,
-					group->val + try_pos - start_byte_pos,
-					group->buf_size);
+      tree src;
+      if (group->rhs_code == MEM_REF)
+	{
+	  tree load_offset_type
+	    = get_alias_type_for_stmts (split_store->orig_loads, true);
+	  HOST_WIDE_INT load_pos
+	    = try_pos + group->load_delta / BITS_PER_UNIT;
+	  tree mem = fold_build2 (MEM_REF, int_type, load_addr,
+				  build_int_cst (load_offset_type, load_pos));
+	  src = make_ssa_name (int_type);
+	  new_ssa_names.safe_push (src);
+	  gimple *load = gimple_build_assign (src, mem);
+	  gimple_set_location (load, loc);
+	  gimple_set_vuse (load, gimple_vuse (group->first_load));
+	  gimple_seq_add_stmt_without_update (&load_seq, load);
+	}
+      else
+	src = native_interpret_expr (int_type,
+				     group->val + try_pos - start_byte_pos,
+				     group->buf_size);
 
       stmt = gimple_build_assign (dest, src);
       gimple_set_location (stmt, loc);
@@ -1191,7 +1371,17 @@ imm_store_chain_info::output_merged_store (merged_store_group *group)
 	       "New sequence of %u stmts to replace old one of %u stmts\n",
 	       num_stmts, orig_num_stmts);
       if (dump_flags & TDF_DETAILS)
-	print_gimple_seq (dump_file, seq, 0, TDF_VOPS | TDF_MEMSYMS);
+	{
+	  if (load_seq)
+	    print_gimple_seq (dump_file, load_seq, 0,
+			      TDF_VOPS | TDF_MEMSYMS);
+	  print_gimple_seq (dump_file, seq, 0, TDF_VOPS | TDF_MEMSYMS);
+	}
+    }
+  if (load_seq)
+    {
+      gimple_stmt_iterator load_gsi = gsi_for_stmt (group->first_load);
+      gsi_insert_seq_before (&load_gsi, load_seq, GSI_SAME_STMT);
     }
   gsi_insert_seq_after (&last_gsi, seq, GSI_SAME_STMT);
 
@@ -1225,6 +1415,13 @@ imm_store_chain_info::output_merged_stores ()
 		  unlink_stmt_vdef (stmt);
 		  release_defs (stmt);
 		}
+	      /* The loaded value had no use other than the store.  */
+	      if (store->load_stmt)
+		{
+		  gsi = gsi_for_stmt (store->load_stmt);
+		  gsi_remove (&gsi, true);
+		  release_defs (store->load_stmt);
+		}
 	    }
 	  ret = true;
 	}
@@ -1296,6 +1493,126 @@ rhs_valid_for_store_merging_p (tree rhs)
   return true;
 }
 
+/* Analyze the memory reference MEM the way this pass records stores.
+   Return the base address of MEM with any constant byte offset folded
+   into *PBITPOS and set *PBITSIZE to its size.  *POFFSET is set to the
+   variable part of the offset, if any, in which case it is also added
+   to the returned base address.  Set *PINVALID if MEM can't take part
+   in store merging.  */
+
+static tree
+mem_base_for_store_merging (tree mem, HOST_WIDE_INT *pbitsize,
+			    HOST_WIDE_INT *pbitpos, tree *poffset,
+			    bool *pinvalid)
+{
+  HOST_WIDE_INT bitsize, bitpos;
+  machine_mode mode;
+  int unsignedp = 0, reversep = 0, volatilep = 0;
+  tree offset, base_addr;
+  base_addr
+    = get_inner_reference (mem, &bitsize, &bitpos, &offset, &mode,
+			   &unsignedp, &reversep, &volatilep);
+  bool invalid = reversep;
+
+  /* We do not want to rewrite TARGET_MEM_REFs.  */
+  if (TREE_CODE (base_addr) == TARGET_MEM_REF)
+    invalid = true;
+  /* In some cases get_inner_reference may return a
+     MEM_REF [ptr + byteoffset].  For the purposes of this pass
+     canonicalize the base_addr to MEM_REF [ptr] and take
+     byteoffset into account in the bitpos.  This occurs in
+     PR 23684 and this way we can catch more chains.  */
+  else if (TREE_CODE (base_addr) == MEM_REF)
+    {
+      offset_int bit_off, byte_off = mem_ref_offset (base_addr);
+      bit_off = byte_off << LOG2_BITS_PER_UNIT;
+      bit_off += bitpos;
+      if (!wi::neg_p (bit_off) && wi::fits_shwi_p (bit_off))
+	bitpos = bit_off.to_shwi ();
+      else
+	invalid = true;
+      base_addr = TREE_OPERAND (base_addr, 0);
+    }
+  /* get_inner_reference returns the base object, get at its
+     address now.  */
+  else
+    {
+      if (bitpos < 0)
+	invalid = true;
+      base_addr = build_fold_addr_expr (base_addr);
+    }
+
+  if (! invalid
+      && offset != NULL_TREE)
+    {
+      /* If the access is variable offset then a base
+	 decl has to be address-taken to be able to
+	 emit pointer-based stores to it.
+	 ???  We might be able to get away with
+	 re-using the original base up to the first
+	 variable part and then wrapping that inside
+	 a BIT_FIELD_REF.  */
+      tree base = get_base_address (base_addr);
+      if (! base
+	  || (DECL_P (base)
+	      && ! TREE_ADDRESSABLE (base)))
+	invalid = true;
+      else
+	base_addr = build2 (POINTER_PLUS_EXPR,
+			    TREE_TYPE (base_addr),
+			    base_addr, offset);
+    }
+
+  *pbitsize = bitsize;
+  *pbitpos = bitpos;
+  *poffset = offset;
+  *pinvalid = invalid;
+  return base_addr;
+}
+
+/* Return true if the store STMT of BITSIZE bits at BITPOS, whose value
+   is an SSA name, can be merged as a copy: the value has to be loaded
+   earlier in the same basic block by a statement that has no other use,
+   from a byte-aligned location of the same size.  Set *PLOAD_BASE and
+   *PLOAD_BITPOS to the base address and bit position of the load.  */
+
+static bool
+copy_valid_for_store_merging_p (gimple *stmt, HOST_WIDE_INT bitsize,
+				HOST_WIDE_INT bitpos, tree *pload_base,
+				HOST_WIDE_INT *pload_bitpos)
+{
+  tree rhs = gimple_assign_rhs1 (stmt);
+  if (bitsize % BITS_PER_UNIT != 0
+      || bitpos % BITS_PER_UNIT != 0
+      || !has_single_use (rhs))
+    return false;
+
+  gimple *load = SSA_NAME_DEF_STMT (rhs);
+  if (!gimple_assign_load_p (load)
+      || gimple_bb (load) != gimple_bb (stmt)
+      || gimple_has_volatile_ops (load)
+      || stmt_can_throw_internal (load))
+    return false;
+
+  tree mem = gimple_assign_rhs1 (load);
+  if (!lhs_valid_for_store_merging_p (mem))
+    return false;
+
+  HOST_WIDE_INT load_bitsize;
+  tree offset;
+  bool invalid;
+  tree load_base
+    = mem_base_for_store_merging (mem, &load_bitsize, pload_bitpos, &offset,
+				  &invalid);
+  if (invalid
+      || load_bitsize != bitsize
+      || *pload_bitpos % BITS_PER_UNIT != 0)
+    return false;
+
+  *pload_base = load_base;
+  return true;
+}
+
 /* Entry point for the pass.  Go over each basic block recording chains of
   immediate stores.  Upon encountering a terminating statement (as defined
   by stmt_terminates_chain_p) process the recorded stores and emit the widened
@@ -1329,9 +1646,14 @@ pass_store_merging::execute (function *fun)
       if (dump_file && (dump_flags & TDF_DETAILS))
 	fprintf (dump_file, "Processing basic block <%d>:\n", bb->index);
 
+      unsigned int uid = 0;
+
       for (gsi = gsi_after_labels (bb); !gsi_end_p (gsi); gsi_next (&gsi))
 	{
 	  gimple *stmt = gsi_stmt (gsi);
+	  /* Number the statements so that the loads feeding a group
+	     of copies can be ordered.  */
+	  gimple_set_uid (stmt, ++uid);
 
 	  if (gimple_has_volatile_ops (stmt))
 	    {
@@ -1354,67 +1676,28 @@ pass_store_merging::execute (function *fun)
 	      tree rhs = gimple_assign_rhs1 (stmt);
 
 	      HOST_WIDE_INT bitsize, bitpos;
-	      machine_mode mode;
-	      int unsignedp = 0, reversep = 0, volatilep = 0;
-	      tree offset, base_addr;
-	      base_addr
-		= get_inner_reference (lhs, &bitsize, &bitpos, &offset, &mode,
-				       &unsignedp, &reversep, &volatilep);
+	      tree offset;
+	      bool invalid;
+	      tree base_addr
+		= mem_base_for_store_merging (lhs, &bitsize, &bitpos, &offset,
+					      &invalid);
+	      tree load_base = NULL_TREE;
+	      HOST_WIDE_INT load_bitpos = 0;
 	      /* As a future enhancement we could handle stores with the same
 		 base and offset.  */
-	      bool invalid = reversep
-			     || ((bitsize > MAX_BITSIZE_MODE_ANY_INT)
-				  && (TREE_CODE (rhs) != INTEGER_CST))
-			     || !rhs_valid_for_store_merging_p (rhs);
-
-	      /* We do not want to rewrite TARGET_MEM_REFs.  */
-	      if (TREE_CODE (base_addr) == TARGET_MEM_REF)
+	      if ((bitsize > MAX_BITSIZE_MODE_ANY_INT)
+		  && (TREE_CODE (rhs) != INTEGER_CST))
 		invalid = true;
-	      /* In some cases get_inner_reference may return a
-		 MEM_REF [ptr + byteoffset].  For the purposes of this pass
-		 canonicalize the base_addr to MEM_REF [ptr] and take
-		 byteoffset into account in the bitpos.  This occurs in
-		 PR 23684 and this way we can catch more chains.  */
-	      else if (TREE_CODE (base_addr) == MEM_REF)
-		{
-		  offset_int bit_off, byte_off = mem_ref_offset (base_addr);
-		  bit_off = byte_off << LOG2_BITS_PER_UNIT;
-		  bit_off += bitpos;
-		  if (!wi::neg_p (bit_off) && wi::fits_shwi_p (bit_off))
-		    bitpos = bit_off.to_shwi ();
-		  else
-		    invalid = true;
-		  base_addr = TREE_OPERAND (base_addr, 0);
-		}
-	      /* get_inner_reference returns the base object, get at its
-	         address now.  */
-	      else
+	      else if (TREE_CODE (rhs) == SSA_NAME)
 		{
-		  if (bitpos < 0)
+		  if (invalid
+		      || !copy_valid_for_store_merging_p (stmt, bitsize, bitpos,
+							  &load_base,
+							  &load_bitpos))
 		    invalid = true;
-		  base_addr = build_fold_addr_expr (base_addr);
-		}
-
-	      if (! invalid
-		  && offset != NULL_TREE)
-		{
-		  /* If the access is variable offset then a base
-		     decl has to be address-taken to be able to
-		     emit pointer-based stores to it.
-		     ???  We might be able to get away with
-		     re-using the original base up to the first
-		     variable part and then wrapping that inside
-		     a BIT_FIELD_REF.  */
-		  tree base = get_base_address (base_addr);
-		  if (! base
-		      || (DECL_P (base)
-			  && ! TREE_ADDRESSABLE (base)))
-		    invalid = true;
-		  else
-		    base_addr = build2 (POINTER_PLUS_EXPR,
-					TREE_TYPE (base_addr),
-					base_addr, offset);
 		}
+	      else if (!rhs_valid_for_store_merging_p (rhs))
+		invalid = true;
 
 	      struct imm_store_chain_info **chain_info
 		= m_stores.get (base_addr);
@@ -1427,6 +1710,7 @@ pass_store_merging::execute (function *fun)
 		      info = new store_immediate_info (
 			bitsize, bitpos, stmt,
 			(*chain_info)->m_store_info.length ());
+		      info->set_load (load_base, load_bitpos);
 		      if (dump_file && (dump_flags & TDF_DETAILS))
 			{
 			  fprintf (dump_file,
@@ -1456,6 +1740,7 @@ pass_store_merging::execute (function *fun)
 		    = new imm_store_chain_info (base_addr);
 		  info = new store_immediate_info (bitsize, bitpos,
 						   stmt, 0);
+		  info->set_load (load_base, load_bitpos);
 		  new_chain->m_store_info.safe_push (info);
 		  m_stores.put (base_addr, new_chain);
 		  if (dump_file && (dump_flags & TDF_DETAILS))
@@ -678,9 +678,9 @@ Escape_note::parse_tag(std::string* tag)
 }
 
 
-// The -fgo-optimize-alloc flag activates this escape analysis.
+// Escape analysis is on by default; -fno-go-optimize-allocs turns it off.
 
-Go_optimize optimize_allocation_flag("allocs");
+Go_optimize optimize_allocation_flag("allocs", true);
 
 // Analyze the program flow for escape information.
 
@@ -9,22 +9,24 @@
 
 // This class manages different arguments to -fgo-optimize-XXX.  If you
 // want to create a new optimization, create a variable of this type with the
-// name to use for XXX.  You can then use is_enabled to see whether
-// the -fgo-optimize-XXX option was used on the command line.
+// name to use for XXX and whether it is on by default.  You can then use
+// is_enabled to see whether the optimization is enabled, taking
+// -fgo-optimize-XXX and -fno-go-optimize-XXX on the command line into
+// account.
 
 class Go_optimize
 {
  public:
-  Go_optimize(const char* name);
+  Go_optimize(const char* name, bool enabled);
 
   // Whether this optimizaiton was enabled.
   bool
   is_enabled() const
   { return this->is_enabled_; }
 
-  // Enable an optimization by name.  Return true if found.
+  // Enable or disable an optimization by name.  Return true if found.
   static bool
-  enable_by_name(const char*);
+  enable_by_name(const char*, bool);
 
  private:
   // The next optimize flag.  These are not in any order.
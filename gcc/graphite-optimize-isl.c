@@ -42,14 +42,158 @@ along with GCC; see the file COPYING3.  If not see
 #ifdef HAVE_ISL_OPTIONS_SET_SCHEDULE_SERIALIZE_SCCS
 /* isl 0.15 or later.  */
 
+/* Returns the bytes touched by a tile of SIZE iterations in each member of
+   a band, where COUNTS[N] is the sum of the element sizes of the references
+   whose subscripts vary with N members of the band.  The result saturates
+   at HOST_WIDE_INT_M1U.  */
+
+static unsigned HOST_WIDE_INT
+tile_footprint (const vec<unsigned HOST_WIDE_INT> &counts, long size)
+{
+  unsigned HOST_WIDE_INT total = 0;
+
+  for (unsigned n = 0; n < counts.length (); n++)
+    {
+      unsigned HOST_WIDE_INT bytes = counts[n];
+      for (unsigned i = 0; i < n && bytes; i++)
+	{
+	  if (bytes > HOST_WIDE_INT_M1U / size)
+	    return HOST_WIDE_INT_M1U;
+	  bytes *= size;
+	}
+      if (bytes > HOST_WIDE_INT_M1U - total)
+	return HOST_WIDE_INT_M1U;
+      total += bytes;
+    }
+
+  return total;
+}
+
+/* Returns the largest tile size such that the data touched by one tile of
+   that size in each member of a band fits in CACHE_BYTES, or 0 if even the
+   smallest tiles do not fit.  COUNTS is as for tile_footprint.  */
+
+static long
+tile_size_for_cache (const vec<unsigned HOST_WIDE_INT> &counts,
+		     unsigned HOST_WIDE_INT cache_bytes)
+{
+  long best = 0;
+
+  for (long size = 2; size <= 4096; size++)
+    {
+      if (tile_footprint (counts, size) > cache_bytes)
+	break;
+      best = size;
+    }
+
+  /* Prefer multiples of 8, they leave no remainder to vectorized code.  */
+  if (best >= 16)
+    best &= ~7L;
+
+  return best;
+}
+
+/* Returns the size in bytes of the data accessed by PDR.  */
+
+static HOST_WIDE_INT
+pdr_element_size (poly_dr_p pdr)
+{
+  HOST_WIDE_INT size = -1;
+
+  if (is_gimple_assign (pdr->stmt))
+    {
+      tree ref = (pdr_read_p (pdr)
+		  ? gimple_assign_rhs1 (pdr->stmt)
+		  : gimple_assign_lhs (pdr->stmt));
+      size = int_size_in_bytes (TREE_TYPE (ref));
+    }
+
+  return size > 0 ? size : UNITS_PER_WORD;
+}
+
+/* Compute in COUNTS, as described for tile_footprint, the data footprint of
+   the references of SCOP executed under the band NODE with DIMS members.
+   A reference varies with a member of the band when its access relation,
+   expressed in terms of the band, involves that member.  */
+
+static void
+band_data_footprint (scop_p scop, isl_schedule_node *node, unsigned dims,
+		     vec<unsigned HOST_WIDE_INT> *counts)
+{
+  isl_union_map *partial
+    = isl_schedule_node_band_get_partial_schedule_union_map (node);
+  partial = isl_union_map_intersect_domain (partial,
+					    isl_schedule_node_get_domain (node));
+
+  counts->safe_grow_cleared (dims + 1);
+
+  int i, j;
+  poly_bb_p pbb;
+  poly_dr_p pdr;
+  FOR_EACH_VEC_ELT (scop->pbbs, i, pbb)
+    FOR_EACH_VEC_ELT (PBB_DRS (pbb), j, pdr)
+      {
+	isl_union_map *acc
+	  = isl_union_map_from_map (isl_map_copy (pdr->accesses));
+	acc = isl_union_map_apply_domain (acc, isl_union_map_copy (partial));
+	if (isl_union_map_is_empty (acc))
+	  {
+	    isl_union_map_free (acc);
+	    continue;
+	  }
+
+	isl_map *band_acc = isl_map_from_union_map (acc);
+	unsigned n = 0;
+	for (unsigned k = 0; k < dims; k++)
+	  if (isl_map_involves_dims (band_acc, isl_dim_in, k, 1)
+	      == isl_bool_true)
+	    n++;
+	isl_map_free (band_acc);
+
+	(*counts)[n] += pdr_element_size (pdr);
+      }
+
+  isl_union_map_free (partial);
+}
+
+/* Tile the DIMS members of the band NODE by SIZE, except for the last one
+   which is tiled by LAST_SIZE, and return the point band.  */
+
+static __isl_give isl_schedule_node *
+tile_band (__isl_take isl_schedule_node *node, unsigned dims, long size,
+	   long last_size)
+{
+  isl_space *space = isl_schedule_node_band_get_space (node);
+  isl_multi_val *sizes = isl_multi_val_zero (space);
+  isl_ctx *ctx = isl_schedule_node_get_ctx (node);
+
+  for (unsigned i = 0; i < dims; i++)
+    {
+      long tile_size = i == dims - 1 ? last_size : size;
+      sizes = isl_multi_val_set_val (sizes, i,
+				     isl_val_int_from_si (ctx, tile_size));
+      if (dump_file && dump_flags)
+	fprintf (dump_file, "tiled by %ld\n", tile_size);
+    }
+
+  node = isl_schedule_node_band_tile (node, sizes);
+  return isl_schedule_node_child (node, 0);
+}
+
 /* get_schedule_for_node_st - Improve schedule for the schedule node.
-   Only Simple loop tiling is considered.  */
+   Only Simple loop tiling is considered.  USER is the SCOP.
+
+   Unless a fixed tile size is requested with --param loop-block-tile-size
+   or --param loop-block-cache-levels=0, the tile sizes come from the data
+   footprint of the band: the innermost tiles fit half of the L1 cache and,
+   for two cache levels, the tiles around them fit half of the L2 cache.
+   With --param loop-unroll-jam-size the innermost tiles are tiled once
+   more and all but their last member unrolled into registers.  */
 
 static __isl_give isl_schedule_node *
 get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
 {
-  if (user)
-    return node;
+  scop_p scop = (scop_p) user;
 
   if (isl_schedule_node_get_type (node) != isl_schedule_node_band
       || isl_schedule_node_n_children (node) != 1)
@@ -73,21 +217,44 @@ get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
     }
 
   /* Tile loops.  */
-  space = isl_schedule_node_band_get_space (node);
-  isl_multi_val *sizes = isl_multi_val_zero (space);
-  long tile_size = PARAM_VALUE (PARAM_LOOP_BLOCK_TILE_SIZE);
-  isl_ctx *ctx = isl_schedule_node_get_ctx (node);
+  int levels = PARAM_VALUE (PARAM_LOOP_BLOCK_CACHE_LEVELS);
+  if (levels == 0
+      || global_options_set.x_param_values[PARAM_LOOP_BLOCK_TILE_SIZE])
+    {
+      long tile_size = PARAM_VALUE (PARAM_LOOP_BLOCK_TILE_SIZE);
+      return tile_band (node, dims, tile_size, tile_size);
+    }
 
-  for (unsigned i = 0; i < dims; i++)
+  auto_vec<unsigned HOST_WIDE_INT> counts;
+  band_data_footprint (scop, node, dims, &counts);
+  long l1_size = tile_size_for_cache (counts, L1_CACHE_SIZE * 1024 / 2);
+  if (l1_size == 0)
     {
-      sizes = isl_multi_val_set_val (sizes, i,
-				     isl_val_int_from_si (ctx, tile_size));
       if (dump_file && dump_flags)
-	fprintf (dump_file, "tiled by %ld\n", tile_size);
+	fprintf (dump_file, "not tiled: footprint too large\n");
+      return node;
     }
 
-  node = isl_schedule_node_band_tile (node, sizes);
-  node = isl_schedule_node_child (node, 0);
+  if (levels > 1)
+    {
+      long l2_size = tile_size_for_cache (counts, L2_CACHE_SIZE * 1024 / 2);
+      l2_size -= l2_size % l1_size;
+      if (l2_size >= 2 * l1_size)
+	node = tile_band (node, dims, l2_size, l2_size);
+    }
+
+  node = tile_band (node, dims, l1_size, l1_size);
+
+  long unroll = PARAM_VALUE (PARAM_LOOP_UNROLL_JAM_SIZE);
+  if (unroll > 1 && unroll < l1_size)
+    {
+      node = tile_band (node, dims, unroll, 1);
+      for (unsigned i = 0; i < dims; i++)
+	node = isl_schedule_node_band_member_set_ast_loop_type
+	  (node, i, isl_ast_loop_unroll);
+      if (dump_file && dump_flags)
+	fprintf (dump_file, "unrolled and jammed by %ld\n", unroll);
+    }
 
   return node;
 }
@@ -150,7 +317,7 @@ optimize_isl (scop_p scop)
   scop->transformed_schedule = isl_schedule_constraints_compute_schedule (sc);
   scop->transformed_schedule =
     isl_schedule_map_schedule_node_bottom_up (scop->transformed_schedule,
-					      get_schedule_for_node_st, NULL);
+					      get_schedule_for_node_st, scop);
   isl_options_set_on_error (scop->isl_context, ISL_ON_ERROR_ABORT);
 
   isl_ctx_reset_operations (scop->isl_context);
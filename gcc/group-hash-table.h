@@ -0,0 +1,615 @@
+/* A hash table with per-slot control bytes probed a group at a time.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+/* This file implements group_hash_table, a drop-in alternative to
+   hash_table (see hash-table.h) that takes the same descriptors and
+   offers the same interface.
+
+   Besides the array of elements the table keeps one control byte per
+   slot.  A control byte is either GROUP_HASH_TABLE_EMPTY,
+   GROUP_HASH_TABLE_DELETED or, for a live slot, the low seven bits of
+   the (mixed) hash value of its element.  The slots are split into
+   groups of GROUP_HASH_TABLE_WIDTH and a lookup probes whole groups:
+   the control bytes of a group are compared against the hash byte at
+   once (with SSE2 where available) and Descriptor::equal is only
+   called for the few slots whose byte matches.  The probe stops at the
+   first group that contains an empty slot.  Most lookups therefore
+   touch one cache line of control bytes and one element, where
+   hash_table's double hashing touches a new cache line per collision.
+
+   Use it by passing it as the Table argument of hash_map or hash_set:
+
+      hash_map <tree, int, simple_hashmap_traits <default_hash_traits <tree>,
+						  int>,
+		group_hash_table> map;
+
+   The table cannot be allocated in GC memory, so such maps and sets
+   cannot be GTY roots.  */
+
+#ifndef GCC_GROUP_HASH_TABLE_H
+#define GCC_GROUP_HASH_TABLE_H
+
+/* Number of slots in a group; also the minimum size of a table.  */
+#define GROUP_HASH_TABLE_WIDTH 16
+
+/* Control byte values for slots that do not hold an element.  Both have
+   the top bit set, unlike the hash byte of a live slot.  */
+#define GROUP_HASH_TABLE_EMPTY ((unsigned char) 0x80)
+#define GROUP_HASH_TABLE_DELETED ((unsigned char) 0xfe)
+
+#if defined (__SSE2__) && GCC_VERSION >= 4005
+typedef char group_hash_table_v16qi __attribute__ ((__vector_size__ (16)));
+#endif
+
+/* Return a mask with bit I set if the I-th of the GROUP_HASH_TABLE_WIDTH
+   control bytes at CTRL is equal to BYTE.  */
+
+inline unsigned int
+group_hash_table_match (const unsigned char *ctrl, unsigned char byte)
+{
+#if defined (__SSE2__) && GCC_VERSION >= 4005
+  group_hash_table_v16qi data;
+  char c = byte;
+  const group_hash_table_v16qi splat = { c, c, c, c, c, c, c, c,
+					 c, c, c, c, c, c, c, c };
+  memcpy (&data, ctrl, sizeof (data));
+  return __builtin_ia32_pmovmskb128 (__builtin_ia32_pcmpeqb128 (data, splat));
+#else
+  unsigned int mask = 0;
+  for (unsigned int i = 0; i < GROUP_HASH_TABLE_WIDTH; i++)
+    if (ctrl[i] == byte)
+      mask |= 1u << i;
+  return mask;
+#endif
+}
+
+/* Return a mask with bit I set if the I-th control byte at CTRL denotes
+   an empty or deleted slot.  */
+
+inline unsigned int
+group_hash_table_match_free (const unsigned char *ctrl)
+{
+#if defined (__SSE2__) && GCC_VERSION >= 4005
+  group_hash_table_v16qi data;
+  memcpy (&data, ctrl, sizeof (data));
+  return __builtin_ia32_pmovmskb128 (data);
+#else
+  unsigned int mask = 0;
+  for (unsigned int i = 0; i < GROUP_HASH_TABLE_WIDTH; i++)
+    if (ctrl[i] & 0x80)
+      mask |= 1u << i;
+  return mask;
+#endif
+}
+
+/* Scramble HASH so that both the group index, taken from the high bits,
+   and the control byte, taken from the low bits, depend on all of its
+   bits.  Many of GCC's hash functions are weak in the low bits (pointers
+   shifted right by a few bits, for example).  */
+
+inline hashval_t
+group_hash_table_mix (hashval_t hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+template <typename Descriptor,
+	  template<typename Type> class Allocator = xcallocator>
+class group_hash_table
+{
+  typedef typename Descriptor::value_type value_type;
+  typedef typename Descriptor::compare_type compare_type;
+
+public:
+  explicit group_hash_table (size_t, bool ggc = false,
+			     bool gather_mem_stats = GATHER_STATISTICS,
+			     mem_alloc_origin origin = HASH_TABLE_ORIGIN
+			     CXX_MEM_STAT_INFO);
+  explicit group_hash_table (const group_hash_table &, bool ggc = false,
+			     bool gather_mem_stats = GATHER_STATISTICS,
+			     mem_alloc_origin origin = HASH_TABLE_ORIGIN
+			     CXX_MEM_STAT_INFO);
+  ~group_hash_table ();
+
+  /* Current size (in entries) of the hash table.  */
+  size_t size () const { return m_size; }
+
+  /* Return the current number of elements in this hash table.  */
+  size_t elements () const { return m_n_elements - m_n_deleted; }
+
+  /* Return the current number of elements in this hash table, including
+     the deleted ones.  */
+  size_t elements_with_deleted () const { return m_n_elements; }
+
+  /* This function clears all entries in this hash table.  */
+  void empty () { if (elements ()) empty_slow (); }
+
+  /* See hash_table for the description of the functions below.  */
+  void clear_slot (value_type *);
+
+  value_type &find_with_hash (const compare_type &, hashval_t);
+
+  value_type &find (const value_type &value)
+    {
+      return find_with_hash (value, Descriptor::hash (value));
+    }
+
+  value_type *find_slot (const value_type &value, insert_option insert)
+    {
+      return find_slot_with_hash (value, Descriptor::hash (value), insert);
+    }
+
+  value_type *find_slot_with_hash (const compare_type &comparable,
+				   hashval_t hash, enum insert_option insert);
+
+  void remove_elt_with_hash (const compare_type &, hashval_t);
+
+  void remove_elt (const value_type &value)
+    {
+      remove_elt_with_hash (value, Descriptor::hash (value));
+    }
+
+  template <typename Argument,
+	    int (*Callback) (value_type *slot, Argument argument)>
+  void traverse_noresize (Argument argument);
+
+  template <typename Argument,
+	    int (*Callback) (value_type *slot, Argument argument)>
+  void traverse (Argument argument);
+
+  class iterator
+  {
+  public:
+    iterator () : m_slot (NULL), m_limit (NULL), m_ctrl (NULL) {}
+
+    iterator (value_type *slot, value_type *limit,
+	      const unsigned char *ctrl)
+      : m_slot (slot), m_limit (limit), m_ctrl (ctrl) {}
+
+    inline value_type &operator * () { return *m_slot; }
+    void slide ();
+    inline iterator &operator ++ ();
+    bool operator != (const iterator &other) const
+      {
+	return m_slot != other.m_slot || m_limit != other.m_limit;
+      }
+
+  private:
+    value_type *m_slot;
+    value_type *m_limit;
+    /* Control byte of M_SLOT.  */
+    const unsigned char *m_ctrl;
+  };
+
+  iterator begin () const
+    {
+      iterator iter (m_entries, m_entries + m_size, m_ctrl);
+      iter.slide ();
+      return iter;
+    }
+
+  iterator end () const { return iterator (); }
+
+  double collisions () const
+    {
+      return m_searches ? static_cast <double> (m_collisions) / m_searches : 0;
+    }
+
+private:
+  void empty_slow ();
+  void alloc_storage (size_t n);
+  void free_storage ();
+  size_t find_free_slot (hashval_t);
+  void expand ();
+
+  /* The elements, M_SIZE of them.  */
+  value_type *m_entries;
+
+  /* The control bytes, one for each element.  */
+  unsigned char *m_ctrl;
+
+  /* Size of the table, a power of two no smaller than
+     GROUP_HASH_TABLE_WIDTH.  */
+  size_t m_size;
+
+  /* Current number of elements including also deleted elements.  */
+  size_t m_n_elements;
+
+  /* Current number of deleted elements in the table.  */
+  size_t m_n_deleted;
+
+  /* Number of lookups and of additional groups probed by them, for
+     collisions ().  */
+  unsigned int m_searches;
+  unsigned int m_collisions;
+
+  /* If we should gather memory statistics for the table.  */
+  bool m_gather_mem_stats;
+};
+
+template<typename Descriptor, template<typename Type> class Allocator>
+group_hash_table<Descriptor, Allocator>::group_hash_table (size_t size,
+							   bool ggc,
+							   bool
+							   gather_mem_stats,
+							   mem_alloc_origin
+							   origin
+							   MEM_STAT_DECL) :
+  m_n_elements (0), m_n_deleted (0), m_searches (0), m_collisions (0),
+  m_gather_mem_stats (gather_mem_stats)
+{
+  gcc_assert (!ggc);
+
+  if (m_gather_mem_stats)
+    hash_table_usage.register_descriptor (this, origin, ggc
+					  FINAL_PASS_MEM_STAT);
+
+  /* Make room for SIZE elements without going over the 7/8 load
+     factor.  */
+  size_t n = GROUP_HASH_TABLE_WIDTH;
+  while (n - n / 8 < size)
+    n *= 2;
+  alloc_storage (n);
+}
+
+template<typename Descriptor, template<typename Type> class Allocator>
+group_hash_table<Descriptor, Allocator>
+::group_hash_table (const group_hash_table &h, bool ggc,
+		    bool gather_mem_stats, mem_alloc_origin origin
+		    MEM_STAT_DECL) :
+  m_n_elements (h.m_n_elements), m_n_deleted (h.m_n_deleted),
+  m_searches (0), m_collisions (0), m_gather_mem_stats (gather_mem_stats)
+{
+  gcc_assert (!ggc);
+
+  if (m_gather_mem_stats)
+    hash_table_usage.register_descriptor (this, origin, ggc
+					  FINAL_PASS_MEM_STAT);
+
+  alloc_storage (h.m_size);
+  memcpy (m_ctrl, h.m_ctrl, m_size);
+  for (size_t i = 0; i < m_size; ++i)
+    if (!(m_ctrl[i] & 0x80))
+      m_entries[i] = h.m_entries[i];
+}
+
+template<typename Descriptor, template<typename Type> class Allocator>
+group_hash_table<Descriptor, Allocator>::~group_hash_table ()
+{
+  for (size_t i = 0; i < m_size; i++)
+    if (!(m_ctrl[i] & 0x80) && !Descriptor::is_empty (m_entries[i]))
+      Descriptor::remove (m_entries[i]);
+
+  free_storage ();
+}
+
+/* Allocate empty storage for N elements and make it the table's.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>::alloc_storage (size_t n)
+{
+  gcc_checking_assert (n >= GROUP_HASH_TABLE_WIDTH && (n & (n - 1)) == 0);
+
+  if (m_gather_mem_stats)
+    hash_table_usage.register_instance_overhead ((sizeof (value_type) + 1)
+						 * n, this);
+
+  m_entries = Allocator <value_type> ::data_alloc (n);
+  gcc_assert (m_entries != NULL);
+  for (size_t i = 0; i < n; i++)
+    Descriptor::mark_empty (m_entries[i]);
+  m_ctrl = XNEWVEC (unsigned char, n);
+  memset (m_ctrl, GROUP_HASH_TABLE_EMPTY, n);
+  m_size = n;
+}
+
+/* Release the storage of the table.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>::free_storage ()
+{
+  if (m_gather_mem_stats)
+    hash_table_usage.release_instance_overhead (this,
+						(sizeof (value_type) + 1)
+						* m_size, true);
+
+  Allocator <value_type> ::data_free (m_entries);
+  XDELETEVEC (m_ctrl);
+}
+
+/* Return the index of the first free slot on the probe sequence of
+   HASH, which must be a mixed hash value.  Used when rehashing, when
+   no element can compare equal.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+size_t
+group_hash_table<Descriptor, Allocator>::find_free_slot (hashval_t hash)
+{
+  size_t mask = m_size / GROUP_HASH_TABLE_WIDTH - 1;
+  size_t group = (hash >> 7) & mask;
+
+  for (size_t step = 1;; step++)
+    {
+      size_t base = group * GROUP_HASH_TABLE_WIDTH;
+      unsigned int spare = group_hash_table_match_free (m_ctrl + base);
+      if (spare)
+	return base + ctz_hwi (spare);
+      /* Triangular steps visit every group of a power-of-two table.  */
+      group = (group + step) & mask;
+    }
+}
+
+/* Rehash the table into storage that is about half full, dropping the
+   deleted elements.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>::expand ()
+{
+  value_type *oentries = m_entries;
+  unsigned char *octrl = m_ctrl;
+  size_t osize = m_size;
+  size_t elts = elements ();
+
+  size_t nsize = GROUP_HASH_TABLE_WIDTH;
+  while (nsize < elts * 2)
+    nsize *= 2;
+
+  if (m_gather_mem_stats)
+    hash_table_usage.release_instance_overhead (this, (sizeof (value_type)
+						       + 1) * osize);
+
+  alloc_storage (nsize);
+
+  m_n_elements = 0;
+  m_n_deleted = 0;
+  for (size_t i = 0; i < osize; i++)
+    if (!(octrl[i] & 0x80) && !Descriptor::is_empty (oentries[i]))
+      {
+	hashval_t hash = group_hash_table_mix (Descriptor::hash (oentries[i]));
+	size_t j = find_free_slot (hash);
+	m_ctrl[j] = hash & 0x7f;
+	m_entries[j] = oentries[i];
+	m_n_elements++;
+      }
+
+  Allocator <value_type> ::data_free (oentries);
+  XDELETEVEC (octrl);
+}
+
+/* Implements empty() in cases where it isn't a no-op.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>::empty_slow ()
+{
+  for (size_t i = 0; i < m_size; i++)
+    if (!(m_ctrl[i] & 0x80))
+      {
+	if (!Descriptor::is_empty (m_entries[i]))
+	  Descriptor::remove (m_entries[i]);
+	Descriptor::mark_empty (m_entries[i]);
+      }
+  memset (m_ctrl, GROUP_HASH_TABLE_EMPTY, m_size);
+  m_n_deleted = 0;
+  m_n_elements = 0;
+}
+
+/* This function clears a specified SLOT in a hash table.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>::clear_slot (value_type *slot)
+{
+  size_t i = slot - m_entries;
+  gcc_checking_assert (i < m_size && !(m_ctrl[i] & 0x80)
+		       && !Descriptor::is_empty (*slot));
+
+  Descriptor::remove (*slot);
+
+  Descriptor::mark_empty (*slot);
+  m_ctrl[i] = GROUP_HASH_TABLE_DELETED;
+  m_n_deleted++;
+}
+
+/* Return the element equal to COMPARABLE, or an empty element if there
+   is none.  It cannot be used to insert or delete an element.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+typename group_hash_table<Descriptor, Allocator>::value_type &
+group_hash_table<Descriptor, Allocator>
+::find_with_hash (const compare_type &comparable, hashval_t hash)
+{
+  m_searches++;
+  hash = group_hash_table_mix (hash);
+  unsigned char h2 = hash & 0x7f;
+  size_t mask = m_size / GROUP_HASH_TABLE_WIDTH - 1;
+  size_t group = (hash >> 7) & mask;
+
+  for (size_t step = 1;; step++)
+    {
+      size_t base = group * GROUP_HASH_TABLE_WIDTH;
+      const unsigned char *ctrl = m_ctrl + base;
+      for (unsigned int m = group_hash_table_match (ctrl, h2); m; m &= m - 1)
+	{
+	  value_type &entry = m_entries[base + ctz_hwi (m)];
+	  if (!Descriptor::is_empty (entry)
+	      && Descriptor::equal (entry, comparable))
+	    return entry;
+	}
+      unsigned int empty = group_hash_table_match (ctrl,
+						   GROUP_HASH_TABLE_EMPTY);
+      if (empty)
+	return m_entries[base + ctz_hwi (empty)];
+      m_collisions++;
+      group = (group + step) & mask;
+    }
+}
+
+/* Return the slot holding the element equal to COMPARABLE, whose hash
+   value is HASH.  If there is none, return NULL if INSERT is NO_INSERT
+   and otherwise an empty slot that the caller must fill in.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+typename group_hash_table<Descriptor, Allocator>::value_type *
+group_hash_table<Descriptor, Allocator>
+::find_slot_with_hash (const compare_type &comparable, hashval_t hash,
+		       enum insert_option insert)
+{
+  if (insert == INSERT && (m_n_elements + 1) * 8 > m_size * 7)
+    expand ();
+
+  m_searches++;
+  hash = group_hash_table_mix (hash);
+  unsigned char h2 = hash & 0x7f;
+  size_t mask = m_size / GROUP_HASH_TABLE_WIDTH - 1;
+  size_t group = (hash >> 7) & mask;
+  size_t first_deleted = m_size;
+  size_t index;
+
+  for (size_t step = 1;; step++)
+    {
+      size_t base = group * GROUP_HASH_TABLE_WIDTH;
+      const unsigned char *ctrl = m_ctrl + base;
+      for (unsigned int m = group_hash_table_match (ctrl, h2); m; m &= m - 1)
+	{
+	  value_type *entry = &m_entries[base + ctz_hwi (m)];
+	  if (!Descriptor::is_empty (*entry)
+	      && Descriptor::equal (*entry, comparable))
+	    return entry;
+	}
+      if (first_deleted == m_size)
+	{
+	  unsigned int deleted
+	    = group_hash_table_match (ctrl, GROUP_HASH_TABLE_DELETED);
+	  if (deleted)
+	    first_deleted = base + ctz_hwi (deleted);
+	}
+      unsigned int empty = group_hash_table_match (ctrl,
+						   GROUP_HASH_TABLE_EMPTY);
+      if (empty)
+	{
+	  index = base + ctz_hwi (empty);
+	  break;
+	}
+      m_collisions++;
+      group = (group + step) & mask;
+    }
+
+  if (insert == NO_INSERT)
+    return NULL;
+
+  if (first_deleted != m_size)
+    {
+      m_n_deleted--;
+      index = first_deleted;
+    }
+  else
+    m_n_elements++;
+
+  m_ctrl[index] = h2;
+  return &m_entries[index];
+}
+
+/* This function deletes an element with the given COMPARABLE value
+   from hash table starting with the given HASH.  If there is no
+   matching element in the hash table, this function does nothing.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>
+::remove_elt_with_hash (const compare_type &comparable, hashval_t hash)
+{
+  value_type *slot = find_slot_with_hash (comparable, hash, NO_INSERT);
+  if (slot == NULL)
+    return;
+
+  clear_slot (slot);
+}
+
+/* This function scans over the entire hash table calling CALLBACK for
+   each live entry.  If CALLBACK returns false, the iteration stops.
+   ARGUMENT is passed as CALLBACK's second argument.  */
+
+template<typename Descriptor,
+	  template<typename Type> class Allocator>
+template<typename Argument,
+	  int (*Callback)
+     (typename group_hash_table<Descriptor, Allocator>::value_type *slot,
+      Argument argument)>
+void
+group_hash_table<Descriptor, Allocator>::traverse_noresize (Argument argument)
+{
+  for (size_t i = 0; i < m_size; i++)
+    if (!(m_ctrl[i] & 0x80) && !Descriptor::is_empty (m_entries[i]))
+      if (! Callback (&m_entries[i], argument))
+	break;
+}
+
+/* Like traverse_noresize, but does resize the table when it is too empty
+   to improve effectivity of subsequent calls.  */
+
+template <typename Descriptor,
+	  template <typename Type> class Allocator>
+template <typename Argument,
+	  int (*Callback)
+     (typename group_hash_table<Descriptor, Allocator>::value_type *slot,
+      Argument argument)>
+void
+group_hash_table<Descriptor, Allocator>::traverse (Argument argument)
+{
+  if (elements () * 8 < m_size && m_size > 32)
+    expand ();
+
+  traverse_noresize <Argument, Callback> (argument);
+}
+
+/* Slide down the iterator slots until an active entry is found.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+group_hash_table<Descriptor, Allocator>::iterator::slide ()
+{
+  for ( ; m_slot < m_limit; ++m_slot, ++m_ctrl)
+    if (!(*m_ctrl & 0x80) && !Descriptor::is_empty (*m_slot))
+      return;
+  m_slot = NULL;
+  m_limit = NULL;
+}
+
+/* Bump the iterator.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+inline typename group_hash_table<Descriptor, Allocator>::iterator &
+group_hash_table<Descriptor, Allocator>::iterator::operator ++ ()
+{
+  ++m_slot;
+  ++m_ctrl;
+  slide ();
+  return *this;
+}
+
+#endif /* GCC_GROUP_HASH_TABLE_H */
@@ -5928,6 +5928,11 @@ int dfa_lookahead;
    could achieve DFA_LOOKAHEAD ** N , where N is the queue length.  */
 static int max_lookahead_tries;
 
+/* The number of insns of the block being scheduled by schedule_block if
+   it is longer than PARAM_SCHED_GOVERNOR_INSNS, 0 otherwise.  The number
+   of tries in max_issue is reduced in proportion for such blocks.  */
+static int governed_block_insns;
+
 /* The following function returns maximal (or close to maximal) number
    of insns which can be issued on the same cycle and one of which
    insns is insns with the best rank (the first insn in READY).  To
@@ -5966,6 +5971,14 @@ max_issue (struct ready_list *ready, int privileged_n, state_t state,
 	max_lookahead_tries *= dfa_lookahead;
     }
 
+  int tries_limit = max_lookahead_tries;
+  if (governed_block_insns)
+    tries_limit
+      = MAX (MIN (tries_limit, 100),
+	     (int) ((int64_t) tries_limit
+		    * PARAM_VALUE (PARAM_SCHED_GOVERNOR_INSNS)
+		    / governed_block_insns));
+
   /* Init max_points.  */
   more_issue = issue_rate - cycle_issued_insns;
   gcc_assert (more_issue >= 0);
@@ -6059,8 +6072,11 @@ max_issue (struct ready_list *ready, int privileged_n, state_t state,
       else if (!ready_try [i])
 	{
 	  tries_num++;
-	  if (tries_num > max_lookahead_tries)
-	    break;
+	  if (tries_num > tries_limit)
+	    {
+	      statistics_counter_event (cfun, "max_issue look-ahead limit", 1);
+	      break;
+	    }
 	  insn = ready_element (ready, i);
 	  delay = state_transition (state, insn);
 	  if (delay < 0)
@@ -6540,6 +6556,21 @@ schedule_block (basic_block *target_bb, state_t init_state)
 
   backtrack_queue = NULL;
 
+  /* Bound the look-ahead of max_issue on very long blocks.  */
+  governed_block_insns = 0;
+  if (PARAM_VALUE (PARAM_SCHED_GOVERNOR_INSNS) > 0 && dfa_lookahead > 0)
+    {
+      int n_insns = 0;
+      for (rtx_insn *insn = head; insn != next_tail; insn = NEXT_INSN (insn))
+	if (NONDEBUG_INSN_P (insn))
+	  n_insns++;
+      if (n_insns > PARAM_VALUE (PARAM_SCHED_GOVERNOR_INSNS))
+	{
+	  governed_block_insns = n_insns;
+	  statistics_counter_event (cfun, "haifa-sched governed block", 1);
+	}
+    }
+
   /* Debug info.  */
   if (sched_verbose)
     {
@@ -7345,6 +7376,7 @@ sched_init (void)
 
   /* Set to "0" so that we recalculate.  */
   max_lookahead_tries = 0;
+  governed_block_insns = 0;
 
   if (targetm.sched.init_dfa_pre_cycle_insn)
     targetm.sched.init_dfa_pre_cycle_insn ();
@@ -33,18 +33,22 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree.h"
 #include "stringpool.h"
 #include "selftest.h"
+#include "group-hash-table.h"
 
 #if CHECKING_P
 
 namespace selftest {
 
-/* Construct a hash_map <const char *, int> and verify that
-   various operations work correctly.  */
+/* Construct a hash_map <const char *, int> stored in a Table and
+   verify that various operations work correctly.  */
 
+template <template<typename, template<typename> class> class Table>
 static void
 test_map_of_strings_to_int ()
 {
-  hash_map <const char *, int> m;
+  hash_map <const char *, int,
+	    simple_hashmap_traits<default_hash_traits<const char *>, int>,
+	    Table> m;
 
   const char *ostrich = "ostrich";
   const char *elephant = "elephant";
@@ -80,12 +84,67 @@ test_map_of_strings_to_int ()
   ASSERT_EQ (NULL, m.get (eric));
 }
 
+/* Insert and remove enough integer keys to a group_hash_table-backed
+   hash_map that it has to grow and reuse deleted slots, checking it
+   against a hash_table-backed one at each step.  */
+
+static void
+test_group_map_of_ints ()
+{
+  typedef int_hash <int, -1, -2> int_traits;
+  typedef simple_hashmap_traits<int_traits, int> map_traits;
+  hash_map <int_traits, int, map_traits, group_hash_table> g;
+  hash_map <int_traits, int, map_traits> h;
+  const int n = 1000;
+
+  for (int i = 0; i < n; i++)
+    {
+      ASSERT_EQ (false, g.put (i * 7, i));
+      h.put (i * 7, i);
+    }
+  ASSERT_EQ (h.elements (), g.elements ());
+
+  /* Remove every other key, then put some of them back.  */
+  for (int i = 0; i < n; i += 2)
+    {
+      g.remove (i * 7);
+      h.remove (i * 7);
+    }
+  for (int i = 0; i < n; i += 4)
+    {
+      ASSERT_EQ (false, g.put (i * 7, -i));
+      h.put (i * 7, -i);
+    }
+  ASSERT_EQ (h.elements (), g.elements ());
+
+  for (int i = 0; i < n * 7; i++)
+    {
+      int *gv = g.get (i);
+      int *hv = h.get (i);
+      ASSERT_EQ (hv == NULL, gv == NULL);
+      if (hv)
+	ASSERT_EQ (*hv, *gv);
+    }
+
+  /* Iteration must visit exactly the live entries.  */
+  size_t count = 0;
+  for (hash_map <int_traits, int, map_traits, group_hash_table>::iterator
+	 it = g.begin (); it != g.end (); ++it)
+    {
+      ASSERT_EQ (*h.get ((*it).first), (*it).second);
+      count++;
+    }
+  ASSERT_EQ (h.elements (), count);
+}
+
 /* Run all of the selftests within this file.  */
 
 void
 hash_map_tests_c_tests ()
 {
-  test_map_of_strings_to_int ();
+  test_map_of_strings_to_int <hash_table> ();
+  test_map_of_strings_to_int <group_hash_table> ();
+  test_group_map_of_ints ();
 }
 
 } // namespace selftest
@@ -21,8 +21,14 @@ along with GCC; see the file COPYING3.  If not see
 #ifndef hash_map_h
 #define hash_map_h
 
+/* A map from keys of type KeyId to values of type Value, described by
+   Traits.  Table is the hash table implementation it is stored in;
+   besides the default hash_table, group_hash_table (for maps that are
+   not allocated in GC memory) can be used.  */
+
 template<typename KeyId, typename Value,
-	 typename Traits>
+	 typename Traits,
+	 template<typename, template<typename> class> class Table>
 class GTY((user)) hash_map
 {
   typedef typename Traits::key_type Key;
@@ -105,6 +111,8 @@ class GTY((user)) hash_map
 	}
   };
 
+  typedef Table<hash_entry, xcallocator> table_type;
+
 public:
   explicit hash_map (size_t n = 13, bool ggc = false,
 		     bool gather_mem_stats = GATHER_STATISTICS
@@ -181,7 +189,7 @@ public:
 				   const Value &, Arg)>
   void traverse (Arg a) const
     {
-      for (typename hash_table<hash_entry>::iterator iter = m_table.begin ();
+      for (typename table_type::iterator iter = m_table.begin ();
 	   iter != m_table.end (); ++iter)
 	f ((*iter).m_key, (*iter).m_value, a);
     }
@@ -190,7 +198,7 @@ public:
 				   Value *, Arg)>
   void traverse (Arg a) const
     {
-      for (typename hash_table<hash_entry>::iterator iter = m_table.begin ();
+      for (typename table_type::iterator iter = m_table.begin ();
 	   iter != m_table.end (); ++iter)
 	if (!f ((*iter).m_key, &(*iter).m_value, a))
 	  break;
@@ -203,7 +211,7 @@ public:
   class iterator
   {
   public:
-    explicit iterator (const typename hash_table<hash_entry>::iterator &iter) :
+    explicit iterator (const typename table_type::iterator &iter) :
       m_iter (iter) {}
 
     iterator &operator++ ()
@@ -225,7 +233,7 @@ public:
     }
 
   private:
-    typename hash_table<hash_entry>::iterator m_iter;
+    typename table_type::iterator m_iter;
   };
 
   /* Standard iterator retrieval methods.  */
@@ -239,7 +247,7 @@ private:
   template<typename T, typename U, typename V> friend void gt_pch_nx (hash_map<T, U, V> *);
       template<typename T, typename U, typename V> friend void gt_pch_nx (hash_map<T, U, V> *, gt_pointer_operator, void *);
 
-  hash_table<hash_entry> m_table;
+  table_type m_table;
 };
 
 /* ggc marking routines.  */
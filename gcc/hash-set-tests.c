@@ -25,18 +25,20 @@ along with GCC; see the file COPYING3.  If not see
 #include "signop.h"
 #include "hash-set.h"
 #include "selftest.h"
+#include "group-hash-table.h"
 
 #if CHECKING_P
 
 namespace selftest {
 
-/* Construct a hash_set <const char *> and verify that various operations
-   work correctly.  */
+/* Construct a hash_set <const char *> stored in a Table and verify that
+   various operations work correctly.  */
 
+template <template<typename, template<typename> class> class Table>
 static void
 test_set_of_strings ()
 {
-  hash_set <const char *> s;
+  hash_set <const char *, default_hash_traits<const char *>, Table> s;
   ASSERT_EQ (0, s.elements ());
 
   const char *red = "red";
@@ -61,7 +63,8 @@ test_set_of_strings ()
 void
 hash_set_tests_c_tests ()
 {
-  test_set_of_strings ();
+  test_set_of_strings <hash_table> ();
+  test_set_of_strings <group_hash_table> ();
 }
 
 } // namespace selftest
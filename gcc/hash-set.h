@@ -21,9 +21,15 @@ along with GCC; see the file COPYING3.  If not see
 #ifndef hash_set_h
 #define hash_set_h
 
-template<typename KeyId, typename Traits = default_hash_traits<KeyId> >
+/* A set of keys of type KeyId, described by Traits.  Table is the hash
+   table implementation, as for hash_map.  */
+
+template<typename KeyId, typename Traits = default_hash_traits<KeyId>,
+	 template<typename, template<typename> class> class Table>
 class hash_set
 {
+  typedef Table<Traits, xcallocator> table_type;
+
 public:
   typedef typename Traits::value_type Key;
   explicit hash_set (size_t n = 13, bool ggc = false CXX_MEM_STAT_INFO)
@@ -71,7 +77,7 @@ public:
   template<typename Arg, bool (*f)(const typename Traits::value_type &, Arg)>
   void traverse (Arg a) const
     {
-      for (typename hash_table<Traits>::iterator iter = m_table.begin ();
+      for (typename table_type::iterator iter = m_table.begin ();
 	   iter != m_table.end (); ++iter)
 	f (*iter, a);
     }
@@ -83,7 +89,7 @@ public:
   class iterator
   {
   public:
-    explicit iterator (const typename hash_table<Traits>::iterator &iter) :
+    explicit iterator (const typename table_type::iterator &iter) :
       m_iter (iter) {}
 
     iterator &operator++ ()
@@ -105,7 +111,7 @@ public:
       }
 
   private:
-    typename hash_table<Traits>::iterator m_iter;
+    typename table_type::iterator m_iter;
   };
 
   /* Standard iterator retrieval methods.  */
@@ -120,7 +126,7 @@ private:
   template<typename T, typename U> friend void gt_pch_nx (hash_set<T, U> *);
       template<typename T, typename U> friend void gt_pch_nx (hash_set<T, U> *, gt_pointer_operator, void *);
 
-  hash_table<Traits> m_table;
+  table_type m_table;
 };
 
 /* ggc marking routines.  */
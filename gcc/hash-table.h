@@ -240,8 +240,13 @@ along with GCC; see the file COPYING3.  If not see
 #include "hash-traits.h"
 #include "hash-map-traits.h"
 
-template<typename, typename, typename> class hash_map;
-template<typename, typename> class hash_set;
+template<typename, template<typename> class> class hash_table;
+template<typename, typename, typename,
+	 template<typename, template<typename> class> class = hash_table>
+class hash_map;
+template<typename, typename,
+	 template<typename, template<typename> class> class = hash_table>
+class hash_set;
 
 /* The ordinary memory allocator.  */
 /* FIXME (crowl): This allocator may be extracted for wider sharing later.  */
@@ -646,7 +651,10 @@ hash_table<Descriptor, Allocator>::alloc_entries (size_t n MEM_STAT_DECL) const
     hash_table_usage.register_instance_overhead (sizeof (value_type) * n, this);
 
   if (!m_ggc)
-    nentries = Allocator <value_type> ::data_alloc (n);
+    {
+      mem_profile_alloc (MEM_PROFILE_HEAP, sizeof (value_type) * n);
+      nentries = Allocator <value_type> ::data_alloc (n);
+    }
   else
     nentries = ::ggc_cleared_vec_alloc<value_type> (n PASS_MEM_STAT);
 
@@ -862,6 +862,23 @@ noce_conversion_profitable_p (rtx_insn *seq, struct noce_if_info *if_info)
   return speed_p && cost <= if_info->max_seq_cost;
 }
 
+/* Scale the budget MAX_COST for an unconditional sequence replacing the
+   branch whose outgoing edge is E by twice the probability of the less
+   likely direction: a 50/50 branch keeps the full budget, one that is
+   never taken the other way keeps only the cost of the branch itself.  */
+
+static unsigned int
+noce_scale_seq_cost_by_profile (unsigned int max_cost, edge e)
+{
+  unsigned int base = COSTS_N_INSNS (2);
+  int minority = MIN (e->probability, REG_BR_PROB_BASE - e->probability);
+
+  if (max_cost <= base)
+    return max_cost;
+  return base + RDIV ((HOST_WIDE_INT) (max_cost - base) * 2 * minority,
+		      REG_BR_PROB_BASE);
+}
+
 /* Helper function for noce_try_store_flag*.  */
 
 static rtx
@@ -4070,6 +4087,15 @@ noce_find_if_block (basic_block test_bb, edge then_edge, edge else_edge,
   if_info.speed_p = speed_p;
   if_info.max_seq_cost
     = targetm.max_noce_ifcvt_seq_cost (then_edge);
+  /* With a measured profile, the less likely direction of the branch
+     bounds how often it is mispredicted.  Scale the extra cost we are
+     willing to pay for an unconditional sequence by that rate, so that
+     branches that nearly always go the same way stay branches.  */
+  if (speed_p
+      && profile_status_for_fn (cfun) == PROFILE_READ
+      && test_bb->count)
+    if_info.max_seq_cost
+      = noce_scale_seq_cost_by_profile (if_info.max_seq_cost, then_edge);
   /* We'll add in the cost of THEN_BB and ELSE_BB later, when we check
      that they are valid to transform.  We can't easily get back to the insn
      for COND (and it may not exist if we had to canonicalize to get COND),
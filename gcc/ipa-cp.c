@@ -1880,6 +1880,10 @@ propagate_vr_across_jump_function (cgraph_edge *cs, ipa_jump_func *jfunc,
       if (TREE_CODE_CLASS (operation) == tcc_unary)
 	{
 	  struct ipa_node_params *caller_info = IPA_NODE_REF (cs->caller);
+	  /* The ranges of a clone of the caller are within those of the
+	     function it was cloned from.  */
+	  if (caller_info->ipcp_orig_node)
+	    caller_info = IPA_NODE_REF (caller_info->ipcp_orig_node);
 	  int src_idx = ipa_get_jf_pass_through_formal_id (jfunc);
 	  tree operand_type = ipa_get_type (caller_info, src_idx);
 	  struct ipcp_param_lattices *src_lats
@@ -4594,6 +4598,20 @@ decide_about_value (struct cgraph_node *node, int index, HOST_WIDE_INT offset,
   if (dump_file)
     fprintf (dump_file, "  Creating a specialized node of %s/%i.\n",
 	     node->name (), node->order);
+  if (opt_record_file)
+    {
+      opt_record_begin (MSG_OPTIMIZED_LOCATIONS,
+			DECL_SOURCE_LOCATION (node->decl), node->decl);
+      opt_record_printf ("specialized %s for a known value of parameter %i",
+			 node->name (), index);
+      opt_record_hotness (count_sum);
+      opt_record_param ("callers", caller_count);
+      opt_record_param ("frequency", freq_sum);
+      opt_record_param ("time_benefit", val->local_time_benefit
+			+ val->prop_time_benefit);
+      opt_record_param ("size_cost", val->local_size_cost
+			+ val->prop_size_cost);
+    }
 
   callers = gather_edges_for_value (val, node, caller_count);
   if (offset == -1)
@@ -4899,8 +4917,56 @@ ipcp_store_bits_results (void)
     }
 }
 
+/* Meet the value ranges the callers of the clone NODE pass to it into
+   LATS, which has an element for each parameter of the original function
+   described by INFO.  Return false if the ranges cannot be determined
+   for all callers.  */
+
+static bool
+gather_clone_value_ranges (cgraph_node *node, ipa_node_params *info,
+			   ipcp_param_lattices *lats)
+{
+  int count = ipa_get_param_count (info);
+
+  for (int i = 0; i < count; i++)
+    lats[i].m_value_range.init ();
+  if (!node->callers)
+    return false;
+
+  for (cgraph_edge *cs = node->callers; cs; cs = cs->next_caller)
+    {
+      if (!ipa_edge_args_info_available_for_edge_p (cs)
+	  || call_passes_through_thunk_p (cs))
+	return false;
+      ipa_edge_args *args = IPA_EDGE_REF (cs);
+      if (ipa_get_cs_argument_count (args) < count)
+	return false;
+      for (int i = 0; i < count; i++)
+	propagate_vr_across_jump_function (cs, ipa_get_ith_jump_func (args, i),
+					   &lats[i], ipa_get_type (info, i));
+    }
+  return true;
+}
+
+/* Return the lattice with the value range of the Ith parameter of a node
+   described by INFO, or of its clone when CLONE_LATS has a useful range
+   for it.  */
+
+static ipcp_vr_lattice *
+get_vr_lattice_for_store (ipa_node_params *info,
+			  ipcp_param_lattices *clone_lats, int i)
+{
+  if (clone_lats
+      && !clone_lats[i].m_value_range.bottom_p ()
+      && !clone_lats[i].m_value_range.top_p ())
+    return &clone_lats[i].m_value_range;
+  return &ipa_get_parm_lattices (info, i)->m_value_range;
+}
+
 /* Look up all VR information that we have discovered and copy it over
-   to the transformation summary.  */
+   to the transformation summary.  A clone only receives the ranges
+   passed by its own callers, which are often narrower than those of
+   the function it was cloned from.  */
 
 static void
 ipcp_store_vr_results (void)
@@ -4910,6 +4976,7 @@ ipcp_store_vr_results (void)
   FOR_EACH_FUNCTION_WITH_GIMPLE_BODY (node)
     {
       ipa_node_params *info = IPA_NODE_REF (node);
+      ipcp_param_lattices *clone_lats = NULL;
       bool found_useful_result = false;
 
       if (!opt_for_fn (node->decl, flag_ipa_vrp))
@@ -4922,21 +4989,34 @@ ipcp_store_vr_results (void)
 	}
 
       if (info->ipcp_orig_node)
-	info = IPA_NODE_REF (info->ipcp_orig_node);
+	{
+	  info = IPA_NODE_REF (info->ipcp_orig_node);
+	  clone_lats = XCNEWVEC (ipcp_param_lattices,
+				 ipa_get_param_count (info));
+	  if (!gather_clone_value_ranges (node, info, clone_lats))
+	    {
+	      free (clone_lats);
+	      clone_lats = NULL;
+	    }
+	}
 
       unsigned count = ipa_get_param_count (info);
       for (unsigned i = 0; i < count; i++)
 	{
-	  ipcp_param_lattices *plats = ipa_get_parm_lattices (info, i);
-	  if (!plats->m_value_range.bottom_p ()
-	      && !plats->m_value_range.top_p ())
+	  ipcp_vr_lattice *vr_lat = get_vr_lattice_for_store (info, clone_lats,
+							      i);
+	  if (!vr_lat->bottom_p ()
+	      && !vr_lat->top_p ())
 	    {
 	      found_useful_result = true;
 	      break;
 	    }
 	}
       if (!found_useful_result)
-	continue;
+	{
+	  free (clone_lats);
+	  continue;
+	}
 
       ipcp_grow_transformations_if_necessary ();
       ipcp_transformation_summary *ts = ipcp_get_transformation_summary (node);
@@ -4944,16 +5024,17 @@ ipcp_store_vr_results (void)
 
       for (unsigned i = 0; i < count; i++)
 	{
-	  ipcp_param_lattices *plats = ipa_get_parm_lattices (info, i);
+	  ipcp_vr_lattice *vr_lat = get_vr_lattice_for_store (info, clone_lats,
+							      i);
 	  ipa_vr vr;
 
-	  if (!plats->m_value_range.bottom_p ()
-	      && !plats->m_value_range.top_p ())
+	  if (!vr_lat->bottom_p ()
+	      && !vr_lat->top_p ())
 	    {
 	      vr.known = true;
-	      vr.type = plats->m_value_range.m_vr.type;
-	      vr.min = plats->m_value_range.m_vr.min;
-	      vr.max = plats->m_value_range.m_vr.max;
+	      vr.type = vr_lat->m_vr.type;
+	      vr.min = vr_lat->m_vr.min;
+	      vr.max = vr_lat->m_vr.max;
 	    }
 	  else
 	    {
@@ -4963,6 +5044,7 @@ ipcp_store_vr_results (void)
 	    }
 	  ts->m_vr->quick_push (vr);
 	}
+      free (clone_lats);
     }
 }
 
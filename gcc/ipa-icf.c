@@ -2139,6 +2139,23 @@ set_alias_uids (symtab_node *n, int uid)
     }
 }
 
+/* Turn the constant pool entry NODE, if it is one, into an ordinary
+   read-only variable.  Constant pool entries have local label names,
+   which cannot be promoted to global symbols when the variable is
+   referred to from several LTO partitions; give it a name that can.  */
+
+static void
+drop_constant_pool_flag (varpool_node *node)
+{
+  if (!DECL_IN_CONSTANT_POOL (node->decl))
+    return;
+
+  DECL_IN_CONSTANT_POOL (node->decl) = 0;
+  tree name = create_tmp_var_name ("C");
+  DECL_NAME (node->decl) = name;
+  symtab->change_decl_assembler_name (node->decl, name);
+}
+
 /* Merges instance with an ALIAS_ITEM, where alias, thunk or redirection can
    be applied.  */
 
@@ -2182,13 +2199,13 @@ sem_variable::merge (sem_item *alias_item)
 
   gcc_assert (!TREE_ASM_WRITTEN (alias->decl));
 
-  /* Constant pool machinery is not quite ready for aliases.
-     TODO: varasm code contains logic for merging DECL_IN_CONSTANT_POOL.
-     For LTO merging does not happen that is an important missing feature.
-     We can enable merging with LTO if the DECL_IN_CONSTANT_POOL
-     flag is dropped and non-local symbol name is assigned.  */
-  if (DECL_IN_CONSTANT_POOL (alias->decl)
-      || DECL_IN_CONSTANT_POOL (original->decl))
+  /* Constant pool machinery is not quite ready for aliases.  Within a
+     unit varasm merges DECL_IN_CONSTANT_POOL entries by itself, but with
+     LTO each partition outputs its own copy of them.  There we merge them
+     as ordinary variables, see drop_constant_pool_flag.  */
+  bool in_constant_pool = (DECL_IN_CONSTANT_POOL (alias->decl)
+			   || DECL_IN_CONSTANT_POOL (original->decl));
+  if (in_constant_pool && !flag_wpa)
     {
       if (dump_file)
 	fprintf (dump_file,
@@ -2249,6 +2266,12 @@ sem_variable::merge (sem_item *alias_item)
       gcc_assert (!original->alias);
       gcc_assert (!alias->alias);
 
+      if (in_constant_pool)
+	{
+	  drop_constant_pool_flag (original);
+	  drop_constant_pool_flag (alias);
+	}
+
       alias->analyzed = false;
 
       DECL_INITIAL (alias->decl) = NULL;
@@ -125,6 +125,15 @@ static int overall_size;
 static gcov_type max_count;
 static gcov_type spec_rem;
 
+/* Statistics about maintenance of the edge heap of
+   inline_small_functions: number of badness recomputations done by
+   update_edge_key, how many of them decreased the key, how many
+   increases were left for lazy update, how many stale keys were found
+   when extracting the minimum and how many edge growth cache entries
+   were invalidated.  */
+static int n_badness_updates, n_key_decreases, n_lazy_increases;
+static int n_stale_keys, n_growth_cache_resets;
+
 /* Pre-computed constants 1/CGRAPH_FREQ_BASE and 1/100. */
 static sreal cgraph_freq_base_rec, percent_rec;
 
@@ -220,11 +229,30 @@ caller_growth_limits (struct cgraph_edge *e)
   return true;
 }
 
+/* Return the location of the call of edge E, for -fopt-record.  */
+
+static location_t
+edge_call_location (struct cgraph_edge *e)
+{
+  return e->call_stmt ? gimple_location (e->call_stmt) : UNKNOWN_LOCATION;
+}
+
 /* Dump info about why inlining has failed.  */
 
 static void
 report_inline_failed_reason (struct cgraph_edge *e)
 {
+  if (opt_record_file)
+    {
+      opt_record_begin (MSG_MISSED_OPTIMIZATION, edge_call_location (e),
+			e->caller->decl);
+      opt_record_printf ("not inlinable: %s -> %s, %s",
+			 e->caller->name (), e->callee->name (),
+			 cgraph_inline_failed_string (e->inline_failed));
+      opt_record_reason (cgraph_inline_failed_name (e->inline_failed));
+      opt_record_hotness (e->count);
+      opt_record_param ("frequency", e->frequency);
+    }
   if (dump_file)
     {
       fprintf (dump_file, "  not inlinable: %s/%i -> %s/%i, %s\n",
@@ -1220,6 +1248,7 @@ static inline void
 update_edge_key (edge_heap_t *heap, struct cgraph_edge *edge)
 {
   sreal badness = edge_badness (edge, false);
+  n_badness_updates++;
   if (edge->aux)
     {
       edge_heap_node_t *n = (edge_heap_node_t *) edge->aux;
@@ -1245,7 +1274,10 @@ update_edge_key (edge_heap_t *heap, struct cgraph_edge *edge)
 		       badness.to_double ());
 	    }
 	  heap->decrease_key (n, badness);
+	  n_key_decreases++;
 	}
+      else if (badness != n->get_key ())
+	n_lazy_increases++;
     }
   else
     {
@@ -1282,7 +1314,10 @@ reset_edge_caches (struct cgraph_node *node)
 
   for (edge = where->callers; edge; edge = edge->next_caller)
     if (edge->inline_failed)
-      reset_edge_growth_cache (edge);
+      {
+	reset_edge_growth_cache (edge);
+	n_growth_cache_resets++;
+      }
 
   FOR_EACH_ALIAS (where, ref)
     reset_edge_caches (dyn_cast <cgraph_node *> (ref->referring));
@@ -1296,7 +1331,10 @@ reset_edge_caches (struct cgraph_node *node)
     else
       {
 	if (e->inline_failed)
-	  reset_edge_growth_cache (e);
+	  {
+	    reset_edge_growth_cache (e);
+	    n_growth_cache_resets++;
+	  }
 	if (e->next_callee)
 	  e = e->next_callee;
 	else
@@ -1741,6 +1779,9 @@ inline_small_functions (void)
   edge_removal_hook_holder
     = symtab->add_edge_removal_hook (&heap_edge_removal_hook, &edge_heap);
 
+  n_badness_updates = n_key_decreases = n_lazy_increases = 0;
+  n_stale_keys = n_growth_cache_resets = 0;
+
   /* Compute overall unit size and other global parameters used by badness
      metrics.  */
 
@@ -1903,6 +1944,7 @@ inline_small_functions (void)
 #endif
       if (current_badness != badness)
 	{
+	  n_stale_keys++;
 	  if (edge_heap.min () && current_badness > edge_heap.min_key ())
 	    {
 	      edge->aux = edge_heap.insert (current_badness, edge);
@@ -1953,6 +1995,9 @@ inline_small_functions (void)
 	{
 	  edge->inline_failed = CIF_INLINE_UNIT_GROWTH_LIMIT;
 	  report_inline_failed_reason (edge);
+	  opt_record_param ("growth", growth);
+	  opt_record_param ("overall_size", overall_size);
+	  opt_record_param ("max_size", max_size);
 	  resolve_noninline_speculation (&edge_heap, edge);
 	  continue;
 	}
@@ -2049,6 +2094,17 @@ inline_small_functions (void)
         }
       bitmap_clear (updated_nodes);
 
+      if (opt_record_file)
+	{
+	  opt_record_begin (MSG_OPTIMIZED_LOCATIONS, edge_call_location (edge),
+			    edge->caller->decl);
+	  opt_record_printf ("inlined %s into %s", edge->callee->name (),
+			     edge->caller->name ());
+	  opt_record_hotness (edge->count);
+	  opt_record_param ("frequency", edge->frequency);
+	  opt_record_param ("growth", growth);
+	  opt_record_param ("overall_size", overall_size);
+	}
       if (dump_file)
 	{
 	  fprintf (dump_file,
@@ -2075,6 +2131,18 @@ inline_small_functions (void)
 	     "Unit growth for small function inlining: %i->%i (%i%%)\n",
 	     initial_size, overall_size,
 	     initial_size ? overall_size * 100 / (initial_size) - 100: 0);
+  if (dump_file)
+    fprintf (dump_file,
+	     "Edge heap maintenance: %i badness updates, %i keys decreased, "
+	     "%i increases deferred, %i stale keys, "
+	     "%i growth cache entries reset\n",
+	     n_badness_updates, n_key_decreases, n_lazy_increases,
+	     n_stale_keys, n_growth_cache_resets);
+  statistics_counter_event (NULL, "inline badness updates",
+			    n_badness_updates);
+  statistics_counter_event (NULL, "inline badness increases deferred",
+			    n_lazy_increases);
+  statistics_counter_event (NULL, "inline stale heap keys", n_stale_keys);
   BITMAP_FREE (updated_nodes);
   symtab->remove_edge_removal_hook (edge_removal_hook_holder);
 }
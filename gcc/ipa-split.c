@@ -98,6 +98,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "ipa-prop.h"
 #include "tree-cfg.h"
 #include "tree-into-ssa.h"
+#include "tree-cfgcleanup.h"
 #include "tree-dfa.h"
 #include "tree-inline.h"
 #include "params.h"
@@ -1707,15 +1708,102 @@ split_function (basic_block return_bb, struct split_point *split_point,
   compute_inline_parameters (node, true);
 }
 
-/* Execute function splitting pass.  */
+/* Look for the best split point of the current function and split it
+   there.  Return the TODO flags for the pass, or 0 if the function was
+   not split.  */
 
 static unsigned int
-execute_split_functions (void)
+find_and_split_function (void)
 {
   gimple_stmt_iterator bsi;
   basic_block bb;
   int overall_time = 0, overall_size = 0;
   int todo = 0;
+
+  /* We enforce splitting after loop headers when profile info is not
+     available.  */
+  if (profile_status_for_fn (cfun) != PROFILE_READ)
+    mark_dfs_back_edges ();
+
+  /* Initialize bitmap to track forbidden calls.  */
+  forbidden_dominators = BITMAP_ALLOC (NULL);
+  calculate_dominance_info (CDI_DOMINATORS);
+
+  /* Compute local info about basic blocks and determine function size/time.  */
+  bb_info_vec.safe_grow_cleared (last_basic_block_for_fn (cfun) + 1);
+  memset (&best_split_point, 0, sizeof (best_split_point));
+  basic_block return_bb = find_return_bb ();
+  int tsan_exit_found = -1;
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      int time = 0;
+      int size = 0;
+      int freq = compute_call_stmt_bb_frequency (current_function_decl, bb);
+
+      if (dump_file && (dump_flags & TDF_DETAILS))
+	fprintf (dump_file, "Basic block %i\n", bb->index);
+
+      for (bsi = gsi_start_bb (bb); !gsi_end_p (bsi); gsi_next (&bsi))
+	{
+	  int this_time, this_size;
+	  gimple *stmt = gsi_stmt (bsi);
+
+	  this_size = estimate_num_insns (stmt, &eni_size_weights);
+	  this_time = estimate_num_insns (stmt, &eni_time_weights) * freq;
+	  size += this_size;
+	  time += this_time;
+	  check_forbidden_calls (stmt);
+
+	  if (dump_file && (dump_flags & TDF_DETAILS))
+	    {
+	      fprintf (dump_file, "  freq:%6i size:%3i time:%3i ",
+		       freq, this_size, this_time);
+	      print_gimple_stmt (dump_file, stmt, 0, 0);
+	    }
+
+	  if ((flag_sanitize & SANITIZE_THREAD)
+	      && gimple_call_internal_p (stmt, IFN_TSAN_FUNC_EXIT))
+	    {
+	      /* We handle TSAN_FUNC_EXIT for splitting either in the
+		 return_bb, or in its immediate predecessors.  */
+	      if ((bb != return_bb && !find_edge (bb, return_bb))
+		  || (tsan_exit_found != -1
+		      && tsan_exit_found != (bb != return_bb)))
+		{
+		  if (dump_file)
+		    fprintf (dump_file, "Not splitting: TSAN_FUNC_EXIT"
+			     " in unexpected basic block.\n");
+		  BITMAP_FREE (forbidden_dominators);
+		  bb_info_vec.release ();
+		  return 0;
+		}
+	      tsan_exit_found = bb != return_bb;
+	    }
+	}
+      overall_time += time;
+      overall_size += size;
+      bb_info_vec[bb->index].time = time;
+      bb_info_vec[bb->index].size = size;
+    }
+  find_split_points (return_bb, overall_time, overall_size);
+  if (best_split_point.split_bbs)
+    {
+      split_function (return_bb, &best_split_point, tsan_exit_found == 1);
+      BITMAP_FREE (best_split_point.ssa_names_to_pass);
+      BITMAP_FREE (best_split_point.split_bbs);
+      todo = TODO_update_ssa | TODO_cleanup_cfg;
+    }
+  BITMAP_FREE (forbidden_dominators);
+  bb_info_vec.release ();
+  return todo;
+}
+
+/* Execute function splitting pass.  */
+
+static unsigned int
+execute_split_functions (void)
+{
+  int todo = 0;
   struct cgraph_node *node = cgraph_node::get (current_function_decl);
 
   if (flags_from_decl_or_type (current_function_decl)
@@ -1794,81 +1882,25 @@ execute_split_functions (void)
       return 0;
     }
 
-  /* We enforce splitting after loop headers when profile info is not
-     available.  */
-  if (profile_status_for_fn (cfun) != PROFILE_READ)
-    mark_dfs_back_edges ();
-
-  /* Initialize bitmap to track forbidden calls.  */
-  forbidden_dominators = BITMAP_ALLOC (NULL);
-  calculate_dominance_info (CDI_DOMINATORS);
-
-  /* Compute local info about basic blocks and determine function size/time.  */
-  bb_info_vec.safe_grow_cleared (last_basic_block_for_fn (cfun) + 1);
-  memset (&best_split_point, 0, sizeof (best_split_point));
-  basic_block return_bb = find_return_bb ();
-  int tsan_exit_found = -1;
-  FOR_EACH_BB_FN (bb, cfun)
+  /* With profile feedback we know which regions are cold, so keep
+     outlining them while the header still has some: what remains is
+     the hot core, cheap enough to be inlined.  */
+  int max_splits = (profile_status_for_fn (cfun) == PROFILE_READ
+		    ? PARAM_VALUE (PARAM_MAX_PARTIAL_INLINING_SPLITS) : 1);
+  for (int n_splits = 0; n_splits < max_splits; n_splits++)
     {
-      int time = 0;
-      int size = 0;
-      int freq = compute_call_stmt_bb_frequency (current_function_decl, bb);
-
-      if (dump_file && (dump_flags & TDF_DETAILS))
-	fprintf (dump_file, "Basic block %i\n", bb->index);
-
-      for (bsi = gsi_start_bb (bb); !gsi_end_p (bsi); gsi_next (&bsi))
+      if (n_splits)
 	{
-	  int this_time, this_size;
-	  gimple *stmt = gsi_stmt (bsi);
-
-	  this_size = estimate_num_insns (stmt, &eni_size_weights);
-	  this_time = estimate_num_insns (stmt, &eni_time_weights) * freq;
-	  size += this_size;
-	  time += this_time;
-	  check_forbidden_calls (stmt);
-
-	  if (dump_file && (dump_flags & TDF_DETAILS))
-	    {
-	      fprintf (dump_file, "  freq:%6i size:%3i time:%3i ",
-		       freq, this_size, this_time);
-	      print_gimple_stmt (dump_file, stmt, 0, 0);
-	    }
-
-	  if ((flag_sanitize & SANITIZE_THREAD)
-	      && gimple_call_internal_p (stmt, IFN_TSAN_FUNC_EXIT))
-	    {
-	      /* We handle TSAN_FUNC_EXIT for splitting either in the
-		 return_bb, or in its immediate predecessors.  */
-	      if ((bb != return_bb && !find_edge (bb, return_bb))
-		  || (tsan_exit_found != -1
-		      && tsan_exit_found != (bb != return_bb)))
-		{
-		  if (dump_file)
-		    fprintf (dump_file, "Not splitting: TSAN_FUNC_EXIT"
-			     " in unexpected basic block.\n");
-		  BITMAP_FREE (forbidden_dominators);
-		  bb_info_vec.release ();
-		  return 0;
-		}
-	      tsan_exit_found = bb != return_bb;
-	    }
+	  /* Bring the header left by the previous split back into shape
+	     for the analysis.  */
+	  update_ssa (TODO_update_ssa);
+	  cleanup_tree_cfg ();
 	}
-      overall_time += time;
-      overall_size += size;
-      bb_info_vec[bb->index].time = time;
-      bb_info_vec[bb->index].size = size;
-    }
-  find_split_points (return_bb, overall_time, overall_size);
-  if (best_split_point.split_bbs)
-    {
-      split_function (return_bb, &best_split_point, tsan_exit_found == 1);
-      BITMAP_FREE (best_split_point.ssa_names_to_pass);
-      BITMAP_FREE (best_split_point.split_bbs);
-      todo = TODO_update_ssa | TODO_cleanup_cfg;
+      unsigned int split_todo = find_and_split_function ();
+      if (!split_todo)
+	break;
+      todo |= split_todo;
     }
-  BITMAP_FREE (forbidden_dominators);
-  bb_info_vec.release ();
   return todo;
 }
 
@@ -2216,7 +2216,11 @@ loop_compare_func (const void *v1p, const void *v2p)
    hardly helps (for irregular register file architecture it could
    help by choosing a better hard register in the loop but we prefer
    faster allocation even in this case).  We also remove cheap loops
-   if there are more than IRA_MAX_LOOPS_NUM of them.  Loop with EH
+   if there are more than IRA_MAX_LOOPS_NUM of them, or proportionally
+   fewer in functions with more than IRA_REGION_PSEUDOS pseudos: every
+   region gets allocnos for the pseudos living in it, so the number
+   of regions times the number of pseudos has to be kept bounded for
+   the allocation time to stay roughly linear.  Loop with EH
    exit or enter edges are removed too because the allocation might
    require put pseudo moves on the EH edges (we could still do this
    for pseudos with caller saved hard registers in some cases but it
@@ -2228,6 +2232,17 @@ mark_loops_for_removal (void)
   int i, n;
   ira_loop_tree_node_t *sorted_loops;
   loop_p loop;
+  int max_loops_num = IRA_MAX_LOOPS_NUM;
+
+  if (IRA_REGION_PSEUDOS > 0 && max_reg_num () > IRA_REGION_PSEUDOS)
+    {
+      max_loops_num
+	= (int) ((int64_t) max_loops_num * IRA_REGION_PSEUDOS / max_reg_num ());
+      if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+	fprintf (ira_dump_file,
+		 "+++Too many pseudos (%d) -- keeping at most %d loops\n",
+		 max_reg_num (), max_loops_num);
+    }
 
   ira_assert (current_loops != NULL);
   sorted_loops
@@ -2252,7 +2267,7 @@ mark_loops_for_removal (void)
 	     );
       }
   qsort (sorted_loops, n, sizeof (ira_loop_tree_node_t), loop_compare_func);
-  for (i = 0; i < n - IRA_MAX_LOOPS_NUM; i++)
+  for (i = 0; i < n - max_loops_num; i++)
     {
       sorted_loops[i]->to_remove_p = true;
       if (internal_flag_ira_verbose > 1 && ira_dump_file != NULL)
@@ -392,6 +392,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "rtl-iter.h"
 #include "shrink-wrap.h"
 #include "print-rtl.h"
+#include "predict.h"
+#include "params.h"
 
 struct target_ira default_target_ira;
 struct target_ira_int default_target_ira_int;
@@ -5105,10 +5107,17 @@ ira (FILE *f)
 
   /* If there are too many pseudos and/or basic blocks (e.g. 10K
      pseudos and 10K blocks or 100K pseudos and 1K blocks), we will
-     use simplified and faster algorithms in LRA.  */
+     use simplified and faster algorithms in LRA.  Functions that are
+     never executed get the simplified algorithms much earlier, the
+     quality of their code matters less than the compile time.  */
+  int simple_threshold = IRA_SIMPLE_LRA_THRESHOLD;
+  if (profile_status_for_fn (cfun) == PROFILE_READ
+      && probably_never_executed_bb_p (cfun, ENTRY_BLOCK_PTR_FOR_FN (cfun)))
+    simple_threshold = MIN (simple_threshold, IRA_SIMPLE_LRA_COLD_THRESHOLD);
   lra_simple_p
     = (ira_use_lra_p
-       && max_reg_num () >= (1 << 26) / last_basic_block_for_fn (cfun));
+       && simple_threshold > 0
+       && max_reg_num () >= simple_threshold / last_basic_block_for_fn (cfun));
   if (lra_simple_p)
     {
       /* It permits to skip live range splitting in LRA.  */
@@ -5139,6 +5148,11 @@ ira (FILE *f)
       ira_dump_file = stderr;
     }
 
+  if (lra_simple_p && internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+    fprintf (ira_dump_file,
+	     "+++Using simplified allocation: %d pseudos, %d blocks\n",
+	     max_reg_num (), last_basic_block_for_fn (cfun));
+
   setup_prohibited_mode_move_regs ();
   decrease_live_ranges_number ();
   df_note_add_problem ();
@@ -1808,11 +1808,20 @@ compile ()
   exit_scope ("toplev::finalize");
 
   /* Ideally we would release the jit mutex here, but we can't yet since
-     followup activities use timevars, which are global state.  */
+     followup activities use timevars, which are global state, and the
+     embedded driver uses global state too.  Without either, all that
+     is left is running and loading the output of the external driver,
+     so let other threads compile in the meantime.  */
+  bool hold_mutex
+    = (get_timer ()
+       || !get_inner_bool_option (INNER_BOOL_OPTION_USE_EXTERNAL_DRIVER));
+  if (!hold_mutex)
+    release_mutex ();
 
   if (errors_occurred ())
     {
-      release_mutex ();
+      if (hold_mutex)
+	release_mutex ();
       return;
     }
 
@@ -1827,7 +1836,8 @@ compile ()
      given file (playback::compile_to_file).  */
   postprocess (ctxt_progname);
 
-  release_mutex ();
+  if (hold_mutex)
+    release_mutex ();
 }
 
 /* Implementation of class gcc::jit::playback::compile_to_memory,
@@ -642,6 +642,43 @@ unroll_loop_constant_iterations (struct loop *loop)
 	     max_unroll, num_loop_insns (loop));
 }
 
+/* Return true if LOOP iterates often enough to be unrolled into NUNROLL
+   copies of its body.  Without profile feedback we require an estimated
+   2 * NUNROLL iterations.  With it, we trust the measured trip count and
+   lower NUNROLL to fit it instead, so that loops running only a few
+   more times than their body is copied still get unrolled.  */
+
+static bool
+loop_rolls_for_unrolling_p (struct loop *loop, unsigned *nunroll)
+{
+  widest_int iterations;
+
+  if (profile_status_for_fn (cfun) == PROFILE_READ
+      && loop->header->count
+      && get_estimated_loop_iterations (loop, &iterations))
+    {
+      if (wi::ltu_p (iterations, 2 * *nunroll))
+	{
+	  /* ITERATIONS counts executions of the latch.  */
+	  unsigned trip_count = iterations.to_uhwi () + 1;
+	  if (trip_count < *nunroll)
+	    *nunroll = trip_count;
+	  if (dump_file)
+	    fprintf (dump_file,
+		     ";; Profiled trip count %u, unrolling at most %u times\n",
+		     trip_count, *nunroll);
+	}
+      return *nunroll > 1;
+    }
+
+  if ((get_estimated_loop_iterations (loop, &iterations)
+       || get_likely_max_loop_iterations (loop, &iterations))
+      && wi::ltu_p (iterations, 2 * *nunroll))
+    return false;
+
+  return true;
+}
+
 /* Decide whether to unroll LOOP iterating runtime computable number of times
    and how much.  */
 static void
@@ -649,7 +686,6 @@ decide_unroll_runtime_iterations (struct loop *loop, int flags)
 {
   unsigned nunroll, nunroll_by_av, i;
   struct niter_desc *desc;
-  widest_int iterations;
 
   if (!(flags & UAP_UNROLL))
     {
@@ -703,9 +739,7 @@ decide_unroll_runtime_iterations (struct loop *loop, int flags)
     }
 
   /* Check whether the loop rolls.  */
-  if ((get_estimated_loop_iterations (loop, &iterations)
-       || get_likely_max_loop_iterations (loop, &iterations))
-      && wi::ltu_p (iterations, 2 * nunroll))
+  if (!loop_rolls_for_unrolling_p (loop, &nunroll))
     {
       if (dump_file)
 	fprintf (dump_file, ";; Not unrolling loop, doesn't roll\n");
@@ -1141,7 +1175,6 @@ decide_unroll_stupid (struct loop *loop, int flags)
 {
   unsigned nunroll, nunroll_by_av, i;
   struct niter_desc *desc;
-  widest_int iterations;
 
   if (!(flags & UAP_UNROLL_ALL))
     {
@@ -1196,9 +1229,7 @@ decide_unroll_stupid (struct loop *loop, int flags)
     }
 
   /* Check whether the loop rolls.  */
-  if ((get_estimated_loop_iterations (loop, &iterations)
-       || get_likely_max_loop_iterations (loop, &iterations))
-      && wi::ltu_p (iterations, 2 * nunroll))
+  if (!loop_rolls_for_unrolling_p (loop, &nunroll))
     {
       if (dump_file)
 	fprintf (dump_file, ";; Not unrolling loop, doesn't roll\n");
@@ -46,11 +46,16 @@ struct lto_compression_stream
   size_t bytes;
   size_t allocation;
   bool is_compression;
+
+  /* For compression, the zlib state and output buffer.  Data is
+     deflated as it arrives rather than accumulated in BUFFER.  */
+  z_stream zstream;
+  unsigned char *outbuf;
 };
 
 /* Overall compression constants for zlib.  */
 
-static const size_t Z_BUFFER_LENGTH = 4096;
+static const size_t Z_BUFFER_LENGTH = 65536;
 static const size_t MIN_STREAM_ALLOCATION = 1024;
 
 /* For zlib, allocate SIZE count of ITEMS and return the address, OPAQUE
@@ -141,6 +146,36 @@ lto_destroy_compression_stream (struct lto_compression_stream *stream)
   free (stream);
 }
 
+/* Run deflate with FLUSH over the input currently set in STREAM,
+   passing every full or final output buffer to the stream callback.  */
+
+static void
+lto_deflate (struct lto_compression_stream *stream, int flush)
+{
+  z_stream *zs = &stream->zstream;
+  int status;
+
+  do
+    {
+      size_t out_bytes;
+
+      status = deflate (zs, flush);
+      if (status != Z_OK && status != Z_STREAM_END)
+	internal_error ("compressed stream: %s", zError (status));
+
+      out_bytes = Z_BUFFER_LENGTH - zs->avail_out;
+      if (out_bytes)
+	{
+	  stream->callback ((const char *) stream->outbuf, out_bytes,
+			    stream->opaque);
+	  lto_stats.num_compressed_il_bytes += out_bytes;
+	  zs->next_out = stream->outbuf;
+	  zs->avail_out = Z_BUFFER_LENGTH;
+	}
+    }
+  while (flush == Z_FINISH ? status != Z_STREAM_END : zs->avail_in > 0);
+}
+
 /* Return a new compression stream, with CALLBACK flush function passed
    OPAQUE token.  */
 
@@ -148,10 +183,28 @@ struct lto_compression_stream *
 lto_start_compression (void (*callback) (const char *, unsigned, void *),
 		       void *opaque)
 {
-  return lto_new_compression_stream (callback, opaque, true);
+  struct lto_compression_stream *stream
+    = lto_new_compression_stream (callback, opaque, true);
+  int status;
+
+  stream->outbuf = (unsigned char *) xmalloc (Z_BUFFER_LENGTH);
+  stream->zstream.next_out = stream->outbuf;
+  stream->zstream.avail_out = Z_BUFFER_LENGTH;
+  stream->zstream.next_in = Z_NULL;
+  stream->zstream.avail_in = 0;
+  stream->zstream.zalloc = lto_zalloc;
+  stream->zstream.zfree = lto_zfree;
+  stream->zstream.opaque = Z_NULL;
+
+  status = deflateInit (&stream->zstream, lto_normalized_zlib_level ());
+  if (status != Z_OK)
+    internal_error ("compressed stream: %s", zError (status));
+
+  return stream;
 }
 
-/* Append NUM_CHARS from address BASE to STREAM.  */
+/* Compress NUM_CHARS from address BASE into STREAM.  The data is
+   consumed before returning, so the caller may reuse BASE.  */
 
 void
 lto_compress_block (struct lto_compression_stream *stream,
@@ -159,8 +212,15 @@ lto_compress_block (struct lto_compression_stream *stream,
 {
   gcc_assert (stream->is_compression);
 
-  lto_append_to_compression_stream (stream, base, num_chars);
   lto_stats.num_output_il_bytes += num_chars;
+  if (num_chars == 0)
+    return;
+
+  timevar_push (TV_IPA_LTO_COMPRESS);
+  stream->zstream.next_in = (Bytef *) CONST_CAST (char *, base);
+  stream->zstream.avail_in = num_chars;
+  lto_deflate (stream, Z_NO_FLUSH);
+  timevar_pop (TV_IPA_LTO_COMPRESS);
 }
 
 /* Finalize STREAM compression, and free stream allocations.  */
@@ -168,61 +228,22 @@ lto_compress_block (struct lto_compression_stream *stream,
 void
 lto_end_compression (struct lto_compression_stream *stream)
 {
-  unsigned char *cursor = (unsigned char *) stream->buffer;
-  size_t remaining = stream->bytes;
-  const size_t outbuf_length = Z_BUFFER_LENGTH;
-  unsigned char *outbuf = (unsigned char *) xmalloc (outbuf_length);
-  z_stream out_stream;
-  size_t compressed_bytes = 0;
   int status;
 
   gcc_assert (stream->is_compression);
 
   timevar_push (TV_IPA_LTO_COMPRESS);
 
-  out_stream.next_out = outbuf;
-  out_stream.avail_out = outbuf_length;
-  out_stream.next_in = cursor;
-  out_stream.avail_in = remaining;
-  out_stream.zalloc = lto_zalloc;
-  out_stream.zfree = lto_zfree;
-  out_stream.opaque = Z_NULL;
+  stream->zstream.next_in = Z_NULL;
+  stream->zstream.avail_in = 0;
+  lto_deflate (stream, Z_FINISH);
 
-  status = deflateInit (&out_stream, lto_normalized_zlib_level ());
-  if (status != Z_OK)
-    internal_error ("compressed stream: %s", zError (status));
-
-  do
-    {
-      size_t in_bytes, out_bytes;
-
-      status = deflate (&out_stream, Z_FINISH);
-      if (status != Z_OK && status != Z_STREAM_END)
-	internal_error ("compressed stream: %s", zError (status));
-
-      in_bytes = remaining - out_stream.avail_in;
-      out_bytes = outbuf_length - out_stream.avail_out;
-
-      stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
-      lto_stats.num_compressed_il_bytes += out_bytes;
-      compressed_bytes += out_bytes;
-
-      cursor += in_bytes;
-      remaining -= in_bytes;
-
-      out_stream.next_out = outbuf;
-      out_stream.avail_out = outbuf_length;
-      out_stream.next_in = cursor;
-      out_stream.avail_in = remaining;
-    }
-  while (status != Z_STREAM_END);
-
-  status = deflateEnd (&out_stream);
+  status = deflateEnd (&stream->zstream);
   if (status != Z_OK)
     internal_error ("compressed stream: %s", zError (status));
 
+  free (stream->outbuf);
   lto_destroy_compression_stream (stream);
-  free (outbuf);
   timevar_pop (TV_IPA_LTO_COMPRESS);
 }
 
@@ -172,6 +172,7 @@ lto_write_options (void)
       switch (option->opt_index)
       {
 	case OPT_dumpbase:
+	case OPT_fltrans_output_list_:
 	case OPT_SPECIAL_unknown:
 	case OPT_SPECIAL_ignore:
 	case OPT_SPECIAL_program_name:
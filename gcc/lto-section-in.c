@@ -95,19 +95,26 @@ struct lto_buffer
 {
   char *data;
   size_t length;
+  size_t allocation;
 };
 
 /* Compression callback, append LENGTH bytes from DATA to the buffer pointed
-   to by OPAQUE.  */
+   to by OPAQUE.  The buffer grows geometrically, as the uncompressed data
+   arrives in many small pieces.  */
 
 static void
 lto_append_data (const char *data, unsigned length, void *opaque)
 {
   struct lto_buffer *buffer = (struct lto_buffer *) opaque;
+  size_t required = buffer->length + length;
 
-  buffer->data = (char *) xrealloc (buffer->data, buffer->length + length);
+  if (buffer->allocation < required)
+    {
+      buffer->allocation = MAX (required, 2 * buffer->allocation);
+      buffer->data = (char *) xrealloc (buffer->data, buffer->allocation);
+    }
   memcpy (buffer->data + buffer->length, data, length);
-  buffer->length += length;
+  buffer->length = required;
 }
 
 /* Header placed in returned uncompressed data streams.  Allows the
@@ -158,11 +165,16 @@ lto_get_section_data (struct lto_file_decl_data *file_data,
 
       buffer.data = (char *) header;
       buffer.length = header_length;
+      buffer.allocation = header_length;
 
       stream = lto_start_uncompression (lto_append_data, &buffer);
       lto_uncompress_block (stream, data, *len);
       lto_end_uncompression (stream);
 
+      /* Give back what the geometric growth allocated in excess.  */
+      if (buffer.allocation > buffer.length)
+	buffer.data = (char *) xrealloc (buffer.data, buffer.length);
+
       *len = buffer.length - header_length;
       data = buffer.data + header_length;
     }
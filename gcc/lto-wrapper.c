@@ -48,6 +48,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "simple-object.h"
 #include "lto-section-names.h"
 #include "collect-utils.h"
+#include "md5.h"
+#include "version.h"
 
 /* Environment variable, used for passing the names of offload targets from GCC
    driver to lto-wrapper.  */
@@ -117,6 +119,95 @@ maybe_unlink (const char *file)
     fprintf (stderr, "[Leaving LTRANS %s]\n", file);
 }
 
+/* Return the name under which the result of compiling the LTRANS unit
+   INPUT_NAME with the ARGC arguments in ARGV is kept in the cache
+   directory CACHE_DIR.  The name is the MD5 sum of the compiler
+   version, the arguments and the contents of the unit.  */
+
+static char *
+ltrans_cache_name (const char *cache_dir, const char **argv, int argc,
+		   const char *input_name)
+{
+  struct md5_ctx ctx;
+  unsigned char digest[16];
+  char buf[65536];
+  size_t len;
+  char *name, *p;
+  FILE *f;
+  int i;
+
+  md5_init_ctx (&ctx);
+  md5_process_bytes (version_string, strlen (version_string) + 1, &ctx);
+  for (i = 0; i < argc; i++)
+    md5_process_bytes (argv[i], strlen (argv[i]) + 1, &ctx);
+
+  f = fopen (input_name, "rb");
+  if (!f)
+    fatal_error (input_location, "fopen: %s: %m", input_name);
+  while ((len = fread (buf, 1, sizeof (buf), f)) > 0)
+    md5_process_bytes (buf, len, &ctx);
+  if (ferror (f))
+    fatal_error (input_location, "fread: %s: %m", input_name);
+  fclose (f);
+  md5_finish_ctx (&ctx, digest);
+
+  name = XNEWVEC (char, strlen (cache_dir) + 2 + 2 * sizeof (digest)
+			+ sizeof (".ltrans.o"));
+  p = name + sprintf (name, "%s%c", cache_dir, DIR_SEPARATOR);
+  for (i = 0; i < (int) sizeof (digest); i++)
+    p += sprintf (p, "%02x", digest[i]);
+  strcpy (p, ".ltrans.o");
+  return name;
+}
+
+/* Copy the file SRC to DEST like copy_file, but return false instead of
+   failing if SRC cannot be read or DEST cannot be written.  */
+
+static bool
+try_copy_file (const char *dest, const char *src)
+{
+  char buf[65536];
+  size_t len;
+  bool ok = true;
+  FILE *in, *out;
+
+  in = fopen (src, "rb");
+  if (!in)
+    return false;
+  out = fopen (dest, "wb");
+  if (!out)
+    {
+      fclose (in);
+      return false;
+    }
+  while (ok && (len = fread (buf, 1, sizeof (buf), in)) > 0)
+    ok = fwrite (buf, 1, len, out) == len;
+  if (ferror (in))
+    ok = false;
+  fclose (in);
+  if (fclose (out) != 0)
+    ok = false;
+  if (!ok)
+    unlink_if_ordinary (dest);
+  return ok;
+}
+
+/* Put the LTRANS output OUTPUT_NAME into the cache as CACHE_NAME.  The
+   copy is renamed into place, so that concurrent links never see a
+   partially written entry.  Failing to update the cache is not an
+   error.  */
+
+static void
+ltrans_cache_store (const char *output_name, const char *cache_name)
+{
+  char *tmp_name = concat (cache_name, ".tmp", NULL);
+
+  if (try_copy_file (tmp_name, output_name)
+      && rename (tmp_name, cache_name) != 0)
+    unlink_if_ordinary (tmp_name);
+  free (tmp_name);
+}
+
 /* Template of LTRANS dumpbase suffix.  */
 #define DUMPBASE_SUFFIX ".ltrans18446744073709551615"
 
@@ -954,6 +1045,8 @@ run_gcc (unsigned argc, char *argv[])
   int parallel = 0;
   int jobserver = 0;
   bool no_partition = false;
+  const char *ltrans_cache_dir = NULL;
+  char **cache_names = NULL;
   struct cl_decoded_option *fdecoded_options = NULL;
   struct cl_decoded_option *offload_fdecoded_options = NULL;
   unsigned int fdecoded_options_count = 0;
@@ -1064,6 +1157,10 @@ run_gcc (unsigned argc, char *argv[])
 	    no_partition = true;
 	  break;
 
+	case OPT_flto_incremental_:
+	  ltrans_cache_dir = option->arg;
+	  break;
+
 	case OPT_flto_:
 	  if (strcmp (option->arg, "jobserver") == 0)
 	    {
@@ -1264,6 +1361,15 @@ cont1:
       tmp += list_option_len;
       strcpy (tmp, ltrans_output_file);
 
+      /* The LTRANS units from WPA contain names derived from the random
+	 seed; fix it so that unchanged units are identical between links
+	 and can be found in the cache.  */
+      if (ltrans_cache_dir)
+	obstack_ptr_grow (&argv_obstack,
+			  concat ("-frandom-seed=",
+				  linker_output ? linker_output : "a.out",
+				  NULL));
+
       if (jobserver)
 	obstack_ptr_grow (&argv_obstack, xstrdup ("-fwpa=jobserver"));
       else if (parallel > 1)
@@ -1341,6 +1447,8 @@ cont:
 	  makefile = make_temp_file (".mk");
 	  mstream = fopen (makefile, "w");
 	}
+      if (ltrans_cache_dir)
+	cache_names = XCNEWVEC (char *, nr);
 
       /* Execute the LTRANS stage for each input file (or prepare a
 	 makefile to invoke this in parallel).  */
@@ -1375,6 +1483,26 @@ cont:
 	  argv_ptr[3] = output_name;
 	  argv_ptr[4] = input_name;
 	  argv_ptr[5] = NULL;
+
+	  /* Reuse the result of an earlier link if the cache has one for
+	     the same unit and options.  */
+	  if (ltrans_cache_dir)
+	    {
+	      cache_names[i] = ltrans_cache_name (ltrans_cache_dir, new_argv,
+						  new_head_argc, input_name);
+	      if (try_copy_file (output_name, cache_names[i]))
+		{
+		  if (verbose)
+		    fprintf (stderr, "Reusing %s for %s\n", cache_names[i],
+			     input_name);
+		  XDELETEVEC (cache_names[i]);
+		  cache_names[i] = NULL;
+		  maybe_unlink (input_name);
+		  output_names[i] = output_name;
+		  continue;
+		}
+	    }
+
 	  if (parallel)
 	    {
 	      fprintf (mstream, "%s:\n\t@%s ", output_name, new_argv[0]);
@@ -1436,6 +1564,16 @@ cont:
 	  for (i = 0; i < nr; ++i)
 	    maybe_unlink (input_names[i]);
 	}
+      if (cache_names)
+	{
+	  for (i = 0; i < nr; ++i)
+	    if (cache_names[i])
+	      {
+		ltrans_cache_store (output_names[i], cache_names[i]);
+		XDELETEVEC (cache_names[i]);
+	      }
+	  XDELETEVEC (cache_names);
+	}
       for (i = 0; i < nr; ++i)
 	{
 	  fputs (output_names[i], stdout);
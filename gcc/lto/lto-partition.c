@@ -617,6 +617,39 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 		  else
 		    cost += edge_cost;
 		}
+
+	      /* With profile feedback, pull callees reached by hot calls
+		 into the partition of their caller, so the calls are not
+		 cut and stay inlinable, as long as that does not grow the
+		 partition past its target size.  The edges were counted
+		 as leaving the partition above and are subtracted again
+		 when the callee is visited.  */
+	      for (edge = node->callees; edge; edge = edge->next_callee)
+		{
+		  cgraph_node *callee = edge->callee;
+
+		  if (edge->count
+		      && callee->definition
+		      && !callee->alias
+		      && !callee->no_reorder
+		      && !symbol_partitioned_p (callee)
+		      && callee->get_partitioning_class () == SYMBOL_PARTITION
+		      && contained_in_symbol (callee) == callee
+		      && opt_for_fn (node->decl, flag_branch_probabilities)
+		      && edge->maybe_hot_p ()
+		      && (partition->insns
+			  + inline_summaries->get (callee)->self_size
+			  <= partition_size))
+		    {
+		      if (symtab->dump_file)
+			fprintf (symtab->dump_file,
+				 "Adding hot callee %s/%i of %s/%i\n",
+				 callee->name (), callee->order,
+				 node->name (), node->order);
+		      add_symbol_to_partition (partition, callee);
+		      total_size -= inline_summaries->get (callee)->size;
+		    }
+		}
 	    }
 	  else
 	    {
@@ -736,6 +769,10 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	      varpool_pos = best_varpool_pos;
 	    }
 	  i = best_i;
+	  if (symtab->dump_file)
+	    fprintf (symtab->dump_file, "Partition %i boundary cost %i, "
+		     "internal cost %i\n", npartitions - 1, best_cost,
+		     best_internal);
  	  /* When we are finished, avoid creating empty partition.  */
 	  while (i < n_nodes - 1 && symbol_partitioned_p (order[i + 1]))
 	    i++;
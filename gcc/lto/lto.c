@@ -2103,6 +2103,60 @@ lto_file_read (lto_file *file, FILE *resolution_file, int *count)
 static size_t page_mask;
 #endif
 
+/* Cache of file descriptors of the object files we read sections
+   from, most recently used first.  Function bodies are read in
+   practically random order, so with a single entry we would keep
+   reopening the same files.  The files get closed at exit.  */
+
+#define LTO_FD_CACHE_SIZE 16
+
+struct lto_fd_cache_entry
+{
+  int fd;
+  char *name;
+};
+
+static struct lto_fd_cache_entry lto_fd_cache[LTO_FD_CACHE_SIZE];
+static int lto_fd_cache_entries;
+
+/* Return a file descriptor for FILE_NAME, opening the file if it is not
+   in the cache, and move it to the front of the cache.  */
+
+static int
+lto_open_cached_fd (const char *file_name)
+{
+  struct lto_fd_cache_entry entry;
+  int i;
+
+  for (i = 0; i < lto_fd_cache_entries; i++)
+    if (filename_cmp (lto_fd_cache[i].name, file_name) == 0)
+      break;
+
+  if (i < lto_fd_cache_entries)
+    entry = lto_fd_cache[i];
+  else
+    {
+      entry.fd = open (file_name, O_RDONLY|O_BINARY);
+      if (entry.fd == -1)
+	fatal_error (input_location, "Cannot open %s", file_name);
+      entry.name = xstrdup (file_name);
+
+      /* Evict the least recently used file if the cache is full.  */
+      if (lto_fd_cache_entries == LTO_FD_CACHE_SIZE)
+	{
+	  i = LTO_FD_CACHE_SIZE - 1;
+	  free (lto_fd_cache[i].name);
+	  close (lto_fd_cache[i].fd);
+	}
+      else
+	i = lto_fd_cache_entries++;
+    }
+
+  memmove (&lto_fd_cache[1], &lto_fd_cache[0], i * sizeof (entry));
+  lto_fd_cache[0] = entry;
+  return entry.fd;
+}
+
 /* Get the section data of length LEN from FILENAME starting at
    OFFSET.  The data segment must be freed by the caller when the
    caller is finished.  Returns NULL if all was not well.  */
@@ -2112,36 +2166,14 @@ lto_read_section_data (struct lto_file_decl_data *file_data,
 		       intptr_t offset, size_t len)
 {
   char *result;
-  static int fd = -1;
-  static char *fd_name;
+  int fd;
 #if LTO_MMAP_IO
   intptr_t computed_len;
   intptr_t computed_offset;
   intptr_t diff;
 #endif
 
-  /* Keep a single-entry file-descriptor cache.  The last file we
-     touched will get closed at exit.
-     ???  Eventually we want to add a more sophisticated larger cache
-     or rather fix function body streaming to not stream them in
-     practically random order.  */
-  if (fd != -1
-      && filename_cmp (fd_name, file_data->file_name) != 0)
-    {
-      free (fd_name);
-      close (fd);
-      fd = -1;
-    }
-  if (fd == -1)
-    {
-      fd = open (file_data->file_name, O_RDONLY|O_BINARY);
-      if (fd == -1)
-        {
-	  fatal_error (input_location, "Cannot open %s", file_data->file_name);
-	  return NULL;
-        }
-      fd_name = xstrdup (file_data->file_name);
-    }
+  fd = lto_open_cached_fd (file_data->file_name);
 
 #if LTO_MMAP_IO
   if (!page_mask)
@@ -2176,10 +2208,11 @@ lto_read_section_data (struct lto_file_decl_data *file_data,
   /* Native windows doesn't supports delayed unlink on opened file. So
      we close file here again. This produces higher I/O load, but at least
      it prevents to have dangling file handles preventing unlink.  */
-  free (fd_name);
-  fd_name = NULL;
+  free (lto_fd_cache[0].name);
   close (fd);
-  fd = -1;
+  lto_fd_cache_entries--;
+  memmove (&lto_fd_cache[0], &lto_fd_cache[1],
+	   lto_fd_cache_entries * sizeof (lto_fd_cache[0]));
 #endif
   return result;
 #endif
@@ -0,0 +1,380 @@
+/* Sampled allocation-site memory profiler.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+/* This implements -fmem-profile=FILE.  Unlike -fmem-report with
+   --enable-gather-detailed-mem-stats, it is available in release
+   compilers: rather than recording every allocation, the GC heap,
+   vec, hash_table and alloc-pool allocators count the bytes they hand
+   out (see mem_profile_alloc in vec.h), and every MEM_PROFILE_INTERVAL
+   bytes the call stack of the allocation in progress is charged with
+   that many bytes.  Sites which allocate a lot are thereby found with
+   a cost proportional to the amount of memory allocated, not to the
+   number of allocations.
+
+   The samples also track the resident set size of the compiler, and
+   the timing stack tracks the size of the GC heap, so that the peak
+   of each of them is known for every timing variable.
+
+   At the end of compilation FILE receives a JSON object with the
+   sites, sorted by decreasing bytes, and the peaks per timing
+   variable.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "backtrace.h"
+#include "timevar.h"
+#include "ggc.h"
+#include "diagnostic-core.h"
+#include "mem-profile.h"
+
+/* Number of bytes allocated between two samples.  */
+#define MEM_PROFILE_INTERVAL (512 * 1024)
+
+/* Number of frames recorded per allocation site.  */
+#define MEM_PROFILE_DEPTH 6
+
+/* Number of slots in the table of sites; a power of two.  */
+#define MEM_PROFILE_SITES 4096
+
+/* An allocation site: a kind of memory and a call stack.  */
+
+struct mem_profile_site
+{
+  enum mem_profile_kind kind;
+  int depth;
+  uintptr_t pcs[MEM_PROFILE_DEPTH];
+  size_t samples;
+  size_t bytes;
+};
+
+static const char *const mem_profile_kind_names[MEM_PROFILE_KINDS]
+  = { "ggc", "heap", "pool" };
+
+/* Hash table of the sites, using open addressing.  */
+static mem_profile_site *sites;
+static size_t n_sites;
+
+/* Bytes charged to sites which did not fit in the table.  */
+static size_t dropped_bytes;
+
+/* Bytes allocated of each kind, as estimated by the samples.  */
+static size_t kind_bytes[MEM_PROFILE_KINDS];
+
+/* The largest sizes of the GC heap and of the resident set seen.  */
+static size_t peak_ggc;
+static size_t peak_rss;
+
+static struct backtrace_state *bt_state;
+
+/* Descriptor of /proc/self/statm, or -1.  */
+static int statm_fd = -1;
+
+/* Return the resident set size of the compiler, or 0 if unknown.  */
+
+static size_t
+current_rss (void)
+{
+  char buf[128];
+  unsigned long size, resident;
+
+  if (statm_fd < 0 || lseek (statm_fd, 0, SEEK_SET) != 0)
+    return 0;
+  ssize_t len = read (statm_fd, buf, sizeof (buf) - 1);
+  if (len <= 0)
+    return 0;
+  buf[len] = '\0';
+  if (sscanf (buf, "%lu %lu", &size, &resident) != 2)
+    return 0;
+  return resident * getpagesize ();
+}
+
+/* Error callback for libbacktrace; a missing stack only makes the
+   profile less precise.  */
+
+static void
+mem_profile_bt_error (void *, const char *, int)
+{
+}
+
+/* The stack being collected by mem_profile_bt_simple.  */
+
+struct mem_profile_stack
+{
+  int depth;
+  uintptr_t pcs[MEM_PROFILE_DEPTH];
+};
+
+/* Callback for backtrace_simple: add PC to the stack DATA.  */
+
+static int
+mem_profile_bt_simple (void *data, uintptr_t pc)
+{
+  mem_profile_stack *stack = (mem_profile_stack *) data;
+  stack->pcs[stack->depth++] = pc;
+  return stack->depth == MEM_PROFILE_DEPTH;
+}
+
+/* Return the slot of the table of sites for KIND and STACK: either the
+   one holding it or the empty one where it belongs.  */
+
+static mem_profile_site *
+find_site (enum mem_profile_kind kind, const mem_profile_stack &stack)
+{
+  size_t hash = kind;
+  for (int i = 0; i < stack.depth; i++)
+    hash = hash * 31 + (stack.pcs[i] >> 2);
+
+  for (size_t i = hash;; i++)
+    {
+      mem_profile_site *site = &sites[i & (MEM_PROFILE_SITES - 1)];
+      if (site->samples == 0)
+	return site;
+      if (site->kind == kind
+	  && site->depth == stack.depth
+	  && memcmp (site->pcs, stack.pcs,
+		     stack.depth * sizeof (uintptr_t)) == 0)
+	return site;
+    }
+}
+
+/* MEM_PROFILE_HOOK: charge the allocation of SIZE bytes of kind KIND
+   which exhausted the countdown with the bytes of the samples it
+   covers.  */
+
+static void
+mem_profile_sample (enum mem_profile_kind kind, size_t size)
+{
+  size_t over = size - mem_profile_countdown;
+  size_t bytes = (1 + over / MEM_PROFILE_INTERVAL) * MEM_PROFILE_INTERVAL;
+  mem_profile_countdown = MEM_PROFILE_INTERVAL - over % MEM_PROFILE_INTERVAL;
+
+  kind_bytes[kind] += bytes;
+
+  mem_profile_stack stack;
+  stack.depth = 0;
+  if (bt_state)
+    backtrace_simple (bt_state, 1, mem_profile_bt_simple,
+		      mem_profile_bt_error, &stack);
+
+  /* Keep the table at most three quarters full.  */
+  mem_profile_site *site = find_site (kind, stack);
+  if (site->samples == 0)
+    {
+      if (n_sites >= MEM_PROFILE_SITES / 4 * 3)
+	{
+	  dropped_bytes += bytes;
+	  site = NULL;
+	}
+      else
+	{
+	  n_sites++;
+	  site->kind = kind;
+	  site->depth = stack.depth;
+	  memcpy (site->pcs, stack.pcs, stack.depth * sizeof (uintptr_t));
+	}
+    }
+  if (site)
+    {
+      site->samples++;
+      site->bytes += bytes;
+    }
+
+  size_t ggc = ggc_allocated_bytes ();
+  size_t rss = current_rss ();
+  peak_ggc = MAX (peak_ggc, ggc);
+  peak_rss = MAX (peak_rss, rss);
+  if (g_timer)
+    g_timer->note_memory (ggc, rss);
+}
+
+/* Start profiling the allocations.  */
+
+void
+mem_profile_start (void)
+{
+  sites = XCNEWVEC (mem_profile_site, MEM_PROFILE_SITES);
+  bt_state = backtrace_create_state (NULL, 0, mem_profile_bt_error, NULL);
+  statm_fd = open ("/proc/self/statm", O_RDONLY);
+  if (g_timer)
+    g_timer->track_memory (ggc_allocated_bytes);
+
+  mem_profile_hook = mem_profile_sample;
+  mem_profile_countdown = MEM_PROFILE_INTERVAL;
+}
+
+/* Print STR to FP as a JSON string literal.  */
+
+static void
+print_json_string (FILE *fp, const char *str)
+{
+  putc ('"', fp);
+  for (; *str; str++)
+    {
+      unsigned char c = *str;
+      if (c == '"' || c == '\\')
+	fprintf (fp, "\\%c", c);
+      else if (c < 0x20)
+	fprintf (fp, "\\u%04x", c);
+      else
+	putc (c, fp);
+    }
+  putc ('"', fp);
+}
+
+/* State of the printing of one frame of a stack.  */
+
+struct mem_profile_frame
+{
+  FILE *fp;
+  uintptr_t pc;
+  bool first;
+  bool printed;
+};
+
+/* Print to the stack of FRAME an entry for its pc, in function
+   FUNCTION of FILENAME at line LINENO; each can be unknown.  */
+
+static void
+print_frame (mem_profile_frame *frame, const char *filename, int lineno,
+	     const char *function)
+{
+  fprintf (frame->fp, "%s{\"pc\": \"%#lx\"", frame->first ? "" : ", ",
+	   (unsigned long) frame->pc);
+  frame->first = false;
+  frame->printed = true;
+  if (function)
+    {
+      fputs (", \"function\": ", frame->fp);
+      print_json_string (frame->fp, function);
+    }
+  if (filename)
+    {
+      fputs (", \"file\": ", frame->fp);
+      print_json_string (frame->fp, filename);
+      fprintf (frame->fp, ", \"line\": %d", lineno);
+    }
+  putc ('}', frame->fp);
+}
+
+/* Callback for backtrace_pcinfo: print the source position of the
+   frame DATA, which can be called several times when functions were
+   inlined.  */
+
+static int
+mem_profile_bt_pcinfo (void *data, uintptr_t, const char *filename,
+		       int lineno, const char *function)
+{
+  print_frame ((mem_profile_frame *) data, filename, lineno, function);
+  return 0;
+}
+
+/* Callback for backtrace_syminfo, used when the compiler has no debug
+   information: print the frame DATA with the name of its symbol.  */
+
+static void
+mem_profile_bt_syminfo (void *data, uintptr_t, const char *symname,
+			uintptr_t, uintptr_t)
+{
+  print_frame ((mem_profile_frame *) data, NULL, 0, symname);
+}
+
+/* qsort comparison function putting the sites which allocated the most
+   first.  */
+
+static int
+site_cmp (const void *p1, const void *p2)
+{
+  const mem_profile_site *s1 = (const mem_profile_site *) p1;
+  const mem_profile_site *s2 = (const mem_profile_site *) p2;
+
+  if (s1->bytes != s2->bytes)
+    return s1->bytes < s2->bytes ? 1 : -1;
+  return 0;
+}
+
+/* Stop profiling the allocations, and write the profile to FILENAME.  */
+
+void
+mem_profile_finish (const char *filename)
+{
+  mem_profile_countdown = (size_t) -1;
+  peak_ggc = MAX (peak_ggc, ggc_allocated_bytes ());
+  peak_rss = MAX (peak_rss, current_rss ());
+  if (statm_fd >= 0)
+    close (statm_fd);
+
+  FILE *fp = strcmp ("stderr", filename) == 0
+	     ? stderr
+	     : strcmp ("stdout", filename) == 0
+	     ? stdout
+	     : fopen (filename, "w");
+  if (!fp)
+    {
+      error ("could not open memory profile file %qs: %m", filename);
+      return;
+    }
+
+  fprintf (fp, "{\"interval\": %lu, \"peak_ggc\": %lu, \"peak_rss\": %lu,\n",
+	   (unsigned long) MEM_PROFILE_INTERVAL, (unsigned long) peak_ggc,
+	   (unsigned long) peak_rss);
+  fputs (" \"allocated\": {", fp);
+  for (int kind = 0; kind < MEM_PROFILE_KINDS; kind++)
+    fprintf (fp, "%s\"%s\": %lu", kind ? ", " : "",
+	     mem_profile_kind_names[kind], (unsigned long) kind_bytes[kind]);
+  fprintf (fp, "}, \"dropped\": %lu,\n \"sites\": [",
+	   (unsigned long) dropped_bytes);
+
+  qsort (sites, MEM_PROFILE_SITES, sizeof (mem_profile_site), site_cmp);
+  for (size_t i = 0; i < n_sites; i++)
+    {
+      mem_profile_site *site = &sites[i];
+      fprintf (fp, "%s\n  {\"kind\": \"%s\", \"bytes\": %lu, "
+	       "\"samples\": %lu, \"stack\": [",
+	       i ? "," : "", mem_profile_kind_names[site->kind],
+	       (unsigned long) site->bytes, (unsigned long) site->samples);
+      mem_profile_frame frame;
+      frame.fp = fp;
+      frame.first = true;
+      for (int j = 0; j < site->depth; j++)
+	{
+	  frame.pc = site->pcs[j];
+	  frame.printed = false;
+	  backtrace_pcinfo (bt_state, frame.pc, mem_profile_bt_pcinfo,
+			    mem_profile_bt_error, &frame);
+	  if (!frame.printed)
+	    backtrace_syminfo (bt_state, frame.pc, mem_profile_bt_syminfo,
+			       mem_profile_bt_error, &frame);
+	  if (!frame.printed)
+	    print_frame (&frame, NULL, 0, NULL);
+	}
+      fputs ("]}", fp);
+    }
+  fputs ("],\n \"timevars\": ", fp);
+  if (g_timer)
+    g_timer->print_json_memory (fp);
+  else
+    fputs ("[]", fp);
+  fputs ("}\n", fp);
+
+  if (fp != stderr && fp != stdout)
+    fclose (fp);
+  XDELETEVEC (sites);
+  sites = NULL;
+}
@@ -0,0 +1,29 @@
+/* Sampled allocation-site memory profiler.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef GCC_MEM_PROFILE_H
+#define GCC_MEM_PROFILE_H
+
+/* The allocators report to the profiler through mem_profile_alloc,
+   declared in vec.h.  */
+
+extern void mem_profile_start (void);
+extern void mem_profile_finish (const char *);
+
+#endif /* GCC_MEM_PROFILE_H */
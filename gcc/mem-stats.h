@@ -24,7 +24,8 @@ along with GCC; see the file COPYING3.  If not see
 /* Forward declaration.  */
 template<typename Key, typename Value,
 	 typename Traits = simple_hashmap_traits<default_hash_traits<Key>,
-						 Value> >
+						 Value>,
+	 template<typename, template<typename> class> class Table>
 class hash_map;
 
 #define LOCATION_LINE_EXTRA_SPACE 30
@@ -27,6 +27,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree.h"
 #include "stringpool.h"
 #include "gimple.h"
+#include "predict.h"
 #include "diagnostic-core.h"
 #include "gimple-ssa.h"
 #include "cgraph.h"
@@ -34,6 +35,52 @@ along with GCC; see the file COPYING3.  If not see
 #include "target.h"
 #include "attribs.h"
 #include "pretty-print.h"
+#include "gimple-iterator.h"
+#include "cfgloop.h"
+
+/* If CALLER is a version created for the target_clones attribute of the
+   versioned function DECL, return the version of DECL for the same target.
+   Both must have been cloned for the same list of targets, then the
+   dispatcher would select that version whenever CALLER runs.  */
+
+static cgraph_node *
+find_version_for_caller (cgraph_node *caller, tree decl)
+{
+  tree caller_clones = lookup_attribute ("target_clones",
+					 DECL_ATTRIBUTES (caller->decl));
+  tree callee_clones = lookup_attribute ("target_clones",
+					 DECL_ATTRIBUTES (decl));
+  tree caller_target = lookup_attribute ("target",
+					 DECL_ATTRIBUTES (caller->decl));
+  if (!caller_clones
+      || !callee_clones
+      || !caller_target
+      || !DECL_FUNCTION_VERSIONED (caller->decl)
+      || !attribute_value_equal (caller_clones, callee_clones))
+    return NULL;
+
+  const char *target
+    = TREE_STRING_POINTER (TREE_VALUE (TREE_VALUE (caller_target)));
+  if (strcmp (target, "default") == 0)
+    return NULL;
+
+  cgraph_function_version_info *v
+    = cgraph_node::get (decl)->function_version ();
+  if (v == NULL)
+    return NULL;
+  while (v->prev != NULL)
+    v = v->prev;
+  for (; v; v = v->next)
+    {
+      tree attr = lookup_attribute ("target",
+				    DECL_ATTRIBUTES (v->this_node->decl));
+      if (attr
+	  && strcmp (TREE_STRING_POINTER (TREE_VALUE (TREE_VALUE (attr))),
+		     target) == 0)
+	return v->this_node;
+    }
+  return NULL;
+}
 
 /* If the call in NODE has multiple target attribute with multiple fields,
    replace it with dispatcher call and create dispatcher (once).  */
@@ -61,6 +108,22 @@ create_dispatcher_calls (struct cgraph_node *node)
 	  || !DECL_FUNCTION_VERSIONED (decl))
 	continue;
 
+      /* Calls from a version of a function cloned for the same targets
+	 do not need to go through the dispatcher.  */
+      cgraph_node *caller = (e->caller->global.inlined_to
+			     ? e->caller->global.inlined_to : e->caller);
+      cgraph_node *version = find_version_for_caller (caller, decl);
+      if (version)
+	{
+	  if (version != node)
+	    {
+	      e_next = e->next_caller;
+	      e->redirect_callee (version);
+	      e = NULL;
+	    }
+	  continue;
+	}
+
       if (!targetm.has_ifunc_p ())
 	{
 	  error_at (gimple_location (call),
@@ -334,6 +397,129 @@ expand_target_clones (struct cgraph_node *node, bool definition)
   return ret;
 }
 
+/* Return true if NODE should be cloned for the targets given by
+   -ftarget-clones: it is hot and contains a hot innermost loop accessing
+   memory, whose vectorization is likely to benefit from the additional
+   instruction sets.  */
+
+static bool
+auto_target_clone_candidate_p (cgraph_node *node)
+{
+  if (!node->definition
+      || node->alias
+      || node->thunk.thunk_p
+      || node->global.inlined_to
+      || node->frequency != NODE_FREQUENCY_HOT
+      || DECL_EXTERNAL (node->decl)
+      || DECL_COMDAT (node->decl)
+      || DECL_FUNCTION_VERSIONED (node->decl)
+      || MAIN_NAME_P (DECL_NAME (node->decl))
+      || lookup_attribute ("target", DECL_ATTRIBUTES (node->decl))
+      || lookup_attribute ("target_clones", DECL_ATTRIBUTES (node->decl))
+      || lookup_attribute ("always_inline", DECL_ATTRIBUTES (node->decl))
+      || lookup_attribute ("noclone", DECL_ATTRIBUTES (node->decl))
+      || !node->has_gimple_body_p ()
+      || !opt_for_fn (node->decl, flag_tree_loop_vectorize))
+    return false;
+
+  node->get_body ();
+  function *fn = DECL_STRUCT_FUNCTION (node->decl);
+  if (!fn || !loops_for_fn (fn))
+    return false;
+
+  basic_block bb;
+  FOR_EACH_BB_FN (bb, fn)
+    if (bb->loop_father->num != 0
+	&& bb->loop_father->inner == NULL
+	&& maybe_hot_bb_p (fn, bb))
+      for (gimple_stmt_iterator gsi = gsi_start_bb (bb);
+	   !gsi_end_p (gsi); gsi_next (&gsi))
+	if (gimple_vuse (gsi_stmt (gsi)))
+	  return true;
+  return false;
+}
+
+/* Add a target_clones attribute for the default target and the targets
+   given by -ftarget-clones to NODE.  */
+
+static void
+add_auto_target_clones (cgraph_node *node)
+{
+  char *list = concat ("default,", flag_target_clones, NULL);
+  tree args = build_tree_list (NULL_TREE,
+			       build_string (strlen (list) + 1, list));
+  free (list);
+  DECL_ATTRIBUTES (node->decl)
+    = tree_cons (get_identifier ("target_clones"), args,
+		 DECL_ATTRIBUTES (node->decl));
+  /* Like for the attribute given by the user, do not inline the function,
+     the callers have to go through the dispatcher.  */
+  DECL_UNINLINABLE (node->decl) = 1;
+
+  if (dump_file)
+    fprintf (dump_file, "Cloning hot function %s/%i for targets %s\n",
+	     node->name (), node->order, flag_target_clones);
+}
+
+/* Entry point for the pass adding target_clones attributes for
+   -ftarget-clones.  It runs before the inline summaries are computed, so
+   the functions are treated as if the user had given the attribute.  */
+
+static unsigned int
+ipa_auto_target_clone (void)
+{
+  struct cgraph_node *node;
+
+  FOR_EACH_FUNCTION (node)
+    if (auto_target_clone_candidate_p (node))
+      add_auto_target_clones (node);
+  return 0;
+}
+
+namespace {
+
+const pass_data pass_data_auto_target_clone =
+{
+  SIMPLE_IPA_PASS,		/* type */
+  "autotargetclone",		/* name */
+  OPTGROUP_NONE,		/* optinfo_flags */
+  TV_NONE,			/* tv_id */
+  ( PROP_ssa | PROP_cfg ),	/* properties_required */
+  0,				/* properties_provided */
+  0,				/* properties_destroyed */
+  0,				/* todo_flags_start */
+  0				/* todo_flags_finish */
+};
+
+class pass_auto_target_clone : public simple_ipa_opt_pass
+{
+public:
+  pass_auto_target_clone (gcc::context *ctxt)
+    : simple_ipa_opt_pass (pass_data_auto_target_clone, ctxt)
+  {}
+
+  /* opt_pass methods: */
+  virtual bool gate (function *);
+  virtual unsigned int execute (function *)
+    {
+      return ipa_auto_target_clone ();
+    }
+};
+
+bool
+pass_auto_target_clone::gate (function *)
+{
+  return flag_target_clones != NULL && targetm.has_ifunc_p ();
+}
+
+} // anon namespace
+
+simple_ipa_opt_pass *
+make_pass_auto_target_clone (gcc::context *ctxt)
+{
+  return new pass_auto_target_clone (ctxt);
+}
+
 static bool target_clone_pass;
 
 static unsigned int
@@ -57,6 +57,9 @@ along with GCC; see the file COPYING3.  If not see
 
 #define TAG_MSGSEND		"objc_msg_lookup"
 #define TAG_MSGSENDSUPER	"objc_msg_lookup_super"
+#define TAG_MSGSENDCACHED	"objc_msg_lookup_cached"
+#define TAG_METHOD_CACHE	"objc_method_cache"
+#define UTAG_METHOD_CACHE	"_objc_method_cache"
 
 /* GNU-specific tags.  */
 
@@ -189,6 +192,16 @@ static void build_protocol_template (void);
 static GTY(()) tree objc_meta;
 static GTY(()) tree meta_base;
 
+/* Used with -fobjc-call-site-cache: 'struct _objc_method_cache' (laid
+   out like 'struct objc_method_cache' of <objc/message.h>), a pointer
+   to the latter, the objc_msg_lookup_cached() messenger and the cache
+   of each message send of the file, which are defined at the end by
+   build_method_cache_decls ().  */
+static GTY(()) tree objc_method_cache_template;
+static GTY(()) tree objc_method_cache_type;
+static GTY(()) tree umsg_cached_decl;
+static GTY(()) vec<tree, va_gc> *method_cache_decls;
+
 static void gnu_runtime_01_initialize (void)
 {
   tree type, ftype, IMP_type;
@@ -245,6 +258,39 @@ static void gnu_runtime_01_initialize (void)
 					  NULL, NULL_TREE);
   TREE_NOTHROW (umsg_super_decl) = 0;
 
+  if (flag_objc_call_site_cache)
+    {
+      tree decls, *chain = NULL;
+
+      objc_method_cache_type
+	= build_pointer_type (xref_tag (RECORD_TYPE,
+					get_identifier (TAG_METHOD_CACHE)));
+
+      /* struct _objc_method_cache {
+	   unsigned long version;
+	   Class class_;
+	   IMP imp;
+	 };  */
+      objc_method_cache_template
+	= objc_start_struct (get_identifier (UTAG_METHOD_CACHE));
+      decls = add_field_decl (long_unsigned_type_node, "version", &chain);
+      add_field_decl (objc_class_type, "class_", &chain);
+      add_field_decl (IMP_type, "imp", &chain);
+      objc_finish_struct (objc_method_cache_template, decls);
+
+      /* IMP objc_msg_lookup_cached (id, SEL, struct objc_method_cache *); */
+      type = build_function_type_list (IMP_type,
+				       objc_object_type,
+				       objc_selector_type,
+				       objc_method_cache_type,
+				       NULL_TREE);
+
+      umsg_cached_decl = add_builtin_function (TAG_MSGSENDCACHED,
+					       type, 0, NOT_BUILT_IN,
+					       NULL, NULL_TREE);
+      TREE_NOTHROW (umsg_cached_decl) = 0;
+    }
+
   /* The following GNU runtime entry point is called to initialize
 	 each module:
 
@@ -647,6 +693,33 @@ gnu_runtime_abi_01_build_typed_selector_reference (location_t loc, tree ident,
   return convert (objc_selector_type, expr);
 }
 
+/* Declare the cache of a new message send site.  It is zero
+   initialized by build_method_cache_decls ().  */
+
+static tree
+build_method_cache_decl (void)
+{
+  char buf[BUFSIZE];
+  tree decl;
+
+  snprintf (buf, BUFSIZE, "_OBJC_MethodCache_%u",
+	    vec_safe_length (method_cache_decls));
+  decl = start_var_decl (objc_method_cache_template, buf);
+  vec_safe_push (method_cache_decls, decl);
+  return decl;
+}
+
+static void
+build_method_cache_decls (void)
+{
+  unsigned ix;
+  tree decl;
+
+  FOR_EACH_VEC_SAFE_ELT (method_cache_decls, ix, decl)
+    finish_var_decl (decl, objc_build_constructor (objc_method_cache_template,
+						   NULL));
+}
+
 /* Build a tree expression to send OBJECT the operation SELECTOR,
    looking up the method on object LOOKUP_OBJECT (often same as OBJECT),
    assuming the method has prototype METHOD_PROTOTYPE.
@@ -695,12 +768,20 @@ build_objc_method_call (location_t loc, int super_flag, tree method_prototype,
 
   /* Param list + 2 slots for object and selector.  */
   vec_alloc (parms, nparm + 2);
-  vec_alloc (tv, 2);
+  vec_alloc (tv, 3);
 
   /* First, call the lookup function to get a pointer to the method,
      then cast the pointer, then call it with the method arguments.  */
   tv->quick_push (lookup_object);
   tv->quick_push (selector);
+  if (!super_flag && flag_objc_call_site_cache)
+    {
+      /* Look the method up through the cache of this send site.  */
+      tree cache = build_method_cache_decl ();
+      tv->quick_push (convert (objc_method_cache_type,
+			       build_unary_op (loc, ADDR_EXPR, cache, 0)));
+      sender = umsg_cached_decl;
+    }
   method = build_function_call_vec (loc, vNULL, sender, tv, NULL);
   vec_free (tv);
 
@@ -2093,6 +2174,8 @@ objc_generate_v1_gnu_metadata (void)
      finish up the array decl even if no selectors were used.  */
   build_gnu_selector_translation_table ();
 
+  build_method_cache_decls ();
+
   if (protocol_chain)
     generate_protocols ();
 
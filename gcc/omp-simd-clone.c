@@ -48,6 +48,9 @@ along with GCC; see the file COPYING3.  If not see
 #include "ipa-prop.h"
 #include "tree-eh.h"
 #include "varasm.h"
+#include "params.h"
+#include "tree-inline.h"
+#include "calls.h"
 
 
 /* Allocate a fresh `simd_clone' and return it.  NARGS is the number
@@ -1558,19 +1561,90 @@ simd_clone_adjust (struct cgraph_node *node)
   pop_cfun ();
 }
 
+/* Return true if NODE, a function not tagged as an elemental SIMD
+   function, should get SIMD clones anyway because it is small, has no side
+   effects and is called from hot loops that -fipa-simd-clone asked us to
+   vectorize.  */
+
+static bool
+simd_clone_auto_candidate_p (struct cgraph_node *node)
+{
+  if (node->simdclone
+      || node->simd_clones
+      || !node->definition
+      || node->externally_visible
+      || node->in_other_partition
+      || DECL_COMDAT (node->decl)
+      || DECL_ONE_ONLY (node->decl)
+      || !node->has_gimple_body_p ()
+      || stdarg_p (TREE_TYPE (node->decl))
+      || TYPE_ARG_TYPES (TREE_TYPE (node->decl)) == NULL_TREE
+      || VOID_TYPE_P (TREE_TYPE (TREE_TYPE (node->decl)))
+      || TYPE_ATOMIC (TREE_TYPE (TREE_TYPE (node->decl))))
+    return false;
+  for (tree t = TYPE_ARG_TYPES (TREE_TYPE (node->decl)); t; t = TREE_CHAIN (t))
+    if (TYPE_ATOMIC (TREE_VALUE (t)))
+      return false;
+
+  /* The calls of the SIMD clone execute the iterations of the loop in
+     lockstep, so the function must not have any side effects.  */
+  int flags = flags_from_decl_or_type (node->decl);
+  if (!(flags & ECF_CONST)
+      || (flags & ECF_LOOPING_CONST_OR_PURE)
+      || !TREE_NOTHROW (node->decl))
+    return false;
+
+  struct cgraph_edge *e;
+  for (e = node->callers; e; e = e->next_caller)
+    if (e->inline_failed
+	&& opt_for_fn (e->caller->decl, flag_ipa_simd_clone)
+	&& opt_for_fn (e->caller->decl, flag_tree_loop_vectorize)
+	/* More than one execution per invocation of the caller means
+	   the call is in a loop.  */
+	&& e->frequency > CGRAPH_FREQ_BASE
+	&& e->maybe_hot_p ())
+      break;
+  if (!e)
+    return false;
+
+  /* The vectorizer will not be able to vectorize the loop the SIMD
+     clone is wrapped into if the function contains loops itself.  */
+  node->get_body ();
+  function *fn = DECL_STRUCT_FUNCTION (node->decl);
+  if (!loops_for_fn (fn)
+      || number_of_loops (fn) > 1
+      || (estimate_num_insns_fn (node->decl, &eni_size_weights)
+	  > PARAM_VALUE (PARAM_IPA_SIMD_CLONE_MAX_INSNS)))
+    return false;
+
+  if (dump_file)
+    fprintf (dump_file, "Creating SIMD clones of %s/%i for hot caller "
+	     "%s/%i\n", node->name (), node->order, e->caller->name (),
+	     e->caller->order);
+  return true;
+}
+
 /* If the function in NODE is tagged as an elemental SIMD function,
-   create the appropriate SIMD clones.  */
+   or is a candidate for automatic SIMD clones, create the appropriate
+   SIMD clones.  */
 
 static void
 expand_simd_clones (struct cgraph_node *node)
 {
   tree attr = lookup_attribute ("omp declare simd",
 				DECL_ATTRIBUTES (node->decl));
-  if (attr == NULL_TREE
-      || node->global.inlined_to
+  if (node->global.inlined_to
       || lookup_attribute ("noclone", DECL_ATTRIBUTES (node->decl)))
     return;
 
+  bool auto_p = false;
+  if (attr == NULL_TREE)
+    {
+      if (!simd_clone_auto_candidate_p (node))
+	return;
+      auto_p = true;
+    }
+
   /* Ignore
      #pragma omp declare simd
      extern int foo ();
@@ -1585,13 +1659,19 @@ expand_simd_clones (struct cgraph_node *node)
 
   do
     {
-      /* Start with parsing the "omp declare simd" attribute(s).  */
+      /* Start with parsing the "omp declare simd" attribute(s).  Automatic
+	 SIMD clones take all arguments as vectors and, as the vectorizer
+	 cannot use masked clones, are created for the notinbranch case
+	 only.  */
       bool inbranch_clause_specified;
       struct cgraph_simd_clone *clone_info
-	= simd_clone_clauses_extract (node, TREE_VALUE (attr),
+	= simd_clone_clauses_extract (node, auto_p ? NULL_TREE
+				      : TREE_VALUE (attr),
 				      &inbranch_clause_specified);
       if (clone_info == NULL)
 	continue;
+      if (auto_p)
+	inbranch_clause_specified = true;
 
       int orig_simdlen = clone_info->simdlen;
       tree base_type = simd_clone_compute_base_data_type (node, clone_info);
@@ -1631,6 +1711,18 @@ expand_simd_clones (struct cgraph_node *node)
 		clone->inbranch = 1;
 	    }
 
+	  /* Do not bloat the code with automatic clones for ISA variants
+	     other than the one the vectorizer prefers for the selected
+	     target.  */
+	  if (auto_p)
+	    {
+	      node->simdclone = clone;
+	      int badness = targetm.simd_clone.usable (node);
+	      node->simdclone = NULL;
+	      if (badness != 0)
+		continue;
+	    }
+
 	  /* simd_clone_mangle might fail if such a clone has been created
 	     already.  */
 	  tree id = simd_clone_mangle (node, clone);
@@ -1670,7 +1762,8 @@ expand_simd_clones (struct cgraph_node *node)
 	    }
 	}
     }
-  while ((attr = lookup_attribute ("omp declare simd", TREE_CHAIN (attr))));
+  while (attr
+	 && (attr = lookup_attribute ("omp declare simd", TREE_CHAIN (attr))));
 }
 
 /* Entry point for IPA simd clone creation pass.  */
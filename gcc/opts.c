@@ -1472,6 +1472,8 @@ enable_fdo_optimizations (struct gcc_options *opts,
     opts->x_flag_vect_cost_model = VECT_COST_MODEL_DYNAMIC;
   if (!opts_set->x_flag_tree_loop_distribute_patterns)
     opts->x_flag_tree_loop_distribute_patterns = value;
+  if (!opts_set->x_flag_ipa_simd_clone)
+    opts->x_flag_ipa_simd_clone = value;
 }
 
 /* -f{,no-}sanitize{,-recover}= suboptions.  */
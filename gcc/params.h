@@ -202,6 +202,12 @@ extern void init_param_values (int *params);
   PARAM_VALUE (PARAM_IRA_MAX_LOOPS_NUM)
 #define IRA_MAX_CONFLICT_TABLE_SIZE \
   PARAM_VALUE (PARAM_IRA_MAX_CONFLICT_TABLE_SIZE)
+#define IRA_REGION_PSEUDOS \
+  PARAM_VALUE (PARAM_IRA_REGION_PSEUDOS)
+#define IRA_SIMPLE_LRA_THRESHOLD \
+  PARAM_VALUE (PARAM_IRA_SIMPLE_LRA_THRESHOLD)
+#define IRA_SIMPLE_LRA_COLD_THRESHOLD \
+  PARAM_VALUE (PARAM_IRA_SIMPLE_LRA_COLD_THRESHOLD)
 #define IRA_LOOP_RESERVED_REGS \
   PARAM_VALUE (PARAM_IRA_LOOP_RESERVED_REGS)
 #define LRA_MAX_CONSIDERED_RELOAD_PSEUDOS \
@@ -218,6 +224,8 @@ extern void init_param_values (int *params);
   PARAM_VALUE (PARAM_MIN_INSN_TO_PREFETCH_RATIO)
 #define PREFETCH_MIN_INSN_TO_MEM_RATIO \
   PARAM_VALUE (PARAM_PREFETCH_MIN_INSN_TO_MEM_RATIO)
+#define PREFETCH_MIN_REF_FREQUENCY \
+  PARAM_VALUE (PARAM_PREFETCH_MIN_REF_FREQUENCY)
 #define MIN_NONDEBUG_INSN_UID \
   PARAM_VALUE (PARAM_MIN_NONDEBUG_INSN_UID)
 #define MAX_STORES_TO_SINK \
@@ -242,6 +250,10 @@ extern void init_param_values (int *params);
   PARAM_VALUE (PARAM_ASAN_MEMINTRIN)
 #define ASAN_USE_AFTER_RETURN \
   PARAM_VALUE (PARAM_ASAN_USE_AFTER_RETURN)
+#define ASAN_MERGE_CHECKS \
+  PARAM_VALUE (PARAM_ASAN_MERGE_CHECKS)
+#define ASAN_HOIST_CHECKS \
+  PARAM_VALUE (PARAM_ASAN_HOIST_CHECKS)
 #define ASAN_INSTRUMENTATION_WITH_CALL_THRESHOLD \
   PARAM_VALUE (PARAM_ASAN_INSTRUMENTATION_WITH_CALL_THRESHOLD)
 #define ASAN_PARAM_USE_AFTER_SCOPE_DIRECT_EMISSION_THRESHOLD \
@@ -37,6 +37,14 @@ along with GCC; see the file COPYING3.  If not see
 #include "gimple-ssa.h"
 #include "tree-phinodes.h"
 #include "ssa-iterators.h"
+#include "tree-eh.h"
+#include "tree-into-ssa.h"
+#include "gimplify-me.h"
+#include "cfgloop.h"
+#include "tree-ssa-loop.h"
+#include "tree-ssa-loop-ivopts.h"
+#include "tree-chrec.h"
+#include "tree-scalar-evolution.h"
 
 /* This is used to carry information about basic blocks.  It is
    attached to the AUX field of the standard CFG block.  */
@@ -622,6 +630,204 @@ sanopt_optimize_walker (basic_block bb, struct sanopt_ctx *ctx)
   info->visited_p = true;
 }
 
+/* Return true if no statement in LOOP can free memory, change the
+   shadow memory or leave LOOP other than through one of its exit edges.
+   As LOOP has no subloops, every iteration of it then runs from the
+   header either to the latch or to an exit.  */
+
+static bool
+loop_suitable_for_check_hoisting_p (struct loop *loop)
+{
+  basic_block *body = get_loop_body (loop);
+  bool suitable = true;
+
+  for (unsigned int i = 0; suitable && i < loop->num_nodes; i++)
+    for (gimple_stmt_iterator gsi = gsi_start_bb (body[i]);
+	 !gsi_end_p (gsi); gsi_next (&gsi))
+      {
+	gimple *stmt = gsi_stmt (gsi);
+	if ((is_gimple_call (stmt)
+	     && !gimple_call_internal_p (stmt, IFN_ASAN_CHECK))
+	    || gimple_code (stmt) == GIMPLE_ASM
+	    || stmt_could_throw_p (stmt))
+	  {
+	    suitable = false;
+	    break;
+	  }
+      }
+
+  free (body);
+  return suitable;
+}
+
+/* Return true if BB is executed on every iteration of LOOP, including
+   the one that leaves it.  */
+
+static bool
+bb_executed_on_every_iteration_p (struct loop *loop, basic_block bb)
+{
+  if (!dominated_by_p (CDI_DOMINATORS, loop->latch, bb))
+    return false;
+
+  vec<edge> exits = get_loop_exit_edges (loop);
+  bool ret = !exits.is_empty ();
+  unsigned int i;
+  edge e;
+  FOR_EACH_VEC_ELT (exits, i, e)
+    if (!dominated_by_p (CDI_DOMINATORS, e->src, bb))
+      {
+	ret = false;
+	break;
+      }
+  exits.release ();
+  return ret;
+}
+
+/* Callback for walk_tree, find a subexpression that might trap.  */
+
+static tree
+find_trapping_expr_r (tree *tp, int *, void *)
+{
+  if (EXPR_P (*tp) && tree_could_trap_p (*tp))
+    return *tp;
+  return NULL_TREE;
+}
+
+/* Try to replace the ASAN_CHECK call at GSI, which is executed on every
+   iteration of LOOP, by a single check in the preheader of LOOP.  This
+   is possible if the checked address is invariant in LOOP, or if it
+   advances by at most the access size on every iteration, like for
+   a[i] with i counting up; the new check then covers all the bytes
+   accessed by LOOP.  Return true on success.  */
+
+static bool
+maybe_hoist_asan_check (struct loop *loop, gimple_stmt_iterator *gsi)
+{
+  gimple *stmt = gsi_stmt (*gsi);
+  HOST_WIDE_INT flags = tree_to_shwi (gimple_call_arg (stmt, 0));
+  tree ptr = gimple_call_arg (stmt, 1);
+  tree len = gimple_call_arg (stmt, 2);
+  tree start, size;
+
+  if (expr_invariant_in_loop_p (loop, ptr)
+      && expr_invariant_in_loop_p (loop, len))
+    {
+      start = ptr;
+      size = len;
+    }
+  else
+    {
+      affine_iv iv;
+      if (!tree_fits_shwi_p (len)
+	  || tree_to_shwi (len) <= 0
+	  || !simple_iv (loop, loop, ptr, &iv, false)
+	  || TREE_CODE (iv.step) != INTEGER_CST)
+	return false;
+
+      /* If there were gaps between the accessed bytes, the range check
+	 would test the gaps as well.  */
+      HOST_WIDE_INT step = int_cst_value (iv.step);
+      if (absu_hwi (step) > (unsigned HOST_WIDE_INT) tree_to_shwi (len))
+	return false;
+
+      start = iv.base;
+      size = fold_convert (sizetype, len);
+      if (step != 0)
+	{
+	  /* NITER may be conditional, and computing it without branches
+	     requires that no part of it can trap.  */
+	  tree niter = number_of_latch_executions (loop);
+	  if (chrec_contains_undetermined (niter)
+	      || walk_tree (&niter, find_trapping_expr_r, NULL, NULL))
+	    return false;
+
+	  tree span = fold_build2 (MULT_EXPR, sizetype,
+				   fold_convert (sizetype, niter),
+				   size_int (absu_hwi (step)));
+	  if (step < 0)
+	    start = fold_build_pointer_plus (start,
+					     fold_build1 (NEGATE_EXPR,
+							  sizetype, span));
+	  size = fold_build2 (PLUS_EXPR, sizetype, size, span);
+	  flags = (flags & ~ASAN_CHECK_SCALAR_ACCESS) | ASAN_CHECK_RANGE;
+	}
+    }
+
+  gimple_seq seq, stmts;
+  start = force_gimple_operand (unshare_expr (start), &seq, true, NULL_TREE);
+  size = force_gimple_operand (fold_convert (pointer_sized_int_node,
+					     unshare_expr (size)),
+			       &stmts, true, NULL_TREE);
+  gimple_seq_add_seq (&seq, stmts);
+
+  gcall *g = gimple_build_call_internal (IFN_ASAN_CHECK, 4,
+					 build_int_cst (integer_type_node,
+							flags),
+					 start, size,
+					 gimple_call_arg (stmt, 3));
+  gimple_set_location (g, gimple_location (stmt));
+  gimple_seq_add_stmt (&seq, g);
+  gsi_insert_seq_on_edge_immediate (loop_preheader_edge (loop), seq);
+
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    {
+      fprintf (dump_file, "Hoisting out of loop %d\n  ", loop->num);
+      print_gimple_stmt (dump_file, stmt, 0, dump_flags);
+      fprintf (dump_file, "as\n  ");
+      print_gimple_stmt (dump_file, g, 0, dump_flags);
+      fprintf (dump_file, "\n");
+    }
+
+  unlink_stmt_vdef (stmt);
+  gsi_remove (gsi, true);
+  return true;
+}
+
+/* Hoist the ASAN_CHECK calls that are executed on every iteration of
+   an innermost loop of FUN out of it where maybe_hoist_asan_check can
+   do so.  Inner loops of real code are mostly simple loops over
+   arrays, and checking them once per loop instead of once per
+   iteration removes most of the cost of instrumenting them.  */
+
+static void
+sanopt_hoist_asan_checks (function *fun)
+{
+  struct loop *loop;
+  bool changed = false;
+
+  loop_optimizer_init (LOOPS_NORMAL | LOOPS_HAVE_RECORDED_EXITS);
+  scev_initialize ();
+  calculate_dominance_info (CDI_DOMINATORS);
+
+  FOR_EACH_LOOP (loop, LI_ONLY_INNERMOST)
+    {
+      if (!loop_suitable_for_check_hoisting_p (loop))
+	continue;
+
+      basic_block *body = get_loop_body (loop);
+      for (unsigned int i = 0; i < loop->num_nodes; i++)
+	{
+	  if (!bb_executed_on_every_iteration_p (loop, body[i]))
+	    continue;
+
+	  gimple_stmt_iterator gsi;
+	  for (gsi = gsi_start_bb (body[i]); !gsi_end_p (gsi);)
+	    if (gimple_call_internal_p (gsi_stmt (gsi), IFN_ASAN_CHECK)
+		&& maybe_hoist_asan_check (loop, &gsi))
+	      changed = true;
+	    else
+	      gsi_next (&gsi);
+	}
+      free (body);
+    }
+
+  scev_finalize ();
+  loop_optimizer_finalize ();
+
+  if (changed)
+    mark_virtual_operands_for_renaming (fun);
+}
+
 /* Try to remove redundant sanitizer checks in function FUN.  */
 
 static int
@@ -631,6 +837,13 @@ sanopt_optimize (function *fun, bool *contains_asan_mark)
   ctx.asan_num_accesses = 0;
   ctx.contains_asan_mark = false;
 
+  /* Hoist checks out of loops first, so that the dominator walk below
+     sees the hoisted checks too.  */
+  if ((flag_sanitize & SANITIZE_ADDRESS)
+      && ASAN_HOIST_CHECKS
+      && number_of_loops (fun) > 1)
+    sanopt_hoist_asan_checks (fun);
+
   /* Set up block info for each basic block.  */
   alloc_aux_for_blocks (sizeof (sanopt_info));
 
@@ -471,6 +471,19 @@ static int cache_size;
 /* True if we should mark added dependencies as a non-register deps.  */
 static bool mark_as_hard;
 
+/* The bound on the length of the pending lists for the block being
+   analyzed by sched_analyze, or 0 to use MAX_PENDING_LIST_LENGTH.  */
+static int pending_list_length_limit;
+
+/* Return the length at which the pending lists are flushed.  */
+
+static inline int
+max_pending_list_length (void)
+{
+  return (pending_list_length_limit
+	  ? pending_list_length_limit : MAX_PENDING_LIST_LENGTH);
+}
+
 static int deps_may_trap_p (const_rtx);
 static void add_dependence_1 (rtx_insn *, rtx_insn *, enum reg_note);
 static void add_dependence_list (rtx_insn *, rtx_insn_list *, int,
@@ -2479,13 +2492,14 @@ sched_analyze_1 (struct deps_desc *deps, rtx x, rtx_insn *insn)
       /* Pending lists can't get larger with a readonly context.  */
       if (!deps->readonly
           && ((deps->pending_read_list_length + deps->pending_write_list_length)
-              >= MAX_PENDING_LIST_LENGTH))
+              >= max_pending_list_length ()))
 	{
 	  /* Flush all pending reads and writes to prevent the pending lists
 	     from getting any larger.  Insn scheduling runs too slowly when
 	     these lists get long.  When compiling GCC with itself,
 	     this flush occurs 8 times for sparc, and 10 times for m88k using
 	     the default value of 32.  */
+	  statistics_counter_event (cfun, "sched-deps pending list flush", 1);
 	  flush_pending_lists (deps, insn, false, true);
 	}
       else
@@ -2696,9 +2710,13 @@ sched_analyze_2 (struct deps_desc *deps, rtx x, rtx_insn *insn)
 	  {
 	    if ((deps->pending_read_list_length
 		 + deps->pending_write_list_length)
-		>= MAX_PENDING_LIST_LENGTH
+		>= max_pending_list_length ()
 		&& !DEBUG_INSN_P (insn))
-	      flush_pending_lists (deps, insn, true, true);
+	      {
+		statistics_counter_event (cfun, "sched-deps pending list flush",
+					  1);
+		flush_pending_lists (deps, insn, true, true);
+	      }
 	    add_insn_mem_dependence (deps, true, insn, x);
 	  }
 
@@ -3209,9 +3227,11 @@ sched_analyze_insn (struct deps_desc *deps, rtx x, rtx_insn *insn)
 	  EXECUTE_IF_SET_IN_REG_SET (reg_pending_clobbers, 0, i, rsi)
 	    {
 	      struct deps_reg *reg_last = &deps->reg_last[i];
-	      if (reg_last->uses_length >= MAX_PENDING_LIST_LENGTH
-		  || reg_last->clobbers_length >= MAX_PENDING_LIST_LENGTH)
+	      if (reg_last->uses_length >= max_pending_list_length ()
+		  || reg_last->clobbers_length >= max_pending_list_length ())
 		{
+		  statistics_counter_event (cfun,
+					    "sched-deps register list flush", 1);
 		  add_dependence_list_and_free (deps, insn, &reg_last->sets, 0,
 						REG_DEP_OUTPUT, false);
 		  add_dependence_list_and_free (deps, insn,
@@ -3667,8 +3687,12 @@ deps_analyze_insn (struct deps_desc *deps, rtx_insn *insn)
                && sel_insn_is_speculation_check (insn)))
         {
           /* Keep the list a reasonable size.  */
-          if (deps->pending_flush_length++ >= MAX_PENDING_LIST_LENGTH)
-            flush_pending_lists (deps, insn, true, true);
+          if (deps->pending_flush_length++ >= max_pending_list_length ())
+	    {
+	      statistics_counter_event (cfun, "sched-deps pending list flush",
+					1);
+	      flush_pending_lists (deps, insn, true, true);
+	    }
           else
 	    deps->pending_jump_insns
               = alloc_INSN_LIST (insn, deps->pending_jump_insns);
@@ -3815,6 +3839,32 @@ sched_analyze (struct deps_desc *deps, rtx_insn *head, rtx_insn *tail)
   if (sched_deps_info->use_cselib)
     cselib_init (CSELIB_RECORD_MEMORY);
 
+  /* On very long blocks, shrink the dependence window in proportion to
+     the length of the block so that the time spent here stays roughly
+     linear.  */
+  int governor_insns = PARAM_VALUE (PARAM_SCHED_GOVERNOR_INSNS);
+  if (governor_insns > 0)
+    {
+      int n_insns = 0;
+      for (insn = head;; insn = NEXT_INSN (insn))
+	{
+	  if (NONDEBUG_INSN_P (insn))
+	    n_insns++;
+	  if (insn == tail)
+	    break;
+	}
+      if (n_insns > governor_insns)
+	{
+	  pending_list_length_limit
+	    = MAX (MAX_PENDING_LIST_LENGTH
+		   * (int64_t) governor_insns / n_insns, 4);
+	  if (pending_list_length_limit >= MAX_PENDING_LIST_LENGTH)
+	    pending_list_length_limit = 0;
+	  else
+	    statistics_counter_event (cfun, "sched-deps governed block", 1);
+	}
+    }
+
   deps_start_bb (deps, head);
 
   for (insn = head;; insn = NEXT_INSN (insn))
@@ -3836,6 +3886,7 @@ sched_analyze (struct deps_desc *deps, rtx_insn *head, rtx_insn *tail)
 	{
 	  if (sched_deps_info->use_cselib)
 	    cselib_finish ();
+	  pending_list_length_limit = 0;
 	  return;
 	}
     }
@@ -0,0 +1,185 @@
+/* Micro-benchmarks of the compiler's core data structures.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "tm.h"
+#include "hash-set.h"
+#include "bitmap.h"
+#include "wide-int.h"
+#include "ggc.h"
+#include "selftest.h"
+
+/* Unlike the selftests, the benchmarks are built in all configurations:
+   timings taken with checking enabled say little about a release
+   compiler.  They are run by -fself-bench, and print one line per
+   benchmark to stderr, of the form
+
+     -fself-bench: NAME OPERATIONS NSEC-PER-OPERATION
+
+   so that the output of two compilers can be compared with a script.  */
+
+namespace selftest {
+
+/* Each benchmark is run this many times, and the fastest run is
+   reported; this filters out most of the noise from the rest of the
+   system.  */
+
+static const int bench_runs = 5;
+
+/* Run FN (N) BENCH_RUNS times, and report the fastest run as N
+   operations called NAME.  */
+
+static void
+run_bench (const char *name, void (*fn) (int), int n)
+{
+  long best = -1;
+  for (int i = 0; i < bench_runs; i++)
+    {
+      long start = get_run_time ();
+      fn (n);
+      long elapsed = get_run_time () - start;
+      if (best < 0 || elapsed < best)
+	best = elapsed;
+    }
+  fprintf (stderr, "-fself-bench: %s %d %.3f\n", name, n,
+	   best * 1000.0 / n);
+}
+
+/* Keep the results of the benchmarks alive, so that the computations
+   are not optimized away.  */
+
+static volatile long bench_sink;
+
+typedef hash_set<int_hash <int, -1, -2> > int_set;
+
+/* Return the Ith of a sequence of distinct keys, spread over the
+   hash table.  */
+
+static inline int
+bench_key (int i)
+{
+  return (int) (((unsigned) i * 2654435761u) & 0x3fffffff);
+}
+
+/* Insert N distinct keys into an empty hash_set.  */
+
+static void
+bench_hash_table_insert (int n)
+{
+  int_set set;
+  for (int i = 0; i < n; i++)
+    set.add (bench_key (i));
+  bench_sink = set.elements ();
+}
+
+/* Do N lookups, half of them successful, in a hash_set with
+   1024 elements.  */
+
+static void
+bench_hash_table_find (int n)
+{
+  int_set set;
+  for (int i = 0; i < 1024; i++)
+    set.add (bench_key (2 * i));
+  long found = 0;
+  for (int i = 0; i < n; i++)
+    found += set.contains (bench_key (i & 2047));
+  bench_sink = found;
+}
+
+/* Do N calls of bitmap_ior_into with two sparse bitmaps.  Once the
+   destination holds both sources nothing changes any more, but the
+   element lists are still walked, as happens in dataflow iteration.  */
+
+static void
+bench_bitmap_ior_into (int n)
+{
+  bitmap dst = BITMAP_ALLOC (NULL);
+  bitmap src1 = BITMAP_ALLOC (NULL);
+  bitmap src2 = BITMAP_ALLOC (NULL);
+  for (int i = 0; i < 1000; i++)
+    {
+      bitmap_set_bit (src1, i * 37);
+      bitmap_set_bit (src2, i * 53);
+    }
+  long changed = 0;
+  for (int i = 0; i < n; i++)
+    changed += bitmap_ior_into (dst, (i & 1) ? src2 : src1);
+  bench_sink = changed;
+  BITMAP_FREE (dst);
+  BITMAP_FREE (src1);
+  BITMAP_FREE (src2);
+}
+
+/* Push N elements onto an empty vec.  */
+
+static void
+bench_vec_safe_push (int n)
+{
+  auto_vec<int> v;
+  for (int i = 0; i < n; i++)
+    v.safe_push (i);
+  bench_sink = v.length ();
+}
+
+/* Do N multiply-and-add steps on 128-bit wide_ints.  */
+
+static void
+bench_wide_int_arith (int n)
+{
+  wide_int acc = wi::shwi (1, 128);
+  wide_int mul = wi::shwi (6364136223846793005LL, 128);
+  wide_int add = wi::shwi (1442695040888963407LL, 128);
+  for (int i = 0; i < n; i++)
+    acc = wi::add (wi::mul (acc, mul), add);
+  bench_sink = acc.to_shwi ();
+}
+
+/* Do N small allocations from the garbage-collected heap.  Nothing
+   refers to them, so they are reclaimed by the next collection.  */
+
+static void
+bench_ggc_alloc (int n)
+{
+  long sum = 0;
+  for (int i = 0; i < n; i++)
+    {
+      int *p = (int *) ggc_alloc_atomic (4 * sizeof (int));
+      p[0] = i;
+      sum += p[0];
+    }
+  bench_sink = sum;
+}
+
+/* Run all the benchmarks.  */
+
+void
+run_benchmarks ()
+{
+  run_bench ("hash_table_insert", bench_hash_table_insert, 1000000);
+  run_bench ("hash_table_find", bench_hash_table_find, 10000000);
+  run_bench ("bitmap_ior_into", bench_bitmap_ior_into, 100000);
+  run_bench ("vec_safe_push", bench_vec_safe_push, 10000000);
+  run_bench ("wide_int_arith", bench_wide_int_arith, 10000000);
+  run_bench ("ggc_alloc", bench_ggc_alloc, 1000000);
+}
+
+} // namespace selftest
@@ -323,4 +323,13 @@ extern int num_passes;
 
 #endif /* #if CHECKING_P */
 
+namespace selftest {
+
+/* Run the micro-benchmarks of -fself-bench (in selftest-bench.c).
+   These are available whether or not CHECKING_P.  */
+
+extern void run_benchmarks ();
+
+} /* end of namespace selftest.  */
+
 #endif /* GCC_SELFTEST_H */
@@ -779,38 +779,32 @@ case_values_threshold (void)
   return threshold;
 }
 
-/* Return true if a switch should be expanded as a decision tree.
-   RANGE is the difference between highest and lowest case.
-   UNIQ is number of unique case node targets, not counting the default case.
-   COUNT is the number of comparisons needed, not counting the default case.  */
+/* Return true if switches can be expanded as dispatch tables.  */
 
 static bool
-expand_switch_as_decision_tree_p (tree range,
-				  unsigned int uniq ATTRIBUTE_UNUSED,
-				  unsigned int count)
+jump_tables_available_p (void)
 {
-  int max_ratio;
-
   /* If neither casesi or tablejump is available, or flag_jump_tables
      over-ruled us, we really have no choice.  */
   if (!targetm.have_casesi () && !targetm.have_tablejump ())
-    return true;
+    return false;
   if (!flag_jump_tables)
-    return true;
+    return false;
 #ifndef ASM_OUTPUT_ADDR_DIFF_ELT
   if (flag_pic)
-    return true;
+    return false;
 #endif
 
-  /* If the switch is relatively small such that the cost of one
-     indirect jump on the target are higher than the cost of a
-     decision tree, go with the decision tree.
+  return true;
+}
 
-     If range of values is much bigger than number of values,
-     or if it is too large to represent in a HOST_WIDE_INT,
-     make a sequence of conditional branches instead of a dispatch.
+/* Return the largest ratio of the range of the case values of a dispatch
+   table to the number of comparisons it replaces.  */
 
-     The definition of "much bigger" depends on whether we are
+static int
+case_values_max_ratio (void)
+{
+  /* The definition of "much bigger" depends on whether we are
      optimizing for size or for speed.  If the former, the maximum
      ratio range/count = 3, because this was found to be the optimal
      ratio for size on i686-pc-linux-gnu, see PR11823.  The ratio
@@ -818,7 +812,32 @@ expand_switch_as_decision_tree_p (tree range,
      benchmarking investigation on numerous platforms.  Or maybe it
      just made sense to someone at some point in the history of GCC,
      who knows...  */
-  max_ratio = optimize_insn_for_size_p () ? 3 : 10;
+  return optimize_insn_for_size_p () ? 3 : 10;
+}
+
+/* Return true if a switch should be expanded as a decision tree.
+   RANGE is the difference between highest and lowest case.
+   UNIQ is number of unique case node targets, not counting the default case.
+   COUNT is the number of comparisons needed, not counting the default case.  */
+
+static bool
+expand_switch_as_decision_tree_p (tree range,
+				  unsigned int uniq ATTRIBUTE_UNUSED,
+				  unsigned int count)
+{
+  int max_ratio;
+
+  if (!jump_tables_available_p ())
+    return true;
+
+  /* If the switch is relatively small such that the cost of one
+     indirect jump on the target are higher than the cost of a
+     decision tree, go with the decision tree.
+
+     If range of values is much bigger than number of values,
+     or if it is too large to represent in a HOST_WIDE_INT,
+     make a sequence of conditional branches instead of a dispatch.  */
+  max_ratio = case_values_max_ratio ();
   if (count < case_values_threshold ()
       || ! tree_fits_uhwi_p (range)
       || compare_tree_int (range, max_ratio * count) > 0)
@@ -827,6 +846,96 @@ expand_switch_as_decision_tree_p (tree range,
   return false;
 }
 
+/* Split the ascending list of case nodes CASE_LIST, which is too sparse
+   for a single dispatch table, into clusters: runs of at least two nodes
+   dense enough for a dispatch table, by the criteria of
+   expand_switch_as_decision_tree_p, and single nodes.  The split
+   minimizes the number of clusters, which are the leaves of the decision
+   tree.  Return the list of case nodes in which each dispatch table
+   cluster is replaced by one node covering its range and jumping to a
+   new label.  Push these labels, and the lists of the case nodes of the
+   clusters, to TABLE_LABELS and TABLE_LISTS.  */
+
+static case_node_ptr
+group_case_clusters (case_node_ptr case_list, vec<tree> *table_labels,
+		     vec<case_node_ptr> *table_lists,
+		     object_allocator<case_node> &case_node_pool)
+{
+  auto_vec<case_node_ptr, 64> nodes;
+  case_node_ptr np, list;
+  unsigned int threshold = case_values_threshold ();
+  unsigned int max_ratio = case_values_max_ratio ();
+  unsigned int n, i, j, k;
+
+  if (!jump_tables_available_p ())
+    return case_list;
+
+  for (np = case_list; np; np = np->right)
+    nodes.safe_push (np);
+  n = nodes.length ();
+  if (n < 2)
+    return case_list;
+
+  /* COUNTS[I] is the number of comparisons the first I nodes need,
+     MIN_CLUSTERS[I] the smallest number of clusters they split into and
+     START[I] the first node of the last of those clusters.  */
+  auto_vec<unsigned int, 64> counts, min_clusters, start;
+  counts.safe_grow (n + 1);
+  min_clusters.safe_grow (n + 1);
+  start.safe_grow (n + 1);
+  counts[0] = 0;
+  min_clusters[0] = 0;
+  for (i = 1; i <= n; i++)
+    {
+      np = nodes[i - 1];
+      counts[i] = counts[i - 1] + (tree_int_cst_equal (np->low, np->high)
+				   ? 1 : 2);
+      min_clusters[i] = min_clusters[i - 1] + 1;
+      start[i] = i - 1;
+      for (j = 0; j + 1 < i; j++)
+	{
+	  unsigned int count = counts[i] - counts[j];
+	  if (min_clusters[j] + 1 < min_clusters[i]
+	      && count >= threshold
+	      && wi::leu_p (wi::to_widest (np->high)
+			    - wi::to_widest (nodes[j]->low),
+			    (unsigned HOST_WIDE_INT) max_ratio * count))
+	    {
+	      min_clusters[i] = min_clusters[j] + 1;
+	      start[i] = j;
+	    }
+	}
+    }
+
+  if (min_clusters[n] == n)
+    return case_list;
+
+  /* Rebuild the list from its end.  */
+  list = NULL;
+  for (i = n; i > 0; i = j)
+    {
+      j = start[i];
+      if (i - j == 1)
+	{
+	  nodes[j]->right = list;
+	  list = nodes[j];
+	  continue;
+	}
+
+      tree label = create_artificial_label (UNKNOWN_LOCATION);
+      int prob = 0;
+      for (k = j; k < i; k++)
+	prob += nodes[k]->prob;
+      nodes[i - 1]->right = NULL;
+      table_labels->safe_push (label);
+      table_lists->safe_push (nodes[j]);
+      list = add_case_node (list, nodes[j]->low, nodes[i - 1]->high, label,
+			    prob, case_node_pool);
+    }
+
+  return list;
+}
+
 /* Generate a decision tree, switching on INDEX_EXPR and jumping to
    one of the labels in CASE_LIST or to the DEFAULT_LABEL.
    DEFAULT_PROB is the estimated probability that it jumps to
@@ -1228,9 +1337,40 @@ expand_case (gswitch *stmt)
      tablejump) or a decision tree.  */
 
   if (expand_switch_as_decision_tree_p (range, uniq, count))
-    emit_case_decision_tree (index_expr, index_type,
-                             case_list, default_label,
-                             default_prob);
+    {
+      /* Dispatch dense clusters of cases through tables of their own,
+	 reached from the decision tree.  */
+      auto_vec<tree> table_labels;
+      auto_vec<case_node_ptr> table_lists;
+
+      case_list = group_case_clusters (case_list, &table_labels,
+				       &table_lists, case_node_pool);
+      emit_case_decision_tree (index_expr, index_type,
+			       case_list, default_label,
+			       default_prob);
+      for (unsigned int j = 0; j < table_labels.length (); j++)
+	{
+	  struct case_node *first = table_lists[j], *last;
+
+	  for (last = first; last->right; last = last->right)
+	    ;
+	  if (dump_file && (dump_flags & TDF_DETAILS))
+	    {
+	      fprintf (dump_file, ";; Expanding case cluster ");
+	      print_dec (first->low, dump_file, TYPE_SIGN (index_type));
+	      fprintf (dump_file, " ... ");
+	      print_dec (last->high, dump_file, TYPE_SIGN (index_type));
+	      fprintf (dump_file, " as dispatch table\n");
+	    }
+	  emit_label (label_rtx (table_labels[j]));
+	  emit_case_dispatch_table (index_expr, index_type,
+				    first, default_label,
+				    first->low, last->high,
+				    fold_build2 (MINUS_EXPR, index_type,
+						 last->high, first->low),
+				    NULL);
+	}
+    }
   else
     emit_case_dispatch_table (index_expr, index_type,
 			      case_list, default_label,
@@ -1339,7 +1479,8 @@ expand_sjlj_dispatch_table (rtx dispatch_index,
 /* Take an ordered list of case nodes
    and transform them into a near optimal binary tree,
    on the assumption that any target code selection value is as
-   likely as any other.
+   likely as any other, unless the probabilities of the cases
+   were read from profile feedback.
 
    The transformation is performed by splitting the ordered
    list into two equal sections plus a pivot.  The parts are
@@ -1356,6 +1497,7 @@ balance_case_nodes (case_node_ptr *head, case_node_ptr parent)
     {
       int i = 0;
       int ranges = 0;
+      int total_prob = 0;
       case_node_ptr *npp;
       case_node_ptr left;
 
@@ -1367,9 +1509,15 @@ balance_case_nodes (case_node_ptr *head, case_node_ptr parent)
 	    ranges++;
 
 	  i++;
+	  total_prob += np->prob;
 	  np = np->right;
 	}
 
+      /* Balance by the probabilities of the cases only when they were
+	 measured.  */
+      if (profile_status_for_fn (cfun) != PROFILE_READ)
+	total_prob = 0;
+
       if (i > 2)
 	{
 	  /* Split this list if it is long enough for that to help.  */
@@ -1379,6 +1527,20 @@ balance_case_nodes (case_node_ptr *head, case_node_ptr parent)
 	  /* If there are just three nodes, split at the middle one.  */
 	  if (i == 3)
 	    npp = &(*npp)->right;
+	  else if (total_prob > 0)
+	    {
+	      /* Split at the node where the probabilities of the cases
+		 reach half their total, so that the likely cases are
+		 tested early.  Keep a node on each side.  */
+	      int prob = (*npp)->prob;
+	      npp = &(*npp)->right;
+	      while ((*npp)->right->right
+		     && 2 * (prob + (*npp)->prob) < total_prob)
+		{
+		  prob += (*npp)->prob;
+		  npp = &(*npp)->right;
+		}
+	    }
 	  else
 	    {
 	      /* Find the place in the list that bisects the list's total cost,
@@ -177,7 +177,9 @@ enum vect_cost_for_stmt
   cond_branch_taken,
   vec_perm,
   vec_promote_demote,
-  vec_construct
+  vec_construct,
+  vector_gather_load,
+  vector_scatter_store
 };
 
 /* Separate locations for which the vectorizer cost model should
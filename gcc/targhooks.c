@@ -682,6 +682,10 @@ default_builtin_vectorization_cost (enum vect_cost_for_stmt type_of_cost,
       case vec_construct:
 	return TYPE_VECTOR_SUBPARTS (vectype) - 1;
 
+      case vector_gather_load:
+      case vector_scatter_store:
+	return TYPE_VECTOR_SUBPARTS (vectype);
+
       default:
         gcc_unreachable ();
     }
@@ -0,0 +1,37 @@
+/* Check that checks of invariant and of strided accesses in loops are
+   replaced by a single check before the loop.  */
+
+/* { dg-options "-fdump-tree-sanopt-details" } */
+/* { dg-do compile } */
+/* { dg-skip-if "" { *-*-* } { "-O0" "-flto" } { "" } } */
+
+void
+foo (int *a, int n)
+{
+  for (int i = 0; i < n; i++)
+    a[i] = i;
+}
+
+void
+bar (int *a, int *p, int n)
+{
+  for (int i = 0; i < n; i++)
+    a[i] += *p;
+}
+
+extern void baz (void);
+
+void
+qux (int *a, int n)
+{
+  /* The call might free A, nothing can be hoisted.  */
+  for (int i = 0; i < n; i++)
+    {
+      a[i] = i;
+      baz ();
+    }
+}
+
+/* { dg-final { scan-tree-dump "Hoisting out of loop" "sanopt" } } */
+/* { dg-final { scan-tree-dump "__builtin___asan_storeN" "sanopt" } } */
+/* { dg-final { scan-tree-dump "__builtin___asan_report_store4" "sanopt" } } */
@@ -0,0 +1,39 @@
+/* Check that the checks of adjacent accesses in the same basic block
+   are merged into one wider check, unless a call intervenes.  */
+
+/* { dg-options "-fdump-tree-sanopt" } */
+/* { dg-do compile } */
+/* { dg-skip-if "" { *-*-* } { "*" } { "-O0" } } */
+
+struct S { int a, b; };
+
+extern void bar (void);
+
+void
+foo (struct S *p, int x, int y)
+{
+  /* One 8-byte check for both stores.  */
+  p->a = x;
+  p->b = y;
+}
+
+void
+baz (char *p, char x, char y)
+{
+  /* One 2-byte check for both stores.  */
+  p[1] = y;
+  p[0] = x;
+}
+
+void
+qux (struct S *p, int x, int y)
+{
+  /* Two 4-byte checks, bar might not return.  */
+  p->a = x;
+  bar ();
+  p->b = y;
+}
+
+/* { dg-final { scan-tree-dump-times "__builtin___asan_report_store_n" 2 "sanopt" } } */
+/* { dg-final { scan-tree-dump-times "__builtin___asan_report_store4" 2 "sanopt" } } */
+/* { dg-final { scan-tree-dump-not "__builtin___asan_report_store1" "sanopt" } } */
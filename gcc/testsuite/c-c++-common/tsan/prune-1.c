@@ -0,0 +1,37 @@
+/* { dg-do compile } */
+/* { dg-skip-if "" { *-*-* } { "*" } { "-O2" } } */
+/* { dg-additional-options "-fdump-tree-tsan1" } */
+
+#include <stdlib.h>
+
+int g;
+volatile int vh;
+
+int
+foo (void)
+{
+  /* The object doesn't escape, no other thread can access it.  */
+  volatile int *p = (volatile int *) malloc (2 * sizeof (int));
+  p[0] = 1;
+  p[1] = 2;
+  int r = p[0] + p[1];
+  free ((void *) p);
+  return r;
+}
+
+void
+bar (void)
+{
+  /* Only the store needs to be instrumented.  */
+  g++;
+}
+
+int
+baz (void)
+{
+  /* Only the first load needs to be instrumented.  */
+  return vh + vh;
+}
+
+/* { dg-final { scan-tree-dump-times "__tsan_read4 " 1 "tsan1" } } */
+/* { dg-final { scan-tree-dump-times "__tsan_write4 " 1 "tsan1" } } */
@@ -0,0 +1,59 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -ftree-parallelize-loops=4 -fdump-tree-parloops2-details -fdump-tree-optimized" } */
+
+void abort (void);
+
+#define N 500
+
+int x[N][N];
+
+__attribute__((noinline))
+void triangle (int n)
+{
+  int i, j;
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j <= i; j++)
+      x[i][j] = i + j;
+}
+
+/* Outer loop with a double reduction over a triangular inner loop.  */
+
+__attribute__((noinline))
+unsigned int rtriangle (int n)
+{
+  int i, j;
+  unsigned int sum = 0;
+
+  for (i = 0; i < n; i++)
+    for (j = i; j < n; j++)
+      sum += x[i][j];
+
+  return sum;
+}
+
+/* The iterations of the outer loop all cost the same.  */
+
+__attribute__((noinline))
+void square (int n)
+{
+  int i, j;
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j < n; j++)
+      x[i][j] = i - j;
+}
+
+int main (void)
+{
+  triangle (N);
+  if (rtriangle (N) != 249500u)
+    abort ();
+  square (N);
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump-times "parallelizing outer loop" 3 "parloops2" } } */
+/* { dg-final { scan-tree-dump-times "has unbalanced iterations" 2 "parloops2" } } */
+/* { dg-final { scan-tree-dump-times "GOMP_loop_dynamic_start" 2 "optimized" } } */
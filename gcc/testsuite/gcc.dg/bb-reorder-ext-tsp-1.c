@@ -0,0 +1,39 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -freorder-blocks-algorithm=ext-tsp -fdump-rtl-bbro" } */
+
+extern void abort (void);
+
+__attribute__ ((noinline)) int
+classify (int x)
+{
+  int r = 0;
+  if (x < 0)
+    r = -1;
+  else if (x == 0)
+    r = 0;
+  else if (x < 10)
+    r = 1;
+  else
+    {
+      while (x >= 10)
+	{
+	  x /= 10;
+	  r++;
+	}
+      r += 10;
+    }
+  return r;
+}
+
+int
+main ()
+{
+  if (classify (-5) != -1
+      || classify (0) != 0
+      || classify (7) != 1
+      || classify (12345) != 14)
+    abort ();
+  return 0;
+}
+
+/* { dg-final { scan-rtl-dump "Reordering with the Ext-TSP algorithm" "bbro" } } */
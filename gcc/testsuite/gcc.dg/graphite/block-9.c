@@ -0,0 +1,49 @@
+/* { dg-require-effective-target size32plus } */
+/* { dg-additional-options "--param loop-unroll-jam-size=4" } */
+
+#define N 200
+
+double A[N][N], B[N][N], C[N][N];
+
+static void __attribute__((noinline))
+matmult (void)
+{
+  int i, j, k;
+
+  /* This should be blocked for the L1 and L2 caches, and the innermost
+     tiles unrolled and jammed.  */
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      for (k = 0; k < N; k++)
+	A[i][j] += B[i][k] * C[k][j];
+}
+
+extern void abort ();
+
+int
+main (void)
+{
+  int i, j;
+  double res = 0;
+
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      {
+	A[i][j] = 0;
+	B[i][j] = j;
+	C[i][j] = i;
+      }
+
+  matmult ();
+
+  for (i = 0; i < N; i++)
+    res += A[i][i];
+
+  if (res != 529340000)
+    abort ();
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump "tiled by" "graphite" } } */
+/* { dg-final { scan-tree-dump "unrolled and jammed by 4" "graphite" } } */
@@ -0,0 +1,9 @@
+/* Verify that the inliner reports how it maintained the edge heap.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -fno-early-inlining -fdump-ipa-inline"  } */
+
+static int f (int x) { return x * 3 + 1; }
+static int g (int x) { return f (x) + f (x + 1); }
+int h (int x) { return g (x) + g (x * 2); }
+
+/* { dg-final { scan-ipa-dump "Edge heap maintenance: \[1-9\]\[0-9\]* badness updates" "inline"  } } */
@@ -0,0 +1,45 @@
+/* { dg-do run } */
+/* { dg-require-effective-target store_merge } */
+/* { dg-options "-O2 -fdump-tree-store-merging" } */
+
+struct bar
+{
+  unsigned char a;
+  unsigned char b;
+  unsigned char c;
+  unsigned char d;
+  short e;
+  short f;
+};
+
+struct bar src, dst;
+
+__attribute__ ((noinline)) void
+copy (void)
+{
+  dst.a = src.a;
+  dst.b = src.b;
+  dst.c = src.c;
+  dst.d = src.d;
+  dst.e = src.e;
+  dst.f = src.f;
+}
+
+int
+main (void)
+{
+  src.a = 1;
+  src.b = 2;
+  src.c = 3;
+  src.d = 4;
+  src.e = 5;
+  src.f = 6;
+  copy ();
+  if (dst.a != 1 || dst.b != 2 || dst.c != 3 || dst.d != 4
+      || dst.e != 5 || dst.f != 6)
+    __builtin_abort ();
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump-times "Merging successful" 1 "store-merging" } } */
@@ -0,0 +1,34 @@
+/* { dg-do compile { target i?86-*-* x86_64-*-* } } */
+/* { dg-options "-O2 -fno-pic -fdump-rtl-expand-details" } */
+
+void f0 (void);
+void f1 (void);
+void f2 (void);
+void f3 (void);
+void f4 (void);
+void f5 (void);
+void f6 (void);
+
+void
+dispatch (int op)
+{
+  switch (op)
+    {
+    case 1: f0 (); break;
+    case 2: f1 (); break;
+    case 3: f2 (); break;
+    case 4: f3 (); break;
+    case 5: f4 (); break;
+    case 6: f5 (); break;
+    case 1000: f0 (); break;
+    case 1001: f1 (); break;
+    case 1002: f2 (); break;
+    case 1003: f3 (); break;
+    case 1004: f4 (); break;
+    case 1005: f5 (); break;
+    case 50000: f6 (); break;
+    }
+}
+
+/* { dg-final { scan-rtl-dump "Expanding case cluster 1 \\\.\\\.\\\. 6 as dispatch table" "expand" } } */
+/* { dg-final { scan-rtl-dump "Expanding case cluster 1000 \\\.\\\.\\\. 1005 as dispatch table" "expand" } } */
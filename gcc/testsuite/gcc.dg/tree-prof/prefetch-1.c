@@ -0,0 +1,37 @@
+/* { dg-options "-O2 -fprefetch-loop-arrays -mtune=amdfam10 -fdump-tree-aprefetch-details" { target { i?86-*-* x86_64-*-* } } } */
+
+#define N 4096
+
+double a[N], b[N];
+
+__attribute__ ((noinline)) double
+sum (int n)
+{
+  int i;
+  double s = 0;
+
+  /* The static prediction says that B is read in every iteration, the
+     profile shows it is almost never read.  */
+  for (i = 0; i < n; i++)
+    {
+      s += a[i];
+      if (__builtin_expect (a[i] < 0, 1))
+	s += b[i];
+    }
+  return s;
+}
+
+int
+main ()
+{
+  int i;
+  double s = 0;
+
+  for (i = 0; i < N; i++)
+    a[i] = i % 1024 ? 1 : -1;
+  for (i = 0; i < 100; i++)
+    s += sum (N);
+  return s == 0;
+}
+
+/* { dg-final-use { scan-tree-dump "Ignoring references in rarely executed bb" "aprefetch" { target { i?86-*-* x86_64-*-* } } } } */
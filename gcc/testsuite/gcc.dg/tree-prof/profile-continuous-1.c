@@ -0,0 +1,22 @@
+/* { dg-options "-O2 -fprofile-continuous -fdump-ipa-profile -fdump-tree-optimized" } */
+
+volatile int sink;
+
+__attribute__ ((noinline)) void
+work (int i)
+{
+  if (i & 1)
+    sink++;
+}
+
+int
+main (void)
+{
+  for (int i = 0; i < 100000; i++)
+    work (i);
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump "PROF_bias" "optimized" } } */
+/* The counts updated in the counter file reach the gcda file.  */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "count 100000" "profile" } } */
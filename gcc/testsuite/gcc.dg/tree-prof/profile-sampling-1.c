@@ -0,0 +1,22 @@
+/* { dg-options "-O2 -fprofile-correction --param profile-sampling-period=16 -fdump-ipa-profile -fdump-tree-optimized" } */
+
+volatile int sink;
+
+__attribute__ ((noinline)) void
+work (int i)
+{
+  if (i & 1)
+    sink++;
+}
+
+int
+main (void)
+{
+  for (int i = 0; i < 160000; i++)
+    work (i);
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump "__gcov_sampling.work" "optimized" } } */
+/* One call out of 16 is counted, 16 times; the loop of main is exact.  */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "count 160000" "profile" } } */
@@ -0,0 +1,39 @@
+/* { dg-options "-O2 -pthread -fprofile-update=sharded -fdump-ipa-profile -fdump-tree-optimized" } */
+
+#include <pthread.h>
+
+#define NUM_THREADS 8
+#define ITERATIONS 100000
+
+volatile int sink;
+
+__attribute__ ((noinline)) void
+work (int i)
+{
+  if (i & 1)
+    sink++;
+}
+
+void *
+thread (void *p)
+{
+  for (int i = 0; i < ITERATIONS; i++)
+    work (i);
+  return p;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  for (int t = 0; t < NUM_THREADS; t++)
+    if (pthread_create (&threads[t], NULL, thread, 0))
+      return 1;
+  for (int t = 0; t < NUM_THREADS; t++)
+    pthread_join (threads[t], NULL);
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump "PROF_shard_offset" "optimized" } } */
+/* The shards of the counters are added together.  */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "count 800000" "profile" } } */
@@ -0,0 +1,25 @@
+/* { dg-options "-O2 -freorder-functions-algorithm=call-chain-clustering -fdump-ipa-cgraph" } */
+
+__attribute__ ((noinline))
+int callee (int x)
+{
+  return x * 3 + 1;
+}
+
+__attribute__ ((noinline))
+int caller (int x)
+{
+  return callee (x) + 2;
+}
+
+int main ()
+{
+  int i, r = 0;
+
+  for (i = 0; i < 1000; i++)
+    r += caller (i);
+
+  return r == 0;
+}
+/* { dg-final-use-not-autofdo { scan-ipa-dump "appending cluster of callee to cluster of caller" "cgraph" } } */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "appending cluster of caller to cluster of main" "cgraph" } } */
@@ -0,0 +1,24 @@
+/* { dg-options "-O2 -fdump-rtl-loop2_unroll -funroll-loops -fno-peel-loops" } */
+
+int a[100];
+
+void
+__attribute__ ((noinline))
+t (int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    a[i] += i;
+}
+
+int
+main ()
+{
+  volatile int n = 7;
+  int j;
+  for (j = 0; j < 10000; j++)
+    t (n);
+  return 0;
+}
+/* { dg-final-use { scan-rtl-dump "Profiled trip count \[0-9\]+, unrolling at most \[0-9\]+ times" "loop2_unroll" } } */
+/* { dg-final-use { scan-rtl-dump "Unrolled loop \[0-9\]+ times, counting # of iterations in runtime" "loop2_unroll" } } */
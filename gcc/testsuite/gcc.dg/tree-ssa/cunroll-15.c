@@ -0,0 +1,16 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -fdump-tree-cunrolli-details" } */
+int a[16];
+int
+t (int n)
+{
+  int s = 0;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < 2; j++)
+      s += a[i] * a[i];
+  return s;
+}
+/* The copies of the inner loop body load and multiply the same values,
+   value numbering the outer loop after unrolling removes that.  */
+/* { dg-final { scan-tree-dump "completely unrolled" "cunrolli" } } */
+/* { dg-final { scan-tree-dump "RPO VN of the region entered by bb \[0-9\]+: \[0-9\]+ blocks, \[1-9\]\[0-9\]* uses replaced" "cunrolli" } } */
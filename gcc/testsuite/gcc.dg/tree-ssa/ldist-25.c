@@ -0,0 +1,46 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -ftree-loop-distribution -fno-tree-loop-distribute-patterns -fdump-tree-ldist-details" } */
+
+extern void abort (void);
+
+int a[1024], b[1024], c[1024], d[1024];
+
+void __attribute__((noinline,noclone))
+foo (int n)
+{
+  int i;
+
+  for (i = 1; i < n; i++)
+    {
+      a[i] = b[i] * 3;
+      c[i] = c[i-1] + b[i];
+      d[i] = d[i-1] ^ i;
+    }
+}
+
+int
+main ()
+{
+  int i, x = 0;
+
+  for (i = 0; i < 1024; i++)
+    b[i] = i;
+  foo (1024);
+  for (i = 1; i < 1024; i++)
+    {
+      x ^= i;
+      if (a[i] != 3 * i
+	  || c[i] != i * (i + 1) / 2
+	  || d[i] != x)
+	abort ();
+    }
+
+  return 0;
+}
+
+/* The parallel partition computing a[] is kept apart from the
+   sequential ones, which are fused together.  */
+/* { dg-final { scan-tree-dump "because they are sequential" "ldist" } } */
+/* { dg-final { scan-tree-dump-times "distributed: split to 2 loops" 1 "ldist" } } */
+/* { dg-final { scan-tree-dump-times "partition . is parallel" 1 "ldist" } } */
+/* { dg-final { scan-tree-dump-times "partition . is sequential" 1 "ldist" } } */
@@ -0,0 +1,25 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fdump-tree-thread1-details --param fsm-min-path-frequency=100" } */
+
+/* No path into the switch is taken every time it is executed, so
+   none is hot enough to duplicate the loop control on it.  */
+
+int f (int);
+
+int
+foo (int n)
+{
+  int state = 0, r = 0;
+  for (int i = 0; i < n; i++)
+    {
+      switch (state)
+	{
+	case 0: r += f (1); state = 1; break;
+	case 1: r += f (2); state = 2; break;
+	default: r += f (3); state = 0; break;
+	}
+    }
+  return r;
+}
+
+/* { dg-final { scan-tree-dump "the path is cold" "thread1" } } */
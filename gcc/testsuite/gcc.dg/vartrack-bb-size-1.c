@@ -0,0 +1,21 @@
+/* Check that var tracking cuts the CFG at blocks with too many live
+   variables instead of giving up.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -g --param max-vartrack-bb-size=2 -fdump-rtl-vartrack" } */
+
+extern void g (int, int, int, int);
+
+void
+f (int a, int b, int c, int d, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    {
+      int x = a + i, y = b * i, z = c - i, w = d ^ i;
+      g (x, y, z, w);
+      if (x > y)
+	g (w, z, y, x);
+    }
+}
+
+/* { dg-final { scan-rtl-dump "cutting" "vartrack" } } */
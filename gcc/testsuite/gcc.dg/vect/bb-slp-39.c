@@ -0,0 +1,49 @@
+/* { dg-require-effective-target vect_int } */
+
+#include "tree-vect.h"
+
+int a[8], b[8];
+
+__attribute__((noinline, noclone)) int
+dot8 (int *x, int *y)
+{
+  return x[0] * y[0] + x[1] * y[1] + x[2] * y[2] + x[3] * y[3]
+	 + x[4] * y[4] + x[5] * y[5] + x[6] * y[6] + x[7] * y[7];
+}
+
+__attribute__((noinline, noclone)) int
+max8 (int *x, int acc)
+{
+  int m0 = x[0] > x[1] ? x[0] : x[1];
+  int m1 = x[2] > x[3] ? x[2] : x[3];
+  int m2 = x[4] > x[5] ? x[4] : x[5];
+  int m3 = x[6] > x[7] ? x[6] : x[7];
+  m0 = m0 > m1 ? m0 : m1;
+  m2 = m2 > m3 ? m2 : m3;
+  m0 = m0 > m2 ? m0 : m2;
+  return m0 > acc ? m0 : acc;
+}
+
+int
+main ()
+{
+  int i;
+
+  check_vect ();
+
+  for (i = 0; i < 8; i++)
+    {
+      a[i] = (i & 1) ? -3 * i : 5 * i + 1;
+      b[i] = i - 4;
+      __asm__ volatile ("");
+    }
+
+  if (dot8 (a, b) != -4 + 9 - 22 + 9 + 0 - 15 + 62 - 63)
+    abort ();
+  if (max8 (a, 0) != 31 || max8 (a, 40) != 40 || max8 (b, -10) != 3)
+    abort ();
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump-times "replacing basic-block reduction" 2 "slp2" { target { vect_int_mult && { whole_vector_shift && vect_int_max } } } } } */
@@ -0,0 +1,36 @@
+/* { dg-require-effective-target vect_float } */
+
+#include "tree-vect.h"
+
+float a[4], b[4];
+
+/* The dot product of the first four elements of X and Y plus ACC,
+   written out as hand-unrolled geometry code usually is.  */
+
+__attribute__((noinline, noclone)) float
+dot4 (float *x, float *y, float acc)
+{
+  return acc + x[0] * y[0] + x[1] * y[1] + x[2] * y[2] + x[3] * y[3];
+}
+
+int
+main ()
+{
+  int i;
+
+  check_vect ();
+
+  for (i = 0; i < 4; i++)
+    {
+      a[i] = i + 1;
+      b[i] = 2 * i - 1;
+      __asm__ volatile ("");
+    }
+
+  if (dot4 (a, b, 0.5f) != 0.5f - 1 + 2 + 9 + 20)
+    abort ();
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump "replacing basic-block reduction" "slp2" { target { vect_float && vect_hw_misalign } } } } */
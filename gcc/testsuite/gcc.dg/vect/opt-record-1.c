@@ -0,0 +1,19 @@
+/* Check that -fopt-record records why a loop was not vectorized.  */
+/* { dg-do compile } */
+/* { dg-additional-options "-fopt-record=opt-record-1.json" } */
+
+extern int f (int);
+int a[128];
+
+void
+foo (void)
+{
+  int i;
+
+  for (i = 0; i < 128; i++)
+    a[i] = f (a[i]);
+}
+
+/* { dg-final { scan-file opt-record-1.json "\"pass\":\"tree-vect\",\"kind\":\"missed\"" } } */
+/* { dg-final { scan-file opt-record-1.json "\"function\":\"foo\"" } } */
+/* { dg-final { scan-file opt-record-1.json "\"reason\":\"function-call\"" } } */
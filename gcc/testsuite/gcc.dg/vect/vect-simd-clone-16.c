@@ -0,0 +1,45 @@
+/* { dg-require-effective-target vect_simd_clones } */
+/* { dg-additional-options "-fipa-simd-clone -fdump-ipa-simdclone" } */
+/* { dg-additional-options "-mavx" { target avx_runtime } } */
+
+#include "tree-vect.h"
+
+#ifndef N
+#define N 1024
+#endif
+
+int array[N];
+
+/* No "omp declare simd" here, the SIMD clone is created because foo
+   has no side effects and is called from a hot loop.  */
+
+static __attribute__((noinline)) int
+foo (int a, int b)
+{
+  if (a < 30)
+    return 5;
+  return a + b;
+}
+
+__attribute__((noinline, noclone)) void
+bar (int b)
+{
+  int i;
+  for (i = 0; i < N; ++i)
+    array[i] = foo (i, b);
+}
+
+int
+main ()
+{
+  int i;
+  check_vect ();
+  bar (123);
+  for (i = 0; i < N; i++)
+    if (array[i] != (i < 30 ? 5 : i + 123))
+      abort ();
+  return 0;
+}
+
+/* { dg-final { scan-ipa-dump "Creating SIMD clones of foo" "simdclone" } } */
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops in function" 2 "vect" } } */
@@ -1,5 +1,5 @@
 /* { dg-do compile } */
-/* { dg-options "-O3 -mavx -mtune=generic -dp" } */
+/* { dg-options "-O3 -mavx -mtune=generic -dp --param vect-epilogues-nomask=0" } */
 
 void feat_s3_cep_dcep (int cepsize_used, float **mfc, float **feat)
 {
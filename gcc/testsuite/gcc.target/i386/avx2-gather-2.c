@@ -1,5 +1,5 @@
 /* { dg-do compile } */
-/* { dg-options "-O3 -mavx2 -fdump-tree-vect-details" } */
+/* { dg-options "-O3 -mavx2 --param vect-epilogues-nomask=0 -fdump-tree-vect-details" } */
 
 #include "avx2-gather-1.c"
 
@@ -1,5 +1,5 @@
 /* { dg-do compile } */
-/* { dg-options "-mavx2 -O3 -fopenmp-simd -fdump-tree-vect-details" } */
+/* { dg-options "-mavx2 -O3 -fopenmp-simd --param vect-epilogues-nomask=0 -fdump-tree-vect-details" } */
 
 #define N 256
 int a1[N], a2[N], a3[N], a4[N], a5[N], a6[N], a7[N];
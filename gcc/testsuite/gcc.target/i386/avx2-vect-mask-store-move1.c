@@ -1,4 +1,4 @@
-/* { dg-options "-O3 -mavx2 -fdump-tree-vect-details" } */
+/* { dg-options "-O3 -mavx2 --param vect-epilogues-nomask=0 -fdump-tree-vect-details" } */
 /* { dg-require-effective-target avx2 } */
 
 #include "avx2-check.h"
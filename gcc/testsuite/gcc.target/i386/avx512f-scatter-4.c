@@ -0,0 +1,30 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -mavx512f" } */
+
+void
+f1 (float *__restrict y, int *__restrict idx, float *__restrict x, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    y[idx[i]] = x[i];
+}
+
+void
+f2 (double *__restrict y, int *__restrict idx, double *__restrict x, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    y[idx[i]] = x[i] * 2.0;
+}
+
+void
+f3 (int *__restrict y, long *__restrict idx, int *__restrict x, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    y[idx[i]] = x[i] + 1;
+}
+
+/* { dg-final { scan-assembler "vscatterdps\[ \\t\]+\[^\n\]*%zmm" } } */
+/* { dg-final { scan-assembler "vscatterdpd\[ \\t\]+\[^\n\]*%zmm" } } */
+/* { dg-final { scan-assembler "vpscatterqd\[ \\t\]+\[^\n\]*%ymm" } } */
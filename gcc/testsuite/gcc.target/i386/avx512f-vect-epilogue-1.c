@@ -0,0 +1,15 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -mavx512f -fdump-tree-vect-details" } */
+
+void
+foo (int *__restrict a, int *__restrict b, int *__restrict c, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    a[i] = b[i] + c[i];
+}
+
+/* { dg-final { scan-tree-dump "LOOP EPILOGUE VECTORIZED \\(VS=32\\)" "vect" } } */
+/* { dg-final { scan-assembler "vpaddd\[^\n\r\]*zmm" } } */
+/* { dg-final { scan-assembler "vpaddd\[^\n\r\]*ymm" } } */
@@ -0,0 +1,49 @@
+/* { dg-do run } */
+/* { dg-options "-O3 -mavx512f" } */
+/* { dg-require-effective-target avx512f } */
+
+#include "avx512f-check.h"
+
+#define N 64
+
+int a[N], b[N], c[N];
+
+__attribute__((noinline, noclone)) void
+foo (int *__restrict a, int *__restrict b, int *__restrict c, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    a[i] = b[i] + c[i];
+}
+
+/* The main loop here is peeled for alignment, so its epilogue has an
+   unknown trip count.  */
+
+__attribute__((noinline, noclone)) void
+init (int n)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    {
+      a[i] = -1;
+      b[i] = i;
+      c[i] = 2 * i + n;
+    }
+}
+
+static void
+avx512f_test (void)
+{
+  int i, n;
+
+  for (n = 0; n <= N; n++)
+    {
+      init (n);
+      foo (a, b, c, n);
+      for (i = 0; i < N; i++)
+	if (a[i] != (i < n ? 3 * i + n : -1))
+	  abort ();
+    }
+}
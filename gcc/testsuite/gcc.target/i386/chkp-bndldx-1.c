@@ -0,0 +1,14 @@
+/* { dg-do compile { target { ! x32 } } } */
+/* { dg-options "-fcheck-pointer-bounds -mmpx -O2 -fdump-tree-chkpopt-details" } */
+/* { dg-final { scan-tree-dump "Removing redundant bounds load" "chkpopt" } } */
+
+struct S
+{
+  int *p;
+};
+
+int
+test (struct S *s, int i)
+{
+  return s->p[i] + s->p[i + 1];
+}
@@ -0,0 +1,19 @@
+/* Test that memcmp with a small constant length whose result is used
+   for ordering is expanded inline.  */
+/* { dg-do compile { target { ! ia32 } } } */
+/* { dg-options "-O2" } */
+
+int
+f8 (const char *a, const char *b)
+{
+  return __builtin_memcmp (a, b, 8);
+}
+
+int
+f12 (const char *a, const char *b)
+{
+  return __builtin_memcmp (a, b, 12);
+}
+
+/* { dg-final { scan-assembler-not "memcmp" } } */
+/* { dg-final { scan-assembler "bswap" } } */
@@ -1,7 +1,10 @@
 /* { dg-do compile } */
 /* { dg-require-ifunc "" } */
 /* { dg-options "-fno-inline" } */
-/* { dg-final { scan-assembler-times "foo.ifunc" 6 } } */
+/* { dg-final { scan-assembler-times "foo.ifunc" 4 } } */
+/* The avx and avx2 clones of bar call the clones of foo directly.  */
+/* { dg-final { scan-assembler "call\[ \t\]+foo\\.avx\\." } } */
+/* { dg-final { scan-assembler "call\[ \t\]+foo\\.avx2\\." } } */
 
 __attribute__((target_clones("default","avx","avx2")))
 int
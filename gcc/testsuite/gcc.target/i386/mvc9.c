@@ -0,0 +1,53 @@
+/* { dg-do compile } */
+/* { dg-require-ifunc "" } */
+/* { dg-options "-O2 -ftree-vectorize -ftarget-clones=avx,avx2 -fdump-ipa-autotargetclone" } */
+
+float a[1024], b[1024];
+
+__attribute__((hot, noinline)) void
+scale (float *x, int n, float f)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    x[i] *= f;
+}
+
+__attribute__((hot, noinline)) void
+work (int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    a[i] = b[i] + 1.0f;
+  scale (a, n, 2.0f);
+}
+
+__attribute__((hot, noinline)) int
+no_loop (int x)
+{
+  return x + 1;
+}
+
+void
+cold (int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    a[i] = b[i];
+}
+
+int
+main ()
+{
+  work (1024);
+  cold (1024);
+  return no_loop (0);
+}
+
+/* { dg-final { scan-ipa-dump "Cloning hot function work" "autotargetclone" } } */
+/* { dg-final { scan-ipa-dump "Cloning hot function scale" "autotargetclone" } } */
+/* { dg-final { scan-ipa-dump-not "Cloning hot function no_loop" "autotargetclone" } } */
+/* { dg-final { scan-ipa-dump-not "Cloning hot function cold" "autotargetclone" } } */
+/* { dg-final { scan-assembler "work.ifunc" } } */
+/* The clones of work call the clones of scale for the same target.  */
+/* { dg-final { scan-assembler "(call|jmp)\[ \t\]+scale\\.avx\\." } } */
+/* { dg-final { scan-assembler "(call|jmp)\[ \t\]+scale\\.avx2\\." } } */
@@ -0,0 +1,27 @@
+/* { dg-do compile { target { ! ia32 } } } */
+/* { dg-options "-O2 -ftree-vectorize -mveclibabi=libmvec -ffast-math -mtune=generic -mno-avx" } */
+
+double x[256];
+float y[256];
+
+extern double exp(double);
+extern float powf(float, float);
+
+void foo(void)
+{
+  int i;
+
+  for (i=0; i<256; ++i)
+    x[i] = exp(x[i]);
+}
+
+void bar(void)
+{
+  int i;
+
+  for (i=0; i<256; ++i)
+    y[i] = powf(y[i], y[i]);
+}
+
+/* { dg-final { scan-assembler "_ZGVbN2v_exp" } } */
+/* { dg-final { scan-assembler "_ZGVbN4vv_powf" } } */
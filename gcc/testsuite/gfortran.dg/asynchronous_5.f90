@@ -0,0 +1,32 @@
+! { dg-do run }
+! { dg-require-effective-target pthread }
+! { dg-options "-pthread" }
+! { dg-set-target-env-var GFORTRAN_UNFORMATTED_BUFFER_SIZE "4096" }
+! Check asynchronous unformatted writes with a small buffer.
+program main
+  implicit none
+  integer, parameter :: n = 10000, nrec = 20
+  real(kind=8), asynchronous :: a(n), c(2)
+  real(kind=8) :: b(n), d(2)
+  integer :: i, j
+
+  open (10, file="asynchronous_5.dat", status="replace", form="unformatted", &
+        asynchronous="yes")
+  do j = 1, nrec
+     a = [(i + j * 1d5, i = 1, n)]
+     write (10, asynchronous="yes") a
+     c = [real(j, kind=8), a(j)]
+     write (10, asynchronous="yes") c
+     wait (10)
+  end do
+  wait (10)
+  close (10)
+  open (10, file="asynchronous_5.dat", status="old", form="unformatted")
+  do j = 1, nrec
+     read (10) b
+     if (any (b /= [(i + j * 1d5, i = 1, n)])) call abort
+     read (10) d
+     if (d(1) /= j .or. d(2) /= j + j * 1d5) call abort
+  end do
+  close (10, status="delete")
+end program main
@@ -0,0 +1,13 @@
+! { dg-do compile }
+! { dg-options "-Warray-temporaries" }
+! Check that sections whose bounds differ by constants of opposite sign
+! are ordered, so that no temporary is needed.
+subroutine foo (a, i, n)
+  integer :: i, n
+  real :: a(n)
+  a(i-5:i-1) = a(i+1:i+5)
+  a(i+1:i+5) = a(i-5:i-1)
+  a(i+1:i+3) = a(i-1:i+1) + 1.0
+  a(i-1:i+1) = a(i+1:i+3) * 2.0
+  a(i-1:i+1) = a(i+1:i-1:-1) ! { dg-warning "Creating array temporary" }
+end subroutine foo
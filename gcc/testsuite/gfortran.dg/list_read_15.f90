@@ -0,0 +1,46 @@
+! { dg-do run }
+! Check list formatted and F editing input of reals, including the forms
+! that are read directly from the unit buffer.
+program list_read_15
+  implicit none
+  real(8) :: a(12), b(3)
+  real(4) :: c(6)
+  real(8) :: f(4)
+  character(40) :: line
+
+  open (10, status='scratch')
+  write (10, '(a)') '0.1 -2.5, 1.0e10 3.25D-3,1+5 ,0.30000000000000004'
+  write (10, '(a)') '123456789012345678 2*7.5 , , 1.7976931348623157e308 -0.0'
+  write (10, '(a)') '1e-320 0.5 0.1 1.5 3.4028235e38 1.17549435e-38'
+  write (10, '(a)') '12.5,7'
+  write (10, '(a)') '  1.02.0e03.0q0    4'
+  rewind (10)
+  a = -1.0_8
+  read (10, *) a
+  if (any (a(1:6) /= [0.1_8, -2.5_8, 1.0e10_8, 3.25e-3_8, 1.0e5_8, &
+                      0.30000000000000004_8])) call abort
+  if (a(7) /= 123456789012345678.0_8) call abort
+  if (a(8) /= 7.5_8 .or. a(9) /= 7.5_8) call abort
+  if (a(10) /= -1.0_8) call abort
+  if (a(11) /= 1.7976931348623157e308_8) call abort
+  if (.not. (a(12) == 0.0_8 .and. sign (1.0_8, a(12)) < 0)) call abort
+  read (10, *) b(1), c(1:5)
+  if (b(1) /= 1.0e-320_8) call abort
+  if (any (c(1:5) /= [0.5_4, 0.1_4, 1.5_4, 3.4028235e38_4, &
+                      1.17549435e-38_4])) call abort
+  read (10, *) b(2), c(6)
+  if (b(2) /= 12.5_8 .or. c(6) /= 7.0_4) call abort
+  read (10, '(4f5.0)') f
+  if (any (f /= [1.0_8, 2.0_8, 3.0_8, 4.0_8])) call abort
+  close (10)
+
+  line = '0,1;2,5'
+  read (line, *, decimal='comma') b(1:2)
+  if (b(1) /= 0.1_8 .or. b(2) /= 2.5_8) call abort
+  line = '  31415.9265  '
+  read (line, '(f14.4)') b(3)
+  if (b(3) /= 31415.9265_8) call abort
+  line = '   314159265'
+  read (line, '(f12.8)') b(3)
+  if (b(3) /= 3.14159265_8) call abort
+end program list_read_15
@@ -0,0 +1,43 @@
+! { dg-do run }
+! { dg-require-effective-target pthread }
+! { dg-options "-pthread -fno-frontend-optimize" }
+! { dg-set-target-env-var GFORTRAN_MATMUL_THREADS "4" }
+! Check the multithreaded MATMUL against a plain loop nest.
+program main
+  implicit none
+  integer, parameter :: m = 300, n = 250, k = 200
+  real(kind=8) :: a(m,k), b(k,n), c(m,n), r(2*m,n), ref(m,n)
+  complex(kind=8) :: ca(m,k), cb(k,n), cc(m,n)
+  integer :: i, j, l
+
+  do j = 1, k
+     do i = 1, m
+        a(i,j) = mod(i + 3*j, 17) - 8
+     end do
+  end do
+  do j = 1, n
+     do i = 1, k
+        b(i,j) = mod(5*i + j, 13) - 6
+     end do
+  end do
+  ref = 0
+  do j = 1, n
+     do l = 1, k
+        do i = 1, m
+           ref(i,j) = ref(i,j) + a(i,l) * b(l,j)
+        end do
+     end do
+  end do
+
+  c = matmul(a, b)
+  if (any(c /= ref)) call abort
+
+  r = -1
+  r(1:2*m:2,:) = matmul(a, b)
+  if (any(r(1:2*m:2,:) /= ref) .or. any(r(2:2*m:2,:) /= -1)) call abort
+
+  ca = cmplx(a, -a, kind=8)
+  cb = cmplx(b, 0, kind=8)
+  cc = matmul(ca, cb)
+  if (any(cc /= cmplx(ref, -ref, kind=8))) call abort
+end program main
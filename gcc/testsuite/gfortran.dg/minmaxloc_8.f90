@@ -0,0 +1,37 @@
+! { dg-do run }
+! { dg-add-options ieee }
+! Check MAXLOC and MINLOC of contiguous arrays large enough to be
+! searched in blocks by the library, including ties and NaNs.
+program minmaxloc_8
+  implicit none
+  integer, parameter :: n = 300
+  real(8) :: a(n,3), nan
+  real(4) :: b(n,2)
+  integer :: c(n,2), i
+  integer :: l(2)
+
+  nan = 0.0_8
+  nan = nan / nan
+  do i = 1, n
+    a(i,:) = mod (i * 37, 101)
+    b(i,:) = mod (i * 53, 97)
+    c(i,:) = -mod (i * 29, 89)
+  end do
+  a(1:70,2) = nan
+  a(:,3) = nan
+  b(200,2) = 1000.0
+  b(250,2) = 1000.0
+
+  l = maxloc (a(:,1:1))
+  if (any (l /= [maxloc(a(:,1), dim=1), 1])) call abort
+  if (any (maxloc (a, dim=1) /= [30, 131, 1])) call abort
+  if (any (minloc (a, dim=1) /= [101, 101, 1])) call abort
+  if (any (maxloc (b, dim=1) /= [86, 200])) call abort
+  if (any (minloc (b, dim=1) /= [97, 97])) call abort
+  l = maxloc (b)
+  if (any (l /= [200, 2])) call abort
+  l = minloc (c)
+  if (any (l /= [46, 1])) call abort
+  if (any (minloc (c, dim=1) /= [46, 46])) call abort
+  if (any (maxloc (c, dim=1) /= [89, 89])) call abort
+end program minmaxloc_8
@@ -0,0 +1,23 @@
+! { dg-do run }
+! Check array temporaries of run-time size, which are placed in a stack
+! buffer if they are small and on the heap otherwise.
+program stack_temporary_1
+  implicit none
+  call check (10)
+  call check (128)
+  call check (129)
+  call check (100000)
+contains
+  subroutine check (n)
+    integer, intent(in) :: n
+    real(8) :: a(n), b(n)
+    integer :: i
+
+    a = [(real (i, 8), i = 1, n)]
+    b = a
+    a(1:n) = a(n:1:-1)
+    if (any (a /= b(n:1:-1))) call abort
+    a(1:n) = a(n:1:-1) + b
+    if (any (a /= 2 * b)) call abort
+  end subroutine check
+end program stack_temporary_1
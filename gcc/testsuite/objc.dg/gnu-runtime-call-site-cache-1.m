@@ -0,0 +1,75 @@
+/* Test that the call site caches of -fobjc-call-site-cache are
+   invalidated when methods are replaced or added.  */
+/* { dg-do run } */
+/* { dg-skip-if "" { *-*-* } { "-fnext-runtime" } { "" } } */
+/* { dg-options "-fobjc-call-site-cache" } */
+
+#include <stdlib.h>
+#include <objc/runtime.h>
+#include "../objc-obj-c++-shared/TestsuiteObject.m"
+
+@interface MyRootClass : TestsuiteObject
+- (int) value;
+@end
+
+@implementation MyRootClass
+- (int) value { return 1; }
+@end
+
+@interface MySubClass : MyRootClass
+@end
+
+@implementation MySubClass
+@end
+
+static int
+two (id self, SEL _cmd)
+{
+  return 2;
+}
+
+static int
+three (id self, SEL _cmd)
+{
+  return 3;
+}
+
+/* All the sends go through the same call site.  */
+static int
+send_value (id object)
+{
+  return [object value];
+}
+
+int
+main (void)
+{
+  id root = [[MyRootClass alloc] init];
+  id sub = [[MySubClass alloc] init];
+  int i;
+
+  for (i = 0; i < 3; i++)
+    if (send_value (root) != 1 || send_value (sub) != 1)
+      abort ();
+
+  method_setImplementation (class_getInstanceMethod (objc_getClass ("MyRootClass"),
+						     @selector (value)),
+			    (IMP) two);
+  for (i = 0; i < 3; i++)
+    if (send_value (root) != 2 || send_value (sub) != 2)
+      abort ();
+
+  if (! class_addMethod (objc_getClass ("MySubClass"), @selector (value),
+			 (IMP) three, method_getTypeEncoding
+			 (class_getInstanceMethod (objc_getClass ("MyRootClass"),
+						   @selector (value)))))
+    abort ();
+  for (i = 0; i < 3; i++)
+    if (send_value (root) != 2 || send_value (sub) != 3)
+      abort ();
+
+  if (send_value (nil) != 0)
+    abort ();
+
+  return 0;
+}
@@ -259,7 +259,11 @@ timer::timer () :
   m_stack (NULL),
   m_unused_stack_instances (NULL),
   m_start_time (),
-  m_jit_client_items (NULL)
+  m_jit_client_items (NULL),
+  m_function_name (NULL),
+  m_function_start_time (),
+  m_function_start_times (NULL),
+  m_ggc_probe (NULL)
 {
   /* Zero all elapsed times.  */
   memset (m_timevars, 0, sizeof (m_timevars));
@@ -300,6 +304,7 @@ timer::~timer ()
     delete m_timevars[i].children;
 
   delete m_jit_client_items;
+  free (m_function_start_times);
 }
 
 /* Initialize timing variables.  */
@@ -366,6 +371,16 @@ timer::push_internal (struct timevar_def *tv)
   else
     context = XNEW (struct timevar_stack_def);
 
+  /* Start the memory peaks of the new level from the current size,
+     after crediting it to the old topmost element.  */
+  context->peak_ggc = context->peak_rss = 0;
+  if (m_ggc_probe)
+    {
+      size_t ggc = m_ggc_probe ();
+      note_memory (ggc, 0);
+      context->peak_ggc = ggc;
+    }
+
   /* Fill it in and put it on the stack.  */
   context->timevar = tv;
   context->next = m_stack;
@@ -401,6 +416,23 @@ timer::pop_internal ()
   /* Attribute the elapsed time to the element we're popping.  */
   timevar_accumulate (&popped->timevar->elapsed, &m_start_time, &now);
 
+  /* Likewise for the memory peaks, which also count for the parent.  */
+  if (m_ggc_probe)
+    {
+      note_memory (m_ggc_probe (), 0);
+      popped->timevar->peak_ggc = MAX (popped->timevar->peak_ggc,
+				       popped->peak_ggc);
+      popped->timevar->peak_rss = MAX (popped->timevar->peak_rss,
+				       popped->peak_rss);
+      if (popped->next)
+	{
+	  popped->next->peak_ggc = MAX (popped->next->peak_ggc,
+					popped->peak_ggc);
+	  popped->next->peak_rss = MAX (popped->next->peak_rss,
+					popped->peak_rss);
+	}
+    }
+
   /* Take the item off the stack.  */
   m_stack = m_stack->next;
 
@@ -792,6 +824,234 @@ timer::print (FILE *fp)
   validate_phases (fp);
 }
 
+/* Print STR to FP as a JSON string literal.  */
+
+void
+timer::print_json_string (FILE *fp, const char *str)
+{
+  putc ('"', fp);
+  for (; *str; str++)
+    {
+      unsigned char c = *str;
+      if (c == '"' || c == '\\')
+	fprintf (fp, "\\%c", c);
+      else if (c < 0x20)
+	fprintf (fp, "\\u%04x", c);
+      else
+	putc (c, fp);
+    }
+  putc ('"', fp);
+}
+
+/* Print the members of a JSON object describing ELAPSED to FP.  */
+
+void
+timer::print_json_times (FILE *fp, const timevar_time_def &elapsed)
+{
+  fprintf (fp, "\"user\": %.6f, \"sys\": %.6f, \"wall\": %.6f, "
+	   "\"ggc_mem\": %lu",
+	   elapsed.user, elapsed.sys, elapsed.wall,
+	   (unsigned long) elapsed.ggc_mem);
+}
+
+/* Summarize timing variables to FP as a single-line JSON object, for
+   -ftime-report-format=json.  Unlike print, nested timevars recorded
+   with -ftime-report-details are emitted as "children" of their parent
+   rather than as indented rows.  */
+
+void
+timer::print_json (FILE *fp)
+{
+  unsigned int /* timevar_id_t */ id;
+  struct timevar_time_def now;
+  bool first = true;
+
+  if (fp == 0)
+    fp = stderr;
+
+  /* Attribute the current elapsed time to the topmost element, as
+     print does.  */
+  get_time (&now);
+  if (m_stack)
+    timevar_accumulate (&m_stack->timevar->elapsed, &m_start_time, &now);
+  m_start_time = now;
+
+  fputs ("{\"kind\": \"summary\", \"timevars\": [", fp);
+  for (id = 0; id < (unsigned int) TIMEVAR_LAST; ++id)
+    {
+      const timevar_def *tv = &m_timevars[(timevar_id_t) id];
+
+      if ((timevar_id_t) id == TV_TOTAL || !tv->used)
+	continue;
+
+      fputs (first ? "{\"name\": " : ", {\"name\": ", fp);
+      first = false;
+      print_json_string (fp, tv->name);
+      fputs (", ", fp);
+      print_json_times (fp, tv->elapsed);
+
+      if (tv->children)
+	{
+	  bool first_child = true;
+	  fputs (", \"children\": [", fp);
+	  for (child_map_t::iterator i = tv->children->begin ();
+	       i != tv->children->end (); ++i)
+	    {
+	      fputs (first_child ? "{\"name\": " : ", {\"name\": ", fp);
+	      first_child = false;
+	      print_json_string (fp, (*i).first->name);
+	      fputs (", ", fp);
+	      print_json_times (fp, (*i).second);
+	      putc ('}', fp);
+	    }
+	  putc (']', fp);
+	}
+      putc ('}', fp);
+    }
+  fputs ("], \"total\": {", fp);
+  print_json_times (fp, m_timevars[TV_TOTAL].elapsed);
+  fputs ("}}\n", fp);
+
+  validate_phases (fp);
+}
+
+/* Start attributing time to FUNCTION_NAME for -ftime-report-format=json.
+   The elapsed times of all timevars are recorded so that
+   end_function_report can emit just the time spent on this function.  */
+
+void
+timer::start_function_report (const char *function_name)
+{
+  struct timevar_time_def now;
+
+  gcc_assert (!m_function_name);
+
+  /* Bring the topmost element up to date so that the snapshot does not
+     miss the time it has accumulated since it was last exposed.  */
+  get_time (&now);
+  if (m_stack)
+    timevar_accumulate (&m_stack->timevar->elapsed, &m_start_time, &now);
+  m_start_time = now;
+
+  if (!m_function_start_times)
+    m_function_start_times = XNEWVEC (timevar_time_def, TIMEVAR_LAST);
+  for (unsigned i = 0; i < TIMEVAR_LAST; ++i)
+    m_function_start_times[i] = m_timevars[i].elapsed;
+  m_function_start_time = now;
+  m_function_name = function_name;
+}
+
+/* Print a JSON object to FP holding the time spent in each timevar since
+   the matching start_function_report.  Each function is printed on its
+   own line as soon as it has been compiled, so that the report can be
+   consumed while compilation is still in progress.  */
+
+void
+timer::end_function_report (FILE *fp)
+{
+  struct timevar_time_def now, total;
+  bool first = true;
+
+  gcc_assert (m_function_name);
+
+  get_time (&now);
+  if (m_stack)
+    timevar_accumulate (&m_stack->timevar->elapsed, &m_start_time, &now);
+  m_start_time = now;
+
+  memset (&total, 0, sizeof (total));
+  timevar_accumulate (&total, &m_function_start_time, &now);
+
+  fputs ("{\"kind\": \"function\", \"name\": ", fp);
+  print_json_string (fp, m_function_name);
+  fputs (", \"timevars\": [", fp);
+  for (unsigned id = 0; id < TIMEVAR_LAST; ++id)
+    {
+      timevar_time_def elapsed;
+
+      if ((timevar_id_t) id == TV_TOTAL || !m_timevars[id].used)
+	continue;
+
+      memset (&elapsed, 0, sizeof (elapsed));
+      timevar_accumulate (&elapsed, &m_function_start_times[id],
+			  &m_timevars[id].elapsed);
+      if (elapsed.user == 0 && elapsed.sys == 0 && elapsed.wall == 0
+	  && elapsed.ggc_mem == 0)
+	continue;
+
+      fputs (first ? "{\"name\": " : ", {\"name\": ", fp);
+      first = false;
+      print_json_string (fp, m_timevars[id].name);
+      fputs (", ", fp);
+      print_json_times (fp, elapsed);
+      putc ('}', fp);
+    }
+  fputs ("], \"total\": {", fp);
+  print_json_times (fp, total);
+  fputs ("}}\n", fp);
+
+  m_function_name = NULL;
+}
+
+/* Record, for -fmem-profile, the largest GC heap and resident set
+   sizes seen while each timing variable is on the stack.  GGC_PROBE
+   returns the size of the GC heap, and is called whenever the stack
+   changes.  */
+
+void
+timer::track_memory (size_t (*ggc_probe) (void))
+{
+  m_ggc_probe = ggc_probe;
+}
+
+/* Note that the GC heap holds GGC bytes and the resident set RSS bytes
+   (or 0 if unknown) at this point, for the topmost element of the
+   timing stack.  Its parents are updated when it is popped.  */
+
+void
+timer::note_memory (size_t ggc, size_t rss)
+{
+  if (m_stack)
+    {
+      m_stack->peak_ggc = MAX (m_stack->peak_ggc, ggc);
+      m_stack->peak_rss = MAX (m_stack->peak_rss, rss);
+    }
+}
+
+/* Print to FP a JSON array holding the memory peaks of each timing
+   variable, as recorded by track_memory.  */
+
+void
+timer::print_json_memory (FILE *fp)
+{
+  bool first = true;
+
+  /* Credit the elements still on the stack with their peaks.  */
+  for (timevar_stack_def *context = m_stack; context; context = context->next)
+    {
+      context->timevar->peak_ggc = MAX (context->timevar->peak_ggc,
+					context->peak_ggc);
+      context->timevar->peak_rss = MAX (context->timevar->peak_rss,
+					context->peak_rss);
+    }
+
+  putc ('[', fp);
+  for (unsigned id = 0; id < TIMEVAR_LAST; ++id)
+    {
+      const timevar_def *tv = &m_timevars[id];
+
+      if (!tv->used || (tv->peak_ggc == 0 && tv->peak_rss == 0))
+	continue;
+
+      fputs (first ? "{\"name\": " : ",\n  {\"name\": ", fp);
+      first = false;
+      print_json_string (fp, tv->name);
+      fprintf (fp, ", \"peak_ggc\": %lu, \"peak_rss\": %lu}",
+	       (unsigned long) tv->peak_ggc, (unsigned long) tv->peak_rss);
+    }
+  putc (']', fp);
+}
+
 /* Get the name of the topmost item.  For use by jit for validating
    inputs to gcc_jit_timer_pop.  */
 const char *
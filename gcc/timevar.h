@@ -119,6 +119,14 @@ class timer
   void pop_client_item ();
 
   void print (FILE *fp);
+  void print_json (FILE *fp);
+
+  void start_function_report (const char *function_name);
+  void end_function_report (FILE *fp);
+
+  void track_memory (size_t (*ggc_probe) (void));
+  void note_memory (size_t ggc, size_t rss);
+  void print_json_memory (FILE *fp);
 
   const char *get_topmost_item_name () const;
 
@@ -133,6 +141,8 @@ class timer
 			 const timevar_time_def *total,
 			 const char *name, const timevar_time_def &elapsed);
   static bool all_zero (const timevar_time_def &elapsed);
+  static void print_json_string (FILE *fp, const char *str);
+  static void print_json_times (FILE *fp, const timevar_time_def &elapsed);
 
  private:
   typedef hash_map<timevar_def *, timevar_time_def> child_map_t;
@@ -159,6 +169,11 @@ class timer
     unsigned used : 1;
 
     child_map_t *children;
+
+    /* With -fmem-profile, the largest GC heap and resident set sizes
+       seen while this variable was on the timing stack.  */
+    size_t peak_ggc;
+    size_t peak_rss;
   };
 
   /* Private type: an element on the timing stack
@@ -171,6 +186,10 @@ class timer
 
     /* The next lower timing variable context in the stack.  */
     struct timevar_stack_def *next;
+
+    /* The memory peaks seen since this level was pushed.  */
+    size_t peak_ggc;
+    size_t peak_rss;
   };
 
   /* A class for managing a collection of named timing items, for use
@@ -202,6 +221,17 @@ class timer
   /* If non-NULL, for use when timing libgccjit's client code.  */
   named_items *m_jit_client_items;
 
+  /* The function being reported by start_function_report, the time at
+     which the report started and the elapsed times of all timevars at
+     that point.  */
+  const char *m_function_name;
+  timevar_time_def m_function_start_time;
+  timevar_time_def *m_function_start_times;
+
+  /* If non-NULL, returns the size of the GC heap, which is then
+     sampled whenever the timing stack changes; see track_memory.  */
+  size_t (*m_ggc_probe) (void);
+
   friend class named_items;
 };
 
@@ -79,6 +79,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "omp-offload.h"
 #include "hsa.h"
 #include "edit-context.h"
+#include "mem-profile.h"
 
 #if defined(DBX_DEBUGGING_INFO) || defined(XCOFF_DEBUGGING_INFO)
 #include "dbxout.h"
@@ -1910,6 +1911,9 @@ finalize (bool no_backend)
   if (mem_report)
     dump_memory_report (true);
 
+  if (flag_mem_profile)
+    mem_profile_finish (flag_mem_profile);
+
   if (profile_report)
     dump_profile_report ();
 
@@ -2009,7 +2013,14 @@ toplev::~toplev ()
   if (g_timer && m_use_TV_TOTAL)
     {
       g_timer->stop (TV_TOTAL);
-      g_timer->print (stderr);
+      /* The timer may only exist for -fmem-profile.  */
+      if (time_report || !quiet_flag || flag_detailed_statistics)
+	{
+	  if (flag_time_report_format == TIME_REPORT_FORMAT_JSON)
+	    g_timer->print_json (stderr);
+	  else
+	    g_timer->print (stderr);
+	}
       delete g_timer;
       g_timer = NULL;
     }
@@ -2021,10 +2032,14 @@ toplev::~toplev ()
 void
 toplev::start_timevars ()
 {
-  if (time_report || !quiet_flag  || flag_detailed_statistics)
+  if (time_report || !quiet_flag  || flag_detailed_statistics
+      || flag_mem_profile)
     timevar_init ();
 
   timevar_start (TV_TOTAL);
+
+  if (flag_mem_profile)
+    mem_profile_start ();
 }
 
 /* Handle -fself-test.   */
@@ -2053,6 +2068,24 @@ toplev::run_self_tests ()
 #endif /* #if CHECKING_P */
 }
 
+/* Handle -fself-bench.  */
+
+void
+toplev::run_self_benchmarks ()
+{
+  if (no_backend)
+    {
+      error_at (UNKNOWN_LOCATION, "self-benchmarks incompatible with -E");
+      return;
+    }
+  input_location = UNKNOWN_LOCATION;
+  bitmap_obstack_initialize (NULL);
+
+  ::selftest::run_benchmarks ();
+
+  bitmap_obstack_release (NULL);
+}
+
 /* Entry point of cc1, cc1plus, jc1, f771, etc.
    Exit code is FATAL_EXIT_CODE if can't open files or if there were
    any errors, or SUCCESS_EXIT_CODE if compilation succeeded.
@@ -2123,6 +2156,9 @@ toplev::main (int argc, char **argv)
   if (flag_self_test)
     run_self_tests ();
 
+  if (flag_self_bench)
+    run_self_benchmarks ();
+
   /* Invoke registered plugin callbacks if any.  Some plugins could
      emit some diagnostics here.  */
   invoke_plugin_callbacks (PLUGIN_FINISH, NULL);
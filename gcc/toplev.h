@@ -43,6 +43,7 @@ private:
   void start_timevars ();
 
   void run_self_tests ();
+  void run_self_benchmarks ();
 
   bool m_use_TV_TOTAL;
   bool m_init_signals;
@@ -1246,6 +1246,220 @@ chkp_reduce_bounds_lifetime (void)
     }
 }
 
+/* Bounds known to be held in the bounds table for the slot
+   located by ADDR and associated with pointer PTR.  */
+struct bnd_slot_info
+{
+  tree addr;
+  tree ptr;
+  tree bounds;
+};
+
+/* Maximum number of bounds table accesses we walk through
+   when proving two loads read the same pointer value.  */
+#define CHKP_MAX_VUSE_WALK 16
+
+/* Return 1 if STMT may change bounds tables content.  Regular
+   stores and bounds checks never touch bounds tables.  */
+static bool
+chkp_may_change_bnd_tables_p (gimple *stmt)
+{
+  if (!gimple_vdef (stmt) || is_gimple_assign (stmt))
+    return false;
+
+  if (chkp_gimple_call_builtin_p (stmt, BUILT_IN_CHKP_BNDCL)
+      || chkp_gimple_call_builtin_p (stmt, BUILT_IN_CHKP_BNDCU)
+      || chkp_gimple_call_builtin_p (stmt, BUILT_IN_CHKP_BNDLDX))
+    return false;
+
+  return true;
+}
+
+/* Return 1 if VAL1 and VAL2 are known to hold the same value.
+   VAL1 should be computed before VAL2.  Besides trivially equal
+   operands we recognize two loads from the same location when
+   only bounds checks and bounds table accesses are executed
+   between them.  Instrumentation puts such statements between
+   two loads of the same pointer, which prevents FRE from merging
+   the loads.  */
+static bool
+chkp_same_value_p (tree val1, tree val2)
+{
+  gimple *def1, *def2;
+  tree vuse1, vuse2;
+  int steps;
+
+  if (operand_equal_p (val1, val2, 0))
+    return true;
+
+  if (TREE_CODE (val1) != SSA_NAME
+      || TREE_CODE (val2) != SSA_NAME)
+    return false;
+
+  def1 = SSA_NAME_DEF_STMT (val1);
+  def2 = SSA_NAME_DEF_STMT (val2);
+
+  if (!gimple_assign_single_p (def1)
+      || !gimple_assign_single_p (def2)
+      || gimple_has_volatile_ops (def1)
+      || gimple_has_volatile_ops (def2)
+      || !operand_equal_p (gimple_assign_rhs1 (def1),
+			   gimple_assign_rhs1 (def2), 0))
+    return false;
+
+  vuse1 = gimple_vuse (def1);
+  vuse2 = gimple_vuse (def2);
+
+  for (steps = 0; vuse2 && steps < CHKP_MAX_VUSE_WALK; steps++)
+    {
+      gimple *vdef_stmt;
+
+      if (vuse2 == vuse1)
+	return true;
+
+      vdef_stmt = SSA_NAME_DEF_STMT (vuse2);
+      if (!chkp_gimple_call_builtin_p (vdef_stmt, BUILT_IN_CHKP_BNDCL)
+	  && !chkp_gimple_call_builtin_p (vdef_stmt, BUILT_IN_CHKP_BNDCU)
+	  && !chkp_gimple_call_builtin_p (vdef_stmt, BUILT_IN_CHKP_BNDLDX)
+	  && !chkp_gimple_call_builtin_p (vdef_stmt, BUILT_IN_CHKP_BNDSTX))
+	return false;
+
+      vuse2 = gimple_vuse (vdef_stmt);
+    }
+
+  return vuse1 == vuse2;
+}
+
+/* Find bounds known for the slot located by ADDR
+   and associated with pointer PTR in AVAIL.  */
+static struct bnd_slot_info *
+chkp_find_bnd_slot (vec<struct bnd_slot_info> &avail, tree addr, tree ptr)
+{
+  unsigned int i;
+
+  for (i = avail.length (); i > 0; i--)
+    {
+      struct bnd_slot_info *slot = &avail[i - 1];
+      if (chkp_same_value_p (slot->addr, addr)
+	  && chkp_same_value_p (slot->ptr, ptr))
+	return slot;
+    }
+
+  return NULL;
+}
+
+/* Remove bounds loads and stores in BB which are redundant
+   with respect to bounds table accesses recorded in AVAIL.
+   Then process all basic blocks dominated by BB.  */
+static void
+chkp_remove_redundant_bnd_accesses_1 (basic_block bb,
+				      vec<struct bnd_slot_info> &avail)
+{
+  gimple_stmt_iterator i;
+  basic_block son;
+
+  for (i = gsi_start_bb (bb); !gsi_end_p (i); )
+    {
+      gimple *stmt = gsi_stmt (i);
+      struct bnd_slot_info *slot;
+      struct bnd_slot_info info;
+
+      if (chkp_gimple_call_builtin_p (stmt, BUILT_IN_CHKP_BNDLDX))
+	{
+	  info.addr = gimple_call_arg (stmt, 0);
+	  info.ptr = gimple_call_arg (stmt, 1);
+	  info.bounds = gimple_call_lhs (stmt);
+
+	  if (!info.bounds
+	      || TREE_CODE (info.bounds) != SSA_NAME
+	      || SSA_NAME_OCCURS_IN_ABNORMAL_PHI (info.bounds))
+	    {
+	      gsi_next (&i);
+	      continue;
+	    }
+
+	  slot = chkp_find_bnd_slot (avail, info.addr, info.ptr);
+	  if (slot)
+	    {
+	      if (dump_file && (dump_flags & TDF_DETAILS))
+		{
+		  fprintf (dump_file, "Removing redundant bounds load: ");
+		  print_gimple_stmt (dump_file, stmt, 0, 0);
+		}
+
+	      replace_uses_by (info.bounds, slot->bounds);
+	      unlink_stmt_vdef (stmt);
+	      gsi_remove (&i, true);
+	      release_defs (stmt);
+	      continue;
+	    }
+
+	  avail.safe_push (info);
+	}
+      else if (chkp_gimple_call_builtin_p (stmt, BUILT_IN_CHKP_BNDSTX))
+	{
+	  info.ptr = gimple_call_arg (stmt, 0);
+	  info.bounds = gimple_call_arg (stmt, 1);
+	  info.addr = gimple_call_arg (stmt, 2);
+
+	  slot = chkp_find_bnd_slot (avail, info.addr, info.ptr);
+	  if (slot && operand_equal_p (slot->bounds, info.bounds, 0))
+	    {
+	      if (dump_file && (dump_flags & TDF_DETAILS))
+		{
+		  fprintf (dump_file, "Removing redundant bounds store: ");
+		  print_gimple_stmt (dump_file, stmt, 0, 0);
+		}
+
+	      unlink_stmt_vdef (stmt);
+	      gsi_remove (&i, true);
+	      release_defs (stmt);
+	      continue;
+	    }
+
+	  /* We cannot tell which slots are overwritten by the
+	     store and therefore forget everything we know.  */
+	  avail.truncate (0);
+	  avail.safe_push (info);
+	}
+      else if (chkp_may_change_bnd_tables_p (stmt))
+	avail.truncate (0);
+
+      gsi_next (&i);
+    }
+
+  for (son = first_dom_son (CDI_DOMINATORS, bb);
+       son;
+       son = next_dom_son (CDI_DOMINATORS, son))
+    {
+      vec<struct bnd_slot_info> son_avail = vNULL;
+
+      /* Bounds known at the end of BB are still valid at
+	 the start of SON only if BB is its single predecessor.  */
+      if (single_pred_p (son))
+	son_avail = avail.copy ();
+
+      chkp_remove_redundant_bnd_accesses_1 (son, son_avail);
+      son_avail.release ();
+    }
+}
+
+/* Instrumentation loads bounds for each pointer load and
+   stores bounds for each pointer store.  When the same pointer
+   is loaded several times, e.g. on each access to a structure
+   field in a loop body, we get several bounds loads which
+   access the same bounds table slot.  Remove such loads and
+   stores if no bounds table modification happens between them.  */
+static void
+chkp_remove_redundant_bnd_accesses (void)
+{
+  vec<struct bnd_slot_info> avail = vNULL;
+
+  chkp_remove_redundant_bnd_accesses_1 (ENTRY_BLOCK_PTR_FOR_FN (cfun), avail);
+
+  avail.release ();
+}
+
 /* Initilize checker optimization pass.  */
 static void
 chkp_opt_init (void)
@@ -1291,6 +1505,8 @@ chkp_opt_execute (void)
 
   chkp_release_check_info ();
 
+  chkp_remove_redundant_bnd_accesses ();
+
   chkp_opt_fini ();
 
   return 0;
@@ -39,7 +39,14 @@ along with GCC; see the file COPYING3.  If not see
    This pass uses an RDG, Reduced Dependence Graph built on top of the
    data dependence relations.  The RDG is then topologically sorted to
    obtain a map of information producers/consumers based on which it
-   generates the new loops.  */
+   generates the new loops.
+
+   Each partition is further classified as parallel when the loop
+   generated for it carries no dependence between iterations, or as
+   sequential otherwise.  Sequential partitions are fused together, as
+   separating them benefits neither vectorization nor parallelization,
+   while the loops generated for parallel partitions are marked so that
+   the loop parallelization pass can rely on the result.  */
 
 #include "config.h"
 #include "system.h"
@@ -469,12 +476,21 @@ enum partition_kind {
     PKIND_NORMAL, PKIND_MEMSET, PKIND_MEMCPY, PKIND_MEMMOVE
 };
 
+/* Type of a partition: iterations of the loop generated for a parallel
+   partition are independent of each other, those of a sequential one
+   may not be.  */
+
+enum partition_type {
+    PTYPE_PARALLEL, PTYPE_SEQUENTIAL
+};
+
 struct partition
 {
   bitmap stmts;
   bitmap loops;
   bool reduction_p;
   enum partition_kind kind;
+  enum partition_type type;
   /* data-references a kind != PKIND_NORMAL partition is about.  */
   data_reference_p main_dr;
   data_reference_p secondary_dr;
@@ -493,6 +509,7 @@ partition_alloc (bitmap stmts, bitmap loops)
   partition->loops = loops ? loops : BITMAP_ALLOC (NULL);
   partition->reduction_p = false;
   partition->kind = PKIND_NORMAL;
+  partition->type = PTYPE_PARALLEL;
   return partition;
 }
 
@@ -531,6 +548,8 @@ partition_merge_into (partition *dest, partition *partition)
   bitmap_ior_into (dest->stmts, partition->stmts);
   if (partition_reduction_p (partition))
     dest->reduction_p = true;
+  if (partition->type == PTYPE_SEQUENTIAL)
+    dest->type = PTYPE_SEQUENTIAL;
 }
 
 
@@ -699,6 +718,11 @@ generate_loops_for_partition (struct loop *loop, partition *partition,
     }
 
   free (bbs);
+
+  /* LOOP now only contains the statements of PARTITION.  Tell the loop
+     parallelization pass that its iterations are independent.  */
+  if (partition->type == PTYPE_PARALLEL)
+    loop->can_be_parallel = true;
 }
 
 /* Build the size argument for a memory operation call.  */
@@ -1235,6 +1259,110 @@ similar_memory_accesses (struct graph *rdg, partition *partition1,
   return false;
 }
 
+/* Returns true when PARTITION1 and PARTITION2 in RDG access memory with
+   the same base address and at least one of the accesses is a write.  */
+
+static bool
+share_written_memory_p (struct graph *rdg, partition *partition1,
+			partition *partition2)
+{
+  unsigned i, j, k, l;
+  bitmap_iterator bi, bj;
+  data_reference_p ref1, ref2;
+
+  EXECUTE_IF_SET_IN_BITMAP (partition1->stmts, 0, i, bi)
+    FOR_EACH_VEC_ELT (RDG_DATAREFS (rdg, i), k, ref1)
+      {
+	tree base1 = ref_base_address (ref1);
+	if (!base1)
+	  continue;
+	EXECUTE_IF_SET_IN_BITMAP (partition2->stmts, 0, j, bj)
+	  FOR_EACH_VEC_ELT (RDG_DATAREFS (rdg, j), l, ref2)
+	    if ((DR_IS_WRITE (ref1) || DR_IS_WRITE (ref2))
+		&& base1 == ref_base_address (ref2))
+	      return true;
+      }
+
+  return false;
+}
+
+/* Returns true if the statements of PARTITION in RDG carry a dependence
+   between the iterations of the loop LOOP_NEST[0].  */
+
+static bool
+partition_carries_dependence_p (struct graph *rdg, vec<loop_p> loop_nest,
+				partition *partition)
+{
+  struct loop *loop = loop_nest[0];
+  auto_vec<data_reference_p, 8> drs;
+  data_reference_p dr1, dr2;
+  bitmap_iterator bi;
+  unsigned i, j;
+
+  EXECUTE_IF_SET_IN_BITMAP (partition->stmts, 0, i, bi)
+    {
+      gimple *stmt = RDG_STMT (rdg, i);
+
+      /* Scalar cycles other than induction variables are carried
+	 by the loop.  */
+      if (gimple_code (stmt) == GIMPLE_PHI
+	  && gimple_bb (stmt) == loop->header)
+	{
+	  tree res = gimple_phi_result (stmt);
+	  affine_iv iv;
+	  if (!virtual_operand_p (res)
+	      && !simple_iv (loop, loop, res, &iv, true))
+	    return true;
+	}
+
+      for (j = 0; RDG_DATAREFS (rdg, i).iterate (j, &dr1); ++j)
+	drs.safe_push (dr1);
+    }
+
+  for (i = 0; drs.iterate (i, &dr1); ++i)
+    for (j = i; drs.iterate (j, &dr2); ++j)
+      {
+	bool carried_p = false;
+
+	if (DR_IS_READ (dr1) && DR_IS_READ (dr2))
+	  continue;
+
+	ddr_p ddr = initialize_data_dependence_relation (dr1, dr2, loop_nest);
+	compute_affine_dependence (ddr, loop);
+	if (DDR_ARE_DEPENDENT (ddr) == chrec_dont_know)
+	  carried_p = true;
+	else if (DDR_ARE_DEPENDENT (ddr) == NULL_TREE)
+	  {
+	    if (DDR_NUM_DIST_VECTS (ddr) == 0)
+	      carried_p = true;
+	    for (unsigned k = 0; k < DDR_NUM_DIST_VECTS (ddr); ++k)
+	      if (DDR_DIST_VECT (ddr, k)[0] != 0)
+		carried_p = true;
+	  }
+	free_dependence_relation (ddr);
+	if (carried_p)
+	  return true;
+      }
+
+  return false;
+}
+
+/* Classifies PARTITION of RDG as sequential if it contains a reduction
+   or carries a dependence between the iterations of LOOP_NEST[0].  */
+
+static void
+classify_partition_type (struct graph *rdg, vec<loop_p> loop_nest,
+			 partition *partition)
+{
+  if (partition_builtin_p (partition)
+      || partition->type == PTYPE_SEQUENTIAL)
+    return;
+
+  if (partition_reduction_p (partition)
+      || partition_carries_dependence_p (rdg, loop_nest, partition))
+    partition->type = PTYPE_SEQUENTIAL;
+}
+
 /* Aggregate several components into a useful partition that is
    registered in the PARTITIONS vector.  Partitions will be
    distributed in different loops.  */
@@ -1490,6 +1618,10 @@ distribute_loop (struct loop *loop, vec<gimple *> stmts,
       goto ldist_done;
     }
 
+  if (flag_tree_loop_distribution)
+    FOR_EACH_VEC_ELT (partitions, i, partition)
+      classify_partition_type (rdg, loop_nest, partition);
+
   /* If we are only distributing patterns fuse all partitions that
      were not classified as builtins.  This also avoids chopping
      a loop into pieces, separated by builtin calls.  That is, we
@@ -1538,8 +1670,38 @@ distribute_loop (struct loop *loop, vec<gimple *> stmts,
 	i--;
       }
 
+  /* Fuse all sequential partitions.  Separating them enables neither
+     vectorization nor parallelization of the resulting loops but loses
+     the reuse of the data they share.  */
+  if (flag_tree_loop_distribution)
+    {
+      for (i = 0; partitions.iterate (i, &into); ++i)
+	if (!partition_builtin_p (into)
+	    && into->type == PTYPE_SEQUENTIAL)
+	  break;
+      for (i = i + 1; partitions.iterate (i, &partition); ++i)
+	if (!partition_builtin_p (partition)
+	    && partition->type == PTYPE_SEQUENTIAL)
+	  {
+	    if (dump_file && (dump_flags & TDF_DETAILS))
+	      {
+		fprintf (dump_file, "fusing partitions\n");
+		dump_bitmap (dump_file, into->stmts);
+		dump_bitmap (dump_file, partition->stmts);
+		fprintf (dump_file, "because they are sequential\n");
+	      }
+	    partition_merge_into (into, partition);
+	    partitions.unordered_remove (i);
+	    partition_free (partition);
+	    i--;
+	  }
+    }
+
   /* Apply our simple cost model - fuse partitions with similar
-     memory accesses.  */
+     memory accesses.  Keep a parallel partition apart from a sequential
+     one if they only share memory that is read, so the former can still
+     be vectorized or parallelized at the cost of loading that memory
+     again.  */
   for (i = 0; partitions.iterate (i, &into); ++i)
     {
       bool changed = false;
@@ -1549,7 +1711,9 @@ distribute_loop (struct loop *loop, vec<gimple *> stmts,
 	   partitions.iterate (j, &partition); ++j)
 	{
 	  if (!partition_builtin_p (partition)
-	      && similar_memory_accesses (rdg, into, partition))
+	      && similar_memory_accesses (rdg, into, partition)
+	      && (partition->type == into->type
+		  || share_written_memory_p (rdg, into, partition)))
 	    {
 	      if (dump_file && (dump_flags & TDF_DETAILS))
 		{
@@ -1691,6 +1855,19 @@ distribute_loop (struct loop *loop, vec<gimple *> stmts,
       goto ldist_done;
     }
 
+  /* Fusing parallel partitions may have introduced dependences between
+     iterations, so verify the type of the loops we are going to
+     generate.  */
+  FOR_EACH_VEC_ELT (partitions, i, partition)
+    {
+      classify_partition_type (rdg, loop_nest, partition);
+      if (dump_file && (dump_flags & TDF_DETAILS)
+	  && !partition_builtin_p (partition))
+	fprintf (dump_file, "partition %d is %s\n", i,
+		 partition->type == PTYPE_PARALLEL
+		 ? "parallel" : "sequential");
+    }
+
   if (dump_file && (dump_flags & TDF_DETAILS))
     dump_rdg_partitions (dump_file, partitions);
 
@@ -366,9 +366,10 @@ lambda_transform_legal_p (lambda_trans_matrix trans,
   if (ddr == NULL)
     return true;
 
-  /* When there is an unknown relation in the dependence_relations, we
-     know that it is no worth looking at this loop nest: give up.  */
-  if (DDR_ARE_DEPENDENT (ddr) == chrec_dont_know)
+  /* When the dependence analysis gave up on the loop nest, there is a
+     single unknown relation between no data references.  */
+  if (DDR_ARE_DEPENDENT (ddr) == chrec_dont_know
+      && DDR_A (ddr) == NULL)
     return false;
 
   distres = lambda_vector_new (nb_loops);
@@ -2026,7 +2027,7 @@ transform_to_exit_first_loop (struct loop *loop,
 static void
 create_parallel_loop (struct loop *loop, tree loop_fn, tree data,
 		      tree new_data, unsigned n_threads, location_t loc,
-		      bool oacc_kernels_p)
+		      bool oacc_kernels_p, bool unbalanced_p)
 {
   gimple_stmt_iterator gsi;
   basic_block for_bb, ex_bb, continue_bb;
@@ -2159,6 +2160,11 @@ create_parallel_loop (struct loop *loop, tree loop_fn, tree data,
       int chunk_size = PARAM_VALUE (PARAM_PARLOOPS_CHUNK_SIZE);
       enum PARAM_PARLOOPS_SCHEDULE_KIND schedule_type \
 	= (enum PARAM_PARLOOPS_SCHEDULE_KIND) PARAM_VALUE (PARAM_PARLOOPS_SCHEDULE);
+      /* Unless the user asked for a particular schedule, hand out the
+	 iterations of an unbalanced loop dynamically.  */
+      if (unbalanced_p
+	  && !global_options_set.x_param_values[PARAM_PARLOOPS_SCHEDULE])
+	schedule_type = PARAM_PARLOOPS_SCHEDULE_KIND_dynamic;
       switch (schedule_type)
 	{
 	case PARAM_PARLOOPS_SCHEDULE_KIND_static:
@@ -2231,13 +2237,14 @@ create_parallel_loop (struct loop *loop, tree loop_fn, tree data,
    later.
 
    NITER describes number of iterations of LOOP.
-   REDUCTION_LIST describes the reductions existent in the LOOP.  */
+   REDUCTION_LIST describes the reductions existent in the LOOP.
+   UNBALANCED_P is true if the iterations of LOOP differ in cost.  */
 
 static void
 gen_parallel_loop (struct loop *loop,
 		   reduction_info_table_type *reduction_list,
 		   unsigned n_threads, struct tree_niter_desc *niter,
-		   bool oacc_kernels_p)
+		   bool oacc_kernels_p, bool unbalanced_p)
 {
   tree many_iterations_cond, type, nit;
   tree arg_struct, new_arg_struct;
@@ -2422,7 +2429,7 @@ gen_parallel_loop (struct loop *loop,
   if (cond_stmt)
     loc = gimple_location (cond_stmt);
   create_parallel_loop (loop, create_loop_fn (loc), arg_struct, new_arg_struct,
-			n_threads, loc, oacc_kernels_p);
+			n_threads, loc, oacc_kernels_p, unbalanced_p);
   if (reduction_list->elements () > 0)
     create_call_for_reduction (loop, reduction_list, &clsn_data);
 
@@ -2519,7 +2526,9 @@ gather_scalar_reductions (loop_p loop, reduction_info_table_type *reduction_list
   if (!stmt_vec_info_vec.exists ())
     init_stmt_vec_info_vec ();
 
-  simple_loop_info = vect_analyze_loop_form (loop);
+  /* The iterations of an inner loop are executed by a single thread, so
+     their number may vary between the iterations of LOOP.  */
+  simple_loop_info = vect_analyze_loop_form (loop, false);
   if (simple_loop_info == NULL)
     goto gather_done;
 
@@ -2550,7 +2559,8 @@ gather_scalar_reductions (loop_p loop, reduction_info_table_type *reduction_list
 
 	  if (!simple_inner_loop_info)
 	    {
-	      simple_inner_loop_info = vect_analyze_loop_form (loop->inner);
+	      simple_inner_loop_info = vect_analyze_loop_form (loop->inner,
+								  false);
 	      if (!simple_inner_loop_info)
 		{
 		  allow_double_reduc = false;
@@ -2803,6 +2813,45 @@ try_create_reduction_list (loop_p loop,
   return true;
 }
 
+/* Returns true if the cost of an iteration of OUTER is likely to vary
+   because of LOOP, a loop nested in it: the number of iterations of LOOP or
+   of a loop nested in it is unknown or varies with OUTER, or LOOP is executed
+   only in some iterations of OUTER.  */
+
+static bool
+inner_loop_unbalanced_p (struct loop *outer, struct loop *loop)
+{
+  tree niter = number_of_latch_executions (loop);
+  struct loop *inner;
+
+  if (chrec_contains_undetermined (niter)
+      || !expr_invariant_in_loop_p (outer, niter)
+      || !dominated_by_p (CDI_DOMINATORS, loop_outer (loop)->latch,
+			  loop->header))
+    return true;
+
+  for (inner = loop->inner; inner; inner = inner->next)
+    if (inner_loop_unbalanced_p (outer, inner))
+      return true;
+
+  return false;
+}
+
+/* Returns true if the iterations of LOOP are likely to differ in cost, so
+   that a static distribution of them would leave threads idle.  */
+
+static bool
+loop_iterations_unbalanced_p (struct loop *loop)
+{
+  struct loop *inner;
+
+  for (inner = loop->inner; inner; inner = inner->next)
+    if (inner_loop_unbalanced_p (loop, inner))
+      return true;
+
+  return false;
+}
+
 /* Return true if LOOP contains phis with ADDR_EXPR in args.  */
 
 static bool
@@ -3192,6 +3241,7 @@ parallelize_loops (bool oacc_kernels_p)
   struct obstack parloop_obstack;
   HOST_WIDE_INT estimated;
   source_location loop_loc;
+  bool unbalanced_p;
 
   /* Do not parallelize loops in the functions created by parallelization.  */
   if (!oacc_kernels_p
@@ -3308,7 +3358,10 @@ parallelize_loops (bool oacc_kernels_p)
       if (loop_has_phi_with_address_arg (loop))
 	continue;
 
+      /* Loops generated by loop distribution for parallel partitions
+	 are known to carry no dependences.  */
       if (!flag_loop_parallelize_all
+	  && !loop->can_be_parallel
 	  && !loop_parallel_p (loop, &parloop_obstack))
 	continue;
 
@@ -3322,12 +3375,16 @@ parallelize_loops (bool oacc_kernels_p)
 
       changed = true;
       skip_loop = loop->inner;
+      unbalanced_p = !oacc_kernels_p && loop_iterations_unbalanced_p (loop);
       if (dump_file && (dump_flags & TDF_DETAILS))
       {
 	if (loop->inner)
 	  fprintf (dump_file, "parallelizing outer loop %d\n",loop->header->index);
 	else
 	  fprintf (dump_file, "parallelizing inner loop %d\n",loop->header->index);
+	if (unbalanced_p)
+	  fprintf (dump_file, "loop %d has unbalanced iterations\n",
+		   loop->num);
 	loop_loc = find_loop_location (loop);
 	if (loop_loc != UNKNOWN_LOCATION)
 	  fprintf (dump_file, "\nloop at %s:%d: ",
@@ -3335,7 +3392,7 @@ parallelize_loops (bool oacc_kernels_p)
       }
 
       gen_parallel_loop (loop, &reduction_list,
-			 n_threads, &niter_desc, oacc_kernels_p);
+			 n_threads, &niter_desc, oacc_kernels_p, unbalanced_p);
     }
 
   obstack_free (&parloop_obstack, NULL);
@@ -65,6 +65,15 @@ static GTY(()) tree ic_void_ptr_var;
 static GTY(()) tree ic_gcov_type_ptr_var;
 static GTY(()) tree ptr_void;
 
+/* Byte offset of the edge counters updated by the current function from
+   the counter variables, for the thread shard and the memory-mapped
+   counter file, or NULL_TREE if it updates the counter variables.  */
+static tree edge_counter_offset;
+
+/* Increment of the edge counters of the current function, or NULL_TREE if
+   not computed yet.  */
+static tree edge_counter_increment;
+
 /* Do initialization work for the edge profiler.  */
 
 /* Add code:
@@ -243,6 +252,182 @@ gimple_init_gcov_profiler (void)
     }
 }
 
+/* Emit on the entry edge of the current function the computation of the
+   thread shard of its edge counters, of their location and of their
+   increment, unless done already.
+
+   Threads have disjoint stacks, so the shard is a hash of the address of
+   a local variable.  A thread may use several shards, as they are summed
+   by libgcov anyway; what matters is that concurrent threads seldom use
+   the same one.
+
+   When sampling, a per-shard counter of the entries of the function makes
+   one entry out of the sampling period update the edge counters, by the
+   period so that the counts keep their scale.  The first entries are all
+   counted, so that functions entered a few times, e.g. main, get exact
+   counts.  Each entry is counted as a whole, which keeps the counts of a
+   function flow consistent.
+
+   With -fprofile-continuous, the edge counters are updated in the counter
+   file that libgcov maps when the program starts, at the offset from the
+   counter variables it stores in the bias variable of the object.  */
+
+static void
+gimple_init_edge_counters (void)
+{
+  if (edge_counter_increment)
+    return;
+
+  edge e = single_succ_edge (ENTRY_BLOCK_PTR_FOR_FN (cfun));
+  unsigned shards = coverage_counter_shards ();
+  unsigned period = PARAM_VALUE (PARAM_PROFILE_SAMPLING_PERIOD);
+  tree shard = size_zero_node;
+
+  if (shards > 1)
+    {
+      tree uintptr_type = build_nonstandard_integer_type (POINTER_SIZE, 1);
+      tree anchor = create_tmp_var (char_type_node, "PROF_shard_anchor");
+      TREE_ADDRESSABLE (anchor) = 1;
+
+      tree addr = make_temp_ssa_name (uintptr_type, NULL, "PROF_shard");
+      gassign *stmt1 = gimple_build_assign (addr, NOP_EXPR,
+					    build_fold_addr_expr (anchor));
+      tree hash = make_temp_ssa_name (uintptr_type, NULL, "PROF_shard");
+      gassign *stmt2 = gimple_build_assign (hash, RSHIFT_EXPR, addr,
+					    build_int_cst (uintptr_type, 16));
+      tree hash2 = make_temp_ssa_name (uintptr_type, NULL, "PROF_shard");
+      gassign *stmt3
+	= gimple_build_assign (hash2, MULT_EXPR, hash,
+			       build_int_cstu (uintptr_type,
+					       HOST_WIDE_INT_UC
+					       (0x9e3779b97f4a7c15)));
+      tree hash3 = make_temp_ssa_name (uintptr_type, NULL, "PROF_shard");
+      gassign *stmt4
+	= gimple_build_assign (hash3, RSHIFT_EXPR, hash2,
+			       build_int_cst (uintptr_type,
+					      POINTER_SIZE
+					      - exact_log2 (shards)));
+      shard = make_temp_ssa_name (sizetype, NULL, "PROF_shard");
+      gassign *stmt5 = gimple_build_assign (shard, NOP_EXPR, hash3);
+      edge_counter_offset
+	= make_temp_ssa_name (sizetype, NULL, "PROF_shard_offset");
+      unsigned HOST_WIDE_INT stride
+	= (coverage_counter_shard_stride (GCOV_COUNTER_ARCS)
+	   * tree_to_uhwi (TYPE_SIZE_UNIT (gcov_type_node)));
+      gassign *stmt6
+	= gimple_build_assign (edge_counter_offset, MULT_EXPR, shard,
+			       size_int (stride));
+      gsi_insert_on_edge (e, stmt1);
+      gsi_insert_on_edge (e, stmt2);
+      gsi_insert_on_edge (e, stmt3);
+      gsi_insert_on_edge (e, stmt4);
+      gsi_insert_on_edge (e, stmt5);
+      gsi_insert_on_edge (e, stmt6);
+    }
+
+  if (flag_profile_continuous)
+    {
+      tree bias = make_temp_ssa_name (sizetype, NULL, "PROF_bias");
+      gsi_insert_on_edge (e, gimple_build_assign (bias,
+						  coverage_counter_bias ()));
+      if (edge_counter_offset)
+	{
+	  tree offset = make_temp_ssa_name (sizetype, NULL,
+					    "PROF_edge_counter_offset");
+	  gsi_insert_on_edge (e, gimple_build_assign (offset, PLUS_EXPR,
+						      edge_counter_offset,
+						      bias));
+	  edge_counter_offset = offset;
+	}
+      else
+	edge_counter_offset = bias;
+    }
+
+  if (period <= 1)
+    {
+      edge_counter_increment = build_int_cst (gcov_type_node, 1);
+      return;
+    }
+
+  /* The entry counters of the function, one per shard, 64 bytes apart.  */
+  unsigned spacing = 64 / tree_to_uhwi (TYPE_SIZE_UNIT (gcov_type_node));
+  const char *fn_name
+    = targetm.strip_name_encoding (IDENTIFIER_POINTER
+				   (DECL_ASSEMBLER_NAME
+				    (current_function_decl)));
+  char *name = concat ("__gcov_sampling.", fn_name, NULL);
+  tree array_type
+    = build_array_type (gcov_type_node,
+			build_index_type (size_int (shards * spacing - 1)));
+  tree counters = build_decl (BUILTINS_LOCATION, VAR_DECL,
+			      get_identifier (name), array_type);
+  free (name);
+  TREE_STATIC (counters) = 1;
+  TREE_ADDRESSABLE (counters) = 1;
+  DECL_ARTIFICIAL (counters) = 1;
+  DECL_IGNORED_P (counters) = 1;
+  DECL_NONALIASED (counters) = 1;
+  SET_DECL_ALIGN (counters, MAX (TYPE_ALIGN (array_type),
+				 MIN (64 * BITS_PER_UNIT,
+				      MAX_OFILE_ALIGNMENT)));
+  DECL_USER_ALIGN (counters) = 1;
+  varpool_node::finalize_decl (counters);
+
+  tree index = shard;
+  if (shards > 1)
+    {
+      index = make_temp_ssa_name (sizetype, NULL, "PROF_sampling_index");
+      gsi_insert_on_edge (e, gimple_build_assign (index, MULT_EXPR, shard,
+						  size_int (spacing)));
+    }
+  tree ref = build4 (ARRAY_REF, gcov_type_node, counters, index, NULL_TREE,
+		     NULL_TREE);
+
+  /* entries = counter; counter = entries + 1;
+     exact = entries < period;
+     sampled = !exact & ((entries & (period - 1)) == 0);
+     increment = exact + (sampled << log2 (period));  */
+  period = 1u << floor_log2 (period);
+  auto_vec<gassign *, 16> stmts;
+  tree entries = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (entries, ref));
+  tree entries2 = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (entries2, PLUS_EXPR, entries,
+					 build_int_cst (gcov_type_node, 1)));
+  stmts.quick_push (gimple_build_assign (unshare_expr (ref), entries2));
+  tree exact_p = make_temp_ssa_name (boolean_type_node, NULL,
+				     "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (exact_p, LT_EXPR, entries,
+					 build_int_cst (gcov_type_node,
+							period)));
+  tree exact = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (exact, NOP_EXPR, exact_p));
+  tree phase = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (phase, BIT_AND_EXPR, entries,
+					 build_int_cst (gcov_type_node,
+							period - 1)));
+  tree phase_p = make_temp_ssa_name (boolean_type_node, NULL,
+				     "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (phase_p, EQ_EXPR, phase,
+					 build_int_cst (gcov_type_node, 0)));
+  tree sampled_p = make_temp_ssa_name (boolean_type_node, NULL,
+				       "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (sampled_p, GT_EXPR, phase_p,
+					 exact_p));
+  tree sampled = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (sampled, NOP_EXPR, sampled_p));
+  tree scaled = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (scaled, LSHIFT_EXPR, sampled,
+					 build_int_cst (integer_type_node,
+							exact_log2 (period))));
+  edge_counter_increment
+    = make_temp_ssa_name (gcov_type_node, NULL, "PROF_sampling");
+  stmts.quick_push (gimple_build_assign (edge_counter_increment, PLUS_EXPR,
+					 exact, scaled));
+  for (unsigned i = 0; i < stmts.length (); i++)
+    gsi_insert_on_edge (e, stmts[i]);
+}
+
 /* Output instructions as GIMPLE trees to increment the edge
    execution count, and insert them on E.  We rely on
    gsi_insert_on_edge to preserve the order.  */
@@ -252,12 +437,22 @@ gimple_gen_edge_profiler (int edgeno, edge e)
 {
   tree one;
 
-  one = build_int_cst (gcov_type_node, 1);
+  gimple_init_edge_counters ();
+  one = edge_counter_increment;
 
   if (flag_profile_update == PROFILE_UPDATE_ATOMIC)
     {
       /* __atomic_fetch_add (&counter, 1, MEMMODEL_RELAXED); */
       tree addr = tree_coverage_counter_addr (GCOV_COUNTER_ARCS, edgeno);
+      if (edge_counter_offset)
+	{
+	  tree addr2 = make_temp_ssa_name (TREE_TYPE (addr), NULL,
+					   "PROF_edge_counter_addr");
+	  gsi_insert_on_edge (e, gimple_build_assign (addr2, POINTER_PLUS_EXPR,
+						      addr,
+						      edge_counter_offset));
+	  addr = addr2;
+	}
       tree f = builtin_decl_explicit (LONG_LONG_TYPE_SIZE > 32
 				      ? BUILT_IN_ATOMIC_FETCH_ADD_8:
 				      BUILT_IN_ATOMIC_FETCH_ADD_4);
@@ -269,6 +464,20 @@ gimple_gen_edge_profiler (int edgeno, edge e)
   else
     {
       tree ref = tree_coverage_counter_ref (GCOV_COUNTER_ARCS, edgeno);
+      if (edge_counter_offset)
+	{
+	  /* Update the counter in the shard of the thread, in the counter
+	     file.  */
+	  tree addr = make_temp_ssa_name (build_pointer_type (gcov_type_node),
+					  NULL, "PROF_edge_counter_addr");
+	  gassign *stmt
+	    = gimple_build_assign (addr, POINTER_PLUS_EXPR,
+				   build_fold_addr_expr (ref),
+				   edge_counter_offset);
+	  gsi_insert_on_edge (e, stmt);
+	  ref = build2 (MEM_REF, gcov_type_node, addr,
+			build_int_cst (TREE_TYPE (addr), 0));
+	}
       tree gcov_type_tmp_var = make_temp_ssa_name (gcov_type_node,
 						   NULL, "PROF_edge_counter");
       gassign *stmt1 = gimple_build_assign (gcov_type_tmp_var, ref);
@@ -644,6 +853,8 @@ tree_profiling (void)
       if (execute_fixup_cfg () & TODO_cleanup_cfg)
 	cleanup_tree_cfg ();
 
+      edge_counter_offset = NULL_TREE;
+      edge_counter_increment = NULL_TREE;
       branch_prob ();
 
       if (! flag_branch_probabilities
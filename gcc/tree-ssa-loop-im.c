@@ -106,6 +106,15 @@ struct mem_ref_loc
 };
 
 
+/* The expanded affine form of the address of a memory reference,
+   together with the size of the access.  */
+
+struct im_mem_ref_aff
+{
+  aff_tree off;
+  widest_int size;
+};
+
 /* Description of a memory reference.  */
 
 struct im_mem_ref
@@ -135,6 +144,14 @@ struct im_mem_ref
 				   If it is only loaded, then it is independent
 				     on all stores in the loop.  */
   bitmap_head dep_loop;		/* The complement of INDEP_LOOP.  */
+
+  /* The results of pairwise dependence queries against references with
+     a larger id, computed on demand.  */
+  bitmap_head indep_ref;
+  bitmap_head dep_ref;
+
+  im_mem_ref_aff *aff;		/* The expanded address, computed on
+				   demand.  */
 };
 
 /* We use two bits per loop in the ref->{in,}dep_loop bitmaps, the first
@@ -1396,6 +1413,9 @@ mem_ref_alloc (tree mem, unsigned hash, unsigned id)
   ref->stored = NULL;
   bitmap_initialize (&ref->indep_loop, &lim_bitmap_obstack);
   bitmap_initialize (&ref->dep_loop, &lim_bitmap_obstack);
+  bitmap_initialize (&ref->indep_ref, &lim_bitmap_obstack);
+  bitmap_initialize (&ref->dep_ref, &lim_bitmap_obstack);
+  ref->aff = NULL;
   ref->accesses_in_loop.create (1);
 
   return ref;
@@ -1587,6 +1607,22 @@ analyze_memory_references (void)
     }
 }
 
+/* Returns the expanded affine address of MEM, computing it the first time
+   it is asked for.  TTAE_CACHE is used as a cache in
+   tree_to_aff_combination_expand.  */
+
+static im_mem_ref_aff *
+mem_ref_aff (im_mem_ref *mem, hash_map<tree, name_expansion *> **ttae_cache)
+{
+  if (!mem->aff)
+    {
+      mem->aff = XOBNEW (&mem_ref_obstack, struct im_mem_ref_aff);
+      get_inner_reference_aff (mem->mem.ref, &mem->aff->off, &mem->aff->size);
+      aff_combination_expand (&mem->aff->off, ttae_cache);
+    }
+  return mem->aff;
+}
+
 /* Returns true if MEM1 and MEM2 may alias.  TTAE_CACHE is used as a cache in
    tree_to_aff_combination_expand.  */
 
@@ -1597,7 +1633,6 @@ mem_refs_may_alias_p (im_mem_ref *mem1, im_mem_ref *mem2,
   /* Perform BASE + OFFSET analysis -- if MEM1 and MEM2 are based on the same
      object and their offset differ in such a way that the locations cannot
      overlap, then they cannot alias.  */
-  widest_int size1, size2;
   aff_tree off1, off2;
 
   /* Perform basic offset and type-based disambiguation.  */
@@ -1605,18 +1640,19 @@ mem_refs_may_alias_p (im_mem_ref *mem1, im_mem_ref *mem2,
     return false;
 
   /* The expansion of addresses may be a bit expensive, thus we only do
-     the check at -O2 and higher optimization levels.  */
+     the check at -O2 and higher optimization levels.  Each address is
+     expanded only once, however many references it is compared with.  */
   if (optimize < 2)
     return true;
 
-  get_inner_reference_aff (mem1->mem.ref, &off1, &size1);
-  get_inner_reference_aff (mem2->mem.ref, &off2, &size2);
-  aff_combination_expand (&off1, ttae_cache);
-  aff_combination_expand (&off2, ttae_cache);
+  im_mem_ref_aff *aff1 = mem_ref_aff (mem1, ttae_cache);
+  im_mem_ref_aff *aff2 = mem_ref_aff (mem2, ttae_cache);
+  off1 = aff1->off;
+  off2 = aff2->off;
   aff_combination_scale (&off1, -1);
   aff_combination_add (&off2, &off1);
 
-  if (aff_comb_cannot_overlap_p (&off2, size1, size2))
+  if (aff_comb_cannot_overlap_p (&off2, aff1->size, aff2->size))
     return false;
 
   return true;
@@ -2079,6 +2115,16 @@ refs_independent_p (im_mem_ref *ref1, im_mem_ref *ref2)
   if (ref1 == ref2)
     return true;
 
+  /* The same pair is queried again for each loop of the nest that
+     contains both references, so cache the answer in the reference
+     with the smaller id.  */
+  if (ref1->id > ref2->id)
+    std::swap (ref1, ref2);
+  if (bitmap_bit_p (&ref1->indep_ref, ref2->id))
+    return true;
+  if (bitmap_bit_p (&ref1->dep_ref, ref2->id))
+    return false;
+
   if (dump_file && (dump_flags & TDF_DETAILS))
     fprintf (dump_file, "Querying dependency of refs %u and %u: ",
 	     ref1->id, ref2->id);
@@ -2087,12 +2133,14 @@ refs_independent_p (im_mem_ref *ref1, im_mem_ref *ref2)
     {
       if (dump_file && (dump_flags & TDF_DETAILS))
 	fprintf (dump_file, "dependent.\n");
+      bitmap_set_bit (&ref1->dep_ref, ref2->id);
       return false;
     }
   else
     {
       if (dump_file && (dump_flags & TDF_DETAILS))
 	fprintf (dump_file, "independent.\n");
+      bitmap_set_bit (&ref1->indep_ref, ref2->id);
       return true;
     }
 }
@@ -590,6 +590,31 @@ gather_memory_references_ref (struct loop *loop, struct mem_ref_group **refs,
   return true;
 }
 
+/* Returns true if the execution counts of the blocks of LOOP were read from
+   profile feedback, so that they can be trusted to decide which references
+   are worth prefetching and how far ahead.  */
+
+static bool
+loop_has_profile_feedback_p (struct loop *loop)
+{
+  return (profile_status_for_fn (cfun) == PROFILE_READ
+	  && loop->header->count > 0);
+}
+
+/* Returns true if profile feedback shows that BB is executed so rarely
+   relative to the header of LOOP that prefetching the references in it
+   does not pay off.  */
+
+static bool
+rarely_executed_in_loop_p (struct loop *loop, basic_block bb)
+{
+  if (!loop_has_profile_feedback_p (loop))
+    return false;
+
+  return (bb->count * 100
+	  < loop->header->count * PREFETCH_MIN_REF_FREQUENCY);
+}
+
 /* Record the suitable memory references in LOOP.  NO_OTHER_REFS is set to
    true if there are no other memory references inside the loop.  */
 
@@ -603,6 +628,7 @@ gather_memory_references (struct loop *loop, bool *no_other_refs, unsigned *ref_
   gimple *stmt;
   tree lhs, rhs;
   struct mem_ref_group *refs = NULL;
+  bool rare;
 
   *no_other_refs = true;
   *ref_count = 0;
@@ -615,6 +641,13 @@ gather_memory_references (struct loop *loop, bool *no_other_refs, unsigned *ref_
       if (bb->loop_father != loop)
 	continue;
 
+      /* The references on paths that profile feedback shows to be rarely
+	 taken are not prefetched; they still count as other references.  */
+      rare = rarely_executed_in_loop_p (loop, bb);
+      if (rare && dump_file && (dump_flags & TDF_DETAILS))
+	fprintf (dump_file, "Ignoring references in rarely executed bb %d\n",
+		 bb->index);
+
       for (bsi = gsi_start_bb (bb); !gsi_end_p (bsi); gsi_next (&bsi))
 	{
 	  stmt = gsi_stmt (bsi);
@@ -636,14 +669,18 @@ gather_memory_references (struct loop *loop, bool *no_other_refs, unsigned *ref_
 
 	  if (REFERENCE_CLASS_P (rhs))
 	    {
-	    *no_other_refs &= gather_memory_references_ref (loop, &refs,
-							    rhs, false, stmt);
+	    *no_other_refs &= (!rare
+			       && gather_memory_references_ref (loop, &refs,
+								rhs, false,
+								stmt));
 	    *ref_count += 1;
 	    }
 	  if (REFERENCE_CLASS_P (lhs))
 	    {
-	    *no_other_refs &= gather_memory_references_ref (loop, &refs,
-							    lhs, true, stmt);
+	    *no_other_refs &= (!rare
+			       && gather_memory_references_ref (loop, &refs,
+								lhs, true,
+								stmt));
 	    *ref_count += 1;
 	    }
 	}
@@ -1827,6 +1864,35 @@ insn_to_prefetch_ratio_too_small_p (unsigned ninsns, unsigned prefetch_count,
 }
 
 
+/* Returns the estimated time of one iteration of LOOP.  With profile
+   feedback the time of each block is weighted by its execution count
+   relative to the loop header, so that rarely executed paths do not
+   shorten the prefetch distance.  */
+
+static unsigned
+loop_iteration_time (struct loop *loop)
+{
+  basic_block *body;
+  gimple_stmt_iterator gsi;
+  gcov_type time = 0;
+  unsigned bb_time, i;
+
+  if (!loop_has_profile_feedback_p (loop))
+    return tree_num_loop_insns (loop, &eni_time_weights);
+
+  body = get_loop_body (loop);
+  for (i = 0; i < loop->num_nodes; i++)
+    {
+      bb_time = 0;
+      for (gsi = gsi_start_bb (body[i]); !gsi_end_p (gsi); gsi_next (&gsi))
+	bb_time += estimate_num_insns (gsi_stmt (gsi), &eni_time_weights);
+      time += RDIV (bb_time * body[i]->count, loop->header->count);
+    }
+  free (body);
+
+  return MIN (time, INT_MAX);
+}
+
 /* Issue prefetch instructions for array references in LOOP.  Returns
    true if the LOOP was unrolled.  */
 
@@ -1848,9 +1914,7 @@ loop_prefetch_arrays (struct loop *loop)
       return false;
     }
 
-  /* FIXME: the time should be weighted by the probabilities of the blocks in
-     the loop body.  */
-  time = tree_num_loop_insns (loop, &eni_time_weights);
+  time = loop_iteration_time (loop);
   if (time == 0)
     return false;
 
@@ -1859,6 +1923,19 @@ loop_prefetch_arrays (struct loop *loop)
   if (est_niter == -1)
     est_niter = likely_max_stmt_executions_int (loop);
 
+  /* A trip count measured by profile feedback is reliable enough to shorten
+     the prefetch distance of a loop that rolls too few times to cover the
+     whole latency, instead of giving up on it.  */
+  if (loop_has_profile_feedback_p (loop)
+      && est_niter >= TRIP_COUNT_TO_AHEAD_RATIO
+      && est_niter < (HOST_WIDE_INT) (TRIP_COUNT_TO_AHEAD_RATIO * ahead))
+    {
+      ahead = est_niter / TRIP_COUNT_TO_AHEAD_RATIO;
+      if (dump_file && (dump_flags & TDF_DETAILS))
+	fprintf (dump_file, "Reducing ahead to %d for measured trip count "
+		 HOST_WIDE_INT_PRINT_DEC "\n", ahead, est_niter);
+    }
+
   /* Prefetching is not likely to be profitable if the trip count to ahead
      ratio is too small.  */
   if (trip_count_to_ahead_ratio_too_small_p (ahead, est_niter))
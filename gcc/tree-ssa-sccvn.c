@@ -4984,3 +4984,520 @@ vn_nary_may_trap (vn_nary_op_t nary)
 
   return false;
 }
+
+
+/* Region-based value numbering.
+
+   run_scc_vn numbers the whole function and iterates over the SCCs of
+   the SSA graph, which is too expensive to redo after a transform that
+   exposes redundancies in a small part of the function only, such as
+   complete unrolling.  do_rpo_vn instead numbers a single-entry region
+   in one walk over its blocks in reverse postorder.  Values flowing
+   over the backedges of the region are not known when the loop header
+   is visited, so PHI nodes merging them are their own value; nothing
+   is iterated.  Conditions that fold to a constant make the edge they
+   do not take non-executable, so that PHI arguments and blocks reached
+   only over it are ignored.
+
+   Uses are replaced by their value during the walk, and definitions
+   that become dead in the region are removed afterwards.  */
+
+/* An expression computed in the region, and a name or constant that
+   holds its value.  Entries for the same expression are chained, most
+   recent first, as not all of them are available everywhere.  */
+
+struct rpo_vn_expr
+{
+  hashval_t hashcode;
+  enum tree_code code;
+  unsigned length;
+  tree type;
+  tree vuse;
+  tree ops[3];
+  tree leader;
+  struct rpo_vn_expr *next;
+};
+
+struct rpo_vn_expr_hasher : nofree_ptr_hash <rpo_vn_expr>
+{
+  static inline hashval_t hash (const rpo_vn_expr *);
+  static inline bool equal (const rpo_vn_expr *, const rpo_vn_expr *);
+};
+
+inline hashval_t
+rpo_vn_expr_hasher::hash (const rpo_vn_expr *e)
+{
+  return e->hashcode;
+}
+
+inline bool
+rpo_vn_expr_hasher::equal (const rpo_vn_expr *e1, const rpo_vn_expr *e2)
+{
+  if (e1->code != e2->code
+      || e1->length != e2->length
+      || e1->vuse != e2->vuse
+      || !types_compatible_p (e1->type, e2->type))
+    return false;
+  for (unsigned i = 0; i < e1->length; ++i)
+    if (!operand_equal_p (e1->ops[i], e2->ops[i], 0))
+      return false;
+  return true;
+}
+
+/* The value of each SSA name visited, or NULL if it is its own.  */
+static vec<tree> rpo_vn_values;
+
+/* The expressions computed in the region.  */
+static hash_table<rpo_vn_expr_hasher> *rpo_vn_exprs;
+static struct obstack rpo_vn_obstack;
+
+/* Valueization hook for the region-based value numbering.  */
+
+static tree
+rpo_vn_valueize (tree name)
+{
+  if (TREE_CODE (name) == SSA_NAME
+      && SSA_NAME_VERSION (name) < rpo_vn_values.length ()
+      && rpo_vn_values[SSA_NAME_VERSION (name)])
+    return rpo_vn_values[SSA_NAME_VERSION (name)];
+  return name;
+}
+
+/* Return true if VAL may be used in place of a name defined in BB.  */
+
+static bool
+rpo_vn_available_p (tree val, basic_block bb)
+{
+  if (TREE_CODE (val) != SSA_NAME
+      || SSA_NAME_IS_DEFAULT_DEF (val))
+    return true;
+  basic_block def_bb = gimple_bb (SSA_NAME_DEF_STMT (val));
+  if (!def_bb
+      || !dominated_by_p (CDI_DOMINATORS, bb, def_bb))
+    return false;
+  /* In loop-closed SSA form names may not be used outside of the loop
+     they are defined in but through PHI nodes on its exits.  */
+  if (current_loops && loops_state_satisfies_p (LOOP_CLOSED_SSA))
+    return (def_bb->loop_father == bb->loop_father
+	    || flow_loop_nested_p (def_bb->loop_father, bb->loop_father));
+  return true;
+}
+
+/* Record VAL as the value of NAME.  */
+
+static void
+rpo_vn_set_value (tree name, tree val)
+{
+  if (SSA_NAME_VERSION (name) >= rpo_vn_values.length ())
+    rpo_vn_values.safe_grow_cleared (num_ssa_names);
+  rpo_vn_values[SSA_NAME_VERSION (name)] = val;
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    {
+      fprintf (dump_file, "Value numbering ");
+      print_generic_expr (dump_file, name, 0);
+      fprintf (dump_file, " to ");
+      print_generic_expr (dump_file, val, 0);
+      fprintf (dump_file, "\n");
+    }
+}
+
+/* Compute the hash code of E.  */
+
+static void
+rpo_vn_hash_expr (rpo_vn_expr *e)
+{
+  inchash::hash hstate;
+  hstate.add_int (e->code);
+  for (unsigned i = 0; i < e->length; ++i)
+    inchash::add_expr (e->ops[i], hstate);
+  if (e->vuse)
+    hstate.add_int (SSA_NAME_VERSION (e->vuse));
+  e->hashcode = hstate.end ();
+}
+
+/* Fill in E with the expression computed by the assignment STMT.
+   Return false if it is not one we number.  */
+
+static bool
+rpo_vn_init_expr (rpo_vn_expr *e, gassign *stmt)
+{
+  enum tree_code code = gimple_assign_rhs_code (stmt);
+  tree rhs1 = gimple_assign_rhs1 (stmt);
+
+  e->type = TREE_TYPE (gimple_assign_lhs (stmt));
+  e->vuse = NULL_TREE;
+  switch (get_gimple_rhs_class (code))
+    {
+    case GIMPLE_UNARY_RHS:
+    case GIMPLE_BINARY_RHS:
+    case GIMPLE_TERNARY_RHS:
+      e->code = code;
+      e->length = gimple_num_ops (stmt) - 1;
+      for (unsigned i = 0; i < e->length; ++i)
+	e->ops[i] = rpo_vn_valueize (gimple_op (stmt, i + 1));
+      if (commutative_tree_code (code)
+	  && tree_swap_operands_p (e->ops[0], e->ops[1]))
+	std::swap (e->ops[0], e->ops[1]);
+      break;
+
+    case GIMPLE_SINGLE_RHS:
+      if (TREE_CODE (rhs1) == SSA_NAME
+	  || is_gimple_min_invariant (rhs1))
+	return false;
+      e->code = TREE_CODE (rhs1);
+      e->length = 1;
+      e->ops[0] = rhs1;
+      e->vuse = gimple_vuse (stmt);
+      break;
+
+    default:
+      return false;
+    }
+  rpo_vn_hash_expr (e);
+  return true;
+}
+
+/* Return a value of E available in BB, or NULL_TREE.  */
+
+static tree
+rpo_vn_lookup (rpo_vn_expr *e, basic_block bb)
+{
+  rpo_vn_expr **slot
+    = rpo_vn_exprs->find_slot_with_hash (e, e->hashcode, NO_INSERT);
+  if (!slot)
+    return NULL_TREE;
+  for (rpo_vn_expr *l = *slot; l; l = l->next)
+    if (rpo_vn_available_p (l->leader, bb))
+      return l->leader;
+  return NULL_TREE;
+}
+
+/* Record LEADER as a value of E.  */
+
+static void
+rpo_vn_insert (rpo_vn_expr *e, tree leader)
+{
+  rpo_vn_expr *n = XOBNEW (&rpo_vn_obstack, rpo_vn_expr);
+  *n = *e;
+  n->leader = leader;
+  rpo_vn_expr **slot
+    = rpo_vn_exprs->find_slot_with_hash (n, n->hashcode, INSERT);
+  n->next = *slot;
+  *slot = n;
+}
+
+/* Value number the PHI node PHI in BB.  */
+
+static void
+rpo_vn_visit_phi (gphi *phi, basic_block bb)
+{
+  tree res = gimple_phi_result (phi);
+  if (virtual_operand_p (res)
+      || SSA_NAME_OCCURS_IN_ABNORMAL_PHI (res))
+    return;
+
+  tree val = NULL_TREE;
+  edge e;
+  edge_iterator ei;
+  FOR_EACH_EDGE (e, ei, bb->preds)
+    {
+      if (!(e->flags & EDGE_EXECUTABLE))
+	continue;
+      tree arg = rpo_vn_valueize (PHI_ARG_DEF_FROM_EDGE (phi, e));
+      if (arg == res)
+	continue;
+      if (!val)
+	val = arg;
+      else if (val != arg
+	       && !(is_gimple_min_invariant (val)
+		    && operand_equal_p (val, arg, 0)))
+	return;
+    }
+  if (val
+      && rpo_vn_available_p (val, bb)
+      && useless_type_conversion_p (TREE_TYPE (res), TREE_TYPE (val)))
+    rpo_vn_set_value (res, val);
+}
+
+/* Value number the statement at GSI in BB, replacing its uses by their
+   values first.  Set the bit of BB in NEED_EH_CLEANUP if a statement
+   can no longer throw.  Return the number of uses replaced.  */
+
+static unsigned
+rpo_vn_visit_stmt (gimple_stmt_iterator *gsi, basic_block bb,
+		   bitmap need_eh_cleanup, unsigned *todo)
+{
+  gimple *stmt = gsi_stmt (*gsi);
+  unsigned replaced = 0;
+  use_operand_p use_p;
+  ssa_op_iter iter;
+
+  FOR_EACH_SSA_USE_OPERAND (use_p, stmt, iter, SSA_OP_USE)
+    {
+      tree op = USE_FROM_PTR (use_p);
+      tree val = rpo_vn_valueize (op);
+      if (val != op && may_propagate_copy (op, val))
+	{
+	  propagate_value (use_p, val);
+	  replaced++;
+	}
+    }
+  if (is_gimple_debug (stmt))
+    {
+      if (replaced)
+	update_stmt (stmt);
+      return replaced;
+    }
+  if (replaced)
+    {
+      gimple *old_stmt = stmt;
+      if (fold_stmt (gsi))
+	stmt = gsi_stmt (*gsi);
+      update_stmt (stmt);
+      if (maybe_clean_or_replace_eh_stmt (old_stmt, stmt))
+	bitmap_set_bit (need_eh_cleanup, bb->index);
+    }
+
+  if (gcond *cond = dyn_cast <gcond *> (stmt))
+    {
+      tree val = fold_binary (gimple_cond_code (cond), boolean_type_node,
+			      rpo_vn_valueize (gimple_cond_lhs (cond)),
+			      rpo_vn_valueize (gimple_cond_rhs (cond)));
+      if (val && (integer_zerop (val) || integer_onep (val)))
+	{
+	  edge true_edge, false_edge;
+	  extract_true_false_edges_from_block (bb, &true_edge, &false_edge);
+	  if (integer_onep (val))
+	    false_edge->flags &= ~EDGE_EXECUTABLE;
+	  else
+	    true_edge->flags &= ~EDGE_EXECUTABLE;
+	  *todo |= TODO_cleanup_cfg;
+	}
+      return replaced;
+    }
+
+  gassign *ass = dyn_cast <gassign *> (stmt);
+  if (!ass
+      || gimple_has_volatile_ops (ass)
+      || stmt_could_throw_p (ass))
+    return replaced;
+
+  rpo_vn_expr e = rpo_vn_expr ();
+  tree lhs = gimple_assign_lhs (ass);
+  if (TREE_CODE (lhs) != SSA_NAME)
+    {
+      /* Remember the value stored, for loads from the same place.  */
+      tree rhs = rpo_vn_valueize (gimple_assign_rhs1 (ass));
+      if (gimple_store_p (ass)
+	  && gimple_assign_single_p (ass)
+	  && (TREE_CODE (rhs) == SSA_NAME || is_gimple_min_invariant (rhs))
+	  && is_gimple_reg_type (TREE_TYPE (lhs))
+	  && !(TREE_CODE (lhs) == COMPONENT_REF
+	       && DECL_BIT_FIELD (TREE_OPERAND (lhs, 1))))
+	{
+	  e.code = TREE_CODE (lhs);
+	  e.length = 1;
+	  e.type = TREE_TYPE (lhs);
+	  e.vuse = gimple_vdef (ass);
+	  e.ops[0] = lhs;
+	  rpo_vn_hash_expr (&e);
+	  rpo_vn_insert (&e, rhs);
+	}
+      return replaced;
+    }
+  if (SSA_NAME_OCCURS_IN_ABNORMAL_PHI (lhs))
+    return replaced;
+
+  /* Copies, constants and whatever folds to one of them.  */
+  tree val = gimple_fold_stmt_to_constant_1 (ass, rpo_vn_valueize);
+  if (val
+      && (is_gimple_min_invariant (val)
+	  || (TREE_CODE (val) == SSA_NAME
+	      && val != lhs
+	      && rpo_vn_available_p (val, bb)))
+      && useless_type_conversion_p (TREE_TYPE (lhs), TREE_TYPE (val)))
+    {
+      rpo_vn_set_value (lhs, val);
+      return replaced;
+    }
+
+  if (!rpo_vn_init_expr (&e, ass))
+    return replaced;
+  val = rpo_vn_lookup (&e, bb);
+  if (val
+      && val != lhs
+      && useless_type_conversion_p (TREE_TYPE (lhs), TREE_TYPE (val)))
+    rpo_vn_set_value (lhs, val);
+  else
+    rpo_vn_insert (&e, lhs);
+  return replaced;
+}
+
+/* Value number the region of FN entered by ENTRY and left by edges
+   into the blocks in EXIT_BBS, replacing redundant computations in it
+   and removing the definitions that become dead.  All the blocks of
+   the region must be dominated by the destination of ENTRY.  Return
+   TODO flags for the caller.  */
+
+unsigned
+do_rpo_vn (function *fn, edge entry, bitmap exit_bbs)
+{
+  unsigned todo = 0;
+  unsigned replaced = 0, removed = 0;
+
+  calculate_dominance_info (CDI_DOMINATORS);
+
+  /* Compute the postorder of the region.  */
+  auto_vec<basic_block> postorder;
+  auto_vec<basic_block, 20> bb_stack;
+  auto_vec<edge_iterator, 20> ei_stack;
+  auto_sbitmap visited (last_basic_block_for_fn (fn));
+  bitmap_clear (visited);
+  bitmap_set_bit (visited, entry->dest->index);
+  bb_stack.safe_push (entry->dest);
+  ei_stack.safe_push (ei_start (entry->dest->succs));
+  while (!ei_stack.is_empty ())
+    {
+      edge_iterator &ei = ei_stack.last ();
+      if (!ei_end_p (ei))
+	{
+	  basic_block dest = ei_edge (ei)->dest;
+	  ei_next (&ei);
+	  if (dest != EXIT_BLOCK_PTR_FOR_FN (fn)
+	      && !bitmap_bit_p (exit_bbs, dest->index)
+	      && !bitmap_bit_p (visited, dest->index))
+	    {
+	      bitmap_set_bit (visited, dest->index);
+	      bb_stack.safe_push (dest);
+	      ei_stack.safe_push (ei_start (dest->succs));
+	    }
+	}
+      else
+	{
+	  postorder.safe_push (bb_stack.pop ());
+	  ei_stack.pop ();
+	}
+    }
+
+  edge e;
+  edge_iterator ei;
+  for (unsigned i = 0; i < postorder.length (); ++i)
+    FOR_EACH_EDGE (e, ei, postorder[i]->preds)
+      e->flags |= EDGE_EXECUTABLE;
+
+  rpo_vn_values.create (0);
+  rpo_vn_values.safe_grow_cleared (num_ssa_names);
+  rpo_vn_exprs = new hash_table<rpo_vn_expr_hasher> (31);
+  gcc_obstack_init (&rpo_vn_obstack);
+  bitmap need_eh_cleanup = BITMAP_ALLOC (NULL);
+
+  for (int i = postorder.length () - 1; i >= 0; --i)
+    {
+      basic_block bb = postorder[i];
+
+      if (bb != entry->dest)
+	{
+	  bool reachable = false;
+	  FOR_EACH_EDGE (e, ei, bb->preds)
+	    if (e->flags & EDGE_EXECUTABLE)
+	      reachable = true;
+	  if (!reachable)
+	    {
+	      FOR_EACH_EDGE (e, ei, bb->succs)
+		e->flags &= ~EDGE_EXECUTABLE;
+	      continue;
+	    }
+	}
+
+      for (gphi_iterator gsi = gsi_start_phis (bb);
+	   !gsi_end_p (gsi); gsi_next (&gsi))
+	rpo_vn_visit_phi (gsi.phi (), bb);
+      for (gimple_stmt_iterator gsi = gsi_start_bb (bb);
+	   !gsi_end_p (gsi); gsi_next (&gsi))
+	replaced += rpo_vn_visit_stmt (&gsi, bb, need_eh_cleanup, &todo);
+
+      /* Arguments on backedges are seen only now.  */
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	{
+	  if (!(e->flags & EDGE_EXECUTABLE))
+	    continue;
+	  for (gphi_iterator gsi = gsi_start_phis (e->dest);
+	       !gsi_end_p (gsi); gsi_next (&gsi))
+	    {
+	      use_operand_p use_p = PHI_ARG_DEF_PTR_FROM_EDGE (gsi.phi (), e);
+	      tree arg = USE_FROM_PTR (use_p);
+	      if (TREE_CODE (arg) != SSA_NAME || virtual_operand_p (arg))
+		continue;
+	      tree val = rpo_vn_valueize (arg);
+	      if (val != arg && may_propagate_copy (arg, val))
+		{
+		  propagate_value (use_p, val);
+		  replaced++;
+		}
+	    }
+	}
+    }
+
+  /* Remove the definitions that became dead, backwards so that chains
+     of them go at once.  */
+  for (unsigned i = 0; i < postorder.length (); ++i)
+    {
+      basic_block bb = postorder[i];
+      gimple_stmt_iterator gsi = gsi_last_bb (bb);
+      while (!gsi_end_p (gsi))
+	{
+	  gimple *stmt = gsi_stmt (gsi);
+	  gimple_stmt_iterator prev = gsi;
+	  gsi_prev (&prev);
+	  tree lhs;
+	  if (is_gimple_assign (stmt)
+	      && (lhs = gimple_assign_lhs (stmt), TREE_CODE (lhs) == SSA_NAME)
+	      && has_zero_uses (lhs)
+	      && !gimple_vdef (stmt)
+	      && !gimple_has_side_effects (stmt)
+	      && !stmt_could_throw_p (stmt))
+	    {
+	      gsi_remove (&gsi, true);
+	      release_defs (stmt);
+	      removed++;
+	    }
+	  gsi = prev;
+	}
+      for (gphi_iterator gsi = gsi_start_phis (bb); !gsi_end_p (gsi); )
+	{
+	  tree res = gimple_phi_result (gsi.phi ());
+	  if (!virtual_operand_p (res) && has_zero_uses (res))
+	    {
+	      remove_phi_node (&gsi, true);
+	      removed++;
+	    }
+	  else
+	    gsi_next (&gsi);
+	}
+    }
+
+  /* Leave the edges executable for the next user of the flag.  */
+  for (unsigned i = 0; i < postorder.length (); ++i)
+    FOR_EACH_EDGE (e, ei, postorder[i]->succs)
+      e->flags |= EDGE_EXECUTABLE;
+
+  if (!bitmap_empty_p (need_eh_cleanup))
+    {
+      gimple_purge_all_dead_eh_edges (need_eh_cleanup);
+      todo |= TODO_cleanup_cfg;
+    }
+  BITMAP_FREE (need_eh_cleanup);
+  obstack_free (&rpo_vn_obstack, NULL);
+  delete rpo_vn_exprs;
+  rpo_vn_exprs = NULL;
+  rpo_vn_values.release ();
+
+  statistics_counter_event (fn, "RPO VN uses replaced", replaced);
+  statistics_counter_event (fn, "RPO VN statements removed", removed);
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    fprintf (dump_file, "RPO VN of the region entered by bb %d: "
+	     "%u blocks, %u uses replaced, %u statements removed\n",
+	     entry->dest->index, postorder.length (), replaced, removed);
+
+  return todo;
+}
@@ -1445,6 +1445,9 @@ scc_visit (constraint_graph_t graph, struct scc_info *si, unsigned int n)
 	  unsigned int lowest_node;
 	  bitmap_iterator bi;
 
+	  /* The nodes come off the stack in no particular order, so
+	     collect them in tree form.  */
+	  bitmap_tree_view (scc);
 	  bitmap_set_bit (scc, n);
 
 	  while (si->scc_stack.length () != 0
@@ -1455,6 +1458,7 @@ scc_visit (constraint_graph_t graph, struct scc_info *si, unsigned int n)
 	      bitmap_set_bit (scc, w);
 	    }
 
+	  bitmap_list_view (scc);
 	  lowest_node = bitmap_first_set_bit (scc);
 	  gcc_assert (lowest_node < FIRST_REF_NODE);
 
@@ -2758,13 +2762,32 @@ solve_graph (constraint_graph_t graph)
 		  unsigned eff_escaped_id = find (escaped_id);
 
 		  /* Propagate solution to all successors.  */
+		  unsigned to_remove = ~0U;
 		  EXECUTE_IF_IN_NONNULL_BITMAP (graph->succs[i],
 						0, j, bi)
 		    {
 		      bitmap tmp;
 		      bool flag;
 
+		      if (to_remove != ~0U)
+			{
+			  bitmap_clear_bit (graph->succs[i], to_remove);
+			  to_remove = ~0U;
+			}
 		      unsigned int to = find (j);
+		      if (to != j)
+			{
+			  /* Replace the edge to a unified node by one to
+			     its representative, so that several edges
+			     ending up at the same node are not all
+			     propagated along each time.  */
+			  to_remove = j;
+			  if (! bitmap_set_bit (graph->succs[i], to))
+			    continue;
+			  /* Whether the bitmap iteration visits TO again
+			     is undefined, so we may propagate to it
+			     twice; that is harmless.  */
+			}
 		      tmp = get_varinfo (to)->solution;
 		      flag = false;
 
@@ -2782,6 +2805,8 @@ solve_graph (constraint_graph_t graph)
 		      if (flag)
 			bitmap_set_bit (changed, to);
 		    }
+		  if (to_remove != ~0U)
+		    bitmap_clear_bit (graph->succs[i], to_remove);
 		}
 	    }
 	}
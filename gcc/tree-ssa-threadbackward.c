@@ -40,6 +40,14 @@ along with GCC; see the file COPYING3.  If not see
 
 static int max_threaded_paths;
 
+/* The unique paths found by find_unique_subpath, keyed by the indices
+   of their blocks.  The search only depends on the CFG, so the cache
+   is kept for all the paths ending at a control statement.  */
+
+typedef hash_map<int_hash <HOST_WIDE_INT, -1, -2>,
+		 vec<basic_block, va_gc> *> subpath_map;
+static subpath_map *subpath_cache;
+
 /* Simple helper to get the last statement from BB, which is assumed
    to be a control statement.   Return NULL if the last statement is
    not a control statement.  */
@@ -311,7 +319,21 @@ profitable_jump_thread_path (vec<basic_block, va_gc> *&path,
       return NULL;
     }
 
-  if (speed_p && optimize_edge_for_speed_p (taken_edge))
+  /* The edge entering the path, which is redirected to the copy.  */
+  edge entry_edge = find_edge ((*path)[path_length - 1],
+			       (*path)[path_length - 2]);
+  gcc_assert (entry_edge);
+
+  /* Weigh the code growth against how often the copy would run: a path
+     entered in less than PARAM_FSM_MIN_PATH_FREQUENCY percent of the
+     executions of the threaded branch saves too little to justify
+     duplicating more than a single instruction.  */
+  bool path_hot_p = (optimize_edge_for_speed_p (entry_edge)
+		     && (EDGE_FREQUENCY (entry_edge) * 100
+			 >= ((*path)[0]->frequency
+			     * PARAM_VALUE (PARAM_FSM_MIN_PATH_FREQUENCY))));
+
+  if (speed_p && path_hot_p && optimize_edge_for_speed_p (taken_edge))
     {
       if (n_insns >= PARAM_VALUE (PARAM_MAX_FSM_THREAD_PATH_INSNS))
 	{
@@ -327,8 +349,9 @@ profitable_jump_thread_path (vec<basic_block, va_gc> *&path,
     {
       if (dump_file && (dump_flags & TDF_DETAILS))
 	fprintf (dump_file, "FSM jump-thread path not considered: "
-		 "duplication of %i insns is needed and optimizing for size.\n",
-		 n_insns);
+		 "duplication of %i insns is needed and %s.\n",
+		 n_insns, (speed_p && !path_hot_p
+			   ? "the path is cold" : "optimizing for size"));
       path->pop ();
       return NULL;
     }
@@ -424,25 +447,24 @@ convert_and_register_jump_thread_path (vec<basic_block, va_gc> *path,
   --max_threaded_paths;
 }
 
-/* While following a chain of SSA_NAME definitions, we jumped from a definition
-   in LAST_BB to a definition in VAR_BB (walking backwards).
+/* Return the blocks of the only path from NEW_BB to one of the
+   predecessors of LAST_BB, in reverse order, or NULL if there is no such
+   path or more than one.  The result is owned by SUBPATH_CACHE.  */
 
-   Verify there is a single path between the blocks and none of the blocks
-   in the path is already in VISITED_BBS.  If so, then update VISISTED_BBS,
-   add the new blocks to PATH and return TRUE.  Otherwise return FALSE.
-
-   Store the length of the subpath in NEXT_PATH_LENGTH.  */
-
-static bool
-check_subpath_and_update_thread_path (basic_block last_bb, basic_block new_bb,
-				      hash_set<basic_block> *visited_bbs,
-				      vec<basic_block, va_gc> *&path,
-				      int *next_path_length)
+static vec<basic_block, va_gc> *
+find_unique_subpath (basic_block last_bb, basic_block new_bb)
 {
+  HOST_WIDE_INT key = ((HOST_WIDE_INT) last_bb->index
+		       * last_basic_block_for_fn (cfun) + new_bb->index);
+  bool existed;
+  vec<basic_block, va_gc> *&next_path
+    = subpath_cache->get_or_insert (key, &existed);
+  if (existed)
+    return next_path;
+
   edge e;
   int e_count = 0;
   edge_iterator ei;
-  vec<basic_block, va_gc> *next_path;
   vec_alloc (next_path, 10);
 
   FOR_EACH_EDGE (e, ei, last_bb->preds)
@@ -457,29 +479,42 @@ check_subpath_and_update_thread_path (basic_block last_bb, basic_block new_bb,
 
       /* If there is more than one path, stop.  */
       if (e_count > 1)
-	{
-	  vec_free (next_path);
-	  return false;
-	}
+	break;
     }
 
-  /* Stop if we have not found a path: this could occur when the recursion
-     is stopped by one of the bounds.  */
-  if (e_count == 0)
-    {
-      vec_free (next_path);
-      return false;
-    }
+  /* Give up as well if we have not found a path: this could occur
+     when the recursion is stopped by one of the bounds.  */
+  if (e_count != 1)
+    vec_free (next_path);
+
+  return next_path;
+}
+
+/* While following a chain of SSA_NAME definitions, we jumped from a definition
+   in LAST_BB to a definition in VAR_BB (walking backwards).
+
+   Verify there is a single path between the blocks and none of the blocks
+   in the path is already in VISITED_BBS.  If so, then update VISISTED_BBS,
+   add the new blocks to PATH and return TRUE.  Otherwise return FALSE.
+
+   Store the length of the subpath in NEXT_PATH_LENGTH.  */
+
+static bool
+check_subpath_and_update_thread_path (basic_block last_bb, basic_block new_bb,
+				      hash_set<basic_block> *visited_bbs,
+				      vec<basic_block, va_gc> *&path,
+				      int *next_path_length)
+{
+  vec<basic_block, va_gc> *next_path = find_unique_subpath (last_bb, new_bb);
+  if (!next_path)
+    return false;
 
   /* Make sure we haven't already visited any of the nodes in
      NEXT_PATH.  Don't add them here to avoid pollution.  */
   for (unsigned int i = 0; i < next_path->length () - 1; i++)
     {
       if (visited_bbs->contains ((*next_path)[i]))
-	{
-	  vec_free (next_path);
-	  return false;
-	}
+	return false;
     }
 
   /* Now add the nodes to VISISTED_BBS.  */
@@ -489,7 +524,6 @@ check_subpath_and_update_thread_path (basic_block last_bb, basic_block new_bb,
   /* Append all the nodes from NEXT_PATH to PATH.  */
   vec_safe_splice (path, next_path);
   *next_path_length = next_path->length ();
-  vec_free (next_path);
 
   return true;
 }
@@ -761,9 +795,15 @@ find_jump_threads_backwards (basic_block bb, bool speed_p)
   hash_set<basic_block> *visited_bbs = new hash_set<basic_block>;
 
   max_threaded_paths = PARAM_VALUE (PARAM_MAX_FSM_THREAD_PATHS);
+  subpath_cache = new subpath_map;
   fsm_find_control_statement_thread_paths (name, visited_bbs, bb_path, false,
 					   speed_p);
 
+  for (subpath_map::iterator it = subpath_cache->begin ();
+       it != subpath_cache->end (); ++it)
+    vec_free ((*it).second);
+  delete subpath_cache;
+  subpath_cache = NULL;
   delete visited_bbs;
   vec_free (bb_path);
 }
@@ -442,6 +442,7 @@ vect_analyze_data_ref_dependence (struct data_dependence_relation *ddr,
 	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
 	               "not vectorized, possible dependence "
 	               "between data-refs ");
+	  opt_record_reason ("possible-dependence");
 	  dump_generic_expr (MSG_NOTE, TDF_SLIM, DR_REF (dra));
 	  dump_printf (MSG_NOTE,  " and ");
 	  dump_generic_expr (MSG_NOTE, TDF_SLIM, DR_REF (drb));
@@ -640,9 +641,12 @@ vect_slp_analyze_instance_dependence (slp_instance instance)
     dump_printf_loc (MSG_NOTE, vect_location,
                      "=== vect_slp_analyze_instance_dependence ===\n");
 
-  /* The stores of this instance are at the root of the SLP tree.  */
+  /* The stores of this instance are at the root of the SLP tree.  The
+     root of a basic-block reduction may be a group of loads instead.  */
   slp_tree store = SLP_INSTANCE_TREE (instance);
-  if (! STMT_VINFO_DATA_REF (vinfo_for_stmt (SLP_TREE_SCALAR_STMTS (store)[0])))
+  data_reference *store_dr
+    = STMT_VINFO_DATA_REF (vinfo_for_stmt (SLP_TREE_SCALAR_STMTS (store)[0]));
+  if (! store_dr || DR_IS_READ (store_dr))
     store = NULL;
 
   /* Verify we can sink stores to the vectorized stmt insert location.  */
@@ -2140,9 +2144,12 @@ vect_analyze_data_refs_alignment (loop_vec_info vinfo)
 	    continue;
 
 	  if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: can't calculate alignment "
-			     "for data ref.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: can't calculate alignment "
+			       "for data ref.\n");
+	      opt_record_reason ("unknown-alignment");
+	    }
 
 	  return false;
 	}
@@ -2174,9 +2181,12 @@ vect_slp_analyze_and_verify_node_alignment (slp_tree node)
       || ! verify_data_ref_alignment (dr))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: bad data alignment in basic "
-			 "block.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: bad data alignment in basic "
+			   "block.\n");
+	  opt_record_reason ("bad-alignment");
+	}
       return false;
     }
 
@@ -2500,12 +2510,14 @@ vect_analyze_data_ref_access (struct data_reference *dr)
       return false;
     }
 
-  /* Allow loads with zero step in inner-loop vectorization.  */
+  /* Allow loads with zero step in inner-loop vectorization.  Gathers
+     and scatters have zero step too, the varying part of their address
+     is the offset vector.  */
   if (loop_vinfo && integer_zerop (step))
     {
       GROUP_FIRST_ELEMENT (vinfo_for_stmt (stmt)) = NULL;
       if (!nested_in_vect_loop_p (loop, stmt))
-	return DR_IS_READ (dr);
+	return DR_IS_READ (dr) || STMT_VINFO_GATHER_SCATTER_P (stmt_info);
       /* Allow references with zero step for outer loops marked
 	 with pragma omp simd only - it guarantees absence of
 	 loop-carried dependencies between inner loop iterations.  */
@@ -2864,8 +2876,11 @@ vect_analyze_data_ref_accesses (vec_info *vinfo)
         && !vect_analyze_data_ref_access (dr))
       {
 	if (dump_enabled_p ())
-	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-	                   "not vectorized: complicated access pattern.\n");
+	  {
+	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			     "not vectorized: complicated access pattern.\n");
+	    opt_record_reason ("complicated-access-pattern");
+	  }
 
         if (is_a <bb_vec_info> (vinfo))
           {
@@ -3577,8 +3592,11 @@ again:
       if (!dr || !DR_REF (dr))
         {
           if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-	                     "not vectorized: unhandled data-ref\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: unhandled data-ref\n");
+	      opt_record_reason ("unhandled-data-ref");
+	    }
           return false;
         }
 
@@ -3696,6 +3714,7 @@ again:
 		  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                    "not vectorized: data ref analysis "
                                    "failed ");
+		  opt_record_reason ("data-ref-analysis-failed");
 		  dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
 		}
 
@@ -3709,9 +3728,12 @@ again:
       if (TREE_CODE (DR_BASE_ADDRESS (dr)) == INTEGER_CST)
         {
           if (dump_enabled_p ())
-            dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-                             "not vectorized: base addr of dr is a "
-                             "constant\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: base addr of dr is a "
+			       "constant\n");
+	      opt_record_reason ("invariant-base-address");
+	    }
 
           if (is_a <bb_vec_info> (vinfo))
 	    break;
@@ -3727,6 +3749,7 @@ again:
             {
               dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                "not vectorized: volatile type ");
+	      opt_record_reason ("volatile-access");
               dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
             }
 
@@ -3743,6 +3766,7 @@ again:
               dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                "not vectorized: statement can throw an "
                                "exception ");
+	      opt_record_reason ("may-throw");
               dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
             }
 
@@ -3762,6 +3786,7 @@ again:
               dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                "not vectorized: statement is bitfield "
                                "access ");
+	      opt_record_reason ("bitfield-access");
               dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
             }
 
@@ -3786,6 +3811,7 @@ again:
 	    {
 	      dump_printf_loc (MSG_MISSED_OPTIMIZATION,  vect_location,
 	                       "not vectorized: dr in a call ");
+	      opt_record_reason ("data-ref-in-call");
 	      dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
 	    }
 
@@ -3932,6 +3958,7 @@ again:
               dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                "not vectorized: more than one data ref "
                                "in stmt: ");
+	      opt_record_reason ("multiple-data-refs");
               dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
             }
 
@@ -3961,6 +3988,7 @@ again:
             {
               dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                "not vectorized: no vectype for stmt: ");
+	      opt_record_reason ("no-vector-type");
               dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
               dump_printf (MSG_MISSED_OPTIMIZATION, " scalar_type: ");
               dump_generic_expr (MSG_MISSED_OPTIMIZATION, TDF_DETAILS,
@@ -4040,6 +4068,7 @@ again:
 		  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location, 
                                    "not vectorized: not suitable for strided "
                                    "load ");
+		  opt_record_reason ("unsupported-strided-access");
 		  dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
 		}
 	      return false;
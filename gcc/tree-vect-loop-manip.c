@@ -1690,7 +1690,14 @@ vect_do_peeling (loop_vec_info loop_vinfo, tree niters, tree nitersm1,
      may be preferred.  */
   basic_block anchor = loop_preheader_edge (loop)->src;
   if (skip_vector)
-    split_edge (loop_preheader_edge (loop));
+    {
+      /* When LOOP is the epilogue of an already vectorized loop, its
+	 preheader may be the block ending with the guard that skips it.
+	 Give the new guard a block of its own.  */
+      if (!single_succ_p (anchor))
+	anchor = split_edge (loop_preheader_edge (loop));
+      split_edge (loop_preheader_edge (loop));
+    }
 
   tree niters_prolog = build_int_cst (type, 0);
   source_location loop_loc = find_loop_location (loop);
@@ -392,6 +392,7 @@ vect_determine_vectorization_factor (loop_vec_info loop_vinfo)
 		{
 	          dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                    "not vectorized: irregular stmt.");
+		  opt_record_reason ("irregular-stmt");
 		  dump_gimple_stmt (MSG_MISSED_OPTIMIZATION,  TDF_SLIM, stmt,
                                     0);
 		}
@@ -404,6 +405,7 @@ vect_determine_vectorization_factor (loop_vec_info loop_vinfo)
 	        {
 	          dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                    "not vectorized: vector stmt in loop:");
+		  opt_record_reason ("vector-stmt-in-loop");
 	          dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
 	        }
 	      return false;
@@ -519,6 +521,7 @@ vect_determine_vectorization_factor (loop_vec_info loop_vinfo)
 		{
 		  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                    "not vectorized: unsupported data-type ");
+		  opt_record_reason ("unsupported-data-type");
 		  dump_generic_expr (MSG_MISSED_OPTIMIZATION, TDF_SLIM,
                                      scalar_type);
                   dump_printf (MSG_MISSED_OPTIMIZATION, "\n");
@@ -534,6 +537,7 @@ vect_determine_vectorization_factor (loop_vec_info loop_vinfo)
 		  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                                    "not vectorized: different sized vector "
                                    "types in statement, ");
+		  opt_record_reason ("different-sized-vectors");
 		  dump_generic_expr (MSG_MISSED_OPTIMIZATION, TDF_SLIM,
                                      vectype);
 		  dump_printf (MSG_MISSED_OPTIMIZATION, " and ");
@@ -573,8 +577,11 @@ vect_determine_vectorization_factor (loop_vec_info loop_vinfo)
   if (vectorization_factor <= 1)
     {
       if (dump_enabled_p ())
-        dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-                         "not vectorized: unsupported data-type\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: unsupported data-type\n");
+	  opt_record_reason ("unsupported-data-type");
+	}
       return false;
     }
   LOOP_VINFO_VECT_FACTOR (loop_vinfo) = vectorization_factor;
@@ -1356,12 +1363,16 @@ vect_compute_single_scalar_iteration_cost (loop_vec_info loop_vinfo)
    - the loop has a single entry and exit
    - the loop exit condition is simple enough
    - the number of iterations can be analyzed, i.e, a countable loop.  The
-     niter could be analyzed under some assumptions.  */
+     niter could be analyzed under some assumptions.
+   - if INVARIANT_INNER_NITER_P, the number of iterations of the inner loop
+     of a nested loop is invariant in LOOP, as outer-loop vectorization
+     requires.  */
 
 bool
 vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
 			  tree *assumptions, tree *number_of_iterationsm1,
-			  tree *number_of_iterations, gcond **inner_loop_cond)
+			  tree *number_of_iterations, gcond **inner_loop_cond,
+			  bool invariant_inner_niter_p)
 {
   if (dump_enabled_p ())
     dump_printf_loc (MSG_NOTE, vect_location,
@@ -1388,16 +1399,22 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
       if (loop->num_nodes != 2)
         {
           if (dump_enabled_p ())
-            dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: control flow in loop.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: control flow in loop.\n");
+	      opt_record_reason ("control-flow");
+	    }
           return false;
         }
 
       if (empty_block_p (loop->header))
 	{
 	  if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: empty loop.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: empty loop.\n");
+	      opt_record_reason ("empty-loop");
+	    }
 	  return false;
 	}
     }
@@ -1426,16 +1443,22 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
       if ((loop->inner)->inner || (loop->inner)->next)
 	{
 	  if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: multiple nested loops.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: multiple nested loops.\n");
+	      opt_record_reason ("multiple-nested-loops");
+	    }
 	  return false;
 	}
 
       if (loop->num_nodes != 5)
         {
 	  if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: control flow in loop.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: control flow in loop.\n");
+	      opt_record_reason ("control-flow");
+	    }
 	  return false;
         }
 
@@ -1445,8 +1468,11 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
 	  || single_exit (innerloop)->dest != EDGE_PRED (loop->latch, 0)->src)
 	{
 	  if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: unsupported outerloop form.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: unsupported outerloop form.\n");
+	      opt_record_reason ("unsupported-outer-loop-form");
+	    }
 	  return false;
 	}
 
@@ -1454,23 +1480,30 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
       tree inner_niterm1, inner_niter, inner_assumptions;
       if (! vect_analyze_loop_form_1 (loop->inner, inner_loop_cond,
 				      &inner_assumptions, &inner_niterm1,
-				      &inner_niter, NULL)
+				      &inner_niter, NULL, true)
 	  /* Don't support analyzing niter under assumptions for inner
 	     loop.  */
 	  || !integer_onep (inner_assumptions))
 	{
 	  if (dump_enabled_p ())
-            dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: Bad inner loop.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: Bad inner loop.\n");
+	      opt_record_reason ("bad-inner-loop");
+	    }
 	  return false;
 	}
 
-      if (!expr_invariant_in_loop_p (loop, inner_niter))
+      if (invariant_inner_niter_p
+	  && !expr_invariant_in_loop_p (loop, inner_niter))
 	{
 	  if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: inner-loop count not"
-                             " invariant.\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: inner-loop count not"
+			       " invariant.\n");
+	      opt_record_reason ("inner-loop-count-not-invariant");
+	    }
 	  return false;
 	}
 
@@ -1502,8 +1535,11 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
       || !gimple_seq_empty_p (phi_nodes (loop->latch)))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: latch block not empty.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: latch block not empty.\n");
+	  opt_record_reason ("latch-not-empty");
+	}
       return false;
     }
 
@@ -1512,8 +1548,11 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
   if (e->flags & EDGE_ABNORMAL)
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: abnormal loop exit edge.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: abnormal loop exit edge.\n");
+	  opt_record_reason ("abnormal-exit");
+	}
       return false;
     }
 
@@ -1522,8 +1561,11 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
   if (!*loop_cond)
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: complicated exit condition.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: complicated exit condition.\n");
+	  opt_record_reason ("complicated-exit-condition");
+	}
       return false;
     }
 
@@ -1532,34 +1574,43 @@ vect_analyze_loop_form_1 (struct loop *loop, gcond **loop_cond,
       || chrec_contains_undetermined (*number_of_iterations))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: number of iterations cannot be "
-			 "computed.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: number of iterations cannot be "
+			   "computed.\n");
+	  opt_record_reason ("unknown-iteration-count");
+	}
       return false;
     }
 
   if (integer_zerop (*number_of_iterations))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: number of iterations = 0.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: number of iterations = 0.\n");
+	  opt_record_reason ("zero-iterations");
+	}
       return false;
     }
 
   return true;
 }
 
-/* Analyze LOOP form and return a loop_vec_info if it is of suitable form.  */
+/* Analyze LOOP form and return a loop_vec_info if it is of suitable form.
+   INVARIANT_INNER_NITER_P is as for vect_analyze_loop_form_1; it can be
+   false for callers that only analyze the reductions of LOOP.  */
 
 loop_vec_info
-vect_analyze_loop_form (struct loop *loop)
+vect_analyze_loop_form (struct loop *loop, bool invariant_inner_niter_p)
 {
   tree assumptions, number_of_iterations, number_of_iterationsm1;
   gcond *loop_cond, *inner_loop_cond = NULL;
 
   if (! vect_analyze_loop_form_1 (loop, &loop_cond,
 				  &assumptions, &number_of_iterationsm1,
-				  &number_of_iterations, &inner_loop_cond))
+				  &number_of_iterations, &inner_loop_cond,
+				  invariant_inner_niter_p))
     return NULL;
 
   loop_vec_info loop_vinfo = new_loop_vec_info (loop);
@@ -1760,8 +1811,11 @@ vect_analyze_loop_operations (loop_vec_info loop_vinfo)
             {
               /* A scalar-dependence cycle that we don't support.  */
               if (dump_enabled_p ())
-		dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-				 "not vectorized: scalar dependence cycle.\n");
+		{
+		  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+				   "not vectorized: scalar dependence cycle.\n");
+		  opt_record_reason ("scalar-dependence-cycle");
+		}
               return false;
             }
 
@@ -1782,6 +1836,7 @@ vect_analyze_loop_operations (loop_vec_info loop_vinfo)
 		  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
 				   "not vectorized: relevant phi not "
 				   "supported: ");
+		  opt_record_reason ("unsupported-phi");
                   dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, phi, 0);
                 }
 	      return false;
@@ -1809,9 +1864,12 @@ vect_analyze_loop_operations (loop_vec_info loop_vinfo)
         dump_printf_loc (MSG_NOTE, vect_location,
 			 "All the computation can be taken out of the loop.\n");
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: redundant loop. no profit to "
-			 "vectorize.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: redundant loop. no profit to "
+			   "vectorize.\n");
+	  opt_record_reason ("redundant-loop");
+	}
       return false;
     }
 
@@ -1819,6 +1877,26 @@ vect_analyze_loop_operations (loop_vec_info loop_vinfo)
 }
 
 
+/* Attach the numbers the cost model based its decision about LOOP_VINFO
+   on to the current -fopt-record remark.  TH is the runtime threshold
+   on the iteration count, or -1 if it is not computed yet.  */
+
+static void
+vect_record_cost_params (loop_vec_info loop_vinfo, int min_profitable_iters,
+			 int min_profitable_estimate, int th)
+{
+  opt_record_param ("vectorization_factor",
+		    LOOP_VINFO_VECT_FACTOR (loop_vinfo));
+  opt_record_param ("scalar_iteration_cost",
+		    LOOP_VINFO_SINGLE_SCALAR_ITERATION_COST (loop_vinfo));
+  opt_record_param ("min_profitable_iters", min_profitable_iters);
+  opt_record_param ("min_profitable_estimate", min_profitable_estimate);
+  if (th >= 0)
+    opt_record_param ("threshold", th);
+  if (LOOP_VINFO_NITERS_KNOWN_P (loop_vinfo))
+    opt_record_param ("iterations", LOOP_VINFO_INT_NITERS (loop_vinfo));
+}
+
 /* Function vect_analyze_loop_2.
 
    Apply a set of analyses on LOOP, and create a loop_vec_info struct
@@ -1844,10 +1922,13 @@ vect_analyze_loop_2 (loop_vec_info loop_vinfo, bool &fatal)
   if (!find_loop_nest (loop, &LOOP_VINFO_LOOP_NEST (loop_vinfo)))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: loop nest containing two "
-			 "or more consecutive inner loops cannot be "
-			 "vectorized\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: loop nest containing two "
+			   "or more consecutive inner loops cannot be "
+			   "vectorized\n");
+	  opt_record_reason ("unsupported-loop-nest");
+	}
       return false;
     }
 
@@ -1893,10 +1974,13 @@ vect_analyze_loop_2 (loop_vec_info loop_vinfo, bool &fatal)
 		  }
 	      }
 	    if (dump_enabled_p ())
-	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			       "not vectorized: loop contains function "
-			       "calls or data references that cannot "
-			       "be analyzed\n");
+	      {
+		dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+				 "not vectorized: loop contains function "
+				 "calls or data references that cannot "
+				 "be analyzed\n");
+		opt_record_reason ("function-call");
+	      }
 	    return false;
 	  }
       }
@@ -2023,9 +2107,12 @@ start_over:
 	  && (unsigned HOST_WIDE_INT) max_niter < vectorization_factor))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: iteration count smaller than "
-			 "vectorization factor.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: iteration count smaller than "
+			   "vectorization factor.\n");
+	  opt_record_reason ("too-few-iterations");
+	}
       return false;
     }
 
@@ -2114,8 +2201,13 @@ start_over:
   if (min_profitable_iters < 0)
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: vectorization not profitable.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: vectorization not profitable.\n");
+	  opt_record_reason ("cost-model");
+	  vect_record_cost_params (loop_vinfo, min_profitable_iters,
+				  min_profitable_estimate, -1);
+	}
       if (dump_enabled_p ())
 	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
 			 "not vectorized: vector version will never be "
@@ -2140,8 +2232,13 @@ start_over:
       && LOOP_VINFO_INT_NITERS (loop_vinfo) <= th)
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: vectorization not profitable.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: vectorization not profitable.\n");
+	  opt_record_reason ("cost-model");
+	  vect_record_cost_params (loop_vinfo, min_profitable_iters,
+				  min_profitable_estimate, th);
+	}
       if (dump_enabled_p ())
         dump_printf_loc (MSG_NOTE, vect_location,
 			 "not vectorized: iteration count smaller than user "
@@ -2159,9 +2256,15 @@ start_over:
           <= MAX (th, (unsigned)min_profitable_estimate)))
     {
       if (dump_enabled_p ())
-	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: estimated iteration count too "
-                         "small.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: estimated iteration count too "
+			   "small.\n");
+	  opt_record_reason ("too-few-iterations");
+	  vect_record_cost_params (loop_vinfo, min_profitable_iters,
+				  min_profitable_estimate, th);
+	  opt_record_param ("estimated_iterations", estimated_niter);
+	}
       if (dump_enabled_p ())
         dump_printf_loc (MSG_NOTE, vect_location,
 			 "not vectorized: estimated iteration count smaller "
@@ -2207,9 +2310,12 @@ start_over:
 							 (loop_vinfo))))
         {
           if (dump_enabled_p ())
-	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			     "not vectorized: can't create required "
-			     "epilog loop\n");
+	    {
+	      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			       "not vectorized: can't create required "
+			       "epilog loop\n");
+	      opt_record_reason ("versioning-failed");
+	    }
           goto again;
         }
     }
@@ -2323,10 +2429,22 @@ vect_analyze_loop (struct loop *loop, loop_vec_info orig_loop_vinfo)
   loop_vec_info loop_vinfo;
   unsigned int vector_sizes;
 
-  /* Autodetect first vector size we try.  */
-  current_vector_size = 0;
   vector_sizes = targetm.vectorize.autovectorize_vector_sizes ();
 
+  /* An epilogue has fewer iterations than the vectorization factor of
+     the loop it was peeled from, so only try vector sizes smaller than
+     the one used for that loop.  Otherwise autodetect the first vector
+     size we try.  */
+  if (orig_loop_vinfo)
+    {
+      vector_sizes &= current_vector_size - 1;
+      if (!vector_sizes)
+	return NULL;
+      current_vector_size = 1 << floor_log2 (vector_sizes);
+    }
+  else
+    current_vector_size = 0;
+
   if (dump_enabled_p ())
     dump_printf_loc (MSG_NOTE, vect_location,
 		     "===== analyze_loop_nest =====\n");
@@ -2344,7 +2462,7 @@ vect_analyze_loop (struct loop *loop, loop_vec_info orig_loop_vinfo)
   while (1)
     {
       /* Check the CFG characteristics of the loop (nesting, entry/exit).  */
-      loop_vinfo = vect_analyze_loop_form (loop);
+      loop_vinfo = vect_analyze_loop_form (loop, true);
       if (!loop_vinfo)
 	{
 	  if (dump_enabled_p ())
@@ -2396,7 +2514,7 @@ vect_analyze_loop (struct loop *loop, loop_vec_info orig_loop_vinfo)
 
    Return FALSE if CODE currently cannot be vectorized as reduction.  */
 
-static bool
+bool
 reduction_code_for_scalar_code (enum tree_code code,
                                 enum tree_code *reduc_code)
 {
@@ -3565,7 +3683,7 @@ vect_estimate_min_profitable_iters (loop_vec_info loop_vinfo,
 
 /* Writes into SEL a mask for a vec_perm, equivalent to a vec_shr by OFFSET
    vector elements (not bits) for a vector of mode MODE.  */
-static void
+void
 calc_vec_perm_mask_for_shift (enum machine_mode mode, unsigned int offset,
 			      unsigned char *sel)
 {
@@ -3578,7 +3696,7 @@ calc_vec_perm_mask_for_shift (enum machine_mode mode, unsigned int offset,
 /* Checks whether the target supports whole-vector shifts for vectors of mode
    MODE.  This is the case if _either_ the platform handles vec_shr_optab, _or_
    it supports vec_perm_const with masks for all necessary shift amounts.  */
-static bool
+bool
 have_whole_vector_shift (enum machine_mode mode)
 {
   if (optab_handler (vec_shr_optab, mode) != CODE_FOR_nothing)
@@ -1527,6 +1527,136 @@ vect_find_last_scalar_stmt_in_slp (slp_tree node)
   return last;
 }
 
+/* Return true if STMT is an operation basic-block SLP can vectorize as
+   a horizontal reduction, that is an associative and commutative
+   operation whose operands may be reordered.  */
+
+static bool
+vect_bb_reduction_op_p (gimple *stmt)
+{
+  enum tree_code code, reduc_code;
+
+  if (!is_gimple_assign (stmt))
+    return false;
+
+  code = gimple_assign_rhs_code (stmt);
+  if (code == MINUS_EXPR
+      || !reduction_code_for_scalar_code (code, &reduc_code))
+    return false;
+
+  tree type = TREE_TYPE (gimple_assign_lhs (stmt));
+  if (SCALAR_FLOAT_TYPE_P (type))
+    return flag_associative_math;
+
+  return (INTEGRAL_TYPE_P (type)
+	  && operation_no_trapping_overflow (type, code));
+}
+
+/* Walk the tree of CODE operations ending in STMT.  Push the stmts in the
+   region of BB_VINFO that compute its operands to LEAVES and the other
+   operands to EXTERNALS.  If CHAIN is not NULL push the CODE operations
+   themselves to it.  */
+
+static void
+vect_bb_reduction_operands (bb_vec_info bb_vinfo, gimple *stmt,
+			    enum tree_code code, vec<gimple *> *leaves,
+			    vec<tree> *externals, vec<gimple *> *chain)
+{
+  if (chain)
+    chain->safe_push (stmt);
+
+  for (unsigned i = 1; i < 3; ++i)
+    {
+      tree op = gimple_op (stmt, i);
+      gimple *def_stmt = NULL;
+      if (TREE_CODE (op) == SSA_NAME)
+	def_stmt = SSA_NAME_DEF_STMT (op);
+
+      if (!def_stmt
+	  || !is_gimple_assign (def_stmt)
+	  || !vect_stmt_in_region_p (bb_vinfo, def_stmt))
+	externals->safe_push (op);
+      else if (gimple_assign_rhs_code (def_stmt) == code
+	       && has_single_use (op))
+	vect_bb_reduction_operands (bb_vinfo, def_stmt, code, leaves,
+				    externals, chain);
+      else
+	leaves->safe_push (def_stmt);
+    }
+}
+
+/* Return true if the target can reduce a vector of type VECTYPE to a
+   scalar using CODE.  Set *REDUC_CODE to the tree code doing that in
+   one step, or to ERROR_MARK if whole-vector shifts have to be used.  */
+
+static bool
+vect_bb_reduction_code (enum tree_code code, tree vectype,
+			enum tree_code *reduc_code)
+{
+  machine_mode mode = TYPE_MODE (vectype);
+  if (!VECTOR_MODE_P (mode))
+    return false;
+
+  /* CODE is needed on whole vectors both for combining the vector defs
+     of the SLP tree and for reducing with shifts.  */
+  optab op = optab_for_tree_code (code, vectype, optab_default);
+  if (!op || optab_handler (op, mode) == CODE_FOR_nothing)
+    return false;
+
+  reduction_code_for_scalar_code (code, reduc_code);
+  if (*reduc_code != ERROR_MARK)
+    {
+      op = optab_for_tree_code (*reduc_code, vectype, optab_default);
+      if (op && optab_handler (op, mode) != CODE_FOR_nothing)
+	return true;
+      *reduc_code = ERROR_MARK;
+    }
+
+  return have_whole_vector_shift (mode);
+}
+
+/* Find the final stmts of trees of reduction operations in the region of
+   BB_VINFO that have at least two operands computed in the region and
+   record them in BB_VINFO_REDUCTION_ROOTS.  */
+
+static void
+vect_slp_find_bb_reductions (bb_vec_info bb_vinfo)
+{
+  for (gimple_stmt_iterator gsi = bb_vinfo->region_begin;
+       gsi_stmt (gsi) != gsi_stmt (bb_vinfo->region_end); gsi_next (&gsi))
+    {
+      gimple *stmt = gsi_stmt (gsi);
+      if (!vect_bb_reduction_op_p (stmt))
+	continue;
+
+      /* Skip operations that feed a bigger tree.  */
+      enum tree_code code = gimple_assign_rhs_code (stmt);
+      use_operand_p use_p;
+      gimple *use_stmt;
+      if (single_imm_use (gimple_assign_lhs (stmt), &use_p, &use_stmt)
+	  && is_gimple_assign (use_stmt)
+	  && gimple_assign_rhs_code (use_stmt) == code
+	  && vect_stmt_in_region_p (bb_vinfo, use_stmt))
+	continue;
+
+      auto_vec<gimple *, 16> leaves;
+      auto_vec<tree, 4> externals;
+      vect_bb_reduction_operands (bb_vinfo, stmt, code, &leaves, &externals,
+				  NULL);
+      if (leaves.length () < 2)
+	continue;
+
+      if (dump_enabled_p ())
+	{
+	  dump_printf_loc (MSG_NOTE, vect_location,
+			   "Detected basic-block reduction with %d operands: ",
+			   leaves.length ());
+	  dump_gimple_stmt (MSG_NOTE, TDF_SLIM, stmt, 0);
+	}
+      BB_VINFO_REDUCTION_ROOTS (bb_vinfo).safe_push (stmt);
+    }
+}
+
 /* Compute the cost for the SLP node NODE in the SLP instance INSTANCE.  */
 
 static void
@@ -1712,6 +1842,21 @@ vect_analyze_slp_cost (slp_instance instance, void *data)
 			   &prologue_cost_vec, &body_cost_vec,
 			   ncopies_for_cost);
 
+  /* For a basic-block reduction account for combining the vector defs
+     of the root node and for reducing the result to a scalar.  */
+  if (gimple *root = SLP_INSTANCE_ROOT_STMT (instance))
+    {
+      enum tree_code reduc_code;
+      vect_bb_reduction_code (gimple_assign_rhs_code (root),
+			      STMT_VINFO_VECTYPE (stmt_info), &reduc_code);
+      unsigned reduc_cost = (reduc_code != ERROR_MARK
+			     ? 1 : 2 * exact_log2 (nunits));
+      record_stmt_cost (&body_cost_vec, ncopies_for_cost - 1 + reduc_cost,
+			vector_stmt, stmt_info, 0, vect_body);
+      record_stmt_cost (&body_cost_vec, 1, vec_to_scalar,
+			stmt_info, 0, vect_body);
+    }
+
   /* Record the prologue costs, which were delayed until we were
      sure that SLP was successful.  */
   FOR_EACH_VEC_ELT (prologue_cost_vec, i, si)
@@ -1802,6 +1947,10 @@ vect_analyze_slp_instance (vec_info *vinfo,
   vec<slp_tree> loads;
   struct data_reference *dr = STMT_VINFO_DATA_REF (vinfo_for_stmt (stmt));
   vec<gimple *> scalar_stmts;
+  bb_vec_info bb_vinfo = dyn_cast <bb_vec_info> (vinfo);
+  bool bb_reduction = false;
+  auto_vec<gimple *, 16> leaves;
+  auto_vec<tree, 4> externals;
 
   if (GROUP_FIRST_ELEMENT (vinfo_for_stmt (stmt)))
     {
@@ -1818,6 +1967,17 @@ vect_analyze_slp_instance (vec_info *vinfo,
 
       group_size = GROUP_SIZE (vinfo_for_stmt (stmt));
     }
+  else if (bb_vinfo)
+    {
+      /* STMT is the final stmt of a basic-block reduction.  The SLP tree
+	 is built from the stmts computing its operands.  */
+      bb_reduction = true;
+      scalar_type = TREE_TYPE (gimple_assign_lhs (stmt));
+      vectype = get_vectype_for_scalar_type (scalar_type);
+      vect_bb_reduction_operands (bb_vinfo, stmt, gimple_assign_rhs_code (stmt),
+				  &leaves, &externals, NULL);
+      group_size = leaves.length ();
+    }
   else
     {
       gcc_assert (is_a <loop_vec_info> (vinfo));
@@ -1839,6 +1999,20 @@ vect_analyze_slp_instance (vec_info *vinfo,
     }
   nunits = TYPE_VECTOR_SUBPARTS (vectype);
 
+  enum tree_code reduc_code;
+  if (bb_reduction
+      && !vect_bb_reduction_code (gimple_assign_rhs_code (stmt), vectype,
+				  &reduc_code))
+    {
+      if (dump_enabled_p ())
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "Build SLP failed: unsupported reduction ");
+	  dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
+	}
+      return false;
+    }
+
   /* Create a node (a root of the SLP tree) for the packed grouped stores.  */
   scalar_stmts.create (group_size);
   next = stmt;
@@ -1861,6 +2035,17 @@ vect_analyze_slp_instance (vec_info *vinfo,
       if (!STMT_VINFO_GROUPED_ACCESS (vinfo_for_stmt (stmt)))
 	STMT_VINFO_DEF_TYPE (vinfo_for_stmt (stmt)) = vect_reduction_def;
     }
+  else if (bb_reduction)
+    {
+      /* Collect the operands of the basic-block reduction.  */
+      FOR_EACH_VEC_ELT (leaves, i, next)
+	if (STMT_VINFO_IN_PATTERN_P (vinfo_for_stmt (next))
+	    && STMT_VINFO_RELATED_STMT (vinfo_for_stmt (next)))
+	  scalar_stmts.safe_push
+	    (STMT_VINFO_RELATED_STMT (vinfo_for_stmt (next)));
+	else
+	  scalar_stmts.safe_push (next);
+    }
   else
     {
       /* Collect reduction statements.  */
@@ -1910,6 +2095,7 @@ vect_analyze_slp_instance (vec_info *vinfo,
       SLP_INSTANCE_GROUP_SIZE (new_instance) = group_size;
       SLP_INSTANCE_UNROLLING_FACTOR (new_instance) = unrolling_factor;
       SLP_INSTANCE_LOADS (new_instance) = loads;
+      SLP_INSTANCE_ROOT_STMT (new_instance) = bb_reduction ? stmt : NULL;
 
       /* Compute the load permutation.  */
       slp_tree load_node;
@@ -2072,6 +2258,13 @@ vect_analyze_slp (vec_info *vinfo, unsigned max_tree_size)
     if (vect_analyze_slp_instance (vinfo, first_element, max_tree_size))
       ok = true;
 
+  /* Find SLP sequences starting from the operands of basic-block
+     reductions.  */
+  if (bb_vec_info bb_vinfo = dyn_cast <bb_vec_info> (vinfo))
+    FOR_EACH_VEC_ELT (BB_VINFO_REDUCTION_ROOTS (bb_vinfo), i, first_element)
+      if (vect_analyze_slp_instance (vinfo, first_element, max_tree_size))
+	ok = true;
+
   if (loop_vec_info loop_vinfo = dyn_cast <loop_vec_info> (vinfo))
     {
       if (loop_vinfo->reduction_chains.length () > 0)
@@ -2352,6 +2545,7 @@ destroy_bb_vec_info (bb_vec_info bb_vinfo)
   vect_destroy_datarefs (bb_vinfo);
   free_dependence_relations (BB_VINFO_DDRS (bb_vinfo));
   BB_VINFO_GROUPED_STORES (bb_vinfo).release ();
+  BB_VINFO_REDUCTION_ROOTS (bb_vinfo).release ();
   FOR_EACH_VEC_ELT (BB_VINFO_SLP_INSTANCES (bb_vinfo), i, instance)
     vect_free_slp_instance (instance);
   BB_VINFO_SLP_INSTANCES (bb_vinfo).release ();
@@ -2550,6 +2744,11 @@ vect_bb_vectorization_profitable_p (bb_vec_info bb_vinfo)
       scalar_cost += vect_bb_slp_scalar_cost (BB_VINFO_BB (bb_vinfo),
 					      SLP_INSTANCE_TREE (instance),
 					      &life);
+      /* The reduction operations of a basic-block reduction are
+	 replaced by the vector code as well.  */
+      if (SLP_INSTANCE_ROOT_STMT (instance))
+	scalar_cost += ((SLP_INSTANCE_GROUP_SIZE (instance) - 1)
+			* vect_get_stmt_cost (scalar_stmt));
     }
 
   /* Unset visited flag.  */
@@ -2653,15 +2852,18 @@ vect_slp_analyze_bb_1 (gimple_stmt_iterator region_begin,
       return NULL;
     }
 
-  /* If there are no grouped stores in the region there is no need
-     to continue with pattern recog as vect_analyze_slp will fail
+  vect_slp_find_bb_reductions (bb_vinfo);
+
+  /* If there are no grouped stores or reductions in the region there is
+     no need to continue with pattern recog as vect_analyze_slp will fail
      anyway.  */
-  if (bb_vinfo->grouped_stores.is_empty ())
+  if (bb_vinfo->grouped_stores.is_empty ()
+      && BB_VINFO_REDUCTION_ROOTS (bb_vinfo).is_empty ())
     {
       if (dump_enabled_p ())
 	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-			 "not vectorized: no grouped stores in "
-			 "basic block.\n");
+			 "not vectorized: no grouped stores or reductions "
+			 "in basic block.\n");
 
       destroy_bb_vec_info (bb_vinfo);
       return NULL;
@@ -2711,6 +2913,21 @@ vect_slp_analyze_bb_1 (gimple_stmt_iterator region_begin,
       vect_mark_slp_stmts (SLP_INSTANCE_TREE (instance), pure_slp, -1);
       vect_mark_slp_stmts_relevant (SLP_INSTANCE_TREE (instance));
 
+      /* So are the reduction operations of a basic-block reduction, which
+	 are replaced by the vector code too.  */
+      if (gimple *root = SLP_INSTANCE_ROOT_STMT (instance))
+	{
+	  auto_vec<gimple *, 16> leaves, chain;
+	  auto_vec<tree, 4> externals;
+	  gimple *stmt;
+	  unsigned j;
+	  vect_bb_reduction_operands (bb_vinfo, root,
+				      gimple_assign_rhs_code (root),
+				      &leaves, &externals, &chain);
+	  FOR_EACH_VEC_ELT (chain, j, stmt)
+	    STMT_SLP_TYPE (vinfo_for_stmt (stmt)) = pure_slp;
+	}
+
       i++;
     }
   if (! BB_VINFO_SLP_INSTANCES (bb_vinfo).length ())
@@ -3790,6 +4007,92 @@ vect_remove_slp_scalar_calls (slp_tree node)
     }
 }
 
+/* Reduce the vector defs of the root node of the basic-block reduction
+   INSTANCE to a scalar and replace the scalar reduction with it.  */
+
+static void
+vect_schedule_slp_bb_reduction (bb_vec_info bb_vinfo, slp_instance instance)
+{
+  gimple *root = SLP_INSTANCE_ROOT_STMT (instance);
+  enum tree_code code = gimple_assign_rhs_code (root), reduc_code;
+  tree scalar_type = TREE_TYPE (gimple_assign_lhs (root));
+  slp_tree node = SLP_INSTANCE_TREE (instance);
+  gimple_stmt_iterator gsi = gsi_for_stmt (root);
+  auto_vec<gimple *, 16> leaves;
+  auto_vec<tree, 4> externals;
+  gimple *new_stmt;
+  unsigned i;
+  tree op;
+
+  vect_bb_reduction_operands (bb_vinfo, root, code, &leaves, &externals,
+			      NULL);
+
+  /* Combine the vector defs of the root node.  */
+  tree vec_def = gimple_get_lhs (SLP_TREE_VEC_STMTS (node)[0]);
+  tree vectype = TREE_TYPE (vec_def);
+  for (i = 1; i < SLP_TREE_VEC_STMTS (node).length (); ++i)
+    {
+      new_stmt
+	= gimple_build_assign (make_ssa_name (vectype), code, vec_def,
+			       gimple_get_lhs (SLP_TREE_VEC_STMTS (node)[i]));
+      gsi_insert_before (&gsi, new_stmt, GSI_SAME_STMT);
+      vec_def = gimple_assign_lhs (new_stmt);
+    }
+
+  /* Reduce the vector to a scalar.  */
+  vect_bb_reduction_code (code, vectype, &reduc_code);
+  if (reduc_code != ERROR_MARK)
+    new_stmt = gimple_build_assign (make_ssa_name (scalar_type), reduc_code,
+				    vec_def);
+  else
+    {
+      machine_mode mode = TYPE_MODE (vectype);
+      unsigned nelt = TYPE_VECTOR_SUBPARTS (vectype);
+      unsigned char *sel = XALLOCAVEC (unsigned char, nelt);
+      tree zero_vec = build_zero_cst (vectype);
+      for (unsigned offset = nelt / 2; offset >= 1; offset /= 2)
+	{
+	  calc_vec_perm_mask_for_shift (mode, offset, sel);
+	  tree mask = vect_gen_perm_mask_any (vectype, sel);
+	  new_stmt = gimple_build_assign (make_ssa_name (vectype),
+					  VEC_PERM_EXPR, vec_def, zero_vec,
+					  mask);
+	  gsi_insert_before (&gsi, new_stmt, GSI_SAME_STMT);
+	  new_stmt = gimple_build_assign (make_ssa_name (vectype), code,
+					  vec_def, gimple_assign_lhs (new_stmt));
+	  gsi_insert_before (&gsi, new_stmt, GSI_SAME_STMT);
+	  vec_def = gimple_assign_lhs (new_stmt);
+	}
+      new_stmt = gimple_build_assign (make_ssa_name (scalar_type),
+				      build3 (BIT_FIELD_REF, scalar_type,
+					      vec_def,
+					      TYPE_SIZE (scalar_type),
+					      bitsize_zero_node));
+    }
+  gsi_insert_before (&gsi, new_stmt, GSI_SAME_STMT);
+  tree res = gimple_assign_lhs (new_stmt);
+
+  /* Add back the operands computed outside of the SLP tree.  */
+  FOR_EACH_VEC_ELT (externals, i, op)
+    {
+      new_stmt = gimple_build_assign (make_ssa_name (scalar_type), code,
+				      res, op);
+      gsi_insert_before (&gsi, new_stmt, GSI_SAME_STMT);
+      res = gimple_assign_lhs (new_stmt);
+    }
+
+  if (dump_enabled_p ())
+    {
+      dump_printf_loc (MSG_NOTE, vect_location,
+		       "replacing basic-block reduction ");
+      dump_gimple_stmt (MSG_NOTE, TDF_SLIM, root, 0);
+    }
+
+  /* The reduction operations feeding ROOT are now dead.  */
+  gimple_assign_set_rhs_from_tree (&gsi, res);
+  update_stmt (gsi_stmt (gsi));
+}
+
 /* Generate vector code for all SLP instances in the loop/basic block.  */
 
 bool
@@ -3833,6 +4136,15 @@ vect_schedule_slp (vec_info *vinfo)
       if (is_a <loop_vec_info> (vinfo))
 	vect_remove_slp_scalar_calls (root);
 
+      /* The root node of a basic-block reduction computes its operands,
+	 it is the reduction itself that is replaced.  */
+      if (SLP_INSTANCE_ROOT_STMT (instance))
+	{
+	  vect_schedule_slp_bb_reduction (as_a <bb_vec_info> (vinfo),
+					  instance);
+	  continue;
+	}
+
       for (j = 0; SLP_TREE_SCALAR_STMTS (root).iterate (j, &store)
                   && j < SLP_INSTANCE_GROUP_SIZE (instance); j++)
         {
@@ -467,8 +467,11 @@ process_use (gimple *stmt, tree use, loop_vec_info loop_vinfo,
   if (!vect_is_simple_use (use, loop_vinfo, &def_stmt, &dt))
     {
       if (dump_enabled_p ())
-        dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-                         "not vectorized: unsupported use in stmt.\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: unsupported use in stmt.\n");
+	  opt_record_reason ("unsupported-use");
+	}
       return false;
     }
 
@@ -934,6 +937,10 @@ vect_model_store_cost (stmt_vec_info stmt_info, int ncopies,
     inside_cost += record_stmt_cost (body_cost_vec,
 				     ncopies * TYPE_VECTOR_SUBPARTS (vectype),
 				     scalar_store, stmt_info, 0, vect_body);
+  else if (memory_access_type == VMAT_GATHER_SCATTER)
+    inside_cost += record_stmt_cost (body_cost_vec, ncopies,
+				     vector_scatter_store, stmt_info, 0,
+				     vect_body);
   else
     vect_get_store_cost (dr, ncopies, &inside_cost, body_cost_vec);
 
@@ -1064,6 +1071,10 @@ vect_model_load_cost (stmt_vec_info stmt_info, int ncopies,
 				       ncopies * TYPE_VECTOR_SUBPARTS (vectype),
 				       scalar_load, stmt_info, 0, vect_body);
     }
+  else if (memory_access_type == VMAT_GATHER_SCATTER)
+    inside_cost += record_stmt_cost (body_cost_vec, ncopies,
+				     vector_gather_load, stmt_info, 0,
+				     vect_body);
   else
     vect_get_load_cost (dr, ncopies, first_stmt_p,
 			&inside_cost, &prologue_cost, 
@@ -6451,7 +6462,12 @@ permute_vec_elements (tree x, tree y, tree mask_vec, gimple *stmt,
   tree perm_dest, data_ref;
   gimple *perm_stmt;
 
-  perm_dest = vect_create_destination_var (gimple_get_lhs (stmt), vectype);
+  /* STMT may be a scatter store, whose lhs is not an SSA name.  */
+  tree scalar_dest = gimple_get_lhs (stmt);
+  if (TREE_CODE (scalar_dest) == SSA_NAME)
+    perm_dest = vect_create_destination_var (scalar_dest, vectype);
+  else
+    perm_dest = vect_get_new_vect_var (vectype, vect_simple_var, NULL);
   data_ref = make_ssa_name (perm_dest);
 
   /* Generate the permute statement.  */
@@ -8367,8 +8383,11 @@ vect_analyze_stmt (gimple *stmt, bool *need_to_vectorize, slp_tree node)
   if (gimple_has_volatile_ops (stmt))
     {
       if (dump_enabled_p ())
-        dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
-                         "not vectorized: stmt has volatile operands\n");
+	{
+	  dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			   "not vectorized: stmt has volatile operands\n");
+	  opt_record_reason ("volatile-operands");
+	}
 
       return false;
     }
@@ -8571,6 +8590,7 @@ vect_analyze_stmt (gimple *stmt, bool *need_to_vectorize, slp_tree node)
         {
           dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                            "not vectorized: relevant stmt not ");
+	  opt_record_reason ("unsupported-stmt");
           dump_printf (MSG_MISSED_OPTIMIZATION, "supported: ");
           dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
         }
@@ -8593,6 +8613,7 @@ vect_analyze_stmt (gimple *stmt, bool *need_to_vectorize, slp_tree node)
         {
           dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
                            "not vectorized: live stmt not ");
+	  opt_record_reason ("unsupported-live-stmt");
           dump_printf (MSG_MISSED_OPTIMIZATION,  "supported: ");
           dump_gimple_stmt (MSG_MISSED_OPTIMIZATION, TDF_SLIM, stmt, 0);
         }
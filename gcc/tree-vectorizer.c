@@ -602,6 +602,8 @@ vectorize_loops (void)
 	loop_vectorized_call = vect_loop_vectorized_call (loop);
        vectorize_epilogue:
 	vect_location = find_loop_location (loop);
+	if (profile_status_for_fn (cfun) == PROFILE_READ)
+	  opt_record_default_hotness (loop->header->count);
         if (LOCATION_LOCUS (vect_location) != UNKNOWN_LOCATION
 	    && dump_enabled_p ())
 	  dump_printf (MSG_NOTE, "\nAnalyzing loop at %s:%d\n",
@@ -703,6 +705,9 @@ vectorize_loops (void)
 	if (loop_vectorized_call)
 	  {
 	    fold_loop_vectorized_call (loop_vectorized_call, boolean_true_node);
+	    /* The epilogue is if-converted in place and is not guarded
+	       by a LOOP_VECTORIZED call of its own.  */
+	    loop_vectorized_call = NULL;
 	    ret |= TODO_cleanup_cfg;
 	  }
 
@@ -127,6 +127,10 @@ typedef struct _slp_instance {
 
   /* The group of nodes that contain loads of this SLP instance.  */
   vec<slp_tree> loads;
+
+  /* For a basic-block reduction the scalar stmt computing the final
+     result of the reduction, NULL otherwise.  */
+  gimple *root_stmt;
 } *slp_instance;
 
 
@@ -135,6 +139,7 @@ typedef struct _slp_instance {
 #define SLP_INSTANCE_GROUP_SIZE(S)               (S)->group_size
 #define SLP_INSTANCE_UNROLLING_FACTOR(S)         (S)->unrolling_factor
 #define SLP_INSTANCE_LOADS(S)                    (S)->loads
+#define SLP_INSTANCE_ROOT_STMT(S)                (S)->root_stmt
 
 #define SLP_TREE_CHILDREN(S)                     (S)->children
 #define SLP_TREE_SCALAR_STMTS(S)                 (S)->stmts
@@ -418,6 +423,9 @@ typedef struct _bb_vec_info : public vec_info
   basic_block bb;
   gimple_stmt_iterator region_begin;
   gimple_stmt_iterator region_end;
+
+  /* Final stmts of trees of reduction operations in the region.  */
+  vec<gimple *> reduction_roots;
 } *bb_vec_info;
 
 #define BB_VINFO_BB(B)               (B)->bb
@@ -426,6 +434,7 @@ typedef struct _bb_vec_info : public vec_info
 #define BB_VINFO_DATAREFS(B)         (B)->datarefs
 #define BB_VINFO_DDRS(B)             (B)->ddrs
 #define BB_VINFO_TARGET_COST_DATA(B) (B)->target_cost_data
+#define BB_VINFO_REDUCTION_ROOTS(B)  (B)->reduction_roots
 
 static inline bb_vec_info
 vec_info_for_bb (basic_block bb)
@@ -1160,7 +1169,7 @@ extern tree vect_build_loop_niters (loop_vec_info);
 extern void vect_gen_vector_loop_niters (loop_vec_info, tree, tree *, bool);
 /* Drive for loop transformation stage.  */
 extern struct loop *vect_transform_loop (loop_vec_info);
-extern loop_vec_info vect_analyze_loop_form (struct loop *);
+extern loop_vec_info vect_analyze_loop_form (struct loop *, bool);
 extern bool vectorizable_live_operation (gimple *, gimple_stmt_iterator *,
 					 slp_tree, int, gimple **);
 extern bool vectorizable_reduction (gimple *, gimple_stmt_iterator *,
@@ -1172,6 +1181,10 @@ extern int vect_get_known_peeling_cost (loop_vec_info, int, int *,
 					stmt_vector_for_cost *,
 					stmt_vector_for_cost *,
 					stmt_vector_for_cost *);
+extern bool reduction_code_for_scalar_code (enum tree_code, enum tree_code *);
+extern void calc_vec_perm_mask_for_shift (enum machine_mode, unsigned int,
+					  unsigned char *);
+extern bool have_whole_vector_shift (enum machine_mode);
 
 /* In tree-vect-slp.c.  */
 extern void vect_free_slp_instance (slp_instance);
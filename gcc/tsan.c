@@ -38,6 +38,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-iterator.h"
 #include "tree-ssa-propagate.h"
 #include "tree-ssa-loop-ivopts.h"
+#include "tree-hash-traits.h"
 #include "tsan.h"
 #include "asan.h"
 #include "builtins.h"
@@ -89,6 +90,32 @@ is_vptr_store (gimple *stmt, tree expr, bool is_write)
   return NULL;
 }
 
+/* Return true if the memory accessed through the MEM_REF or
+   TARGET_MEM_REF BASE is only reachable from the current function,
+   like a malloced object whose address is never stored to memory or
+   passed to a call.  No other thread can access such memory.  */
+
+static bool
+local_mem_ref_p (tree base)
+{
+  if (TREE_CODE (base) != MEM_REF && TREE_CODE (base) != TARGET_MEM_REF)
+    return false;
+
+  tree ptr = TREE_OPERAND (base, 0);
+  if (TREE_CODE (ptr) != SSA_NAME)
+    return false;
+
+  struct ptr_info_def *pi = SSA_NAME_PTR_INFO (ptr);
+  if (pi == NULL)
+    return false;
+
+  struct pt_solution *pt = &pi->pt;
+  return (!pt->escaped
+	  && !pt->ipa_escaped
+	  && !pt->vars_contains_escaped
+	  && !pt_solution_includes_global (pt));
+}
+
 /* Instruments EXPR if needed. If any instrumentation is inserted,
    return true.  */
 
@@ -127,6 +154,10 @@ instrument_expr (gimple_stmt_iterator gsi, tree expr, bool is_write)
       if (!may_be_aliased (base))
 	return false;
     }
+  /* Likewise for memory that only pointers local to this function
+     point to.  */
+  else if (local_mem_ref_p (base))
+    return false;
 
   if (TREE_READONLY (base) || (VAR_P (base) && DECL_HARD_REGISTER (base)))
     return false;
@@ -681,11 +712,108 @@ instrument_builtin_call (gimple_stmt_iterator *gsi)
       }
 }
 
+/* A memory access of an assignment in a basic block, see
+   find_redundant_accesses.  */
+
+struct tsan_access
+{
+  gimple *stmt;
+  tree expr;
+  bool is_write;
+};
+
+/* Add the accesses in ACCESSES that don't need to be instrumented to
+   SKIP_READS and SKIP_WRITES.  ACCESSES are in program order and have
+   no synchronization in between, so they all happen at the same point
+   of the happens-before order: any race with one of them is a race
+   with every other access to the same location too, and with a write
+   to it in particular.  So only the first write to each location needs
+   to be instrumented, or the first read if there is no write.  */
+
+static void
+find_redundant_accesses_1 (vec<tsan_access> &accesses,
+			   hash_set<gimple *> *skip_reads,
+			   hash_set<gimple *> *skip_writes)
+{
+  if (accesses.length () < 2)
+    return;
+
+  hash_map<tree_operand_hash, unsigned int> first_read, first_write;
+  unsigned int i;
+  tsan_access *a;
+  FOR_EACH_VEC_ELT (accesses, i, a)
+    {
+      hash_map<tree_operand_hash, unsigned int> &first
+	= a->is_write ? first_write : first_read;
+      if (!first.get (a->expr))
+	first.put (a->expr, i);
+    }
+
+  FOR_EACH_VEC_ELT (accesses, i, a)
+    {
+      unsigned int *w = first_write.get (a->expr);
+      unsigned int keep = w ? *w : *first_read.get (a->expr);
+      if (i == keep)
+	continue;
+      if (a->is_write)
+	skip_writes->add (a->stmt);
+      else
+	skip_reads->add (a->stmt);
+    }
+}
+
+/* Find the loads and stores in BB whose instrumentation would be
+   redundant and add their statements to SKIP_READS and SKIP_WRITES.
+   Calls and asm statements might synchronize with other threads, so
+   accesses are only combined between them.  */
+
+static void
+find_redundant_accesses (basic_block bb, hash_set<gimple *> *skip_reads,
+			 hash_set<gimple *> *skip_writes)
+{
+  auto_vec<tsan_access, 16> accesses;
+
+  for (gimple_stmt_iterator gsi = gsi_start_bb (bb); !gsi_end_p (gsi);
+       gsi_next (&gsi))
+    {
+      gimple *stmt = gsi_stmt (gsi);
+      if (is_gimple_call (stmt) || gimple_code (stmt) == GIMPLE_ASM)
+	{
+	  find_redundant_accesses_1 (accesses, skip_reads, skip_writes);
+	  accesses.truncate (0);
+	  continue;
+	}
+      if (!is_gimple_assign (stmt) || gimple_clobber_p (stmt))
+	continue;
+
+      tsan_access a;
+      a.stmt = stmt;
+      if (gimple_store_p (stmt))
+	{
+	  a.expr = gimple_assign_lhs (stmt);
+	  a.is_write = true;
+	  /* Stores to the vptr are reported specially, keep them out.  */
+	  if (!is_vptr_store (stmt, a.expr, true))
+	    accesses.safe_push (a);
+	}
+      if (gimple_assign_load_p (stmt))
+	{
+	  a.expr = gimple_assign_rhs1 (stmt);
+	  a.is_write = false;
+	  accesses.safe_push (a);
+	}
+    }
+  find_redundant_accesses_1 (accesses, skip_reads, skip_writes);
+}
+
 /* Instruments the gimple pointed to by GSI. Return
-   true if func entry/exit should be instrumented.  */
+   true if func entry/exit should be instrumented.  Loads of statements
+   in SKIP_READS and stores of statements in SKIP_WRITES are left
+   alone.  */
 
 static bool
-instrument_gimple (gimple_stmt_iterator *gsi)
+instrument_gimple (gimple_stmt_iterator *gsi, hash_set<gimple *> *skip_reads,
+		   hash_set<gimple *> *skip_writes)
 {
   gimple *stmt;
   tree rhs, lhs;
@@ -707,12 +835,12 @@ instrument_gimple (gimple_stmt_iterator *gsi)
   else if (is_gimple_assign (stmt)
 	   && !gimple_clobber_p (stmt))
     {
-      if (gimple_store_p (stmt))
+      if (gimple_store_p (stmt) && !skip_writes->contains (stmt))
 	{
 	  lhs = gimple_assign_lhs (stmt);
 	  instrumented = instrument_expr (*gsi, lhs, true);
 	}
-      if (gimple_assign_load_p (stmt))
+      if (gimple_assign_load_p (stmt) && !skip_reads->contains (stmt))
 	{
 	  rhs = gimple_assign_rhs1 (stmt);
 	  instrumented = instrument_expr (*gsi, rhs, false);
@@ -773,22 +901,30 @@ instrument_memory_accesses (void)
   bool fentry_exit_instrument = false;
   bool func_exit_seen = false;
   auto_vec<gimple *> tsan_func_exits;
+  hash_set<gimple *> skip_reads, skip_writes;
 
   FOR_EACH_BB_FN (bb, cfun)
-    for (gsi = gsi_start_bb (bb); !gsi_end_p (gsi); gsi_next (&gsi))
-      {
-	gimple *stmt = gsi_stmt (gsi);
-	if (gimple_call_internal_p (stmt, IFN_TSAN_FUNC_EXIT))
-	  {
-	    if (fentry_exit_instrument)
-	      replace_func_exit (stmt);
-	    else
-	      tsan_func_exits.safe_push (stmt);
-	    func_exit_seen = true;
-	  }
-	else
-	  fentry_exit_instrument |= instrument_gimple (&gsi);
-      }
+    {
+      skip_reads.empty ();
+      skip_writes.empty ();
+      find_redundant_accesses (bb, &skip_reads, &skip_writes);
+
+      for (gsi = gsi_start_bb (bb); !gsi_end_p (gsi); gsi_next (&gsi))
+	{
+	  gimple *stmt = gsi_stmt (gsi);
+	  if (gimple_call_internal_p (stmt, IFN_TSAN_FUNC_EXIT))
+	    {
+	      if (fentry_exit_instrument)
+		replace_func_exit (stmt);
+	      else
+		tsan_func_exits.safe_push (stmt);
+	      func_exit_seen = true;
+	    }
+	  else
+	    fentry_exit_instrument |= instrument_gimple (&gsi, &skip_reads,
+							 &skip_writes);
+	}
+    }
   unsigned int i;
   gimple *stmt;
   FOR_EACH_VEC_ELT (tsan_func_exits, i, stmt)
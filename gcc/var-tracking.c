@@ -566,6 +566,10 @@ struct variable_tracking_info
   /* Has the block been flooded in VTA?  */
   bool flooded;
 
+  /* Has the IN set of the block exceeded PARAM_MAX_VARTRACK_BB_SIZE, so
+     that the block starts with an empty IN set?  */
+  bool cut;
+
 };
 
 /* Alloc pool for struct attrs_def.  */
@@ -7006,6 +7010,7 @@ vt_find_locations (void)
   int i;
   int htabsz = 0;
   int htabmax = PARAM_VALUE (PARAM_MAX_VARTRACK_SIZE);
+  int bbmax = PARAM_VALUE (PARAM_MAX_VARTRACK_BB_SIZE);
   bool success = true;
 
   timevar_push (TV_VAR_TRACKING_DATAFLOW);
@@ -7114,6 +7119,24 @@ vt_find_locations (void)
 		    dataflow_set_union (&VTI (bb)->in, &VTI (e->src)->out);
 		}
 
+	      /* Rather than let the sets grow without bound, cut the CFG
+		 at blocks whose IN set gets too large and track the
+		 variables after the cut from scratch, as at the entry of
+		 the function.  Once cut a block stays cut, so the IN set
+		 still only changes a bounded number of times.  */
+	      if (bbmax
+		  && !VTI (bb)->cut
+		  && ((int) shared_hash_htab (VTI (bb)->in.vars)->elements ()
+		      > bbmax))
+		{
+		  VTI (bb)->cut = true;
+		  if (dump_file)
+		    fprintf (dump_file, "BB %i: IN set exceeds %i variables, "
+			     "cutting\n", bb->index, bbmax);
+		}
+	      if (VTI (bb)->cut)
+		dataflow_set_clear (&VTI (bb)->in);
+
 	      changed = compute_bb_dataflow (bb);
 	      htabsz += shared_hash_htab (VTI (bb)->in.vars)->size ()
 			 + shared_hash_htab (VTI (bb)->out.vars)->size ();
@@ -9921,6 +9944,7 @@ vt_initialize (void)
     {
       VTI (bb)->visited = false;
       VTI (bb)->flooded = false;
+      VTI (bb)->cut = false;
       dataflow_set_init (&VTI (bb)->in);
       dataflow_set_init (&VTI (bb)->out);
       VTI (bb)->permp = NULL;
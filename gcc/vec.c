@@ -42,6 +42,11 @@ along with GCC; see the file COPYING3.  If not see
    they cannot have ctors/dtors.  */
 vnull vNULL;
 
+/* State of the -fmem-profile sampler.  The countdown never runs out
+   unless the profiler is started.  */
+size_t mem_profile_countdown = (size_t) -1;
+void (*mem_profile_hook) (enum mem_profile_kind, size_t);
+
 /* Vector memory usage.  */
 struct vec_usage: public mem_usage
 {
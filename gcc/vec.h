@@ -31,6 +31,34 @@ extern void ggc_free (void *);
 extern size_t ggc_round_alloc_size (size_t requested_size);
 extern void *ggc_realloc (void *, size_t MEM_STAT_DECL);
 
+/* Hook of the sampled allocation-site profiler of -fmem-profile (see
+   mem-profile.c).  MEM_PROFILE_COUNTDOWN is the number of bytes which
+   can still be allocated before the next sample; the allocation which
+   exhausts it calls MEM_PROFILE_HOOK.  They are defined in vec.c, so
+   that the gen* programs, which do not have the profiler, still link.  */
+
+enum mem_profile_kind
+{
+  MEM_PROFILE_GGC,
+  MEM_PROFILE_HEAP,
+  MEM_PROFILE_POOL,
+  MEM_PROFILE_KINDS
+};
+
+extern size_t mem_profile_countdown;
+extern void (*mem_profile_hook) (enum mem_profile_kind, size_t);
+
+/* Account for an allocation of SIZE bytes of kind KIND.  */
+
+static inline void
+mem_profile_alloc (enum mem_profile_kind kind, size_t size)
+{
+  if (__builtin_expect (size < mem_profile_countdown, 1))
+    mem_profile_countdown -= size;
+  else
+    mem_profile_hook (kind, size);
+}
+
 /* Templated vector type and associated interfaces.
 
    The interface functions are typesafe and use inline functions,
@@ -285,6 +313,7 @@ va_heap::reserve (vec<T, va_heap, vl_embed> *&v, unsigned reserve, bool exact
 
   size_t size = vec<T, va_heap, vl_embed>::embedded_size (alloc);
   unsigned nelem = v ? v->length () : 0;
+  mem_profile_alloc (MEM_PROFILE_HEAP, size);
   v = static_cast <vec<T, va_heap, vl_embed> *> (xrealloc (v, size));
   v->embedded_init (alloc, nelem);
 
@@ -138,9 +138,12 @@ along with GCC; see the file COPYING3.  If not see
 #include "backend.h"
 #include "tree.h"
 #include "gimple.h"
+#include "cfghooks.h"
 #include "tree-pass.h"
 #include "ssa.h"
+#include "predict.h"
 #include "gimple-iterator.h"
+#include "cfgloop.h"
 
 #include "vtable-verify.h"
 
@@ -627,6 +630,109 @@ var_is_used_for_virtual_call_p (tree lhs, int *mem_ref_depth,
   return false;
 }
 
+/* The verification call CALL_STMT checks the vtable pointer VPTR,
+   loaded by the statement at GSI, against the set in the vtable map
+   variable MAP_VAR.  When the set holds a single vtable pointer,
+   libvtv stores it in MAP_VAR directly as that (even) pointer plus
+   one, so the common case of a class with no derived classes can be
+   checked without a call.  Split the block after the load and emit
+
+     if (((uintptr_t) MAP_VAR ^ ((uintptr_t) VPTR + 1))
+         | ((uintptr_t) VPTR & 1)) == 0)
+       RESULT = VPTR;
+     else
+       RESULT = CALL_STMT;
+
+   The low bit test keeps an odd VPTR from matching a set pointer or
+   a set handle handle.  All uses of VPTR must already have been
+   replaced with RESULT.  */
+
+static void
+insert_singleton_fast_path (gimple_stmt_iterator *gsi, tree map_var,
+			    tree vptr, gcall *call_stmt, tree result)
+{
+  gimple *stmt = gsi_stmt (*gsi);
+  tree uptr = pointer_sized_int_node;
+  tree map_val, vptr_val, key, diff, low_bit, cond_val, call_result;
+  gimple *g;
+
+  /* Split the block after the vtable pointer load.  */
+  edge e = split_block (gsi_bb (*gsi), stmt);
+  basic_block cond_bb = e->src;
+  basic_block join_bb = e->dest;
+  basic_block call_bb = create_empty_bb (cond_bb);
+  if (current_loops)
+    {
+      add_bb_to_loop (call_bb, cond_bb->loop_father);
+      loops_state_set (LOOPS_NEED_FIXUP);
+    }
+
+  /* The fast path skips the call.  */
+  edge fast_e = e;
+  fast_e->flags = EDGE_TRUE_VALUE;
+  fast_e->probability = PROB_EVEN;
+  fast_e->count = apply_probability (cond_bb->count, PROB_EVEN);
+
+  e = make_edge (cond_bb, call_bb, EDGE_FALSE_VALUE);
+  e->probability = REG_BR_PROB_BASE - PROB_EVEN;
+  e->count = cond_bb->count - fast_e->count;
+  call_bb->frequency = EDGE_FREQUENCY (e);
+  call_bb->count = e->count;
+
+  edge call_e = make_single_succ_edge (call_bb, join_bb, EDGE_FALLTHRU);
+
+  if (dom_info_available_p (CDI_DOMINATORS))
+    set_immediate_dominator (CDI_DOMINATORS, call_bb, cond_bb);
+
+  /* Build the singleton test at the end of the condition block.  */
+  gimple_stmt_iterator cond_gsi = gsi_last_bb (cond_bb);
+
+  map_val = make_ssa_name (TREE_TYPE (map_var));
+  g = gimple_build_assign (map_val, map_var);
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+
+  g = gimple_build_assign (make_ssa_name (uptr), NOP_EXPR, map_val);
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+  map_val = gimple_assign_lhs (g);
+
+  g = gimple_build_assign (make_ssa_name (uptr), NOP_EXPR, vptr);
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+  vptr_val = gimple_assign_lhs (g);
+
+  g = gimple_build_assign (make_ssa_name (uptr), PLUS_EXPR, vptr_val,
+			   build_int_cst (uptr, 1));
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+  key = gimple_assign_lhs (g);
+
+  g = gimple_build_assign (make_ssa_name (uptr), BIT_XOR_EXPR, map_val, key);
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+  diff = gimple_assign_lhs (g);
+
+  g = gimple_build_assign (make_ssa_name (uptr), BIT_AND_EXPR, vptr_val,
+			   build_int_cst (uptr, 1));
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+  low_bit = gimple_assign_lhs (g);
+
+  g = gimple_build_assign (make_ssa_name (uptr), BIT_IOR_EXPR, diff, low_bit);
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+  cond_val = gimple_assign_lhs (g);
+
+  g = gimple_build_cond (EQ_EXPR, cond_val, build_zero_cst (uptr),
+			 NULL_TREE, NULL_TREE);
+  gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+
+  /* Fall back to the library call for everything else.  */
+  call_result = make_temp_ssa_name (TREE_TYPE (result), NULL, "VTV");
+  gimple_call_set_lhs (call_stmt, call_result);
+  update_stmt (call_stmt);
+  gimple_stmt_iterator call_gsi = gsi_start_bb (call_bb);
+  gsi_insert_after (&call_gsi, call_stmt, GSI_NEW_STMT);
+
+  gphi *phi = create_phi_node (result, join_bb);
+  add_phi_arg (phi, vptr, fast_e, UNKNOWN_LOCATION);
+  add_phi_arg (phi, call_result, call_e, UNKNOWN_LOCATION);
+}
+
 /* Search through all the statements in a basic block (BB), searching
    for virtual method calls.  For each virtual method dispatch, find
    the vptr value used, and the statically declared type of the
@@ -778,15 +884,26 @@ verify_bb_vtables (basic_block bb)
 
                   gcc_assert (found);
 
+                  any_verification_calls_generated = true;
+                  total_num_verified_vcalls++;
+
                   /* Insert the new verification call just after the
                      statement that gets the vtable pointer out of the
                      object.  */
                   gcc_assert (gsi_stmt (gsi_vtbl_assign) == stmt);
-                  gsi_insert_after (&gsi_vtbl_assign, call_stmt,
-                                    GSI_NEW_STMT);
-
-                  any_verification_calls_generated = true;
-                  total_num_verified_vcalls++;
+                  if (flag_vtv_debug)
+                    gsi_insert_after (&gsi_vtbl_assign, call_stmt,
+                                      GSI_NEW_STMT);
+                  else
+                    {
+                      /* Check for a singleton set inline; the rest
+                         of BB has moved to a new block, which the
+                         caller will visit later.  */
+                      insert_singleton_fast_path (&gsi_vtbl_assign,
+                                                  vtbl_var_decl, lhs,
+                                                  call_stmt, tmp0);
+                      return;
+                    }
                 }
             }
         }
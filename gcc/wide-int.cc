@@ -2247,6 +2247,44 @@ test_ops ()
   assert_deceq ("4", a - b, SIGNED);
   assert_deceq ("-4", b - a, SIGNED);
   assert_deceq ("21", a * b, SIGNED);
+
+  /* Division and modulus, including the negative operands that take
+     the single-HWI fast paths.  */
+  assert_deceq ("2", wi::sdiv_trunc (a, b), SIGNED);
+  assert_deceq ("-2", wi::sdiv_trunc (-a, b), SIGNED);
+  assert_deceq ("1", wi::smod_trunc (a, b), SIGNED);
+  assert_deceq ("-1", wi::smod_trunc (-a, b), SIGNED);
+  assert_deceq ("2", wi::udiv_trunc (a, b), UNSIGNED);
+  assert_deceq ("1", wi::umod_trunc (a, b), UNSIGNED);
+}
+
+/* Verify that multiplication and division of small-precision values
+   report overflow correctly.  */
+
+static void
+test_small_precision_overflow ()
+{
+  bool overflow;
+
+  wide_int a = wi::shwi (100, 8);
+  wide_int b = wi::shwi (2, 8);
+  wi::mul (a, b, SIGNED, &overflow);
+  ASSERT_TRUE (overflow);
+  wi::mul (a, b, UNSIGNED, &overflow);
+  ASSERT_FALSE (overflow);
+  assert_deceq ("-56", wi::mul (a, b), SIGNED);
+
+  wide_int c = wi::shwi (-128, 8);
+  wide_int m1 = wi::shwi (-1, 8);
+  wi::div_trunc (c, m1, SIGNED, &overflow);
+  ASSERT_TRUE (overflow);
+  assert_deceq ("0", wi::div_trunc (c, m1, UNSIGNED, &overflow), UNSIGNED);
+  ASSERT_FALSE (overflow);
+
+  widest_int d = widest_int (-3);
+  assert_deceq ("-9", wi::mul (d, widest_int (3)), SIGNED);
+  wi::mul (d, d, UNSIGNED, &overflow);
+  ASSERT_TRUE (overflow);
 }
 
 /* Verify that various comparisons work correctly for VALUE_TYPE.  */
@@ -2310,6 +2348,7 @@ wide_int_cc_tests ()
  run_all_wide_int_tests <wide_int> ();
  run_all_wide_int_tests <offset_int> ();
  run_all_wide_int_tests <widest_int> ();
+ test_small_precision_overflow ();
 }
 
 } // namespace selftest
@@ -2450,6 +2450,15 @@ wi::mul (const T1 &x, const T2 &y)
       val[0] = xi.ulow () * yi.ulow ();
       result.set_len (1);
     }
+  /* Multiplying two half-width values cannot exceed a single HWI,
+     which is the common case for offset_int and widest_int.  */
+  else if (xi.len == 1 && yi.len == 1
+	   && sext_hwi (xi.val[0], HOST_BITS_PER_WIDE_INT / 2) == xi.val[0]
+	   && sext_hwi (yi.val[0], HOST_BITS_PER_WIDE_INT / 2) == yi.val[0])
+    {
+      val[0] = xi.val[0] * yi.val[0];
+      result.set_len (1);
+    }
   else
     result.set_len (mul_internal (val, xi.val, xi.len, yi.val, yi.len,
 				  precision, UNSIGNED, 0, false));
@@ -2466,9 +2475,41 @@ wi::mul (const T1 &x, const T2 &y, signop sgn, bool *overflow)
   unsigned int precision = get_precision (result);
   WIDE_INT_REF_FOR (T1) xi (x, precision);
   WIDE_INT_REF_FOR (T2) yi (y, precision);
-  result.set_len (mul_internal (val, xi.val, xi.len,
-				yi.val, yi.len, precision,
-				sgn, overflow, false));
+  if (precision <= HOST_BITS_PER_WIDE_INT / 2)
+    {
+      /* The exact product fits in a HWI, so overflow is simply a
+	 matter of whether it survives truncation to PRECISION.  */
+      if (sgn == SIGNED)
+	{
+	  HOST_WIDE_INT res = xi.to_shwi () * yi.to_shwi ();
+	  if (overflow)
+	    *overflow = sext_hwi (res, precision) != res;
+	  val[0] = res;
+	}
+      else
+	{
+	  unsigned HOST_WIDE_INT res = xi.to_uhwi () * yi.to_uhwi ();
+	  if (overflow)
+	    *overflow = zext_hwi (res, precision) != res;
+	  val[0] = res;
+	}
+      result.set_len (1);
+    }
+  else if (precision > HOST_BITS_PER_WIDE_INT
+	   && xi.len == 1 && yi.len == 1
+	   && sext_hwi (xi.val[0], HOST_BITS_PER_WIDE_INT / 2) == xi.val[0]
+	   && sext_hwi (yi.val[0], HOST_BITS_PER_WIDE_INT / 2) == yi.val[0]
+	   && (sgn == SIGNED || (xi.val[0] >= 0 && yi.val[0] >= 0)))
+    {
+      val[0] = xi.val[0] * yi.val[0];
+      if (overflow)
+	*overflow = false;
+      result.set_len (1);
+    }
+  else
+    result.set_len (mul_internal (val, xi.val, xi.len,
+				  yi.val, yi.len, precision,
+				  sgn, overflow, false));
   return result;
 }
 
@@ -2506,6 +2547,25 @@ wi::mul_high (const T1 &x, const T2 &y, signop sgn)
   return result;
 }
 
+namespace wi
+{
+  /* Return true if dividing XI by YI with signedness SGN can be done
+     directly on the host: both operands are single HWIs whose values
+     are the HWIs themselves and the division cannot overflow.  */
+  template <typename T1, typename T2>
+  inline bool
+  single_hwi_divmod_p (const T1 &xi, const T2 &yi, signop sgn)
+  {
+    if (xi.len != 1 || yi.len != 1)
+      return false;
+    if (sgn == SIGNED)
+      return yi.to_shwi () != 0 && yi.to_shwi () != -1;
+    return ((xi.precision <= HOST_BITS_PER_WIDE_INT || xi.val[0] >= 0)
+	    && (yi.precision <= HOST_BITS_PER_WIDE_INT || yi.val[0] >= 0)
+	    && yi.to_uhwi () != 0);
+  }
+}
+
 /* Return X / Y, rouding towards 0.  Treat X and Y as having the
    signedness given by SGN.  Indicate in *OVERFLOW if the result
    overflows.  */
@@ -2518,6 +2578,18 @@ wi::div_trunc (const T1 &x, const T2 &y, signop sgn, bool *overflow)
   WIDE_INT_REF_FOR (T1) xi (x, precision);
   WIDE_INT_REF_FOR (T2) yi (y);
 
+  if (wi::single_hwi_divmod_p (xi, yi, sgn))
+    {
+      if (sgn == SIGNED)
+	quotient_val[0] = xi.to_shwi () / yi.to_shwi ();
+      else
+	quotient_val[0] = xi.to_uhwi () / yi.to_uhwi ();
+      quotient.set_len (1);
+      if (overflow)
+	*overflow = false;
+      return quotient;
+    }
+
   quotient.set_len (divmod_internal (quotient_val, 0, 0, xi.val, xi.len,
 				     precision,
 				     yi.val, yi.len, yi.precision,
@@ -2708,6 +2780,18 @@ wi::mod_trunc (const T1 &x, const T2 &y, signop sgn, bool *overflow)
   WIDE_INT_REF_FOR (T1) xi (x, precision);
   WIDE_INT_REF_FOR (T2) yi (y);
 
+  if (wi::single_hwi_divmod_p (xi, yi, sgn))
+    {
+      if (sgn == SIGNED)
+	remainder_val[0] = xi.to_shwi () % yi.to_shwi ();
+      else
+	remainder_val[0] = xi.to_uhwi () % yi.to_uhwi ();
+      remainder.set_len (1);
+      if (overflow)
+	*overflow = false;
+      return remainder;
+    }
+
   unsigned int remainder_len;
   divmod_internal (0, &remainder_len, remainder_val,
 		   xi.val, xi.len, precision,
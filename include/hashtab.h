@@ -132,8 +132,12 @@ struct htab {
   htab_free_with_arg free_with_arg_f;
 
   /* Current size (in entries) of the hash table, as an index into the
-     table of primes.  */
+     table of primes.  Unused by linear probing tables.  */
   unsigned int size_prime_index;
+
+  /* For tables created by htab_create_linear_alloc, the hash value of
+     the element in each entry, and NULL otherwise.  */
+  hashval_t *hashes;
 };
 
 typedef struct htab *htab_t;
@@ -155,6 +159,11 @@ extern htab_t	htab_create_alloc_ex (size_t, htab_hash,
 extern htab_t  htab_create_typed_alloc (size_t, htab_hash, htab_eq, htab_del,
 					htab_alloc, htab_alloc, htab_free);
 
+extern htab_t	htab_create_linear_alloc (size_t, htab_hash,
+					  htab_eq, htab_del,
+					  htab_alloc, htab_free);
+extern htab_t	htab_create_linear (size_t, htab_hash, htab_eq, htab_del);
+
 /* Backward-compatibility functions.  */
 extern htab_t htab_create (size_t, htab_hash, htab_eq, htab_del);
 extern htab_t htab_try_create (size_t, htab_hash, htab_eq, htab_del);
@@ -189,6 +198,9 @@ extern htab_hash htab_hash_pointer;
 /* An equality function for pointers.  */
 extern htab_eq htab_eq_pointer;
 
+/* Scramble the bits of a hash value.  */
+extern hashval_t htab_hash_mix (hashval_t);
+
 /* A hash function for null-terminated strings.  */
 extern hashval_t htab_hash_string (const void *);
 
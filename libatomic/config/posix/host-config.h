@@ -52,4 +52,21 @@ protect_end (void *ptr, UWORD dummy UNUSED)
 # endif
 #endif /* protect_start_end */
 
+/* Optimistic reading for a "large" operation.  The caller copies the
+   object after libat_read_begin_n and keeps the copy if
+   libat_read_validate_n then succeeds; otherwise it takes the locks.  */
+#ifndef optimistic_read_n
+# ifdef HAVE_ATTRIBUTE_VISIBILITY
+#  pragma GCC visibility push(hidden)
+# endif
+
+UWORD libat_read_begin_n (void *ptr, size_t n);
+bool libat_read_validate_n (void *ptr, size_t n, UWORD);
+
+# define optimistic_read_n 1
+# ifdef HAVE_ATTRIBUTE_VISIBILITY
+#  pragma GCC visibility pop
+# endif
+#endif /* optimistic_read_n */
+
 #include_next <host-config.h>
@@ -45,15 +45,29 @@
 #define WATCH_SIZE	CACHLINE_SIZE
 #endif
 
+/* The number of locks.  Objects are mapped onto the locks by their
+   offset within a page, so that a page mapped at two addresses still
+   uses the same locks; the count must therefore divide the number of
+   watched lines in a page.  Fewer locks save memory at the cost of
+   more contention between unrelated objects.  */
+#ifndef NLOCKS
+#define NLOCKS		(PAGE_SIZE / WATCH_SIZE)
+#endif
+
+#if (PAGE_SIZE / WATCH_SIZE) % NLOCKS != 0
+#error "NLOCKS must divide PAGE_SIZE / WATCH_SIZE"
+#endif
+
+/* Each lock carries a sequence count, odd while a thread holds the
+   lock and has possibly started to write, so that large loads can
+   copy the object optimistically and check afterwards whether it
+   changed under them.  Each lock gets a cache line of its own.  */
 struct lock
 {
   pthread_mutex_t mutex;
-  char pad[sizeof(pthread_mutex_t) < CACHLINE_SIZE
-	   ? CACHLINE_SIZE - sizeof(pthread_mutex_t)
-	   : 0];
-};
+  UWORD seq;
+} __attribute__ ((aligned (CACHLINE_SIZE)));
 
-#define NLOCKS		(PAGE_SIZE / WATCH_SIZE)
 static struct lock locks[NLOCKS] = {
   [0 ... NLOCKS-1].mutex = PTHREAD_MUTEX_INITIALIZER
 };
@@ -64,16 +78,37 @@ addr_hash (void *ptr)
   return ((uintptr_t)ptr / WATCH_SIZE) % NLOCKS;
 }
 
+/* Mark the start and end of a possible write under lock L.  */
+
+static inline void
+seq_write_begin (struct lock *l)
+{
+  __atomic_store_n (&l->seq, l->seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+static inline void
+seq_write_end (struct lock *l)
+{
+  __atomic_store_n (&l->seq, l->seq + 1, __ATOMIC_RELEASE);
+}
+
 void
 libat_lock_1 (void *ptr)
 {
-  pthread_mutex_lock (&locks[addr_hash (ptr)].mutex);
+  struct lock *l = &locks[addr_hash (ptr)];
+
+  pthread_mutex_lock (&l->mutex);
+  seq_write_begin (l);
 }
 
 void
 libat_unlock_1 (void *ptr)
 {
-  pthread_mutex_unlock (&locks[addr_hash (ptr)].mutex);
+  struct lock *l = &locks[addr_hash (ptr)];
+
+  seq_write_end (l);
+  pthread_mutex_unlock (&l->mutex);
 }
 
 void
@@ -83,12 +118,13 @@ libat_lock_n (void *ptr, size_t n)
   size_t i = 0;
 
   /* Don't lock more than all the locks we have.  */
-  if (n > PAGE_SIZE)
-    n = PAGE_SIZE;
+  if (n > NLOCKS * WATCH_SIZE)
+    n = NLOCKS * WATCH_SIZE;
 
   do
     {
       pthread_mutex_lock (&locks[h].mutex);
+      seq_write_begin (&locks[h]);
       if (++h == NLOCKS)
 	h = 0;
       i += WATCH_SIZE;
@@ -102,11 +138,12 @@ libat_unlock_n (void *ptr, size_t n)
   uintptr_t h = addr_hash (ptr);
   size_t i = 0;
 
-  if (n > PAGE_SIZE)
-    n = PAGE_SIZE;
+  if (n > NLOCKS * WATCH_SIZE)
+    n = NLOCKS * WATCH_SIZE;
 
   do
     {
+      seq_write_end (&locks[h]);
       pthread_mutex_unlock (&locks[h].mutex);
       if (++h == NLOCKS)
 	h = 0;
@@ -114,3 +151,62 @@ libat_unlock_n (void *ptr, size_t n)
     }
   while (i < n);
 }
+
+/* Begin an optimistic read of the N bytes at PTR.  Return the sum of
+   the sequence counts of the locks that libat_lock_n would take, or 1
+   if one of them is held for writing.  The counts only grow, so the
+   sum is unchanged exactly when none of them changed.  */
+
+UWORD
+libat_read_begin_n (void *ptr, size_t n)
+{
+  uintptr_t h = addr_hash (ptr);
+  size_t i = 0;
+  UWORD sum = 0;
+
+  if (n > NLOCKS * WATCH_SIZE)
+    n = NLOCKS * WATCH_SIZE;
+
+  do
+    {
+      UWORD seq = __atomic_load_n (&locks[h].seq, __ATOMIC_ACQUIRE);
+      if (seq & 1)
+	return 1;
+      sum += seq;
+      if (++h == NLOCKS)
+	h = 0;
+      i += WATCH_SIZE;
+    }
+  while (i < n);
+
+  return sum;
+}
+
+/* Return true if nothing was written to the N bytes at PTR since
+   libat_read_begin_n returned SUM, so that what was read in between
+   is a consistent copy.  */
+
+bool
+libat_read_validate_n (void *ptr, size_t n, UWORD sum)
+{
+  uintptr_t h = addr_hash (ptr);
+  size_t i = 0;
+
+  if (sum & 1)
+    return false;
+
+  if (n > NLOCKS * WATCH_SIZE)
+    n = NLOCKS * WATCH_SIZE;
+
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  do
+    {
+      sum -= __atomic_load_n (&locks[h].seq, __ATOMIC_RELAXED);
+      if (++h == NLOCKS)
+	h = 0;
+      i += WATCH_SIZE;
+    }
+  while (i < n);
+
+  return sum == 0;
+}
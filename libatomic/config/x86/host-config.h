@@ -28,29 +28,38 @@
 extern unsigned int libat_feat1_ecx HIDDEN;
 extern unsigned int libat_feat1_edx HIDDEN;
 
+/* On x86_64, the first alternative also uses AVX for 16-byte loads and
+   stores; init.c only leaves bit_AVX set on processors known to make
+   them atomic.  */
 #ifdef __x86_64__
-# define IFUNC_COND_1	(libat_feat1_ecx & bit_CMPXCHG16B)
+# define IFUNC_COND_1	((libat_feat1_ecx & (bit_AVX | bit_CMPXCHG16B)) \
+			 == (bit_AVX | bit_CMPXCHG16B))
+# define IFUNC_COND_2	(libat_feat1_ecx & bit_CMPXCHG16B)
 #else
 # define IFUNC_COND_1	(libat_feat1_edx & bit_CMPXCHG8B)
 #endif
 
 #ifdef __x86_64__
-# define IFUNC_NCOND(N) (N == 16)
+# define IFUNC_NCOND(N) (2 * (N == 16))
 #else
 # define IFUNC_NCOND(N) (N == 8)
 #endif
 
 #ifdef __x86_64__
 # undef MAYBE_HAVE_ATOMIC_CAS_16
-# define MAYBE_HAVE_ATOMIC_CAS_16	IFUNC_COND_1
+# define MAYBE_HAVE_ATOMIC_CAS_16	IFUNC_COND_2
 # undef MAYBE_HAVE_ATOMIC_EXCHANGE_16
-# define MAYBE_HAVE_ATOMIC_EXCHANGE_16	IFUNC_COND_1
+# define MAYBE_HAVE_ATOMIC_EXCHANGE_16	IFUNC_COND_2
 # undef MAYBE_HAVE_ATOMIC_LDST_16
-# define MAYBE_HAVE_ATOMIC_LDST_16	IFUNC_COND_1
-# if IFUNC_ALT == 1
+# define MAYBE_HAVE_ATOMIC_LDST_16	IFUNC_COND_2
+# if IFUNC_ALT != 0
 #  undef HAVE_ATOMIC_CAS_16
 #  define HAVE_ATOMIC_CAS_16 1
 # endif
+# if IFUNC_ALT == 1
+#  undef HAVE_ATOMIC_LDST_16
+#  define HAVE_ATOMIC_LDST_16 1
+# endif
 #else
 # undef MAYBE_HAVE_ATOMIC_CAS_8
 # define MAYBE_HAVE_ATOMIC_CAS_8	IFUNC_COND_1
@@ -66,4 +75,31 @@ extern unsigned int libat_feat1_edx HIDDEN;
 
 #endif /* HAVE_IFUNC */
 
+#if defined(__x86_64__) && IFUNC_ALT == 1 && N == 16
+/* An aligned 16-byte vmovdqa is single-copy atomic here.  Unlike a load
+   done with cmpxchg16b, it does not take the cache line exclusive, so
+   concurrent readers do not contend.  */
+static inline U_16
+atomic_load_n (U_16 *mptr, int smodel UNUSED)
+{
+  U_16 ret;
+
+  __asm__ __volatile__ ("vmovdqa\t{%1, %0|%0, %1}"
+			: "=x" (ret) : "m" (*mptr) : "memory");
+  return ret;
+}
+
+static inline void
+atomic_store_n (U_16 *mptr, U_16 val, int smodel)
+{
+  __asm__ __volatile__ ("vmovdqa\t{%1, %0|%0, %1}"
+			: "=m" (*mptr) : "x" (val) : "memory");
+  if (smodel == __ATOMIC_SEQ_CST)
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+}
+
+# define atomic_load_n atomic_load_n
+# define atomic_store_n atomic_store_n
+#endif
+
 #include_next <host-config.h>
@@ -31,8 +31,20 @@ unsigned int libat_feat1_ecx, libat_feat1_edx;
 static void __attribute__((constructor))
 init_cpuid (void)
 {
-  unsigned int eax, ebx;
+  unsigned int eax, ebx, ecx, edx;
   __get_cpuid (1, &eax, &ebx, &libat_feat1_ecx, &libat_feat1_edx);
+
+#ifdef __x86_64__
+  /* Intel and AMD document aligned 16-byte loads and stores as atomic on
+     their processors with AVX; nobody else does, so only keep bit_AVX,
+     which selects them, for those two.  */
+  if (libat_feat1_ecx & bit_AVX)
+    {
+      __cpuid (0, eax, ebx, ecx, edx);
+      if (ecx != signature_INTEL_ecx && ecx != signature_AMD_ecx)
+	libat_feat1_ecx &= ~bit_AVX;
+    }
+#endif
 }
 
 #endif /* HAVE_IFUNC */
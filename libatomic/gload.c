@@ -89,6 +89,30 @@ libat_load (size_t n, void *mptr, void *rptr, int smodel)
     }
 
   pre_seq_barrier (smodel);
+
+#ifdef optimistic_read_n
+  /* Most large objects are read far more often than written; copy the
+     object without taking the locks, and only take them if a writer
+     got in the way.  A seq_cst load must still be ordered after all
+     earlier seq_cst operations of this thread.  */
+  {
+    UWORD seq;
+
+    if (smodel == __ATOMIC_SEQ_CST)
+      __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    seq = libat_read_begin_n (mptr, n);
+    if ((seq & 1) == 0)
+      {
+	memcpy (rptr, mptr, n);
+	if (libat_read_validate_n (mptr, n, seq))
+	  {
+	    post_seq_barrier (smodel);
+	    return;
+	  }
+      }
+  }
+#endif
+
   libat_lock_n (mptr, n);
 
   memcpy (rptr, mptr, n);
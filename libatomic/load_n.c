@@ -31,12 +31,12 @@ UTYPE
 SIZE(libat_load) (UTYPE *mptr, int smodel)
 {
   if (maybe_specialcase_relaxed(smodel))
-    return __atomic_load_n (mptr, __ATOMIC_RELAXED);
+    return atomic_load_n (mptr, __ATOMIC_RELAXED);
   else if (maybe_specialcase_acqrel(smodel))
     /* Note that REL and ACQ_REL are not valid for loads.  */
-    return __atomic_load_n (mptr, __ATOMIC_ACQUIRE);
+    return atomic_load_n (mptr, __ATOMIC_ACQUIRE);
   else
-    return __atomic_load_n (mptr, __ATOMIC_SEQ_CST);
+    return atomic_load_n (mptr, __ATOMIC_SEQ_CST);
 }
 
 #define DONE 1
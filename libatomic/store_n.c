@@ -31,12 +31,12 @@ void
 SIZE(libat_store) (UTYPE *mptr, UTYPE newval, int smodel)
 {
   if (maybe_specialcase_relaxed(smodel))
-    __atomic_store_n (mptr, newval, __ATOMIC_RELAXED);
+    atomic_store_n (mptr, newval, __ATOMIC_RELAXED);
   else if (maybe_specialcase_acqrel(smodel))
     /* Note that ACQ and ACQ_REL are not valid for store.  */
-    __atomic_store_n (mptr, newval, __ATOMIC_RELEASE);
+    atomic_store_n (mptr, newval, __ATOMIC_RELEASE);
   else
-    __atomic_store_n (mptr, newval, __ATOMIC_SEQ_CST);
+    atomic_store_n (mptr, newval, __ATOMIC_SEQ_CST);
 }
 
 #define DONE 1
@@ -285,6 +285,16 @@ struct unit
   int is_dwarf64;
   /* Address size.  */
   int addrsize;
+  /* Offset of the abbreviations for this unit in .debug_abbrev.  */
+  uint64_t abbrev_offset;
+  /* Nonzero if the address ranges of this unit were taken from
+     .debug_aranges.  In that case the abbreviations and the compilation
+     unit DIE are not read during initialization, and LINEOFF, FILENAME,
+     COMP_DIR and ABBREVS are not set here.  They are read by
+     read_unit_die into a copy of the unit when the line information is
+     first needed; FILENAME and COMP_DIR are then stored back, like the
+     fields below.  */
+  int lazy;
   /* Offset into line number information.  */
   off_t lineoff;
   /* Primary source file.  */
@@ -352,6 +362,9 @@ struct dwarf_data
   /* The unparsed .debug_info section.  */
   const unsigned char *dwarf_info;
   size_t dwarf_info_size;
+  /* The unparsed .debug_abbrev section.  */
+  const unsigned char *dwarf_abbrev;
+  size_t dwarf_abbrev_size;
   /* The unparsed .debug_line section.  */
   const unsigned char *dwarf_line;
   size_t dwarf_line_size;
@@ -921,6 +934,10 @@ unit_addrs_compare (const void *v1, const void *v2)
     return -1;
   if (a1->u->lineoff > a2->u->lineoff)
     return 1;
+  if (a1->u->unit_data < a2->u->unit_data)
+    return -1;
+  if (a1->u->unit_data > a2->u->unit_data)
+    return 1;
   return 0;
 }
 
@@ -1395,6 +1412,225 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
   return 1;
 }
 
+/* Compare two .debug_info offsets for qsort and bsearch.  */
+
+static int
+info_offset_compare (const void *v1, const void *v2)
+{
+  const uint64_t *o1 = (const uint64_t *) v1;
+  const uint64_t *o2 = (const uint64_t *) v2;
+
+  if (*o1 < *o2)
+    return -1;
+  if (*o1 > *o2)
+    return 1;
+  return 0;
+}
+
+/* Read the header of the compilation unit at OFFSET in .debug_info,
+   and return a new lazily initialized unit for it.  Returns NULL on
+   failure.  */
+
+static struct unit *
+read_lazy_unit (struct backtrace_state *state,
+		const unsigned char *dwarf_info, size_t dwarf_info_size,
+		uint64_t offset, int is_bigendian,
+		backtrace_error_callback error_callback, void *data)
+{
+  struct dwarf_buf unit_buf;
+  uint64_t len;
+  int is_dwarf64;
+  int version;
+  uint64_t abbrev_offset;
+  int addrsize;
+  struct unit *u;
+
+  if (offset >= dwarf_info_size)
+    {
+      error_callback (data, ".debug_aranges unit offset out of range", 0);
+      return NULL;
+    }
+
+  unit_buf.name = ".debug_info";
+  unit_buf.start = dwarf_info;
+  unit_buf.buf = dwarf_info + offset;
+  unit_buf.left = dwarf_info_size - offset;
+  unit_buf.is_bigendian = is_bigendian;
+  unit_buf.error_callback = error_callback;
+  unit_buf.data = data;
+  unit_buf.reported_underflow = 0;
+
+  is_dwarf64 = 0;
+  len = read_uint32 (&unit_buf);
+  if (len == 0xffffffff)
+    {
+      len = read_uint64 (&unit_buf);
+      is_dwarf64 = 1;
+    }
+  if (len > unit_buf.left)
+    {
+      dwarf_buf_error (&unit_buf, "unit length out of range");
+      return NULL;
+    }
+  unit_buf.left = len;
+
+  version = read_uint16 (&unit_buf);
+  if (version < 2 || version > 4)
+    {
+      dwarf_buf_error (&unit_buf, "unrecognized DWARF version");
+      return NULL;
+    }
+
+  abbrev_offset = read_offset (&unit_buf, is_dwarf64);
+  addrsize = read_byte (&unit_buf);
+  if (unit_buf.reported_underflow)
+    return NULL;
+
+  u = ((struct unit *)
+       backtrace_alloc (state, sizeof *u, error_callback, data));
+  if (u == NULL)
+    return NULL;
+  memset (u, 0, sizeof *u);
+  u->unit_data = unit_buf.buf;
+  u->unit_data_len = unit_buf.left;
+  u->unit_data_offset = unit_buf.buf - (dwarf_info + offset);
+  u->version = version;
+  u->is_dwarf64 = is_dwarf64;
+  u->addrsize = addrsize;
+  u->abbrev_offset = abbrev_offset;
+  u->lazy = 1;
+  return u;
+}
+
+/* Read the .debug_aranges section, which lists the address ranges of
+   the compilation units, and add them to ADDRS.  Only the headers of
+   the compilation units are read (see read_lazy_unit), so this is much
+   cheaper than walking the DIEs in .debug_info.  The .debug_info
+   offsets of the units that were found are stored in OFFSETS, sorted.
+   Returns 1 on success, 0 on failure.  */
+
+static int
+read_aranges (struct backtrace_state *state, uintptr_t base_address,
+	      const unsigned char *dwarf_info, size_t dwarf_info_size,
+	      const unsigned char *dwarf_aranges, size_t dwarf_aranges_size,
+	      int is_bigendian, backtrace_error_callback error_callback,
+	      void *data, struct unit_addrs_vector *addrs,
+	      struct backtrace_vector *offsets, size_t *offsets_count)
+{
+  struct dwarf_buf aranges_buf;
+  int sorted;
+
+  aranges_buf.name = ".debug_aranges";
+  aranges_buf.start = dwarf_aranges;
+  aranges_buf.buf = dwarf_aranges;
+  aranges_buf.left = dwarf_aranges_size;
+  aranges_buf.is_bigendian = is_bigendian;
+  aranges_buf.error_callback = error_callback;
+  aranges_buf.data = data;
+  aranges_buf.reported_underflow = 0;
+
+  sorted = 1;
+  while (aranges_buf.left > 0)
+    {
+      const unsigned char *set_start;
+      uint64_t len;
+      int is_dwarf64;
+      struct dwarf_buf set_buf;
+      int version;
+      uint64_t info_offset;
+      int addrsize;
+      int segsize;
+      size_t tuple_size;
+      size_t header_size;
+      struct unit *u;
+      uint64_t *poffset;
+
+      if (aranges_buf.reported_underflow)
+	return 0;
+
+      set_start = aranges_buf.buf;
+
+      is_dwarf64 = 0;
+      len = read_uint32 (&aranges_buf);
+      if (len == 0xffffffff)
+	{
+	  len = read_uint64 (&aranges_buf);
+	  is_dwarf64 = 1;
+	}
+
+      set_buf = aranges_buf;
+      set_buf.left = len;
+
+      if (!advance (&aranges_buf, len))
+	return 0;
+
+      version = read_uint16 (&set_buf);
+      if (version != 2)
+	{
+	  dwarf_buf_error (&set_buf, "unrecognized .debug_aranges version");
+	  return 0;
+	}
+
+      info_offset = read_offset (&set_buf, is_dwarf64);
+      addrsize = read_byte (&set_buf);
+      segsize = read_byte (&set_buf);
+      if (segsize != 0 || (addrsize != 4 && addrsize != 8))
+	{
+	  dwarf_buf_error (&set_buf, "unsupported .debug_aranges layout");
+	  return 0;
+	}
+
+      /* The address tuples start at a multiple of their size.  */
+      tuple_size = 2 * (size_t) addrsize;
+      header_size = (size_t) (set_buf.buf - set_start);
+      if (header_size % tuple_size != 0
+	  && !advance (&set_buf, tuple_size - header_size % tuple_size))
+	return 0;
+
+      u = read_lazy_unit (state, dwarf_info, dwarf_info_size, info_offset,
+			  is_bigendian, error_callback, data);
+      if (u == NULL)
+	return 0;
+
+      while (set_buf.left > 0)
+	{
+	  struct unit_addrs a;
+	  uint64_t length;
+
+	  a.low = read_address (&set_buf, addrsize);
+	  length = read_address (&set_buf, addrsize);
+	  if (set_buf.reported_underflow)
+	    return 0;
+	  if (a.low == 0 && length == 0)
+	    break;
+	  if (length == 0)
+	    continue;
+	  a.high = a.low + length;
+	  a.u = u;
+	  if (!add_unit_addr (state, base_address, a, error_callback, data,
+			      addrs))
+	    return 0;
+	}
+
+      if (*offsets_count > 0
+	  && info_offset < ((uint64_t *) offsets->base)[*offsets_count - 1])
+	sorted = 0;
+      poffset = ((uint64_t *)
+		 backtrace_vector_grow (state, sizeof (uint64_t),
+					error_callback, data, offsets));
+      if (poffset == NULL)
+	return 0;
+      *poffset = info_offset;
+      ++*offsets_count;
+    }
+
+  if (!sorted)
+    backtrace_qsort (offsets->base, *offsets_count, sizeof (uint64_t),
+		     info_offset_compare);
+
+  return 1;
+}
+
 /* Build a mapping from address ranges to the compilation units where
    the line number information for that range can be found.  Returns 1
    on success, 0 on failure.  */
@@ -1405,18 +1641,42 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
 		   const unsigned char *dwarf_abbrev, size_t dwarf_abbrev_size,
 		   const unsigned char *dwarf_ranges, size_t dwarf_ranges_size,
 		   const unsigned char *dwarf_str, size_t dwarf_str_size,
+		   const unsigned char *dwarf_aranges,
+		   size_t dwarf_aranges_size,
 		   int is_bigendian, backtrace_error_callback error_callback,
 		   void *data, struct unit_addrs_vector *addrs)
 {
   struct dwarf_buf info;
   struct abbrevs abbrevs;
+  struct backtrace_vector offsets;
+  size_t offsets_count;
 
   memset (&addrs->vec, 0, sizeof addrs->vec);
   addrs->count = 0;
 
-  /* Read through the .debug_info section.  FIXME: Should we use the
-     .debug_aranges section?  gdb and addr2line don't use it, but I'm
-     not sure why.  */
+  /* If there is a .debug_aranges section, take the address ranges of
+     the compilation units listed there from it, and only read their
+     DIEs when we need their line information.  For large programs,
+     this saves most of the time and memory spent here.  */
+
+  memset (&offsets, 0, sizeof offsets);
+  offsets_count = 0;
+  if (dwarf_aranges_size > 0
+      && !read_aranges (state, base_address, dwarf_info, dwarf_info_size,
+			dwarf_aranges, dwarf_aranges_size, is_bigendian,
+			error_callback, data, addrs, &offsets,
+			&offsets_count))
+    {
+      /* Fall back to reading all of .debug_info.  */
+      free_unit_addrs_vector (state, addrs, error_callback, data);
+      memset (&addrs->vec, 0, sizeof addrs->vec);
+      addrs->count = 0;
+      offsets_count = 0;
+    }
+
+  /* Read through the .debug_info section, for the units that are not
+     covered by .debug_aranges.  Some producers do not emit
+     .debug_aranges at all, or not for all units.  */
 
   info.name = ".debug_info";
   info.start = dwarf_info;
@@ -1458,6 +1718,16 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
       if (!advance (&info, len))
 	goto fail;
 
+      if (offsets_count > 0)
+	{
+	  uint64_t offset;
+
+	  offset = (uint64_t) (unit_data_start - dwarf_info);
+	  if (bsearch (&offset, offsets.base, offsets_count,
+		       sizeof (uint64_t), info_offset_compare) != NULL)
+	    continue;
+	}
+
       version = read_uint16 (&unit_buf);
       if (version < 2 || version > 4)
 	{
@@ -1482,6 +1752,8 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
       u->version = version;
       u->is_dwarf64 = is_dwarf64;
       u->addrsize = addrsize;
+      u->abbrev_offset = abbrev_offset;
+      u->lazy = 0;
       u->filename = NULL;
       u->comp_dir = NULL;
       u->abs_filename = NULL;
@@ -1516,9 +1788,15 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   if (info.reported_underflow)
     goto fail;
 
+  if (offsets.base != NULL)
+    backtrace_free (state, offsets.base, offsets.size + offsets.alc,
+		    error_callback, data);
   return 1;
 
  fail:
+  if (offsets.base != NULL)
+    backtrace_free (state, offsets.base, offsets.size + offsets.alc,
+		    error_callback, data);
   free_abbrevs (state, &abbrevs, error_callback, data);
   free_unit_addrs_vector (state, addrs, error_callback, data);
   return 0;
@@ -2631,6 +2909,82 @@ report_inlined_functions (uintptr_t pc, struct function *function,
   return 0;
 }
 
+/* Read the abbreviations and the compilation unit DIE of a unit whose
+   address ranges were taken from .debug_aranges, filling in the fields
+   of U that read_line_info and read_function_info need.  Returns 1 on
+   success, 0 on failure.  On failure, the caller must still free
+   U->ABBREVS.  */
+
+static int
+read_unit_die (struct backtrace_state *state, struct dwarf_data *ddata,
+	       struct unit *u, backtrace_error_callback error_callback,
+	       void *data)
+{
+  struct dwarf_buf unit_buf;
+  uint64_t code;
+  const struct abbrev *abbrev;
+  size_t i;
+
+  if (!read_abbrevs (state, u->abbrev_offset, ddata->dwarf_abbrev,
+		     ddata->dwarf_abbrev_size, ddata->is_bigendian,
+		     error_callback, data, &u->abbrevs))
+    return 0;
+
+  unit_buf.name = ".debug_info";
+  unit_buf.start = ddata->dwarf_info;
+  unit_buf.buf = u->unit_data;
+  unit_buf.left = u->unit_data_len;
+  unit_buf.is_bigendian = ddata->is_bigendian;
+  unit_buf.error_callback = error_callback;
+  unit_buf.data = data;
+  unit_buf.reported_underflow = 0;
+
+  code = read_uleb128 (&unit_buf);
+  if (code == 0)
+    return 0;
+
+  abbrev = lookup_abbrev (&u->abbrevs, code, error_callback, data);
+  if (abbrev == NULL)
+    return 0;
+
+  if (abbrev->tag != DW_TAG_compile_unit)
+    return 0;
+
+  for (i = 0; i < abbrev->num_attrs; ++i)
+    {
+      struct attr_val val;
+
+      if (!read_attribute (abbrev->attrs[i].form, &unit_buf,
+			   u->is_dwarf64, u->version, u->addrsize,
+			   ddata->dwarf_str, ddata->dwarf_str_size, &val))
+	return 0;
+
+      switch (abbrev->attrs[i].name)
+	{
+	case DW_AT_stmt_list:
+	  if (val.encoding == ATTR_VAL_UINT
+	      || val.encoding == ATTR_VAL_REF_SECTION)
+	    u->lineoff = val.u.uint;
+	  break;
+
+	case DW_AT_name:
+	  if (val.encoding == ATTR_VAL_STRING)
+	    u->filename = val.u.string;
+	  break;
+
+	case DW_AT_comp_dir:
+	  if (val.encoding == ATTR_VAL_STRING)
+	    u->comp_dir = val.u.string;
+	  break;
+
+	default:
+	  break;
+	}
+    }
+
+  return !unit_buf.reported_underflow;
+}
+
 /* Look for a PC in the DWARF mapping for one module.  On success,
    call CALLBACK and return whatever it returns.  On error, call
    ERROR_CALLBACK and return 0.  Sets *FOUND to 1 if the PC is found,
@@ -2711,14 +3065,38 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
       size_t function_addrs_count;
       struct line_header lhdr;
       size_t count;
+      struct unit lazy_u;
+      struct unit *ru;
 
       /* We have never read the line information for this unit.  Read
 	 it now.  */
 
       function_addrs = NULL;
       function_addrs_count = 0;
-      if (read_line_info (state, ddata, error_callback, data, entry->u, &lhdr,
-			  &lines, &count))
+
+      /* If we have not read the compilation unit DIE yet, read it into
+	 a copy of the unit, so that threads doing this simultaneously
+	 do not interfere with each other.  */
+      ru = entry->u;
+      if (ru->lazy)
+	{
+	  lazy_u = *ru;
+	  memset (&lazy_u.abbrevs, 0, sizeof lazy_u.abbrevs);
+	  ru = &lazy_u;
+	  if (!read_unit_die (state, ddata, ru, error_callback, data))
+	    {
+	      free_abbrevs (state, &ru->abbrevs, error_callback, data);
+	      ru = NULL;
+	    }
+	}
+
+      if (ru == NULL)
+	{
+	  lines = (struct line *) (uintptr_t) -1;
+	  count = 0;
+	}
+      else if (read_line_info (state, ddata, error_callback, data, ru, &lhdr,
+			       &lines, &count))
 	{
 	  struct function_vector *pfvec;
 
@@ -2729,12 +3107,31 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 	  else
 	    pfvec = &ddata->fvec;
 	  read_function_info (state, ddata, &lhdr, error_callback, data,
-			      entry->u, pfvec, &function_addrs,
+			      ru, pfvec, &function_addrs,
 			      &function_addrs_count);
 	  free_line_header (state, &lhdr, error_callback, data);
 	  new_data = 1;
 	}
 
+      /* The abbreviations of a lazily read unit are not needed any
+	 more, but its file name may be, if the line information does
+	 not cover the whole unit.  Several threads may store the same
+	 values here.  */
+      if (ru == &lazy_u)
+	{
+	  free_abbrevs (state, &lazy_u.abbrevs, error_callback, data);
+	  if (!state->threaded)
+	    {
+	      u->filename = lazy_u.filename;
+	      u->comp_dir = lazy_u.comp_dir;
+	    }
+	  else
+	    {
+	      backtrace_atomic_store_pointer (&u->filename, lazy_u.filename);
+	      backtrace_atomic_store_pointer (&u->comp_dir, lazy_u.comp_dir);
+	    }
+	}
+
       /* Atomically store the information we just read into the unit.
 	 If another thread is simultaneously writing, it presumably
 	 read the same information, and we don't care which one we
@@ -2920,6 +3317,8 @@ build_dwarf_data (struct backtrace_state *state,
 		  size_t dwarf_ranges_size,
 		  const unsigned char *dwarf_str,
 		  size_t dwarf_str_size,
+		  const unsigned char *dwarf_aranges,
+		  size_t dwarf_aranges_size,
 		  int is_bigendian,
 		  backtrace_error_callback error_callback,
 		  void *data)
@@ -2927,11 +3326,14 @@ build_dwarf_data (struct backtrace_state *state,
   struct unit_addrs_vector addrs_vec;
   struct unit_addrs *addrs;
   size_t addrs_count;
+  size_t i;
+  size_t j;
   struct dwarf_data *fdata;
 
   if (!build_address_map (state, base_address, dwarf_info, dwarf_info_size,
 			  dwarf_abbrev, dwarf_abbrev_size, dwarf_ranges,
 			  dwarf_ranges_size, dwarf_str, dwarf_str_size,
+			  dwarf_aranges, dwarf_aranges_size,
 			  is_bigendian, error_callback, data, &addrs_vec))
     return NULL;
 
@@ -2942,6 +3344,27 @@ build_dwarf_data (struct backtrace_state *state,
   backtrace_qsort (addrs, addrs_count, sizeof (struct unit_addrs),
 		   unit_addrs_compare);
 
+  /* Merge ranges of the same unit that have become adjacent or
+     overlapping after sorting, to make the binary search in
+     dwarf_lookup_pc faster.  Only merge if the merged range does not
+     reach into the next range, so that lookups find the same unit as
+     before.  */
+  j = 0;
+  for (i = 1; i < addrs_count; ++i)
+    {
+      uint64_t high;
+
+      high = addrs[i].high > addrs[j].high ? addrs[i].high : addrs[j].high;
+      if (addrs[i].u == addrs[j].u
+	  && addrs[i].low <= addrs[j].high
+	  && (i + 1 >= addrs_count || addrs[i + 1].low >= high))
+	addrs[j].high = high;
+      else
+	addrs[++j] = addrs[i];
+    }
+  if (addrs_count > 0)
+    addrs_count = j + 1;
+
   fdata = ((struct dwarf_data *)
 	   backtrace_alloc (state, sizeof (struct dwarf_data),
 			    error_callback, data));
@@ -2954,6 +3377,8 @@ build_dwarf_data (struct backtrace_state *state,
   fdata->addrs_count = addrs_count;
   fdata->dwarf_info = dwarf_info;
   fdata->dwarf_info_size = dwarf_info_size;
+  fdata->dwarf_abbrev = dwarf_abbrev;
+  fdata->dwarf_abbrev_size = dwarf_abbrev_size;
   fdata->dwarf_line = dwarf_line;
   fdata->dwarf_line_size = dwarf_line_size;
   fdata->dwarf_ranges = dwarf_ranges;
@@ -2983,6 +3408,8 @@ backtrace_dwarf_add (struct backtrace_state *state,
 		     size_t dwarf_ranges_size,
 		     const unsigned char *dwarf_str,
 		     size_t dwarf_str_size,
+		     const unsigned char *dwarf_aranges,
+		     size_t dwarf_aranges_size,
 		     int is_bigendian,
 		     backtrace_error_callback error_callback,
 		     void *data, fileline *fileline_fn)
@@ -2992,7 +3419,8 @@ backtrace_dwarf_add (struct backtrace_state *state,
   fdata = build_dwarf_data (state, base_address, dwarf_info, dwarf_info_size,
 			    dwarf_line, dwarf_line_size, dwarf_abbrev,
 			    dwarf_abbrev_size, dwarf_ranges, dwarf_ranges_size,
-			    dwarf_str, dwarf_str_size, is_bigendian,
+			    dwarf_str, dwarf_str_size, dwarf_aranges,
+			    dwarf_aranges_size, is_bigendian,
 			    error_callback, data);
   if (fdata == NULL)
     return 0;
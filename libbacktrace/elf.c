@@ -32,9 +32,12 @@ POSSIBILITY OF SUCH DAMAGE.  */
 
 #include "config.h"
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef HAVE_DL_ITERATE_PHDR
 #include <link.h>
@@ -103,8 +106,12 @@ dl_iterate_phdr (int (*callback) (struct dl_phdr_info *,
 #undef SHT_SYMTAB
 #undef SHT_STRTAB
 #undef SHT_DYNSYM
+#undef SHT_NOTE
+#undef SHF_COMPRESSED
 #undef STT_OBJECT
 #undef STT_FUNC
+#undef NT_GNU_BUILD_ID
+#undef ELFCOMPRESS_ZLIB
 
 /* Basic types.  */
 
@@ -193,8 +200,11 @@ typedef struct {
 
 #define SHT_SYMTAB 2
 #define SHT_STRTAB 3
+#define SHT_NOTE 7
 #define SHT_DYNSYM 11
 
+#define SHF_COMPRESSED 0x800
+
 #if BACKTRACE_ELF_SIZE == 32
 
 typedef struct
@@ -224,6 +234,45 @@ typedef struct
 #define STT_OBJECT 1
 #define STT_FUNC 2
 
+typedef struct
+{
+  b_elf_word n_namesz;			/* Length of the name */
+  b_elf_word n_descsz;			/* Length of the descriptor */
+  b_elf_word n_type;			/* Type of the note */
+  char name[1];				/* Start of the name field */
+} b_elf_note;  /* Elf_Nhdr.  */
+
+#define NT_GNU_BUILD_ID 3
+
+#if BACKTRACE_ELF_SIZE == 32
+
+typedef struct
+{
+  b_elf_word	ch_type;		/* Compresstion algorithm */
+  b_elf_word	ch_size;		/* Uncompressed size */
+  b_elf_word	ch_addralign;		/* Alignment for uncompressed data */
+} b_elf_chdr;  /* Elf_Chdr.  */
+
+#else /* BACKTRACE_ELF_SIZE != 32 */
+
+typedef struct
+{
+  b_elf_word	ch_type;		/* Compression algorithm */
+  b_elf_word	ch_reserved;		/* Reserved */
+  b_elf_xword	ch_size;		/* Uncompressed size */
+  b_elf_xword	ch_addralign;		/* Alignment for uncompressed data */
+} b_elf_chdr;  /* Elf_Chdr.  */
+
+#endif /* BACKTRACE_ELF_SIZE != 32 */
+
+#define ELFCOMPRESS_ZLIB 1
+
+/* The directory in which we look for separate debug info files by
+   build ID, and the one in which we look for them by debuglink.  */
+
+#define SYSTEM_BUILD_ID_DIR "/usr/lib/debug/.build-id/"
+#define SYSTEM_DEBUG_DIR "/usr/lib/debug"
+
 /* An index of ELF sections we care about.  */
 
 enum debug_section
@@ -233,6 +282,7 @@ enum debug_section
   DEBUG_ABBREV,
   DEBUG_RANGES,
   DEBUG_STR,
+  DEBUG_ARANGES,
   DEBUG_MAX
 };
 
@@ -244,7 +294,8 @@ static const char * const debug_section_names[DEBUG_MAX] =
   ".debug_line",
   ".debug_abbrev",
   ".debug_ranges",
-  ".debug_str"
+  ".debug_str",
+  ".debug_aranges"
 };
 
 /* Information we gather for the sections we care about.  */
@@ -257,6 +308,10 @@ struct debug_section_info
   size_t size;
   /* Section contents, after read from file.  */
   const unsigned char *data;
+  /* Whether the section has the SHF_COMPRESSED flag.  */
+  int compressed;
+  /* Whether this is a .zdebug section.  */
+  int zdebug;
 };
 
 /* Information we keep for an ELF symbol.  */
@@ -307,6 +362,592 @@ elf_nosyms (struct backtrace_state *state ATTRIBUTE_UNUSED,
   error_callback (data, "no symbol table in ELF executable", -1);
 }
 
+/* Inflating zlib streams, used for compressed debug sections.  This is
+   a straightforward implementation of RFC 1950 and RFC 1951; we do not
+   use zlib itself because libbacktrace must not depend on other
+   libraries.  Huffman codes of up to ELF_ZLIB_FAST_BITS bits are
+   decoded with a table lookup, longer ones bit by bit.  */
+
+#define ELF_ZLIB_FAST_BITS 9
+#define ELF_ZLIB_MAX_BITS 15
+
+/* A Huffman code.  */
+
+struct elf_zlib_huffman
+{
+  /* The number of codes of each length.  */
+  uint16_t count[ELF_ZLIB_MAX_BITS + 1];
+  /* The symbols, ordered by their codes.  */
+  uint16_t symbol[288];
+  /* For the codes of at most ELF_ZLIB_FAST_BITS bits, indexed by the
+     code read LSB first: the symbol shifted left by 4, ored with the
+     length of the code.  Zero for longer codes.  */
+  uint16_t fast[1 << ELF_ZLIB_FAST_BITS];
+};
+
+/* The state of the inflater.  */
+
+struct elf_zlib_state
+{
+  /* Input.  */
+  const unsigned char *pin;
+  const unsigned char *pinend;
+  /* Bits read from the input but not consumed yet, LSB first.  */
+  uint64_t val;
+  unsigned int bits;
+  /* Output.  */
+  unsigned char *pout;
+  unsigned char *poutstart;
+  unsigned char *poutend;
+  /* The codes of the current block, and the one used to read the code
+     lengths of a dynamic block.  */
+  struct elf_zlib_huffman lencode;
+  struct elf_zlib_huffman distcode;
+  struct elf_zlib_huffman codelencode;
+};
+
+/* Make sure that at least 56 bits are available in S->VAL, unless
+   the input ends first.  */
+
+static void
+elf_zlib_fill (struct elf_zlib_state *s)
+{
+  while (s->bits <= 56 && s->pin < s->pinend)
+    {
+      s->val |= (uint64_t) *s->pin++ << s->bits;
+      s->bits += 8;
+    }
+}
+
+/* Consume and return COUNT bits, or return -1 at the end of input.  */
+
+static int
+elf_zlib_bits (struct elf_zlib_state *s, unsigned int count)
+{
+  int ret;
+
+  if (s->bits < count)
+    {
+      elf_zlib_fill (s);
+      if (s->bits < count)
+	return -1;
+    }
+  ret = (int) (s->val & ((1U << count) - 1));
+  s->val >>= count;
+  s->bits -= count;
+  return ret;
+}
+
+/* Go back to a byte boundary, and return the unconsumed whole bytes in
+   S->VAL to the input.  */
+
+static void
+elf_zlib_align (struct elf_zlib_state *s)
+{
+  s->pin -= s->bits / 8;
+  s->val = 0;
+  s->bits = 0;
+}
+
+/* Build the Huffman code H from the code lengths LENGTHS of N symbols.
+   Returns 1 on success, 0 if the lengths do not describe a valid
+   code.  */
+
+static int
+elf_zlib_build (struct elf_zlib_huffman *h, const unsigned char *lengths,
+		unsigned int n)
+{
+  uint16_t offs[ELF_ZLIB_MAX_BITS + 1];
+  unsigned int len;
+  unsigned int sym;
+  int left;
+  unsigned int code;
+  unsigned int index;
+
+  memset (h->count, 0, sizeof h->count);
+  for (sym = 0; sym < n; ++sym)
+    h->count[lengths[sym]]++;
+
+  /* Reject over-subscribed codes.  Incomplete codes are allowed, since
+     a code with just one symbol is incomplete; an unused code simply
+     fails to decode.  */
+  left = 1;
+  for (len = 1; len <= ELF_ZLIB_MAX_BITS; ++len)
+    {
+      left <<= 1;
+      left -= h->count[len];
+      if (left < 0)
+	return 0;
+    }
+
+  offs[1] = 0;
+  for (len = 1; len < ELF_ZLIB_MAX_BITS; ++len)
+    offs[len + 1] = offs[len] + h->count[len];
+  for (sym = 0; sym < n; ++sym)
+    if (lengths[sym] != 0)
+      h->symbol[offs[lengths[sym]]++] = sym;
+
+  /* Fill in the lookup table.  Codes are assigned in the order of
+     H->SYMBOL, and are read MSB first, so we have to reverse them.  */
+  memset (h->fast, 0, sizeof h->fast);
+  code = 0;
+  index = 0;
+  for (len = 1; len <= ELF_ZLIB_FAST_BITS; ++len)
+    {
+      unsigned int i;
+
+      for (i = 0; i < h->count[len]; ++i)
+	{
+	  unsigned int rev;
+	  unsigned int j;
+
+	  rev = 0;
+	  for (j = 0; j < len; ++j)
+	    rev |= ((code >> j) & 1) << (len - 1 - j);
+	  for (j = rev; j < (1U << ELF_ZLIB_FAST_BITS); j += 1U << len)
+	    h->fast[j] = (uint16_t) ((h->symbol[index] << 4) | len);
+	  ++code;
+	  ++index;
+	}
+      code <<= 1;
+    }
+
+  return 1;
+}
+
+/* Decode a symbol using the Huffman code H.  Returns -1 on error.  */
+
+static int
+elf_zlib_decode (struct elf_zlib_state *s, const struct elf_zlib_huffman *h)
+{
+  unsigned int entry;
+  unsigned int len;
+  int code;
+  int first;
+  int index;
+
+  if (s->bits < ELF_ZLIB_MAX_BITS)
+    elf_zlib_fill (s);
+
+  entry = h->fast[s->val & ((1U << ELF_ZLIB_FAST_BITS) - 1)];
+  if (entry != 0 && (entry & 0xf) <= s->bits)
+    {
+      s->val >>= entry & 0xf;
+      s->bits -= entry & 0xf;
+      return (int) (entry >> 4);
+    }
+
+  /* The code is longer than ELF_ZLIB_FAST_BITS bits.  */
+  code = 0;
+  first = 0;
+  index = 0;
+  for (len = 1; len <= ELF_ZLIB_MAX_BITS && len <= s->bits; ++len)
+    {
+      int count;
+
+      code |= (int) ((s->val >> (len - 1)) & 1);
+      count = h->count[len];
+      if (code - count < first)
+	{
+	  s->val >>= len;
+	  s->bits -= len;
+	  return h->symbol[index + (code - first)];
+	}
+      index += count;
+      first += count;
+      first <<= 1;
+      code <<= 1;
+    }
+  return -1;
+}
+
+/* Read the code lengths of a dynamic block and build its codes.
+   Returns 1 on success, 0 on error.  */
+
+static int
+elf_zlib_dynamic (struct elf_zlib_state *s)
+{
+  static const unsigned char order[19] =
+    { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+  unsigned char lengths[288 + 32];
+  int nlen;
+  int ndist;
+  int ncode;
+  int index;
+
+  nlen = elf_zlib_bits (s, 5);
+  ndist = elf_zlib_bits (s, 5);
+  ncode = elf_zlib_bits (s, 4);
+  if (nlen < 0 || ndist < 0 || ncode < 0)
+    return 0;
+  nlen += 257;
+  ndist += 1;
+  ncode += 4;
+  if (nlen > 286 || ndist > 30)
+    return 0;
+
+  memset (lengths, 0, 19);
+  for (index = 0; index < ncode; ++index)
+    {
+      int len;
+
+      len = elf_zlib_bits (s, 3);
+      if (len < 0)
+	return 0;
+      lengths[order[index]] = (unsigned char) len;
+    }
+  if (!elf_zlib_build (&s->codelencode, lengths, 19))
+    return 0;
+
+  index = 0;
+  while (index < nlen + ndist)
+    {
+      int sym;
+      int len;
+      int rep;
+
+      sym = elf_zlib_decode (s, &s->codelencode);
+      if (sym < 0)
+	return 0;
+      if (sym < 16)
+	{
+	  lengths[index++] = (unsigned char) sym;
+	  continue;
+	}
+      len = 0;
+      if (sym == 16)
+	{
+	  if (index == 0)
+	    return 0;
+	  len = lengths[index - 1];
+	  rep = elf_zlib_bits (s, 2);
+	  if (rep < 0)
+	    return 0;
+	  rep += 3;
+	}
+      else if (sym == 17)
+	{
+	  rep = elf_zlib_bits (s, 3);
+	  if (rep < 0)
+	    return 0;
+	  rep += 3;
+	}
+      else
+	{
+	  rep = elf_zlib_bits (s, 7);
+	  if (rep < 0)
+	    return 0;
+	  rep += 11;
+	}
+      if (index + rep > nlen + ndist)
+	return 0;
+      while (rep-- > 0)
+	lengths[index++] = (unsigned char) len;
+    }
+
+  /* There must be an end of block code.  */
+  if (lengths[256] == 0)
+    return 0;
+
+  return (elf_zlib_build (&s->lencode, lengths, nlen)
+	  && elf_zlib_build (&s->distcode, lengths + nlen, ndist));
+}
+
+/* Build the fixed codes of RFC 1951 section 3.2.6.  */
+
+static void
+elf_zlib_fixed (struct elf_zlib_state *s)
+{
+  unsigned char lengths[288];
+  unsigned int i;
+
+  for (i = 0; i < 144; ++i)
+    lengths[i] = 8;
+  for (; i < 256; ++i)
+    lengths[i] = 9;
+  for (; i < 280; ++i)
+    lengths[i] = 7;
+  for (; i < 288; ++i)
+    lengths[i] = 8;
+  elf_zlib_build (&s->lencode, lengths, 288);
+
+  for (i = 0; i < 30; ++i)
+    lengths[i] = 5;
+  elf_zlib_build (&s->distcode, lengths, 30);
+}
+
+/* Decode the compressed data of a block with the current codes.
+   Returns 1 on success, 0 on error.  */
+
+static int
+elf_zlib_codes (struct elf_zlib_state *s)
+{
+  static const uint16_t len_base[29] =
+    { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+  static const unsigned char len_extra[29] =
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+  static const uint16_t dist_base[30] =
+    { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+      8193, 12289, 16385, 24577 };
+  static const unsigned char dist_extra[30] =
+    { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+  while (1)
+    {
+      int sym;
+      int extra;
+      size_t len;
+      size_t dist;
+      unsigned char *from;
+
+      sym = elf_zlib_decode (s, &s->lencode);
+      if (sym < 0)
+	return 0;
+      if (sym < 256)
+	{
+	  if (s->pout >= s->poutend)
+	    return 0;
+	  *s->pout++ = (unsigned char) sym;
+	  continue;
+	}
+      if (sym == 256)
+	return 1;
+
+      sym -= 257;
+      if (sym >= 29)
+	return 0;
+      extra = elf_zlib_bits (s, len_extra[sym]);
+      if (extra < 0)
+	return 0;
+      len = len_base[sym] + (size_t) extra;
+
+      sym = elf_zlib_decode (s, &s->distcode);
+      if (sym < 0 || sym >= 30)
+	return 0;
+      extra = elf_zlib_bits (s, dist_extra[sym]);
+      if (extra < 0)
+	return 0;
+      dist = dist_base[sym] + (size_t) extra;
+
+      if (dist > (size_t) (s->pout - s->poutstart)
+	  || len > (size_t) (s->poutend - s->pout))
+	return 0;
+      from = s->pout - dist;
+      if (dist >= len)
+	{
+	  memcpy (s->pout, from, len);
+	  s->pout += len;
+	}
+      else
+	{
+	  while (len-- > 0)
+	    *s->pout++ = *from++;
+	}
+    }
+}
+
+/* Inflate the zlib stream of SIN bytes at PIN into the SOUT bytes at
+   POUT, using the state S.  Returns 1 on success, 0 if the stream is
+   invalid or does not have exactly SOUT bytes of data.  */
+
+static int
+elf_zlib_inflate (struct elf_zlib_state *s, const unsigned char *pin,
+		  size_t sin, unsigned char *pout, size_t sout)
+{
+  int final;
+  uint32_t a;
+  uint32_t b;
+  size_t i;
+  uint32_t adler;
+
+  if (sin < 6)
+    return 0;
+  /* Check the zlib header: deflate, no preset dictionary.  */
+  if ((pin[0] & 0xf) != 8
+      || (pin[0] >> 4) > 7
+      || (pin[1] & 0x20) != 0
+      || ((pin[0] << 8) | pin[1]) % 31 != 0)
+    return 0;
+
+  s->pin = pin + 2;
+  s->pinend = pin + sin;
+  s->val = 0;
+  s->bits = 0;
+  s->pout = pout;
+  s->poutstart = pout;
+  s->poutend = pout + sout;
+
+  do
+    {
+      int type;
+
+      final = elf_zlib_bits (s, 1);
+      type = elf_zlib_bits (s, 2);
+      if (final < 0 || type < 0)
+	return 0;
+
+      if (type == 0)
+	{
+	  size_t len;
+
+	  /* A stored block.  */
+	  elf_zlib_align (s);
+	  if (s->pinend - s->pin < 4)
+	    return 0;
+	  len = (size_t) s->pin[0] | ((size_t) s->pin[1] << 8);
+	  if (((size_t) s->pin[2] | ((size_t) s->pin[3] << 8))
+	      != (~len & 0xffff))
+	    return 0;
+	  s->pin += 4;
+	  if (len > (size_t) (s->pinend - s->pin)
+	      || len > (size_t) (s->poutend - s->pout))
+	    return 0;
+	  memcpy (s->pout, s->pin, len);
+	  s->pin += len;
+	  s->pout += len;
+	}
+      else if (type == 1)
+	{
+	  elf_zlib_fixed (s);
+	  if (!elf_zlib_codes (s))
+	    return 0;
+	}
+      else if (type == 2)
+	{
+	  if (!elf_zlib_dynamic (s) || !elf_zlib_codes (s))
+	    return 0;
+	}
+      else
+	return 0;
+    }
+  while (!final);
+
+  if (s->pout != s->poutend)
+    return 0;
+
+  /* Check the Adler-32 checksum of the uncompressed data.  */
+  elf_zlib_align (s);
+  if (s->pinend - s->pin < 4)
+    return 0;
+  adler = (((uint32_t) s->pin[0] << 24) | ((uint32_t) s->pin[1] << 16)
+	   | ((uint32_t) s->pin[2] << 8) | (uint32_t) s->pin[3]);
+  a = 1;
+  b = 0;
+  i = 0;
+  while (i < sout)
+    {
+      /* 5552 is the largest N such that 255N(N+1)/2 + (N+1)(65520)
+	 fits in 32 bits.  */
+      size_t end;
+
+      end = sout - i > 5552 ? i + 5552 : sout;
+      for (; i < end; ++i)
+	{
+	  a += pout[i];
+	  b += a;
+	}
+      a %= 65521;
+      b %= 65521;
+    }
+  return ((b << 16) | a) == adler;
+}
+
+/* Uncompress the debug section SECTION, which is either a .zdebug
+   section or has the SHF_COMPRESSED flag, into newly allocated memory,
+   and update SECTION to point to it.  Returns 1 on success, 0 on
+   failure.  */
+
+static int
+elf_uncompress_section (struct backtrace_state *state,
+			struct debug_section_info *section,
+			backtrace_error_callback error_callback, void *data)
+{
+  const unsigned char *compressed;
+  size_t compressed_size;
+  uint64_t size;
+  unsigned char *uncompressed;
+  struct elf_zlib_state *zstate;
+  int ret;
+
+  if (section->zdebug)
+    {
+      unsigned int i;
+
+      /* "ZLIB" followed by the uncompressed size as a 64-bit
+	 big-endian number.  */
+      if (section->size < 12 || memcmp (section->data, "ZLIB", 4) != 0)
+	{
+	  error_callback (data, "invalid .zdebug section header", 0);
+	  return 0;
+	}
+      size = 0;
+      for (i = 4; i < 12; ++i)
+	size = (size << 8) | section->data[i];
+      compressed = section->data + 12;
+      compressed_size = section->size - 12;
+    }
+  else
+    {
+      b_elf_chdr chdr;
+
+      if (section->size < sizeof chdr)
+	{
+	  error_callback (data, "invalid compressed section header", 0);
+	  return 0;
+	}
+      memcpy (&chdr, section->data, sizeof chdr);
+      if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	{
+	  error_callback (data, "unsupported debug section compression", 0);
+	  return 0;
+	}
+      size = chdr.ch_size;
+      compressed = section->data + sizeof chdr;
+      compressed_size = section->size - sizeof chdr;
+    }
+
+  if (size == 0 || size != (size_t) size)
+    {
+      error_callback (data, "invalid uncompressed debug section size", 0);
+      return 0;
+    }
+
+  uncompressed = ((unsigned char *)
+		  backtrace_alloc (state, (size_t) size, error_callback, data));
+  if (uncompressed == NULL)
+    return 0;
+
+  /* The inflater state is too large for the stack of a signal
+     handler, so allocate it.  */
+  zstate = ((struct elf_zlib_state *)
+	    backtrace_alloc (state, sizeof *zstate, error_callback, data));
+  if (zstate == NULL)
+    {
+      backtrace_free (state, uncompressed, (size_t) size, error_callback,
+		      data);
+      return 0;
+    }
+
+  ret = elf_zlib_inflate (zstate, compressed, compressed_size, uncompressed,
+			  (size_t) size);
+  backtrace_free (state, zstate, sizeof *zstate, error_callback, data);
+  if (!ret)
+    {
+      error_callback (data, "invalid compressed debug section", 0);
+      backtrace_free (state, uncompressed, (size_t) size, error_callback,
+		      data);
+      return 0;
+    }
+
+  section->data = uncompressed;
+  section->size = (size_t) size;
+  return 1;
+}
+
 /* Compare struct elf_symbol for qsort.  */
 
 static int
@@ -510,16 +1151,257 @@ elf_syminfo (struct backtrace_state *state, uintptr_t addr,
     callback (data, addr, sym->name, sym->address, sym->size);
 }
 
+/* Compute the CRC-32 of the file DESCRIPTOR, as used by
+   .gnu_debuglink.  Returns 0 on failure; that is also a valid CRC, but
+   then we just do not use the file.  */
+
+static uint32_t
+elf_crc32_file (struct backtrace_state *state, int descriptor,
+		backtrace_error_callback error_callback, void *data)
+{
+  struct stat st;
+  struct backtrace_view file_view;
+  uint32_t table[256];
+  uint32_t crc;
+  const unsigned char *p;
+  size_t i;
+
+  if (fstat (descriptor, &st) < 0)
+    {
+      error_callback (data, "fstat", errno);
+      return 0;
+    }
+  if (st.st_size == 0)
+    return 0;
+
+  if (!backtrace_get_view (state, descriptor, 0, st.st_size, error_callback,
+			   data, &file_view))
+    return 0;
+
+  for (i = 0; i < 256; ++i)
+    {
+      uint32_t c;
+      int k;
+
+      c = (uint32_t) i;
+      for (k = 0; k < 8; ++k)
+	c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+
+  crc = 0xffffffff;
+  p = (const unsigned char *) file_view.data;
+  for (i = 0; i < (size_t) st.st_size; ++i)
+    crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+
+  backtrace_release_view (state, &file_view, error_callback, data);
+
+  return ~crc;
+}
+
+/* Open the separate debug info file for the build ID BUILDID of
+   BUILDID_SIZE bytes, in SYSTEM_BUILD_ID_DIR.  Returns an open
+   descriptor, or -1 if there is no such file.  */
+
+static int
+elf_open_debugfile_by_buildid (struct backtrace_state *state,
+			       const unsigned char *buildid,
+			       size_t buildid_size,
+			       backtrace_error_callback error_callback,
+			       void *data)
+{
+  static const char hex[] = "0123456789abcdef";
+  const size_t prefix_len = strlen (SYSTEM_BUILD_ID_DIR);
+  size_t len;
+  char *path;
+  char *t;
+  size_t i;
+  int does_not_exist;
+  int ret;
+
+  len = prefix_len + buildid_size * 2 + sizeof "/.debug";
+  path = (char *) backtrace_alloc (state, len, error_callback, data);
+  if (path == NULL)
+    return -1;
+
+  memcpy (path, SYSTEM_BUILD_ID_DIR, prefix_len);
+  t = path + prefix_len;
+  for (i = 0; i < buildid_size; ++i)
+    {
+      *t++ = hex[buildid[i] >> 4];
+      *t++ = hex[buildid[i] & 0xf];
+      if (i == 0)
+	*t++ = '/';
+    }
+  strcpy (t, ".debug");
+
+  ret = backtrace_open (path, error_callback, data, &does_not_exist);
+
+  backtrace_free (state, path, len, error_callback, data);
+
+  return ret;
+}
+
+/* Try to open the separate debug info file DIR/SUBDIR/NAME.  If CRC is
+   not zero, the file must have that CRC.  Returns an open descriptor,
+   or -1.  */
+
+static int
+elf_try_debugfile (struct backtrace_state *state, const char *dir,
+		   size_t dir_len, const char *subdir, const char *name,
+		   uint32_t crc, backtrace_error_callback error_callback,
+		   void *data)
+{
+  size_t subdir_len;
+  size_t name_len;
+  size_t len;
+  char *path;
+  int does_not_exist;
+  int ret;
+
+  subdir_len = strlen (subdir);
+  name_len = strlen (name);
+  len = dir_len + subdir_len + name_len + 1;
+  path = (char *) backtrace_alloc (state, len, error_callback, data);
+  if (path == NULL)
+    return -1;
+  memcpy (path, dir, dir_len);
+  memcpy (path + dir_len, subdir, subdir_len);
+  memcpy (path + dir_len + subdir_len, name, name_len + 1);
+
+  ret = backtrace_open (path, error_callback, data, &does_not_exist);
+
+  backtrace_free (state, path, len, error_callback, data);
+
+  if (ret >= 0
+      && crc != 0
+      && elf_crc32_file (state, ret, error_callback, data) != crc)
+    {
+      backtrace_close (ret, error_callback, data);
+      ret = -1;
+    }
+
+  return ret;
+}
+
+/* Open the separate debug info file named by the .gnu_debuglink
+   section of FILENAME, whose contents are DEBUGLINK_NAME and
+   DEBUGLINK_CRC.  Like GDB, look in the directory of FILENAME, in its
+   .debug subdirectory, and below SYSTEM_DEBUG_DIR.  Returns an open
+   descriptor, or -1 if there is no such file.  */
+
+static int
+elf_open_debugfile_by_debuglink (struct backtrace_state *state,
+				 const char *filename,
+				 const char *debuglink_name,
+				 uint32_t debuglink_crc,
+				 backtrace_error_callback error_callback,
+				 void *data)
+{
+  char *alc;
+  size_t alc_len;
+  const char *slash;
+  size_t dir_len;
+  int ret;
+
+  /* If FILENAME is a symbolic link, as /proc/self/exe is, the debug
+     info file is next to the file that it points to.  */
+  alc = NULL;
+  alc_len = 0;
+#ifdef HAVE_READLINK
+  {
+    int links;
+
+    for (links = 0; links < 10; ++links)
+      {
+	char buf[4096];
+	ssize_t rl;
+	char *target;
+	size_t target_len;
+
+	rl = readlink (filename, buf, sizeof buf);
+	if (rl < 0 || (size_t) rl >= sizeof buf)
+	  break;
+
+	/* A relative link is relative to the directory of the link.  */
+	dir_len = 0;
+	slash = strrchr (filename, '/');
+	if (buf[0] != '/' && slash != NULL)
+	  dir_len = (size_t) (slash - filename) + 1;
+	target_len = dir_len + (size_t) rl + 1;
+	target = (char *) backtrace_alloc (state, target_len, error_callback,
+					   data);
+	if (target == NULL)
+	  break;
+	memcpy (target, filename, dir_len);
+	memcpy (target + dir_len, buf, (size_t) rl);
+	target[dir_len + rl] = '\0';
+
+	if (alc != NULL)
+	  backtrace_free (state, alc, alc_len, error_callback, data);
+	alc = target;
+	alc_len = target_len;
+	filename = target;
+      }
+  }
+#endif
+
+  slash = strrchr (filename, '/');
+  if (slash == NULL)
+    {
+      filename = ".";
+      dir_len = 1;
+    }
+  else
+    dir_len = (size_t) (slash - filename);
+
+  ret = elf_try_debugfile (state, filename, dir_len, "/", debuglink_name,
+			   debuglink_crc, error_callback, data);
+  if (ret < 0)
+    ret = elf_try_debugfile (state, filename, dir_len, "/.debug/",
+			     debuglink_name, debuglink_crc, error_callback,
+			     data);
+  if (ret < 0 && filename[0] == '/')
+    {
+      size_t sys_len;
+      size_t len;
+      char *dir;
+
+      /* Look for SYSTEM_DEBUG_DIR/DIR/NAME.  */
+      sys_len = strlen (SYSTEM_DEBUG_DIR);
+      len = sys_len + dir_len;
+      dir = (char *) backtrace_alloc (state, len, error_callback, data);
+      if (dir != NULL)
+	{
+	  memcpy (dir, SYSTEM_DEBUG_DIR, sys_len);
+	  memcpy (dir + sys_len, filename, dir_len);
+	  ret = elf_try_debugfile (state, dir, len, "/", debuglink_name,
+				   debuglink_crc, error_callback, data);
+	  backtrace_free (state, dir, len, error_callback, data);
+	}
+    }
+
+  if (alc != NULL)
+    backtrace_free (state, alc, alc_len, error_callback, data);
+
+  return ret;
+}
+
 /* Add the backtrace data for one ELF file.  Returns 1 on success,
    0 on failure (in both cases descriptor is closed) or -1 if exe
    is non-zero and the ELF file is ET_DYN, which tells the caller that
    elf_add will need to be called on the descriptor again after
-   base_address is determined.  */
+   base_address is determined.  FILENAME is the name of the file, if
+   known; it is used to find a separate debug info file.  DEBUGINFO is
+   non-zero if this is such a separate debug info file; then *FOUND_SYM
+   is non-zero on entry if the symbol table of the main file is
+   complete, and the symbol table of this file is only used if not.  */
 
 static int
-elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
-	 backtrace_error_callback error_callback, void *data,
-	 fileline *fileline_fn, int *found_sym, int *found_dwarf, int exe)
+elf_add (struct backtrace_state *state, const char *filename, int descriptor,
+	 uintptr_t base_address, backtrace_error_callback error_callback,
+	 void *data, fileline *fileline_fn, int *found_sym, int *found_dwarf,
+	 int exe, int debuginfo)
 {
   struct backtrace_view ehdr_view;
   b_elf_ehdr ehdr;
@@ -547,8 +1429,13 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
   off_t max_offset;
   struct backtrace_view debug_view;
   int debug_view_valid;
+  unsigned int buildid_shndx;
+  unsigned int debuglink_shndx;
+  int has_symtab;
+  int all_compressed;
 
-  *found_sym = 0;
+  if (!debuginfo)
+    *found_sym = 0;
   *found_dwarf = 0;
 
   shdrs_view_valid = 0;
@@ -671,6 +1558,8 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
 
   symtab_shndx = 0;
   dynsym_shndx = 0;
+  buildid_shndx = 0;
+  debuglink_shndx = 0;
 
   memset (sections, 0, sizeof sections);
 
@@ -704,13 +1593,38 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
 	    {
 	      sections[j].offset = shdr->sh_offset;
 	      sections[j].size = shdr->sh_size;
+	      sections[j].compressed = (shdr->sh_flags & SHF_COMPRESSED) != 0;
+	      sections[j].zdebug = 0;
+	      break;
+	    }
+	  /* Old style compressed sections are called .zdebug_*; only
+	     use them if there is no .debug_* section.  */
+	  if (strncmp (name, ".zdebug_", 8) == 0
+	      && strcmp (name + 8, debug_section_names[j] + 7) == 0
+	      && sections[j].size == 0)
+	    {
+	      sections[j].offset = shdr->sh_offset;
+	      sections[j].size = shdr->sh_size;
+	      sections[j].compressed = 0;
+	      sections[j].zdebug = 1;
 	      break;
 	    }
 	}
+
+      if (shdr->sh_type == SHT_NOTE
+	  && strcmp (name, ".note.gnu.build-id") == 0)
+	buildid_shndx = i;
+      else if (strcmp (name, ".gnu_debuglink") == 0)
+	debuglink_shndx = i;
     }
 
-  if (symtab_shndx == 0)
+  /* A separate debug info file only provides its full symbol table,
+     if the main file does not have one.  */
+  has_symtab = symtab_shndx != 0;
+  if (symtab_shndx == 0 && !debuginfo)
     symtab_shndx = dynsym_shndx;
+  if (debuginfo && *found_sym)
+    symtab_shndx = 0;
   if (symtab_shndx != 0)
     {
       const b_elf_shdr *symtab_shdr;
@@ -763,7 +1677,107 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
       elf_add_syminfo_data (state, sdata);
     }
 
-  /* FIXME: Need to handle compressed debug sections.  */
+  /* If there is no debug info in this file, look for a separate debug
+     info file, first by build ID, then by .gnu_debuglink.  */
+
+  if (!debuginfo && sections[DEBUG_INFO].size == 0
+      && (buildid_shndx != 0 || debuglink_shndx != 0))
+    {
+      int d;
+
+      d = -1;
+      if (buildid_shndx != 0)
+	{
+	  const b_elf_shdr *buildid_shdr;
+	  struct backtrace_view buildid_view;
+
+	  buildid_shdr = &shdrs[buildid_shndx - 1];
+	  if (backtrace_get_view (state, descriptor, buildid_shdr->sh_offset,
+				  buildid_shdr->sh_size, error_callback, data,
+				  &buildid_view))
+	    {
+	      const b_elf_note *note;
+	      size_t note_size;
+
+	      note = (const b_elf_note *) buildid_view.data;
+	      note_size = buildid_shdr->sh_size;
+	      if (note_size >= 12
+		  && note->n_type == NT_GNU_BUILD_ID
+		  && note->n_namesz == 4
+		  && strncmp (note->name, "GNU", 4) == 0
+		  && note->n_descsz > 0
+		  && 16 + (size_t) note->n_descsz <= note_size)
+		d = elf_open_debugfile_by_buildid (state,
+						   ((const unsigned char *)
+						    note->name + 4),
+						   note->n_descsz,
+						   error_callback, data);
+	      backtrace_release_view (state, &buildid_view, error_callback,
+				      data);
+	    }
+	}
+
+      if (d < 0 && debuglink_shndx != 0 && filename != NULL)
+	{
+	  const b_elf_shdr *debuglink_shdr;
+	  struct backtrace_view debuglink_view;
+
+	  debuglink_shdr = &shdrs[debuglink_shndx - 1];
+	  if (backtrace_get_view (state, descriptor,
+				  debuglink_shdr->sh_offset,
+				  debuglink_shdr->sh_size, error_callback, data,
+				  &debuglink_view))
+	    {
+	      const char *debuglink_name;
+	      size_t debuglink_size;
+	      const char *nul;
+	      size_t crc_offset;
+	      uint32_t debuglink_crc;
+
+	      /* The name, padded to a multiple of 4 bytes, followed by a
+		 4-byte CRC.  */
+	      debuglink_name = (const char *) debuglink_view.data;
+	      debuglink_size = debuglink_shdr->sh_size;
+	      nul = (const char *) memchr (debuglink_name, '\0',
+					   debuglink_size);
+	      crc_offset = 0;
+	      if (nul != NULL)
+		crc_offset = ((size_t) (nul - debuglink_name) + 4) & ~(size_t) 3;
+	      if (nul != NULL && crc_offset + 4 <= debuglink_size)
+		{
+		  memcpy (&debuglink_crc, debuglink_name + crc_offset, 4);
+		  d = elf_open_debugfile_by_debuglink (state, filename,
+						       debuglink_name,
+						       debuglink_crc,
+						       error_callback, data);
+		}
+	      backtrace_release_view (state, &debuglink_view, error_callback,
+				      data);
+	    }
+	}
+
+      if (d >= 0)
+	{
+	  int debug_found_sym;
+
+	  backtrace_release_view (state, &shdrs_view, error_callback, data);
+	  backtrace_release_view (state, &names_view, error_callback, data);
+	  if (!backtrace_close (descriptor, error_callback, data))
+	    {
+	      backtrace_close (d, error_callback, data);
+	      return 0;
+	    }
+
+	  /* Failing to use the debug info file is not a failure of the
+	     main file, whose symbols we have read already.  */
+	  debug_found_sym = has_symtab;
+	  if (elf_add (state, NULL, d, base_address, error_callback, data,
+		       fileline_fn, &debug_found_sym, found_dwarf, 0, 1)
+	      && debug_found_sym)
+	    *found_sym = 1;
+	  return 1;
+	}
+    }
 
   backtrace_release_view (state, &shdrs_view, error_callback, data);
   shdrs_view_valid = 0;
@@ -805,13 +1819,32 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
     goto fail;
   descriptor = -1;
 
+  all_compressed = 1;
   for (i = 0; i < (int) DEBUG_MAX; ++i)
     {
       if (sections[i].size == 0)
 	sections[i].data = NULL;
       else
-	sections[i].data = ((const unsigned char *) debug_view.data
-			    + (sections[i].offset - min_offset));
+	{
+	  sections[i].data = ((const unsigned char *) debug_view.data
+			      + (sections[i].offset - min_offset));
+	  if (sections[i].compressed || sections[i].zdebug)
+	    {
+	      if (!elf_uncompress_section (state, &sections[i],
+					   error_callback, data))
+		goto fail;
+	    }
+	  else
+	    all_compressed = 0;
+	}
+    }
+
+  /* If we have uncompressed all the debug sections, we no longer need
+     the view of the compressed data.  */
+  if (all_compressed)
+    {
+      backtrace_release_view (state, &debug_view, error_callback, data);
+      debug_view_valid = 0;
     }
 
   if (!backtrace_dwarf_add (state, base_address,
@@ -825,6 +1858,8 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
 			    sections[DEBUG_RANGES].size,
 			    sections[DEBUG_STR].data,
 			    sections[DEBUG_STR].size,
+			    sections[DEBUG_ARANGES].data,
+			    sections[DEBUG_ARANGES].size,
 			    ehdr.e_ident[EI_DATA] == ELFDATA2MSB,
 			    error_callback, data, fileline_fn))
     goto fail;
@@ -859,6 +1894,7 @@ struct phdr_data
   fileline *fileline_fn;
   int *found_sym;
   int *found_dwarf;
+  const char *exe_filename;
   int exe_descriptor;
 };
 
@@ -873,6 +1909,7 @@ phdr_callback (struct dl_phdr_info *info, size_t size ATTRIBUTE_UNUSED,
 	       void *pdata)
 {
   struct phdr_data *pd = (struct phdr_data *) pdata;
+  const char *filename;
   int descriptor;
   int does_not_exist;
   fileline elf_fileline_fn;
@@ -885,6 +1922,7 @@ phdr_callback (struct dl_phdr_info *info, size_t size ATTRIBUTE_UNUSED,
     {
       if (pd->exe_descriptor == -1)
 	return 0;
+      filename = pd->exe_filename;
       descriptor = pd->exe_descriptor;
       pd->exe_descriptor = -1;
     }
@@ -896,14 +1934,16 @@ phdr_callback (struct dl_phdr_info *info, size_t size ATTRIBUTE_UNUSED,
 	  pd->exe_descriptor = -1;
 	}
 
+      filename = info->dlpi_name;
       descriptor = backtrace_open (info->dlpi_name, pd->error_callback,
 				   pd->data, &does_not_exist);
       if (descriptor < 0)
 	return 0;
     }
 
-  if (elf_add (pd->state, descriptor, info->dlpi_addr, pd->error_callback,
-	       pd->data, &elf_fileline_fn, pd->found_sym, &found_dwarf, 0))
+  if (elf_add (pd->state, filename, descriptor, info->dlpi_addr,
+	       pd->error_callback, pd->data, &elf_fileline_fn, pd->found_sym,
+	       &found_dwarf, 0, 0))
     {
       if (found_dwarf)
 	{
@@ -920,8 +1960,8 @@ phdr_callback (struct dl_phdr_info *info, size_t size ATTRIBUTE_UNUSED,
    sections.  */
 
 int
-backtrace_initialize (struct backtrace_state *state, int descriptor,
-		      backtrace_error_callback error_callback,
+backtrace_initialize (struct backtrace_state *state, const char *filename,
+		      int descriptor, backtrace_error_callback error_callback,
 		      void *data, fileline *fileline_fn)
 {
   int ret;
@@ -930,8 +1970,8 @@ backtrace_initialize (struct backtrace_state *state, int descriptor,
   fileline elf_fileline_fn = elf_nodebug;
   struct phdr_data pd;
 
-  ret = elf_add (state, descriptor, 0, error_callback, data, &elf_fileline_fn,
-		 &found_sym, &found_dwarf, 1);
+  ret = elf_add (state, filename, descriptor, 0, error_callback, data,
+		 &elf_fileline_fn, &found_sym, &found_dwarf, 1, 0);
   if (!ret)
     return 0;
 
@@ -941,6 +1981,7 @@ backtrace_initialize (struct backtrace_state *state, int descriptor,
   pd.fileline_fn = &elf_fileline_fn;
   pd.found_sym = &found_sym;
   pd.found_dwarf = &found_dwarf;
+  pd.exe_filename = filename;
   pd.exe_descriptor = ret < 0 ? descriptor : -1;
 
   dl_iterate_phdr (phdr_callback, (void *) &pd);
@@ -57,6 +57,7 @@ fileline_initialize (struct backtrace_state *state,
   int pass;
   int called_error_callback;
   int descriptor;
+  const char *filename;
 
   if (!state->threaded)
     failed = state->fileline_initialization_failed;
@@ -80,9 +81,9 @@ fileline_initialize (struct backtrace_state *state,
 
   descriptor = -1;
   called_error_callback = 0;
+  filename = NULL;
   for (pass = 0; pass < 4; ++pass)
     {
-      const char *filename;
       int does_not_exist;
 
       switch (pass)
@@ -133,8 +134,8 @@ fileline_initialize (struct backtrace_state *state,
 
   if (!failed)
     {
-      if (!backtrace_initialize (state, descriptor, error_callback, data,
-				 &fileline_fn))
+      if (!backtrace_initialize (state, filename, descriptor, error_callback,
+				 data, &fileline_fn))
 	failed = 1;
     }
 
@@ -263,11 +263,13 @@ extern int backtrace_vector_release (struct backtrace_state *state,
    that the synchronization code is only implemented once.  This is
    called after the descriptor has first been opened.  It will close
    the descriptor if it is no longer needed.  Returns 1 on success, 0
-   on error.  There will be multiple implementations of this function,
-   for different file formats.  Each system will compile the
-   appropriate one.  */
+   on error.  FILENAME is the name of the file that DESCRIPTOR refers
+   to.  There will be multiple implementations of this function, for
+   different file formats.  Each system will compile the appropriate
+   one.  */
 
 extern int backtrace_initialize (struct backtrace_state *state,
+				 const char *filename,
 				 int descriptor,
 				 backtrace_error_callback error_callback,
 				 void *data,
@@ -287,6 +289,8 @@ extern int backtrace_dwarf_add (struct backtrace_state *state,
 				size_t dwarf_range_size,
 				const unsigned char *dwarf_str,
 				size_t dwarf_str_size,
+				const unsigned char *dwarf_aranges,
+				size_t dwarf_aranges_size,
 				int is_bigendian,
 				backtrace_error_callback error_callback,
 				void *data, fileline *fileline_fn);
@@ -142,6 +142,7 @@ enum debug_section
   DEBUG_ABBREV,
   DEBUG_RANGES,
   DEBUG_STR,
+  DEBUG_ARANGES,
   DEBUG_MAX
 };
 
@@ -153,7 +154,8 @@ static const char * const debug_section_names[DEBUG_MAX] =
   ".debug_line",
   ".debug_abbrev",
   ".debug_ranges",
-  ".debug_str"
+  ".debug_str",
+  ".debug_aranges"
 };
 
 /* Information we gather for the sections we care about.  */
@@ -863,6 +865,8 @@ coff_add (struct backtrace_state *state, int descriptor,
 			    sections[DEBUG_RANGES].size,
 			    sections[DEBUG_STR].data,
 			    sections[DEBUG_STR].size,
+			    sections[DEBUG_ARANGES].data,
+			    sections[DEBUG_ARANGES].size,
 			    0, /* FIXME */
 			    error_callback, data, fileline_fn))
     goto fail;
@@ -890,7 +894,8 @@ coff_add (struct backtrace_state *state, int descriptor,
    sections.  */
 
 int
-backtrace_initialize (struct backtrace_state *state, int descriptor,
+backtrace_initialize (struct backtrace_state *state,
+		      const char *filename ATTRIBUTE_UNUSED, int descriptor,
 		      backtrace_error_callback error_callback,
 		      void *data, fileline *fileline_fn)
 {
@@ -39,16 +39,65 @@ cc1_plugin::connection::print (const char *)
 cc1_plugin::status
 cc1_plugin::connection::send (char c)
 {
-  if (write (m_fd, &c, 1) != 1)
-    return FAIL;
-  return OK;
+  return send (&c, 1);
 }
 
 cc1_plugin::status
 cc1_plugin::connection::send (const void *buf, int len)
 {
-  if (write (m_fd, buf, len) != len)
+  if (m_out_len + len > (int) sizeof (m_out_buf))
+    {
+      if (!flush ())
+	return FAIL;
+      // Large blocks bypass the buffer.
+      if (len > (int) sizeof (m_out_buf))
+	{
+	  const char *p = (const char *) buf;
+	  while (len > 0)
+	    {
+	      int n = write (m_fd, p, len);
+	      if (n <= 0)
+		return FAIL;
+	      p += n;
+	      len -= n;
+	    }
+	  return OK;
+	}
+    }
+
+  memcpy (m_out_buf + m_out_len, buf, len);
+  m_out_len += len;
+  return OK;
+}
+
+cc1_plugin::status
+cc1_plugin::connection::flush ()
+{
+  int done = 0;
+
+  while (done < m_out_len)
+    {
+      int n = write (m_fd, m_out_buf + done, m_out_len - done);
+      if (n <= 0)
+	return FAIL;
+      done += n;
+    }
+  m_out_len = 0;
+  return OK;
+}
+
+cc1_plugin::status
+cc1_plugin::connection::fill ()
+{
+  // Make sure the remote has everything it needs to answer.
+  if (!flush ())
+    return FAIL;
+
+  int n = read (m_fd, m_in_buf, sizeof (m_in_buf));
+  if (n <= 0)
     return FAIL;
+  m_in_pos = 0;
+  m_in_len = n;
   return OK;
 }
 
@@ -57,7 +106,7 @@ cc1_plugin::connection::require (char c)
 {
   char result;
 
-  if (read (m_fd, &result, 1) != 1
+  if (!get (&result, 1)
       || result != c)
     return FAIL;
 
@@ -67,8 +116,21 @@ cc1_plugin::connection::require (char c)
 cc1_plugin::status
 cc1_plugin::connection::get (void *buf, int len)
 {
-  if (read (m_fd, buf, len) != len)
-    return FAIL;
+  char *p = (char *) buf;
+
+  while (len > 0)
+    {
+      if (m_in_pos == m_in_len && !fill ())
+	return FAIL;
+
+      int n = m_in_len - m_in_pos;
+      if (n > len)
+	n = len;
+      memcpy (p, m_in_buf + m_in_pos, n);
+      m_in_pos += n;
+      p += n;
+      len -= n;
+    }
   return OK;
 }
 
@@ -78,77 +140,89 @@ cc1_plugin::connection::do_wait (bool want_result)
   while (true)
     {
       char result;
-      fd_set read_set;
-
-      FD_ZERO (&read_set);
-      FD_SET (m_fd, &read_set);
-      if (m_aux_fd != -1)
-	FD_SET (m_aux_fd, &read_set);
 
-      int nfds = select (FD_SETSIZE, &read_set, NULL, NULL, NULL);
-      if (nfds == -1)
+      // A message may already be waiting in the input buffer.
+      if (m_in_pos == m_in_len)
 	{
-	  if (errno == EINTR)
-	    continue;
-	  return FAIL;
-	}
+	  fd_set read_set;
 
-      // We have to check the stderr fd first, to avoid a possible
-      // blocking scenario when do_wait is called reentrantly.  In
-      // such a call, if we handle the primary fd first, then we may
-      // re-enter this function, read from gcc's stderr, causing the
-      // outer invocation of this function to block when trying to
-      // read.
-      if (m_aux_fd != -1 && FD_ISSET (m_aux_fd, &read_set))
-	{
-	  char buf[1024];
-	  int n = read (m_aux_fd, buf, sizeof (buf) - 1);
-	  if (n < 0)
+	  // The remote may be waiting for what we have sent so far.
+	  if (!flush ())
 	    return FAIL;
-	  if (n > 0)
+
+	  FD_ZERO (&read_set);
+	  FD_SET (m_fd, &read_set);
+	  if (m_aux_fd != -1)
+	    FD_SET (m_aux_fd, &read_set);
+
+	  int nfds = select (FD_SETSIZE, &read_set, NULL, NULL, NULL);
+	  if (nfds == -1)
 	    {
-	      buf[n] = '\0';
-	      print (buf);
+	      if (errno == EINTR)
+		continue;
+	      return FAIL;
 	    }
-	}
 
-      if (FD_ISSET (m_fd, &read_set))
-	{
-	  int n = read (m_fd, &result, 1);
+	  // We have to check the stderr fd first, to avoid a possible
+	  // blocking scenario when do_wait is called reentrantly.  In
+	  // such a call, if we handle the primary fd first, then we may
+	  // re-enter this function, read from gcc's stderr, causing the
+	  // outer invocation of this function to block when trying to
+	  // read.
+	  if (m_aux_fd != -1 && FD_ISSET (m_aux_fd, &read_set))
+	    {
+	      char buf[1024];
+	      int n = read (m_aux_fd, buf, sizeof (buf) - 1);
+	      if (n < 0)
+		return FAIL;
+	      if (n > 0)
+		{
+		  buf[n] = '\0';
+		  print (buf);
+		}
+	    }
+
+	  if (!FD_ISSET (m_fd, &read_set))
+	    continue;
+
+	  int n = read (m_fd, m_in_buf, sizeof (m_in_buf));
 	  if (n == 0)
 	    return want_result ? FAIL : OK;
-	  if (n != 1)
+	  if (n < 0)
 	    return FAIL;
+	  m_in_pos = 0;
+	  m_in_len = n;
+	}
 
-	  switch (result)
-	    {
-	    case 'R':
-	      // The reply is ready; the caller will unmarshall it.
-	      return want_result ? OK : FAIL;
-
-	    case 'Q':
-	      // While waiting for a reply, the other side made a method
-	      // call.
-	      {
-		// Use an argument_wrapper here to simplify management
-		// of the string's lifetime.
-		argument_wrapper<char *> method_name;
-
-		if (!method_name.unmarshall (this))
-		  return FAIL;
-
-		callback_ftype *callback
-		  = m_callbacks.find_callback (method_name);
-		// The call to CALLBACK is where we may end up in a
-		// reentrant call.
-		if (callback == NULL || !callback (this))
-		  return FAIL;
-	      }
-	      break;
-
-	    default:
+      result = m_in_buf[m_in_pos++];
+      switch (result)
+	{
+	case 'R':
+	  // The reply is ready; the caller will unmarshall it.
+	  return want_result ? OK : FAIL;
+
+	case 'Q':
+	  // While waiting for a reply, the other side made a method
+	  // call.
+	  {
+	    // Use an argument_wrapper here to simplify management
+	    // of the string's lifetime.
+	    argument_wrapper<char *> method_name;
+
+	    if (!method_name.unmarshall (this))
 	      return FAIL;
-	    }
+
+	    callback_ftype *callback
+	      = m_callbacks.find_callback (method_name);
+	    // The call to CALLBACK is where we may end up in a
+	    // reentrant call.
+	    if (callback == NULL || !callback (this))
+	      return FAIL;
+	  }
+	  break;
+
+	default:
+	  return FAIL;
 	}
     }
 }
@@ -35,26 +35,37 @@ namespace cc1_plugin
     connection (int fd)
       : m_fd (fd),
 	m_aux_fd (-1),
-	m_callbacks ()
+	m_callbacks (),
+	m_in_pos (0),
+	m_in_len (0),
+	m_out_len (0)
     {
     }
 
     connection (int fd, int aux_fd)
       : m_fd (fd),
 	m_aux_fd (aux_fd),
-	m_callbacks ()
+	m_callbacks (),
+	m_in_pos (0),
+	m_in_len (0),
+	m_out_len (0)
     {
     }
 
     virtual ~connection ();
 
     // Send a single character.  This is used to introduce various
-    // higher-level protocol elements.
+    // higher-level protocol elements.  Like all the data sent, it is
+    // buffered until the connection waits for the remote or the
+    // buffer fills up.
     status send (char c);
 
     // Send data in bulk.
     status send (const void *buf, int len);
 
+    // Write out any buffered data.
+    status flush ();
+
     // Read a single byte from the connection and verify that it
     // matches the argument C.
     status require (char c);
@@ -100,6 +111,11 @@ namespace cc1_plugin
     // Helper function for the wait_* methods.
     status do_wait (bool);
 
+    // Read whatever is available from the file descriptor into the
+    // input buffer, which must be empty, after flushing the output.
+    // Blocks if nothing is available.
+    status fill ();
+
     // The file descriptor.
     int m_fd;
 
@@ -108,6 +124,18 @@ namespace cc1_plugin
 
     // Callbacks associated with this connection.
     callbacks m_callbacks;
+
+    // Data read from the file descriptor but not consumed yet, which
+    // is m_in_buf[m_in_pos] up to m_in_buf[m_in_len].  Reading in
+    // blocks saves a system call for each character and integer of
+    // a message.
+    char m_in_buf[4096];
+    int m_in_pos;
+    int m_in_len;
+
+    // Data not written to the file descriptor yet.
+    char m_out_buf[4096];
+    int m_out_len;
   };
 }
 
@@ -439,6 +439,7 @@ global_state_t* cilkg_get_user_settable_values()
 
         g->max_steal_failures       = 128; // TBD: depend on max_workers?
         g->stack_size               = 0;   // 0 unless set by the user
+        g->pin_workers              = 0;   // Default Off
 
         // Assume no record or replay log for now
         g->record_replay_file_name  = NULL;
@@ -463,6 +464,11 @@ global_state_t* cilkg_get_user_settable_values()
             // the larger of 3 and twice the number of hardware threads.
             store_int(&g->max_user_workers, envstr, 1, 16*hardware_cpu_count);
 
+        if (cilkos_getenv(envstr, sizeof(envstr), "CILK_PIN_WORKERS"))
+            // Pin system workers to CPUs, and steal from workers on
+            // the same socket first.
+            store_bool(&g->pin_workers, envstr);
+
         if (cilkos_getenv(envstr, sizeof(envstr), "CILK_STEAL_FAILURES"))
             // Set the number of times a worker should fail to steal before
             // it looks to see whether it should suspend itself.
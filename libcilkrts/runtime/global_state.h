@@ -209,6 +209,15 @@ struct global_state_t { /* COMMON_PORTABLE */
     /// Size of each stack
     size_t stack_size;
 
+    /**
+     * @brief USER SETTING: Pin each system worker to a CPU and have
+     * workers prefer stealing from workers on the same socket.
+     *
+     * Set from the CILK_PIN_WORKERS environment variable.  Only
+     * supported on Linux.
+     */
+    int pin_workers;
+
     /// Global cache for per-worker memory
     struct __cilkrts_frame_cache frame_malloc;
 
@@ -291,6 +291,22 @@ struct local_state  /* COMMON_PORTABLE */
      */
     unsigned rand_seed;
 
+    /**
+     * Ids of the other system workers that are pinned to a CPU on the
+     * same socket as this worker.  Steals try these workers first.
+     * NULL unless workers are pinned to more than one socket.
+     *
+     * [local read-only]
+     */
+    int32_t *domain_victims;
+
+    /**
+     * Number of entries in domain_victims.
+     *
+     * [local read-only]
+     */
+    int num_domain_victims;
+
     /**
      * Function to execute after transferring onto the scheduling stack.
      *
@@ -163,6 +163,13 @@ struct cilkred_map {
     /** Array of pointers to buckets */
     bucket **buckets;
 
+    /**
+     * Element most recently found by lookup(), or null.  Reset
+     * whenever elements are inserted, removed or moved, since any of
+     * these can leave it pointing into a freed or shifted bucket.
+     */
+    elem *last_found;
+
     /** Set true if merging (for debugging purposes) */
     bool merging;
 
@@ -307,6 +314,7 @@ void cilkred_map::make_buckets(__cilkrts_worker *w,
     buckets = new_buckets;
 #endif
     nelem = 0;
+    last_found = 0;
 }
 
 static void free_buckets(__cilkrts_worker  *w, 
@@ -447,6 +455,7 @@ elem *cilkred_map::insert_no_rehash(__cilkrts_worker           *w,
     CILK_ASSERT(view != 0);
 	    
     elem *el = grow(w, &(buckets[hashfun(this, key)]));
+    last_found = 0;
 
 #if REDPAR_DEBUG >= 3
     fprintf(stderr, "[W=%d, this=%p, inserting key=%p, view=%p, el = %p]\n",
@@ -513,13 +522,20 @@ elem *cilkred_map::rehash_and_insert(__cilkrts_worker           *w,
 
 elem *cilkred_map::lookup(void *key)
 {
+    // Loops that update a reducer look up the same key over and over.
+    elem *el = last_found;
+    if (el && el->key == key) {
+        CILK_ASSERT(el->view);
+        return el;
+    }
+
     bucket *b = buckets[hashfun(this, key)];
 
     if (b) {
-        elem *el;
         for (el = b->el; el->key; ++el) {
             if (el->key == key) {
                 CILK_ASSERT(el->view);
+                last_found = el;
                 return el;
             }
         }
@@ -609,6 +625,7 @@ const char *UNSYNCED_REDUCER_MSG =
         ++el;
     } while (el->key);
     --h->nelem;
+    h->last_found = 0;
 
 #if REDPAR_DEBUG >= 2
     fprintf(stderr, "[W=%d, desc=hyper_destroy_finish, key=%p, w->reducer_map=%p]\n",
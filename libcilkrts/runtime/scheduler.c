@@ -915,10 +915,16 @@ static void random_steal(__cilkrts_worker *w)
        There must be only one worker to prevent stealing. */
     CILK_ASSERT(w->g->total_workers > 1);
 
-    /* pick random *other* victim */
-    n = myrand(w) % (w->g->total_workers - 1);
-    if (n >= w->self)
-        ++n;
+    /* pick random *other* victim.  If the workers are pinned, pick
+       one on the same socket three times out of four, so that most
+       steals do not move cache lines between sockets. */
+    if (w->l->num_domain_victims > 0 && (myrand(w) & 3) != 0)
+        n = w->l->domain_victims[myrand(w) % w->l->num_domain_victims];
+    else {
+        n = myrand(w) % (w->g->total_workers - 1);
+        if (n >= w->self)
+            ++n;
+    }
 
     // If we're replaying a log, override the victim.  -1 indicates that
     // we've exhausted the list of things this worker stole when we recorded
@@ -2906,6 +2912,8 @@ __cilkrts_worker *make_worker(global_state_t *g,
     w->l->scheduling_fiber = NULL;
     w->l->original_pedigree_leaf = NULL;
     w->l->rand_seed = 0; /* the scheduler will overwrite this field */
+    w->l->domain_victims = NULL;
+    w->l->num_domain_victims = 0;
 
     w->l->post_suspend = 0;
     w->l->suspended_stack = 0;
@@ -2987,6 +2995,8 @@ void destroy_worker(__cilkrts_worker *w)
         signal_node_destroy(w->l->signal_node);
     }
 
+    if (w->l->domain_victims)
+        __cilkrts_free(w->l->domain_victims);
     __cilkrts_free(w->l->ltq);
     __cilkrts_mutex_destroy(0, &w->l->lock);
     __cilkrts_mutex_destroy(0, &w->l->steal_lock);
@@ -89,6 +89,14 @@
 #ifdef __linux__
 #   include <sys/resource.h>
 #   include <sys/sysinfo.h>
+#   include <sched.h>
+#   include <stdio.h>
+#endif
+
+// Pinning system workers to CPUs (CILK_PIN_WORKERS) needs the
+// thread affinity extensions.
+#if defined __linux__ && defined HAVE_PTHREAD_AFFINITY_NP
+#   define CILK_CAN_PIN_WORKERS 1
 #endif
 
 #ifdef __FreeBSD__
@@ -106,6 +114,7 @@ struct global_sysdep_state
 {
     pthread_t *threads;    ///< Array of pthreads for system workers
     size_t pthread_t_size; ///< for cilk_db
+    int *worker_cpus;      ///< CPU of each pinned system worker, or NULL
 }; 
 
 static void internal_enforce_global_visibility();
@@ -138,6 +147,7 @@ void __cilkrts_init_global_sysdep(global_state_t *g)
     //      Need to check what we are using this field for.
     g->sysdep->threads = __cilkrts_malloc(sizeof(pthread_t) * g->total_workers);
     CILK_ASSERT(g->sysdep->threads);
+    g->sysdep->worker_cpus = NULL;
 
     return;
 }
@@ -147,6 +157,8 @@ void __cilkrts_destroy_global_sysdep(global_state_t *g)
 {
     if (g->sysdep->threads)
         __cilkrts_free(g->sysdep->threads);
+    if (g->sysdep->worker_cpus)
+        __cilkrts_free(g->sysdep->worker_cpus);
     __cilkrts_free(g->sysdep);
 }
 
@@ -261,17 +273,106 @@ void* __cilkrts_worker_stub(void* arg)
 
 static void write_version_file (global_state_t *, int);
 
+#ifdef CILK_CAN_PIN_WORKERS
+/* Return the physical package (socket) of cpu, or 0 if the kernel
+ * does not tell us.
+ */
+static int cpu_package_id(int cpu)
+{
+    char path[96];
+    int id = 0;
+    FILE *f;
+
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/topology/physical_package_id",
+             cpu);
+    f = fopen(path, "r");
+    if (f) {
+        if (fscanf(f, "%d", &id) != 1)
+            id = 0;
+        fclose(f);
+    }
+    return id;
+}
+
+/* Assign the system workers 0..n-1 round robin to the CPUs that the
+ * calling thread may run on.  If those CPUs span more than one socket,
+ * also give each of these workers the list of the other ones on its
+ * socket, which random_steal tries first.
+ */
+static void pin_workers(global_state_t *g, int n)
+{
+    cpu_set_t mask;
+    int *cpus, *package;
+    int ncpus = 0, one_package = 1;
+
+    if (g->sysdep->worker_cpus || n <= 0)
+        return;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) != 0)
+        return;
+
+    cpus = __cilkrts_malloc(sizeof(int) * CPU_COUNT(&mask));
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &mask))
+            cpus[ncpus++] = cpu;
+    if (ncpus == 0) {
+        __cilkrts_free(cpus);
+        return;
+    }
+
+    g->sysdep->worker_cpus = __cilkrts_malloc(sizeof(int) * n);
+    package = __cilkrts_malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        g->sysdep->worker_cpus[i] = cpus[i % ncpus];
+        package[i] = cpu_package_id(g->sysdep->worker_cpus[i]);
+        if (package[i] != package[0])
+            one_package = 0;
+    }
+    __cilkrts_free(cpus);
+
+    // With a single socket, uniform victim selection is already local.
+    for (int i = 0; i < n && !one_package; i++) {
+        __cilkrts_worker *w = g->workers[i];
+        int count = 0;
+
+        for (int j = 0; j < n; j++)
+            if (j != i && package[j] == package[i])
+                count++;
+        if (count == 0)
+            continue;
+
+        w->l->domain_victims = __cilkrts_malloc(sizeof(int32_t) * count);
+        for (int j = 0; j < n; j++)
+            if (j != i && package[j] == package[i])
+                w->l->domain_victims[w->l->num_domain_victims++] = j;
+    }
+    __cilkrts_free(package);
+}
+#endif
+
 /* Create n worker threads from base..top-1
  */
 static void create_threads(global_state_t *g, int base, int top)
 {
-    // TBD(11/30/12): We want to insert code providing the option of
-    // pinning system workers to cores.
     for (int i = base; i < top; i++) {
+        pthread_attr_t attr, *attrp = NULL;
+#ifdef CILK_CAN_PIN_WORKERS
+        if (g->sysdep->worker_cpus) {
+            cpu_set_t cpu;
+
+            CPU_ZERO(&cpu);
+            CPU_SET(g->sysdep->worker_cpus[i], &cpu);
+            pthread_attr_init(&attr);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpu), &cpu);
+            attrp = &attr;
+        }
+#endif
         int status = pthread_create(&g->sysdep->threads[i],
-                                    NULL,
+                                    attrp,
                                     scheduler_thread_proc_for_system_worker,
                                     g->workers[i]);
+        if (attrp)
+            pthread_attr_destroy(attrp);
         if (status != 0)
             __cilkrts_bug("Cilk runtime error: thread creation (%d) failed: %d\n", i, status);
     }
@@ -302,6 +403,11 @@ void __cilkrts_start_workers(global_state_t *g, int n)
     if (!g->sysdep->threads)
         return;
 
+#ifdef CILK_CAN_PIN_WORKERS
+    if (g->pin_workers)
+        pin_workers(g, n);
+#endif
+
     // Do we actually have any threads to create?
     if (n > 0)
     {
@@ -170,6 +170,8 @@ struct file_hash_entry_pool
 static bool open_file (_cpp_file *file);
 static bool pch_open_file (cpp_reader *pfile, _cpp_file *file,
 			   bool *invalid_pch);
+static bool dir_may_contain (cpp_reader *pfile, cpp_dir *dir,
+			     const char *fname);
 static bool find_file_in_dir (cpp_reader *pfile, _cpp_file *file,
 			      bool *invalid_pch, source_location loc);
 static bool read_file_guts (cpp_reader *pfile, _cpp_file *file,
@@ -193,6 +195,7 @@ static struct cpp_file_hash_entry *new_file_hash_entry (cpp_reader *pfile);
 static int report_missing_guard (void **slot, void *b);
 static hashval_t file_hash_hash (const void *p);
 static int file_hash_eq (const void *p, const void *q);
+static int nonexistent_file_hash_eq (const void *p, const void *q);
 static char *read_filename_string (int ch, FILE *f);
 static void read_name_map (cpp_dir *dir);
 static char *remap_filename (cpp_reader *pfile, _cpp_file *file);
@@ -369,6 +372,88 @@ maybe_shorter_path (const char * file)
     }
 }
 
+/* The contents of an include directory, as read once by
+   dir_may_contain.  ENTRIES is NULL if the directory could not be
+   read, in which case nothing is known about it.  */
+struct dir_contents
+{
+  const char *name;
+  struct htab *entries;
+};
+
+/* Return false if DIR is known not to contain the first component of
+   FNAME, so that looking FNAME up in DIR is bound to fail; return
+   true otherwise.  The directory is read the first time it is asked
+   about, which replaces one failed open per include per directory
+   with a single scan of each directory.  Only used for
+   -fcache-include-dirs, since files added to DIR afterwards are not
+   seen.  */
+
+static bool
+dir_may_contain (cpp_reader *pfile ATTRIBUTE_UNUSED,
+		 cpp_dir *dir ATTRIBUTE_UNUSED,
+		 const char *fname ATTRIBUTE_UNUSED)
+{
+#if defined (HAVE_DIRENT_H) && !defined (HAVE_DOS_BASED_FILE_SYSTEM)
+  struct dir_contents *contents;
+  size_t len;
+  char *first;
+  void **slot;
+  bool found;
+
+  if (dir->len == 0 || dir->construct || IS_ABSOLUTE_PATH (fname))
+    return true;
+
+  slot = htab_find_slot_with_hash (pfile->dir_contents_hash, dir->name,
+				   htab_hash_string (dir->name), INSERT);
+  contents = (struct dir_contents *) *slot;
+  if (contents == NULL)
+    {
+      DIR *d;
+      struct dirent *de;
+
+      contents = XOBNEW (&pfile->nonexistent_file_ob, struct dir_contents);
+      contents->name = (char *) obstack_copy0 (&pfile->nonexistent_file_ob,
+					       dir->name, dir->len);
+      contents->entries = NULL;
+      *slot = contents;
+
+      d = opendir (dir->name);
+      if (d == NULL)
+	return true;
+      contents->entries = htab_create_alloc (127, htab_hash_string,
+					     nonexistent_file_hash_eq,
+					     NULL, xcalloc, free);
+      while ((de = readdir (d)) != NULL)
+	{
+	  len = strlen (de->d_name);
+	  slot = htab_find_slot_with_hash (contents->entries, de->d_name,
+					   htab_hash_string (de->d_name),
+					   INSERT);
+	  if (*slot == NULL)
+	    *slot = obstack_copy0 (&pfile->nonexistent_file_ob,
+				   de->d_name, len);
+	}
+      closedir (d);
+    }
+
+  if (contents->entries == NULL)
+    return true;
+
+  for (len = 0; fname[len] && !IS_DIR_SEPARATOR (fname[len]); len++)
+    ;
+  first = XNEWVEC (char, len + 1);
+  memcpy (first, fname, len);
+  first[len] = '\0';
+  found = htab_find_with_hash (contents->entries, first,
+			       htab_hash_string (first)) != NULL;
+  free (first);
+  return found;
+#else
+  return true;
+#endif
+}
+
 /* Try to open the path FILE->name appended to FILE->dir.  This is
    where remap and PCH intercept the file lookup process.  Return true
    if the file was found, whether or not the open was successful.
@@ -381,6 +466,18 @@ find_file_in_dir (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch,
 {
   char *path;
 
+  /* Remapped names and PCH files can be found under names other than
+     FILE->name, so the directory contents say nothing about them.  */
+  if (CPP_OPTION (pfile, cache_include_dirs)
+      && !CPP_OPTION (pfile, remap)
+      && !pfile->cb.valid_pch
+      && !dir_may_contain (pfile, file->dir, file->name))
+    {
+      file->err_no = ENOENT;
+      file->path = file->name;
+      return false;
+    }
+
   if (CPP_OPTION (pfile, remap) && (path = remap_filename (pfile, file)))
     ;
   else
@@ -1302,6 +1399,32 @@ nonexistent_file_hash_eq (const void *p, const void *q)
   return filename_cmp ((const char *) p, (const char *) q) == 0;
 }
 
+/* Hash and compare entries in the directory contents hash table.  The
+   lookup key is the directory name.  */
+static hashval_t
+dir_contents_hash_hash (const void *p)
+{
+  return htab_hash_string (((const struct dir_contents *) p)->name);
+}
+
+static int
+dir_contents_hash_eq (const void *p, const void *q)
+{
+  return filename_cmp (((const struct dir_contents *) p)->name,
+		       (const char *) q) == 0;
+}
+
+/* Free the table of names of a directory contents entry.  The entry
+   itself lives on the nonexistent file obstack.  */
+static void
+dir_contents_hash_del (void *p)
+{
+  struct dir_contents *contents = (struct dir_contents *) p;
+
+  if (contents->entries)
+    htab_delete (contents->entries);
+}
+
 /* Initialize everything in this source file.  */
 void
 _cpp_init_files (cpp_reader *pfile)
@@ -1316,6 +1439,10 @@ _cpp_init_files (cpp_reader *pfile)
 						    NULL, xcalloc, free);
   obstack_specify_allocation (&pfile->nonexistent_file_ob, 0, 0,
 			      xmalloc, free);
+  pfile->dir_contents_hash = htab_create_alloc (31, dir_contents_hash_hash,
+						dir_contents_hash_eq,
+						dir_contents_hash_del,
+						xcalloc, free);
 }
 
 /* Finalize everything in this source file.  */
@@ -1325,6 +1452,7 @@ _cpp_cleanup_files (cpp_reader *pfile)
   htab_delete (pfile->file_hash);
   htab_delete (pfile->dir_hash);
   htab_delete (pfile->nonexistent_file_hash);
+  htab_delete (pfile->dir_contents_hash);
   obstack_free (&pfile->nonexistent_file_ob, 0);
   free_file_hash_entries (pfile);
   destroy_all_cpp_files (pfile);
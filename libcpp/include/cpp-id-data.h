@@ -51,6 +51,11 @@ struct GTY(()) cpp_macro {
     const unsigned char * GTY ((tag ("1"))) text;
   } GTY ((desc ("%1.traditional"))) exp;
 
+  /* For an object-like macro, the locations array of the macro map of
+     its first tracked expansion, shared by the maps of the later ones.
+     NULL until then.  */
+  source_location * GTY((atomic)) exp_locations;
+
   /* Definition line number.  */
   source_location line;
 
@@ -544,6 +544,10 @@ struct cpp_options
 
   /* True enables canonicalization of system header file paths. */
   bool canonical_system_headers;
+
+  /* True means read the contents of each include directory once and
+     use them to rule out lookups of names it does not contain.  */
+  bool cache_include_dirs;
 };
 
 /* Callback for header lookup for HEADER, which is the name of a
@@ -209,16 +209,20 @@ struct cpp_context
      we are in a macro context, this is a pointer to an instance of
      cpp_hashnode, representing the name of the macro this context is
      for.  If we are not in a macro context, then this is just NULL.
-     Note that when tokens_kind is TOKEN_KIND_EXTENDED, the memory
-     used by the instance of macro_context pointed to by this member
-     is de-allocated upon de-allocation of the instance of struct
-     cpp_context.  */
+     Note that when tokens_kind is TOKEN_KIND_EXTENDED, the instance
+     of macro_context pointed to by this member is MC_STORAGE below,
+     so it lives as long as the instance of struct cpp_context.  */
   union
   {
     macro_context *mc;
     cpp_hashnode *macro;
   } c;
 
+  /* The storage for c.mc.  Contexts are recycled by depth rather than
+     freed when popped, so this saves allocating a macro_context for
+     each tracked macro expansion.  */
+  macro_context mc_storage;
+
   /* This determines the type of tokens held by this context.  */
   enum context_tokens_kind tokens_kind;
 };
@@ -453,6 +457,9 @@ struct cpp_reader
   struct htab *nonexistent_file_hash;
   struct obstack nonexistent_file_ob;
 
+  /* Contents of include directories, for -fcache-include-dirs.  */
+  struct htab *dir_contents_hash;
+
   /* Nonzero means don't look for #include "foo" the source-file
      directory.  */
   bool quote_ignores_source_dir;
@@ -842,11 +849,14 @@ ufputs (const unsigned char *s, FILE *f)
    invocations, it's best to make it point to the closing parenthesis
    of the macro, rather than the the location of the first character
    of the macro.  NUM_TOKENS is the number of tokens that are part of
-   the replacement-list of MACRO.  */
+   the replacement-list of MACRO.  If LOCATIONS is non-NULL, it is the
+   locations array of an earlier map for the same expansion-list,
+   which the new map shares instead of allocating its own.  */
 const line_map_macro *linemap_enter_macro (struct line_maps *,
 					   struct cpp_hashnode*,
 					   source_location,
-					   unsigned int);
+					   unsigned int,
+					   source_location *);
 
 /* Create and return a virtual location for a token that is part of a
    macro expansion-list at a macro expansion point.  See the comment
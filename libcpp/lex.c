@@ -487,6 +487,65 @@ search_line_sse42 (const uchar *s, const uchar *end)
 #define search_line_sse42 search_line_sse2
 #endif
 
+#if defined(HAVE_AVX2) && GCC_VERSION >= 4007
+/* A version of the fast scanner using AVX2 vectorized byte compare insns.
+   This is the SSE2 algorithm with 32-byte blocks; aligned loads never
+   cross a page boundary, so reading past END up to the terminating
+   newline is safe.  */
+
+static const uchar *
+#ifndef __AVX2__
+__attribute__((__target__("avx2")))
+#endif
+search_line_avx2 (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+  typedef char v32qi __attribute__ ((__vector_size__ (32)));
+
+  const v32qi repl_nl
+    = __builtin_ia32_pbroadcastb256 (*(const v16qi *)repl_chars[0]);
+  const v32qi repl_cr
+    = __builtin_ia32_pbroadcastb256 (*(const v16qi *)repl_chars[1]);
+  const v32qi repl_bs
+    = __builtin_ia32_pbroadcastb256 (*(const v16qi *)repl_chars[2]);
+  const v32qi repl_qm
+    = __builtin_ia32_pbroadcastb256 (*(const v16qi *)repl_chars[3]);
+
+  unsigned int misalign, found, mask;
+  const v32qi *p;
+  v32qi data, t;
+
+  /* Align the source pointer.  */
+  misalign = (uintptr_t)s & 31;
+  p = (const v32qi *)((uintptr_t)s & -32);
+  data = *p;
+
+  /* Create a mask for the bytes that are valid within the first
+     32-byte block.  */
+  mask = -1u << misalign;
+
+  /* Main loop processing 32 bytes at a time.  */
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      t  = __builtin_ia32_pcmpeqb256 (data, repl_nl);
+      t |= __builtin_ia32_pcmpeqb256 (data, repl_cr);
+      t |= __builtin_ia32_pcmpeqb256 (data, repl_bs);
+      t |= __builtin_ia32_pcmpeqb256 (data, repl_qm);
+      found = __builtin_ia32_pmovmskb256 (t);
+      found &= mask;
+    }
+  while (!found);
+
+  found = __builtin_ctz (found);
+  return (const uchar *)p + found;
+}
+#endif
+
 /* Check the CPU capabilities.  */
 
 #include "../gcc/config/i386/cpuid.h"
@@ -528,6 +587,25 @@ init_vectorized_lexer (void)
 	impl = search_line_mmx;
     }
 
+#if defined(HAVE_AVX2) && GCC_VERSION >= 4007
+  /* Prefer AVX2 when both the CPU and the OS support it; the latter
+     means the OS saves the YMM state, as reported by XGETBV.  */
+  if (impl == search_line_sse42 || impl == search_line_sse2)
+    {
+      unsigned eax, ebx, xcr0;
+
+      if (__get_cpuid_max (0, 0) >= 7
+	  && __get_cpuid (1, &dummy, &dummy, &ecx, &edx)
+	  && (ecx & (bit_OSXSAVE | bit_AVX)) == (bit_OSXSAVE | bit_AVX))
+	{
+	  __asm__ (".byte 0x0f, 0x01, 0xd0" : "=a" (xcr0) : "c" (0) : "edx");
+	  __cpuid_count (7, 0, eax, ebx, ecx, edx);
+	  if ((xcr0 & 6) == 6 && (ebx & bit_AVX2))
+	    impl = search_line_avx2;
+	}
+    }
+#endif
+
   search_line_fast = impl;
 }
 
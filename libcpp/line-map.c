@@ -109,7 +109,8 @@ rebuild_location_adhoc_htab (struct line_maps *set)
 {
   unsigned i;
   set->location_adhoc_data_map.htab =
-      htab_create (100, location_adhoc_data_hash, location_adhoc_data_eq, NULL);
+      htab_create_linear (100, location_adhoc_data_hash, location_adhoc_data_eq,
+			  NULL);
   for (i = 0; i < set->location_adhoc_data_map.curr_loc; i++)
     htab_find_slot (set->location_adhoc_data_map.htab,
 		    set->location_adhoc_data_map.data + i, INSERT);
@@ -351,7 +352,8 @@ linemap_init (struct line_maps *set,
   set->highest_location = RESERVED_LOCATION_COUNT - 1;
   set->highest_line = RESERVED_LOCATION_COUNT - 1;
   set->location_adhoc_data_map.htab =
-      htab_create (100, location_adhoc_data_hash, location_adhoc_data_eq, NULL);
+      htab_create_linear (100, location_adhoc_data_hash, location_adhoc_data_eq,
+			  NULL);
   set->builtin_location = builtin_location;
 }
 
@@ -604,7 +606,10 @@ linemap_tracks_macro_expansion_locs_p (struct line_maps *set)
    invocations, it's best to make it point to the closing parenthesis
    of the macro, rather than the the location of the first character
    of the macro.  NUM_TOKENS is the number of tokens that are part of
-   the replacement-list of MACRO.
+   the replacement-list of MACRO.  If LOCATIONS is non-NULL, it is the
+   locations array of an earlier map whose tokens have exactly the
+   same locations as the ones of the new map; it is shared rather than
+   allocating 2 * NUM_TOKENS new locations.
 
    Note that when we run out of the integer space available for source
    locations, this function returns NULL.  In that case, callers of
@@ -613,7 +618,8 @@ linemap_tracks_macro_expansion_locs_p (struct line_maps *set)
 
 const line_map_macro *
 linemap_enter_macro (struct line_maps *set, struct cpp_hashnode *macro_node,
-		     source_location expansion, unsigned int num_tokens)
+		     source_location expansion, unsigned int num_tokens,
+		     source_location *locations)
 {
   line_map_macro *map;
   source_location start_location;
@@ -634,13 +640,18 @@ linemap_enter_macro (struct line_maps *set, struct cpp_hashnode *macro_node,
   map->start_location = start_location;
   map->macro = macro_node;
   map->n_tokens = num_tokens;
-  map->macro_locations
-    = (source_location*) reallocator (NULL,
-				      2 * num_tokens
-				      * sizeof (source_location));
   map->expansion = expansion;
-  memset (MACRO_MAP_LOCATIONS (map), 0,
-	  num_tokens * sizeof (source_location));
+  if (locations)
+    map->macro_locations = locations;
+  else
+    {
+      map->macro_locations
+	= (source_location*) reallocator (NULL,
+					  2 * num_tokens
+					  * sizeof (source_location));
+      memset (MACRO_MAP_LOCATIONS (map), 0,
+	      num_tokens * sizeof (source_location));
+    }
 
   LINEMAPS_MACRO_CACHE (set) = LINEMAPS_MACRO_USED (set) - 1;
 
@@ -956,6 +967,13 @@ linemap_ordinary_map_lookup (struct line_maps *set, source_location line)
     {
       if (mn + 1 == mx || line < MAP_START_LOCATION (&cached[1]))
 	return cached;
+      /* Locations tend to be looked up in the order they were
+	 allocated, so try the following map before searching.  */
+      if (mn + 2 == mx || line < MAP_START_LOCATION (&cached[2]))
+	{
+	  LINEMAPS_ORDINARY_CACHE (set) = mn + 1;
+	  return &cached[1];
+	}
     }
   else
     {
@@ -1897,6 +1915,8 @@ linemap_get_statistics (struct line_maps *set,
     macro_maps_locations_size = 0, duplicated_macro_maps_locations_size = 0;
 
   const line_map_macro *cur_map;
+  htab_t seen_locations = htab_create (37, htab_hash_pointer,
+				       htab_eq_pointer, NULL);
 
   ordinary_maps_allocated_size =
     LINEMAPS_ORDINARY_ALLOCATED (set) * sizeof (struct line_map_ordinary);
@@ -1915,6 +1935,15 @@ linemap_get_statistics (struct line_maps *set,
 
       linemap_assert (linemap_macro_expansion_map_p (cur_map));
 
+      /* Count locations arrays shared by several maps only once.  */
+      if (MACRO_MAP_NUM_MACRO_TOKENS (cur_map) == 0)
+	continue;
+      void **slot = htab_find_slot (seen_locations,
+				    MACRO_MAP_LOCATIONS (cur_map), INSERT);
+      if (*slot)
+	continue;
+      *slot = MACRO_MAP_LOCATIONS (cur_map);
+
       macro_maps_locations_size +=
 	2 * MACRO_MAP_NUM_MACRO_TOKENS (cur_map) * sizeof (source_location);
 
@@ -1926,6 +1955,7 @@ linemap_get_statistics (struct line_maps *set,
 	      sizeof (source_location);
 	}
     }
+  htab_delete (seen_locations);
 
   macro_maps_used_size =
     LINEMAPS_MACRO_USED (set) * sizeof (struct line_map_macro);
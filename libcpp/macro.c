@@ -473,7 +473,7 @@ builtin_macro (cpp_reader *pfile, cpp_hashnode *node,
       source_location *virt_locs = NULL;
       _cpp_buff *token_buf = tokens_buff_new (pfile, 1, &virt_locs);
       const line_map_macro * map =
-	linemap_enter_macro (pfile->line_table, node, loc, 1);
+	linemap_enter_macro (pfile->line_table, node, loc, 1, NULL);
       tokens_buff_add_token (token_buf, virt_locs, token,
 			     pfile->line_table->builtin_location,
 			     pfile->line_table->builtin_location,
@@ -1192,9 +1192,13 @@ enter_macro_context (cpp_reader *pfile, cpp_hashnode *node,
 
 	      /* Create a macro map to record the locations of the
 		 tokens that are involved in the expansion. LOCATION
-		 is the location of the macro expansion point.  */
+		 is the location of the macro expansion point.  The
+		 tokens of an object-like macro have the same
+		 locations in every expansion, so all its maps share
+		 the locations array of the first one.  */
 	      map = linemap_enter_macro (pfile->line_table,
-					 node, location, tokens_count);
+					 node, location, tokens_count,
+					 macro->exp_locations);
 	      for (i = 0; i < tokens_count; ++i)
 		{
 		  tokens_buff_add_token (macro_tokens, virt_locs,
@@ -1202,6 +1206,8 @@ enter_macro_context (cpp_reader *pfile, cpp_hashnode *node,
 					 src->src_loc, map, i);
 		  ++src;
 		}
+	      if (map)
+		macro->exp_locations = MACRO_MAP_LOCATIONS (map);
 	      push_extended_tokens_context (pfile, node,
 					    macro_tokens,
 					    virt_locs,
@@ -1667,7 +1673,7 @@ replace_args (cpp_reader *pfile, cpp_hashnode *node, cpp_macro *macro,
 	num_macro_tokens = exp_count;
       map = linemap_enter_macro (pfile->line_table, node,
 				 expansion_point_loc,
-				 num_macro_tokens);
+				 num_macro_tokens, NULL);
     }
   i = 0;
   for (src = macro->exp.tokens; src < limit; src++)
@@ -1925,6 +1931,10 @@ next_context (cpp_reader *pfile)
   return result;
 }
 
+/* Token buffers of popped contexts up to this size go back to the
+   free buffer list; larger ones are freed.  */
+#define MAX_RECYCLED_CONTEXT_BUFF_SIZE (16 * 1024)
+
 /* Push a list of pointers to tokens.  */
 static void
 push_ptoken_context (cpp_reader *pfile, cpp_hashnode *macro, _cpp_buff *buff,
@@ -1991,7 +2001,7 @@ push_extended_tokens_context (cpp_reader *pfile,
   context->tokens_kind = TOKENS_KIND_EXTENDED;
   context->buff = token_buff;
 
-  m = XNEW (macro_context);
+  m = &context->mc_storage;
   m->macro_node = macro;
   m->virt_locs = virt_locs;
   m->cur_virt_loc = virt_locs;
@@ -2026,10 +2036,9 @@ tokens_buff_new (cpp_reader *pfile, size_t len,
 		 source_location **virt_locs)
 {
   size_t tokens_size = len * sizeof (cpp_token *);
-  size_t locs_size = len * sizeof (source_location);
 
   if (virt_locs != NULL)
-    *virt_locs = XNEWVEC (source_location, locs_size);
+    *virt_locs = XNEWVEC (source_location, len);
   return _cpp_get_buff (pfile, tokens_size);
 }
 
@@ -2313,7 +2322,6 @@ _cpp_pop_context (cpp_reader *pfile)
 	      free (mc->virt_locs);
 	      mc->virt_locs = NULL;
 	    }
-	  free (mc);
 	  context->c.mc = NULL;
 	}
       else
@@ -2341,15 +2349,20 @@ _cpp_pop_context (cpp_reader *pfile)
 
   if (context->buff)
     {
-      /* Decrease memory peak consumption by freeing the memory used
-	 by the context.  */
-      _cpp_free_buff (context->buff);
+      /* Recycle the small buffers most expansions use; decrease
+	 memory peak consumption by freeing the larger ones.  */
+      if (context->buff->next == NULL
+	  && (size_t) (context->buff->limit - context->buff->base)
+	     <= MAX_RECYCLED_CONTEXT_BUFF_SIZE)
+	_cpp_release_buff (pfile, context->buff);
+      else
+	_cpp_free_buff (context->buff);
+      context->buff = NULL;
     }
 
+  /* Keep the context itself for the next expansion at this depth;
+     there are only as many contexts as the maximum nesting depth.  */
   pfile->context = context->prev;
-  /* decrease peak memory consumption by feeing the context.  */
-  pfile->context->next = NULL;
-  free (context);
 }
 
 /* Return TRUE if we reached the end of the set of tokens stored in
@@ -3206,6 +3219,7 @@ _cpp_create_definition (cpp_reader *pfile, cpp_hashnode *node)
   macro->count = 0;
   macro->fun_like = 0;
   macro->extra_tokens = 0;
+  macro->exp_locations = NULL;
   /* To suppress some diagnostics.  */
   macro->syshdr = pfile->buffer && pfile->buffer->sysp != 0;
 
@@ -259,6 +259,10 @@ extern int errno;
 # endif
 #endif
 
+#ifdef HAVE_DIRENT_H
+# include <dirent.h>
+#endif
+
 #ifdef HAVE_LOCALE_H
 # include <locale.h>
 #endif
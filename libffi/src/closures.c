@@ -600,6 +600,79 @@ segment_holding_code (mstate m, char* addr)
 }
 #endif
 
+/* Closures that were freed recently are kept in a small per-thread
+   cache, so that code creating and freeing closures at a high rate
+   does not take the dlmalloc lock for each of them.  A cached chunk
+   holds the link to the next one and its executable address.  */
+#define FFI_CLOSURE_CACHE 1
+
+/* Maximum number of closures cached by each thread.  */
+#define CLOSURE_CACHE_MAX 32
+
+struct closure_cache_entry
+{
+  struct closure_cache_entry *next;
+  void *code;
+};
+
+struct closure_cache
+{
+  struct closure_cache_entry *head;
+  unsigned int count;
+};
+
+static pthread_key_t closure_cache_key;
+static pthread_once_t closure_cache_once = PTHREAD_ONCE_INIT;
+static int closure_cache_usable;
+
+/* Give the closures cached by an exiting thread back to dlmalloc.  */
+static void
+closure_cache_destroy (void *p)
+{
+  struct closure_cache *cache = p;
+
+  while (cache->head)
+    {
+      struct closure_cache_entry *e = cache->head;
+
+      cache->head = e->next;
+      dlfree (e);
+    }
+  free (cache);
+}
+
+static void
+closure_cache_init (void)
+{
+  closure_cache_usable
+    = pthread_key_create (&closure_cache_key, closure_cache_destroy) == 0;
+}
+
+/* Return the calling thread's closure cache, creating it if CREATE
+   is nonzero.  Returns NULL if there is none.  */
+static struct closure_cache *
+get_closure_cache (int create)
+{
+  struct closure_cache *cache;
+
+  pthread_once (&closure_cache_once, closure_cache_init);
+  if (!closure_cache_usable)
+    return NULL;
+
+  cache = pthread_getspecific (closure_cache_key);
+  if (!cache && create)
+    {
+      cache = calloc (1, sizeof (*cache));
+      if (cache && pthread_setspecific (closure_cache_key, cache) != 0)
+	{
+	  free (cache);
+	  cache = NULL;
+	}
+    }
+
+  return cache;
+}
+
 #endif /* !(defined(X86_WIN32) || defined(X86_WIN64) || defined(__OS2__)) || defined (__CYGWIN__) || defined(__INTERIX) */
 
 /* Allocate a chunk of memory with the given size.  Returns a pointer
@@ -613,6 +686,22 @@ ffi_closure_alloc (size_t size, void **code)
   if (!code)
     return NULL;
 
+#if FFI_CLOSURE_CACHE
+  {
+    struct closure_cache *cache = get_closure_cache (0);
+
+    if (cache && cache->head && dlmalloc_usable_size (cache->head) >= size)
+      {
+	struct closure_cache_entry *e = cache->head;
+
+	cache->head = e->next;
+	cache->count--;
+	*code = e->code;
+	return e;
+      }
+  }
+#endif
+
   ptr = dlmalloc (size);
 
   if (ptr)
@@ -639,6 +728,25 @@ ffi_closure_free (void *ptr)
     ptr = sub_segment_exec_offset (ptr, seg);
 #endif
 
+#if FFI_CLOSURE_CACHE
+  if (ptr)
+    {
+      struct closure_cache *cache = get_closure_cache (1);
+      msegmentptr seg = segment_holding (gm, ptr);
+
+      if (cache && seg && cache->count < CLOSURE_CACHE_MAX)
+	{
+	  struct closure_cache_entry *e = ptr;
+
+	  e->code = add_segment_exec_offset (ptr, seg);
+	  e->next = cache->head;
+	  cache->head = e;
+	  cache->count++;
+	  return;
+	}
+    }
+#endif
+
   dlfree (ptr);
 }
 
@@ -31,7 +31,8 @@ __bid_adddd3 (_Decimal64 x, _Decimal64 y) {
 
   ux.d = x;
   uy.d = y;
-  res.i = __bid64_add (ux.i, uy.i);
+  if (!__bid64_fast_add (ux.i, uy.i, &res.i))
+    res.i = __bid64_add (ux.i, uy.i);
   return (res.d);
 }
 
@@ -41,6 +42,7 @@ __bid_subdd3 (_Decimal64 x, _Decimal64 y) {
 
   ux.d = x;
   uy.d = y;
-  res.i = __bid64_sub (ux.i, uy.i);
+  if (!__bid64_fast_add (ux.i, uy.i ^ BID64_FAST_SIGN, &res.i))
+    res.i = __bid64_sub (ux.i, uy.i);
   return (res.d);
 }
@@ -29,9 +29,12 @@ CMPtype
 __bid_gedd2 (_Decimal64 x, _Decimal64 y) {
   CMPtype res;
   union decimal64 ux, uy;
+  int c;
  
   ux.d = x;
   uy.d = y;
+  if (__bid64_fast_compare (ux.i, uy.i, &c))
+    return c >= 0 ? 1 : -1;
   res = __bid64_quiet_greater_equal (ux.i, uy.i);
   if (res == 0) res = -1;
 
@@ -31,6 +31,7 @@ __bid_muldd3 (_Decimal64 x, _Decimal64 y) {
  
   ux.d = x;
   uy.d = y;
-  res.i = __bid64_mul (ux.i, uy.i);
+  if (!__bid64_fast_mul (ux.i, uy.i, &res.i))
+    res.i = __bid64_mul (ux.i, uy.i);
   return (res.d);
 }
@@ -281,6 +281,114 @@ union float128 {
   UINT128 i;
 };
 #endif
+
+/* Fast paths for _Decimal64 operands that are finite and have their
+   coefficient in the low 53 bits of the encoding.  When such operands
+   have the same exponent, as values of one scale such as amounts of
+   money do, their sum, difference and order only need integer
+   arithmetic on the coefficients.  The same holds for a product
+   whose coefficient still fits.  These results are exact, so they
+   neither depend on the rounding mode nor raise exceptions.  The
+   functions return 0 when the general code is needed.  */
+
+#define BID64_FAST_SIGN		0x8000000000000000ull
+#define BID64_FAST_STEERING	0x6000000000000000ull
+#define BID64_FAST_EXP		0x7fe0000000000000ull
+#define BID64_FAST_COEFF	0x001fffffffffffffull
+
+static __inline__ int
+__bid64_fast_p (UINT64 x)
+{
+  return (x & BID64_FAST_STEERING) != BID64_FAST_STEERING;
+}
+
+/* Store X + Y in *RES.  */
+static __inline__ int
+__bid64_fast_add (UINT64 x, UINT64 y, UINT64 *res)
+{
+  UINT64 cx, cy, c, sign;
+
+  if (!__bid64_fast_p (x) || !__bid64_fast_p (y)
+      || ((x ^ y) & BID64_FAST_EXP) != 0)
+    return 0;
+
+  cx = x & BID64_FAST_COEFF;
+  cy = y & BID64_FAST_COEFF;
+  if (((x ^ y) & BID64_FAST_SIGN) == 0)
+    {
+      c = cx + cy;
+      sign = x & BID64_FAST_SIGN;
+    }
+  else if (cx > cy)
+    {
+      c = cx - cy;
+      sign = x & BID64_FAST_SIGN;
+    }
+  else if (cy > cx)
+    {
+      c = cy - cx;
+      sign = y & BID64_FAST_SIGN;
+    }
+  else
+    /* The sign of an exact zero depends on the rounding mode.  */
+    return 0;
+
+  if (c > BID64_FAST_COEFF)
+    return 0;
+  *res = sign | (x & BID64_FAST_EXP) | c;
+  return 1;
+}
+
+/* Store X * Y in *RES.  */
+static __inline__ int
+__bid64_fast_mul (UINT64 x, UINT64 y, UINT64 *res)
+{
+  UINT64 cx, cy, c;
+  int e;
+
+  if (!__bid64_fast_p (x) || !__bid64_fast_p (y))
+    return 0;
+
+  cx = x & BID64_FAST_COEFF;
+  cy = y & BID64_FAST_COEFF;
+  if ((cx >> 32) != 0 || (cy >> 32) != 0)
+    return 0;
+  c = cx * cy;
+  if (c > BID64_FAST_COEFF)
+    return 0;
+
+  /* The biased exponent of the result must be in [0, 767].  */
+  e = (int) ((x & BID64_FAST_EXP) >> 53) + (int) ((y & BID64_FAST_EXP) >> 53)
+      - 398;
+  if (e < 0 || e > 767)
+    return 0;
+
+  *res = ((x ^ y) & BID64_FAST_SIGN) | ((UINT64) e << 53) | c;
+  return 1;
+}
+
+/* Store -1, 0 or 1 in *RES as X is less than, equal to or greater
+   than Y.  */
+static __inline__ int
+__bid64_fast_compare (UINT64 x, UINT64 y, int *res)
+{
+  long long sx, sy;
+
+  if (!__bid64_fast_p (x) || !__bid64_fast_p (y)
+      || ((x ^ y) & BID64_FAST_EXP) != 0)
+    return 0;
+
+  /* Coefficients are below 2^53, so they fit as signed values, and
+     +0 and -0 compare equal.  */
+  sx = (long long) (x & BID64_FAST_COEFF);
+  sy = (long long) (y & BID64_FAST_COEFF);
+  if (x & BID64_FAST_SIGN)
+    sx = -sx;
+  if (y & BID64_FAST_SIGN)
+    sy = -sy;
+  *res = (sx > sy) - (sx < sy);
+  return 1;
+}
 #endif  /* BID_HAS_GCC_DECIMAL_INTRINSICS */
 
 #endif /* _BID_GCC_INTRINSICS_H */
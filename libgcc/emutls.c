@@ -62,6 +62,19 @@ static __gthread_mutex_t emutls_mutex;
 static __gthread_key_t emutls_key;
 static pointer emutls_size;
 
+/* Where each thread keeps its struct __emutls_array.  A target with a
+   register or a native thread slot to spare can define these in
+   libgcc_tm.h, to avoid the __gthread_getspecific call on every access.
+   They are only used after emutls_init has run.  */
+#ifndef EMUTLS_GET_THREAD_ARRAY
+#define EMUTLS_GET_THREAD_ARRAY() \
+  ((struct __emutls_array *) __gthread_getspecific (emutls_key))
+#endif
+#ifndef EMUTLS_SET_THREAD_ARRAY
+#define EMUTLS_SET_THREAD_ARRAY(ARR) \
+  __gthread_setspecific (emutls_key, (void *) (ARR))
+#endif
+
 static void
 emutls_destroy (void *ptr)
 {
@@ -87,6 +100,26 @@ emutls_init (void)
   if (__gthread_key_create (&emutls_key, emutls_destroy) != 0)
     abort ();
 }
+
+/* Give OBJ its index in the per-thread arrays, if it has none yet.  */
+
+static pointer
+emutls_assign_offset (struct __emutls_object *obj)
+{
+  static __gthread_once_t once = __GTHREAD_ONCE_INIT;
+  pointer offset;
+
+  __gthread_once (&once, emutls_init);
+  __gthread_mutex_lock (&emutls_mutex);
+  offset = obj->loc.offset;
+  if (offset == 0)
+    {
+      offset = ++emutls_size;
+      __atomic_store_n (&obj->loc.offset, offset, __ATOMIC_RELEASE);
+    }
+  __gthread_mutex_unlock (&emutls_mutex);
+  return offset;
+}
 #endif
 
 static void *
@@ -123,36 +156,20 @@ emutls_alloc (struct __emutls_object *obj)
   return ret;
 }
 
-void *
-__emutls_get_address (struct __emutls_object *obj)
-{
-  if (! __gthread_active_p ())
-    {
-      if (__builtin_expect (obj->loc.ptr == NULL, 0))
-	obj->loc.ptr = emutls_alloc (obj);
-      return obj->loc.ptr;
-    }
+#ifdef __GTHREADS
+/* Everything __emutls_get_address does on the first access of a thread
+   to OBJ: assign its offset, grow the thread's array and allocate the
+   thread's copy of OBJ.  */
 
-#ifndef __GTHREADS
-  abort ();
-#else
+static void * __attribute__ ((noinline))
+emutls_get_address_slow (struct __emutls_object *obj)
+{
   pointer offset = __atomic_load_n (&obj->loc.offset, __ATOMIC_ACQUIRE);
 
   if (__builtin_expect (offset == 0, 0))
-    {
-      static __gthread_once_t once = __GTHREAD_ONCE_INIT;
-      __gthread_once (&once, emutls_init);
-      __gthread_mutex_lock (&emutls_mutex);
-      offset = obj->loc.offset;
-      if (offset == 0)
-	{
-	  offset = ++emutls_size;
-	  __atomic_store_n (&obj->loc.offset, offset, __ATOMIC_RELEASE);
-	}
-      __gthread_mutex_unlock (&emutls_mutex);
-    }
+    offset = emutls_assign_offset (obj);
 
-  struct __emutls_array *arr = __gthread_getspecific (emutls_key);
+  struct __emutls_array *arr = EMUTLS_GET_THREAD_ARRAY ();
   if (__builtin_expect (arr == NULL, 0))
     {
       pointer size = offset + 32;
@@ -160,7 +177,7 @@ __emutls_get_address (struct __emutls_object *obj)
       if (arr == NULL)
 	abort ();
       arr->size = size;
-      __gthread_setspecific (emutls_key, (void *) arr);
+      EMUTLS_SET_THREAD_ARRAY (arr);
     }
   else if (__builtin_expect (offset > arr->size, 0))
     {
@@ -174,7 +191,7 @@ __emutls_get_address (struct __emutls_object *obj)
       arr->size = size;
       memset (arr->data + orig_size, 0,
 	      (size - orig_size) * sizeof (void *));
-      __gthread_setspecific (emutls_key, (void *) arr);
+      EMUTLS_SET_THREAD_ARRAY (arr);
     }
 
   void *ret = arr->data[offset - 1];
@@ -184,6 +201,38 @@ __emutls_get_address (struct __emutls_object *obj)
       arr->data[offset - 1] = ret;
     }
   return ret;
+}
+#endif
+
+void *
+__emutls_get_address (struct __emutls_object *obj)
+{
+  if (! __gthread_active_p ())
+    {
+      if (__builtin_expect (obj->loc.ptr == NULL, 0))
+	obj->loc.ptr = emutls_alloc (obj);
+      return obj->loc.ptr;
+    }
+
+#ifndef __GTHREADS
+  abort ();
+#else
+  /* A nonzero offset means emutls_init has run, so the thread array
+     can be read.  Objects normally get their offset when registered.  */
+  pointer offset = __atomic_load_n (&obj->loc.offset, __ATOMIC_ACQUIRE);
+
+  if (__builtin_expect (offset != 0, 1))
+    {
+      struct __emutls_array *arr = EMUTLS_GET_THREAD_ARRAY ();
+      if (__builtin_expect (arr != NULL && offset <= arr->size, 1))
+	{
+	  void *ret = arr->data[offset - 1];
+	  if (__builtin_expect (ret != NULL, 1))
+	    return ret;
+	}
+    }
+
+  return emutls_get_address_slow (obj);
 #endif
 }
 
@@ -200,4 +249,11 @@ __emutls_register_common (struct __emutls_object *obj,
     obj->align = align;
   if (templ && size == obj->size)
     obj->templ = templ;
+
+#ifdef __GTHREADS
+  /* Take the mutex now, in the constructor, rather than on the first
+     access.  Without threads, LOC holds the object itself instead.  */
+  if (__gthread_active_p ())
+    emutls_assign_offset (obj);
+#endif
 }
@@ -65,7 +65,8 @@ static pthread_once_t create_key_once = PTHREAD_ONCE_INIT;
 
 /* Release all the segments for a thread.  This is the destructor
    function used by pthread_key_create, and is called when a thread
-   exits.  */
+   exits.  The segments go to the shared pool, if there is room, so
+   that the next thread to split its stack need not map new ones.  */
 
 static void
 free_segments (void* arg)
@@ -135,6 +135,10 @@ __splitstack_find_context (void *context[10], size_t *, void **, void **,
 			   void **)
   __attribute__ ((visibility ("default")));
 
+extern void
+__splitstack_getstats (size_t *, size_t *, size_t *)
+  __attribute__ ((visibility ("default")));
+
 /* These functions must be defined by the processor specific code.  */
 
 extern void *__morestack_get_guard (void)
@@ -193,8 +197,15 @@ struct initial_sp
      uintptr_type because it replaced one of the void * pointers in
      extra.  */
   uintptr_type dont_block_signals;
+  /* The number of times this thread has split the stack, the number
+     of those splits that needed a new segment, and the number of new
+     segments taken from the pool rather than mapped.  These replaced
+     three of the void * pointers in extra.  */
+  uintptr_type splits;
+  uintptr_type allocations;
+  uintptr_type pool_hits;
   /* Some extra space for later extensibility.  */
-  void *extra[4];
+  void *extra[1];
 };
 
 /* A list of memory blocks allocated by dynamic stack allocation.
@@ -243,6 +254,80 @@ __thread struct initial_sp __morestack_initial_sp
 
 static sigset_t __morestack_fullmask;
 
+/* Segments released by one thread are kept here for any thread to
+   reuse, so that a thread which exits, or a stack which is released,
+   does not cost a munmap now and an mmap later.  The list is linked
+   through the next field and holds at most MORESTACK_POOL_SIZE
+   segments.  The lock is only ever tried, never waited for: this code
+   may run in a signal handler or on very little stack, and falling
+   back to mmap or munmap is always correct.  */
+
+#ifndef MORESTACK_POOL_SIZE
+#define MORESTACK_POOL_SIZE 16
+#endif
+
+#ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
+#define USE_MORESTACK_POOL (MORESTACK_POOL_SIZE > 0)
+#else
+#define USE_MORESTACK_POOL 0
+#endif
+
+static struct stack_segment *morestack_pool;
+static unsigned int morestack_pool_count;
+static int morestack_pool_lock;
+
+/* Take a segment with at least SIZE usable bytes from the pool.
+   Return NULL if there is none, or if the pool is busy.  */
+
+static struct stack_segment *
+morestack_pool_get (size_t size)
+{
+  struct stack_segment **pp;
+  struct stack_segment *pss;
+
+  if (!USE_MORESTACK_POOL
+      || __atomic_load_n (&morestack_pool, __ATOMIC_RELAXED) == NULL
+      || __sync_lock_test_and_set (&morestack_pool_lock, 1) != 0)
+    return NULL;
+
+  for (pp = &morestack_pool; *pp != NULL; pp = &(*pp)->next)
+    if ((*pp)->size >= size)
+      break;
+  pss = *pp;
+  if (pss != NULL)
+    {
+      *pp = pss->next;
+      --morestack_pool_count;
+    }
+
+  __sync_lock_release (&morestack_pool_lock);
+  return pss;
+}
+
+/* Give PSS to the pool.  Return zero if the pool is full or busy, in
+   which case the caller must unmap it.  */
+
+static int
+morestack_pool_put (struct stack_segment *pss)
+{
+  int ret;
+
+  if (!USE_MORESTACK_POOL
+      || __sync_lock_test_and_set (&morestack_pool_lock, 1) != 0)
+    return 0;
+
+  ret = morestack_pool_count < MORESTACK_POOL_SIZE;
+  if (ret)
+    {
+      pss->next = morestack_pool;
+      __atomic_store_n (&morestack_pool, pss, __ATOMIC_RELAXED);
+      ++morestack_pool_count;
+    }
+
+  __sync_lock_release (&morestack_pool_lock);
+  return ret;
+}
+
 /* Convert an integer to a decimal string without using much stack
    space.  Return a pointer to the part of the buffer to use.  We this
    instead of sprintf because sprintf will require too much stack
@@ -360,6 +445,17 @@ allocate_segment (size_t frame_size)
     allocate = ((frame_size + overhead + pagesize - 1)
 		& ~ (pagesize - 1));
 
+  ++__morestack_initial_sp.allocations;
+
+  pss = morestack_pool_get (allocate - overhead);
+  if (pss != NULL)
+    {
+      ++__morestack_initial_sp.pool_hits;
+      pss->prev = NULL;
+      pss->next = NULL;
+      return pss;
+    }
+
   if (use_guard_page)
     allocate += pagesize;
 
@@ -438,8 +534,9 @@ merge_dynamic_blocks (struct dynamic_allocation_blocks *a,
   return a;
 }
 
-/* Release stack segments.  If FREE_DYNAMIC is non-zero, we also free
-   any dynamic blocks.  Otherwise we return them.  */
+/* Release stack segments to the pool, or unmap them if it is full.
+   If FREE_DYNAMIC is non-zero, we also free any dynamic blocks.
+   Otherwise we return them.  */
 
 struct dynamic_allocation_blocks *
 __morestack_release_segments (struct stack_segment **pp, int free_dynamic)
@@ -469,6 +566,14 @@ __morestack_release_segments (struct stack_segment **pp, int free_dynamic)
 	      ret = merge_dynamic_blocks (pss->dynamic_allocation, ret);
 	      ret = merge_dynamic_blocks (pss->free_dynamic_allocation, ret);
 	    }
+	  pss->dynamic_allocation = NULL;
+	  pss->free_dynamic_allocation = NULL;
+	}
+
+      if (morestack_pool_put (pss))
+	{
+	  pss = next;
+	  continue;
 	}
 
       allocate = pss->size + sizeof (struct stack_segment);
@@ -554,18 +659,29 @@ __generic_morestack (size_t *pframe_size, void *old_stack, size_t param_size)
   size_t i;
   size_t aligned;
 
+  size_t min_size;
+
   current = __morestack_current_segment;
+  ++__morestack_initial_sp.splits;
 
+  /* A next segment which is too small is replaced by one at least
+     twice its size, so that a frame which keeps outgrowing the cached
+     segment does not keep replacing it.  */
+  min_size = frame_size + param_size;
   pp = current != NULL ? &current->next : &__morestack_segments;
   if (*pp != NULL && (*pp)->size < frame_size)
-    dynamic = __morestack_release_segments (pp, 0);
+    {
+      if (min_size < (*pp)->size * 2)
+	min_size = (*pp)->size * 2;
+      dynamic = __morestack_release_segments (pp, 0);
+    }
   else
     dynamic = NULL;
   current = *pp;
 
   if (current == NULL)
     {
-      current = allocate_segment (frame_size + param_size);
+      current = allocate_segment (min_size);
       current->prev = __morestack_current_segment;
       *pp = current;
     }
@@ -961,6 +1077,25 @@ __splitstack_find (void *segment_arg, void *sp, size_t *len,
   return ret;
 }
 
+/* Report how this thread has split its stack: the number of splits,
+   the number of those that needed a new segment, and the number of
+   new segments that were reused from another thread or stack rather
+   than mapped.  A high ratio of splits to new segments in a short
+   time means that some function call straddles a segment boundary in
+   a loop.  Any argument may be NULL.  */
+
+void
+__splitstack_getstats (size_t *splits, size_t *allocations,
+		       size_t *pool_hits)
+{
+  if (splits != NULL)
+    *splits = __morestack_initial_sp.splits;
+  if (allocations != NULL)
+    *allocations = __morestack_initial_sp.allocations;
+  if (pool_hits != NULL)
+    *pool_hits = __morestack_initial_sp.pool_hits;
+}
+
 /* Tell the split stack code whether it has to block signals while
    manipulating the stack.  This is for programs in which some threads
    block all signals.  If a thread already blocks signals, there is no
@@ -128,10 +128,52 @@ create_file_directory (char *filename)
 #endif
 }
 
+/* Return a copy of PREFIX in which each "%p" is replaced by the process
+   id, or NULL if PREFIX contains no "%p".  Each process then writes its
+   own tree of gcda files, without reading and merging files written by
+   other processes; gcov-tool merge combines the trees later on.  */
+
+static char *
+expand_gcov_prefix (const char *prefix)
+{
+#ifdef TARGET_POSIX_IO
+  const char *probe;
+  char pid[32];
+  size_t pid_length;
+  unsigned count = 0;
+  char *expanded, *dst;
+
+  for (probe = prefix; (probe = strstr (probe, "%p")); probe += 2)
+    count++;
+  if (!count)
+    return NULL;
+
+  sprintf (pid, "%ld", (long) getpid ());
+  pid_length = strlen (pid);
+  expanded = (char *) xmalloc (strlen (prefix) + count * pid_length + 1);
+  for (dst = expanded; *prefix;)
+    if (prefix[0] == '%' && prefix[1] == 'p')
+      {
+        memcpy (dst, pid, pid_length);
+        dst += pid_length;
+        prefix += 2;
+      }
+    else
+      *dst++ = *prefix++;
+  *dst = '\0';
+
+  return expanded;
+#else
+  (void) prefix;
+  return NULL;
+#endif
+}
+
 static void
 allocate_filename_struct (struct gcov_filename *gf)
 {
   const char *gcov_prefix;
+  char *expanded_prefix = NULL;
   size_t prefix_length;
   int strip = 0;
 
@@ -150,6 +192,10 @@ allocate_filename_struct (struct gcov_filename *gf)
 
   /* Get file name relocation prefix.  Non-absolute values are ignored. */
   gcov_prefix = getenv("GCOV_PREFIX");
+  if (gcov_prefix)
+    expanded_prefix = expand_gcov_prefix (gcov_prefix);
+  if (expanded_prefix)
+    gcov_prefix = expanded_prefix;
   prefix_length = gcov_prefix ? strlen (gcov_prefix) : 0;
   
   /* Remove an unnecessary trailing '/' */
@@ -169,14 +215,14 @@ allocate_filename_struct (struct gcov_filename *gf)
   gf->filename = (char *) xmalloc (gf->max_length + prefix_length + 2);
   if (prefix_length)
     memcpy (gf->filename, gcov_prefix, prefix_length);
+  free (expanded_prefix);
 }
 
-/* Open a gcda file specified by GI_FILENAME.
-   Return -1 on error.  Return 0 on success.  */
+/* Build in GF the name of the gcda file of GI_PTR, relocated by
+   GCOV_PREFIX and GCOV_PREFIX_STRIP.  */
 
-static int
-gcov_exit_open_gcda_file (struct gcov_info *gi_ptr,
-			  struct gcov_filename *gf)
+static void
+build_gcda_filename (const struct gcov_info *gi_ptr, struct gcov_filename *gf)
 {
   const char *fname = gi_ptr->filename;
   char *dst = gf->filename + gf->prefix;
@@ -215,6 +261,16 @@ gcov_exit_open_gcda_file (struct gcov_info *gi_ptr,
 	*dst++ = '/';
     }
   strcpy (dst, fname);
+}
+
+/* Open a gcda file specified by GI_FILENAME.
+   Return -1 on error.  Return 0 on success.  */
+
+static int
+gcov_exit_open_gcda_file (struct gcov_info *gi_ptr,
+			  struct gcov_filename *gf)
+{
+  build_gcda_filename (gi_ptr, gf);
 
   if (!gcov_open (gf->filename))
     {
@@ -39,6 +39,9 @@ void __gcov_init (struct gcov_info *p __attribute__ ((unused))) {}
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/stat.h>
+#if !IN_GCOV_TOOL
+#include <sys/mman.h>
+#endif
 #endif
 
 #ifdef L_gcov
@@ -822,6 +825,88 @@ read_fatal:;
 }
 
 
+/* Add the thread shards of the arc counters of the objects in LIST to
+   their first shard, and clear them.  */
+
+static void
+gcov_fold_shards (struct gcov_info *list)
+{
+  struct gcov_info *gi_ptr;
+
+  for (gi_ptr = list; gi_ptr; gi_ptr = gi_ptr->next)
+    {
+      unsigned f_ix;
+
+      if (gi_ptr->n_shards <= 1 || !gi_ptr->merge[GCOV_COUNTER_ARCS])
+	continue;
+
+      for (f_ix = 0; f_ix < gi_ptr->n_functions; f_ix++)
+	{
+	  const struct gcov_fn_info *gfi_ptr = gi_ptr->functions[f_ix];
+	  const struct gcov_ctr_info *ci_ptr;
+	  unsigned stride, s_ix, ix;
+
+	  if (!gfi_ptr || gfi_ptr->key != gi_ptr)
+	    continue;
+
+	  /* The arc counters come first.  */
+	  ci_ptr = &gfi_ptr->ctrs[0];
+	  stride = GCOV_SHARD_STRIDE (ci_ptr->num);
+	  for (s_ix = 1; s_ix < gi_ptr->n_shards; s_ix++)
+	    {
+	      gcov_type *shard = ci_ptr->values + s_ix * stride;
+	      for (ix = 0; ix < ci_ptr->num; ix++)
+		{
+		  ci_ptr->values[ix] += shard[ix];
+		  shard[ix] = 0;
+		}
+	    }
+	}
+    }
+}
+
+/* Add the arc counters of the objects in LIST that are updated in their
+   memory-mapped counter file, see gcov_map_counters, to the counters in
+   memory, and clear them in the file.  */
+
+static void
+gcov_fold_mapped_counters (struct gcov_info *list)
+{
+  struct gcov_info *gi_ptr;
+
+  for (gi_ptr = list; gi_ptr; gi_ptr = gi_ptr->next)
+    {
+      unsigned f_ix;
+
+      if (!gi_ptr->bias || !*gi_ptr->bias
+	  || !gi_ptr->merge[GCOV_COUNTER_ARCS])
+	continue;
+
+      for (f_ix = 0; f_ix < gi_ptr->n_functions; f_ix++)
+	{
+	  const struct gcov_fn_info *gfi_ptr = gi_ptr->functions[f_ix];
+	  const struct gcov_ctr_info *ci_ptr;
+	  gcov_type *mapped;
+	  unsigned num, ix;
+
+	  if (!gfi_ptr || gfi_ptr->key != gi_ptr)
+	    continue;
+
+	  /* The arc counters come first.  */
+	  ci_ptr = &gfi_ptr->ctrs[0];
+	  num = ci_ptr->num;
+	  if (gi_ptr->n_shards > 1)
+	    num = GCOV_SHARD_STRIDE (num) * gi_ptr->n_shards;
+	  mapped = (gcov_type *) ((char *) ci_ptr->values + *gi_ptr->bias);
+	  for (ix = 0; ix < num; ix++)
+	    {
+	      ci_ptr->values[ix] += mapped[ix];
+	      mapped[ix] = 0;
+	    }
+	}
+    }
+}
+
 /* Dump all the coverage counts for the program. It first computes program
    summary and then traverses gcov_list list and dumps the gcov_info
    objects one by one.  */
@@ -838,6 +923,8 @@ gcov_do_dump (struct gcov_info *list, int run_counted)
   struct gcov_summary all_prg;
   struct gcov_summary this_prg;
 
+  gcov_fold_mapped_counters (list);
+  gcov_fold_shards (list);
   crc32 = compute_summary (list, &this_prg, &gf.max_length);
 
   allocate_filename_struct (&gf);
@@ -872,6 +959,9 @@ struct gcov_root __gcov_root;
 struct gcov_master __gcov_master = 
   {GCOV_VERSION, 0};
 
+/* Per-dynamic-object value profile sampling period.  */
+gcov_unsigned_t __gcov_value_sample_period = 1;
+
 void
 __gcov_exit (void)
 {
@@ -886,6 +976,128 @@ __gcov_exit (void)
   gcov_error_exit ();
 }
 
+#if GCOV_LOCKED
+/* Suffix appended to the gcda file name to name the memory-mapped
+   counter file of an object.  */
+#define GCOV_COUNTER_FILE_SUFFIX ".ctrs"
+
+/* Magic number of the memory-mapped counter files, "gcnt".  */
+#define GCOV_COUNTER_FILE_MAGIC ((gcov_unsigned_t)0x67636e74)
+
+/* Header of the memory-mapped counter file of an object compiled with
+   -fprofile-continuous.  The arc counters of the object follow it, at the
+   same offsets from each other as in memory.  */
+
+struct gcov_counter_file
+{
+  gcov_unsigned_t magic;	/* GCOV_COUNTER_FILE_MAGIC */
+  gcov_unsigned_t stamp;	/* stamp of the object */
+  gcov_type size;		/* size of the counters, in bytes */
+};
+
+/* Map a file next to the gcda file of GI_PTR, an object compiled with
+   -fprofile-continuous, and make the code of the object update its arc
+   counters there.  The kernel writes them back as the program runs, so
+   they survive the process being killed.  Counts left in the file by a
+   run that did not dump its profile are kept, and end up in the gcda
+   file at the next dump.  On failure, the counters stay in memory.  */
+
+static void
+gcov_map_counters (struct gcov_info *gi_ptr)
+{
+  struct gcov_filename gf;
+  struct gcov_counter_file header, *mapped;
+  struct stat st;
+  char *lo = 0, *hi = 0;
+  size_t size;
+  unsigned f_ix;
+  void *map;
+  int fd;
+
+  for (f_ix = 0; f_ix < gi_ptr->n_functions; f_ix++)
+    {
+      const struct gcov_fn_info *gfi_ptr = gi_ptr->functions[f_ix];
+      const struct gcov_ctr_info *ci_ptr;
+      unsigned num;
+
+      if (!gfi_ptr || gfi_ptr->key != gi_ptr)
+	continue;
+
+      /* The arc counters come first.  */
+      ci_ptr = &gfi_ptr->ctrs[0];
+      num = ci_ptr->num;
+      if (!num)
+	continue;
+      if (gi_ptr->n_shards > 1)
+	num = GCOV_SHARD_STRIDE (num) * gi_ptr->n_shards;
+      if (!lo || (char *) ci_ptr->values < lo)
+	lo = (char *) ci_ptr->values;
+      if ((char *) (ci_ptr->values + num) > hi)
+	hi = (char *) (ci_ptr->values + num);
+    }
+  if (!lo)
+    return;
+  size = sizeof (struct gcov_counter_file) + (hi - lo);
+
+  gf.max_length = strlen (gi_ptr->filename) + strlen (GCOV_COUNTER_FILE_SUFFIX);
+  allocate_filename_struct (&gf);
+  build_gcda_filename (gi_ptr, &gf);
+  strcat (gf.filename, GCOV_COUNTER_FILE_SUFFIX);
+
+  fd = open (gf.filename, O_RDWR | O_CREAT, 0666);
+  if (fd < 0 && !create_file_directory (gf.filename))
+    fd = open (gf.filename, O_RDWR | O_CREAT, 0666);
+  if (fd < 0)
+    {
+      gcov_error ("profiling:%s:Cannot open
+", gf.filename);
+      goto out;
+    }
+
+  /* Start from an empty file unless it holds the counters of this very
+     object.  Another process may still map the old file, so replace it
+     rather than truncate it.  */
+  if (fstat (fd, &st)
+      || (size_t) st.st_size != size
+      || read (fd, &header, sizeof (header)) != sizeof (header)
+      || header.magic != GCOV_COUNTER_FILE_MAGIC
+      || header.stamp != gi_ptr->stamp
+      || header.size != (gcov_type) (hi - lo))
+    {
+      close (fd);
+      unlink (gf.filename);
+      fd = open (gf.filename, O_RDWR | O_CREAT, 0666);
+      if (fd < 0 || ftruncate (fd, size))
+	{
+	  gcov_error ("profiling:%s:Cannot create counter file
+",
+		      gf.filename);
+	  if (fd >= 0)
+	    close (fd);
+	  goto out;
+	}
+    }
+
+  map = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      gcov_error ("profiling:%s:Cannot map counter file
+", gf.filename);
+      goto out;
+    }
+
+  mapped = (struct gcov_counter_file *) map;
+  mapped->magic = GCOV_COUNTER_FILE_MAGIC;
+  mapped->stamp = gi_ptr->stamp;
+  mapped->size = hi - lo;
+  *gi_ptr->bias = (char *) (mapped + 1) - lo;
+
+out:
+  free (gf.filename);
+}
+#endif /* GCOV_LOCKED */
+
 /* Add a new object file onto the bb chain.  Invoked automatically
   when running an object file's global ctors.  */
 
@@ -898,6 +1110,11 @@ __gcov_init (struct gcov_info *info)
     {
       if (!__gcov_root.list)
 	{
+	  const char *period = getenv ("GCOV_VALUE_SAMPLE_PERIOD");
+
+	  if (period && atoi (period) > 1)
+	    __gcov_value_sample_period = atoi (period);
+
 	  /* Add to master list and at exit function.  */
 	  if (gcov_version (NULL, __gcov_master.version, "<master>"))
 	    {
@@ -910,6 +1127,11 @@ __gcov_init (struct gcov_info *info)
 
       info->next = __gcov_root.list;
       __gcov_root.list = info;
+
+#if GCOV_LOCKED
+      if (info->bias)
+	gcov_map_counters (info);
+#endif
     }
 }
 #endif /* !IN_GCOV_TOOL */
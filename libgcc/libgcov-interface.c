@@ -119,7 +119,17 @@ gcov_clear (const struct gcov_info *list)
               if (!gi_ptr->merge[t_ix])
                 continue;
 
-              memset (ci_ptr->values, 0, sizeof (gcov_type) * ci_ptr->num);
+              gcov_unsigned_t num = ci_ptr->num;
+
+              /* Clear the thread shards of the arc counters too.  */
+              if (t_ix == GCOV_COUNTER_ARCS && gi_ptr->n_shards > 1)
+                num = GCOV_SHARD_STRIDE (num) * gi_ptr->n_shards;
+              memset (ci_ptr->values, 0, sizeof (gcov_type) * num);
+
+              /* And their copy in the memory-mapped counter file.  */
+              if (t_ix == GCOV_COUNTER_ARCS && gi_ptr->bias && *gi_ptr->bias)
+                memset ((char *) ci_ptr->values + *gi_ptr->bias, 0,
+                        sizeof (gcov_type) * num);
               ci_ptr++;
             }
         }
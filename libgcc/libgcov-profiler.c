@@ -37,6 +37,32 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
 #endif
 #endif
 
+/* Return the weight with which a value profiler records this call: the
+   sampling period for one call out of each __gcov_value_sample_period,
+   and zero for the others, which need not touch the counters at all.
+   The countdown is kept per thread where TLS is available.  */
+
+static inline gcov_type
+__gcov_value_sample_weight (void)
+{
+#if defined(HAVE_CC_TLS) && !defined (USE_EMUTLS)
+  static __thread gcov_unsigned_t countdown;
+#else
+  static gcov_unsigned_t countdown;
+#endif
+  gcov_unsigned_t period = __gcov_value_sample_period;
+
+  if (__builtin_expect (period <= 1, 1))
+    return 1;
+  if (countdown != 0)
+    {
+      countdown--;
+      return 0;
+    }
+  countdown = period - 1;
+  return period;
+}
+
 #ifdef L_gcov_interval_profiler
 /* If VALUE is in interval <START, START + STEPS - 1>, then increases the
    corresponding counter in COUNTERS.  If the VALUE is above or below
@@ -108,33 +134,38 @@ __gcov_pow2_profiler_atomic (gcov_type *counters, gcov_type value)
 
 /* Tries to determine the most common value among its inputs.  Checks if the
    value stored in COUNTERS[0] matches VALUE.  If this is the case, COUNTERS[1]
-   is incremented.  If this is not the case and COUNTERS[1] is not zero,
-   COUNTERS[1] is decremented.  Otherwise COUNTERS[1] is set to one and
-   VALUE is stored to COUNTERS[0].  This algorithm guarantees that if this
-   function is called more than 50% of the time with one value, this value
-   will be in COUNTERS[0] in the end.
+   is increased by the sampling weight.  If this is not the case, COUNTERS[1]
+   is decreased by the weight, and if that would take it below zero, VALUE
+   replaces COUNTERS[0] and keeps the difference.  This algorithm guarantees
+   that if this function is called more than 50% of the time with one value,
+   this value will be in COUNTERS[0] in the end.
 
-   In any case, COUNTERS[2] is incremented.  If USE_ATOMIC is set to 1,
-   COUNTERS[2] is updated with an atomic instruction.  */
+   In any case, COUNTERS[2] is increased by the weight.  If USE_ATOMIC is
+   set to 1, COUNTERS[2] is updated with an atomic instruction.  */
 
 static inline void
 __gcov_one_value_profiler_body (gcov_type *counters, gcov_type value,
 				int use_atomic)
 {
+  gcov_type weight = __gcov_value_sample_weight ();
+
+  if (weight == 0)
+    return;
+
   if (value == counters[0])
-    counters[1]++;
-  else if (counters[1] == 0)
+    counters[1] += weight;
+  else if (counters[1] < weight)
     {
-      counters[1] = 1;
+      counters[1] = weight - counters[1];
       counters[0] = value;
     }
   else
-    counters[1]--;
+    counters[1] -= weight;
 
   if (use_atomic)
-    __atomic_fetch_add (&counters[2], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add (&counters[2], weight, __ATOMIC_RELAXED);
   else
-    counters[2]++;
+    counters[2] += weight;
 }
 
 #ifdef L_gcov_one_value_profiler
@@ -184,6 +215,10 @@ __gcov_topn_value_profiler_body (gcov_type *counters, gcov_type value)
    gcov_type *value_array = &counters[1];
    gcov_type *num_eviction = &counters[0];
    gcov_unsigned_t topn_val = GCOV_ICALL_TOPN_VAL;
+   gcov_type weight = __gcov_value_sample_weight ();
+
+   if (weight == 0)
+     return;
 
    /* There are 2*topn_val values tracked, each value takes two slots in the
       counter array.  */
@@ -192,7 +227,7 @@ __gcov_topn_value_profiler_body (gcov_type *counters, gcov_type value)
        entry = &value_array[i];
        if (entry[0] == value)
          {
-           entry[1]++ ;
+           entry[1] += weight;
            found = 1;
            break;
          }
@@ -211,7 +246,7 @@ __gcov_topn_value_profiler_body (gcov_type *counters, gcov_type value)
    /* lfu_entry is either an empty entry or an entry
       with lowest count, which will be evicted.  */
    lfu_entry[0] = value;
-   lfu_entry[1] = 1;
+   lfu_entry[1] = weight;
 
 #define GCOV_ICALL_COUNTER_CLEAR_THRESHOLD 3000
 
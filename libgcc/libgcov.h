@@ -205,6 +205,11 @@ struct gcov_info
 #else
   const struct gcov_fn_info **functions;
 #endif /* !IN_GCOV_TOOL */
+
+  gcov_unsigned_t n_shards;	/* number of thread shards of the arc
+				   counters (0 or 1 for none) */
+  size_t *bias;			/* offset of the arc counters in the
+				   memory-mapped counter file, or NULL */
 };
 
 /* Root of a program/shared-object state */
@@ -228,6 +233,10 @@ struct gcov_master
 /* Exactly one of these will be active in the process.  */
 extern struct gcov_master __gcov_master;
 
+/* The value profilers record one call out of this many, with the
+   weight of all of them.  Set from GCOV_VALUE_SAMPLE_PERIOD.  */
+extern gcov_unsigned_t __gcov_value_sample_period ATTRIBUTE_HIDDEN;
+
 /* Dump a set of gcov objects.  */
 extern void __gcov_dump_one (struct gcov_root *) ATTRIBUTE_HIDDEN;
 
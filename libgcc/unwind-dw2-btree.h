@@ -0,0 +1,449 @@
+/* Lock-free B-tree mapping PC ranges to registered unwind objects.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GCC.
+
+   GCC is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   GCC is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef GCC_UNWIND_DW2_BTREE_H
+#define GCC_UNWIND_DW2_BTREE_H
+
+/* The tree stores non-overlapping [BASE, BASE + SIZE) ranges, each with
+   the struct object that describes it.  Lookups never take a lock: every
+   node carries a version counter that is odd while a writer modifies the
+   node, and readers restart from the root whenever a version they relied
+   on has changed.  Writers are not synchronized with each other here;
+   the caller must serialize btree_insert and btree_remove (object_mutex
+   does so in unwind-dw2-fde.c).
+
+   Nodes are never returned to malloc, only to a free list, so a reader
+   racing with a writer may see stale contents but never unmapped memory.
+   Every inner node child covers the keys up to and including its
+   separator, except the last child, which covers everything up to the
+   node's own upper bound.  Each stored range lies entirely within the
+   bounds of its leaf, so a lookup only ever visits one leaf.  */
+
+typedef __UINTPTR_TYPE__ uintptr_type;
+
+struct version_lock
+{
+  uintptr_type version;
+};
+
+/* Start a modification.  Writers are serialized by the caller, so this
+   never waits.  */
+
+static inline void
+version_lock_begin_write (struct version_lock *vl)
+{
+  uintptr_type v = __atomic_load_n (&vl->version, __ATOMIC_RELAXED);
+  __atomic_store_n (&vl->version, v + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+static inline void
+version_lock_end_write (struct version_lock *vl)
+{
+  uintptr_type v = __atomic_load_n (&vl->version, __ATOMIC_RELAXED);
+  __atomic_store_n (&vl->version, v + 1, __ATOMIC_RELEASE);
+}
+
+/* Take an optimistic snapshot of VL.  Fails if a writer is active.  */
+
+static inline int
+version_lock_begin_read (const struct version_lock *vl, uintptr_type *v)
+{
+  *v = __atomic_load_n (&vl->version, __ATOMIC_ACQUIRE);
+  return (*v & 1) == 0;
+}
+
+/* Check that nothing was modified since the snapshot V was taken.  */
+
+static inline int
+version_lock_validate (const struct version_lock *vl, uintptr_type v)
+{
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  return __atomic_load_n (&vl->version, __ATOMIC_RELAXED) == v;
+}
+
+enum btree_node_type
+{
+  btree_node_inner,
+  btree_node_leaf,
+  btree_node_free
+};
+
+struct inner_entry
+{
+  uintptr_type separator;
+  struct btree_node *child;
+};
+
+struct leaf_entry
+{
+  uintptr_type base, size;
+  struct object *ob;
+};
+
+/* Both entry arrays take about 240 bytes on a 64-bit host.  */
+#define BTREE_MAX_FANOUT_INNER 15
+#define BTREE_MAX_FANOUT_LEAF 10
+
+struct btree_node
+{
+  struct version_lock lock;
+  unsigned entry_count;
+  enum btree_node_type type;
+  union
+  {
+    struct inner_entry children[BTREE_MAX_FANOUT_INNER];
+    struct leaf_entry entries[BTREE_MAX_FANOUT_LEAF];
+  } content;
+};
+
+struct btree
+{
+  struct btree_node *root;
+  struct btree_node *free_list;
+  /* Protects ROOT.  */
+  struct version_lock root_lock;
+};
+
+static inline int
+btree_node_is_full (const struct btree_node *n)
+{
+  return n->entry_count == (n->type == btree_node_leaf
+			    ? BTREE_MAX_FANOUT_LEAF
+			    : BTREE_MAX_FANOUT_INNER);
+}
+
+/* Find the child of inner node N that covers ADDR.  COUNT is passed
+   separately because readers must clamp a possibly torn entry_count.  */
+
+static inline unsigned
+btree_node_find_inner_slot (const struct btree_node *n, unsigned count,
+			    uintptr_type addr)
+{
+  unsigned i;
+  for (i = 0; i + 1 < count; ++i)
+    if (n->content.children[i].separator >= addr)
+      break;
+  return i;
+}
+
+/* Allocate a node of type TYPE, reusing freed nodes if possible.  The
+   node is returned in the middle of a write.  */
+
+static struct btree_node *
+btree_allocate_node (struct btree *t, enum btree_node_type type)
+{
+  struct btree_node *n = t->free_list;
+  if (n)
+    {
+      version_lock_begin_write (&n->lock);
+      t->free_list = n->content.children[0].child;
+    }
+  else
+    {
+      n = malloc (sizeof (struct btree_node));
+      if (!n)
+	return NULL;
+      n->lock.version = 1;
+    }
+  n->entry_count = 0;
+  n->type = type;
+  return n;
+}
+
+/* Put N, which must be in the middle of a write, on the free list.  */
+
+static void
+btree_release_node (struct btree *t, struct btree_node *n)
+{
+  n->type = btree_node_free;
+  n->entry_count = 0;
+  n->content.children[0].child = t->free_list;
+  t->free_list = n;
+  version_lock_end_write (&n->lock);
+}
+
+/* Split the full child at SLOT of inner node PARENT, or the full root if
+   PARENT is null.  Returns false if no memory is available.  */
+
+static int
+btree_split (struct btree *t, struct btree_node *parent, unsigned slot)
+{
+  struct btree_node *n = parent ? parent->content.children[slot].child
+			 : t->root;
+  struct btree_node *right = btree_allocate_node (t, n->type);
+  struct btree_node *root = NULL;
+  unsigned count = n->entry_count, left_count = count / 2, i;
+  uintptr_type fence;
+
+  if (!right)
+    return 0;
+  if (!parent)
+    {
+      root = btree_allocate_node (t, btree_node_inner);
+      if (!root)
+	{
+	  btree_release_node (t, right);
+	  return 0;
+	}
+    }
+
+  version_lock_begin_write (&n->lock);
+  if (n->type == btree_node_leaf)
+    {
+      struct leaf_entry *last = &n->content.entries[left_count - 1];
+      for (i = left_count; i < count; ++i)
+	right->content.entries[i - left_count] = n->content.entries[i];
+      fence = last->base + last->size - 1;
+    }
+  else
+    {
+      for (i = left_count; i < count; ++i)
+	right->content.children[i - left_count] = n->content.children[i];
+      fence = n->content.children[left_count - 1].separator;
+    }
+  right->entry_count = count - left_count;
+  n->entry_count = left_count;
+
+  if (parent)
+    {
+      version_lock_begin_write (&parent->lock);
+      for (i = parent->entry_count; i > slot + 1; --i)
+	parent->content.children[i] = parent->content.children[i - 1];
+      parent->content.children[slot + 1].separator
+	= parent->content.children[slot].separator;
+      parent->content.children[slot + 1].child = right;
+      parent->content.children[slot].separator = fence;
+      ++parent->entry_count;
+      version_lock_end_write (&parent->lock);
+    }
+  else
+    {
+      root->content.children[0].separator = fence;
+      root->content.children[0].child = n;
+      root->content.children[1].separator = (uintptr_type) -1;
+      root->content.children[1].child = right;
+      root->entry_count = 2;
+      version_lock_end_write (&root->lock);
+
+      version_lock_begin_write (&t->root_lock);
+      t->root = root;
+      version_lock_end_write (&t->root_lock);
+    }
+
+  version_lock_end_write (&right->lock);
+  version_lock_end_write (&n->lock);
+  return 1;
+}
+
+/* Insert [BASE, BASE + SIZE) for OB.  The range must not overlap any
+   range already in T.  Returns false if no memory is available.  */
+
+static int
+btree_insert (struct btree *t, uintptr_type base, uintptr_type size,
+	      struct object *ob)
+{
+  uintptr_type last = base + size - 1;
+  struct btree_node *n;
+  unsigned i;
+
+  if (!size)
+    return 0;
+
+  if (!t->root)
+    {
+      n = btree_allocate_node (t, btree_node_leaf);
+      if (!n)
+	return 0;
+      version_lock_end_write (&n->lock);
+
+      version_lock_begin_write (&t->root_lock);
+      t->root = n;
+      version_lock_end_write (&t->root_lock);
+    }
+
+  /* Split full nodes on the way down, so that a parent always has room
+     for the separator of a split child.  */
+  if (btree_node_is_full (t->root) && !btree_split (t, NULL, 0))
+    return 0;
+
+  n = t->root;
+  while (n->type == btree_node_inner)
+    {
+      i = btree_node_find_inner_slot (n, n->entry_count, base);
+      if (btree_node_is_full (n->content.children[i].child))
+	{
+	  if (!btree_split (t, n, i))
+	    return 0;
+	  i = btree_node_find_inner_slot (n, n->entry_count, base);
+	}
+
+      /* After removals or a split a separator may fall inside the new
+	 range.  The children it would straddle cannot hold any range, so
+	 move their bounds up to the end of the new one.  */
+      if (i + 1 < n->entry_count && n->content.children[i].separator < last)
+	{
+	  unsigned j;
+	  version_lock_begin_write (&n->lock);
+	  for (j = i; j + 1 < n->entry_count
+		      && n->content.children[j].separator < last; ++j)
+	    n->content.children[j].separator = last;
+	  version_lock_end_write (&n->lock);
+	}
+      n = n->content.children[i].child;
+    }
+
+  version_lock_begin_write (&n->lock);
+  for (i = n->entry_count; i > 0 && n->content.entries[i - 1].base > base; --i)
+    n->content.entries[i] = n->content.entries[i - 1];
+  n->content.entries[i].base = base;
+  n->content.entries[i].size = size;
+  n->content.entries[i].ob = ob;
+  ++n->entry_count;
+  version_lock_end_write (&n->lock);
+  return 1;
+}
+
+/* Remove the range starting at BASE that was inserted for OB.  Returns
+   OB, or null if there is no such range.  A leaf that becomes empty is
+   unlinked from its parent; other underfull nodes are left alone.  */
+
+static struct object *
+btree_remove (struct btree *t, uintptr_type base, struct object *ob)
+{
+  struct btree_node *n = t->root, *parent = NULL;
+  unsigned i, slot = 0;
+
+  if (!n)
+    return NULL;
+
+  while (n->type == btree_node_inner)
+    {
+      parent = n;
+      slot = btree_node_find_inner_slot (n, n->entry_count, base);
+      n = n->content.children[slot].child;
+    }
+
+  for (i = 0; i < n->entry_count; ++i)
+    if (n->content.entries[i].base == base && n->content.entries[i].ob == ob)
+      break;
+  if (i == n->entry_count)
+    return NULL;
+
+  version_lock_begin_write (&n->lock);
+  for (; i + 1 < n->entry_count; ++i)
+    n->content.entries[i] = n->content.entries[i + 1];
+  --n->entry_count;
+
+  if (n->entry_count || !parent || parent->entry_count == 1)
+    {
+      version_lock_end_write (&n->lock);
+      return ob;
+    }
+
+  /* The neighbours take over the bounds of the empty leaf.  */
+  version_lock_begin_write (&parent->lock);
+  if (slot + 1 == parent->entry_count)
+    parent->content.children[slot - 1].separator
+      = parent->content.children[slot].separator;
+  for (i = slot; i + 1 < parent->entry_count; ++i)
+    parent->content.children[i] = parent->content.children[i + 1];
+  --parent->entry_count;
+  version_lock_end_write (&parent->lock);
+
+  btree_release_node (t, n);
+  return ob;
+}
+
+/* Find the object whose range contains ADDR, or null.  Never blocks.  */
+
+static struct object *
+btree_lookup (const struct btree *t, uintptr_type addr)
+{
+  const struct btree_node *n;
+  uintptr_type root_version, version, child_version;
+  unsigned count, i;
+
+ restart:
+  if (!version_lock_begin_read (&t->root_lock, &root_version))
+    goto restart;
+  n = __atomic_load_n (&t->root, __ATOMIC_RELAXED);
+  if (!n)
+    {
+      if (!version_lock_validate (&t->root_lock, root_version))
+	goto restart;
+      return NULL;
+    }
+  if (!version_lock_begin_read (&n->lock, &version)
+      || !version_lock_validate (&t->root_lock, root_version))
+    goto restart;
+
+  for (;;)
+    {
+      enum btree_node_type type = n->type;
+      count = n->entry_count;
+
+      if (type == btree_node_leaf)
+	{
+	  struct object *ob = NULL;
+	  if (count > BTREE_MAX_FANOUT_LEAF)
+	    count = BTREE_MAX_FANOUT_LEAF;
+	  for (i = 0; i < count; ++i)
+	    {
+	      const struct leaf_entry *e = &n->content.entries[i];
+	      if (e->base <= addr && addr - e->base < e->size)
+		{
+		  ob = e->ob;
+		  break;
+		}
+	    }
+	  if (!version_lock_validate (&n->lock, version))
+	    goto restart;
+	  return ob;
+	}
+
+      if (type != btree_node_inner || count == 0)
+	goto restart;
+      if (count > BTREE_MAX_FANOUT_INNER)
+	count = BTREE_MAX_FANOUT_INNER;
+
+      /* Check N before following the child pointer, and again after
+	 the child's snapshot: a child is unlinked from its parent before
+	 it is freed, so the second check proves it was not reused.  */
+      {
+	const struct btree_node *child;
+	i = btree_node_find_inner_slot (n, count, addr);
+	child = __atomic_load_n (&n->content.children[i].child,
+				 __ATOMIC_RELAXED);
+	if (!version_lock_validate (&n->lock, version)
+	    || !version_lock_begin_read (&child->lock, &child_version)
+	    || !version_lock_validate (&n->lock, version))
+	  goto restart;
+	n = child;
+	version = child_version;
+      }
+    }
+}
+
+#endif /* unwind-dw2-btree.h */
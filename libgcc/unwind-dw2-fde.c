@@ -42,6 +42,10 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
 #endif
 #endif
 
+#ifdef ATOMIC_FDE_FAST_PATH
+#include "unwind-dw2-btree.h"
+#endif
+
 /* The unseen_objects list contains objects that have been registered
    but not yet categorized in any way.  The seen_objects list has had
    its pc_begin and count fields initialized at minimum, and is sorted
@@ -49,7 +53,13 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
 static struct object *unseen_objects;
 static struct object *seen_objects;
 #ifdef ATOMIC_FDE_FAST_PATH
-static int any_objects_registered;
+/* Where the fast path looks objects up by PC, without object_mutex.
+   All registered objects stay on unseen_objects, which is only used to
+   find them again on deregistration.  Modifications of the tree are
+   serialized by object_mutex.  */
+static struct btree registered_frames;
+
+static void register_pc_range (struct object *);
 #endif
 
 #ifdef __GTHREAD_MUTEX_INIT
@@ -105,14 +115,12 @@ __register_frame_info_bases (const void *begin, struct object *ob,
   ob->next = unseen_objects;
   unseen_objects = ob;
 #ifdef ATOMIC_FDE_FAST_PATH
-  /* Set flag that at least one library has registered FDEs.
-     Use relaxed MO here, it is up to the app to ensure that the library
+  /* Publishing in the tree is what makes the object visible to
+     _Unwind_Find_FDE.  It is up to the app to ensure that the library
      loading/initialization happens-before using that library in other
      threads (in particular unwinding with that library's functions
-     appearing in the backtraces).  Calling that library's functions
-     without waiting for the library to initialize would be racy.  */
-  if (!any_objects_registered)
-    __atomic_store_n (&any_objects_registered, 1, __ATOMIC_RELAXED);
+     appearing in the backtraces).  */
+  register_pc_range (ob);
 #endif
 
   __gthread_mutex_unlock (&object_mutex);
@@ -159,14 +167,12 @@ __register_frame_info_table_bases (void *begin, struct object *ob,
   ob->next = unseen_objects;
   unseen_objects = ob;
 #ifdef ATOMIC_FDE_FAST_PATH
-  /* Set flag that at least one library has registered FDEs.
-     Use relaxed MO here, it is up to the app to ensure that the library
+  /* Publishing in the tree is what makes the object visible to
+     _Unwind_Find_FDE.  It is up to the app to ensure that the library
      loading/initialization happens-before using that library in other
      threads (in particular unwinding with that library's functions
-     appearing in the backtraces).  Calling that library's functions
-     without waiting for the library to initialize would be racy.  */
-  if (!any_objects_registered)
-    __atomic_store_n (&any_objects_registered, 1, __ATOMIC_RELAXED);
+     appearing in the backtraces).  */
+  register_pc_range (ob);
 #endif
 
   __gthread_mutex_unlock (&object_mutex);
@@ -211,12 +217,27 @@ __deregister_frame_info_bases (const void *begin)
   __gthread_mutex_lock (&object_mutex);
 
   for (p = &unseen_objects; *p ; p = &(*p)->next)
+#ifdef ATOMIC_FDE_FAST_PATH
+    /* Objects on the fast path are sorted in place, on this list.  */
+    if ((*p)->s.b.sorted
+	? (*p)->u.sort->orig_data == begin
+	: (*p)->u.single == begin)
+      {
+	ob = *p;
+	*p = ob->next;
+	btree_remove (&registered_frames, (uintptr_type) ob->pc_begin, ob);
+	if (ob->s.b.sorted)
+	  free (ob->u.sort);
+	goto out;
+      }
+#else
     if ((*p)->u.single == begin)
       {
 	ob = *p;
 	*p = ob->next;
 	goto out;
       }
+#endif
 
   for (p = &seen_objects; *p ; p = &(*p)->next)
     if ((*p)->s.b.sorted)
@@ -627,11 +648,13 @@ end_fde_sort (struct object *ob, struct fde_accumulator *accu, size_t count)
 
 
 /* Update encoding, mixed_encoding, and pc_begin for OB for the
-   fde array beginning at THIS_FDE.  Return the number of fdes
-   encountered along the way.  */
+   fde array beginning at THIS_FDE.  If PC_END is not null, raise it to
+   the end of the highest fde.  Return the number of fdes encountered
+   along the way.  */
 
 static size_t
-classify_object_over_fdes (struct object *ob, const fde *this_fde)
+classify_object_over_fdes (struct object *ob, const fde *this_fde,
+			   _Unwind_Ptr *pc_end)
 {
   const struct dwarf_cie *last_cie = 0;
   size_t count = 0;
@@ -641,7 +664,8 @@ classify_object_over_fdes (struct object *ob, const fde *this_fde)
   for (; ! last_fde (ob, this_fde); this_fde = next_fde (this_fde))
     {
       const struct dwarf_cie *this_cie;
-      _Unwind_Ptr mask, pc_begin;
+      _Unwind_Ptr mask, pc_begin, pc_range;
+      const unsigned char *p;
 
       /* Skip CIEs.  */
       if (this_fde->CIE_delta == 0)
@@ -663,8 +687,8 @@ classify_object_over_fdes (struct object *ob, const fde *this_fde)
 	    ob->s.b.mixed_encoding = 1;
 	}
 
-      read_encoded_value_with_base (encoding, base, this_fde->pc_begin,
-				    &pc_begin);
+      p = read_encoded_value_with_base (encoding, base, this_fde->pc_begin,
+					&pc_begin);
 
       /* Take care to ignore link-once functions that were removed.
 	 In these cases, the function address will be NULL, but if
@@ -682,11 +706,44 @@ classify_object_over_fdes (struct object *ob, const fde *this_fde)
       count += 1;
       if ((void *) pc_begin < ob->pc_begin)
 	ob->pc_begin = (void *) pc_begin;
+      if (pc_end)
+	{
+	  read_encoded_value_with_base (encoding & 0x0F, 0, p, &pc_range);
+	  if (pc_begin + pc_range > *pc_end)
+	    *pc_end = pc_begin + pc_range;
+	}
     }
 
   return count;
 }
 
+#ifdef ATOMIC_FDE_FAST_PATH
+/* Classify OB and insert the range of code it covers into
+   registered_frames.  Called with object_mutex held.  Objects that
+   cover no code, or that we cannot handle, are never found.  */
+
+static void
+register_pc_range (struct object *ob)
+{
+  _Unwind_Ptr pc_end = 0;
+
+  if (ob->s.b.from_array)
+    {
+      fde **p;
+      for (p = ob->u.array; *p; ++p)
+	if (classify_object_over_fdes (ob, *p, &pc_end) == (size_t) -1)
+	  return;
+    }
+  else if (classify_object_over_fdes (ob, ob->u.single, &pc_end)
+	   == (size_t) -1)
+    return;
+
+  if (pc_end > (_Unwind_Ptr) ob->pc_begin)
+    btree_insert (&registered_frames, (uintptr_type) ob->pc_begin,
+		  pc_end - (_Unwind_Ptr) ob->pc_begin, ob);
+}
+#endif
+
 static void
 add_fdes (struct object *ob, struct fde_accumulator *accu, const fde *this_fde)
 {
@@ -766,7 +823,7 @@ init_object (struct object* ob)
 	  fde **p = ob->u.array;
 	  for (count = 0; *p; ++p)
 	    {
-	      size_t cur_count = classify_object_over_fdes (ob, *p);
+	      size_t cur_count = classify_object_over_fdes (ob, *p, NULL);
 	      if (cur_count == (size_t) -1)
 		goto unhandled_fdes;
 	      count += cur_count;
@@ -774,7 +831,7 @@ init_object (struct object* ob)
 	}
       else
 	{
-	  count = classify_object_over_fdes (ob, ob->u.single);
+	  count = classify_object_over_fdes (ob, ob->u.single, NULL);
 	  if (count == (size_t) -1)
 	    {
 	      static const fde terminator;
@@ -815,7 +872,17 @@ init_object (struct object* ob)
   accu.linear->orig_data = ob->u.single;
   ob->u.sort = accu.linear;
 
+#ifdef ATOMIC_FDE_FAST_PATH
+  /* _Unwind_Find_FDE tests this flag without holding object_mutex.  */
+  {
+    __typeof (ob->s) s;
+    s.i = ob->s.i;
+    s.b.sorted = 1;
+    __atomic_store_n (&ob->s.i, s.i, __ATOMIC_RELEASE);
+  }
+#else
   ob->s.b.sorted = 1;
+#endif
 }
 
 /* A linear search through a set of FDEs for the given PC.  This is
@@ -1030,18 +1097,27 @@ _Unwind_Find_FDE (void *pc, struct dwarf_eh_bases *bases)
   const fde *f = NULL;
 
 #ifdef ATOMIC_FDE_FAST_PATH
-  /* For targets where unwind info is usually not registered through these
-     APIs anymore, avoid taking a global lock.
-     Use relaxed MO here, it is up to the app to ensure that the library
-     loading/initialization happens-before using that library in other
-     threads (in particular unwinding with that library's functions
-     appearing in the backtraces).  Calling that library's functions
-     without waiting for the library to initialize would be racy.  */
-  if (__builtin_expect (!__atomic_load_n (&any_objects_registered,
-					  __ATOMIC_RELAXED), 1))
+  /* Registered objects are looked up without taking a global lock, so
+     that threads unwinding concurrently do not serialize.  Only the
+     first search of an object sorts its FDEs under object_mutex.  */
+  ob = btree_lookup (&registered_frames, (uintptr_type) pc);
+  if (!ob)
     return NULL;
-#endif
 
+  {
+    __typeof (ob->s) s;
+    s.i = __atomic_load_n (&ob->s.i, __ATOMIC_ACQUIRE);
+    if (s.b.sorted)
+      f = search_object (ob, pc);
+    else
+      {
+	init_object_mutex_once ();
+	__gthread_mutex_lock (&object_mutex);
+	f = search_object (ob, pc);
+	__gthread_mutex_unlock (&object_mutex);
+      }
+  }
+#else
   init_object_mutex_once ();
   __gthread_mutex_lock (&object_mutex);
 
@@ -1078,6 +1154,7 @@ _Unwind_Find_FDE (void *pc, struct dwarf_eh_bases *bases)
 
  fini:
   __gthread_mutex_unlock (&object_mutex);
+#endif
 
   if (f)
     {
@@ -1219,6 +1219,111 @@ execute_cfa_program (const unsigned char *insn_ptr,
     }
 }
 
+#if defined (__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4) \
+    && !defined (FRAME_STATE_CACHE_SIZE)
+#define FRAME_STATE_CACHE_SIZE 128
+#endif
+
+#if defined (FRAME_STATE_CACHE_SIZE) && FRAME_STATE_CACHE_SIZE > 0
+#define USE_FRAME_STATE_CACHE 1
+#endif
+
+#ifdef USE_FRAME_STATE_CACHE
+/* Profilers and exception-heavy code unwind through the same return
+   addresses over and over.  Remember the decoded frame state for recent
+   ones in a direct-mapped table shared by all threads.  Each slot has a
+   version that is odd while it is written; readers copy the slot and
+   discard it if the version changed meanwhile, so lookups never block.
+
+   The FDE is still looked up for every frame, and a slot only matches
+   the FDE it was decoded from.  A PC in an object loaded where another
+   was unloaded therefore never uses stale data.  */
+
+struct frame_state_cache_entry
+{
+  unsigned int version __attribute__ ((mode (SI)));
+  void *ra;
+  _Unwind_Word signal_frame;
+  const struct dwarf_fde *fde;
+  void *lsda;
+  _Unwind_Word args_size;
+  _Unwind_FrameState fs;
+};
+
+static struct frame_state_cache_entry
+  frame_state_cache[FRAME_STATE_CACHE_SIZE];
+
+static inline struct frame_state_cache_entry *
+frame_state_cache_slot (void *ra)
+{
+  _Unwind_Ptr h = (_Unwind_Ptr) ra;
+  h ^= h >> 11;
+  return &frame_state_cache[h % FRAME_STATE_CACHE_SIZE];
+}
+
+/* Fill FS and the caller data in CONTEXT from the cache if the frame
+   at CONTEXT->ra, described by FDE, was decoded before.  */
+
+static int
+frame_state_cache_lookup (struct _Unwind_Context *context,
+			  const struct dwarf_fde *fde, _Unwind_FrameState *fs)
+{
+  struct frame_state_cache_entry *e = frame_state_cache_slot (context->ra);
+  unsigned int v __attribute__ ((mode (SI)));
+  void *lsda;
+  _Unwind_Word args_size;
+
+  v = __atomic_load_n (&e->version, __ATOMIC_ACQUIRE);
+  if ((v & 1) != 0
+      || e->ra != context->ra
+      || e->fde != fde
+      || e->signal_frame != _Unwind_IsSignalFrame (context))
+    return 0;
+
+  memcpy (fs, &e->fs, sizeof (*fs));
+  lsda = e->lsda;
+  args_size = e->args_size;
+
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  if (__atomic_load_n (&e->version, __ATOMIC_RELAXED) != v)
+    return 0;
+
+  context->lsda = lsda;
+  context->args_size = args_size;
+  return 1;
+}
+
+/* Remember FS and the caller data in CONTEXT for the frame at
+   CONTEXT->ra.  Gives up if another thread is writing the slot.  */
+
+static void
+frame_state_cache_insert (struct _Unwind_Context *context,
+			  const struct dwarf_fde *fde,
+			  const _Unwind_FrameState *fs)
+{
+  struct frame_state_cache_entry *e = frame_state_cache_slot (context->ra);
+  unsigned int v __attribute__ ((mode (SI)));
+
+  v = __atomic_load_n (&e->version, __ATOMIC_RELAXED);
+  if ((v & 1) != 0
+      || !__atomic_compare_exchange_n (&e->version, &v, v + 1, 0,
+				       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return;
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+
+  e->ra = context->ra;
+  e->signal_frame = _Unwind_IsSignalFrame (context);
+  e->fde = fde;
+  e->lsda = context->lsda;
+  e->args_size = context->args_size;
+  memcpy (&e->fs, fs, sizeof (*fs));
+  /* This points into the stack of execute_cfa_program, and is dead.  */
+  e->fs.regs.prev = NULL;
+
+  __atomic_store_n (&e->version, v + 2, __ATOMIC_RELEASE);
+}
+#endif
+
 /* Given the _Unwind_Context CONTEXT for a stack frame, look up the FDE for
    its caller and decode it into FS.  This function also sets the
    args_size and lsda members of CONTEXT, as they are really information
@@ -1252,6 +1357,11 @@ uw_frame_state_for (struct _Unwind_Context *context, _Unwind_FrameState *fs)
 #endif
     }
 
+#ifdef USE_FRAME_STATE_CACHE
+  if (frame_state_cache_lookup (context, fde, fs))
+    return _URC_NO_REASON;
+#endif
+
   fs->pc = context->bases.func;
 
   cie = get_cie (fde);
@@ -1288,6 +1398,10 @@ uw_frame_state_for (struct _Unwind_Context *context, _Unwind_FrameState *fs)
   end = (const unsigned char *) next_fde (fde);
   execute_cfa_program (insn, end, context, fs);
 
+#ifdef USE_FRAME_STATE_CACHE
+  frame_state_cache_insert (context, fde, fs);
+#endif
+
   return _URC_NO_REASON;
 }
 
@@ -0,0 +1,1295 @@
+/* Shared-memory implementation of GNU Fortran Coarray Library
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran Coarray Runtime Library (libcaf).
+
+Libcaf is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+Libcaf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+/* The images of a program linked against this library are processes on
+   the local node.  _gfortran_caf_init maps one shared anonymous segment
+   and then forks the images; the original process only supervises them.
+   As the segment is mapped before the fork, it has the same address in
+   every image, so pointers into it can be exchanged freely.
+
+   Coarrays are allocated collectively, i.e. every image registers them in
+   the same order.  Each image therefore runs an identical copy of the
+   allocator for the symmetric part of the segment and obtains the same
+   block, which holds the memory of all images back to back.  Memory that
+   only one image allocates (allocatable components of derived type
+   coarrays) comes from a private part of the segment owned by that image.
+
+   SYNC ALL, SYNC IMAGES, locks and events are implemented with atomic
+   operations on the segment and futexes for blocking.  The data movement
+   routines are shared with the single-image library.  */
+
+#include "libcaf.h"
+
+#if !defined (HAVE_FORK) || !defined (HAVE_SYS_WAIT_H)
+/* The images cannot be started without fork; run a single image.  */
+#include "single.c"
+#else
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <sched.h>
+#endif
+
+static void *caf_shmem_memptr (caf_token_t, int);
+
+#define CAF_MULTI_IMAGE 1
+#define CAF_MEMPTR(X, IMAGE_INDEX) caf_shmem_memptr ((X), (IMAGE_INDEX))
+#include "single.c"
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+/* Alignment of all allocations in the segment.  Keeping the memory of
+   different images on different cache lines avoids false sharing.  */
+#define CAF_SHMEM_ALIGN 64
+
+/* Bytes per image of the buffer used to exchange the data of the
+   collective subroutines.  */
+#define CAF_SHMEM_CHUNK 65536
+
+/* Number of times a waiting image polls before it blocks.  */
+#define CAF_SHMEM_SPIN 1000
+
+/* The barrier word holds the generation in the upper half and the number
+   of arrived images in the lower bits.  The top bit of the lower half is
+   set when the previous generation completed with stopped images.  */
+#define CAF_SHMEM_MAX_IMAGES 0x7fff
+#define BARRIER_COUNT(X) ((X) & 0x7fff)
+#define BARRIER_STOPPED 0x8000
+#define BARRIER_GEN(X) ((X) >> 16)
+
+#define ROUND_UP(X, A) (((X) + (A) - 1) & ~(size_t) ((A) - 1))
+
+/* The start of the shared segment.  */
+typedef struct caf_shmem_header
+{
+  /* Barrier for SYNC ALL, memory (de)allocation and the collectives.  */
+  uint32_t barrier;
+  /* Number of images that have stopped.  */
+  uint32_t stopped;
+  /* Set when an image has initiated error termination.  */
+  uint32_t error_stop;
+}
+caf_shmem_header;
+
+/* A coarray token.  The embedded single-image token must come first, as
+   the shared data movement routines access the token through it.  */
+struct caf_shmem_token
+{
+  struct caf_single_token base;
+  /* The distance between the memory of consecutive images, or zero if
+     the memory exists on the registering image only.  */
+  size_t stride;
+  /* The number of bytes allocated for the memory of a nonsymmetric
+     token.  */
+  size_t size;
+};
+typedef struct caf_shmem_token *caf_shmem_token_t;
+
+#define SHMEM_TOKEN(X) ((caf_shmem_token_t) (X))
+
+/* A range of free memory in an arena.  */
+typedef struct caf_shmem_hole
+{
+  size_t offset;
+  size_t size;
+  struct caf_shmem_hole *next;
+}
+caf_shmem_hole;
+
+/* A part of the segment managed by a local allocator.  The free list is
+   sorted by offset.  */
+typedef struct caf_shmem_arena
+{
+  char *base;
+  caf_shmem_hole *holes;
+}
+caf_shmem_arena;
+
+/* Global variables.  */
+static int caf_this_image;
+static int caf_num_images;
+static caf_shmem_header *caf_header;
+/* Per image: nonzero once the image has stopped.  */
+static uint32_t *caf_image_stopped;
+/* Element I * caf_num_images + J counts the SYNC IMAGES statements of
+   image I + 1 that involved image J + 1.  */
+static uint32_t *caf_sync_images;
+/* CAF_SHMEM_CHUNK bytes per image for the collective subroutines.  */
+static char *caf_collective_buf;
+static caf_shmem_arena caf_symmetric;
+static caf_shmem_arena caf_private;
+
+
+static void
+caf_shmem_futex_wait (uint32_t *addr, uint32_t val)
+{
+  int i;
+
+  for (i = 0; i < CAF_SHMEM_SPIN; i++)
+    if (__atomic_load_n (addr, __ATOMIC_ACQUIRE) != val)
+      return;
+
+#ifdef __linux__
+  syscall (SYS_futex, addr, FUTEX_WAIT, val, NULL, NULL, 0);
+#else
+  sched_yield ();
+#endif
+}
+
+
+static void
+caf_shmem_futex_wake (uint32_t *addr)
+{
+#ifdef __linux__
+  syscall (SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+  (void) addr;
+#endif
+}
+
+
+/* Set *STAT to CODE and ERRMSG to MSG if present, otherwise terminate
+   with MSG as error message.  */
+
+static void
+caf_shmem_error (int code, const char *msg, int *stat, char *errmsg,
+		 int errmsg_len)
+{
+  if (stat)
+    {
+      *stat = code;
+      if (errmsg_len > 0)
+	{
+	  int len = ((int) strlen (msg) > errmsg_len) ? errmsg_len
+						      : (int) strlen (msg);
+	  memcpy (errmsg, msg, len);
+	  if (errmsg_len > len)
+	    memset (&errmsg[len], ' ', errmsg_len-len);
+	}
+      return;
+    }
+  caf_runtime_error ("%s on image %d", msg, caf_this_image);
+}
+
+
+static void *
+caf_shmem_alloc (caf_shmem_arena *arena, size_t size)
+{
+  caf_shmem_hole **p, *h;
+
+  size = ROUND_UP (size ? size : 1, CAF_SHMEM_ALIGN);
+  for (p = &arena->holes; (h = *p) != NULL; p = &h->next)
+    if (h->size >= size)
+      {
+	void *ret = arena->base + h->offset;
+	h->offset += size;
+	h->size -= size;
+	if (h->size == 0)
+	  {
+	    *p = h->next;
+	    free (h);
+	  }
+	return ret;
+      }
+  return NULL;
+}
+
+
+static void
+caf_shmem_free (caf_shmem_arena *arena, void *ptr, size_t size)
+{
+  caf_shmem_hole **p, *h, *prev = NULL;
+  size_t offset = (char *) ptr - arena->base;
+
+  size = ROUND_UP (size ? size : 1, CAF_SHMEM_ALIGN);
+  for (p = &arena->holes; *p && (*p)->offset < offset; p = &(*p)->next)
+    prev = *p;
+
+  h = *p;
+  if (prev && prev->offset + prev->size == offset)
+    {
+      prev->size += size;
+      if (h && prev->offset + prev->size == h->offset)
+	{
+	  prev->size += h->size;
+	  prev->next = h->next;
+	  free (h);
+	}
+    }
+  else if (h && offset + size == h->offset)
+    {
+      h->offset = offset;
+      h->size += size;
+    }
+  else
+    {
+      h = malloc (sizeof (caf_shmem_hole));
+      /* Without memory for the bookkeeping the range is lost.  */
+      if (h == NULL)
+	return;
+      h->offset = offset;
+      h->size = size;
+      h->next = *p;
+      *p = h;
+    }
+}
+
+
+static void
+caf_shmem_arena_init (caf_shmem_arena *arena, char *base, size_t size)
+{
+  arena->base = base;
+  arena->holes = malloc (sizeof (caf_shmem_hole));
+  if (arena->holes == NULL)
+    caf_runtime_error ("Cannot allocate memory for the coarray allocator");
+  arena->holes->offset = 0;
+  arena->holes->size = size;
+  arena->holes->next = NULL;
+}
+
+
+static void *
+caf_shmem_memptr (caf_token_t token, int image_index)
+{
+  caf_shmem_token_t shmem_token = SHMEM_TOKEN (token);
+  char *memptr = shmem_token->base.memptr;
+
+  /* An image index of zero denotes the executing image.  */
+  if (image_index > 0 && shmem_token->stride)
+    memptr += ((ptrdiff_t) image_index - caf_this_image)
+	      * (ptrdiff_t) shmem_token->stride;
+  return memptr;
+}
+
+
+/* Try to complete barrier generation GEN, which is possible once every
+   image that has not stopped has arrived.  */
+
+static void
+caf_shmem_barrier_complete (uint32_t gen)
+{
+  uint32_t s = __atomic_load_n (&caf_header->barrier, __ATOMIC_SEQ_CST);
+
+  while (BARRIER_GEN (s) == gen)
+    {
+      uint32_t stopped = __atomic_load_n (&caf_header->stopped,
+					  __ATOMIC_SEQ_CST);
+      if (BARRIER_COUNT (s) + stopped < (uint32_t) caf_num_images)
+	return;
+      if (__atomic_compare_exchange_n (&caf_header->barrier, &s,
+				       (((gen + 1) & 0xffff) << 16)
+				       | (stopped ? BARRIER_STOPPED : 0),
+				       false, __ATOMIC_SEQ_CST,
+				       __ATOMIC_SEQ_CST))
+	{
+	  caf_shmem_futex_wake (&caf_header->barrier);
+	  return;
+	}
+    }
+}
+
+
+/* Wait until all images that have not stopped arrive.  Returns
+   GFC_STAT_STOPPED_IMAGE if there are stopped images, zero otherwise.  */
+
+static int
+caf_shmem_barrier (void)
+{
+  uint32_t s = __atomic_add_fetch (&caf_header->barrier, 1, __ATOMIC_SEQ_CST);
+  uint32_t gen = BARRIER_GEN (s);
+
+  caf_shmem_barrier_complete (gen);
+  while (BARRIER_GEN (s = __atomic_load_n (&caf_header->barrier,
+					   __ATOMIC_SEQ_CST)) == gen)
+    caf_shmem_futex_wait (&caf_header->barrier, s);
+
+  return (s & BARRIER_STOPPED) ? GFC_STAT_STOPPED_IMAGE : 0;
+}
+
+
+/* Record that the executing image has stopped and release the images
+   waiting for it.  */
+
+static void
+caf_shmem_stop_image (void)
+{
+  int j;
+
+  if (caf_header == NULL
+      || __atomic_exchange_n (&caf_image_stopped[caf_this_image - 1], 1,
+			      __ATOMIC_SEQ_CST))
+    return;
+
+  __atomic_add_fetch (&caf_header->stopped, 1, __ATOMIC_SEQ_CST);
+  caf_shmem_barrier_complete (BARRIER_GEN (__atomic_load_n
+					   (&caf_header->barrier,
+					    __ATOMIC_SEQ_CST)));
+
+  /* Images in SYNC IMAGES with this one wait for one of these counters to
+     change and then notice that this image has stopped.  */
+  for (j = 0; j < caf_num_images; j++)
+    {
+      uint32_t *cnt = &caf_sync_images[(caf_this_image - 1) * caf_num_images
+				       + j];
+      __atomic_add_fetch (cnt, 1, __ATOMIC_SEQ_CST);
+      caf_shmem_futex_wake (cnt);
+    }
+}
+
+
+static void caf_shmem_error_stop (int error) __attribute__ ((noreturn));
+
+/* Initiate error termination of all images.  */
+
+static void
+caf_shmem_error_stop (int error)
+{
+  if (caf_header)
+    __atomic_store_n (&caf_header->error_stop, 1, __ATOMIC_SEQ_CST);
+  exit (error);
+}
+
+
+static size_t
+caf_shmem_getenv_size (const char *name, size_t dflt)
+{
+  const char *p = getenv (name);
+  char *end;
+  unsigned long long val;
+
+  if (p == NULL || *p == '\0')
+    return dflt;
+
+  errno = 0;
+  val = strtoull (p, &end, 10);
+  switch (*end)
+    {
+    case 'k': case 'K':
+      val <<= 10, end++;
+      break;
+    case 'm': case 'M':
+      val <<= 20, end++;
+      break;
+    case 'g': case 'G':
+      val <<= 30, end++;
+      break;
+    }
+  if (errno || *end != '\0' || val == 0 || val > SIZE_MAX)
+    caf_runtime_error ("Bad value for environment variable %s: %s", name, p);
+  return val;
+}
+
+
+/* Initialize coarray program.  Forks the images; only the images return
+   from this function.  */
+
+void
+_gfortran_caf_init (int *argc __attribute__ ((unused)),
+		    char ***argv __attribute__ ((unused)))
+{
+  size_t header_size, sym_size, priv_size, segment_size, num_images;
+  long ncpus;
+  pid_t *pids;
+  char *segment;
+  int i, status, remaining;
+
+  if (caf_num_images != 0)
+    return;
+
+  ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+  num_images = caf_shmem_getenv_size ("GFORTRAN_NUM_IMAGES",
+				      ncpus > 0 ? ncpus : 1);
+  if (num_images > CAF_SHMEM_MAX_IMAGES)
+    caf_runtime_error ("Too many images requested with GFORTRAN_NUM_IMAGES");
+  caf_num_images = num_images;
+
+  /* The segment is reserved but not committed, so the default can be
+     generous.  */
+  segment_size
+    = caf_shmem_getenv_size ("GFORTRAN_SHARED_MEMORY_SIZE",
+			     (sizeof (void *) > 4 ? (size_t) 1 << 30
+						  : (size_t) 1 << 26)
+			     * caf_num_images);
+
+  header_size = ROUND_UP (sizeof (caf_shmem_header), CAF_SHMEM_ALIGN)
+		+ ROUND_UP (caf_num_images * sizeof (uint32_t), CAF_SHMEM_ALIGN)
+		+ ROUND_UP ((size_t) caf_num_images * caf_num_images
+			    * sizeof (uint32_t), CAF_SHMEM_ALIGN)
+		+ (size_t) caf_num_images * CAF_SHMEM_CHUNK;
+  if (segment_size <= header_size)
+    caf_runtime_error ("GFORTRAN_SHARED_MEMORY_SIZE is too small for %d "
+		       "images", caf_num_images);
+
+  /* Half of the remaining space is for the symmetric allocations, the
+     other half is split between the images.  */
+  priv_size = (segment_size - header_size) / 2 / caf_num_images;
+  priv_size &= ~(size_t) (CAF_SHMEM_ALIGN - 1);
+  sym_size = segment_size - header_size - priv_size * caf_num_images;
+  sym_size &= ~(size_t) (CAF_SHMEM_ALIGN - 1);
+
+  segment = mmap (NULL, segment_size, PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (segment == MAP_FAILED)
+    caf_runtime_error ("Cannot map %lu bytes of shared memory",
+		       (unsigned long) segment_size);
+
+  caf_header = (caf_shmem_header *) segment;
+  segment += ROUND_UP (sizeof (caf_shmem_header), CAF_SHMEM_ALIGN);
+  caf_image_stopped = (uint32_t *) segment;
+  segment += ROUND_UP (caf_num_images * sizeof (uint32_t), CAF_SHMEM_ALIGN);
+  caf_sync_images = (uint32_t *) segment;
+  segment += ROUND_UP ((size_t) caf_num_images * caf_num_images
+		       * sizeof (uint32_t), CAF_SHMEM_ALIGN);
+  caf_collective_buf = segment;
+  segment += (size_t) caf_num_images * CAF_SHMEM_CHUNK;
+  caf_shmem_arena_init (&caf_symmetric, segment, sym_size);
+  segment += sym_size;
+
+  if (caf_num_images == 1)
+    {
+      caf_this_image = 1;
+      caf_shmem_arena_init (&caf_private, segment, priv_size);
+      return;
+    }
+
+  pids = malloc (caf_num_images * sizeof (pid_t));
+  if (pids == NULL)
+    caf_runtime_error ("Cannot allocate memory for %d images",
+		       caf_num_images);
+
+  fflush (stdout);
+  fflush (stderr);
+  for (i = 0; i < caf_num_images; i++)
+    {
+      pids[i] = fork ();
+      if (pids[i] == 0)
+	{
+	  free (pids);
+	  caf_this_image = i + 1;
+	  caf_shmem_arena_init (&caf_private, segment + i * priv_size,
+				priv_size);
+	  return;
+	}
+      if (pids[i] < 0)
+	{
+	  fprintf (stderr, "Fortran runtime error: Cannot start image %d: "
+		   "%s\n", i + 1, strerror (errno));
+	  while (i-- > 0)
+	    kill (pids[i], SIGKILL);
+	  exit (EXIT_FAILURE);
+	}
+    }
+
+  /* Supervise the images.  The first image that terminates abnormally or
+     with a nonzero exit status terminates all others and determines the
+     exit status of the program.  */
+  status = 0;
+  remaining = caf_num_images;
+  while (remaining > 0)
+    {
+      int wstatus, code;
+      pid_t pid = wait (&wstatus);
+
+      if (pid < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  break;
+	}
+      remaining--;
+      code = WIFEXITED (wstatus) ? WEXITSTATUS (wstatus)
+	     : 128 + WTERMSIG (wstatus);
+      if (status == 0
+	  && (code != 0
+	      || __atomic_load_n (&caf_header->error_stop, __ATOMIC_SEQ_CST)))
+	{
+	  status = code ? code : EXIT_FAILURE;
+	  for (i = 0; i < caf_num_images; i++)
+	    if (pids[i] != pid)
+	      kill (pids[i], SIGTERM);
+	}
+    }
+  exit (status);
+}
+
+
+void
+_gfortran_caf_finalize (void)
+{
+  caf_shmem_stop_image ();
+
+  while (caf_static_list != NULL)
+    {
+      caf_static_t *tmp = caf_static_list->prev;
+      free (caf_static_list->token);
+      free (caf_static_list);
+      caf_static_list = tmp;
+    }
+}
+
+
+int
+_gfortran_caf_this_image (int distance __attribute__ ((unused)))
+{
+  return caf_this_image;
+}
+
+
+int
+_gfortran_caf_num_images (int distance __attribute__ ((unused)),
+			  int failed __attribute__ ((unused)))
+{
+  return caf_num_images;
+}
+
+
+void
+_gfortran_caf_register (size_t size, caf_register_t type, caf_token_t *token,
+			gfc_descriptor_t *data, int *stat, char *errmsg,
+			int errmsg_len)
+{
+  const char alloc_fail_msg[] = "Failed to allocate coarray";
+  caf_shmem_token_t shmem_token;
+  void *local = NULL;
+  bool lock_or_event = (type == CAF_REGTYPE_LOCK_STATIC
+			|| type == CAF_REGTYPE_LOCK_ALLOC
+			|| type == CAF_REGTYPE_CRITICAL
+			|| type == CAF_REGTYPE_EVENT_STATIC
+			|| type == CAF_REGTYPE_EVENT_ALLOC);
+
+  /* For locks and events SIZE is the number of variables.  */
+  if (lock_or_event)
+    size *= sizeof (uint32_t);
+
+  if (type == CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY
+      || type == CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY)
+    {
+      /* The token and memory of allocatable components must be visible
+	 to the other images, but are only allocated on this image.  */
+      if (type == CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY)
+	*token = caf_shmem_alloc (&caf_private,
+				  sizeof (struct caf_shmem_token));
+      else
+	{
+	  local = caf_shmem_alloc (&caf_private, size);
+	  if (local == NULL)
+	    {
+	      caf_shmem_error (1, alloc_fail_msg, stat, errmsg, errmsg_len);
+	      return;
+	    }
+	}
+      if (*token == NULL)
+	{
+	  caf_shmem_error (1, alloc_fail_msg, stat, errmsg, errmsg_len);
+	  return;
+	}
+      shmem_token = SHMEM_TOKEN (*token);
+      shmem_token->base.memptr = local;
+      shmem_token->base.owning_memory = local != NULL;
+      shmem_token->stride = 0;
+      shmem_token->size = size;
+    }
+  else
+    {
+      size_t stride = ROUND_UP (size ? size : 1, CAF_SHMEM_ALIGN);
+      char *mem = NULL;
+
+      /* All images allocate the same block in the same order, so this
+	 needs no communication.  */
+      if (stride <= SIZE_MAX / caf_num_images)
+	mem = caf_shmem_alloc (&caf_symmetric, stride * caf_num_images);
+      *token = mem ? malloc (sizeof (struct caf_shmem_token)) : NULL;
+      if (*token == NULL)
+	{
+	  if (mem)
+	    caf_shmem_free (&caf_symmetric, mem, stride * caf_num_images);
+	  caf_shmem_error (1, alloc_fail_msg, stat, errmsg, errmsg_len);
+	  return;
+	}
+      local = mem + (caf_this_image - 1) * stride;
+      shmem_token = SHMEM_TOKEN (*token);
+      shmem_token->base.memptr = local;
+      shmem_token->base.owning_memory = true;
+      shmem_token->stride = stride;
+      shmem_token->size = size;
+
+      /* Memory from a previous allocation must not look locked or
+	 posted.  */
+      if (lock_or_event)
+	memset (local, 0, size);
+    }
+  shmem_token->base.desc = GFC_DESCRIPTOR_RANK (data) > 0 ? data : NULL;
+
+  if (stat)
+    *stat = 0;
+
+  if (type == CAF_REGTYPE_COARRAY_STATIC || type == CAF_REGTYPE_LOCK_STATIC
+      || type == CAF_REGTYPE_CRITICAL || type == CAF_REGTYPE_EVENT_STATIC)
+    {
+      caf_static_t *tmp = malloc (sizeof (caf_static_t));
+      tmp->prev  = caf_static_list;
+      tmp->token = *token;
+      caf_static_list = tmp;
+    }
+  GFC_DESCRIPTOR_DATA (data) = local;
+
+  /* ALLOCATE of a coarray synchronizes all images.  */
+  if (type == CAF_REGTYPE_COARRAY_ALLOC || type == CAF_REGTYPE_LOCK_ALLOC
+      || type == CAF_REGTYPE_EVENT_ALLOC)
+    {
+      int ierr = caf_shmem_barrier ();
+      if (ierr)
+	caf_shmem_error (ierr, "ALLOCATE failed - there are stopped images",
+			 stat, errmsg, errmsg_len);
+    }
+}
+
+
+void
+_gfortran_caf_deregister (caf_token_t *token, caf_deregister_t type, int *stat,
+			  char *errmsg, int errmsg_len)
+{
+  caf_shmem_token_t shmem_token = SHMEM_TOKEN (*token);
+  int ierr = 0;
+
+  if (stat)
+    *stat = 0;
+
+  if (shmem_token->stride)
+    {
+      /* DEALLOCATE of a coarray synchronizes all images; afterwards no
+	 image accesses the memory any more.  */
+      ierr = caf_shmem_barrier ();
+      caf_shmem_free (&caf_symmetric,
+		      (char *) shmem_token->base.memptr
+		      - (caf_this_image - 1) * shmem_token->stride,
+		      shmem_token->stride * caf_num_images);
+      free (shmem_token);
+      *token = NULL;
+    }
+  else
+    {
+      if (shmem_token->base.owning_memory && shmem_token->base.memptr)
+	caf_shmem_free (&caf_private, shmem_token->base.memptr,
+			shmem_token->size);
+      shmem_token->base.memptr = NULL;
+      shmem_token->base.owning_memory = false;
+      if (type != CAF_DEREGTYPE_COARRAY_DEALLOCATE_ONLY)
+	{
+	  caf_shmem_free (&caf_private, shmem_token,
+			  sizeof (struct caf_shmem_token));
+	  *token = NULL;
+	}
+    }
+
+  if (ierr)
+    caf_shmem_error (ierr, "DEALLOCATE failed - there are stopped images",
+		     stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_sync_all (int *stat, char *errmsg, int errmsg_len)
+{
+  int ierr = caf_shmem_barrier ();
+
+  if (stat)
+    *stat = 0;
+  if (ierr)
+    caf_shmem_error (ierr, "SYNC ALL failed - there are stopped images",
+		     stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_sync_memory (int *stat,
+			   char *errmsg __attribute__ ((unused)),
+			   int errmsg_len __attribute__ ((unused)))
+{
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+  if (stat)
+    *stat = 0;
+}
+
+
+/* SYNC IMAGES.  Note: SYNC IMAGES(*) is passed as count == -1 while
+   SYNC IMAGES([]) has count == 0.  Each image counts how often it has
+   synchronized with each other image; image I waits until image J has
+   counted as many synchronizations with I as I has with J.  */
+
+void
+_gfortran_caf_sync_images (int count, int images[], int *stat, char *errmsg,
+			   int errmsg_len)
+{
+  int i, n = count < 0 ? caf_num_images : count;
+  int ierr = 0;
+
+  if (stat)
+    *stat = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      int j = count < 0 ? i + 1 : images[i];
+      uint32_t *out;
+
+      if (j < 1 || j > caf_num_images)
+	{
+	  caf_shmem_error (1, "SYNC IMAGES failed - invalid image index",
+			   stat, errmsg, errmsg_len);
+	  return;
+	}
+      if (j == caf_this_image)
+	continue;
+      out = &caf_sync_images[(caf_this_image - 1) * caf_num_images + j - 1];
+      __atomic_add_fetch (out, 1, __ATOMIC_SEQ_CST);
+      caf_shmem_futex_wake (out);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      int j = count < 0 ? i + 1 : images[i];
+      uint32_t *in, target, val;
+
+      if (j == caf_this_image)
+	continue;
+      target = __atomic_load_n (&caf_sync_images[(caf_this_image - 1)
+						 * caf_num_images + j - 1],
+				__ATOMIC_RELAXED);
+      in = &caf_sync_images[(j - 1) * caf_num_images + caf_this_image - 1];
+      while ((int32_t) ((val = __atomic_load_n (in, __ATOMIC_SEQ_CST))
+			- target) < 0
+	     && !__atomic_load_n (&caf_image_stopped[j - 1],
+				  __ATOMIC_SEQ_CST))
+	caf_shmem_futex_wait (in, val);
+      if (__atomic_load_n (&caf_image_stopped[j - 1], __ATOMIC_SEQ_CST))
+	ierr = GFC_STAT_STOPPED_IMAGE;
+    }
+
+  if (ierr)
+    caf_shmem_error (ierr, "SYNC IMAGES failed - there are stopped images",
+		     stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_stop_numeric (int32_t stop_code)
+{
+  fprintf (stderr, "STOP %d\n", stop_code);
+  caf_shmem_stop_image ();
+  exit (0);
+}
+
+
+void
+_gfortran_caf_stop_str (const char *string, int32_t len)
+{
+  fputs ("STOP ", stderr);
+  while (len--)
+    fputc (*(string++), stderr);
+  fputs ("\n", stderr);
+
+  caf_shmem_stop_image ();
+  exit (0);
+}
+
+
+void
+_gfortran_caf_error_stop_str (const char *string, int32_t len)
+{
+  fputs ("ERROR STOP ", stderr);
+  while (len--)
+    fputc (*(string++), stderr);
+  fputs ("\n", stderr);
+
+  caf_shmem_error_stop (1);
+}
+
+
+void
+_gfortran_caf_error_stop (int32_t error)
+{
+  fprintf (stderr, "ERROR STOP %d\n", error);
+  caf_shmem_error_stop (error);
+}
+
+
+/* The address of element I, in array element order, of A.  */
+
+static char *
+caf_shmem_element (gfc_descriptor_t *a, size_t i)
+{
+  int j, rank = GFC_DESCRIPTOR_RANK (a);
+  ptrdiff_t offset = 0;
+
+  for (j = 0; j < rank; j++)
+    {
+      ptrdiff_t extent = GFC_DESCRIPTOR_EXTENT (a, j);
+      offset += (i % extent) * GFC_DESCRIPTOR_STRIDE (a, j);
+      i /= extent;
+    }
+  return (char *) GFC_DESCRIPTOR_DATA (a) + offset * GFC_DESCRIPTOR_SIZE (a);
+}
+
+
+static size_t
+caf_shmem_num_elems (gfc_descriptor_t *a)
+{
+  int j, rank = GFC_DESCRIPTOR_RANK (a);
+  size_t n = 1;
+
+  for (j = 0; j < rank; j++)
+    {
+      ptrdiff_t extent = GFC_DESCRIPTOR_EXTENT (a, j);
+      if (extent <= 0)
+	return 0;
+      n *= extent;
+    }
+  return n;
+}
+
+
+static void
+caf_shmem_pack (char *buf, gfc_descriptor_t *a, size_t first, size_t n)
+{
+  size_t i, size = GFC_DESCRIPTOR_SIZE (a);
+
+  for (i = 0; i < n; i++)
+    memcpy (buf + i * size, caf_shmem_element (a, first + i), size);
+}
+
+
+static void
+caf_shmem_unpack (gfc_descriptor_t *a, const char *buf, size_t first,
+		  size_t n)
+{
+  size_t i, size = GFC_DESCRIPTOR_SIZE (a);
+
+  for (i = 0; i < n; i++)
+    memcpy (caf_shmem_element (a, first + i), buf + i * size, size);
+}
+
+
+void
+_gfortran_caf_co_broadcast (gfc_descriptor_t *a, int source_image, int *stat,
+			    char *errmsg, int errmsg_len)
+{
+  size_t size = GFC_DESCRIPTOR_SIZE (a);
+  size_t i, n, chunk, nelems = caf_shmem_num_elems (a);
+  int ierr = 0;
+
+  if (stat)
+    *stat = 0;
+
+  if (size == 0 || size > CAF_SHMEM_CHUNK)
+    {
+      caf_shmem_error (1, "CO_BROADCAST failed - unsupported element size",
+		       stat, errmsg, errmsg_len);
+      return;
+    }
+
+  chunk = CAF_SHMEM_CHUNK / size;
+  for (i = 0; i < nelems && !ierr; i += n)
+    {
+      n = nelems - i < chunk ? nelems - i : chunk;
+      if (caf_this_image == source_image)
+	caf_shmem_pack (caf_collective_buf, a, i, n);
+      ierr = caf_shmem_barrier ();
+      if (caf_this_image != source_image)
+	caf_shmem_unpack (a, caf_collective_buf, i, n);
+      ierr |= caf_shmem_barrier ();
+    }
+
+  if (ierr)
+    caf_shmem_error (GFC_STAT_STOPPED_IMAGE,
+		     "CO_BROADCAST failed - there are stopped images",
+		     stat, errmsg, errmsg_len);
+}
+
+
+enum caf_shmem_op { CAF_SHMEM_SUM, CAF_SHMEM_MIN, CAF_SHMEM_MAX };
+
+#define REDUCE_ORDERED(TYPE) \
+  do {									\
+    TYPE *x = (TYPE *) acc;						\
+    const TYPE *y = (const TYPE *) val;					\
+    switch (op)								\
+      {									\
+      case CAF_SHMEM_SUM:						\
+	for (i = 0; i < n; i++)						\
+	  x[i] += y[i];							\
+	break;								\
+      case CAF_SHMEM_MIN:						\
+	for (i = 0; i < n; i++)						\
+	  if (y[i] < x[i])						\
+	    x[i] = y[i];						\
+	break;								\
+      case CAF_SHMEM_MAX:						\
+	for (i = 0; i < n; i++)						\
+	  if (y[i] > x[i])						\
+	    x[i] = y[i];						\
+	break;								\
+      }									\
+    return true;							\
+  } while (0)
+
+#define REDUCE_SUM(TYPE) \
+  do {									\
+    TYPE *x = (TYPE *) acc;						\
+    const TYPE *y = (const TYPE *) val;					\
+    if (op != CAF_SHMEM_SUM)						\
+      return false;							\
+    for (i = 0; i < n; i++)						\
+      x[i] += y[i];							\
+    return true;							\
+  } while (0)
+
+/* Combine the N elements at ACC with those at VAL using OP.  Returns false
+   if the type is not supported.  */
+
+static bool
+caf_shmem_combine (enum caf_shmem_op op, int type, size_t size, int kind,
+		   char *acc, const char *val, size_t n)
+{
+  size_t i;
+
+  switch (type)
+    {
+    case BT_INTEGER:
+      switch (size)
+	{
+	case 1:
+	  REDUCE_ORDERED (GFC_INTEGER_1);
+	case 2:
+	  REDUCE_ORDERED (GFC_INTEGER_2);
+	case 4:
+	  REDUCE_ORDERED (GFC_INTEGER_4);
+	case 8:
+	  REDUCE_ORDERED (GFC_INTEGER_8);
+#ifdef HAVE_GFC_INTEGER_16
+	case 16:
+	  REDUCE_ORDERED (GFC_INTEGER_16);
+#endif
+	}
+      break;
+    /* The kind of REAL(10) and REAL(16) cannot be told apart by the size
+       alone, so only the kinds of float and double are supported.  */
+    case BT_REAL:
+      switch (size)
+	{
+	case 4:
+	  REDUCE_ORDERED (GFC_REAL_4);
+	case 8:
+	  REDUCE_ORDERED (GFC_REAL_8);
+	}
+      break;
+    case BT_COMPLEX:
+      switch (size)
+	{
+	case 8:
+	  REDUCE_SUM (GFC_COMPLEX_4);
+	case 16:
+	  REDUCE_SUM (GFC_COMPLEX_8);
+	}
+      break;
+    case BT_CHARACTER:
+      if (op == CAF_SHMEM_SUM)
+	break;
+      for (i = 0; i < n; i++, acc += size, val += size)
+	{
+	  int cmp = 0;
+	  if (kind == 1)
+	    cmp = memcmp (val, acc, size);
+	  else
+	    {
+	      const gfc_char4_t *x = (const gfc_char4_t *) acc;
+	      const gfc_char4_t *y = (const gfc_char4_t *) val;
+	      size_t k;
+	      for (k = 0; k < size / sizeof (gfc_char4_t) && !cmp; k++)
+		cmp = y[k] < x[k] ? -1 : y[k] > x[k];
+	    }
+	  if (op == CAF_SHMEM_MIN ? cmp < 0 : cmp > 0)
+	    memcpy (acc, val, size);
+	}
+      return true;
+    default:
+      break;
+    }
+  return false;
+}
+
+#undef REDUCE_ORDERED
+#undef REDUCE_SUM
+
+
+/* Reduce A over all images with OP.  The result is stored on
+   RESULT_IMAGE, or on all images if it is zero.  The operands are combined
+   in image order, so that every image computes the same result.  */
+
+static void
+caf_shmem_reduce (const char *name, enum caf_shmem_op op, gfc_descriptor_t *a,
+		  int result_image, int a_len, int *stat, char *errmsg,
+		  int errmsg_len)
+{
+  size_t size = GFC_DESCRIPTOR_SIZE (a);
+  size_t i, n, chunk, nelems = caf_shmem_num_elems (a);
+  char *mine = caf_collective_buf + (caf_this_image - 1) * CAF_SHMEM_CHUNK;
+  char msg[80];
+  char *acc;
+  int kind, k, ierr = 0;
+  bool ok = true;
+
+  if (stat)
+    *stat = 0;
+
+  kind = GFC_DESCRIPTOR_TYPE (a) == BT_CHARACTER && a_len > 0
+	 ? (int) size / a_len : 1;
+  acc = size && size <= CAF_SHMEM_CHUNK ? malloc (CAF_SHMEM_CHUNK) : NULL;
+  if (acc == NULL)
+    {
+      snprintf (msg, sizeof (msg), "%s failed - unsupported element size",
+		name);
+      caf_shmem_error (1, msg, stat, errmsg, errmsg_len);
+      return;
+    }
+
+  chunk = CAF_SHMEM_CHUNK / size;
+  for (i = 0; i < nelems && !ierr; i += n)
+    {
+      n = nelems - i < chunk ? nelems - i : chunk;
+      caf_shmem_pack (mine, a, i, n);
+      ierr = caf_shmem_barrier ();
+      if (result_image == 0 || result_image == caf_this_image)
+	{
+	  memcpy (acc, caf_collective_buf, n * size);
+	  for (k = 1; k < caf_num_images && ok; k++)
+	    ok = caf_shmem_combine (op, GFC_DESCRIPTOR_TYPE (a), size, kind,
+				    acc, caf_collective_buf
+					 + k * CAF_SHMEM_CHUNK, n);
+	  if (ok)
+	    caf_shmem_unpack (a, acc, i, n);
+	}
+      /* The buffers are reused for the next chunk.  */
+      ierr |= caf_shmem_barrier ();
+    }
+  free (acc);
+
+  if (!ok)
+    {
+      snprintf (msg, sizeof (msg), "%s failed - unsupported type", name);
+      caf_shmem_error (1, msg, stat, errmsg, errmsg_len);
+    }
+  else if (ierr)
+    {
+      snprintf (msg, sizeof (msg), "%s failed - there are stopped images",
+		name);
+      caf_shmem_error (GFC_STAT_STOPPED_IMAGE, msg, stat, errmsg, errmsg_len);
+    }
+}
+
+
+void
+_gfortran_caf_co_sum (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int errmsg_len)
+{
+  caf_shmem_reduce ("CO_SUM", CAF_SHMEM_SUM, a, result_image, 0, stat,
+		    errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_min (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int a_len, int errmsg_len)
+{
+  caf_shmem_reduce ("CO_MIN", CAF_SHMEM_MIN, a, result_image, a_len, stat,
+		    errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_max (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int a_len, int errmsg_len)
+{
+  caf_shmem_reduce ("CO_MAX", CAF_SHMEM_MAX, a, result_image, a_len, stat,
+		    errmsg, errmsg_len);
+}
+
+
+/* FIXME: The calling convention of OPR depends on the type of A, which is
+   not known here.  Only a single image is supported.  */
+
+void
+_gfortran_caf_co_reduce (gfc_descriptor_t *a __attribute__ ((unused)),
+			 void * (*opr) (void *, void *)
+				__attribute__ ((unused)),
+			 int opr_flags __attribute__ ((unused)),
+			 int result_image __attribute__ ((unused)),
+			 int *stat, char *errmsg,
+			 int a_len __attribute__ ((unused)),
+			 int errmsg_len)
+{
+  if (stat)
+    *stat = 0;
+  if (caf_num_images > 1)
+    caf_shmem_error (1, "CO_REDUCE is not supported with more than one "
+		     "image", stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_event_post (caf_token_t token, size_t index, int image_index,
+			  int *stat, char *errmsg __attribute__ ((unused)),
+			  int errmsg_len __attribute__ ((unused)))
+{
+  uint32_t *event = (uint32_t *) caf_shmem_memptr (token, image_index)
+		    + index;
+
+  __atomic_fetch_add (event, 1, __ATOMIC_SEQ_CST);
+  caf_shmem_futex_wake (event);
+
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_event_wait (caf_token_t token, size_t index, int until_count,
+			  int *stat, char *errmsg __attribute__ ((unused)),
+			  int errmsg_len __attribute__ ((unused)))
+{
+  uint32_t *event = (uint32_t *) MEMTOK (token) + index;
+  uint32_t count = until_count > 0 ? until_count : 1;
+  uint32_t val = __atomic_load_n (event, __ATOMIC_SEQ_CST);
+
+  for (;;)
+    {
+      if ((int32_t) val >= (int32_t) count)
+	{
+	  if (__atomic_compare_exchange_n (event, &val, val - count, false,
+					   __ATOMIC_SEQ_CST,
+					   __ATOMIC_SEQ_CST))
+	    break;
+	  continue;
+	}
+      caf_shmem_futex_wait (event, val);
+      val = __atomic_load_n (event, __ATOMIC_SEQ_CST);
+    }
+
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_event_query (caf_token_t token, size_t index, int image_index,
+			   int *count, int *stat)
+{
+  uint32_t *event = (uint32_t *) caf_shmem_memptr (token, image_index)
+		    + index;
+
+  *count = (int) __atomic_load_n (event, __ATOMIC_SEQ_CST);
+
+  if (stat)
+    *stat = 0;
+}
+
+
+/* A lock variable holds zero if it is unlocked and the number of the
+   image holding it otherwise.  */
+
+void
+_gfortran_caf_lock (caf_token_t token, size_t index, int image_index,
+		    int *aquired_lock, int *stat, char *errmsg, int errmsg_len)
+{
+  uint32_t *lock = (uint32_t *) caf_shmem_memptr (token, image_index)
+		   + index;
+  uint32_t val = 0;
+
+  if (stat)
+    *stat = 0;
+
+  while (!__atomic_compare_exchange_n (lock, &val, caf_this_image, false,
+				       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      if (val == (uint32_t) caf_this_image)
+	{
+	  caf_shmem_error (GFC_STAT_LOCKED, "Already locked", stat, errmsg,
+			   errmsg_len);
+	  return;
+	}
+      if (aquired_lock)
+	{
+	  *aquired_lock = (int) false;
+	  return;
+	}
+      caf_shmem_futex_wait (lock, val);
+      val = 0;
+    }
+
+  if (aquired_lock)
+    *aquired_lock = (int) true;
+}
+
+
+void
+_gfortran_caf_unlock (caf_token_t token, size_t index, int image_index,
+		      int *stat, char *errmsg, int errmsg_len)
+{
+  uint32_t *lock = (uint32_t *) caf_shmem_memptr (token, image_index)
+		   + index;
+  uint32_t val = caf_this_image;
+
+  if (stat)
+    *stat = 0;
+
+  if (__atomic_compare_exchange_n (lock, &val, 0, false, __ATOMIC_RELEASE,
+				   __ATOMIC_RELAXED))
+    {
+      caf_shmem_futex_wake (lock);
+      return;
+    }
+
+  if (val == 0)
+    caf_shmem_error (GFC_STAT_UNLOCKED, "Variable is not locked", stat,
+		     errmsg, errmsg_len);
+  else
+    caf_shmem_error (GFC_STAT_LOCKED_OTHER_IMAGE,
+		     "Variable is locked by another image", stat, errmsg,
+		     errmsg_len);
+}
+
+#endif /* HAVE_FORK && HAVE_SYS_WAIT_H  */
@@ -49,6 +49,15 @@ typedef struct caf_single_token *caf_single_token_t;
 #define TOKEN(X) ((caf_single_token_t) (X))
 #define MEMTOK(X) ((caf_single_token_t) (X))->memptr
 
+/* The memory registered with token X as seen on image IMAGE_INDEX.  A
+   multi-image library that includes this file to share its data movement
+   routines defines this to address the memory of the other images, and
+   defines CAF_MULTI_IMAGE to provide its own image control, registration
+   and collective routines.  */
+#ifndef CAF_MEMPTR
+#define CAF_MEMPTR(X, IMAGE_INDEX) MEMTOK (X)
+#endif
+
 /* Single-image implementation of the CAF library.
    Note: For performance reasons -fcoarry=single should be used
    rather than this library.  */
@@ -96,6 +105,7 @@ caf_internal_error (const char *msg, int *stat, char *errmsg,
 }
 
 
+#ifndef CAF_MULTI_IMAGE
 void
 _gfortran_caf_init (int *argc __attribute__ ((unused)),
 		    char ***argv __attribute__ ((unused)))
@@ -355,6 +365,7 @@ _gfortran_caf_co_reduce (gfc_descriptor_t *a __attribute__ ((unused)),
    if (stat)
      *stat = 0;
  }
+#endif /* CAF_MULTI_IMAGE  */
 
 
 static void
@@ -665,7 +676,8 @@ _gfortran_caf_get (caf_token_t token, size_t offset,
 
   if (rank == 0)
     {
-      void *sr = (void *) ((char *) MEMTOK (token) + offset);
+      void *sr = (void *) ((char *) CAF_MEMPTR (token, image_index)
+			   + offset);
       if (GFC_DESCRIPTOR_TYPE (dest) == GFC_DESCRIPTOR_TYPE (src)
 	  && dst_kind == src_kind)
 	{
@@ -726,7 +738,8 @@ _gfortran_caf_get (caf_token_t token, size_t offset,
 	      stride = src->dim[j]._stride;
 	    }
 	  array_offset_sr += (i / extent) * src->dim[rank-1]._stride;
-	  void *sr = (void *)((char *) MEMTOK (token) + offset
+	  void *sr = (void *)((char *) CAF_MEMPTR (token, image_index)
+			  + offset
 			  + array_offset_sr*GFC_DESCRIPTOR_SIZE (src));
           memcpy ((void *) ((char *) tmp + array_offset_dst), sr, src_size);
           array_offset_dst += src_size;
@@ -811,7 +824,8 @@ _gfortran_caf_get (caf_token_t token, size_t offset,
 	  stride = src->dim[j]._stride;
 	}
       array_offset_sr += (i / extent) * src->dim[rank-1]._stride;
-      void *sr = (void *)((char *) MEMTOK (token) + offset
+      void *sr = (void *)((char *) CAF_MEMPTR (token, image_index)
+			  + offset
 			  + array_offset_sr*GFC_DESCRIPTOR_SIZE (src));
 
       if (GFC_DESCRIPTOR_TYPE (dest) == GFC_DESCRIPTOR_TYPE (src)
@@ -858,7 +872,8 @@ _gfortran_caf_send (caf_token_t token, size_t offset,
 
   if (rank == 0)
     {
-      void *dst = (void *) ((char *) MEMTOK (token) + offset);
+      void *dst = (void *) ((char *) CAF_MEMPTR (token, image_index)
+			    + offset);
       if (GFC_DESCRIPTOR_TYPE (dest) == GFC_DESCRIPTOR_TYPE (src)
 	  && dst_kind == src_kind)
 	{
@@ -950,7 +965,8 @@ _gfortran_caf_send (caf_token_t token, size_t offset,
           stride = dest->dim[j]._stride;
 	    }
 	  array_offset_dst += (i / extent) * dest->dim[rank-1]._stride;
-	  void *dst = (void *)((char *) MEMTOK (token) + offset
+	  void *dst = (void *)((char *) CAF_MEMPTR (token, image_index)
+			  + offset
 		      + array_offset_dst*GFC_DESCRIPTOR_SIZE (dest));
           void *sr = tmp + array_offset_sr;
 	  if (GFC_DESCRIPTOR_TYPE (dest) == GFC_DESCRIPTOR_TYPE (src)
@@ -998,7 +1014,8 @@ _gfortran_caf_send (caf_token_t token, size_t offset,
           stride = dest->dim[j]._stride;
 	}
       array_offset_dst += (i / extent) * dest->dim[rank-1]._stride;
-      void *dst = (void *)((char *) MEMTOK (token) + offset
+      void *dst = (void *)((char *) CAF_MEMPTR (token, image_index)
+			  + offset
 			   + array_offset_dst*GFC_DESCRIPTOR_SIZE (dest));
       void *sr;
       if (GFC_DESCRIPTOR_RANK (src) != 0)
@@ -1061,8 +1078,9 @@ _gfortran_caf_sendget (caf_token_t dst_token, size_t dst_offset,
   /* For a single image, src->base_addr should be the same as src_token + offset
      but to play save, we do it properly.  */
   void *src_base = GFC_DESCRIPTOR_DATA (src);
-  GFC_DESCRIPTOR_DATA (src) = (void *) ((char *) MEMTOK (src_token)
-					+ src_offset);
+  GFC_DESCRIPTOR_DATA (src)
+    = (void *) ((char *) CAF_MEMPTR (src_token, src_image_index)
+		+ src_offset);
   _gfortran_caf_send (dst_token, dst_offset, dst_image_index, dest, dst_vector,
 		      src, dst_kind, src_kind, may_require_tmp, NULL);
   GFC_DESCRIPTOR_DATA (src) = src_base;
@@ -1473,7 +1491,7 @@ _gfortran_caf_get_by_ref (caf_token_t token,
   int dst_cur_dim = 0;
   size_t src_size = 0;
   caf_single_token_t single_token = TOKEN (token);
-  void *memptr = single_token->memptr;
+  void *memptr = CAF_MEMPTR (token, image_index);
   gfc_descriptor_t *src = single_token->desc;
   caf_reference_t *riter = refs;
   long delta;
@@ -1887,7 +1905,7 @@ _gfortran_caf_get_by_ref (caf_token_t token,
 
   /* Reset the token.  */
   single_token = TOKEN (token);
-  memptr = single_token->memptr;
+  memptr = CAF_MEMPTR (token, image_index);
   src = single_token->desc;
   memset(dst_index, 0, sizeof (dst_index));
   i = 0;
@@ -2340,7 +2358,7 @@ _gfortran_caf_send_by_ref (caf_token_t token,
   int src_cur_dim = 0;
   size_t src_size = 0;
   caf_single_token_t single_token = TOKEN (token);
-  void *memptr = single_token->memptr;
+  void *memptr = CAF_MEMPTR (token, image_index);
   gfc_descriptor_t *dst = single_token->desc;
   caf_reference_t *riter = refs;
   long delta;
@@ -2668,7 +2686,7 @@ _gfortran_caf_send_by_ref (caf_token_t token,
 
   /* Reset the token.  */
   single_token = TOKEN (token);
-  memptr = single_token->memptr;
+  memptr = CAF_MEMPTR (token, image_index);
   dst = single_token->desc;
   memset (dst_index, 0, sizeof (dst_index));
   i = 0;
@@ -2712,7 +2730,8 @@ _gfortran_caf_atomic_define (caf_token_t token, size_t offset,
 {
   assert(kind == 4);
 
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  uint32_t *atom = (uint32_t *) ((char *) CAF_MEMPTR (token, image_index)
+				  + offset);
 
   __atomic_store (atom, (uint32_t *) value, __ATOMIC_RELAXED);
 
@@ -2728,7 +2747,8 @@ _gfortran_caf_atomic_ref (caf_token_t token, size_t offset,
 {
   assert(kind == 4);
 
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  uint32_t *atom = (uint32_t *) ((char *) CAF_MEMPTR (token, image_index)
+				  + offset);
 
   __atomic_load (atom, (uint32_t *) value, __ATOMIC_RELAXED);
 
@@ -2745,7 +2765,8 @@ _gfortran_caf_atomic_cas (caf_token_t token, size_t offset,
 {
   assert(kind == 4);
 
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  uint32_t *atom = (uint32_t *) ((char *) CAF_MEMPTR (token, image_index)
+				  + offset);
 
   *(uint32_t *) old = *(uint32_t *) compare;
   (void) __atomic_compare_exchange_n (atom, (uint32_t *) old,
@@ -2765,7 +2786,8 @@ _gfortran_caf_atomic_op (int op, caf_token_t token, size_t offset,
   assert(kind == 4);
 
   uint32_t res;
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  uint32_t *atom = (uint32_t *) ((char *) CAF_MEMPTR (token, image_index)
+				  + offset);
 
   switch (op)
     {
@@ -2792,6 +2814,7 @@ _gfortran_caf_atomic_op (int op, caf_token_t token, size_t offset,
     *stat = 0;
 }
 
+#ifndef CAF_MULTI_IMAGE
 void
 _gfortran_caf_event_post (caf_token_t token, size_t index, 
 			  int image_index __attribute__ ((unused)), 
@@ -2910,6 +2933,7 @@ _gfortran_caf_unlock (caf_token_t token, size_t index,
     }
   _gfortran_caf_error_stop_str (msg, (int32_t) strlen (msg));
 }
+#endif /* CAF_MULTI_IMAGE  */
 
 int
 _gfortran_caf_is_present (caf_token_t token,
@@ -2924,7 +2948,7 @@ _gfortran_caf_is_present (caf_token_t token,
 				   "unknown array reference type.\n";
   size_t i;
   caf_single_token_t single_token = TOKEN (token);
-  void *memptr = single_token->memptr;
+  void *memptr = CAF_MEMPTR (token, image_index);
   gfc_descriptor_t *src = single_token->desc;
   caf_reference_t *riter = refs;
 
@@ -74,6 +74,22 @@ extern void matmul_c10 (gfc_array_c10 * const restrict retarray,
 	int blas_limit, blas_call gemm);
 export_proto(matmul_c10);
 
+/* Signature of the implementations of matmul_c10.  */
+
+typedef void (*matmul_c10_fn) (gfc_array_c10 * const restrict retarray, 
+	gfc_array_c10 * const restrict a, gfc_array_c10 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm);
+
+/* Multiply one block of columns for matmul_threaded.  FN points to
+   the implementation to use.  */
+
+static void
+matmul_c10_slice (void *fn, array_t *retarray, array_t *a, array_t *b)
+{
+  (**(matmul_c10_fn *) fn) ((gfc_array_c10 *) retarray, (gfc_array_c10 *) a,
+			(gfc_array_c10 *) b, 0, 0, NULL);
+}
+
 
 
 
@@ -2296,13 +2312,18 @@ void matmul_c10 (gfc_array_c10 * const restrict retarray,
    }
 
 tailcall:
+   if (try_blas == 0
+       && matmul_threaded ((array_t *) retarray, (array_t *) a,
+			   (array_t *) b, sizeof (GFC_COMPLEX_10),
+			   matmul_c10_slice, &matmul_p))
+     return;
    (*matmul_p) (retarray, a, b, try_blas, blas_limit, gemm);
 }
 
 #else  /* Just the vanilla function.  */
 
-void
-matmul_c10 (gfc_array_c10 * const restrict retarray, 
+static void
+matmul_c10_vanilla (gfc_array_c10 * const restrict retarray, 
 	gfc_array_c10 * const restrict a, gfc_array_c10 * const restrict b, int try_blas,
 	int blas_limit, blas_call gemm)
 {
@@ -2837,6 +2858,21 @@ matmul_c10 (gfc_array_c10 * const restrict retarray,
 #undef min
 #undef max
 
+void
+matmul_c10 (gfc_array_c10 * const restrict retarray, 
+	gfc_array_c10 * const restrict a, gfc_array_c10 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm)
+{
+  matmul_c10_fn fn = matmul_c10_vanilla;
+
+  if (try_blas == 0
+      && matmul_threaded ((array_t *) retarray, (array_t *) a,
+			  (array_t *) b, sizeof (GFC_COMPLEX_10),
+			  matmul_c10_slice, &fn))
+    return;
+  matmul_c10_vanilla (retarray, a, b, try_blas, blas_limit, gemm);
+}
+
 #endif
 #endif
 
@@ -74,6 +74,22 @@ extern void matmul_r16 (gfc_array_r16 * const restrict retarray,
 	int blas_limit, blas_call gemm);
 export_proto(matmul_r16);
 
+/* Signature of the implementations of matmul_r16.  */
+
+typedef void (*matmul_r16_fn) (gfc_array_r16 * const restrict retarray, 
+	gfc_array_r16 * const restrict a, gfc_array_r16 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm);
+
+/* Multiply one block of columns for matmul_threaded.  FN points to
+   the implementation to use.  */
+
+static void
+matmul_r16_slice (void *fn, array_t *retarray, array_t *a, array_t *b)
+{
+  (**(matmul_r16_fn *) fn) ((gfc_array_r16 *) retarray, (gfc_array_r16 *) a,
+			(gfc_array_r16 *) b, 0, 0, NULL);
+}
+
 #if defined(HAVE_AVX) && defined(HAVE_AVX2)
 /* REAL types generate identical code for AVX and AVX2.  Only generate
    an AVX2 function if we are dealing with integer.  */
@@ -2300,13 +2316,18 @@ void matmul_r16 (gfc_array_r16 * const restrict retarray,
    }
 
 tailcall:
+   if (try_blas == 0
+       && matmul_threaded ((array_t *) retarray, (array_t *) a,
+			   (array_t *) b, sizeof (GFC_REAL_16),
+			   matmul_r16_slice, &matmul_p))
+     return;
    (*matmul_p) (retarray, a, b, try_blas, blas_limit, gemm);
 }
 
 #else  /* Just the vanilla function.  */
 
-void
-matmul_r16 (gfc_array_r16 * const restrict retarray, 
+static void
+matmul_r16_vanilla (gfc_array_r16 * const restrict retarray, 
 	gfc_array_r16 * const restrict a, gfc_array_r16 * const restrict b, int try_blas,
 	int blas_limit, blas_call gemm)
 {
@@ -2841,6 +2862,21 @@ matmul_r16 (gfc_array_r16 * const restrict retarray,
 #undef min
 #undef max
 
+void
+matmul_r16 (gfc_array_r16 * const restrict retarray, 
+	gfc_array_r16 * const restrict a, gfc_array_r16 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm)
+{
+  matmul_r16_fn fn = matmul_r16_vanilla;
+
+  if (try_blas == 0
+      && matmul_threaded ((array_t *) retarray, (array_t *) a,
+			  (array_t *) b, sizeof (GFC_REAL_16),
+			  matmul_r16_slice, &fn))
+    return;
+  matmul_r16_vanilla (retarray, a, b, try_blas, blas_limit, gemm);
+}
+
 #endif
 #endif
 
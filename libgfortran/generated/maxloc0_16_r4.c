@@ -82,6 +82,25 @@ maxloc0_16_r4 (gfc_array_i16 * const restrict retarray,
 
   base = array->base_addr;
 
+  /* A contiguous array is searched as a whole.  */
+  {
+    index_type size = 1;
+
+    for (n = 0; n < rank && sstride[n] == size; n++)
+      size *= extent[n];
+    if (n == rank)
+      {
+	index_type pos = maxloc_contig_r4 (base, size);
+
+	for (n = 0; n < rank; n++)
+	  {
+	    dest[n * dstride] = pos % extent[n] + 1;
+	    pos /= extent[n];
+	  }
+	return;
+      }
+  }
+
   /* Initialize the return value.  */
   for (n = 0; n < rank; n++)
     dest[n * dstride] = 1;
@@ -147,6 +147,8 @@ maxloc1_16_i4 (gfc_array_i16 * const restrict retarray,
 	result = 1;
 	if (len <= 0)
 	  *dest = 0;
+	else if (delta == 1)
+	  *dest = (GFC_INTEGER_16) maxloc_contig_i4 (src, len) + 1;
 	else
 	  {
 	    for (n = 0; n < len; n++, src += delta)
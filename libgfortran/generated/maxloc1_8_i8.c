@@ -147,6 +147,8 @@ maxloc1_8_i8 (gfc_array_i8 * const restrict retarray,
 	result = 1;
 	if (len <= 0)
 	  *dest = 0;
+	else if (delta == 1)
+	  *dest = (GFC_INTEGER_8) maxloc_contig_i8 (src, len) + 1;
 	else
 	  {
 	    for (n = 0; n < len; n++, src += delta)
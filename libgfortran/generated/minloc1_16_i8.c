@@ -147,6 +147,8 @@ minloc1_16_i8 (gfc_array_i16 * const restrict retarray,
 	result = 1;
 	if (len <= 0)
 	  *dest = 0;
+	else if (delta == 1)
+	  *dest = (GFC_INTEGER_16) minloc_contig_i8 (src, len) + 1;
 	else
 	  {
 	    for (n = 0; n < len; n++, src += delta)
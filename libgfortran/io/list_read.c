@@ -1611,6 +1611,89 @@ eol_4:
 }
 
 
+/* Longest number read_real_fast handles.  */
+
+#define READ_REAL_FAST_MAX 64
+
+/* Fast path of read_real for the common case of a plain number, not a
+   repeat count, infinity or NaN, that is followed by a separator within
+   the buffered data of a default formatted external unit.  The number
+   is scanned straight from the unit buffer rather than one next_char
+   and push_char at a time.  Returns false without consuming anything
+   if the input is not of that form, leaving it all to read_real.  */
+
+static bool
+read_real_fast (st_parameter_dt *dtp, void *dest, int length)
+{
+  gfc_unit *u = dtp->u.p.current_unit;
+  char buffer[READ_REAL_FAST_MAX + 4];
+  const char *start, *p, *end;
+  char *out = buffer;
+  int digits = 0;
+
+  if (u->next_char_fn_ptr != &next_char_default || u->fbuf == NULL
+      || u->last_char != EOF - 1 || dtp->u.p.line_buffer_enabled
+      || dtp->u.p.namelist_mode || is_stream_io (dtp)
+      || u->decimal_status == DECIMAL_COMMA)
+    return false;
+
+  start = p = fbuf_getptr (u);
+  end = start + (u->fbuf->act - u->fbuf->pos);
+  if (end - start > READ_REAL_FAST_MAX)
+    end = start + READ_REAL_FAST_MAX;
+
+  if (p < end && (*p == '+' || *p == '-'))
+    *out++ = *p++;
+  for (; p < end && isdigit (*p); digits++)
+    *out++ = *p++;
+  if (p < end && *p == '.')
+    for (*out++ = *p++; p < end && isdigit (*p); digits++)
+      *out++ = *p++;
+  if (digits == 0 || p == end)
+    return false;
+
+  switch (*p)
+    {
+    case 'E':
+    case 'e':
+    case 'D':
+    case 'd':
+    case 'Q':
+    case 'q':
+      p++;
+      /* Fall through.  */
+    case '+':
+    case '-':
+      *out++ = 'e';
+      if (p < end && (*p == '+' || *p == '-'))
+	*out++ = *p++;
+      if (p == end || !isdigit (*p))
+	return false;
+      while (p < end && isdigit (*p))
+	*out++ = *p++;
+      if (p == end)
+	return false;
+      break;
+    }
+
+  switch (*p)
+    {
+    CASE_SEPARATORS:
+      break;
+    default:
+      return false;
+    }
+  *out = '\0';
+
+  u->fbuf->pos += p - start;
+  eat_separator (dtp);
+  if (convert_real (dtp, dest, buffer, length))
+    return true;
+  dtp->u.p.saved_type = BT_REAL;
+  return true;
+}
+
+
 /* Parse a real number with a possible repeat count.  */
 
 static void
@@ -1621,6 +1704,9 @@ read_real (st_parameter_dt *dtp, void * dest, int length)
   int seen_dp;
   int is_inf;
 
+  if (read_real_fast (dtp, dest, length))
+    return;
+
   seen_dp = 0;
 
   c = next_char (dtp);
@@ -117,6 +117,124 @@ si_max (int length)
 }
 
 
+/* convert_real_fast()-- Convert the string at BUFFER, as built by
+   read_f and the list formatted reads, to a REAL(4) or REAL(8) number
+   without strtod when that is exact.  This is Clinger's fast path: if
+   the decimal significand and the power of ten it is scaled by are
+   both exactly representable, a single correctly rounded
+   multiplication or division gives the correctly rounded result.
+   Returns false, leaving DEST alone, for any other input or when the
+   result cannot be guaranteed.  The FPU must be rounding to nearest.  */
+
+static bool
+convert_real_fast (void *dest, const char *buffer, int length)
+{
+#if FLT_EVAL_METHOD == 0
+  static const double pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const char *p = buffer;
+  GFC_UINTEGER_8 mant = 0;
+  GFC_REAL_8 r;
+  int exp10 = 0, zeros = 0, exp, i;
+  bool neg = false, seen_digit = false, seen_dp = false;
+
+  if (*p == '+' || *p == '-')
+    neg = *p++ == '-';
+
+  /* Trailing zeros are kept in ZEROS rather than in the significand, so
+     that they do not take up any of its digits.  */
+  for (;; p++)
+    {
+      if (*p == '.' && !seen_dp)
+	{
+	  seen_dp = true;
+	  continue;
+	}
+      if (!isdigit (*p))
+	break;
+      seen_digit = true;
+      if (seen_dp)
+	exp10--;
+      if (*p == '0')
+	{
+	  zeros++;
+	  continue;
+	}
+      for (i = 0; i <= zeros; i++)
+	{
+	  if (mant > (GFC_UINTEGER_8) 1 << 53)
+	    return false;
+	  mant *= 10;
+	}
+      mant += *p - '0';
+      zeros = 0;
+    }
+  if (!seen_digit)
+    return false;
+  exp10 += zeros;
+
+  if (*p == 'e' || *p == 'E')
+    {
+      bool eneg = false;
+
+      p++;
+      if (*p == '+' || *p == '-')
+	eneg = *p++ == '-';
+      if (!isdigit (*p))
+	return false;
+      for (exp = 0; isdigit (*p); p++)
+	{
+	  if (exp > 1000)
+	    return false;
+	  exp = exp * 10 + *p - '0';
+	}
+      exp10 += eneg ? -exp : exp;
+    }
+  if (*p != '\0')
+    return false;
+  if (mant == 0)
+    exp10 = 0;
+
+  if (mant > (GFC_UINTEGER_8) 1 << 53 || exp10 < -22 || exp10 > 22)
+    return false;
+  r = mant;
+  if (exp10 > 0)
+    r *= pow10[exp10];
+  else if (exp10 < 0)
+    r /= pow10[-exp10];
+
+  switch (length)
+    {
+    case 4:
+      {
+	/* R is the correctly rounded double, well within the range of
+	   normal floats.  Rounding it again gives the correctly rounded
+	   float unless R is within one unit of double precision of a
+	   midpoint between two floats.  */
+	GFC_UINTEGER_8 bits;
+
+	memcpy (&bits, &r, sizeof (bits));
+	if ((GFC_UINTEGER_4) (bits & 0x1fffffff) - 0x0fffffff <= 2)
+	  return false;
+	*((GFC_REAL_4 *) dest) = neg ? -r : r;
+	return true;
+      }
+
+    case 8:
+      *((GFC_REAL_8 *) dest) = neg ? -r : r;
+      return true;
+
+    default:
+      return false;
+    }
+#else
+  return false;
+#endif
+}
+
+
 /* convert_real()-- Convert a character representation of a floating
    point number to the machine number.  Returns nonzero if there is an
    invalid input.  Note: many architectures (e.g. IA-64, HP-PA)
@@ -144,6 +262,10 @@ convert_real (st_parameter_dt *dtp, void *dest, const char *buffer, int length)
     }
 
   old_round_mode = get_fpu_rounding_mode();
+  if (round_mode == ROUND_NEAREST && old_round_mode == ROUND_NEAREST
+      && convert_real_fast (dest, buffer, length))
+    return 0;
+
   set_fpu_rounding_mode (round_mode);
 
   switch (length)
@@ -4113,10 +4113,26 @@ st_write_done (st_parameter_dt *dtp)
 }
 
 
-/* F2003: This is a stub for the runtime portion of the WAIT statement.  */
+/* F2003: The runtime portion of the WAIT statement.  The only transfers
+   that can still be pending are the queued writes of units opened with
+   ASYNCHRONOUS='yes'; wait for those to finish and report their
+   errors.  */
 void
-st_wait (st_parameter_wait *wtp __attribute__((unused)))
+st_wait (st_parameter_wait *wtp)
 {
+  gfc_unit *u;
+
+  library_start (&wtp->common);
+
+  u = find_unit (wtp->common.unit);
+  if (u != NULL)
+    {
+      if (u->flags.async == ASYNC_YES && u->s != NULL && sflush (u->s) < 0)
+	generate_error (&wtp->common, LIBERROR_OS, NULL);
+      unlock_unit (u);
+    }
+
+  library_end ();
 }
 
 
@@ -184,7 +184,11 @@ fallback_access (const char *path, int mode)
 
 /* Unix and internal stream I/O module */
 
-static const int BUFFER_SIZE = 8192;
+/* Largest amount of data asynchronous writes of a unit may have queued
+   up.  Larger writes are done synchronously to avoid copying them.  */
+#define ASYNC_MAX_PENDING ((ssize_t) 64 << 20)
+
+typedef struct async_unit async_unit;
 
 typedef struct
 {
@@ -196,6 +200,7 @@ typedef struct
   gfc_offset file_length;	/* Length of the file. */
 
   char *buffer;                 /* Pointer to the buffer.  */
+  int buffer_size;		/* Size of the buffer.  */
   int fd;                       /* The POSIX file descriptor.  */
 
   int active;			/* Length of valid bytes in the buffer */
@@ -207,6 +212,10 @@ typedef struct
   ino_t st_ino;
 
   bool unbuffered;  /* Buffer should be flushed after each I/O statement.  */
+
+  /* Writes in progress on a helper thread for ASYNCHRONOUS='yes'
+     units, or NULL.  */
+  async_unit *async;
 }
 unix_stream;
 
@@ -479,8 +488,257 @@ improve performance. The buffer must be flushed when switching from
 reading to writing and vice versa.
 *********************************************************************/
 
+/*********************************************************************
+Asynchronous writes.  For units opened with ASYNCHRONOUS='yes', full
+buffers and large writes are handed to a helper thread, so that the
+program can continue computing while the data is written.  The data is
+copied, so the transfer is complete as far as the program is concerned
+when the data transfer statement returns.  Everything else that
+touches the file descriptor, and the WAIT, FLUSH and CLOSE statements,
+first wait for the queued writes to finish; errors of queued writes
+are reported then, or by the next write.
+*********************************************************************/
+
+#if defined (__GTHREADS) && defined (__GTHREADS_CXX0X)
+
+typedef struct async_request
+{
+  struct async_request *next;
+  char *data;
+  gfc_offset offset;
+  ssize_t len;
+}
+async_request;
+
+struct async_unit
+{
+  __gthread_t thread;
+  __gthread_mutex_t lock;
+  __gthread_cond_t cond;	/* Signalled on any change below.  */
+  async_request *head, *tail;
+  ssize_t pending;		/* Bytes queued or being written.  */
+  int error;			/* errno of the first failed write.  */
+  bool quit;
+};
+
+static void *
+async_thread (void *arg)
+{
+  unix_stream *s = arg;
+  async_unit *au = s->async;
+
+  __gthread_mutex_lock (&au->lock);
+  while (true)
+    {
+      async_request *r = au->head;
+
+      if (r == NULL)
+	{
+	  if (au->quit)
+	    break;
+	  __gthread_cond_wait (&au->cond, &au->lock);
+	  continue;
+	}
+
+      __gthread_mutex_unlock (&au->lock);
+      int err = 0;
+      if (raw_seek (s, r->offset, SEEK_SET) < 0
+	  || raw_write (s, r->data, r->len) != r->len)
+	err = errno ? errno : EIO;
+      free (r->data);
+      __gthread_mutex_lock (&au->lock);
+
+      au->head = r->next;
+      if (au->head == NULL)
+	au->tail = NULL;
+      au->pending -= r->len;
+      if (err != 0 && au->error == 0)
+	au->error = err;
+      free (r);
+      __gthread_cond_broadcast (&au->cond);
+    }
+  __gthread_mutex_unlock (&au->lock);
+  return NULL;
+}
+
+/* Start the helper thread of S.  If that fails, S just stays
+   synchronous.  */
+
+static void
+async_init (unix_stream * s)
+{
+  async_unit *au;
+
+  if (!__gthread_active_p ())
+    return;
+
+  au = xcalloc (1, sizeof (async_unit));
+#ifdef __GTHREAD_MUTEX_INIT
+  {
+    __gthread_mutex_t tmp = __GTHREAD_MUTEX_INIT;
+    au->lock = tmp;
+  }
+#else
+  __GTHREAD_MUTEX_INIT_FUNCTION (&au->lock);
+#endif
+#ifdef __GTHREAD_COND_INIT
+  {
+    __gthread_cond_t tmp = __GTHREAD_COND_INIT;
+    au->cond = tmp;
+  }
+#else
+  __GTHREAD_COND_INIT_FUNCTION (&au->cond);
+#endif
+
+  s->async = au;
+  if (__gthread_create (&au->thread, async_thread, s) != 0)
+    {
+      s->async = NULL;
+      __gthread_cond_destroy (&au->cond);
+      __gthread_mutex_destroy (&au->lock);
+      free (au);
+    }
+}
+
+/* Wait until all queued writes of S have been done.  Return -1 with
+   errno set if any of them failed.  */
+
 static int
-buf_flush (unix_stream * s)
+async_wait (unix_stream * s)
+{
+  async_unit *au = s->async;
+  int err;
+
+  if (au == NULL)
+    return 0;
+
+  __gthread_mutex_lock (&au->lock);
+  while (au->pending != 0)
+    __gthread_cond_wait (&au->cond, &au->lock);
+  err = au->error;
+  au->error = 0;
+  __gthread_mutex_unlock (&au->lock);
+
+  if (err != 0)
+    {
+      /* The file offset is unknown after a failed write.  */
+      s->physical_offset = -1;
+      errno = err;
+      return -1;
+    }
+  return 0;
+}
+
+/* Queue writing LEN bytes at DATA, which must have been allocated with
+   malloc and is freed once written, at offset OFFSET of S.  Return -1
+   with errno set if an earlier write failed.  */
+
+static int
+async_write (unix_stream * s, char *data, gfc_offset offset, ssize_t len)
+{
+  async_unit *au = s->async;
+  async_request *r;
+  int err;
+
+  r = xmalloc (sizeof (async_request));
+  r->next = NULL;
+  r->data = data;
+  r->offset = offset;
+  r->len = len;
+
+  __gthread_mutex_lock (&au->lock);
+  while (au->pending != 0 && au->pending + len > ASYNC_MAX_PENDING)
+    __gthread_cond_wait (&au->cond, &au->lock);
+  err = au->error;
+  if (err == 0)
+    {
+      if (au->tail)
+	au->tail->next = r;
+      else
+	au->head = r;
+      au->tail = r;
+      au->pending += len;
+      __gthread_cond_broadcast (&au->cond);
+    }
+  else
+    au->error = 0;
+  __gthread_mutex_unlock (&au->lock);
+
+  if (err != 0)
+    {
+      free (data);
+      free (r);
+      s->physical_offset = -1;
+      errno = err;
+      return -1;
+    }
+
+  /* This is where the helper thread leaves the file offset.  */
+  s->physical_offset = offset + len;
+  return 0;
+}
+
+/* Wait for the queued writes of S and stop its helper thread.  */
+
+static int
+async_close (unix_stream * s)
+{
+  async_unit *au = s->async;
+  int retval;
+
+  if (au == NULL)
+    return 0;
+
+  retval = async_wait (s);
+  __gthread_mutex_lock (&au->lock);
+  au->quit = true;
+  __gthread_cond_broadcast (&au->cond);
+  __gthread_mutex_unlock (&au->lock);
+  __gthread_join (au->thread, NULL);
+
+  __gthread_cond_destroy (&au->cond);
+  __gthread_mutex_destroy (&au->lock);
+  free (au);
+  s->async = NULL;
+  return retval;
+}
+
+#else
+
+static void
+async_init (unix_stream * s __attribute__ ((unused)))
+{
+}
+
+static int
+async_wait (unix_stream * s __attribute__ ((unused)))
+{
+  return 0;
+}
+
+static int
+async_write (unix_stream * s __attribute__ ((unused)),
+	     char *data __attribute__ ((unused)),
+	     gfc_offset offset __attribute__ ((unused)),
+	     ssize_t len __attribute__ ((unused)))
+{
+  abort ();
+}
+
+static int
+async_close (unix_stream * s __attribute__ ((unused)))
+{
+  return 0;
+}
+
+#endif
+
+
+/* Write out the dirty part of the buffer of S, or queue it for
+   writing if S is asynchronous.  */
+
+static int
+buf_write_out (unix_stream * s)
 {
   int writelen;
 
@@ -489,7 +747,21 @@ buf_flush (unix_stream * s)
 
   if (s->ndirty == 0)
     return 0;
-  
+
+  if (s->async)
+    {
+      char *data = s->buffer;
+      int ndirty = s->ndirty;
+
+      s->buffer = xmalloc (s->buffer_size);
+      s->ndirty = 0;
+      if (async_write (s, data, s->buffer_offset, ndirty) < 0)
+	return -1;
+      if (s->physical_offset > s->file_length)
+	s->file_length = s->physical_offset;
+      return 0;
+    }
+
   if (s->physical_offset != s->buffer_offset
       && raw_seek (s, s->buffer_offset, SEEK_SET) < 0)
     return -1;
@@ -508,6 +780,19 @@ buf_flush (unix_stream * s)
   return 0;
 }
 
+/* Write out the buffer of S, and for asynchronous units wait until
+   everything has been written.  */
+
+static int
+buf_flush (unix_stream * s)
+{
+  int retval = buf_write_out (s);
+
+  if (async_wait (s) != 0)
+    retval = -1;
+  return retval;
+}
+
 static ssize_t
 buf_read (unix_stream * s, void * buf, ssize_t nbyte)
 {
@@ -545,13 +830,15 @@ buf_read (unix_stream * s, void * buf, ssize_t nbyte)
       /* At this point we consider all bytes in the buffer discarded.  */
       to_read = nbyte - nread;
       new_logical = s->logical_offset + nread;
+      if (async_wait (s) != 0)
+	return -1;
       if (s->physical_offset != new_logical
           && raw_seek (s, new_logical, SEEK_SET) < 0)
         return -1;
       s->buffer_offset = s->physical_offset = new_logical;
-      if (to_read <= BUFFER_SIZE/2)
+      if (to_read <= s->buffer_size/2)
         {
-          did_read = raw_read (s, s->buffer, BUFFER_SIZE);
+          did_read = raw_read (s, s->buffer, s->buffer_size);
 	  if (likely (did_read >= 0))
 	    {
 	      s->physical_offset += did_read;
@@ -565,6 +852,17 @@ buf_read (unix_stream * s, void * buf, ssize_t nbyte)
       else
         {
           did_read = raw_read (s, p, to_read);
+	  /* Large reads from regular files may return less than asked
+	     for, e.g. at most 2 GB on Linux.  Read the rest as well
+	     instead of reporting a short record.  */
+	  if (!s->unbuffered)
+	    while (did_read > 0 && did_read < to_read)
+	      {
+		ssize_t more = raw_read (s, p + did_read, to_read - did_read);
+		if (more <= 0)
+		  break;
+		did_read += more;
+	      }
 	  if (likely (did_read >= 0))
 	    {
 	      s->physical_offset += did_read;
@@ -586,11 +884,11 @@ buf_write (unix_stream * s, const void * buf, ssize_t nbyte)
     s->buffer_offset = s->logical_offset;
 
   /* Does the data fit into the buffer?  As a special case, if the
-     buffer is empty and the request is bigger than BUFFER_SIZE/2,
-     write directly. This avoids the case where the buffer would have
-     to be flushed at every write.  */
-  if (!(s->ndirty == 0 && nbyte > BUFFER_SIZE/2)
-      && s->logical_offset + nbyte <= s->buffer_offset + BUFFER_SIZE
+     buffer is empty and the request is bigger than half the buffer
+     size, write directly. This avoids the case where the buffer would
+     have to be flushed at every write.  */
+  if (!(s->ndirty == 0 && nbyte > s->buffer_size/2)
+      && s->logical_offset + nbyte <= s->buffer_offset + s->buffer_size
       && s->buffer_offset <= s->logical_offset
       && s->buffer_offset + s->ndirty >= s->logical_offset)
     {
@@ -603,16 +901,27 @@ buf_write (unix_stream * s, const void * buf, ssize_t nbyte)
     {
       /* Flush, and either fill the buffer with the new data, or if
          the request is bigger than the buffer size, write directly
-         bypassing the buffer.  */
-      buf_flush (s);
-      if (nbyte <= BUFFER_SIZE/2)
+         bypassing the buffer.  Asynchronous units queue a copy of
+         large requests instead, and report failed earlier writes.  */
+      if (buf_write_out (s) != 0 && s->async)
+	return -1;
+      if (nbyte <= s->buffer_size/2)
         {
           memcpy (s->buffer, buf, nbyte);
           s->buffer_offset = s->logical_offset;
           s->ndirty += nbyte;
         }
+      else if (s->async && nbyte <= ASYNC_MAX_PENDING)
+	{
+	  char *data = xmalloc (nbyte);
+	  memcpy (data, buf, nbyte);
+	  if (async_write (s, data, s->logical_offset, nbyte) < 0)
+	    return -1;
+	}
       else
 	{
+	  if (async_wait (s) != 0)
+	    return -1;
 	  if (s->physical_offset != s->logical_offset)
 	    {
 	      if (raw_seek (s, s->logical_offset, SEEK_SET) < 0)
@@ -642,8 +951,10 @@ buf_write (unix_stream * s, const void * buf, ssize_t nbyte)
 static int
 buf_markeor (unix_stream * s)
 {
-  if (s->unbuffered || s->ndirty >= BUFFER_SIZE / 2)
+  if (s->unbuffered)
     return buf_flush (s);
+  if (s->ndirty >= s->buffer_size / 2)
+    return buf_write_out (s);
   return 0;
 }
 
@@ -700,7 +1011,11 @@ buf_truncate (unix_stream * s, gfc_offset length)
 static int
 buf_close (unix_stream * s)
 {
-  if (buf_flush (s) != 0)
+  int retval = buf_write_out (s);
+
+  if (async_close (s) != 0)
+    retval = -1;
+  if (retval != 0)
     return -1;
   free (s->buffer);
   return raw_close (s);
@@ -719,11 +1034,19 @@ static const struct stream_vtable buf_vtable = {
 };
 
 static int
-buf_init (unix_stream * s)
+buf_init (unix_stream * s, bool unformatted, bool async)
 {
   s->st.vptr = &buf_vtable;
 
-  s->buffer = xmalloc (BUFFER_SIZE);
+  s->buffer_size = (unformatted ? options.unformatted_buffer_size
+		    : options.formatted_buffer_size);
+  if (s->buffer_size <= 0)
+    s->buffer_size = (unformatted ? DEFAULT_UNFORMATTED_BUFFER_SIZE
+		      : DEFAULT_FORMATTED_BUFFER_SIZE);
+  s->buffer = xmalloc (s->buffer_size);
+
+  if (async)
+    async_init (s);
   return 0;
 }
 
@@ -1042,7 +1365,7 @@ open_internal4 (char *base, int length, gfc_offset offset)
  * around it. */
 
 static stream *
-fd_to_stream (int fd, bool unformatted)
+fd_to_stream (int fd, bool unformatted, bool async)
 {
   struct stat statbuf;
   unix_stream *s;
@@ -1074,13 +1397,13 @@ fd_to_stream (int fd, bool unformatted)
 	   (s->fd == STDIN_FILENO 
 	    || s->fd == STDOUT_FILENO 
 	    || s->fd == STDERR_FILENO)))
-    buf_init (s);
+    buf_init (s, unformatted, async);
   else
     {
       if (unformatted)
 	{
 	  s->unbuffered = true;
-	  buf_init (s);
+	  buf_init (s, unformatted, false);
 	}
       else
 	raw_init (s);
@@ -1523,7 +1846,8 @@ open_external (st_parameter_open *opp, unit_flags *flags)
   if (open_share (opp, fd, flags) < 0)
     return NULL;
 
-  return fd_to_stream (fd, flags->form == FORM_UNFORMATTED);
+  return fd_to_stream (fd, flags->form == FORM_UNFORMATTED,
+		       flags->async == ASYNC_YES);
 }
 
 
@@ -1533,7 +1857,7 @@ open_external (st_parameter_open *opp, unit_flags *flags)
 stream *
 input_stream (void)
 {
-  return fd_to_stream (STDIN_FILENO, false);
+  return fd_to_stream (STDIN_FILENO, false, false);
 }
 
 
@@ -1549,7 +1873,7 @@ output_stream (void)
   setmode (STDOUT_FILENO, O_BINARY);
 #endif
 
-  s = fd_to_stream (STDOUT_FILENO, false);
+  s = fd_to_stream (STDOUT_FILENO, false, false);
   return s;
 }
 
@@ -1566,7 +1890,7 @@ error_stream (void)
   setmode (STDERR_FILENO, O_BINARY);
 #endif
 
-  s = fd_to_stream (STDERR_FILENO, false);
+  s = fd_to_stream (STDERR_FILENO, false, false);
   return s;
 }
 
@@ -1679,6 +1679,32 @@ set_fnode_default (st_parameter_dt *dtp, fnode *f, int length)
     }
 }
 
+/* With GFORTRAN_SHORTEST_REAL, reduce the number of significant digits
+   of REAL(4) and REAL(8) list formatted and G0 output to the least
+   number that reads back as the same value.  At least one digit is
+   kept after the decimal point, which needs COMP_D + 1 digits when E
+   editing is used.  */
+
+static void
+set_shortest_digits (fnode *f, const char *source, int kind, int comp_d)
+{
+  int n, e;
+
+  if (!options.shortest_real)
+    return;
+
+  n = dtoa_shortest (source, kind, &e);
+  if (n == 0)
+    return;
+
+  if (e >= 0 && e + 2 <= f->u.real.d)
+    f->u.real.d = n > e + 2 ? n : e + 2;
+  else if (e == -1)
+    f->u.real.d = n;
+  else
+    f->u.real.d = n > comp_d + 1 ? n : comp_d + 1;
+}
+
 /* Output a real number with default format.
    To guarantee that a binary -> decimal -> binary roundtrip conversion
    recovers the original value, IEEE 754-2008 requires 9, 17, 21 and 36
@@ -1702,6 +1728,7 @@ write_real (st_parameter_dt *dtp, const char *source, int kind)
   int orig_scale = dtp->u.p.scale_factor;
   dtp->u.p.scale_factor = 1;
   set_fnode_default (dtp, &f, kind);
+  set_shortest_digits (&f, source, kind, 1);
 
   /* Precision for snprintf call.  */
   int precision = get_precision (dtp, &f, source, kind);
@@ -1746,6 +1773,8 @@ write_real_g0 (st_parameter_dt *dtp, const char *source, int kind, int d)
     comp_d = 1;
   else
     comp_d = 0;
+  if (d == 0)
+    set_shortest_digits (&f, source, kind, comp_d);
   dtp->u.p.g0_no_blanks = 1;
 
   /* Precision for snprintf call.  */
@@ -1778,7 +1807,7 @@ write_complex (st_parameter_dt *dtp, const char *source, int kind, size_t size)
      blanks.  We will pad left later.  */
   dtp->u.p.g0_no_blanks = 1;
 
-  fnode f ;
+  fnode f, f1, f2;
   char buf_stack[BUF_STACK_SZ];
   char str1_buf[BUF_STACK_SZ];
   char str2_buf[BUF_STACK_SZ];
@@ -1796,6 +1825,10 @@ write_complex (st_parameter_dt *dtp, const char *source, int kind, size_t size)
      blanks.  We will pad left later.  */
   dtp->u.p.g0_no_blanks = 1;
 
+  f1 = f2 = f;
+  set_shortest_digits (&f1, source, kind, 0);
+  set_shortest_digits (&f2, source + size / 2, kind, 0);
+
   /* Precision for snprintf call.  */
   int precision = get_precision (dtp, &f, source, kind);
 
@@ -1805,9 +1838,9 @@ write_complex (st_parameter_dt *dtp, const char *source, int kind, size_t size)
 
   buffer = select_buffer (dtp, &f, precision, buf_stack, &buf_size, kind);
 
-  get_float_string (dtp, &f, source , kind, 0, buffer,
+  get_float_string (dtp, &f1, source , kind, 0, buffer,
                            precision, buf_size, result1, &res_len1);
-  get_float_string (dtp, &f, source + size / 2 , kind, 0, buffer,
+  get_float_string (dtp, &f2, source + size / 2 , kind, 0, buffer,
                            precision, buf_size, result2, &res_len2);
   lblanks = width - res_len1 - res_len2 - 3;
 
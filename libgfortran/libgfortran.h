@@ -502,7 +502,7 @@ typedef GFC_ARRAY_DESCRIPTOR (GFC_MAX_DIMENSIONS, GFC_LOGICAL_16) gfc_array_l16;
 
 typedef struct
 {
-  int stdin_unit, stdout_unit, stderr_unit, optional_plus;
+  int stdin_unit, stdout_unit, stderr_unit, optional_plus, shortest_real;
   int locus;
 
   int separator_len;
@@ -510,6 +510,8 @@ typedef struct
 
   int all_unbuffered, unbuffered_preconnected, default_recl;
   int fpe, backtrace;
+  int matmul_threads;
+  int formatted_buffer_size, unformatted_buffer_size;
 }
 options_t;
 
@@ -579,6 +581,12 @@ iexport_data_proto(filename);
    Default value is 1 Gb.  */
 #define DEFAULT_RECL 1073741824
 
+/* Default sizes of the buffers of formatted and unformatted units
+   connected to regular files.  These can be overridden by environment
+   variables.  */
+#define DEFAULT_FORMATTED_BUFFER_SIZE 8192
+#define DEFAULT_UNFORMATTED_BUFFER_SIZE 131072
+
 
 #define CHARACTER2(name) \
               gfc_charlen_type name ## _len; \
@@ -1364,6 +1372,33 @@ extern index_type count_0 (const gfc_array_l1 *);
 
 internal_proto(count_0);
 
+/* matmul_threads.c */
+
+typedef void (*matmul_slice_fn) (void *, array_t *, array_t *, array_t *);
+
+extern int matmul_threaded (array_t *, array_t *, array_t *, size_t,
+			    matmul_slice_fn, void *);
+internal_proto(matmul_threaded);
+
+/* minmaxloc.c */
+
+extern index_type maxloc_contig_i4 (const GFC_INTEGER_4 *, index_type);
+internal_proto(maxloc_contig_i4);
+extern index_type minloc_contig_i4 (const GFC_INTEGER_4 *, index_type);
+internal_proto(minloc_contig_i4);
+extern index_type maxloc_contig_i8 (const GFC_INTEGER_8 *, index_type);
+internal_proto(maxloc_contig_i8);
+extern index_type minloc_contig_i8 (const GFC_INTEGER_8 *, index_type);
+internal_proto(minloc_contig_i8);
+extern index_type maxloc_contig_r4 (const GFC_REAL_4 *, index_type);
+internal_proto(maxloc_contig_r4);
+extern index_type minloc_contig_r4 (const GFC_REAL_4 *, index_type);
+internal_proto(minloc_contig_r4);
+extern index_type maxloc_contig_r8 (const GFC_REAL_8 *, index_type);
+internal_proto(maxloc_contig_r8);
+extern index_type minloc_contig_r8 (const GFC_REAL_8 *, index_type);
+internal_proto(minloc_contig_r8);
+
 /* Internal auxiliary functions for cshift */
 
 void cshift0_i1 (gfc_array_i1 *, const gfc_array_i1 *, ptrdiff_t, int);
@@ -197,6 +197,10 @@ static variable variable_table[] = {
   /* Print optional plus signs in numbers where permitted */
   { "GFORTRAN_OPTIONAL_PLUS", 0, &options.optional_plus, init_boolean },
 
+  /* Print list formatted and G0 real numbers with the fewest digits that
+     read back as the same value */
+  { "GFORTRAN_SHORTEST_REAL", 0, &options.shortest_real, init_boolean },
+
   /* Default maximum record length for sequential files */
   { "GFORTRAN_DEFAULT_RECL", DEFAULT_RECL, &options.default_recl,
     init_unsigned_integer },
@@ -210,6 +214,18 @@ static variable variable_table[] = {
   /* Print out a backtrace if possible on runtime error */
   { "GFORTRAN_ERROR_BACKTRACE", -1, &options.backtrace, init_boolean },
 
+  /* Buffer size for formatted files connected to regular files */
+  { "GFORTRAN_FORMATTED_BUFFER_SIZE", DEFAULT_FORMATTED_BUFFER_SIZE,
+    &options.formatted_buffer_size, init_unsigned_integer },
+
+  /* Buffer size for unformatted files connected to regular files */
+  { "GFORTRAN_UNFORMATTED_BUFFER_SIZE", DEFAULT_UNFORMATTED_BUFFER_SIZE,
+    &options.unformatted_buffer_size, init_unsigned_integer },
+
+  /* Maximum number of threads a single MATMUL may use */
+  { "GFORTRAN_MATMUL_THREADS", 1, &options.matmul_threads,
+    init_unsigned_integer },
+
   { NULL, 0, NULL, NULL }
 };
 
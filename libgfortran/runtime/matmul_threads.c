@@ -0,0 +1,171 @@
+/* Multithreaded driver for the MATMUL intrinsic.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran runtime library (libgfortran).
+
+Libgfortran is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+Libgfortran is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+#include "libgfortran.h"
+#include <gthr.h>
+
+
+/* Minimum number of multiply-adds for each thread; below this, starting
+   a thread costs more than it saves.  */
+
+#define MATMUL_THREAD_MIN_WORK ((index_type) 1 << 21)
+
+#if defined (__GTHREADS) && defined (__GTHREADS_CXX0X)
+
+/* A block of columns of the result, computed by one thread.  */
+
+typedef struct
+{
+  matmul_slice_fn fn;
+  void *data;
+  array_t *a;
+  array_t retarray;
+  array_t b;
+  __gthread_t thread;
+  int started;
+}
+matmul_slice;
+
+static void *
+matmul_slice_thread (void *arg)
+{
+  matmul_slice *s = arg;
+  s->fn (s->data, &s->retarray, s->a, &s->b);
+  return NULL;
+}
+
+/* Return a copy of the rank 2 descriptor DESC covering columns
+   [J0, J1) only.  SIZE is the size of an element.  */
+
+static void
+column_block (array_t *block, const array_t *desc, index_type j0,
+	      index_type j1, size_t size)
+{
+  index_type stride = GFC_DESCRIPTOR_STRIDE (desc, 1);
+
+  block->base_addr = (char *) desc->base_addr + j0 * stride * size;
+  block->offset = 0;
+  block->dtype = desc->dtype;
+  block->dim[0] = desc->dim[0];
+  GFC_DIMENSION_SET (block->dim[1], 0, j1 - j0 - 1, stride);
+}
+
+
+/* Compute RETARRAY = MATMUL (A, B) with several threads if the
+   GFORTRAN_MATMUL_THREADS environment variable allows it and the
+   matrices are large enough, and return nonzero.  Return zero, doing
+   nothing, if the caller should do the multiplication by itself.
+
+   The columns of B and of the result are split into one block per
+   thread, and FN (DATA, R, A, B) is called for each block with R and B
+   describing just those columns.  SIZE is the size of an element.
+   Shape errors are left to the serial code to diagnose.  */
+
+int
+matmul_threaded (array_t *retarray, array_t *a, array_t *b, size_t size,
+		 matmul_slice_fn fn, void *data)
+{
+  index_type xcount, ycount, count, nthreads, i;
+  matmul_slice *slices;
+  double work;
+
+  nthreads = options.matmul_threads;
+  if (nthreads <= 1 || !__gthread_active_p ())
+    return 0;
+
+  if (GFC_DESCRIPTOR_RANK (a) != 2 || GFC_DESCRIPTOR_RANK (b) != 2)
+    return 0;
+
+  xcount = GFC_DESCRIPTOR_EXTENT (a, 0);
+  count = GFC_DESCRIPTOR_EXTENT (a, 1);
+  ycount = GFC_DESCRIPTOR_EXTENT (b, 1);
+  if (count != GFC_DESCRIPTOR_EXTENT (b, 0))
+    return 0;
+
+  work = (double) xcount * (double) ycount * (double) count;
+  if (work < (double) nthreads * MATMUL_THREAD_MIN_WORK)
+    nthreads = work / MATMUL_THREAD_MIN_WORK;
+  if (nthreads > ycount)
+    nthreads = ycount;
+  if (nthreads <= 1)
+    return 0;
+
+  if (retarray->base_addr == NULL)
+    {
+      GFC_DIMENSION_SET (retarray->dim[0], 0, xcount - 1, 1);
+      GFC_DIMENSION_SET (retarray->dim[1], 0, ycount - 1, xcount);
+      retarray->base_addr = xmallocarray (size0 (retarray), size);
+      retarray->offset = 0;
+    }
+  else if (GFC_DESCRIPTOR_EXTENT (retarray, 0) != xcount
+	   || GFC_DESCRIPTOR_EXTENT (retarray, 1) != ycount)
+    return 0;
+
+  slices = xmallocarray (nthreads, sizeof (matmul_slice));
+  for (i = 0; i < nthreads; i++)
+    {
+      index_type j0 = ycount * i / nthreads;
+      index_type j1 = ycount * (i + 1) / nthreads;
+
+      slices[i].fn = fn;
+      slices[i].data = data;
+      slices[i].a = a;
+      column_block (&slices[i].retarray, retarray, j0, j1, size);
+      column_block (&slices[i].b, b, j0, j1, size);
+    }
+
+  /* The calling thread does the first block, and any block for which
+     no thread could be started.  */
+  for (i = 1; i < nthreads; i++)
+    slices[i].started = __gthread_create (&slices[i].thread,
+					  matmul_slice_thread,
+					  &slices[i]) == 0;
+
+  matmul_slice_thread (&slices[0]);
+  for (i = 1; i < nthreads; i++)
+    {
+      if (slices[i].started)
+	__gthread_join (slices[i].thread, NULL);
+      else
+	matmul_slice_thread (&slices[i]);
+    }
+
+  free (slices);
+  return 1;
+}
+
+#else
+
+int
+matmul_threaded (array_t *retarray __attribute__ ((unused)),
+		 array_t *a __attribute__ ((unused)),
+		 array_t *b __attribute__ ((unused)),
+		 size_t size __attribute__ ((unused)),
+		 matmul_slice_fn fn __attribute__ ((unused)),
+		 void *data __attribute__ ((unused)))
+{
+  return 0;
+}
+
+#endif
@@ -0,0 +1,134 @@
+/* Vectorized MAXLOC and MINLOC kernels for contiguous arrays.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran runtime library (libgfortran).
+
+Libgfortran is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+Libgfortran is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+#include "libgfortran.h"
+#include <string.h>
+
+/* The first-index semantics of MAXLOC tie the position to the value,
+   which keeps the compiler from vectorizing the scalar loop.  Here the
+   array is processed in blocks: the extreme value of a block is found
+   with vector compares, and only a block that improves on the current
+   extreme value is scanned again for its position.  After the first few
+   blocks that is rare, so nearly all elements are handled by the vector
+   compares.  NaNs never compare greater or less, so they are skipped
+   exactly as by the scalar loop.  */
+
+#define MINMAXLOC_BLOCK 64
+
+typedef GFC_INTEGER_4 minmaxloc_v4si __attribute__ ((vector_size (16)));
+typedef GFC_INTEGER_8 minmaxloc_v2di __attribute__ ((vector_size (16)));
+typedef GFC_REAL_4 minmaxloc_v4sf __attribute__ ((vector_size (16)));
+typedef GFC_REAL_8 minmaxloc_v2df __attribute__ ((vector_size (16)));
+
+/* Replace the lanes of ACC for which V OP ACC holds with those of V.  */
+
+#define MINMAXLOC_MERGE(ACC, V, VTYPE, MTYPE, OP)			\
+  do									\
+    {									\
+      MTYPE c_ = (V) OP (ACC);						\
+      (ACC) = (VTYPE) (((MTYPE) (V) & c_) | ((MTYPE) (ACC) & ~c_));	\
+    }									\
+  while (0)
+
+/* Define NAME, returning the zero-based position of the first element of
+   SRC[0..LEN-1], LEN > 0, for which OP holds against all others.  A
+   leading run of NaNs is skipped; if all elements are NaN, the result is
+   zero.  VTYPE is a vector of TYPE and MTYPE the integer vector of the
+   same size.  Four accumulators hide the latency of the compares.  */
+
+#define DEFINE_MINMAXLOC(NAME, TYPE, VTYPE, MTYPE, OP)			\
+index_type								\
+NAME (const TYPE *src, index_type len)					\
+{									\
+  const int vlen = sizeof (VTYPE) / sizeof (TYPE);			\
+  index_type i, j, res;							\
+  TYPE m;								\
+									\
+  for (res = 0; res < len && src[res] != src[res]; res++)		\
+    ;									\
+  if (res == len)							\
+    return 0;								\
+  m = src[res];								\
+									\
+  for (i = res + 1; i + MINMAXLOC_BLOCK <= len; i += MINMAXLOC_BLOCK)	\
+    {									\
+      VTYPE a0, a1, a2, a3;						\
+      TYPE bm;								\
+									\
+      for (j = 0; j < vlen; j++)					\
+	a0[j] = m;							\
+      a1 = a2 = a3 = a0;						\
+      for (j = 0; j < MINMAXLOC_BLOCK; j += 4 * vlen)			\
+	{								\
+	  VTYPE v0, v1, v2, v3;						\
+	  memcpy (&v0, src + i + j, sizeof (v0));			\
+	  memcpy (&v1, src + i + j + vlen, sizeof (v1));		\
+	  memcpy (&v2, src + i + j + 2 * vlen, sizeof (v2));		\
+	  memcpy (&v3, src + i + j + 3 * vlen, sizeof (v3));		\
+	  MINMAXLOC_MERGE (a0, v0, VTYPE, MTYPE, OP);			\
+	  MINMAXLOC_MERGE (a1, v1, VTYPE, MTYPE, OP);			\
+	  MINMAXLOC_MERGE (a2, v2, VTYPE, MTYPE, OP);			\
+	  MINMAXLOC_MERGE (a3, v3, VTYPE, MTYPE, OP);			\
+	}								\
+      MINMAXLOC_MERGE (a0, a1, VTYPE, MTYPE, OP);			\
+      MINMAXLOC_MERGE (a2, a3, VTYPE, MTYPE, OP);			\
+      MINMAXLOC_MERGE (a0, a2, VTYPE, MTYPE, OP);			\
+      bm = a0[0];							\
+      for (j = 1; j < vlen; j++)					\
+	if (a0[j] OP bm)						\
+	  bm = a0[j];							\
+      if (bm OP m)							\
+	for (j = i; j < i + MINMAXLOC_BLOCK; j++)			\
+	  if (src[j] OP m)						\
+	    {								\
+	      m = src[j];						\
+	      res = j;							\
+	    }								\
+    }									\
+									\
+  for (; i < len; i++)							\
+    if (src[i] OP m)							\
+      {									\
+	m = src[i];							\
+	res = i;							\
+      }									\
+  return res;								\
+}
+
+DEFINE_MINMAXLOC (maxloc_contig_i4, GFC_INTEGER_4, minmaxloc_v4si,
+		  minmaxloc_v4si, >)
+DEFINE_MINMAXLOC (minloc_contig_i4, GFC_INTEGER_4, minmaxloc_v4si,
+		  minmaxloc_v4si, <)
+DEFINE_MINMAXLOC (maxloc_contig_i8, GFC_INTEGER_8, minmaxloc_v2di,
+		  minmaxloc_v2di, >)
+DEFINE_MINMAXLOC (minloc_contig_i8, GFC_INTEGER_8, minmaxloc_v2di,
+		  minmaxloc_v2di, <)
+DEFINE_MINMAXLOC (maxloc_contig_r4, GFC_REAL_4, minmaxloc_v4sf,
+		  minmaxloc_v4si, >)
+DEFINE_MINMAXLOC (minloc_contig_r4, GFC_REAL_4, minmaxloc_v4sf,
+		  minmaxloc_v4si, <)
+DEFINE_MINMAXLOC (maxloc_contig_r8, GFC_REAL_8, minmaxloc_v2df,
+		  minmaxloc_v2di, >)
+DEFINE_MINMAXLOC (minloc_contig_r8, GFC_REAL_8, minmaxloc_v2df,
+		  minmaxloc_v2di, <)
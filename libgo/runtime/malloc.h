@@ -115,6 +115,7 @@ enum
 	FixAllocChunk = 16<<10,		// Chunk size for FixAlloc
 	MaxMHeapList = 1<<(20 - PageShift),	// Maximum page length for fixed-size list in MHeap.
 	HeapAllocChunk = 1<<20,		// Chunk size for heap growth
+	MCentralGrowPages = 8,		// Max pages fetched from heap by one MCentral refill
 
 	// Number of bits in page to span calculations (4k pages).
 	// On Windows 64-bit we limit the arena to 32GB or 35 bits (see below for reason).
@@ -398,6 +399,7 @@ extern MHeap runtime_mheap;
 
 void	runtime_MHeap_Init(MHeap *h);
 MSpan*	runtime_MHeap_Alloc(MHeap *h, uintptr npage, int32 sizeclass, bool large, bool needzero);
+int32	runtime_MHeap_AllocSmall(MHeap *h, uintptr npage, int32 sizeclass, MSpan **spans, int32 nspan);
 void	runtime_MHeap_Free(MHeap *h, MSpan *s, int32 acct);
 MSpan*	runtime_MHeap_Lookup(MHeap *h, void *v);
 MSpan*	runtime_MHeap_LookupMaybe(MHeap *h, void *v);
@@ -249,42 +249,52 @@ runtime_MGetSizeClassInfo(int32 sizeclass, uintptr *sizep, int32 *npagesp, int32
 	*nobj = (npages << PageShift) / size;
 }
 
-// Fetch a new span from the heap and
+// Fetch new spans from the heap and
 // carve into objects for the free list.
+// Small spans are fetched in batches of up to MCentralGrowPages pages,
+// so that allocation-heavy programs take the heap lock less often.
 static bool
 MCentral_Grow(MCentral *c)
 {
-	int32 i, n, npages;
+	int32 i, j, n, npages, nspan;
 	uintptr size;
 	MLink **tailp, *v;
 	byte *p;
-	MSpan *s;
+	MSpan *s, *spans[MCentralGrowPages];
 
 	runtime_unlock(c);
 	runtime_MGetSizeClassInfo(c->sizeclass, &size, &npages, &n);
-	s = runtime_MHeap_Alloc(&runtime_mheap, npages, c->sizeclass, 0, 1);
-	if(s == nil) {
+	nspan = MCentralGrowPages / npages;
+	if(nspan < 1)
+		nspan = 1;
+	nspan = runtime_MHeap_AllocSmall(&runtime_mheap, npages, c->sizeclass, spans, nspan);
+	if(nspan == 0) {
 		// TODO(rsc): Log out of memory
 		runtime_lock(c);
 		return false;
 	}
 
-	// Carve span into sequence of blocks.
-	tailp = &s->freelist;
-	p = (byte*)(s->start << PageShift);
-	s->limit = (uintptr)(p + size*n);
-	for(i=0; i<n; i++) {
-		v = (MLink*)p;
-		*tailp = v;
-		tailp = &v->next;
-		p += size;
+	for(j=0; j<nspan; j++) {
+		// Carve span into sequence of blocks.
+		s = spans[j];
+		tailp = &s->freelist;
+		p = (byte*)(s->start << PageShift);
+		s->limit = (uintptr)(p + size*n);
+		for(i=0; i<n; i++) {
+			v = (MLink*)p;
+			*tailp = v;
+			tailp = &v->next;
+			p += size;
+		}
+		*tailp = nil;
+		runtime_markspan((byte*)(s->start<<PageShift), size, n, size*n < (s->npages<<PageShift));
 	}
-	*tailp = nil;
-	runtime_markspan((byte*)(s->start<<PageShift), size, n, size*n < (s->npages<<PageShift));
 
 	runtime_lock(c);
-	c->nfree += n;
-	runtime_MSpanList_Insert(&c->nonempty, s);
+	for(j=0; j<nspan; j++) {
+		c->nfree += n;
+		runtime_MSpanList_Insert(&c->nonempty, spans[j]);
+	}
 	return true;
 }
 
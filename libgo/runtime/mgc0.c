@@ -48,7 +48,8 @@
 // When a goroutine explicitly frees an object or sets a finalizer, it ensures that
 // the span is swept (either by sweeping it, or by waiting for the concurrent sweep to finish).
 // The finalizer goroutine is kicked off only when all spans are swept.
-// When the next GC starts, it sweeps all not-yet-swept spans (if any).
+// When the next GC starts, it sweeps all not-yet-swept spans (if any) before
+// stopping the world, so that the pause does not grow with the unswept heap.
 
 #include <unistd.h>
 
@@ -2152,6 +2153,12 @@ runtime_gc(int32 force)
 		return;
 	}
 
+	// Finish the sweep of the previous cycle while the world is still
+	// running.  Other goroutines keep allocating, but none can start
+	// another GC while we hold worldsema.
+	while(runtime_sweepone() != (uintptr)-1)
+		gcstats.nbgsweep++;
+
 	// Ok, we're doing it!  Stop everybody else
 	a.start_time = runtime_nanotime();
 	a.eagersweep = force >= 2;
@@ -2235,7 +2242,7 @@ gc(struct gc_args *args)
 	if(runtime_debug.gctrace)
 		tm1 = runtime_nanotime();
 
-	// Sweep what is not sweeped by bgsweep.
+	// Sweep what is not sweeped by bgsweep or before stopping the world.
 	while(runtime_sweepone() != (uintptr)-1)
 		gcstats.npausesweep++;
 
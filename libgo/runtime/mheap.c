@@ -17,6 +17,7 @@
 #include "malloc.h"
 
 static MSpan *MHeap_AllocLocked(MHeap*, uintptr, int32);
+static bool MHeap_HaveFree(MHeap*, uintptr);
 static bool MHeap_Grow(MHeap*, uintptr);
 static void MHeap_FreeLocked(MHeap*, MSpan*);
 static MSpan *MHeap_AllocLarge(MHeap*, uintptr);
@@ -204,6 +205,52 @@ runtime_MHeap_Alloc(MHeap *h, uintptr npage, int32 sizeclass, bool large, bool n
 	return s;
 }
 
+// Allocate up to nspan spans of npage pages each for small objects of
+// the given size class, taking the heap lock only once.  The first span
+// may grow the heap; further spans are only taken from memory that is
+// already free.  Stores the spans in spans and returns their number.
+int32
+runtime_MHeap_AllocSmall(MHeap *h, uintptr npage, int32 sizeclass, MSpan **spans, int32 nspan)
+{
+	MStats *pmstats;
+	MSpan *s;
+	int32 i, n;
+
+	runtime_lock(h);
+	pmstats = mstats();
+	pmstats->heap_alloc += (intptr)runtime_m()->mcache->local_cachealloc;
+	runtime_m()->mcache->local_cachealloc = 0;
+	for(n = 0; n < nspan; n++) {
+		if(n > 0 && (!h->sweepdone || !MHeap_HaveFree(h, npage)))
+			break;
+		s = MHeap_AllocLocked(h, npage, sizeclass);
+		if(s == nil)
+			break;
+		pmstats->heap_inuse += npage<<PageShift;
+		spans[n] = s;
+	}
+	runtime_unlock(h);
+	for(i = 0; i < n; i++) {
+		s = spans[i];
+		if(s->needzero)
+			runtime_memclr((byte*)(s->start<<PageShift), s->npages<<PageShift);
+		s->needzero = 0;
+	}
+	return n;
+}
+
+// Whether a span of npage pages can be allocated without growing the heap.
+static bool
+MHeap_HaveFree(MHeap *h, uintptr npage)
+{
+	uintptr n;
+
+	for(n=npage; n < nelem(h->free); n++)
+		if(!runtime_MSpanList_IsEmpty(&h->free[n]))
+			return true;
+	return !runtime_MSpanList_IsEmpty(&h->freelarge);
+}
+
 static MSpan*
 MHeap_AllocLocked(MHeap *h, uintptr npage, int32 sizeclass)
 {
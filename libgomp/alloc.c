@@ -57,3 +57,26 @@ gomp_realloc (void *old, size_t size)
     gomp_fatal ("Out of memory allocating %lu bytes", (unsigned long) size);
   return ret;
 }
+
+/* Allocate SIZE bytes aligned to AL, which must be a power of two.
+   The block must be released with gomp_aligned_free.  */
+
+void *
+gomp_aligned_alloc (size_t al, size_t size)
+{
+  void *ret, *p;
+
+  if (al < sizeof (void *))
+    al = sizeof (void *);
+  p = gomp_malloc (size + al);
+  ret = (void *) (((uintptr_t) p + al) & -al);
+  ((void **) ret)[-1] = p;
+  return ret;
+}
+
+void
+gomp_aligned_free (void *ptr)
+{
+  if (ptr)
+    free (((void **) ptr)[-1]);
+}
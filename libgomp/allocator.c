@@ -0,0 +1,423 @@
+/* Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file contains the OpenMP memory allocator routines: omp_alloc,
+   omp_free and the allocator handles they take.  All memory spaces are
+   backed by ordinary host memory; the pinned and partition traits are
+   honored by mapping the block separately and locking it or setting its
+   NUMA policy.  */
+
+#include "libgomp.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#define omp_max_predefined_alloc omp_thread_mem_alloc
+
+/* Linux mbind policies, from <linux/mempolicy.h>.  */
+#define GOMP_MPOL_PREFERRED	1
+#define GOMP_MPOL_INTERLEAVE	3
+
+struct omp_allocator_data
+{
+  omp_memspace_handle_t memspace;
+  omp_uintptr_t alignment;
+  omp_uintptr_t pool_size;
+  omp_uintptr_t used_pool_size;
+  omp_allocator_handle_t fb_data;
+  unsigned int sync_hint : 8;
+  unsigned int access : 8;
+  unsigned int fallback : 8;
+  unsigned int pinned : 1;
+  unsigned int partition : 7;
+};
+
+/* Placed right before each block returned by omp_alloc.  PTR is the
+   underlying malloc or mmap allocation and SIZE the number of bytes
+   requested for it, which is also what was charged to the pool.  */
+
+struct omp_mem_header
+{
+  void *ptr;
+  size_t size;
+  omp_allocator_handle_t allocator;
+  /* Whether PTR was mapped by gomp_alloc_mapped, and whether it is
+     locked in memory.  */
+  bool mapped;
+  bool pinned;
+};
+
+omp_allocator_handle_t
+omp_init_allocator (omp_memspace_handle_t memspace, int ntraits,
+		    const omp_alloctrait_t traits[])
+{
+  struct omp_allocator_data data
+    = { memspace, 1, ~(omp_uintptr_t) 0, 0, 0, omp_atv_contended, omp_atv_all,
+	omp_atv_default_mem_fb, omp_atv_false, omp_atv_environment };
+  struct omp_allocator_data *ret;
+  int i;
+
+  if (memspace > omp_low_lat_mem_space)
+    return omp_null_allocator;
+  for (i = 0; i < ntraits; i++)
+    switch (traits[i].key)
+      {
+      case omp_atk_sync_hint:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.sync_hint = omp_atv_contended;
+	    break;
+	  case omp_atv_contended:
+	  case omp_atv_uncontended:
+	  case omp_atv_sequential:
+	  case omp_atv_private:
+	    data.sync_hint = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_alignment:
+	if (traits[i].value == omp_atv_default)
+	  data.alignment = 1;
+	else if ((traits[i].value & (traits[i].value - 1)) != 0
+		 || !traits[i].value)
+	  return omp_null_allocator;
+	else
+	  data.alignment = traits[i].value;
+	break;
+      case omp_atk_access:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.access = omp_atv_all;
+	    break;
+	  case omp_atv_all:
+	  case omp_atv_cgroup:
+	  case omp_atv_pteam:
+	  case omp_atv_thread:
+	    data.access = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_pool_size:
+	if (traits[i].value == omp_atv_default)
+	  data.pool_size = ~(omp_uintptr_t) 0;
+	else
+	  data.pool_size = traits[i].value;
+	break;
+      case omp_atk_fallback:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.fallback = omp_atv_default_mem_fb;
+	    break;
+	  case omp_atv_default_mem_fb:
+	  case omp_atv_null_fb:
+	  case omp_atv_abort_fb:
+	  case omp_atv_allocator_fb:
+	    data.fallback = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_fb_data:
+	data.fb_data = traits[i].value;
+	break;
+      case omp_atk_pinned:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	  case omp_atv_false:
+	    data.pinned = omp_atv_false;
+	    break;
+	  case omp_atv_true:
+	    data.pinned = omp_atv_true;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_partition:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.partition = omp_atv_environment;
+	    break;
+	  case omp_atv_environment:
+	  case omp_atv_nearest:
+	  case omp_atv_blocked:
+	  case omp_atv_interleaved:
+	    data.partition = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      default:
+	return omp_null_allocator;
+      }
+
+  if (data.alignment < sizeof (void *))
+    data.alignment = sizeof (void *);
+  if (data.fallback == omp_atv_allocator_fb
+      && data.fb_data == omp_null_allocator)
+    return omp_null_allocator;
+
+  ret = gomp_malloc (sizeof (struct omp_allocator_data));
+  *ret = data;
+  return (omp_allocator_handle_t) ret;
+}
+
+void
+omp_destroy_allocator (omp_allocator_handle_t allocator)
+{
+  if (allocator != omp_null_allocator
+      && allocator > omp_max_predefined_alloc)
+    free ((void *) allocator);
+}
+
+ialias (omp_init_allocator)
+ialias (omp_destroy_allocator)
+
+void
+omp_set_default_allocator (omp_allocator_handle_t allocator)
+{
+  struct gomp_task_icv *icv = gomp_icv (true);
+  if (allocator == omp_null_allocator)
+    allocator = omp_default_mem_alloc;
+  icv->default_allocator_var = allocator;
+}
+
+omp_allocator_handle_t
+omp_get_default_allocator (void)
+{
+  struct gomp_task_icv *icv = gomp_icv (false);
+  return (omp_allocator_handle_t) icv->default_allocator_var;
+}
+
+ialias (omp_set_default_allocator)
+ialias (omp_get_default_allocator)
+
+/* Allocate SIZE bytes for an allocator with the PINNED and PARTITION
+   traits by mapping whole pages, so that locking them or changing their
+   NUMA policy doesn't affect any other allocation.  Return NULL on
+   failure.  */
+
+static void *
+gomp_alloc_mapped (size_t size, bool pinned, unsigned int partition)
+{
+#ifdef __linux__
+  size_t page = sysconf (_SC_PAGESIZE);
+  void *ptr;
+
+  if (size > ~(size_t) 0 - page)
+    return NULL;
+  size = (size + page - 1) & ~(page - 1);
+  ptr = mmap (NULL, size, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return NULL;
+
+#ifdef SYS_mbind
+  /* The placement is only a hint, the block is usable whatever the
+     kernel says.  With OMP_PROC_BIND the calling thread stays on its
+     place, so "nearest" means the NUMA node of that place.  */
+  if (partition == omp_atv_nearest)
+    syscall (SYS_mbind, ptr, size, GOMP_MPOL_PREFERRED, NULL, 0UL, 0U);
+  else if (partition == omp_atv_interleaved)
+    {
+      unsigned long nodes[1024 / (8 * sizeof (unsigned long))];
+      memset (nodes, 0xff, sizeof (nodes));
+      syscall (SYS_mbind, ptr, size, GOMP_MPOL_INTERLEAVE, nodes,
+	       (unsigned long) (8 * sizeof (nodes)), 0U);
+    }
+#else
+  (void) partition;
+#endif
+
+  if (pinned && mlock (ptr, size) != 0)
+    {
+      munmap (ptr, size);
+      return NULL;
+    }
+  return ptr;
+#else
+  (void) size;
+  (void) pinned;
+  (void) partition;
+  return NULL;
+#endif
+}
+
+/* Release a block of SIZE bytes allocated by gomp_alloc_mapped.  */
+
+static void
+gomp_free_mapped (void *ptr, size_t size, bool pinned)
+{
+#ifdef __linux__
+  size_t page = sysconf (_SC_PAGESIZE);
+
+  size = (size + page - 1) & ~(page - 1);
+  if (pinned)
+    munlock (ptr, size);
+  munmap (ptr, size);
+#else
+  (void) ptr;
+  (void) size;
+  (void) pinned;
+#endif
+}
+
+void *
+omp_alloc (size_t size, omp_allocator_handle_t allocator)
+{
+  struct omp_allocator_data *allocator_data;
+  size_t alignment = sizeof (void *), new_size;
+  void *ptr, *ret;
+  bool mapped, pinned;
+
+  /* The alignment trait is kept when falling back to another allocator,
+     as the caller relies on it no matter where the memory comes from.  */
+retry:
+  if (allocator == omp_null_allocator)
+    allocator = omp_get_default_allocator ();
+
+  if (allocator > omp_max_predefined_alloc)
+    {
+      allocator_data = (struct omp_allocator_data *) allocator;
+      if (allocator_data->alignment > alignment)
+	alignment = allocator_data->alignment;
+    }
+  else
+    allocator_data = NULL;
+
+  new_size = sizeof (struct omp_mem_header);
+  if (alignment > sizeof (void *))
+    new_size += alignment - sizeof (void *);
+  if (__builtin_add_overflow (size, new_size, &new_size))
+    goto fail;
+
+  if (allocator_data && allocator_data->pool_size < ~(omp_uintptr_t) 0)
+    {
+      omp_uintptr_t used_pool_size;
+      if (new_size > allocator_data->pool_size)
+	goto fail;
+      used_pool_size = __atomic_add_fetch (&allocator_data->used_pool_size,
+					   new_size, MEMMODEL_RELAXED);
+      if (used_pool_size > allocator_data->pool_size
+	  || used_pool_size < new_size)
+	{
+	  __atomic_add_fetch (&allocator_data->used_pool_size, -new_size,
+			      MEMMODEL_RELAXED);
+	  goto fail;
+	}
+    }
+
+  pinned = allocator_data && allocator_data->pinned;
+  mapped = (pinned
+	    || (allocator_data
+		&& (allocator_data->partition == omp_atv_nearest
+		    || allocator_data->partition == omp_atv_interleaved)));
+  if (mapped)
+    ptr = gomp_alloc_mapped (new_size, pinned, allocator_data->partition);
+  else
+    ptr = malloc (new_size);
+  if (ptr == NULL)
+    {
+      if (allocator_data && allocator_data->pool_size < ~(omp_uintptr_t) 0)
+	__atomic_add_fetch (&allocator_data->used_pool_size, -new_size,
+			    MEMMODEL_RELAXED);
+      goto fail;
+    }
+
+  if (alignment > sizeof (void *))
+    ret = (void *) (((uintptr_t) ptr + sizeof (struct omp_mem_header)
+		     + alignment - sizeof (void *)) & ~(alignment - 1));
+  else
+    ret = (char *) ptr + sizeof (struct omp_mem_header);
+  ((struct omp_mem_header *) ret)[-1].ptr = ptr;
+  ((struct omp_mem_header *) ret)[-1].size = new_size;
+  ((struct omp_mem_header *) ret)[-1].allocator = allocator;
+  ((struct omp_mem_header *) ret)[-1].mapped = mapped;
+  ((struct omp_mem_header *) ret)[-1].pinned = pinned;
+  return ret;
+
+fail:
+  if (allocator_data)
+    {
+      switch (allocator_data->fallback)
+	{
+	case omp_atv_default_mem_fb:
+	  allocator = omp_default_mem_alloc;
+	  goto retry;
+	case omp_atv_null_fb:
+	  break;
+	case omp_atv_allocator_fb:
+	  allocator = allocator_data->fb_data;
+	  goto retry;
+	default:
+	  gomp_fatal ("Out of memory allocating %lu bytes",
+		      (unsigned long) size);
+	}
+    }
+  return NULL;
+}
+
+ialias (omp_alloc)
+
+void
+omp_free (void *ptr, omp_allocator_handle_t allocator)
+{
+  struct omp_mem_header *data;
+
+  if (ptr == NULL)
+    return;
+  /* The header records the allocator the block came from, which is what
+     matters if ALLOCATOR was omp_null_allocator or a fallback was used.  */
+  (void) allocator;
+  data = &((struct omp_mem_header *) ptr)[-1];
+  if (data->allocator > omp_max_predefined_alloc)
+    {
+      struct omp_allocator_data *allocator_data
+	= (struct omp_allocator_data *) data->allocator;
+      if (allocator_data->pool_size < ~(omp_uintptr_t) 0)
+	__atomic_add_fetch (&allocator_data->used_pool_size, -data->size,
+			    MEMMODEL_RELAXED);
+    }
+  if (data->mapped)
+    gomp_free_mapped (data->ptr, data->size, data->pinned);
+  else
+    free (data->ptr);
+}
+
+ialias (omp_free)
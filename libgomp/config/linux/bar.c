@@ -30,6 +30,32 @@
 #include <limits.h>
 #include "wait.h"
 
+/* Like do_wait on BAR->generation, but account for the threads that
+   actually block in the kernel, so that the releasing thread can skip
+   the futex_wake syscall when all the waiters are still spinning.  */
+
+static inline void
+do_bar_wait (gomp_barrier_t *bar, int val)
+{
+  if (do_spin ((int *) &bar->generation, val))
+    {
+      __atomic_add_fetch (&bar->sleepers, 1, MEMMODEL_SEQ_CST);
+      futex_wait ((int *) &bar->generation, val);
+      __atomic_add_fetch (&bar->sleepers, -1, MEMMODEL_RELAXED);
+    }
+}
+
+/* Wake up to COUNT threads blocked on BAR->generation.  Must be called
+   after the store to BAR->generation the waiters are waiting for; the
+   fence pairs with the increment of BAR->sleepers in do_bar_wait.  */
+
+static inline void
+do_bar_wake (gomp_barrier_t *bar, int count)
+{
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  if (__atomic_load_n (&bar->sleepers, MEMMODEL_RELAXED))
+    futex_wake ((int *) &bar->generation, count);
+}
 
 void
 gomp_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
@@ -40,12 +66,12 @@ gomp_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
       bar->awaited = bar->total;
       __atomic_store_n (&bar->generation, bar->generation + BAR_INCR,
 			MEMMODEL_RELEASE);
-      futex_wake ((int *) &bar->generation, INT_MAX);
+      do_bar_wake (bar, INT_MAX);
     }
   else
     {
       do
-	do_wait ((int *) &bar->generation, state);
+	do_bar_wait (bar, state);
       while (__atomic_load_n (&bar->generation, MEMMODEL_ACQUIRE) == state);
     }
 }
@@ -74,7 +100,7 @@ gomp_barrier_wait_last (gomp_barrier_t *bar)
 void
 gomp_team_barrier_wake (gomp_barrier_t *bar, int count)
 {
-  futex_wake ((int *) &bar->generation, count == 0 ? INT_MAX : count);
+  do_bar_wake (bar, count == 0 ? INT_MAX : count);
 }
 
 void
@@ -100,7 +126,7 @@ gomp_team_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
 	  state &= ~BAR_CANCELLED;
 	  state += BAR_INCR - BAR_WAS_LAST;
 	  __atomic_store_n (&bar->generation, state, MEMMODEL_RELEASE);
-	  futex_wake ((int *) &bar->generation, INT_MAX);
+	  do_bar_wake (bar, INT_MAX);
 	  return;
 	}
     }
@@ -109,7 +135,7 @@ gomp_team_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
   state &= ~BAR_CANCELLED;
   do
     {
-      do_wait ((int *) &bar->generation, generation);
+      do_bar_wait (bar, generation);
       gen = __atomic_load_n (&bar->generation, MEMMODEL_ACQUIRE);
       if (__builtin_expect (gen & BAR_TASK_PENDING, 0))
 	{
@@ -163,7 +189,7 @@ gomp_team_barrier_wait_cancel_end (gomp_barrier_t *bar,
 	{
 	  state += BAR_INCR - BAR_WAS_LAST;
 	  __atomic_store_n (&bar->generation, state, MEMMODEL_RELEASE);
-	  futex_wake ((int *) &bar->generation, INT_MAX);
+	  do_bar_wake (bar, INT_MAX);
 	  return false;
 	}
     }
@@ -174,7 +200,7 @@ gomp_team_barrier_wait_cancel_end (gomp_barrier_t *bar,
   generation = state;
   do
     {
-      do_wait ((int *) &bar->generation, generation);
+      do_bar_wait (bar, generation);
       gen = __atomic_load_n (&bar->generation, MEMMODEL_ACQUIRE);
       if (__builtin_expect (gen & BAR_CANCELLED, 0))
 	return true;
@@ -207,5 +233,5 @@ gomp_team_barrier_cancel (struct gomp_team *team)
     }
   team->barrier.generation |= BAR_CANCELLED;
   gomp_mutex_unlock (&team->task_lock);
-  futex_wake ((int *) &team->barrier.generation, INT_MAX);
+  do_bar_wake (&team->barrier, INT_MAX);
 }
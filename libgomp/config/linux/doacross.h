@@ -30,24 +30,67 @@
 
 #include "libgomp.h"
 #include <errno.h>
+#include <limits.h>
 #include "wait.h"
 
 #ifdef HAVE_ATTRIBUTE_VISIBILITY
 # pragma GCC visibility push(hidden)
 #endif
 
+/* Flattened doacross entries are padded to a cache line.  The int
+   following the counter is non-zero while some thread might be waiting
+   for the counter to change in futex_wait.  */
+
+static inline int *
+doacross_futex (unsigned long *addr)
+{
+  return (int *) (addr + 1);
+}
+
+static inline void doacross_post (unsigned long *addr, unsigned long val)
+{
+  int *futex = doacross_futex (addr);
+
+  __atomic_store_n (addr, val, MEMMODEL_SEQ_CST);
+  if (__builtin_expect (__atomic_load_n (futex, MEMMODEL_SEQ_CST) != 0, 0))
+    {
+      __atomic_store_n (futex, 0, MEMMODEL_RELAXED);
+      futex_wake (futex, INT_MAX);
+    }
+}
+
 static inline void doacross_spin (unsigned long *addr, unsigned long expected,
 				  unsigned long cur)
 {
-  /* FIXME: back off depending on how large expected - cur is.  */
-  do
+  unsigned long long i, count = gomp_spin_count_var;
+  int *futex = doacross_futex (addr);
+
+  if (__builtin_expect (__atomic_load_n (&gomp_managed_threads,
+					 MEMMODEL_RELAXED)
+			> gomp_available_cpus, 0))
+    count = gomp_throttled_spin_count_var;
+  for (i = 0; i < count; i++)
     {
       cpu_relax ();
       cur = __atomic_load_n (addr, MEMMODEL_RELAXED);
       if (expected < cur)
 	return;
     }
-  while (1);
+
+  /* Spinning didn't help, sleep until the posting thread wakes us up.
+     The store to *FUTEX and the load of *ADDR pair with the store and
+     the load in doacross_post, so either this thread sees the new
+     counter or the posting thread sees the flag.  */
+  do
+    {
+      __atomic_store_n (futex, 1, MEMMODEL_SEQ_CST);
+      cur = __atomic_load_n (addr, MEMMODEL_SEQ_CST);
+      if (expected < cur)
+	return;
+      futex_wait (futex, 1);
+      cur = __atomic_load_n (addr, MEMMODEL_RELAXED);
+    }
+  while (expected >= cur);
 }
 
 #ifdef HAVE_ATTRIBUTE_VISIBILITY
@@ -0,0 +1,119 @@
+/* Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* Hardware transactional memory primitives used for lock elision of
+   speculative locks.  Without support for them, gomp_elision_supported
+   returns false and the other functions are never called.  */
+
+#ifndef GOMP_ELISION_H
+#define GOMP_ELISION_H 1
+
+/* Returned by gomp_xbegin when the transaction has started.  */
+#define GOMP_XBEGIN_STARTED	(~0u)
+/* Abort status bits: the transaction may succeed on a retry, and
+   the transaction was aborted by gomp_xabort_busy.  */
+#define GOMP_XABORT_RETRY	(1u << 1)
+#define GOMP_XABORT_BUSY	((1u << 0) | (0xffu << 24))
+
+#if defined __x86_64__ || defined __i386__
+#include <cpuid.h>
+
+/* The instructions are emitted as bytes, so that no assembler support
+   for RTM is needed.  */
+
+static inline bool
+gomp_elision_supported (void)
+{
+  unsigned int eax, ebx, ecx, edx;
+
+  if (__get_cpuid_max (0, NULL) < 7)
+    return false;
+  __cpuid_count (7, 0, eax, ebx, ecx, edx);
+  /* RTM.  */
+  return (ebx & (1u << 11)) != 0;
+}
+
+static inline unsigned int
+gomp_xbegin (void)
+{
+  unsigned int status = GOMP_XBEGIN_STARTED;
+  /* xbegin with the fallback address right after the instruction.  */
+  __asm volatile (".byte 0xc7, 0xf8, 0, 0, 0, 0"
+		  : "+a" (status) : : "memory");
+  return status;
+}
+
+static inline void
+gomp_xend (void)
+{
+  __asm volatile (".byte 0x0f, 0x01, 0xd5" : : : "memory");
+}
+
+static inline void
+gomp_xabort_busy (void)
+{
+  /* xabort $0xff.  */
+  __asm volatile (".byte 0xc6, 0xf8, 0xff" : : : "memory");
+}
+
+static inline bool
+gomp_xtest (void)
+{
+  unsigned char in_txn;
+  /* xtest; setnz.  */
+  __asm volatile (".byte 0x0f, 0x01, 0xd6\n\tsetnz %0"
+		  : "=q" (in_txn) : : "memory", "cc");
+  return in_txn;
+}
+#else
+static inline bool
+gomp_elision_supported (void)
+{
+  return false;
+}
+
+static inline unsigned int
+gomp_xbegin (void)
+{
+  return 0;
+}
+
+static inline void
+gomp_xend (void)
+{
+}
+
+static inline void
+gomp_xabort_busy (void)
+{
+}
+
+static inline bool
+gomp_xtest (void)
+{
+  return false;
+}
+#endif
+
+#endif /* GOMP_ELISION_H */
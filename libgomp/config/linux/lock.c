@@ -173,3 +173,6 @@ ialias (omp_test_lock)
 ialias (omp_test_nest_lock)
 
 #endif
+
+ialias (omp_init_lock_with_hint)
+ialias (omp_init_nest_lock_with_hint)
@@ -27,7 +27,9 @@
    mechanism for libgomp.  This type is private to the library.  This
    implementation uses atomic instructions and the futex syscall.  */
 
+#include <limits.h>
 #include "wait.h"
+#include "elision.h"
 
 int gomp_futex_wake = FUTEX_WAKE | FUTEX_PRIVATE_FLAG;
 int gomp_futex_wait = FUTEX_WAIT | FUTEX_PRIVATE_FLAG;
@@ -68,3 +70,215 @@ gomp_mutex_unlock_slow (gomp_mutex_t *mutex)
 {
   futex_wake (mutex, 1);
 }
+
+/* Hinted mutexes.  Bit 30 is set in all of their states, bit 31 in
+   none of them.  Speculative mutexes additionally have bit 29 set and
+   keep the state of a plain mutex in their low bits, 0 if unlocked,
+   1 if locked and 2 if locked with possible sleepers.  Queued mutexes
+   are ticket locks: bits 0 to 13 hold the ticket being served, bits 14
+   to 27 the next ticket to hand out and bit 28 is set when threads
+   might sleep in futex_wait.  */
+
+#define GOMP_MUTEX_HINTED	0x40000000
+#define GOMP_MUTEX_SPECULATIVE	(GOMP_MUTEX_HINTED | 0x20000000)
+#define GOMP_MUTEX_QUEUED	GOMP_MUTEX_HINTED
+#define GOMP_MUTEX_SLEEPERS	0x10000000
+#define GOMP_MUTEX_TICKET_BITS	14
+#define GOMP_MUTEX_TICKET_MASK	((1 << GOMP_MUTEX_TICKET_BITS) - 1)
+#define GOMP_MUTEX_NEXT_MASK	(GOMP_MUTEX_TICKET_MASK \
+				 << GOMP_MUTEX_TICKET_BITS)
+
+/* Number of attempts to run a critical section of a speculative mutex
+   as a transaction before really locking the mutex.  */
+#define GOMP_ELISION_RETRIES	3
+
+/* -1 until the first hinted mutex is initialized, then whether the
+   CPU supports lock elision.  */
+static int gomp_elision_ok = -1;
+
+static inline bool
+gomp_mutex_hinted_p (int val)
+{
+  return (val & (GOMP_MUTEX_HINTED | (1U << 31))) == GOMP_MUTEX_HINTED;
+}
+
+static inline int
+gomp_mutex_serving (int val)
+{
+  return val & GOMP_MUTEX_TICKET_MASK;
+}
+
+static inline int
+gomp_mutex_next (int val)
+{
+  return (val >> GOMP_MUTEX_TICKET_BITS) & GOMP_MUTEX_TICKET_MASK;
+}
+
+/* Return queued mutex state VAL with the next ticket handed out.  */
+
+static inline int
+gomp_mutex_take_ticket (int val)
+{
+  return (val & ~GOMP_MUTEX_NEXT_MASK)
+	 | ((val + (1 << GOMP_MUTEX_TICKET_BITS)) & GOMP_MUTEX_NEXT_MASK);
+}
+
+void
+gomp_mutex_init_hint (gomp_mutex_t *mutex, int hint)
+{
+  *mutex = 0;
+  if ((hint & omp_lock_hint_speculative)
+      && !(hint & omp_lock_hint_nonspeculative))
+    {
+      if (gomp_elision_ok < 0)
+	gomp_elision_ok = gomp_elision_supported ();
+      if (gomp_elision_ok)
+	{
+	  *mutex = GOMP_MUTEX_SPECULATIVE;
+	  return;
+	}
+    }
+  if ((hint & omp_lock_hint_contended)
+      && !(hint & omp_lock_hint_uncontended))
+    *mutex = GOMP_MUTEX_QUEUED;
+}
+
+/* Lock speculative MUTEX, first by trying to elide it.  */
+
+static void
+gomp_mutex_lock_speculative (gomp_mutex_t *mutex)
+{
+  int i, oldval;
+
+  for (i = 0; i < GOMP_ELISION_RETRIES; i++)
+    {
+      unsigned int status = gomp_xbegin ();
+      if (status == GOMP_XBEGIN_STARTED)
+	{
+	  /* Reading the mutex makes the transaction abort as soon as
+	     another thread really locks it.  */
+	  if (__atomic_load_n (mutex, MEMMODEL_RELAXED)
+	      == GOMP_MUTEX_SPECULATIVE)
+	    return;
+	  gomp_xabort_busy ();
+	}
+      /* Don't retry if the mutex is held or retrying is unlikely to
+	 help, e.g. because the critical section doesn't fit into the
+	 transactional buffers.  */
+      if ((status & GOMP_XABORT_BUSY) == GOMP_XABORT_BUSY
+	  || !(status & GOMP_XABORT_RETRY))
+	break;
+    }
+
+  oldval = GOMP_MUTEX_SPECULATIVE;
+  if (__atomic_compare_exchange_n (mutex, &oldval, GOMP_MUTEX_SPECULATIVE + 1,
+				   false, MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+    return;
+  while (__atomic_exchange_n (mutex, GOMP_MUTEX_SPECULATIVE + 2,
+			      MEMMODEL_ACQUIRE) != GOMP_MUTEX_SPECULATIVE)
+    do_wait (mutex, GOMP_MUTEX_SPECULATIVE + 2);
+}
+
+/* Lock queued MUTEX, whose state was OLDVAL, in FIFO order.  */
+
+static void
+gomp_mutex_lock_queued (gomp_mutex_t *mutex, int oldval)
+{
+  int ticket, newval;
+
+  do
+    newval = gomp_mutex_take_ticket (oldval);
+  while (!__atomic_compare_exchange_n (mutex, &oldval, newval, true,
+				       MEMMODEL_ACQUIRE, MEMMODEL_RELAXED));
+  ticket = gomp_mutex_next (oldval);
+
+  oldval = newval;
+  while (gomp_mutex_serving (oldval) != ticket)
+    {
+      if (!(oldval & GOMP_MUTEX_SLEEPERS))
+	{
+	  /* Every unlock and every new waiter changes the mutex, so
+	     spinning stops early; only sleep once nothing changes.  */
+	  if (!do_spin (mutex, oldval))
+	    {
+	      oldval = __atomic_load_n (mutex, MEMMODEL_ACQUIRE);
+	      continue;
+	    }
+	  if (!__atomic_compare_exchange_n (mutex, &oldval,
+					    oldval | GOMP_MUTEX_SLEEPERS,
+					    false, MEMMODEL_ACQUIRE,
+					    MEMMODEL_ACQUIRE))
+	    continue;
+	  oldval |= GOMP_MUTEX_SLEEPERS;
+	}
+      futex_wait (mutex, oldval);
+      oldval = __atomic_load_n (mutex, MEMMODEL_ACQUIRE);
+    }
+}
+
+void
+gomp_mutex_lock_hint_slow (gomp_mutex_t *mutex, int oldval)
+{
+  if (!gomp_mutex_hinted_p (oldval))
+    gomp_mutex_lock_slow (mutex, oldval);
+  else if ((oldval & GOMP_MUTEX_SPECULATIVE) == GOMP_MUTEX_SPECULATIVE)
+    gomp_mutex_lock_speculative (mutex);
+  else
+    gomp_mutex_lock_queued (mutex, oldval);
+}
+
+void
+gomp_mutex_unlock_hint_slow (gomp_mutex_t *mutex, int oldval)
+{
+  int newval;
+
+  if (!gomp_mutex_hinted_p (oldval))
+    {
+      /* A plain mutex with sleepers.  Waiters only ever store -1
+	 into it while it is locked.  */
+      __atomic_store_n (mutex, 0, MEMMODEL_RELEASE);
+      gomp_mutex_unlock_slow (mutex);
+    }
+  else if ((oldval & GOMP_MUTEX_SPECULATIVE) == GOMP_MUTEX_SPECULATIVE)
+    {
+      /* The mutex is seen unlocked only if this thread elided it.  */
+      if (oldval == GOMP_MUTEX_SPECULATIVE && gomp_xtest ())
+	gomp_xend ();
+      else if (__atomic_exchange_n (mutex, GOMP_MUTEX_SPECULATIVE,
+				    MEMMODEL_RELEASE)
+	       == GOMP_MUTEX_SPECULATIVE + 2)
+	futex_wake (mutex, 1);
+    }
+  else
+    {
+      do
+	newval = (oldval & ~(GOMP_MUTEX_TICKET_MASK | GOMP_MUTEX_SLEEPERS))
+		 | ((oldval + 1) & GOMP_MUTEX_TICKET_MASK);
+      while (!__atomic_compare_exchange_n (mutex, &oldval, newval, true,
+					   MEMMODEL_RELEASE,
+					   MEMMODEL_RELAXED));
+      /* Only the thread holding the next ticket can proceed, but there
+	 is no way to tell which of the sleepers that is.  */
+      if (oldval & GOMP_MUTEX_SLEEPERS)
+	futex_wake (mutex, INT_MAX);
+    }
+}
+
+int
+gomp_mutex_trylock_hint_slow (gomp_mutex_t *mutex, int oldval)
+{
+  if (!gomp_mutex_hinted_p (oldval))
+    return 0;
+  if ((oldval & GOMP_MUTEX_SPECULATIVE) == GOMP_MUTEX_SPECULATIVE)
+    {
+      oldval = GOMP_MUTEX_SPECULATIVE;
+      return __atomic_compare_exchange_n (mutex, &oldval,
+					  GOMP_MUTEX_SPECULATIVE + 1, false,
+					  MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
+    }
+  if (gomp_mutex_serving (oldval) != gomp_mutex_next (oldval))
+    return 0;
+  return __atomic_compare_exchange_n (mutex, &oldval,
+				      gomp_mutex_take_ticket (oldval), false,
+				      MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
+}
@@ -64,4 +64,46 @@ gomp_mutex_unlock (gomp_mutex_t *mutex)
   if (__builtin_expect (wait < 0, 0))
     gomp_mutex_unlock_slow (mutex);
 }
+
+/* Mutexes initialized by gomp_mutex_init_hint with an OpenMP lock hint
+   may be queued or speculative locks instead.  Those keep their kind in
+   the upper bits of the mutex, so their states never compare equal to
+   the 0, 1 and -1 states of plain mutexes, which is what sends them
+   into the out of line functions.  The gomp_mutex_*_hint functions
+   below handle both plain and hinted mutexes.  */
+
+#define GOMP_MUTEX_HINTS 1
+
+extern void gomp_mutex_init_hint (gomp_mutex_t *mutex, int hint);
+extern void gomp_mutex_lock_hint_slow (gomp_mutex_t *mutex, int);
+extern void gomp_mutex_unlock_hint_slow (gomp_mutex_t *mutex, int);
+extern int gomp_mutex_trylock_hint_slow (gomp_mutex_t *mutex, int);
+
+static inline void
+gomp_mutex_lock_hint (gomp_mutex_t *mutex)
+{
+  int oldval = 0;
+  if (!__atomic_compare_exchange_n (mutex, &oldval, 1, false,
+				    MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+    gomp_mutex_lock_hint_slow (mutex, oldval);
+}
+
+static inline void
+gomp_mutex_unlock_hint (gomp_mutex_t *mutex)
+{
+  int oldval = 1;
+  if (!__atomic_compare_exchange_n (mutex, &oldval, 0, false,
+				    MEMMODEL_RELEASE, MEMMODEL_RELAXED))
+    gomp_mutex_unlock_hint_slow (mutex, oldval);
+}
+
+static inline int
+gomp_mutex_trylock_hint (gomp_mutex_t *mutex)
+{
+  int oldval = 0;
+  if (__atomic_compare_exchange_n (mutex, &oldval, 1, false,
+				   MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+    return 1;
+  return gomp_mutex_trylock_hint_slow (mutex, oldval);
+}
 #endif /* GOMP_MUTEX_H */
@@ -45,19 +45,53 @@ extern int gomp_futex_wait, gomp_futex_wake;
 
 #include <futex.h>
 
+/* Bounds for the self-tuned spin budget used when neither GOMP_SPINCOUNT
+   nor OMP_WAIT_POLICY has been set.  Every GOMP_SPIN_PROBE_MASK + 1 waits
+   the full gomp_spin_count_var is spun again, so that a thread whose
+   budget shrank during a period of long waits can grow it back.  */
+#define GOMP_SPIN_BUDGET_MIN	1000ULL
+#define GOMP_SPIN_PROBE_MASK	15
+
 static inline int do_spin (int *addr, int val)
 {
   unsigned long long i, count = gomp_spin_count_var;
+  struct gomp_thread *thr = NULL;
 
   if (__builtin_expect (__atomic_load_n (&gomp_managed_threads,
                                          MEMMODEL_RELAXED)
                         > gomp_available_cpus, 0))
     count = gomp_throttled_spin_count_var;
+  else if (gomp_spin_count_adaptive && (thr = gomp_thread ()) != NULL)
+    {
+      if (thr->spin_budget && (++thr->spin_waits & GOMP_SPIN_PROBE_MASK))
+	count = thr->spin_budget;
+    }
   for (i = 0; i < count; i++)
     if (__builtin_expect (__atomic_load_n (addr, MEMMODEL_RELAXED) != val, 0))
-      return 0;
+      {
+	/* The wait was satisfied by spinning; allow twice as much next
+	   time so that similar waits keep avoiding the futex.  */
+	if (thr)
+	  {
+	    unsigned long long budget = 2 * i;
+	    if (budget < GOMP_SPIN_BUDGET_MIN)
+	      budget = GOMP_SPIN_BUDGET_MIN;
+	    else if (budget > gomp_spin_count_var)
+	      budget = gomp_spin_count_var;
+	    thr->spin_budget = budget;
+	  }
+	return 0;
+      }
     else
       cpu_relax ();
+  /* Spinning was wasted, the caller is going to block.  */
+  if (thr)
+    {
+      unsigned long long budget = count / 2;
+      if (budget < GOMP_SPIN_BUDGET_MIN)
+	budget = GOMP_SPIN_BUDGET_MIN;
+      thr->spin_budget = budget;
+    }
   return 1;
 }
 
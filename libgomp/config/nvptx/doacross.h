@@ -44,6 +44,11 @@ cpu_relax (void)
   return r;
 }
 
+static inline void doacross_post (unsigned long *addr, unsigned long val)
+{
+  __atomic_store_n (addr, val, MEMMODEL_RELEASE);
+}
+
 static inline void doacross_spin (unsigned long *addr, unsigned long expected,
 				  unsigned long cur)
 {
@@ -39,3 +39,5 @@ ialias (omp_unset_lock)
 ialias (omp_unset_nest_lock)
 ialias (omp_test_lock)
 ialias (omp_test_nest_lock)
+ialias (omp_init_lock_with_hint)
+ialias (omp_init_nest_lock_with_hint)
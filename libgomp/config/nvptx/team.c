@@ -68,6 +68,7 @@ gomp_nvptx_main (void (*fn) (void *), void *fn_data)
       pool->threads_used = ntids;
       pool->threads_busy = 1;
       pool->last_team = NULL;
+      memset (pool->team_cache, 0, sizeof (pool->team_cache));
       gomp_simple_barrier_init (&pool->threads_dock, ntids);
 
       nvptx_thrs[0].thread_pool = pool;
@@ -41,6 +41,11 @@ cpu_relax (void)
   __asm volatile ("" : : : "memory");
 }
 
+static inline void doacross_post (unsigned long *addr, unsigned long val)
+{
+  __atomic_store_n (addr, val, MEMMODEL_RELEASE);
+}
+
 static inline void doacross_spin (unsigned long *addr, unsigned long expected,
 				  unsigned long cur)
 {
@@ -207,6 +207,22 @@ gomp_test_nest_lock_30 (omp_nest_lock_t *lock)
 }
 #endif
 
+/* Lock hints are only hints, so they are ignored.  */
+
+void
+omp_init_lock_with_hint (omp_lock_t *lock,
+			 omp_lock_hint_t hint __attribute__((unused)))
+{
+  gomp_init_lock_30 (lock);
+}
+
+void
+omp_init_nest_lock_with_hint (omp_nest_lock_t *lock,
+			      omp_lock_hint_t hint __attribute__((unused)))
+{
+  gomp_init_nest_lock_30 (lock);
+}
+
 #ifdef LIBGOMP_GNU_SYMBOL_VERSIONING
 void
 gomp_init_lock_25 (omp_lock_25_t *lock)
@@ -303,3 +319,6 @@ ialias (omp_test_lock)
 ialias (omp_test_nest_lock)
 
 #endif
+
+ialias (omp_init_lock_with_hint)
+ialias (omp_init_nest_lock_with_hint)
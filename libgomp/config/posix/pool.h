@@ -30,6 +30,7 @@
 #define GOMP_POOL_H 1
 
 #include "libgomp.h"
+#include <string.h>
 
 /* Get the thread pool, allocate and initialize it on demand.  */
 
@@ -44,6 +45,7 @@ gomp_get_thread_pool (struct gomp_thread *thr, unsigned nthreads)
       pool->threads_size = 0;
       pool->threads_used = 0;
       pool->last_team = NULL;
+      memset (pool->team_cache, 0, sizeof (pool->team_cache));
       pool->threads_busy = nthreads;
       thr->thread_pool = pool;
       pthread_setspecific (gomp_thread_destructor, thr);
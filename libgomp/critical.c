@@ -31,18 +31,30 @@
 
 static gomp_mutex_t default_lock;
 
+/* Make the lock of unnamed critical regions behave as if initialized
+   with lock hint HINT.  Called by initialize_env, before any critical
+   region can be entered.  */
+
+void
+gomp_critical_init_hint (int hint __attribute__((unused)))
+{
+#ifdef GOMP_MUTEX_HINTS
+  gomp_mutex_init_hint (&default_lock, hint);
+#endif
+}
+
 void
 GOMP_critical_start (void)
 {
   /* There is an implicit flush on entry to a critical region. */
   __atomic_thread_fence (MEMMODEL_RELEASE);
-  gomp_mutex_lock (&default_lock);
+  gomp_mutex_lock_hint (&default_lock);
 }
 
 void
 GOMP_critical_end (void)
 {
-  gomp_mutex_unlock (&default_lock);
+  gomp_mutex_unlock_hint (&default_lock);
 }
 
 #ifndef HAVE_SYNC_BUILTINS
@@ -63,6 +63,7 @@ struct gomp_task_icv gomp_global_icv = {
   .run_sched_var = GFS_DYNAMIC,
   .run_sched_chunk_size = 1,
   .default_device_var = 0,
+  .default_allocator_var = omp_default_mem_alloc,
   .dyn_var = false,
   .nest_var = false,
   .bind_var = omp_proc_bind_false,
@@ -77,6 +78,8 @@ gomp_mutex_t gomp_managed_threads_lock;
 #endif
 unsigned long gomp_available_cpus = 1, gomp_managed_threads = 1;
 unsigned long long gomp_spin_count_var, gomp_throttled_spin_count_var;
+bool gomp_spin_count_adaptive;
+unsigned long gomp_hot_teams_idle = 1000;
 unsigned long *gomp_nthreads_var_list, gomp_nthreads_var_list_len;
 char *gomp_bind_var_list;
 unsigned long gomp_bind_var_list_len;
@@ -888,6 +891,59 @@ parse_boolean (const char *name, bool *value)
     gomp_error ("Invalid value for environment variable %s", name);
 }
 
+/* Parse a comma separated list of OpenMP lock hints, without their
+   omp_lock_hint_ prefix, for environment variable NAME and store their
+   combination in PVALUE.  Return true if one was present and it was
+   successfully parsed.  */
+
+static bool
+parse_lock_hint (const char *name, int *pvalue)
+{
+  static const struct { const char *name; int hint; } hints[] = {
+    { "none", omp_lock_hint_none },
+    { "uncontended", omp_lock_hint_uncontended },
+    { "contended", omp_lock_hint_contended },
+    { "nonspeculative", omp_lock_hint_nonspeculative },
+    { "speculative", omp_lock_hint_speculative }
+  };
+  const char *env;
+  int value = 0;
+  size_t i, len;
+
+  env = getenv (name);
+  if (env == NULL)
+    return false;
+
+  do
+    {
+      while (isspace ((unsigned char) *env))
+	++env;
+      for (i = 0; i < sizeof (hints) / sizeof (hints[0]); i++)
+	{
+	  len = strlen (hints[i].name);
+	  if (strncasecmp (env, hints[i].name, len) == 0
+	      && !isalpha ((unsigned char) env[len]))
+	    break;
+	}
+      if (i == sizeof (hints) / sizeof (hints[0]))
+	goto invalid;
+      value |= hints[i].hint;
+      env += len;
+      while (isspace ((unsigned char) *env))
+	++env;
+    }
+  while (*env++ == ',');
+  if (env[-1] != '\0')
+    goto invalid;
+
+  *pvalue = value;
+  return true;
+
+ invalid:
+  gomp_error ("Invalid value for environment variable %s", name);
+  return false;
+}
+
 /* Parse the OMP_WAIT_POLICY environment variable and store the
    result in gomp_active_wait_policy.  */
 
@@ -1178,6 +1234,8 @@ handle_omp_display_env (unsigned long stacksize, int wait_policy)
       fprintf (stderr, "  GOMP_SPINCOUNT = '%lu'\n",
 	       (unsigned long) gomp_spin_count_var);
 #endif
+      fprintf (stderr, "  GOMP_HOT_TEAMS_IDLE = '%lu'\n",
+	       gomp_hot_teams_idle);
     }
 
   fputs ("OPENMP DISPLAY ENVIRONMENT END\n", stderr);
@@ -1188,7 +1246,7 @@ static void __attribute__((constructor))
 initialize_env (void)
 {
   unsigned long thread_limit_var, stacksize;
-  int wait_policy;
+  int wait_policy, critical_hint;
 
   /* Do a compile time check that mkomp_h.pl did good job.  */
   omp_check_defines ();
@@ -1258,7 +1316,12 @@ initialize_env (void)
       if (wait_policy > 0)
 	gomp_spin_count_var = 30000000000LL;
       else if (wait_policy < 0)
-	gomp_spin_count_var = 300000LL;
+	{
+	  gomp_spin_count_var = 300000LL;
+	  /* Without any explicit request, let each thread tune how long
+	     it spins below this limit based on how its waits end.  */
+	  gomp_spin_count_adaptive = true;
+	}
     }
   /* gomp_throttled_spin_count_var is used when there are more libgomp
      managed threads than available CPUs.  Use very short spinning.  */
@@ -1268,6 +1331,9 @@ initialize_env (void)
     gomp_throttled_spin_count_var = 100LL;
   if (gomp_throttled_spin_count_var > gomp_spin_count_var)
     gomp_throttled_spin_count_var = gomp_spin_count_var;
+  parse_unsigned_long ("GOMP_HOT_TEAMS_IDLE", &gomp_hot_teams_idle, true);
+  if (parse_lock_hint ("GOMP_CRITICAL_HINT", &critical_hint))
+    gomp_critical_init_hint (critical_hint);
 
   /* Not strictly environment related, but ordering constructors is tricky.  */
   pthread_attr_init (&gomp_thread_attr);
@@ -1306,5 +1372,7 @@ initialize_env (void)
   parse_acc_device_type ();
 
   goacc_runtime_initialize ();
+
+  gomp_ompt_init ();
 }
 #endif /* LIBGOMP_OFFLOADED_ONLY */
@@ -44,6 +44,8 @@ ialias_redirect (omp_unset_nest_lock)
 ialias_redirect (omp_test_lock)
 ialias_redirect (omp_test_nest_lock)
 # endif
+ialias_redirect (omp_init_lock_with_hint)
+ialias_redirect (omp_init_nest_lock_with_hint)
 ialias_redirect (omp_set_dynamic)
 ialias_redirect (omp_set_nested)
 ialias_redirect (omp_set_num_threads)
@@ -171,6 +173,24 @@ gomp_test_nest_lock__30 (omp_nest_lock_arg_t lock)
   return gomp_test_nest_lock_30 (omp_nest_lock_arg (lock));
 }
 
+void
+omp_init_lock_with_hint_ (omp_lock_arg_t lock, const int32_t *hint)
+{
+#ifndef OMP_LOCK_DIRECT
+  omp_lock_arg (lock) = malloc (sizeof (omp_lock_t));
+#endif
+  omp_init_lock_with_hint (omp_lock_arg (lock), *hint);
+}
+
+void
+omp_init_nest_lock_with_hint_ (omp_nest_lock_arg_t lock, const int32_t *hint)
+{
+#ifndef OMP_NEST_LOCK_DIRECT
+  omp_nest_lock_arg (lock) = malloc (sizeof (omp_nest_lock_t));
+#endif
+  omp_init_nest_lock_with_hint (omp_nest_lock_arg (lock), *hint);
+}
+
 #ifdef LIBGOMP_GNU_SYMBOL_VERSIONING
 void
 gomp_init_lock__25 (omp_lock_25_arg_t lock)
@@ -253,6 +253,136 @@ gomp_iter_dynamic_next (long *pstart, long *pend)
 #endif /* HAVE_SYNC_BUILTINS */
 
 
+/* Set up WS for a nonmonotonic dynamic loop of COUNT iterations handed
+   out CHUNK_SIZE at a time to NTHREADS threads.  Each thread starts with
+   a contiguous 1/NTHREADS share of the iteration space.  */
+
+void
+gomp_iter_steal_init (struct gomp_work_share *ws, unsigned long long count,
+		      unsigned long long chunk_size, unsigned nthreads)
+{
+  struct gomp_steal_work_share *steal;
+  unsigned long long q, t, lo;
+  unsigned i;
+
+  steal = gomp_malloc (sizeof (*steal) + 63
+		       + nthreads * sizeof (struct gomp_steal_range));
+  steal->count = count;
+  steal->chunk_size = chunk_size ? chunk_size : 1;
+  steal->nthreads = nthreads;
+  steal->ranges = (struct gomp_steal_range *)
+		  ((((uintptr_t) (steal + 1)) + 63) & ~(uintptr_t) 63);
+
+  q = count / nthreads;
+  t = count % nthreads;
+  lo = 0;
+  for (i = 0; i < nthreads; i++)
+    {
+      struct gomp_steal_range *r = &steal->ranges[i];
+      gomp_mutex_init (&r->lock);
+      r->got_last = false;
+      r->next = lo;
+      lo += q + (i < t);
+      r->end = lo;
+    }
+  ws->steal = steal;
+}
+
+/* Hand out the next chunk of a nonmonotonic dynamic loop to the calling
+   thread, as iteration numbers *PSTART <= x < *PEND.  The chunk comes
+   from this thread's own range if it has anything left, otherwise from
+   the back half of the range of another thread.  Return false when all
+   the iterations have been handed out, or once this thread got the last
+   one.  Only one range lock is ever held at a time.  */
+
+bool
+gomp_iter_steal_next (unsigned long long *pstart, unsigned long long *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_steal_work_share *steal = thr->ts.work_share->steal;
+  unsigned long long chunk = steal->chunk_size;
+  unsigned nthreads = steal->nthreads;
+  unsigned id = thr->ts.team_id % nthreads;
+  struct gomp_steal_range *self = &steal->ranges[id];
+  unsigned long long lo = 0, hi = 0;
+  unsigned i;
+
+  if (self->got_last)
+    return false;
+
+  gomp_mutex_lock (&self->lock);
+  if (self->next == self->end)
+    {
+      gomp_mutex_unlock (&self->lock);
+      for (i = 1; i < nthreads; i++)
+	{
+	  struct gomp_steal_range *victim
+	    = &steal->ranges[(id + i) % nthreads];
+	  unsigned long long left;
+
+	  /* Peek without the lock first, so that idle threads don't
+	     keep bouncing the locks of ranges that are already empty.
+	     A range never grows once it is empty except by its owner
+	     stealing, so a stale read here only skips work that the
+	     owner is about to do itself.  */
+	  if (victim->next == victim->end)
+	    continue;
+	  gomp_mutex_lock (&victim->lock);
+	  left = victim->end - victim->next;
+	  if (left)
+	    {
+	      hi = victim->end;
+	      lo = hi - (left > chunk ? (left + 1) / 2 : left);
+	      victim->end = lo;
+	    }
+	  gomp_mutex_unlock (&victim->lock);
+	  if (lo != hi)
+	    break;
+	}
+      if (lo == hi)
+	return false;
+
+      gomp_mutex_lock (&self->lock);
+      self->next = lo;
+      self->end = hi;
+    }
+
+  lo = self->next;
+  hi = self->end - lo > chunk ? lo + chunk : self->end;
+  self->next = hi;
+  gomp_mutex_unlock (&self->lock);
+
+  if (hi == steal->count)
+    self->got_last = true;
+  *pstart = lo;
+  *pend = hi;
+  return true;
+}
+
+/* The nonmonotonic dynamic schedule for long loops.  Translate the
+   iteration numbers from gomp_iter_steal_next back to loop values;
+   ws->next holds the loop start, as ws->next is not otherwise used
+   by this schedule.  */
+
+bool
+gomp_iter_nonmonotonic_dynamic_next (long *pstart, long *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_work_share *ws = thr->ts.work_share;
+  unsigned long long lo, hi;
+
+  if (!gomp_iter_steal_next (&lo, &hi))
+    return false;
+
+  *pstart = (unsigned long) ws->next + lo * (unsigned long) ws->incr;
+  if (hi == ws->steal->count)
+    *pend = ws->end;
+  else
+    *pend = (unsigned long) ws->next + hi * (unsigned long) ws->incr;
+  return true;
+}
+
+
 /* This function implements the GUIDED scheduling method.  Arguments are
    as for gomp_iter_static_next.  This function must be called with the
    work share lock held.  */
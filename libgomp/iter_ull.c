@@ -254,6 +254,28 @@ gomp_iter_ull_dynamic_next (gomp_ull *pstart, gomp_ull *pend)
 #endif /* HAVE_SYNC_BUILTINS */
 
 
+/* The nonmonotonic dynamic schedule for unsigned long long loops; see
+   gomp_iter_nonmonotonic_dynamic_next.  */
+
+bool
+gomp_iter_ull_nonmonotonic_dynamic_next (gomp_ull *pstart, gomp_ull *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_work_share *ws = thr->ts.work_share;
+  gomp_ull lo, hi;
+
+  if (!gomp_iter_steal_next (&lo, &hi))
+    return false;
+
+  *pstart = ws->next_ull + lo * ws->incr_ull;
+  if (hi == ws->steal->count)
+    *pend = ws->end_ull;
+  else
+    *pend = ws->next_ull + hi * ws->incr_ull;
+  return true;
+}
+
+
 /* This function implements the GUIDED scheduling method.  Arguments are
    as for gomp_iter_ull_static_next.  This function must be called with the
    work share lock held.  */
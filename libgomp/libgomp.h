@@ -44,6 +44,7 @@
 #include "config.h"
 #include "gstdint.h"
 #include "libgomp-plugin.h"
+#include "omp-tools.h"
 
 #ifdef HAVE_PTHREAD_H
 #include <pthread.h>
@@ -88,6 +89,9 @@ enum memmodel
 extern void *gomp_malloc (size_t) __attribute__((malloc));
 extern void *gomp_malloc_cleared (size_t) __attribute__((malloc));
 extern void *gomp_realloc (void *, size_t);
+extern void *gomp_aligned_alloc (size_t, size_t)
+  __attribute__((malloc, alloc_size (2)));
+extern void gomp_aligned_free (void *);
 
 /* Avoid conflicting prototypes of alloca() in system headers by using
    GCC's builtin alloca().  */
@@ -123,6 +127,12 @@ struct htab;
 #include "priority_queue.h"
 #include "sem.h"
 #include "mutex.h"
+#ifndef GOMP_MUTEX_HINTS
+/* Without support for OpenMP lock hints, hinted mutexes are plain ones.  */
+# define gomp_mutex_init_hint(MUTEX, HINT) gomp_mutex_init (MUTEX)
+# define gomp_mutex_lock_hint gomp_mutex_lock
+# define gomp_mutex_unlock_hint gomp_mutex_unlock
+#endif
 #include "bar.h"
 #include "simple-bar.h"
 #include "ptrlock.h"
@@ -178,6 +188,34 @@ struct gomp_doacross_work_share
   unsigned int shift_counts[];
 };
 
+/* The iterations of a nonmonotonic dynamic loop not yet handed out to
+   one of the threads.  Iterations are numbered from 0; this thread
+   takes chunks from the front of [NEXT, END), other threads that ran
+   out of work steal its back half.  */
+
+struct gomp_steal_range
+{
+  gomp_mutex_t lock;
+  /* Set once this thread has been handed the last iteration of the loop.
+     The code emitted for lastprivate and linear clauses expects that to
+     be the last chunk the thread gets, so it may not steal anymore.  */
+  bool got_last;
+  unsigned long long next;
+  unsigned long long end;
+} __attribute__((aligned (64)));
+
+struct gomp_steal_work_share
+{
+  /* Number of iterations in the whole loop.  */
+  unsigned long long count;
+  /* chunk_size copy, in iterations rather than multiplied by incr.  */
+  unsigned long long chunk_size;
+  /* Number of entries in RANGES.  */
+  unsigned nthreads;
+  /* Per-thread ranges indexed by team_id, aligned to cache line size.  */
+  struct gomp_steal_range *ranges;
+};
+
 struct gomp_work_share
 {
   /* This member records the SCHEDULE clause to be used for this construct.
@@ -220,6 +258,10 @@ struct gomp_work_share
 
     /* This is a pointer to DOACROSS work share data.  */
     struct gomp_doacross_work_share *doacross;
+
+    /* This is a pointer to the per-thread ranges of a nonmonotonic
+       dynamic loop.  */
+    struct gomp_steal_work_share *steal;
   };
 
   /* This is the number of threads that have registered themselves in
@@ -342,6 +384,7 @@ struct gomp_task_icv
   int run_sched_chunk_size;
   int default_device_var;
   unsigned int thread_limit_var;
+  uintptr_t default_allocator_var;
   bool dyn_var;
   bool nest_var;
   char bind_var;
@@ -357,6 +400,8 @@ extern unsigned long gomp_max_active_levels_var;
 extern bool gomp_cancel_var;
 extern int gomp_max_task_priority_var;
 extern unsigned long long gomp_spin_count_var, gomp_throttled_spin_count_var;
+extern bool gomp_spin_count_adaptive;
+extern unsigned long gomp_hot_teams_idle;
 extern unsigned long gomp_available_cpus, gomp_managed_threads;
 extern unsigned long *gomp_nthreads_var_list, gomp_nthreads_var_list_len;
 extern char *gomp_bind_var_list;
@@ -457,6 +502,8 @@ struct gomp_task
      block further execution of their parent until the dependencies
      are satisfied.  */
   bool parent_depends_on;
+  /* Data a tool attached to this task through the OMPT interface.  */
+  ompt_data_t ompt_data;
   /* Dependencies provided and/or needed for this task.  DEPEND_COUNT
      is the number of items available.  */
   struct gomp_task_depend_entry depend[];
@@ -473,6 +520,9 @@ struct gomp_taskgroup
   bool cancelled;
   gomp_sem_t taskgroup_sem;
   size_t num_children;
+  /* Task reductions registered for this taskgroup or inherited from
+     the enclosing one, see GOMP_taskgroup_reduction_register.  */
+  uintptr_t *reductions;
 };
 
 /* Various state of OpenMP async offloading tasks.  */
@@ -522,6 +572,19 @@ struct gomp_team
      the current thread was created.  */
   struct gomp_team_state prev_ts;
 
+  /* Data a tool attached to this parallel region through OMPT.  */
+  ompt_data_t ompt_parallel_data;
+
+  /* True if an OMPT tool was active when the team was created.  The
+     threads of such a team then wait for each other once more after
+     reporting the end of their implicit tasks, so that the team isn't
+     reused while they are still reporting.  */
+  bool ompt_enabled;
+
+  /* True if the threads of this nested team come from the pool of hot
+     threads of its master thread.  */
+  bool hot;
+
   /* This semaphore should be used by the master thread instead of its
      "native" semaphore in the thread structure.  Required for nested
      parallels, as the master is a member of two teams.  */
@@ -613,9 +676,34 @@ struct gomp_thread
 
   /* User pthread thread pool */
   struct gomp_thread_pool *thread_pool;
+
+  /* Self-tuned spin count for futex waits, zero until the first wait
+     finishes, and the number of waits used to schedule full-length
+     probes.  Only used if gomp_spin_count_adaptive.  */
+  unsigned long long spin_budget;
+  unsigned int spin_waits;
+
+  /* Data a tool attached to this thread through OMPT, and to the initial
+     task while thr->task is NULL.  */
+  ompt_data_t ompt_thread_data;
+  ompt_data_t ompt_initial_task_data;
+
+  /* Task reductions registered by orphaned taskgroups, which don't have
+     a struct gomp_taskgroup.  */
+  uintptr_t *task_reductions;
+
+  /* Pool of idle threads kept for the nested teams this thread is the
+     master of, or NULL.  It is only used for teams encountered at nesting
+     level NESTED_POOL_LEVEL, as the threads of a pool can't be members
+     of two teams at a time.  */
+  struct gomp_thread_pool *nested_pool;
+  unsigned nested_pool_level;
 };
 
 
+/* Number of ended teams besides the last one a thread pool keeps.  */
+#define GOMP_TEAM_CACHE_SIZE 3
+
 struct gomp_thread_pool
 {
   /* This array manages threads spawned from the top level, which will
@@ -627,8 +715,14 @@ struct gomp_thread_pool
      make sure all the threads in the team move on to the pool's barrier before
      the team's barrier is destroyed.  */
   struct gomp_team *last_team;
+  /* Teams that ended before the last one, kept to be reused by teams of
+     the same size.  The least recently ended one comes first.  */
+  struct gomp_team *team_cache[GOMP_TEAM_CACHE_SIZE];
   /* Number of threads running in this contention group.  */
   unsigned long threads_busy;
+  /* For a pool of threads of nested teams, omp_get_wtime when it was
+     last used.  */
+  double last_used;
 
   /* This barrier holds and releases threads waiting in thread pools.  */
   gomp_simple_barrier_t threads_dock;
@@ -710,6 +804,50 @@ extern bool gomp_affinity_init_level (int, unsigned long, bool);
 extern void gomp_affinity_print_place (void *);
 extern void gomp_get_place_proc_ids_8 (int, int64_t *);
 
+/* ompt.c */
+
+#define GOMP_OMPT_CALLBACKS	(ompt_callback_dispatch + 1)
+
+/* ompt_callback_sync_region_wait shares the signature of
+   ompt_callback_sync_region.  */
+typedef ompt_callback_sync_region_t ompt_callback_sync_region_wait_t;
+
+extern bool gomp_ompt_enabled;
+extern ompt_callback_t gomp_ompt_callbacks[GOMP_OMPT_CALLBACKS];
+extern void gomp_ompt_init (void);
+extern ompt_id_t gomp_ompt_next_op_id (void);
+
+/* Return the OMPT callback for ompt_callback_NAME if a tool registered
+   one, NULL otherwise.  Without a tool this is a single well predicted
+   load and branch.  */
+#define gomp_ompt_callback(name) \
+  (__builtin_expect (gomp_ompt_enabled, 0)				\
+   ? (ompt_callback_##name##_t) gomp_ompt_callbacks[ompt_callback_##name] \
+   : (ompt_callback_##name##_t) NULL)
+
+/* Return the OMPT data of the current task of THR.  */
+
+static inline ompt_data_t *
+gomp_ompt_task_data (struct gomp_thread *thr)
+{
+  return thr->task ? &thr->task->ompt_data : &thr->ompt_initial_task_data;
+}
+
+/* Report THR beginning or ending to wait in a synchronization region
+   of KIND to an OMPT tool.  */
+
+static inline void
+gomp_ompt_sync_region_wait (struct gomp_thread *thr, ompt_sync_region_t kind,
+			    ompt_scope_endpoint_t endpoint)
+{
+  ompt_callback_sync_region_wait_t sync_region_wait
+    = gomp_ompt_callback (sync_region_wait);
+  if (sync_region_wait)
+    sync_region_wait (kind, endpoint,
+		      thr->ts.team ? &thr->ts.team->ompt_parallel_data : NULL,
+		      gomp_ompt_task_data (thr), NULL);
+}
+
 /* iter.c */
 
 extern int gomp_iter_static_next (long *, long *);
@@ -720,6 +858,12 @@ extern bool gomp_iter_guided_next_locked (long *, long *);
 extern bool gomp_iter_dynamic_next (long *, long *);
 extern bool gomp_iter_guided_next (long *, long *);
 #endif
+extern void gomp_iter_steal_init (struct gomp_work_share *,
+				  unsigned long long, unsigned long long,
+				  unsigned);
+extern bool gomp_iter_steal_next (unsigned long long *,
+				  unsigned long long *);
+extern bool gomp_iter_nonmonotonic_dynamic_next (long *, long *);
 
 /* iter_ull.c */
 
@@ -736,6 +880,12 @@ extern bool gomp_iter_ull_dynamic_next (unsigned long long *,
 extern bool gomp_iter_ull_guided_next (unsigned long long *,
 				       unsigned long long *);
 #endif
+extern bool gomp_iter_ull_nonmonotonic_dynamic_next (unsigned long long *,
+						     unsigned long long *);
+
+/* critical.c */
+
+extern void gomp_critical_init_hint (int);
 
 /* ordered.c */
 
@@ -918,6 +1068,34 @@ enum gomp_device_state
   GOMP_DEVICE_FINALIZED
 };
 
+/* Number of size classes and of live block hash buckets in
+   struct gomp_device_mem_cache.  */
+#define GOMP_DEVICE_MEM_CLASSES	73
+#define GOMP_DEVICE_MEM_HASH	256
+
+/* A block of device memory handed out by gomp_device_alloc.  */
+struct gomp_device_mem_block
+{
+  void *ptr;
+  /* Size rounded up to its size class.  */
+  size_t size;
+  struct gomp_device_mem_block *next;
+};
+
+/* Cache of device memory blocks released by gomp_device_free, see
+   target.c.  */
+struct gomp_device_mem_cache
+{
+  /* Cacheable blocks currently in use, hashed by device address.  */
+  struct gomp_device_mem_block *live[GOMP_DEVICE_MEM_HASH];
+  /* Released blocks available for reuse, by size class.  */
+  struct gomp_device_mem_block *free_list[GOMP_DEVICE_MEM_CLASSES];
+  /* Unused block descriptors.  */
+  struct gomp_device_mem_block *spare;
+  /* Total size of the blocks on the free lists.  */
+  size_t cached_bytes;
+};
+
 /* This structure describes accelerator device.
    It contains name of the corresponding libgomp plugin, function handlers for
    interaction with the device, ID-number of the device, and information about
@@ -961,6 +1139,9 @@ struct gomp_device_descr
   /* Splay tree containing information about mapped memory regions.  */
   struct splay_tree_s mem_map;
 
+  /* Device memory released by libgomp and kept for reuse.  */
+  struct gomp_device_mem_cache mem_cache;
+
   /* Mutex for the mutable data.  */
   gomp_mutex_t lock;
 
@@ -992,6 +1173,9 @@ extern struct target_mem_desc *gomp_map_vars (struct gomp_device_descr *,
 					      size_t *, void *, bool,
 					      enum gomp_map_vars_kind);
 extern void gomp_unmap_vars (struct target_mem_desc *, bool);
+extern void *gomp_device_alloc (struct gomp_device_descr *, size_t);
+extern bool gomp_device_free (struct gomp_device_descr *, void *);
+extern void gomp_device_mem_cache_fini (struct gomp_device_descr *);
 extern void gomp_init_device (struct gomp_device_descr *);
 extern void gomp_free_memmap (struct splay_tree_s *);
 extern void gomp_unload_device (struct gomp_device_descr *);
@@ -31,7 +31,20 @@
 #include "libgomp.h"
 
 /* The internal gomp_mutex_t and the external non-recursive omp_lock_t
-   have the same form.  Re-use it.  */
+   have the same form.  Re-use it.  Locks initialized with a hint may
+   be in states plain mutexes never are in, so they are handled by the
+   gomp_mutex_*_hint functions.  */
+
+#ifndef GOMP_MUTEX_HINTS
+static inline int
+gomp_mutex_trylock_hint (gomp_mutex_t *mutex)
+{
+  int oldval = 0;
+
+  return __atomic_compare_exchange_n (mutex, &oldval, 1, false,
+				      MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
+}
+#endif
 
 void
 gomp_init_lock_30 (omp_lock_t *lock)
@@ -39,6 +52,12 @@ gomp_init_lock_30 (omp_lock_t *lock)
   gomp_mutex_init (lock);
 }
 
+void
+omp_init_lock_with_hint (omp_lock_t *lock, omp_lock_hint_t hint)
+{
+  gomp_mutex_init_hint (lock, hint);
+}
+
 void
 gomp_destroy_lock_30 (omp_lock_t *lock)
 {
@@ -48,22 +67,19 @@ gomp_destroy_lock_30 (omp_lock_t *lock)
 void
 gomp_set_lock_30 (omp_lock_t *lock)
 {
-  gomp_mutex_lock (lock);
+  gomp_mutex_lock_hint (lock);
 }
 
 void
 gomp_unset_lock_30 (omp_lock_t *lock)
 {
-  gomp_mutex_unlock (lock);
+  gomp_mutex_unlock_hint (lock);
 }
 
 int
 gomp_test_lock_30 (omp_lock_t *lock)
 {
-  int oldval = 0;
-
-  return __atomic_compare_exchange_n (lock, &oldval, 1, false,
-				      MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
+  return gomp_mutex_trylock_hint (lock);
 }
 
 void
@@ -72,6 +88,13 @@ gomp_init_nest_lock_30 (omp_nest_lock_t *lock)
   memset (lock, '\0', sizeof (*lock));
 }
 
+void
+omp_init_nest_lock_with_hint (omp_nest_lock_t *lock, omp_lock_hint_t hint)
+{
+  memset (lock, '\0', sizeof (*lock));
+  gomp_mutex_init_hint (&lock->lock, hint);
+}
+
 void
 gomp_destroy_nest_lock_30 (omp_nest_lock_t *lock)
 {
@@ -84,7 +107,7 @@ gomp_set_nest_lock_30 (omp_nest_lock_t *lock)
 
   if (lock->owner != me)
     {
-      gomp_mutex_lock (&lock->lock);
+      gomp_mutex_lock_hint (&lock->lock);
       lock->owner = me;
     }
 
@@ -97,7 +120,7 @@ gomp_unset_nest_lock_30 (omp_nest_lock_t *lock)
   if (--lock->count == 0)
     {
       lock->owner = NULL;
-      gomp_mutex_unlock (&lock->lock);
+      gomp_mutex_unlock_hint (&lock->lock);
     }
 }
 
@@ -105,14 +128,11 @@ int
 gomp_test_nest_lock_30 (omp_nest_lock_t *lock)
 {
   void *me = gomp_icv (true);
-  int oldval;
 
   if (lock->owner == me)
     return ++lock->count;
 
-  oldval = 0;
-  if (__atomic_compare_exchange_n (&lock->lock, &oldval, 1, false,
-				   MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+  if (gomp_mutex_trylock_hint (&lock->lock))
     {
       lock->owner = me;
       lock->count = 1;
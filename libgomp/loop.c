@@ -78,6 +78,30 @@ gomp_loop_init (struct gomp_work_share *ws, long start, long end, long incr,
     }
 }
 
+/* Split the iterations of the GFS_DYNAMIC loop in WS into per-thread
+   ranges for NTHREADS threads, for the nonmonotonic dynamic schedule.
+   CHUNK_SIZE is the unscaled SCHEDULE clause argument.  */
+
+static inline void
+gomp_loop_steal_init (struct gomp_work_share *ws, long chunk_size,
+		      unsigned nthreads)
+{
+  unsigned long span, step;
+
+  if (ws->incr > 0)
+    {
+      span = (unsigned long) ws->end - (unsigned long) ws->next;
+      step = ws->incr;
+    }
+  else
+    {
+      span = (unsigned long) ws->next - (unsigned long) ws->end;
+      step = -(unsigned long) ws->incr;
+    }
+  gomp_iter_steal_init (ws, span / step + (span % step != 0), chunk_size,
+			nthreads);
+}
+
 /* The *_start routines are called when first encountering a loop construct
    that is not bound directly to a parallel construct.  The first thread 
    that arrives will create the work-share construct; subsequent threads
@@ -111,10 +135,8 @@ gomp_loop_static_start (long start, long end, long incr, long chunk_size,
   return !gomp_iter_static_next (istart, iend);
 }
 
-/* The current dynamic implementation is always monotonic.  The
-   entrypoints without nonmonotonic in them have to be always monotonic,
-   but the nonmonotonic ones could be changed to use work-stealing for
-   improved scalability.  */
+/* The entrypoints without nonmonotonic in them have to be always
+   monotonic, so they all allocate chunks from the shared ws->next.  */
 
 static bool
 gomp_loop_dynamic_start (long start, long end, long incr, long chunk_size,
@@ -141,6 +163,32 @@ gomp_loop_dynamic_start (long start, long end, long incr, long chunk_size,
   return ret;
 }
 
+/* The nonmonotonic variant gives each thread a contiguous share of the
+   iterations up front; threads hand out chunks from their own share and
+   only touch another thread's share to steal half of it once theirs is
+   used up.  */
+
+static bool
+gomp_loop_nonmonotonic_dynamic_start (long start, long end, long incr,
+				      long chunk_size, long *istart,
+				      long *iend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+
+  if (gomp_work_share_start (false))
+    {
+      struct gomp_team *team = thr->ts.team;
+
+      gomp_loop_init (thr->ts.work_share, start, end, incr,
+		      GFS_DYNAMIC, chunk_size);
+      gomp_loop_steal_init (thr->ts.work_share, chunk_size,
+			    team ? team->nthreads : 1);
+      gomp_work_share_init_done ();
+    }
+
+  return gomp_iter_nonmonotonic_dynamic_next (istart, iend);
+}
+
 /* Similarly as for dynamic, though the question is how can the chunk sizes
    be decreased without a central locking or atomics.  */
 
@@ -435,6 +483,12 @@ gomp_loop_dynamic_next (long *istart, long *iend)
   return ret;
 }
 
+static bool
+gomp_loop_nonmonotonic_dynamic_next (long *istart, long *iend)
+{
+  return gomp_iter_nonmonotonic_dynamic_next (istart, iend);
+}
+
 static bool
 gomp_loop_guided_next (long *istart, long *iend)
 {
@@ -638,24 +692,28 @@ GOMP_parallel_loop_guided (void (*fn) (void *), void *data,
   GOMP_parallel_end ();
 }
 
-#ifdef HAVE_ATTRIBUTE_ALIAS
-extern __typeof(GOMP_parallel_loop_dynamic) GOMP_parallel_loop_nonmonotonic_dynamic
-	__attribute__((alias ("GOMP_parallel_loop_dynamic")));
-extern __typeof(GOMP_parallel_loop_guided) GOMP_parallel_loop_nonmonotonic_guided
-	__attribute__((alias ("GOMP_parallel_loop_guided")));
-#else
 void
 GOMP_parallel_loop_nonmonotonic_dynamic (void (*fn) (void *), void *data,
 					 unsigned num_threads, long start,
 					 long end, long incr, long chunk_size,
 					 unsigned flags)
 {
-  gomp_parallel_loop_start (fn, data, num_threads, start, end, incr,
-			    GFS_DYNAMIC, chunk_size, flags);
+  struct gomp_team *team;
+
+  num_threads = gomp_resolve_num_threads (num_threads, 0);
+  team = gomp_new_team (num_threads);
+  gomp_loop_init (&team->work_shares[0], start, end, incr, GFS_DYNAMIC,
+		  chunk_size);
+  gomp_loop_steal_init (&team->work_shares[0], chunk_size, num_threads);
+  gomp_team_start (fn, data, num_threads, flags, team);
   fn (data);
   GOMP_parallel_end ();
 }
 
+#ifdef HAVE_ATTRIBUTE_ALIAS
+extern __typeof(GOMP_parallel_loop_guided) GOMP_parallel_loop_nonmonotonic_guided
+	__attribute__((alias ("GOMP_parallel_loop_guided")));
+#else
 void
 GOMP_parallel_loop_nonmonotonic_guided (void (*fn) (void *), void *data,
 					unsigned num_threads, long start,
@@ -717,8 +775,8 @@ extern __typeof(gomp_loop_dynamic_start) GOMP_loop_dynamic_start
 	__attribute__((alias ("gomp_loop_dynamic_start")));
 extern __typeof(gomp_loop_guided_start) GOMP_loop_guided_start
 	__attribute__((alias ("gomp_loop_guided_start")));
-extern __typeof(gomp_loop_dynamic_start) GOMP_loop_nonmonotonic_dynamic_start
-	__attribute__((alias ("gomp_loop_dynamic_start")));
+extern __typeof(gomp_loop_nonmonotonic_dynamic_start) GOMP_loop_nonmonotonic_dynamic_start
+	__attribute__((alias ("gomp_loop_nonmonotonic_dynamic_start")));
 extern __typeof(gomp_loop_guided_start) GOMP_loop_nonmonotonic_guided_start
 	__attribute__((alias ("gomp_loop_guided_start")));
 
@@ -742,8 +800,8 @@ extern __typeof(gomp_loop_dynamic_next) GOMP_loop_dynamic_next
 	__attribute__((alias ("gomp_loop_dynamic_next")));
 extern __typeof(gomp_loop_guided_next) GOMP_loop_guided_next
 	__attribute__((alias ("gomp_loop_guided_next")));
-extern __typeof(gomp_loop_dynamic_next) GOMP_loop_nonmonotonic_dynamic_next
-	__attribute__((alias ("gomp_loop_dynamic_next")));
+extern __typeof(gomp_loop_nonmonotonic_dynamic_next) GOMP_loop_nonmonotonic_dynamic_next
+	__attribute__((alias ("gomp_loop_nonmonotonic_dynamic_next")));
 extern __typeof(gomp_loop_guided_next) GOMP_loop_nonmonotonic_guided_next
 	__attribute__((alias ("gomp_loop_guided_next")));
 
@@ -780,7 +838,8 @@ GOMP_loop_nonmonotonic_dynamic_start (long start, long end, long incr,
 				      long chunk_size, long *istart,
 				      long *iend)
 {
-  return gomp_loop_dynamic_start (start, end, incr, chunk_size, istart, iend);
+  return gomp_loop_nonmonotonic_dynamic_start (start, end, incr, chunk_size,
+					       istart, iend);
 }
 
 bool
@@ -859,7 +918,7 @@ GOMP_loop_guided_next (long *istart, long *iend)
 bool
 GOMP_loop_nonmonotonic_dynamic_next (long *istart, long *iend)
 {
-  return gomp_loop_dynamic_next (istart, iend);
+  return gomp_loop_nonmonotonic_dynamic_next (istart, iend);
 }
 
 bool
@@ -80,6 +80,30 @@ gomp_loop_ull_init (struct gomp_work_share *ws, bool up, gomp_ull start,
     ws->mode |= 2;
 }
 
+/* Split the iterations of the GFS_DYNAMIC loop in WS into per-thread
+   ranges for NTHREADS threads, for the nonmonotonic dynamic schedule.
+   CHUNK_SIZE is the unscaled SCHEDULE clause argument.  */
+
+static inline void
+gomp_loop_ull_steal_init (struct gomp_work_share *ws, gomp_ull chunk_size,
+			  unsigned nthreads)
+{
+  gomp_ull span, step;
+
+  if (__builtin_expect (ws->mode & 2, 0) == 0)
+    {
+      span = ws->end_ull - ws->next_ull;
+      step = ws->incr_ull;
+    }
+  else
+    {
+      span = ws->next_ull - ws->end_ull;
+      step = -ws->incr_ull;
+    }
+  gomp_iter_steal_init (ws, span / step + (span % step != 0), chunk_size,
+			nthreads);
+}
+
 /* The *_start routines are called when first encountering a loop construct
    that is not bound directly to a parallel construct.  The first thread
    that arrives will create the work-share construct; subsequent threads
@@ -140,6 +164,30 @@ gomp_loop_ull_dynamic_start (bool up, gomp_ull start, gomp_ull end,
   return ret;
 }
 
+/* See gomp_loop_nonmonotonic_dynamic_start.  */
+
+static bool
+gomp_loop_ull_nonmonotonic_dynamic_start (bool up, gomp_ull start,
+					  gomp_ull end, gomp_ull incr,
+					  gomp_ull chunk_size,
+					  gomp_ull *istart, gomp_ull *iend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+
+  if (gomp_work_share_start (false))
+    {
+      struct gomp_team *team = thr->ts.team;
+
+      gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
+			  GFS_DYNAMIC, chunk_size);
+      gomp_loop_ull_steal_init (thr->ts.work_share, chunk_size,
+				team ? team->nthreads : 1);
+      gomp_work_share_init_done ();
+    }
+
+  return gomp_iter_ull_nonmonotonic_dynamic_next (istart, iend);
+}
+
 static bool
 gomp_loop_ull_guided_start (bool up, gomp_ull start, gomp_ull end,
 			    gomp_ull incr, gomp_ull chunk_size,
@@ -440,6 +488,12 @@ gomp_loop_ull_dynamic_next (gomp_ull *istart, gomp_ull *iend)
   return ret;
 }
 
+static bool
+gomp_loop_ull_nonmonotonic_dynamic_next (gomp_ull *istart, gomp_ull *iend)
+{
+  return gomp_iter_ull_nonmonotonic_dynamic_next (istart, iend);
+}
+
 static bool
 gomp_loop_ull_guided_next (gomp_ull *istart, gomp_ull *iend)
 {
@@ -566,8 +620,8 @@ extern __typeof(gomp_loop_ull_dynamic_start) GOMP_loop_ull_dynamic_start
 	__attribute__((alias ("gomp_loop_ull_dynamic_start")));
 extern __typeof(gomp_loop_ull_guided_start) GOMP_loop_ull_guided_start
 	__attribute__((alias ("gomp_loop_ull_guided_start")));
-extern __typeof(gomp_loop_ull_dynamic_start) GOMP_loop_ull_nonmonotonic_dynamic_start
-	__attribute__((alias ("gomp_loop_ull_dynamic_start")));
+extern __typeof(gomp_loop_ull_nonmonotonic_dynamic_start) GOMP_loop_ull_nonmonotonic_dynamic_start
+	__attribute__((alias ("gomp_loop_ull_nonmonotonic_dynamic_start")));
 extern __typeof(gomp_loop_ull_guided_start) GOMP_loop_ull_nonmonotonic_guided_start
 	__attribute__((alias ("gomp_loop_ull_guided_start")));
 
@@ -591,8 +645,8 @@ extern __typeof(gomp_loop_ull_dynamic_next) GOMP_loop_ull_dynamic_next
 	__attribute__((alias ("gomp_loop_ull_dynamic_next")));
 extern __typeof(gomp_loop_ull_guided_next) GOMP_loop_ull_guided_next
 	__attribute__((alias ("gomp_loop_ull_guided_next")));
-extern __typeof(gomp_loop_ull_dynamic_next) GOMP_loop_ull_nonmonotonic_dynamic_next
-	__attribute__((alias ("gomp_loop_ull_dynamic_next")));
+extern __typeof(gomp_loop_ull_nonmonotonic_dynamic_next) GOMP_loop_ull_nonmonotonic_dynamic_next
+	__attribute__((alias ("gomp_loop_ull_nonmonotonic_dynamic_next")));
 extern __typeof(gomp_loop_ull_guided_next) GOMP_loop_ull_nonmonotonic_guided_next
 	__attribute__((alias ("gomp_loop_ull_guided_next")));
 
@@ -636,8 +690,8 @@ GOMP_loop_ull_nonmonotonic_dynamic_start (bool up, gomp_ull start,
 					  gomp_ull chunk_size,
 					  gomp_ull *istart, gomp_ull *iend)
 {
-  return gomp_loop_ull_dynamic_start (up, start, end, incr, chunk_size, istart,
-				      iend);
+  return gomp_loop_ull_nonmonotonic_dynamic_start (up, start, end, incr,
+						   chunk_size, istart, iend);
 }
 
 bool
@@ -724,7 +778,7 @@ GOMP_loop_ull_guided_next (gomp_ull *istart, gomp_ull *iend)
 bool
 GOMP_loop_ull_nonmonotonic_dynamic_next (gomp_ull *istart, gomp_ull *iend)
 {
-  return gomp_loop_ull_dynamic_next (istart, iend);
+  return gomp_loop_ull_nonmonotonic_dynamic_next (istart, iend);
 }
 
 bool
@@ -108,7 +108,11 @@ acc_malloc (size_t s)
   if (thr->dev->capabilities & GOMP_OFFLOAD_CAP_SHARED_MEM)
     return malloc (s);
 
-  return thr->dev->alloc_func (thr->dev->target_id, s);
+  gomp_mutex_lock (&thr->dev->lock);
+  void *d = gomp_device_alloc (thr->dev, s);
+  gomp_mutex_unlock (&thr->dev->lock);
+
+  return d;
 }
 
 /* OpenACC 2.0a (3.2.16) doesn't specify what to do in the event
@@ -149,8 +153,13 @@ acc_free (void *d)
   else
     gomp_mutex_unlock (&acc_dev->lock);
 
-  if (!acc_dev->free_func (acc_dev->target_id, d))
-    gomp_fatal ("error in freeing device memory in %s", __FUNCTION__);
+  gomp_mutex_lock (&acc_dev->lock);
+  if (!gomp_device_free (acc_dev, d))
+    {
+      gomp_mutex_unlock (&acc_dev->lock);
+      gomp_fatal ("error in freeing device memory in %s", __FUNCTION__);
+    }
+  gomp_mutex_unlock (&acc_dev->lock);
 }
 
 void
@@ -566,8 +575,13 @@ delete_copyout (unsigned f, void *h, size_t s, const char *libfnname)
 
   acc_unmap_data (h);
 
-  if (!acc_dev->free_func (acc_dev->target_id, d))
-    gomp_fatal ("error in freeing device memory in %s", libfnname);
+  gomp_mutex_lock (&acc_dev->lock);
+  if (!gomp_device_free (acc_dev, d))
+    {
+      gomp_mutex_unlock (&acc_dev->lock);
+      gomp_fatal ("error in freeing device memory in %s", libfnname);
+    }
+  gomp_mutex_unlock (&acc_dev->lock);
 }
 
 void
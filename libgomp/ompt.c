@@ -0,0 +1,195 @@
+/* Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file contains the tool registration part of the OMPT interface.
+   The callbacks themselves are dispatched where the events happen, see
+   gomp_ompt_callback.  */
+
+#include "libgomp.h"
+#include "gomp-constants.h"
+#include <string.h>
+#include <strings.h>
+#ifdef PLUGIN_SUPPORT
+#include <dlfcn.h>
+#endif
+
+/* The OpenMP API version reported to ompt_start_tool.  */
+#define GOMP_OMPT_OMP_VERSION	201511
+
+bool gomp_ompt_enabled;
+ompt_callback_t gomp_ompt_callbacks[GOMP_OMPT_CALLBACKS];
+
+#ifndef LIBGOMP_OFFLOADED_ONLY
+/* The tool that has been started, if any.  */
+static ompt_start_tool_result_t *gomp_ompt_tool;
+
+/* Counter for host_op_id of ompt_callback_target_data_op.  */
+static unsigned long gomp_ompt_op_id;
+
+/* A tool linked into the program or one of its libraries provides this.  */
+#pragma weak ompt_start_tool
+
+static ompt_set_result_t
+gomp_ompt_set_callback (ompt_callbacks_t event, ompt_callback_t callback)
+{
+  switch (event)
+    {
+    case ompt_callback_thread_begin:
+    case ompt_callback_thread_end:
+    case ompt_callback_parallel_begin:
+    case ompt_callback_parallel_end:
+    case ompt_callback_task_create:
+    case ompt_callback_task_schedule:
+    case ompt_callback_implicit_task:
+    case ompt_callback_target_data_op:
+    case ompt_callback_sync_region_wait:
+      gomp_ompt_callbacks[event] = callback;
+      return ompt_set_always;
+    default:
+      return ompt_set_never;
+    }
+}
+
+static int
+gomp_ompt_get_callback (ompt_callbacks_t event, ompt_callback_t *callback)
+{
+  if ((int) event <= 0 || event >= GOMP_OMPT_CALLBACKS
+      || gomp_ompt_callbacks[event] == NULL)
+    return 0;
+  *callback = gomp_ompt_callbacks[event];
+  return 1;
+}
+
+static ompt_data_t *
+gomp_ompt_get_thread_data (void)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  return thr ? &thr->ompt_thread_data : NULL;
+}
+
+/* Return a new host_op_id for ompt_callback_target_data_op.  */
+
+ompt_id_t
+gomp_ompt_next_op_id (void)
+{
+  return __atomic_add_fetch (&gomp_ompt_op_id, 1, MEMMODEL_RELAXED);
+}
+
+static ompt_interface_fn_t
+gomp_ompt_lookup (const char *name)
+{
+  if (strcmp (name, "ompt_set_callback") == 0)
+    return (ompt_interface_fn_t) gomp_ompt_set_callback;
+  if (strcmp (name, "ompt_get_callback") == 0)
+    return (ompt_interface_fn_t) gomp_ompt_get_callback;
+  if (strcmp (name, "ompt_get_thread_data") == 0)
+    return (ompt_interface_fn_t) gomp_ompt_get_thread_data;
+  return NULL;
+}
+
+/* Find a tool: first one linked into the program, then the ones listed
+   in OMP_TOOL_LIBRARIES, in order.  */
+
+static ompt_start_tool_result_t *
+gomp_ompt_find_tool (void)
+{
+  ompt_start_tool_result_t *ret = NULL;
+
+  if (ompt_start_tool)
+    ret = ompt_start_tool (GOMP_OMPT_OMP_VERSION, "GNU libgomp");
+
+#ifdef PLUGIN_SUPPORT
+  const char *libs = getenv ("OMP_TOOL_LIBRARIES");
+  while (ret == NULL && libs != NULL && *libs != '\0')
+    {
+      const char *end = strchr (libs, ':');
+      size_t len = end ? (size_t) (end - libs) : strlen (libs);
+      char *name = gomp_malloc (len + 1);
+      void *handle;
+
+      memcpy (name, libs, len);
+      name[len] = '\0';
+      handle = dlopen (name, RTLD_LAZY);
+      if (handle)
+	{
+	  ompt_start_tool_result_t *(*start_tool) (unsigned int,
+						   const char *)
+	    = dlsym (handle, "ompt_start_tool");
+	  if (start_tool)
+	    ret = start_tool (GOMP_OMPT_OMP_VERSION, "GNU libgomp");
+	  if (ret == NULL)
+	    dlclose (handle);
+	}
+      free (name);
+      libs = end ? end + 1 : NULL;
+    }
+#endif
+
+  return ret;
+}
+
+/* Start a tool if there is one, called from initialize_env.  */
+
+void
+gomp_ompt_init (void)
+{
+  const char *env = getenv ("OMP_TOOL");
+  ompt_callback_thread_begin_t thread_begin;
+
+  if (env && strcasecmp (env, "disabled") == 0)
+    return;
+
+  gomp_ompt_tool = gomp_ompt_find_tool ();
+  if (gomp_ompt_tool == NULL)
+    return;
+  if (!gomp_ompt_tool->initialize (gomp_ompt_lookup,
+				   GOMP_DEVICE_HOST_FALLBACK,
+				   &gomp_ompt_tool->tool_data))
+    {
+      memset (gomp_ompt_callbacks, 0, sizeof (gomp_ompt_callbacks));
+      gomp_ompt_tool = NULL;
+      return;
+    }
+  gomp_ompt_enabled = true;
+
+  thread_begin = gomp_ompt_callback (thread_begin);
+  if (thread_begin && gomp_thread ())
+    thread_begin (ompt_thread_initial, &gomp_thread ()->ompt_thread_data);
+}
+
+static void __attribute__((destructor))
+gomp_ompt_fini (void)
+{
+  ompt_callback_thread_end_t thread_end = gomp_ompt_callback (thread_end);
+
+  if (gomp_ompt_tool == NULL)
+    return;
+  if (thread_end && gomp_thread ())
+    thread_end (&gomp_thread ()->ompt_thread_data);
+  gomp_ompt_enabled = false;
+  if (gomp_ompt_tool->finalize)
+    gomp_ompt_tool->finalize (&gomp_ompt_tool->tool_data);
+  gomp_ompt_tool = NULL;
+}
+#endif /* LIBGOMP_OFFLOADED_ONLY */
@@ -331,8 +331,11 @@ gomp_doacross_init (unsigned ncounts, long *counts, long chunk_size)
 	  doacross->shift_counts[i - 1] = shift_count;
 	  shift_count += bits[i - 1];
 	}
+      /* Clear the counters as well as the words following them, which
+	 doacross.h may use to track sleeping waiters.  */
       for (ent = 0; ent < num_ents; ent++)
-	*(unsigned long *) (doacross->array + ent * elt_sz) = 0;
+	memset (doacross->array + ent * elt_sz, '\0',
+		2 * sizeof (unsigned long));
     }
   else
     for (ent = 0; ent < num_ents; ent++)
@@ -387,7 +390,7 @@ GOMP_doacross_post (long *counts)
       if (flattened == __atomic_load_n (array, MEMMODEL_ACQUIRE))
 	__atomic_thread_fence (MEMMODEL_RELEASE);
       else
-	__atomic_store_n (array, flattened, MEMMODEL_RELEASE);
+	doacross_post (array, flattened);
       return;
     }
 
@@ -566,8 +569,11 @@ gomp_doacross_ull_init (unsigned ncounts, gomp_ull *counts, gomp_ull chunk_size)
 	  doacross->shift_counts[i - 1] = shift_count;
 	  shift_count += bits[i - 1];
 	}
+      /* Clear the counters as well as the words following them, which
+	 doacross.h may use to track sleeping waiters.  */
       for (ent = 0; ent < num_ents; ent++)
-	*(unsigned long *) (doacross->array + ent * elt_sz) = 0;
+	memset (doacross->array + ent * elt_sz, '\0',
+		2 * sizeof (unsigned long));
     }
   else
     for (ent = 0; ent < num_ents; ent++)
@@ -621,7 +627,7 @@ GOMP_doacross_ull_post (gomp_ull *counts)
       if (flattened == __atomic_load_n (array, MEMMODEL_ACQUIRE))
 	__atomic_thread_fence (MEMMODEL_RELEASE);
       else
-	__atomic_store_n (array, flattened, MEMMODEL_RELEASE);
+	doacross_post (array, flattened);
       return;
     }
 
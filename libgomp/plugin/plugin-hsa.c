@@ -364,6 +364,21 @@ struct brig_image_desc
 
 struct agent_info;
 
+/* A kernel argument buffer and a completion signal of a finished kernel
+   dispatch, kept for reuse by subsequent dispatches on the same agent.  */
+
+struct dispatch_resources
+{
+  /* The next entry in the pool of an agent.  */
+  struct dispatch_resources *next;
+  /* Kernel argument buffer allocated from the kernarg region.  */
+  void *kernarg_address;
+  /* Size of the buffer above.  */
+  uint32_t kernarg_size;
+  /* Handle of the completion signal.  */
+  uint64_t signal;
+};
+
 /* Information required to identify, finalize and run any given kernel.  */
 
 struct kernel_info
@@ -470,6 +485,13 @@ struct agent_info
   struct brig_library_info **brig_libraries;
   /* Number of loaded shared BRIG libraries.  */
   unsigned brig_libraries_count;
+
+  /* Mutex protecting the pool of dispatch resources.  */
+  pthread_mutex_t dispatch_pool_mutex;
+  /* Kernel argument buffers and completion signals of finished kernel
+     dispatches.  Allocating them from the HSA run-time is expensive compared
+     to running a small kernel, so they are reused.  */
+  struct dispatch_resources *dispatch_pool;
 };
 
 /* Information about the whole HSA environment and all of its agents.  */
@@ -738,6 +760,13 @@ GOMP_OFFLOAD_init_device (int n)
       GOMP_PLUGIN_error ("Failed to initialize an HSA agent program mutex");
       return false;
     }
+  if (pthread_mutex_init (&agent->dispatch_pool_mutex, NULL))
+    {
+      GOMP_PLUGIN_error ("Failed to initialize an HSA agent dispatch pool "
+			 "mutex");
+      return false;
+    }
+  agent->dispatch_pool = NULL;
 
   uint32_t queue_size;
   hsa_status_t status;
@@ -1130,6 +1159,93 @@ final:
     GOMP_PLUGIN_fatal ("Could not unlock an HSA agent program mutex");
 }
 
+/* Provide SHADOW with a kernel argument buffer of at least KERNARG_SIZE bytes
+   and a completion signal set to one.  Take them from the dispatch pool of
+   AGENT if possible, otherwise allocate them.  */
+
+static void
+acquire_dispatch_resources (struct agent_info *agent,
+			    struct GOMP_hsa_kernel_dispatch *shadow,
+			    uint32_t kernarg_size)
+{
+  struct dispatch_resources *res, **prev;
+  hsa_signal_t sync_signal;
+  hsa_status_t status;
+
+  if (pthread_mutex_lock (&agent->dispatch_pool_mutex))
+    GOMP_PLUGIN_fatal ("Could not lock an HSA agent dispatch pool mutex");
+  for (prev = &agent->dispatch_pool; (res = *prev); prev = &res->next)
+    if (res->kernarg_size >= kernarg_size)
+      {
+	*prev = res->next;
+	break;
+      }
+  if (pthread_mutex_unlock (&agent->dispatch_pool_mutex))
+    GOMP_PLUGIN_fatal ("Could not unlock an HSA agent dispatch pool mutex");
+
+  if (res)
+    {
+      shadow->kernarg_address = res->kernarg_address;
+      shadow->signal = res->signal;
+      sync_signal.handle = res->signal;
+      hsa_fns.hsa_signal_store_relaxed_fn (sync_signal, 1);
+      free (res);
+      return;
+    }
+
+  status = hsa_fns.hsa_signal_create_fn (1, 0, NULL, &sync_signal);
+  if (status != HSA_STATUS_SUCCESS)
+    hsa_fatal ("Error creating the HSA sync signal", status);
+  shadow->signal = sync_signal.handle;
+
+  status = hsa_fns.hsa_memory_allocate_fn (agent->kernarg_region, kernarg_size,
+					   &shadow->kernarg_address);
+  if (status != HSA_STATUS_SUCCESS)
+    hsa_fatal ("Could not allocate memory for HSA kernel arguments", status);
+}
+
+/* Return the kernel argument buffer of KERNARG_SIZE bytes and the completion
+   signal of SHADOW into the dispatch pool of AGENT.  */
+
+static void
+release_dispatch_resources (struct agent_info *agent,
+			    struct GOMP_hsa_kernel_dispatch *shadow,
+			    uint32_t kernarg_size)
+{
+  struct dispatch_resources *res
+    = GOMP_PLUGIN_malloc (sizeof (struct dispatch_resources));
+
+  res->kernarg_address = shadow->kernarg_address;
+  res->kernarg_size = kernarg_size;
+  res->signal = shadow->signal;
+
+  if (pthread_mutex_lock (&agent->dispatch_pool_mutex))
+    GOMP_PLUGIN_fatal ("Could not lock an HSA agent dispatch pool mutex");
+  res->next = agent->dispatch_pool;
+  agent->dispatch_pool = res;
+  if (pthread_mutex_unlock (&agent->dispatch_pool_mutex))
+    GOMP_PLUGIN_fatal ("Could not unlock an HSA agent dispatch pool mutex");
+}
+
+/* Free all kernel argument buffers and destroy all completion signals in the
+   dispatch pool of AGENT.  */
+
+static void
+destroy_dispatch_pool (struct agent_info *agent)
+{
+  while (agent->dispatch_pool)
+    {
+      struct dispatch_resources *res = agent->dispatch_pool;
+      agent->dispatch_pool = res->next;
+
+      hsa_fns.hsa_memory_free_fn (res->kernarg_address);
+      hsa_signal_t s;
+      s.handle = res->signal;
+      hsa_fns.hsa_signal_destroy_fn (s);
+      free (res);
+    }
+}
+
 /* Create kernel dispatch data structure for given KERNEL.  */
 
 static struct GOMP_hsa_kernel_dispatch *
@@ -1151,43 +1267,35 @@ create_single_kernel_dispatch (struct kernel_info *kernel,
 
   shadow->object = kernel->object;
 
-  hsa_signal_t sync_signal;
-  hsa_status_t status = hsa_fns.hsa_signal_create_fn (1, 0, NULL, &sync_signal);
-  if (status != HSA_STATUS_SUCCESS)
-    hsa_fatal ("Error creating the HSA sync signal", status);
-
-  shadow->signal = sync_signal.handle;
   shadow->private_segment_size = kernel->private_segment_size;
   shadow->group_segment_size = kernel->group_segment_size;
 
-  status
-    = hsa_fns.hsa_memory_allocate_fn (agent->kernarg_region,
-				      kernel->kernarg_segment_size,
-				      &shadow->kernarg_address);
-  if (status != HSA_STATUS_SUCCESS)
-    hsa_fatal ("Could not allocate memory for HSA kernel arguments", status);
+  acquire_dispatch_resources (agent, shadow, kernel->kernarg_segment_size);
 
   return shadow;
 }
 
-/* Release data structure created for a kernel dispatch in SHADOW argument.  */
+/* Release data structure created for a kernel dispatch of KERNEL in SHADOW
+   argument.  */
 
 static void
-release_kernel_dispatch (struct GOMP_hsa_kernel_dispatch *shadow)
+release_kernel_dispatch (struct kernel_info *kernel,
+			 struct GOMP_hsa_kernel_dispatch *shadow)
 {
   HSA_DEBUG ("Released kernel dispatch: %p has value: %lu (%p)\n", shadow,
 	     shadow->debug, (void *) shadow->debug);
 
-  hsa_fns.hsa_memory_free_fn (shadow->kernarg_address);
-
-  hsa_signal_t s;
-  s.handle = shadow->signal;
-  hsa_fns.hsa_signal_destroy_fn (s);
+  release_dispatch_resources (kernel->agent, shadow,
+			      kernel->kernarg_segment_size);
 
   free (shadow->omp_data_memory);
 
   for (unsigned i = 0; i < shadow->kernel_dispatch_count; i++)
-    release_kernel_dispatch (shadow->children_dispatches[i]);
+    {
+      struct kernel_info *dependency
+	= get_kernel_for_agent (kernel->agent, kernel->dependencies[i]);
+      release_kernel_dispatch (dependency, shadow->children_dispatches[i]);
+    }
 
   free (shadow->children_dispatches);
   free (shadow);
@@ -1620,7 +1728,7 @@ run_kernel (struct kernel_info *kernel, void *vars,
 	hsa_fns.hsa_signal_load_acquire_fn (child_s);
       }
 
-  release_kernel_dispatch (shadow);
+  release_kernel_dispatch (kernel, shadow);
 
   if (pthread_rwlock_unlock (&agent->modules_rwlock))
     GOMP_PLUGIN_fatal ("Unable to unlock an HSA agent rwlock");
@@ -1816,6 +1924,12 @@ GOMP_OFFLOAD_fini_device (int n)
       GOMP_PLUGIN_error ("Failed to destroy an HSA agent program mutex");
       return false;
     }
+  destroy_dispatch_pool (agent);
+  if (pthread_mutex_destroy (&agent->dispatch_pool_mutex))
+    {
+      GOMP_PLUGIN_error ("Failed to destroy an HSA agent dispatch pool mutex");
+      return false;
+    }
   if (pthread_rwlock_destroy (&agent->modules_rwlock))
     {
       GOMP_PLUGIN_error ("Failed to destroy an HSA agent rwlock");
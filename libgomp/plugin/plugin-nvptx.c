@@ -1596,6 +1596,8 @@ GOMP_OFFLOAD_init_device (int n)
   return dev != NULL;
 }
 
+static void nvptx_release_finished_async_runs (int);
+
 bool
 GOMP_OFFLOAD_fini_device (int n)
 {
@@ -1603,8 +1605,13 @@ GOMP_OFFLOAD_fini_device (int n)
 
   if (ptx_devices[n] != NULL)
     {
-      if (!nvptx_attach_host_thread_to_device (n)
-	  || !nvptx_close_device (ptx_devices[n]))
+      if (!nvptx_attach_host_thread_to_device (n))
+	{
+	  pthread_mutex_unlock (&ptx_dev_lock);
+	  return false;
+	}
+      nvptx_release_finished_async_runs (n);
+      if (!nvptx_close_device (ptx_devices[n]))
 	{
 	  pthread_mutex_unlock (&ptx_dev_lock);
 	  return false;
@@ -1990,13 +1997,18 @@ nvptx_stacks_free (void *p, int num)
     GOMP_PLUGIN_fatal ("cuMemFree error: %s", cuda_error (r));
 }
 
-void
-GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
+/* Launch the OpenMP target region TGT_FN with arguments TGT_VARS and
+   target arguments ARGS on device ORD, in STREAM.  Store the stacks
+   allocated for it and their number in *STACKS and *NUM_STACKS; they
+   must be kept until the kernel has finished.  */
+
+static void
+nvptx_launch_target (int ord, void *tgt_fn, void *tgt_vars, void **args,
+		     CUstream stream, void **stacks, int *num_stacks)
 {
   CUfunction function = ((struct targ_fn_descriptor *) tgt_fn)->fn;
   CUresult r;
   struct ptx_device *ptx_dev = ptx_devices[ord];
-  const char *maybe_abort_msg = "(perhaps abort was called)";
   int teams = 0, threads = 0;
 
   if (!args)
@@ -2020,8 +2032,9 @@ GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
   nvptx_adjust_launch_bounds (tgt_fn, ptx_dev, &teams, &threads);
 
   size_t stack_size = nvptx_stacks_size ();
-  void *stacks = nvptx_stacks_alloc (stack_size, teams * threads);
-  void *fn_args[] = {tgt_vars, stacks, (void *) stack_size};
+  *num_stacks = teams * threads;
+  *stacks = nvptx_stacks_alloc (stack_size, *num_stacks);
+  void *fn_args[] = {tgt_vars, *stacks, (void *) stack_size};
   size_t fn_args_size = sizeof fn_args;
   void *config[] = {
     CU_LAUNCH_PARAM_BUFFER_POINTER, fn_args,
@@ -2031,9 +2044,95 @@ GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
   r = cuLaunchKernel (function,
 		      teams, 1, 1,
 		      32, threads, 1,
-		      0, ptx_dev->null_stream->stream, NULL, config);
+		      0, stream, NULL, config);
   if (r != CUDA_SUCCESS)
     GOMP_PLUGIN_fatal ("cuLaunchKernel error: %s", cuda_error (r));
+}
+
+/* An OpenMP target region launched by GOMP_OFFLOAD_async_run.  */
+
+struct nvptx_async_run
+{
+  int ord;
+  CUstream stream;
+  void *stacks;
+  int num_stacks;
+  void *async_data;
+  struct nvptx_async_run *next;
+};
+
+/* Asynchronous target regions that have finished, but whose stream and
+   stacks have not been released yet.  Stream callbacks must not call
+   into the CUDA API, so this is done by the next call into the plugin
+   that launches a target region, or when the device is finalized.  */
+
+static struct nvptx_async_run *nvptx_finished_async_runs;
+static pthread_mutex_t nvptx_async_run_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Release the resources of the finished asynchronous target regions
+   of device ORD.  */
+
+static void
+nvptx_release_finished_async_runs (int ord)
+{
+  struct nvptx_async_run *run = NULL, **p;
+
+  pthread_mutex_lock (&nvptx_async_run_lock);
+  for (p = &nvptx_finished_async_runs; *p; )
+    if ((*p)->ord == ord)
+      {
+	struct nvptx_async_run *r = *p;
+	*p = r->next;
+	r->next = run;
+	run = r;
+      }
+    else
+      p = &(*p)->next;
+  pthread_mutex_unlock (&nvptx_async_run_lock);
+
+  while (run)
+    {
+      struct nvptx_async_run *next = run->next;
+      CUDA_CALL_ASSERT (cuStreamDestroy, run->stream);
+      nvptx_stacks_free (run->stacks, run->num_stacks);
+      free (run);
+      run = next;
+    }
+}
+
+/* Stream callback called by the CUDA driver when the kernel of the
+   asynchronous target region DATA has finished.  */
+
+static void CUDA_CB
+nvptx_async_run_done (CUstream stream, CUresult status, void *data)
+{
+  struct nvptx_async_run *run = (struct nvptx_async_run *) data;
+  void *async_data = run->async_data;
+
+  if (status != CUDA_SUCCESS)
+    GOMP_PLUGIN_fatal ("asynchronous target region failed with CUDA error %d "
+		       "(perhaps abort was called)", (int) status);
+
+  pthread_mutex_lock (&nvptx_async_run_lock);
+  run->next = nvptx_finished_async_runs;
+  nvptx_finished_async_runs = run;
+  pthread_mutex_unlock (&nvptx_async_run_lock);
+
+  GOMP_PLUGIN_target_task_completion (async_data);
+}
+
+void
+GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
+{
+  CUresult r;
+  const char *maybe_abort_msg = "(perhaps abort was called)";
+  void *stacks;
+  int num_stacks;
+
+  nvptx_release_finished_async_runs (ord);
+  nvptx_launch_target (ord, tgt_fn, tgt_vars, args,
+		       ptx_devices[ord]->null_stream->stream,
+		       &stacks, &num_stacks);
 
   r = cuCtxSynchronize ();
   if (r == CUDA_ERROR_LAUNCH_FAILED)
@@ -2041,12 +2140,29 @@ GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
 		       maybe_abort_msg);
   else if (r != CUDA_SUCCESS)
     GOMP_PLUGIN_fatal ("cuCtxSynchronize error: %s", cuda_error (r));
-  nvptx_stacks_free (stacks, teams * threads);
+  nvptx_stacks_free (stacks, num_stacks);
 }
 
+/* Run a target region like GOMP_OFFLOAD_run does, but in a stream of its
+   own, and call GOMP_PLUGIN_target_task_completion with ASYNC_DATA from
+   a stream callback once it has finished.  No host thread waits for the
+   kernel in the meantime.  */
+
 void
 GOMP_OFFLOAD_async_run (int ord, void *tgt_fn, void *tgt_vars, void **args,
 			void *async_data)
 {
-  GOMP_PLUGIN_fatal ("GOMP_OFFLOAD_async_run unimplemented");
+  struct nvptx_async_run *run;
+
+  nvptx_release_finished_async_runs (ord);
+
+  run = GOMP_PLUGIN_malloc (sizeof (struct nvptx_async_run));
+  run->ord = ord;
+  run->async_data = async_data;
+  run->next = NULL;
+  CUDA_CALL_ASSERT (cuStreamCreate, &run->stream, CU_STREAM_NON_BLOCKING);
+  nvptx_launch_target (ord, tgt_fn, tgt_vars, args, run->stream,
+		       &run->stacks, &run->num_stacks);
+  CUDA_CALL_ASSERT (cuStreamAddCallback, run->stream, nvptx_async_run_done,
+		    run, 0);
 }
@@ -26,107 +26,32 @@
 
 /* The splay tree code copied from include/splay-tree.h and adjusted,
    so that all the data lives directly in splay_tree_node_s structure
-   and no extra allocations are needed.  */
+   and no extra allocations are needed.
 
-/* For an easily readable description of splay-trees, see:
-
-     Lewis, Harry R. and Denenberg, Larry.  Data Structures and Their
-     Algorithms.  Harper-Collins, Inc.  1991.
-
-   The major feature of splay trees is that all basic tree operations
-   are amortized O(log n) time for a tree with n nodes.  */
+   Despite the name, the tree is no longer splayed: it is kept balanced
+   as a treap, whose heap priority is a hash of each node's address, so
+   that no extra field is needed.  All basic tree operations are expected
+   O(log n) time regardless of the order of insertions, and unlike with
+   splaying, splay_tree_lookup never modifies the tree, so looking up the
+   same few nodes over and over doesn't dirty them, and lookups could
+   safely run in parallel with each other.  */
 
 #include "libgomp.h"
 
-/* Rotate the edge joining the left child N with its parent P.  PP is the
-   grandparents' pointer to P.  */
-
-static inline void
-rotate_left (splay_tree_node *pp, splay_tree_node p, splay_tree_node n)
-{
-  splay_tree_node tmp;
-  tmp = n->right;
-  n->right = p;
-  p->left = tmp;
-  *pp = n;
-}
-
-/* Rotate the edge joining the right child N with its parent P.  PP is the
-   grandparents' pointer to P.  */
+/* Return the heap priority of NODE, a mix of its address bits, so that
+   the nodes allocated next to each other, e.g. from one array, still
+   get unrelated priorities.  */
 
-static inline void
-rotate_right (splay_tree_node *pp, splay_tree_node p, splay_tree_node n)
+static inline uintptr_t
+splay_tree_priority (splay_tree_node node)
 {
-  splay_tree_node tmp;
-  tmp = n->left;
-  n->left = p;
-  p->right = tmp;
-  *pp = n;
-}
-
-/* Bottom up splay of KEY.  */
-
-static void
-splay_tree_splay (splay_tree sp, splay_tree_key key)
-{
-  if (sp->root == NULL)
-    return;
-
-  do {
-    int cmp1, cmp2;
-    splay_tree_node n, c;
-
-    n = sp->root;
-    cmp1 = splay_compare (key, &n->key);
-
-    /* Found.  */
-    if (cmp1 == 0)
-      return;
-
-    /* Left or right?  If no child, then we're done.  */
-    if (cmp1 < 0)
-      c = n->left;
-    else
-      c = n->right;
-    if (!c)
-      return;
-
-    /* Next one left or right?  If found or no child, we're done
-       after one rotation.  */
-    cmp2 = splay_compare (key, &c->key);
-    if (cmp2 == 0
-	|| (cmp2 < 0 && !c->left)
-	|| (cmp2 > 0 && !c->right))
-      {
-	if (cmp1 < 0)
-	  rotate_left (&sp->root, n, c);
-	else
-	  rotate_right (&sp->root, n, c);
-	return;
-      }
-
-    /* Now we have the four cases of double-rotation.  */
-    if (cmp1 < 0 && cmp2 < 0)
-      {
-	rotate_left (&n->left, c, c->left);
-	rotate_left (&sp->root, n, n->left);
-      }
-    else if (cmp1 > 0 && cmp2 > 0)
-      {
-	rotate_right (&n->right, c, c->right);
-	rotate_right (&sp->root, n, n->right);
-      }
-    else if (cmp1 < 0 && cmp2 > 0)
-      {
-	rotate_right (&n->left, c, c->right);
-	rotate_left (&sp->root, n, n->left);
-      }
-    else if (cmp1 > 0 && cmp2 < 0)
-      {
-	rotate_left (&n->right, c, c->left);
-	rotate_right (&sp->root, n, n->right);
-      }
-  } while (1);
+  unsigned long long x = (uintptr_t) node;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return (uintptr_t) x;
 }
 
 /* Insert a new NODE into SP.  The NODE shouldn't exist in the tree.  */
@@ -134,35 +59,44 @@ splay_tree_splay (splay_tree sp, splay_tree_key key)
 attribute_hidden void
 splay_tree_insert (splay_tree sp, splay_tree_node node)
 {
-  int comparison = 0;
-
-  splay_tree_splay (sp, &node->key);
+  uintptr_t prio = splay_tree_priority (node);
+  splay_tree_node *pp = &sp->root, *lp, *rp, n;
+  int comparison;
 
-  if (sp->root)
-    comparison = splay_compare (&sp->root->key, &node->key);
+  /* Walk down to where NODE belongs in heap order.  */
+  while ((n = *pp) != NULL && splay_tree_priority (n) > prio)
+    {
+      comparison = splay_compare (&node->key, &n->key);
+      if (comparison == 0)
+	gomp_fatal ("Duplicate node");
+      pp = comparison < 0 ? &n->left : &n->right;
+    }
 
-  if (sp->root && comparison == 0)
-    gomp_fatal ("Duplicate node");
-  else
+  /* Put NODE there and split the subtree previously rooted there
+     into NODE's left and right subtrees.  */
+  *pp = node;
+  lp = &node->left;
+  rp = &node->right;
+  while (n)
     {
-      /* Insert it at the root.  */
-      if (sp->root == NULL)
-	node->left = node->right = NULL;
-      else if (comparison < 0)
+      comparison = splay_compare (&node->key, &n->key);
+      if (comparison == 0)
+	gomp_fatal ("Duplicate node");
+      if (comparison < 0)
 	{
-	  node->left = sp->root;
-	  node->right = node->left->right;
-	  node->left->right = NULL;
+	  *rp = n;
+	  rp = &n->left;
+	  n = n->left;
 	}
       else
 	{
-	  node->right = sp->root;
-	  node->left = node->right->left;
-	  node->right->left = NULL;
+	  *lp = n;
+	  lp = &n->right;
+	  n = n->right;
 	}
-
-      sp->root = node;
     }
+  *lp = NULL;
+  *rp = NULL;
 }
 
 /* Remove node with KEY from SP.  It is not an error if it did not exist.  */
@@ -170,33 +104,32 @@ splay_tree_insert (splay_tree sp, splay_tree_node node)
 attribute_hidden void
 splay_tree_remove (splay_tree sp, splay_tree_key key)
 {
-  splay_tree_splay (sp, key);
+  splay_tree_node *pp = &sp->root, n, left, right;
+  int comparison;
 
-  if (sp->root && splay_compare (&sp->root->key, key) == 0)
-    {
-      splay_tree_node left, right;
-
-      left = sp->root->left;
-      right = sp->root->right;
+  while ((n = *pp) != NULL && (comparison = splay_compare (key, &n->key)))
+    pp = comparison < 0 ? &n->left : &n->right;
+  if (n == NULL)
+    return;
 
-      /* One of the children is now the root.  Doesn't matter much
-	 which, so long as we preserve the properties of the tree.  */
-      if (left)
-	{
-	  sp->root = left;
-
-	  /* If there was a right child as well, hang it off the
-	     right-most leaf of the left child.  */
-	  if (right)
-	    {
-	      while (left->right)
-		left = left->right;
-	      left->right = right;
-	    }
-	}
-      else
-	sp->root = right;
-    }
+  /* Merge the two children in heap order; all keys in LEFT are smaller
+     than all keys in RIGHT.  */
+  left = n->left;
+  right = n->right;
+  while (left && right)
+    if (splay_tree_priority (left) > splay_tree_priority (right))
+      {
+	*pp = left;
+	pp = &left->right;
+	left = left->right;
+      }
+    else
+      {
+	*pp = right;
+	pp = &right->left;
+	right = right->left;
+      }
+  *pp = left ? left : right;
 }
 
 /* Lookup KEY in SP, returning NODE if present, and NULL
@@ -205,12 +138,16 @@ splay_tree_remove (splay_tree sp, splay_tree_key key)
 attribute_hidden splay_tree_key
 splay_tree_lookup (splay_tree sp, splay_tree_key key)
 {
-  splay_tree_splay (sp, key);
+  splay_tree_node n = sp->root;
 
-  if (sp->root && splay_compare (&sp->root->key, key) == 0)
-    return &sp->root->key;
-  else
-    return NULL;
+  while (n)
+    {
+      int comparison = splay_compare (key, &n->key);
+      if (comparison == 0)
+	return &n->key;
+      n = comparison < 0 ? n->left : n->right;
+    }
+  return NULL;
 }
 
 /* Helper function for splay_tree_foreach.
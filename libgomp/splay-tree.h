@@ -45,13 +45,10 @@ typedef struct splay_tree_key_s *splay_tree_key;
    define the macro splay_tree_c.  See the include of splay-tree.h in
    priority_queue.[hc] for an example.  */
 
-/* For an easily readable description of splay-trees, see:
-
-     Lewis, Harry R. and Denenberg, Larry.  Data Structures and Their
-     Algorithms.  Harper-Collins, Inc.  1991.
-
-   The major feature of splay trees is that all basic tree operations
-   are amortized O(log n) time for a tree with n nodes.  */
+/* The tree is actually balanced as a treap rather than splayed, see
+   splay-tree.c.  All basic tree operations are expected O(log n) time
+   for a tree with n nodes, and splay_tree_lookup doesn't modify the
+   tree.  */
 
 #ifdef splay_tree_prefix
 # define splay_tree_name_1(prefix, name) prefix ## _ ## name
@@ -162,6 +162,30 @@ gomp_map_0len_lookup (splay_tree mem_map, splay_tree_key key)
   return n;
 }
 
+/* Report a data operation of OPTYPE on DEVICEP to an OMPT tool.
+   Host addresses are reported with the GOMP_DEVICE_HOST_FALLBACK
+   device number.  */
+
+static void
+gomp_ompt_target_data_op (struct gomp_device_descr *devicep,
+			  ompt_target_data_op_t optype,
+			  const void *src_addr, bool src_dev,
+			  void *dest_addr, bool dest_dev, size_t bytes)
+{
+  ompt_callback_target_data_op_t target_data_op
+    = gomp_ompt_callback (target_data_op);
+  int dev_num = -1;
+
+  if (target_data_op == NULL)
+    return;
+  if (devicep >= devices && devicep < devices + num_devices)
+    dev_num = devicep - devices;
+  target_data_op (0, gomp_ompt_next_op_id (), optype, (void *) src_addr,
+		  src_dev ? dev_num : GOMP_DEVICE_HOST_FALLBACK, dest_addr,
+		  dest_dev ? dev_num : GOMP_DEVICE_HOST_FALLBACK, bytes,
+		  NULL);
+}
+
 static inline void
 gomp_device_copy (struct gomp_device_descr *devicep,
 		  bool (*copy_func) (int, void *, const void *, size_t),
@@ -177,24 +201,363 @@ gomp_device_copy (struct gomp_device_descr *devicep,
     }
 }
 
+/* Infrastructure for coalescing host to device memory transfers which
+   are adjacent or nearly adjacent in device addresses, so that mapping
+   many small variables doesn't result in one host2dev_func call, and
+   therefore one device round trip, for each of them.  */
+
+struct gomp_coalesce_buf
+{
+  /* Buffer into which gomp_copy_host2dev memcpys the data and from which
+     it is later copied to the device.  */
+  void *buf;
+  struct target_mem_desc *tgt;
+  /* Array with offsets, chunks[2 * i] is the starting offset and
+     chunks[2 * i + 1] the ending offset relative to the tgt->tgt_start
+     device address of chunks which are to be copied to buf and later
+     copied to the device.  */
+  size_t *chunks;
+  /* Number of chunks in the chunks array, or -1 if coalescing should not
+     be performed.  */
+  long chunk_cnt;
+  /* During construction of the chunks array, how many memory regions are
+     within the last chunk.  If there is just one memory region in a chunk,
+     it is copied directly to the device rather than going through buf.  */
+  long use_cnt;
+};
+
+/* Maximum size of a memory region considered for coalescing.  Larger
+   copies are performed directly.  */
+#define MAX_COALESCE_BUF_SIZE	(32 * 1024)
+
+/* Maximum size of a gap in between regions for them to be still copied
+   within the same chunk.  All the device offsets considered are within
+   newly allocated device memory, so it isn't fatal if some padding in
+   between is copied from host to device too.  The gaps come either from
+   alignment padding or from memory regions which are not supposed to be
+   copied from host to device (e.g. map(alloc:), map(from:) etc.).  */
+#define MAX_COALESCE_BUF_GAP	(4 * 1024)
+
+/* Add region with device tgt_start relative offset START and length LEN
+   to CBUF.  */
+
+static inline void
+gomp_coalesce_buf_add (struct gomp_coalesce_buf *cbuf, size_t start,
+		       size_t len)
+{
+  if (len > MAX_COALESCE_BUF_SIZE || len == 0)
+    return;
+  if (cbuf->chunk_cnt)
+    {
+      if (cbuf->chunk_cnt < 0)
+	return;
+      if (start < cbuf->chunks[2 * cbuf->chunk_cnt - 1])
+	{
+	  cbuf->chunk_cnt = -1;
+	  return;
+	}
+      if (start < cbuf->chunks[2 * cbuf->chunk_cnt - 1] + MAX_COALESCE_BUF_GAP)
+	{
+	  cbuf->chunks[2 * cbuf->chunk_cnt - 1] = start + len;
+	  cbuf->use_cnt++;
+	  return;
+	}
+      /* If the last chunk is only used by one mapping, discard it,
+	 as it will be one host to device copy anyway and
+	 memcpying it around will only waste cycles.  */
+      if (cbuf->use_cnt == 1)
+	cbuf->chunk_cnt--;
+    }
+  cbuf->chunks[2 * cbuf->chunk_cnt] = start;
+  cbuf->chunks[2 * cbuf->chunk_cnt + 1] = start + len;
+  cbuf->chunk_cnt++;
+  cbuf->use_cnt = 1;
+}
+
+/* Return true for mapping kinds which need to copy data from the
+   host to device for regions that weren't previously mapped.  */
+
+static inline bool
+gomp_to_device_kind_p (int kind)
+{
+  switch (kind)
+    {
+    case GOMP_MAP_ALLOC:
+    case GOMP_MAP_FROM:
+    case GOMP_MAP_FORCE_ALLOC:
+    case GOMP_MAP_FORCE_FROM:
+    case GOMP_MAP_ALWAYS_FROM:
+      return false;
+    default:
+      return true;
+    }
+}
+
+/* Copy SZ bytes from host address H to device address D.  If CBUF is
+   non-NULL and D falls into one of its chunks, just stash the data into
+   the coalescing buffer; it is sent to the device by
+   gomp_coalesce_buf_flush.  */
+
 static void
 gomp_copy_host2dev (struct gomp_device_descr *devicep,
-		    void *d, const void *h, size_t sz)
+		    void *d, const void *h, size_t sz,
+		    struct gomp_coalesce_buf *cbuf)
 {
+  if (cbuf)
+    {
+      uintptr_t doff = (uintptr_t) d - cbuf->tgt->tgt_start;
+      if (doff < cbuf->chunks[2 * cbuf->chunk_cnt - 1])
+	{
+	  long first = 0;
+	  long last = cbuf->chunk_cnt - 1;
+	  while (first <= last)
+	    {
+	      long middle = (first + last) >> 1;
+	      if (cbuf->chunks[2 * middle + 1] <= doff)
+		first = middle + 1;
+	      else if (cbuf->chunks[2 * middle] <= doff)
+		{
+		  if (doff + sz > cbuf->chunks[2 * middle + 1])
+		    {
+		      gomp_mutex_unlock (&devicep->lock);
+		      gomp_fatal ("internal libgomp cbuf error");
+		    }
+		  memcpy ((char *) cbuf->buf + (doff - cbuf->chunks[0]),
+			  h, sz);
+		  return;
+		}
+	      else
+		last = middle - 1;
+	    }
+	}
+    }
+  gomp_ompt_target_data_op (devicep, ompt_target_data_transfer_to_device,
+			    h, false, d, true, sz);
   gomp_device_copy (devicep, devicep->host2dev_func, "dev", d, "host", h, sz);
 }
 
+/* Send all the chunks collected in CBUF to the device and release
+   the buffer.  */
+
+static void
+gomp_coalesce_buf_flush (struct gomp_device_descr *devicep,
+			 struct gomp_coalesce_buf *cbuf)
+{
+  long c;
+  for (c = 0; c < cbuf->chunk_cnt; ++c)
+    gomp_copy_host2dev (devicep,
+			(void *) (cbuf->tgt->tgt_start + cbuf->chunks[2 * c]),
+			(char *) cbuf->buf + (cbuf->chunks[2 * c]
+					      - cbuf->chunks[0]),
+			cbuf->chunks[2 * c + 1] - cbuf->chunks[2 * c], NULL);
+  free (cbuf->buf);
+}
+
 static void
 gomp_copy_dev2host (struct gomp_device_descr *devicep,
 		    void *h, const void *d, size_t sz)
 {
+  gomp_ompt_target_data_op (devicep, ompt_target_data_transfer_from_device,
+			    d, true, h, false, sz);
   gomp_device_copy (devicep, devicep->dev2host_func, "host", h, "dev", d, sz);
 }
 
+/* Device memory cache.  Allocating and freeing device memory through the
+   plugin can be expensive (e.g. cuMemAlloc and cuMemFree synchronize the
+   device), and target data regions entered in a loop allocate and free
+   blocks of the same sizes over and over.  Blocks of up to
+   GOMP_DEVICE_MEM_MAX_CACHED bytes are therefore rounded up to one of
+   GOMP_DEVICE_MEM_CLASSES size classes, four per power of two, and
+   when released kept on per-class free lists for reuse, as long as no
+   more than GOMP_DEVICE_MEM_CACHE_LIMIT bytes are cached in total.  The
+   cache is trimmed when the device runs out of memory and dropped when
+   the device is finalized.  Everything here is protected by
+   devicep->lock.  */
+
+#define GOMP_DEVICE_MEM_MIN_CLASS	256
+#define GOMP_DEVICE_MEM_MAX_CACHED	((size_t) 64 * 1024 * 1024)
+#define GOMP_DEVICE_MEM_CACHE_LIMIT	((size_t) 256 * 1024 * 1024)
+
+/* Return the size class of a SIZE bytes allocation and store the size
+   of that class to *ROUNDED, or return -1 if SIZE is not cached.  */
+
+static int
+gomp_device_mem_class (size_t size, size_t *rounded)
+{
+  unsigned int m;
+  size_t step;
+
+  if (size <= GOMP_DEVICE_MEM_MIN_CLASS)
+    {
+      *rounded = GOMP_DEVICE_MEM_MIN_CLASS;
+      return 0;
+    }
+  if (size > GOMP_DEVICE_MEM_MAX_CACHED)
+    return -1;
+  /* 2^M < SIZE <= 2^(M+1); split that range into four classes.  */
+  m = sizeof (unsigned long) * CHAR_BIT - 1
+      - __builtin_clzl ((unsigned long) (size - 1));
+  step = (size_t) 1 << (m - 2);
+  *rounded = ((size - 1) | (step - 1)) + 1;
+  return (m - 8) * 4 + ((*rounded - ((size_t) 1 << m)) >> (m - 2));
+}
+
+static inline struct gomp_device_mem_block **
+gomp_device_mem_bucket (struct gomp_device_mem_cache *cache, void *ptr)
+{
+  uintptr_t p = (uintptr_t) ptr;
+  return &cache->live[((p >> 8) ^ (p >> 16)) & (GOMP_DEVICE_MEM_HASH - 1)];
+}
+
+/* Release all cached device memory blocks of DEVICEP.  */
+
+static void
+gomp_device_mem_cache_trim (struct gomp_device_descr *devicep)
+{
+  struct gomp_device_mem_cache *cache = &devicep->mem_cache;
+  int i;
+
+  for (i = 0; i < GOMP_DEVICE_MEM_CLASSES; i++)
+    while (cache->free_list[i])
+      {
+	struct gomp_device_mem_block *b = cache->free_list[i];
+	cache->free_list[i] = b->next;
+	if (!devicep->free_func (devicep->target_id, b->ptr))
+	  {
+	    gomp_mutex_unlock (&devicep->lock);
+	    gomp_fatal ("error in freeing device memory block at %p", b->ptr);
+	  }
+	b->next = cache->spare;
+	cache->spare = b;
+      }
+  cache->cached_bytes = 0;
+}
+
+/* Allocate SIZE bytes of device memory on DEVICEP, reusing a cached
+   block if possible.  Return NULL on failure.  */
+
+static void *
+gomp_device_alloc_1 (struct gomp_device_descr *devicep, size_t size)
+{
+  struct gomp_device_mem_cache *cache = &devicep->mem_cache;
+  struct gomp_device_mem_block *b, **bucket;
+  size_t rounded;
+  int cls;
+  void *ptr;
+
+  if (size == 0 || (devicep->capabilities & GOMP_OFFLOAD_CAP_SHARED_MEM))
+    return devicep->alloc_func (devicep->target_id, size);
+
+  cls = gomp_device_mem_class (size, &rounded);
+  if (cls < 0)
+    rounded = size;
+  else if ((b = cache->free_list[cls]) != NULL)
+    {
+      cache->free_list[cls] = b->next;
+      cache->cached_bytes -= b->size;
+      goto found;
+    }
+
+  ptr = devicep->alloc_func (devicep->target_id, rounded);
+  if (ptr == NULL && cache->cached_bytes)
+    {
+      /* The cached blocks might be what the device is missing.  */
+      gomp_device_mem_cache_trim (devicep);
+      ptr = devicep->alloc_func (devicep->target_id, rounded);
+    }
+  if (ptr == NULL || cls < 0)
+    return ptr;
+
+  b = cache->spare;
+  if (b)
+    cache->spare = b->next;
+  else
+    b = gomp_malloc (sizeof (*b));
+  b->ptr = ptr;
+  b->size = rounded;
+
+ found:
+  bucket = gomp_device_mem_bucket (cache, b->ptr);
+  b->next = *bucket;
+  *bucket = b;
+  return b->ptr;
+}
+
+attribute_hidden void *
+gomp_device_alloc (struct gomp_device_descr *devicep, size_t size)
+{
+  void *ptr = gomp_device_alloc_1 (devicep, size);
+  if (ptr)
+    gomp_ompt_target_data_op (devicep, ompt_target_data_alloc,
+			      NULL, false, ptr, true, size);
+  return ptr;
+}
+
+/* Release device memory block PTR allocated by gomp_device_alloc on
+   DEVICEP, either into the cache or back to the device.  Return false
+   if the plugin failed to free it.  */
+
+attribute_hidden bool
+gomp_device_free (struct gomp_device_descr *devicep, void *ptr)
+{
+  struct gomp_device_mem_cache *cache = &devicep->mem_cache;
+  struct gomp_device_mem_block *b, **pb;
+
+  gomp_ompt_target_data_op (devicep, ompt_target_data_delete,
+			    ptr, true, NULL, false, 0);
+  if (devicep->capabilities & GOMP_OFFLOAD_CAP_SHARED_MEM)
+    return devicep->free_func (devicep->target_id, ptr);
+
+  for (pb = gomp_device_mem_bucket (cache, ptr); (b = *pb); pb = &b->next)
+    if (b->ptr == ptr)
+      {
+	*pb = b->next;
+	if (cache->cached_bytes + b->size <= GOMP_DEVICE_MEM_CACHE_LIMIT)
+	  {
+	    size_t rounded;
+	    int cls = gomp_device_mem_class (b->size, &rounded);
+	    b->next = cache->free_list[cls];
+	    cache->free_list[cls] = b;
+	    cache->cached_bytes += b->size;
+	    return true;
+	  }
+	b->next = cache->spare;
+	cache->spare = b;
+	break;
+      }
+
+  return devicep->free_func (devicep->target_id, ptr);
+}
+
+/* Drop the device memory cache of DEVICEP before the device is
+   finalized.  Blocks still in use are forgotten, the device frees them
+   along with everything else.  */
+
+attribute_hidden void
+gomp_device_mem_cache_fini (struct gomp_device_descr *devicep)
+{
+  struct gomp_device_mem_cache *cache = &devicep->mem_cache;
+  struct gomp_device_mem_block *b;
+  int i;
+
+  gomp_device_mem_cache_trim (devicep);
+  for (i = 0; i < GOMP_DEVICE_MEM_HASH; i++)
+    while ((b = cache->live[i]) != NULL)
+      {
+	cache->live[i] = b->next;
+	free (b);
+      }
+  while ((b = cache->spare) != NULL)
+    {
+      cache->spare = b->next;
+      free (b);
+    }
+}
+
 static void
 gomp_free_device_memory (struct gomp_device_descr *devicep, void *devptr)
 {
-  if (!devicep->free_func (devicep->target_id, devptr))
+  if (!gomp_device_free (devicep, devptr))
     {
       gomp_mutex_unlock (&devicep->lock);
       gomp_fatal ("error in freeing device memory block at %p", devptr);
@@ -208,7 +571,7 @@ gomp_free_device_memory (struct gomp_device_descr *devicep, void *devptr)
 static inline void
 gomp_map_vars_existing (struct gomp_device_descr *devicep, splay_tree_key oldn,
 			splay_tree_key newn, struct target_var_desc *tgt_var,
-			unsigned char kind)
+			unsigned char kind, struct gomp_coalesce_buf *cbuf)
 {
   tgt_var->key = oldn;
   tgt_var->copy_from = GOMP_MAP_COPY_FROM_P (kind);
@@ -232,7 +595,7 @@ gomp_map_vars_existing (struct gomp_device_descr *devicep, splay_tree_key oldn,
 			(void *) (oldn->tgt->tgt_start + oldn->tgt_offset
 				  + newn->host_start - oldn->host_start),
 			(void *) newn->host_start,
-			newn->host_end - newn->host_start);
+			newn->host_end - newn->host_start, cbuf);
 
   if (oldn->refcount != REFCOUNT_INFINITY)
     oldn->refcount++;
@@ -247,7 +610,8 @@ get_kind (bool short_mapkind, void *kinds, int idx)
 
 static void
 gomp_map_pointer (struct target_mem_desc *tgt, uintptr_t host_ptr,
-		  uintptr_t target_offset, uintptr_t bias)
+		  uintptr_t target_offset, uintptr_t bias,
+		  struct gomp_coalesce_buf *cbuf)
 {
   struct gomp_device_descr *devicep = tgt->device_descr;
   struct splay_tree_s *mem_map = &devicep->mem_map;
@@ -257,11 +621,10 @@ gomp_map_pointer (struct target_mem_desc *tgt, uintptr_t host_ptr,
   if (cur_node.host_start == (uintptr_t) NULL)
     {
       cur_node.tgt_offset = (uintptr_t) NULL;
-      /* FIXME: see comment about coalescing host/dev transfers below.  */
       gomp_copy_host2dev (devicep,
 			  (void *) (tgt->tgt_start + target_offset),
 			  (void *) &cur_node.tgt_offset,
-			  sizeof (void *));
+			  sizeof (void *), cbuf);
       return;
     }
   /* Add bias to the pointer value.  */
@@ -280,15 +643,15 @@ gomp_map_pointer (struct target_mem_desc *tgt, uintptr_t host_ptr,
      array section.  Now subtract bias to get what we want
      to initialize the pointer with.  */
   cur_node.tgt_offset -= bias;
-  /* FIXME: see comment about coalescing host/dev transfers below.  */
   gomp_copy_host2dev (devicep, (void *) (tgt->tgt_start + target_offset),
-		      (void *) &cur_node.tgt_offset, sizeof (void *));
+		      (void *) &cur_node.tgt_offset, sizeof (void *), cbuf);
 }
 
 static void
 gomp_map_fields_existing (struct target_mem_desc *tgt, splay_tree_key n,
 			  size_t first, size_t i, void **hostaddrs,
-			  size_t *sizes, void *kinds)
+			  size_t *sizes, void *kinds,
+			  struct gomp_coalesce_buf *cbuf)
 {
   struct gomp_device_descr *devicep = tgt->device_descr;
   struct splay_tree_s *mem_map = &devicep->mem_map;
@@ -306,7 +669,7 @@ gomp_map_fields_existing (struct target_mem_desc *tgt, splay_tree_key n,
       && n2->host_start - n->host_start == n2->tgt_offset - n->tgt_offset)
     {
       gomp_map_vars_existing (devicep, n2, &cur_node,
-			      &tgt->list[i], kind & typemask);
+			      &tgt->list[i], kind & typemask, cbuf);
       return;
     }
   if (sizes[i] == 0)
@@ -322,7 +685,7 @@ gomp_map_fields_existing (struct target_mem_desc *tgt, splay_tree_key n,
 		 == n2->tgt_offset - n->tgt_offset)
 	    {
 	      gomp_map_vars_existing (devicep, n2, &cur_node, &tgt->list[i],
-				      kind & typemask);
+				      kind & typemask, cbuf);
 	      return;
 	    }
 	}
@@ -334,7 +697,7 @@ gomp_map_fields_existing (struct target_mem_desc *tgt, splay_tree_key n,
 	  && n2->host_start - n->host_start == n2->tgt_offset - n->tgt_offset)
 	{
 	  gomp_map_vars_existing (devicep, n2, &cur_node, &tgt->list[i],
-				  kind & typemask);
+				  kind & typemask, cbuf);
 	  return;
 	}
     }
@@ -378,6 +741,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
   struct splay_tree_key_s cur_node;
   struct target_mem_desc *tgt
     = gomp_malloc (sizeof (*tgt) + sizeof (tgt->list[0]) * mapnum);
+  struct gomp_coalesce_buf cbuf, *cbufp = NULL;
   tgt->list_count = mapnum;
   tgt->refcount = pragma_kind == GOMP_MAP_VARS_ENTER_DATA ? 0 : 1;
   tgt->device_descr = devicep;
@@ -391,11 +755,25 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 
   tgt_align = sizeof (void *);
   tgt_size = 0;
+  cbuf.chunks = NULL;
+  cbuf.chunk_cnt = -1;
+  cbuf.use_cnt = 0;
+  cbuf.buf = NULL;
+  if (mapnum > 1 || pragma_kind == GOMP_MAP_VARS_TARGET)
+    {
+      cbuf.chunks
+	= (size_t *) gomp_alloca ((2 * mapnum + 2) * sizeof (size_t));
+      cbuf.chunk_cnt = 0;
+    }
   if (pragma_kind == GOMP_MAP_VARS_TARGET)
     {
       size_t align = 4 * sizeof (void *);
       tgt_align = align;
       tgt_size = mapnum * sizeof (void *);
+      cbuf.chunk_cnt = 1;
+      cbuf.use_cnt = 1 + (mapnum > 1);
+      cbuf.chunks[0] = 0;
+      cbuf.chunks[1] = tgt_size;
     }
 
   gomp_mutex_lock (&devicep->lock);
@@ -455,13 +833,21 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 	      tgt_size += cur_node.host_end - (uintptr_t) hostaddrs[i];
 	      not_found_cnt += last - i;
 	      for (i = first; i <= last; i++)
-		tgt->list[i].key = NULL;
+		{
+		  tgt->list[i].key = NULL;
+		  if (gomp_to_device_kind_p (get_kind (short_mapkind, kinds, i)
+					     & typemask))
+		    gomp_coalesce_buf_add (&cbuf,
+					   tgt_size - cur_node.host_end
+					   + (uintptr_t) hostaddrs[i],
+					   sizes[i]);
+		}
 	      i--;
 	      continue;
 	    }
 	  for (i = first; i <= last; i++)
 	    gomp_map_fields_existing (tgt, n, first, i, hostaddrs,
-				      sizes, kinds);
+				      sizes, kinds, NULL);
 	  i--;
 	  continue;
 	}
@@ -485,6 +871,8 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 	  if (tgt_align < align)
 	    tgt_align = align;
 	  tgt_size = (tgt_size + align - 1) & ~(align - 1);
+	  gomp_coalesce_buf_add (&cbuf, tgt_size,
+				 cur_node.host_end - cur_node.host_start);
 	  tgt_size += cur_node.host_end - cur_node.host_start;
 	  has_firstprivate = true;
 	  continue;
@@ -504,7 +892,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 	n = splay_tree_lookup (mem_map, &cur_node);
       if (n && n->refcount != REFCOUNT_LINK)
 	gomp_map_vars_existing (devicep, n, &cur_node, &tgt->list[i],
-				kind & typemask);
+				kind & typemask, NULL);
       else
 	{
 	  tgt->list[i].key = NULL;
@@ -514,6 +902,9 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 	  if (tgt_align < align)
 	    tgt_align = align;
 	  tgt_size = (tgt_size + align - 1) & ~(align - 1);
+	  if (gomp_to_device_kind_p (kind & typemask))
+	    gomp_coalesce_buf_add (&cbuf, tgt_size,
+				   cur_node.host_end - cur_node.host_start);
 	  tgt_size += cur_node.host_end - cur_node.host_start;
 	  if ((kind & typemask) == GOMP_MAP_TO_PSET)
 	    {
@@ -551,8 +942,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
       /* Allocate tgt_align aligned tgt_size block of memory.  */
       /* FIXME: Perhaps change interface to allocate properly aligned
 	 memory.  */
-      tgt->to_free = devicep->alloc_func (devicep->target_id,
-					  tgt_size + tgt_align - 1);
+      tgt->to_free = gomp_device_alloc (devicep, tgt_size + tgt_align - 1);
       if (!tgt->to_free)
 	{
 	  gomp_mutex_unlock (&devicep->lock);
@@ -562,6 +952,19 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
       tgt->tgt_start = (uintptr_t) tgt->to_free;
       tgt->tgt_start = (tgt->tgt_start + tgt_align - 1) & ~(tgt_align - 1);
       tgt->tgt_end = tgt->tgt_start + tgt_size;
+
+      if (cbuf.use_cnt == 1)
+	cbuf.chunk_cnt--;
+      if (cbuf.chunk_cnt > 0)
+	{
+	  cbuf.buf
+	    = malloc (cbuf.chunks[2 * cbuf.chunk_cnt - 1] - cbuf.chunks[0]);
+	  if (cbuf.buf)
+	    {
+	      cbuf.tgt = tgt;
+	      cbufp = &cbuf;
+	    }
+	}
     }
   else
     {
@@ -600,7 +1003,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 		len = sizes[i];
 		gomp_copy_host2dev (devicep,
 				    (void *) (tgt->tgt_start + tgt_size),
-				    (void *) hostaddrs[i], len);
+				    (void *) hostaddrs[i], len, cbufp);
 		tgt_size += len;
 		continue;
 	      case GOMP_MAP_FIRSTPRIVATE_INT:
@@ -633,7 +1036,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 		  }
 		for (i = first; i <= last; i++)
 		  gomp_map_fields_existing (tgt, n, first, i, hostaddrs,
-					    sizes, kinds);
+					    sizes, kinds, cbufp);
 		i--;
 		continue;
 	      case GOMP_MAP_ALWAYS_POINTER:
@@ -658,7 +1061,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 					      + cur_node.host_start
 					      - n->host_start),
 				    (void *) &cur_node.tgt_offset,
-				    sizeof (void *));
+				    sizeof (void *), cbufp);
 		cur_node.tgt_offset = n->tgt->tgt_start + n->tgt_offset
 				      + cur_node.host_start - n->host_start;
 		continue;
@@ -674,7 +1077,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 	    splay_tree_key n = splay_tree_lookup (mem_map, k);
 	    if (n && n->refcount != REFCOUNT_LINK)
 	      gomp_map_vars_existing (devicep, n, k, &tgt->list[i],
-				      kind & typemask);
+				      kind & typemask, cbufp);
 	    else
 	      {
 		k->link_key = NULL;
@@ -725,26 +1128,22 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 		  case GOMP_MAP_FORCE_TOFROM:
 		  case GOMP_MAP_ALWAYS_TO:
 		  case GOMP_MAP_ALWAYS_TOFROM:
-		    /* FIXME: Perhaps add some smarts, like if copying
-		       several adjacent fields from host to target, use some
-		       host buffer to avoid sending each var individually.  */
 		    gomp_copy_host2dev (devicep,
 					(void *) (tgt->tgt_start
 						  + k->tgt_offset),
 					(void *) k->host_start,
-					k->host_end - k->host_start);
+					k->host_end - k->host_start, cbufp);
 		    break;
 		  case GOMP_MAP_POINTER:
 		    gomp_map_pointer (tgt, (uintptr_t) *(void **) k->host_start,
-				      k->tgt_offset, sizes[i]);
+				      k->tgt_offset, sizes[i], cbufp);
 		    break;
 		  case GOMP_MAP_TO_PSET:
-		    /* FIXME: see above FIXME comment.  */
 		    gomp_copy_host2dev (devicep,
 					(void *) (tgt->tgt_start
 						  + k->tgt_offset),
 					(void *) k->host_start,
-					k->host_end - k->host_start);
+					k->host_end - k->host_start, cbufp);
 
 		    for (j = i + 1; j < mapnum; j++)
 		      if (!GOMP_MAP_POINTER_P (get_kind (short_mapkind, kinds,
@@ -767,7 +1166,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 					    k->tgt_offset
 					    + ((uintptr_t) hostaddrs[j]
 					       - k->host_start),
-					    sizes[j]);
+					    sizes[j], cbufp);
 			  i++;
 			}
 		    break;
@@ -795,7 +1194,7 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
 					(void *) (tgt->tgt_start
 						  + k->tgt_offset),
 					(void *) k->host_start,
-					sizeof (void *));
+					sizeof (void *), cbufp);
 		    break;
 		  default:
 		    gomp_mutex_unlock (&devicep->lock);
@@ -822,13 +1221,16 @@ gomp_map_vars (struct gomp_device_descr *devicep, size_t mapnum,
       for (i = 0; i < mapnum; i++)
 	{
 	  cur_node.tgt_offset = gomp_map_val (tgt, hostaddrs, i);
-	  /* FIXME: see above FIXME comment.  */
 	  gomp_copy_host2dev (devicep,
 			      (void *) (tgt->tgt_start + i * sizeof (void *)),
-			      (void *) &cur_node.tgt_offset, sizeof (void *));
+			      (void *) &cur_node.tgt_offset, sizeof (void *),
+			      cbufp);
 	}
     }
 
+  if (cbufp)
+    gomp_coalesce_buf_flush (devicep, cbufp);
+
   /* If the variable from "omp target enter data" map-list was already mapped,
      tgt is not needed.  Otherwise tgt will be freed by gomp_unmap_vars or
      gomp_exit_data.  */
@@ -970,7 +1372,7 @@ gomp_update (struct gomp_device_descr *devicep, size_t mapnum, void **hostaddrs,
 	    size_t size = cur_node.host_end - cur_node.host_start;
 
 	    if (GOMP_MAP_COPY_TO_P (kind & typemask))
-	      gomp_copy_host2dev (devicep, devaddr, hostaddr, size);
+	      gomp_copy_host2dev (devicep, devaddr, hostaddr, size, NULL);
 	    if (GOMP_MAP_COPY_FROM_P (kind & typemask))
 	      gomp_copy_dev2host (devicep, hostaddr, devaddr, size);
 	  }
@@ -1970,7 +2372,7 @@ omp_target_alloc (size_t size, int device_num)
     return malloc (size);
 
   gomp_mutex_lock (&devicep->lock);
-  void *ret = devicep->alloc_func (devicep->target_id, size);
+  void *ret = gomp_device_alloc (devicep, size);
   gomp_mutex_unlock (&devicep->lock);
   return ret;
 }
@@ -2465,6 +2867,7 @@ gomp_target_fini (void)
       gomp_mutex_lock (&devicep->lock);
       if (devicep->state == GOMP_DEVICE_INITIALIZED)
 	{
+	  gomp_device_mem_cache_fini (devicep);
 	  ret = devicep->fini_device_func (devicep->target_id);
 	  devicep->state = GOMP_DEVICE_FINALIZED;
 	}
@@ -2533,6 +2936,8 @@ gomp_target_init (void)
 		/* current_device.capabilities has already been set.  */
 		current_device.type = current_device.get_type_func ();
 		current_device.mem_map.root = NULL;
+		memset (&current_device.mem_cache, 0,
+			sizeof (current_device.mem_cache));
 		current_device.state = GOMP_DEVICE_UNINITIALIZED;
 		current_device.openacc.data_environ = NULL;
 		for (i = 0; i < new_num_devices; i++)
@@ -86,6 +86,49 @@ gomp_init_task (struct gomp_task *task, struct gomp_task *parent_task,
   task->dependers = NULL;
   task->depend_hash = NULL;
   task->depend_count = 0;
+  task->ompt_data.value = 0;
+}
+
+/* Report the creation of explicit task TASK with GOMP_TASK_FLAG_* FLAGS
+   by the current task of THR to an OMPT tool.  */
+
+static inline void
+gomp_ompt_task_create (struct gomp_thread *thr, struct gomp_task *task,
+		       unsigned flags, bool undeferred)
+{
+  ompt_callback_task_create_t task_create = gomp_ompt_callback (task_create);
+  if (task_create)
+    task_create (gomp_ompt_task_data (thr), NULL, &task->ompt_data,
+		 ompt_task_explicit
+		 | (undeferred ? ompt_task_undeferred : 0)
+		 | ((flags & GOMP_TASK_FLAG_UNTIED) ? ompt_task_untied : 0)
+		 | (task->final_task ? ompt_task_final : 0),
+		 (flags & GOMP_TASK_FLAG_DEPEND) != 0, NULL);
+}
+
+/* Report a switch from the task with OMPT data PRIOR to the one with
+   NEXT to an OMPT tool.  */
+
+static inline void
+gomp_ompt_task_schedule (ompt_data_t *prior, ompt_task_status_t status,
+			 ompt_data_t *next)
+{
+  ompt_callback_task_schedule_t task_schedule
+    = gomp_ompt_callback (task_schedule);
+  if (task_schedule)
+    task_schedule (prior, status, next);
+}
+
+/* Run the function of CHILD_TASK on behalf of TASK.  */
+
+static inline void
+gomp_task_run_fn (struct gomp_task *task, struct gomp_task *child_task)
+{
+  gomp_ompt_task_schedule (&task->ompt_data, ompt_task_switch,
+			   &child_task->ompt_data);
+  child_task->fn (child_task->fn_data);
+  gomp_ompt_task_schedule (&child_task->ompt_data, ompt_task_complete,
+			   &task->ompt_data);
 }
 
 /* Clean up a task, after completing it.  */
@@ -339,6 +382,9 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  task.in_tied_task = thr->task->in_tied_task;
 	  task.taskgroup = thr->task->taskgroup;
 	}
+      gomp_ompt_task_create (thr, &task, flags, true);
+      gomp_ompt_task_schedule (gomp_ompt_task_data (thr), ompt_task_switch,
+			       &task.ompt_data);
       thr->task = &task;
       if (__builtin_expect (cpyfn != NULL, 0))
 	{
@@ -366,6 +412,8 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  gomp_mutex_unlock (&team->task_lock);
 	}
       gomp_end_task ();
+      gomp_ompt_task_schedule (&task.ompt_data, ompt_task_complete,
+			       gomp_ompt_task_data (thr));
     }
   else
     {
@@ -401,6 +449,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       task->fn = fn;
       task->fn_data = arg;
       task->final_task = (flags & GOMP_TASK_FLAG_FINAL) >> 1;
+      gomp_ompt_task_create (thr, task, flags, false);
       gomp_mutex_lock (&team->task_lock);
       /* If parallel or taskgroup has been cancelled, don't start new
 	 tasks.  */
@@ -1193,6 +1242,15 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
   struct gomp_task *to_free = NULL;
   int do_wake = 0;
 
+  /* Threads woken for a task that some other thread has already
+     picked up would only take task_lock to find the queue empty.
+     Don't add to the contention on the lock in that case; the caller
+     rechecks the barrier generation and comes back here while
+     BAR_TASK_PENDING stays set.  */
+  if (!gomp_barrier_last_thread (state)
+      && priority_queue_empty_p (&team->task_queue, MEMMODEL_ACQUIRE))
+    return;
+
   gomp_mutex_lock (&team->task_lock);
   if (gomp_barrier_last_thread (state))
     {
@@ -1268,7 +1326,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    gomp_task_run_fn (task, child_task);
 	  thr->task = task;
 	}
       else
@@ -1329,6 +1387,8 @@ GOMP_taskwait (void)
       || priority_queue_empty_p (&task->children_queue, MEMMODEL_ACQUIRE))
     return;
 
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_taskwait,
+			      ompt_scope_begin);
   memset (&taskwait, 0, sizeof (taskwait));
   bool child_q = false;
   gomp_mutex_lock (&team->task_lock);
@@ -1347,6 +1407,8 @@ GOMP_taskwait (void)
 	    }
 	  if (destroy_taskwait)
 	    gomp_sem_destroy (&taskwait.taskwait_sem);
+	  gomp_ompt_sync_region_wait (thr, ompt_sync_region_taskwait,
+				      ompt_scope_end);
 	  return;
 	}
       struct gomp_task *next_task
@@ -1418,7 +1480,7 @@ GOMP_taskwait (void)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    gomp_task_run_fn (task, child_task);
 	  thr->task = task;
 	}
       else
@@ -1611,7 +1673,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    gomp_task_run_fn (task, child_task);
 	  thr->task = task;
 	}
       else
@@ -1675,6 +1737,8 @@ GOMP_taskgroup_start (void)
   taskgroup->cancelled = false;
   taskgroup->num_children = 0;
   gomp_sem_init (&taskgroup->taskgroup_sem, 0);
+  taskgroup->reductions
+    = taskgroup->prev ? taskgroup->prev->reductions : NULL;
   task->taskgroup = taskgroup;
 }
 
@@ -1807,7 +1871,7 @@ GOMP_taskgroup_end (void)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    gomp_task_run_fn (task, child_task);
 	  thr->task = task;
 	}
       else
@@ -1840,6 +1904,208 @@ GOMP_taskgroup_end (void)
   free (taskgroup);
 }
 
+/* Task reductions.  The compiler describes the task_reduction clauses
+   of a taskgroup with an array of uintptr_t:
+     data[0]	    number of reduction variables N
+     data[1]	    size of the private copies of all the variables
+		    for one thread, a multiple of data[2]
+     data[2]	    alignment of the private copies, replaced with the
+		    address of the privatized block by the runtime
+     data[3]	    reserved, -1
+     data[4]	    next array of the same taskgroup or NULL, replaced
+		    with the enclosing taskgroup's array by the runtime
+     data[5]	    runtime use, hash table of all the visible variables
+     data[6]	    runtime use, end of the privatized block
+   followed by N triplets, sorted by increasing offset:
+     data[7+3*i]	address of the original variable
+     data[7+3*i+1]	offset of its private copy within a thread's part
+     data[7+3*i+2]	runtime use, the array it belongs to
+   Each thread accumulates into its own zero initialized part of the
+   privatized block, so tasks never contend on the variables.  After
+   GOMP_taskgroup_end the compiler generated code initializes and
+   combines the parts into the original variables and then calls
+   GOMP_taskgroup_reduction_unregister.  */
+
+/* Allocate the privatized blocks of DATA for NTHREADS threads, chain
+   it to OLD and build the hash table of all the variables visible in
+   the taskgroup.  */
+
+static void
+gomp_reduction_register (uintptr_t *data, uintptr_t *old, unsigned nthreads)
+{
+  size_t total_cnt = 0, i;
+  uintptr_t *d = data;
+  struct htab *old_htab = NULL, *new_htab;
+
+  while (1)
+    {
+      size_t sz = d[1] * nthreads;
+      void *ptr = gomp_aligned_alloc (d[2], sz);
+      memset (ptr, '\0', sz);
+      d[2] = (uintptr_t) ptr;
+      d[6] = d[2] + sz;
+      d[5] = 0;
+      total_cnt += d[0];
+      if (d[4] == 0)
+	{
+	  d[4] = (uintptr_t) old;
+	  break;
+	}
+      d = (uintptr_t *) d[4];
+    }
+  if (old && old[5])
+    {
+      old_htab = (struct htab *) old[5];
+      total_cnt += htab_elements (old_htab);
+    }
+  new_htab = htab_create (total_cnt);
+  if (old_htab)
+    /* Inherit the variables of the enclosing taskgroups, the inner
+       ones are inserted later and so shadow them.  */
+    for (i = 0; i < old_htab->size; i++)
+      {
+	hash_entry_type n = old_htab->entries[i];
+	if (n != HTAB_EMPTY_ENTRY && n != HTAB_DELETED_ENTRY)
+	  *htab_find_slot (&new_htab, n, INSERT) = n;
+      }
+  d = data;
+  while (1)
+    {
+      for (i = 0; i < d[0]; i++)
+	{
+	  uintptr_t *p = d + 7 + i * 3;
+	  hash_entry_type n;
+	  p[2] = (uintptr_t) d;
+	  /* hash_entry_type is the task dependence entry, which like P
+	     starts with the address that is hashed and compared.  Hide
+	     the type punning from the compiler.  */
+	  __asm ("" : "=g" (n) : "0" (p));
+	  *htab_find_slot (&new_htab, n, INSERT) = n;
+	}
+      if (d[4] == (uintptr_t) old)
+	break;
+      d = (uintptr_t *) d[4];
+    }
+  data[5] = (uintptr_t) new_htab;
+}
+
+/* Register the task_reduction clauses of the current taskgroup described
+   by DATA.  */
+
+void
+GOMP_taskgroup_reduction_register (uintptr_t *data)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_team *team = thr->ts.team;
+  struct gomp_taskgroup *taskgroup;
+
+  /* Without a team all the tasks are run undeferred by this thread, see
+     GOMP_taskgroup_start.  */
+  if (team == NULL || thr->task->taskgroup == NULL)
+    {
+      gomp_reduction_register (data, thr->task_reductions, 1);
+      thr->task_reductions = data;
+      return;
+    }
+  taskgroup = thr->task->taskgroup;
+  gomp_reduction_register (data, taskgroup->reductions, team->nthreads);
+  taskgroup->reductions = data;
+}
+
+/* Release what GOMP_taskgroup_reduction_register allocated for DATA,
+   after its privatized blocks have been combined.  */
+
+void
+GOMP_taskgroup_reduction_unregister (uintptr_t *data)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  uintptr_t *d = data;
+
+  htab_free ((struct htab *) data[5]);
+  do
+    {
+      gomp_aligned_free ((void *) d[2]);
+      d = (uintptr_t *) d[4];
+    }
+  while (d && !d[5]);
+  if (thr->task_reductions == data)
+    thr->task_reductions = d;
+}
+
+/* For the in_reduction clauses of a task, replace the addresses of the
+   original variables in PTRS[0] to PTRS[CNT-1] with the addresses of the
+   current thread's private copies.  The addresses may also point into
+   another thread's private copy, if the task was created in a task that
+   itself had the variable in an in_reduction clause.  For the first
+   CNTORIG of them also store the addresses of the original variables
+   to PTRS[CNT] and following, for user defined reductions.  */
+
+void
+GOMP_task_reduction_remap (size_t cnt, size_t cntorig, void **ptrs)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_task *task = thr->task;
+  unsigned id = thr->ts.team_id;
+  uintptr_t *data, *d;
+  struct htab *reduction_htab;
+  size_t i;
+
+  if (task && task->taskgroup && task->taskgroup->reductions)
+    data = task->taskgroup->reductions;
+  else
+    {
+      data = thr->task_reductions;
+      id = 0;
+    }
+  if (data == NULL)
+    gomp_fatal ("in_reduction outside of a taskgroup with task_reduction");
+  reduction_htab = (struct htab *) data[5];
+
+  for (i = 0; i < cnt; i++)
+    {
+      hash_entry_type ent, n;
+      uintptr_t off;
+
+      __asm ("" : "=g" (ent) : "0" (ptrs + i));
+      n = htab_find (reduction_htab, ent);
+      if (n)
+	{
+	  uintptr_t *p;
+	  __asm ("" : "=g" (p) : "0" (n));
+	  d = (uintptr_t *) p[2];
+	  ptrs[i] = (void *) (d[2] + id * d[1] + p[1]);
+	  if (__builtin_expect (i < cntorig, 0))
+	    ptrs[cnt + i] = (void *) p[0];
+	  continue;
+	}
+
+      /* Not an original variable, so it has to be a private copy.  */
+      for (d = data; d; d = (uintptr_t *) d[4])
+	if ((uintptr_t) ptrs[i] >= d[2] && (uintptr_t) ptrs[i] < d[6])
+	  break;
+      if (d == NULL)
+	gomp_fatal ("couldn't find matching task_reduction for %p", ptrs[i]);
+      off = ((uintptr_t) ptrs[i] - d[2]) % d[1];
+      ptrs[i] = (void *) (d[2] + id * d[1] + off);
+      if (__builtin_expect (i < cntorig, 0))
+	{
+	  size_t lo = 0, hi = d[0];
+	  while (lo < hi)
+	    {
+	      size_t m = (lo + hi) / 2;
+	      if (d[7 + 3 * m + 1] < off)
+		lo = m + 1;
+	      else
+		hi = m;
+	    }
+	  if (lo == d[0] || d[7 + 3 * lo + 1] != off)
+	    gomp_fatal ("couldn't find matching task_reduction for %p",
+			ptrs[i]);
+	  ptrs[cnt + i] = (void *) d[7 + 3 * lo];
+	}
+    }
+}
+
 int
 omp_in_final (void)
 {
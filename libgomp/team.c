@@ -31,7 +31,43 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Report the implicit task of THR in its team beginning or ending to
+   an OMPT tool.  */
+
+static inline void
+gomp_ompt_implicit_task (struct gomp_thread *thr,
+			 ompt_scope_endpoint_t endpoint)
+{
+  ompt_callback_implicit_task_t implicit_task
+    = gomp_ompt_callback (implicit_task);
+  if (implicit_task)
+    implicit_task (endpoint,
+		   endpoint == ompt_scope_begin
+		   ? &thr->ts.team->ompt_parallel_data : NULL,
+		   &thr->task->ompt_data, thr->ts.team->nthreads,
+		   thr->ts.team_id, ompt_task_implicit);
+}
+
+/* Wait at the implicit barrier at the end of the parallel region.  */
+
+static inline void
+gomp_team_barrier_wait_implicit (struct gomp_thread *thr,
+				 struct gomp_team *team)
+{
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_barrier_implicit,
+			      ompt_scope_begin);
+  gomp_team_barrier_wait_final (&team->barrier);
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_barrier_implicit,
+			      ompt_scope_end);
+  gomp_ompt_implicit_task (thr, ompt_scope_end);
+}
+
+static void gomp_free_pool_helper (void *);
+static void gomp_free_pool (struct gomp_thread_pool *);
+
 #ifdef LIBGOMP_USE_PTHREADS
+ialias_redirect (omp_get_wtime)
+
 /* This attribute contains PTHREAD_CREATE_DETACHED.  */
 pthread_attr_t gomp_thread_attr;
 
@@ -56,11 +92,16 @@ struct gomp_thread_start_data
   struct gomp_team_state ts;
   struct gomp_task *task;
   struct gomp_thread_pool *thread_pool;
+  /* Pool on whose dock the thread waits between teams, either
+     THREAD_POOL or the nested pool of the master thread.  */
+  struct gomp_thread_pool *dock_pool;
   unsigned int place;
   bool nested;
 };
 
 
+static void gomp_release_idle_nested_pool (struct gomp_thread *);
+
 /* This function is a pthread_create entry point.  This contains the idle
    loop in which a thread waits to be called up to become part of a team.  */
 
@@ -89,11 +130,20 @@ gomp_thread_start (void *xdata)
   thr->ts = data->ts;
   thr->task = data->task;
   thr->place = data->place;
+  thr->spin_budget = 0;
+  thr->spin_waits = 0;
+  thr->ompt_thread_data.value = 0;
+  thr->ompt_initial_task_data.value = 0;
+  thr->nested_pool = NULL;
+
+  ompt_callback_thread_begin_t thread_begin = gomp_ompt_callback (thread_begin);
+  if (thread_begin)
+    thread_begin (ompt_thread_worker, &thr->ompt_thread_data);
 
   thr->ts.team->ordered_release[thr->ts.team_id] = &thr->release;
 
   /* Make thread pool local. */
-  pool = thr->thread_pool;
+  pool = data->dock_pool;
 
   if (data->nested)
     {
@@ -102,8 +152,9 @@ gomp_thread_start (void *xdata)
 
       gomp_barrier_wait (&team->barrier);
 
+      gomp_ompt_implicit_task (thr, ompt_scope_begin);
       local_fn (local_data);
-      gomp_team_barrier_wait_final (&team->barrier);
+      gomp_team_barrier_wait_implicit (thr, team);
       gomp_finish_task (task);
       gomp_barrier_wait_last (&team->barrier);
     }
@@ -117,9 +168,17 @@ gomp_thread_start (void *xdata)
 	  struct gomp_team *team = thr->ts.team;
 	  struct gomp_task *task = thr->task;
 
+	  /* gomp_free_pool_helper terminates the thread outside of any
+	     team, THR->ts.team may be already freed.  */
+	  if (local_fn != gomp_free_pool_helper)
+	    gomp_ompt_implicit_task (thr, ompt_scope_begin);
 	  local_fn (local_data);
-	  gomp_team_barrier_wait_final (&team->barrier);
+	  gomp_team_barrier_wait_implicit (thr, team);
 	  gomp_finish_task (task);
+	  if (__builtin_expect (team->ompt_enabled, 0))
+	    gomp_barrier_wait_last (&team->barrier);
+	  if (__builtin_expect (thr->nested_pool != NULL, 0))
+	    gomp_release_idle_nested_pool (thr);
 
 	  gomp_simple_barrier_wait (&pool->threads_dock);
 
@@ -130,6 +189,16 @@ gomp_thread_start (void *xdata)
       while (local_fn);
     }
 
+  if (thr->nested_pool)
+    {
+      gomp_free_pool (thr->nested_pool);
+      thr->nested_pool = NULL;
+    }
+
+  ompt_callback_thread_end_t thread_end = gomp_ompt_callback (thread_end);
+  if (thread_end)
+    thread_end (&thr->ompt_thread_data);
+
   gomp_sem_destroy (&thr->release);
   thr->thread_pool = NULL;
   thr->task = NULL;
@@ -141,16 +210,32 @@ static inline struct gomp_team *
 get_last_team (unsigned nthreads)
 {
   struct gomp_thread *thr = gomp_thread ();
+  struct gomp_thread_pool *pool;
+  struct gomp_team *last_team;
+  int i;
+
   if (thr->ts.team == NULL)
+    pool = gomp_get_thread_pool (thr, nthreads);
+  else if (thr->nested_pool != NULL
+	   && thr->nested_pool_level == thr->ts.level)
+    pool = thr->nested_pool;
+  else
+    return NULL;
+
+  last_team = pool->last_team;
+  if (last_team != NULL && last_team->nthreads == nthreads)
     {
-      struct gomp_thread_pool *pool = gomp_get_thread_pool (thr, nthreads);
-      struct gomp_team *last_team = pool->last_team;
-      if (last_team != NULL && last_team->nthreads == nthreads)
-        {
-          pool->last_team = NULL;
-          return last_team;
-        }
+      pool->last_team = NULL;
+      return last_team;
     }
+  for (i = GOMP_TEAM_CACHE_SIZE - 1; i >= 0; i--)
+    if (pool->team_cache[i] != NULL
+	&& pool->team_cache[i]->nthreads == nthreads)
+      {
+	last_team = pool->team_cache[i];
+	pool->team_cache[i] = NULL;
+	return last_team;
+      }
   return NULL;
 }
 
@@ -193,6 +278,9 @@ gomp_new_team (unsigned nthreads)
 
   gomp_sem_init (&team->master_release, 0);
   team->ordered_release = (void *) &team->implicit_task[nthreads];
+  team->ompt_parallel_data.value = 0;
+  team->ompt_enabled = gomp_ompt_enabled;
+  team->hot = false;
   team->ordered_release[0] = &team->master_release;
 
   priority_queue_init (&team->task_queue);
@@ -220,12 +308,45 @@ free_team (struct gomp_team *team)
   free (team);
 }
 
+/* Keep TEAM, which has just ended, in POOL for reuse by a later team.  */
+
+static void
+gomp_pool_keep_team (struct gomp_thread_pool *pool, struct gomp_team *team)
+{
+  int i;
+
+  if (pool->last_team)
+    {
+      /* Evict the least recently ended team if the cache is full.  */
+      for (i = 0; i < GOMP_TEAM_CACHE_SIZE; i++)
+	if (pool->team_cache[i] == NULL)
+	  break;
+      if (i == GOMP_TEAM_CACHE_SIZE)
+	{
+	  free_team (pool->team_cache[0]);
+	  memmove (&pool->team_cache[0], &pool->team_cache[1],
+		   (GOMP_TEAM_CACHE_SIZE - 1) * sizeof (pool->team_cache[0]));
+	  i = GOMP_TEAM_CACHE_SIZE - 1;
+	}
+      pool->team_cache[i] = pool->last_team;
+    }
+  pool->last_team = team;
+}
+
 static void
 gomp_free_pool_helper (void *thread_pool)
 {
   struct gomp_thread *thr = gomp_thread ();
   struct gomp_thread_pool *pool
     = (struct gomp_thread_pool *) thread_pool;
+  ompt_callback_thread_end_t thread_end = gomp_ompt_callback (thread_end);
+  if (thread_end)
+    thread_end (&thr->ompt_thread_data);
+  if (thr->nested_pool)
+    {
+      gomp_free_pool (thr->nested_pool);
+      thr->nested_pool = NULL;
+    }
   gomp_simple_barrier_wait_last (&pool->threads_dock);
   gomp_sem_destroy (&thr->release);
   thr->thread_pool = NULL;
@@ -239,47 +360,64 @@ gomp_free_pool_helper (void *thread_pool)
 #endif
 }
 
-/* Free a thread pool and release its threads. */
+/* Free a thread pool and release its threads.  */
 
-void
-gomp_free_thread (void *arg __attribute__((unused)))
+static void
+gomp_free_pool (struct gomp_thread_pool *pool)
 {
-  struct gomp_thread *thr = gomp_thread ();
-  struct gomp_thread_pool *pool = thr->thread_pool;
-  if (pool)
+  int i;
+
+  if (pool->threads_used > 0)
     {
-      if (pool->threads_used > 0)
+      for (i = 1; i < pool->threads_used; i++)
 	{
-	  int i;
-	  for (i = 1; i < pool->threads_used; i++)
-	    {
-	      struct gomp_thread *nthr = pool->threads[i];
-	      nthr->fn = gomp_free_pool_helper;
-	      nthr->data = pool;
-	    }
-	  /* This barrier undocks threads docked on pool->threads_dock.  */
-	  gomp_simple_barrier_wait (&pool->threads_dock);
-	  /* And this waits till all threads have called gomp_barrier_wait_last
-	     in gomp_free_pool_helper.  */
-	  gomp_simple_barrier_wait (&pool->threads_dock);
-	  /* Now it is safe to destroy the barrier and free the pool.  */
-	  gomp_simple_barrier_destroy (&pool->threads_dock);
+	  struct gomp_thread *nthr = pool->threads[i];
+	  nthr->fn = gomp_free_pool_helper;
+	  nthr->data = pool;
+	}
+      /* This barrier undocks threads docked on pool->threads_dock.  */
+      gomp_simple_barrier_wait (&pool->threads_dock);
+      /* And this waits till all threads have called gomp_barrier_wait_last
+	 in gomp_free_pool_helper.  */
+      gomp_simple_barrier_wait (&pool->threads_dock);
+      /* Now it is safe to destroy the barrier and free the pool.  */
+      gomp_simple_barrier_destroy (&pool->threads_dock);
 
 #ifdef HAVE_SYNC_BUILTINS
-	  __sync_fetch_and_add (&gomp_managed_threads,
-				1L - pool->threads_used);
+      __sync_fetch_and_add (&gomp_managed_threads,
+			    1L - pool->threads_used);
 #else
-	  gomp_mutex_lock (&gomp_managed_threads_lock);
-	  gomp_managed_threads -= pool->threads_used - 1L;
-	  gomp_mutex_unlock (&gomp_managed_threads_lock);
+      gomp_mutex_lock (&gomp_managed_threads_lock);
+      gomp_managed_threads -= pool->threads_used - 1L;
+      gomp_mutex_unlock (&gomp_managed_threads_lock);
 #endif
-	}
-      if (pool->last_team)
-	free_team (pool->last_team);
+    }
+  if (pool->last_team)
+    free_team (pool->last_team);
+  for (i = 0; i < GOMP_TEAM_CACHE_SIZE; i++)
+    if (pool->team_cache[i])
+      free_team (pool->team_cache[i]);
 #ifndef __nvptx__
-      free (pool->threads);
-      free (pool);
+  free (pool->threads);
+  free (pool);
 #endif
+}
+
+/* Free the thread pools of the current thread and release their threads.  */
+
+void
+gomp_free_thread (void *arg __attribute__((unused)))
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_thread_pool *pool = thr->thread_pool;
+  if (thr->nested_pool)
+    {
+      gomp_free_pool (thr->nested_pool);
+      thr->nested_pool = NULL;
+    }
+  if (pool)
+    {
+      gomp_free_pool (pool);
       thr->thread_pool = NULL;
     }
   if (thr->ts.level == 0 && __builtin_expect (thr->ts.team != NULL, 0))
@@ -292,9 +430,44 @@ gomp_free_thread (void *arg __attribute__((unused)))
     }
 }
 
+#ifdef LIBGOMP_USE_PTHREADS
+/* Return the pool of hot threads for the nested teams THR encounters at
+   nesting level LEVEL, allocating it on demand, or NULL if the pool is
+   kept for another level.  Unlike the top level pool, it doesn't track
+   a contention group, its threads keep THR's thread_pool.  */
+
+static struct gomp_thread_pool *
+gomp_get_nested_pool (struct gomp_thread *thr, unsigned level)
+{
+  struct gomp_thread_pool *pool = thr->nested_pool;
+  if (__builtin_expect (pool == NULL, 0))
+    {
+      pool = gomp_malloc_cleared (sizeof (*pool));
+      thr->nested_pool = pool;
+      thr->nested_pool_level = level;
+    }
+  else if (thr->nested_pool_level != level)
+    return NULL;
+  return pool;
+}
+
+/* Release the hot threads of the nested teams of THR if they haven't
+   been used for GOMP_HOT_TEAMS_IDLE milliseconds.  This is checked
+   whenever THR finishes a team or an implicit task in one.  */
+
+static void
+gomp_release_idle_nested_pool (struct gomp_thread *thr)
+{
+  struct gomp_thread_pool *pool = thr->nested_pool;
+  if (pool->last_used + gomp_hot_teams_idle * 0.001 < omp_get_wtime ())
+    {
+      gomp_free_pool (pool);
+      thr->nested_pool = NULL;
+    }
+}
+
 /* Launch a team.  */
 
-#ifdef LIBGOMP_USE_PTHREADS
 void
 gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
 		 unsigned flags, struct gomp_team *team)
@@ -321,6 +494,13 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   if (__builtin_expect (gomp_places_list != NULL, 0) && thr->place == 0)
     gomp_init_affinity ();
 
+  ompt_callback_parallel_begin_t parallel_begin
+    = gomp_ompt_callback (parallel_begin);
+  if (parallel_begin)
+    parallel_begin (gomp_ompt_task_data (thr), NULL,
+		    &team->ompt_parallel_data, nthreads,
+		    ompt_parallel_invoker_runtime | ompt_parallel_team, NULL);
+
   /* Always save the previous state, even if this isn't a nested team.
      In particular, we should save any work share state from an outer
      orphaned work share construct.  */
@@ -352,10 +532,26 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   gomp_init_task (thr->task, task, icv);
   team->implicit_task[0].icv.nthreads_var = nthreads_var;
   team->implicit_task[0].icv.bind_var = bind_var;
+  gomp_ompt_implicit_task (thr, ompt_scope_begin);
 
   if (nthreads == 1)
     return;
 
+  /* Unless GOMP_HOT_TEAMS_IDLE is zero, the threads of nested teams are
+     kept in a pool of the master thread as well, and from here on such
+     teams are started like non-nested ones.  */
+  if (nested && gomp_hot_teams_idle != 0)
+    {
+      struct gomp_thread_pool *nested_pool
+	= gomp_get_nested_pool (thr, team->prev_ts.level);
+      if (nested_pool != NULL)
+	{
+	  pool = nested_pool;
+	  team->hot = true;
+	  nested = false;
+	}
+    }
+
   i = 1;
 
   if (__builtin_expect (gomp_places_list != NULL, 0))
@@ -426,11 +622,9 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   else
     bind = omp_proc_bind_false;
 
-  /* We only allow the reuse of idle threads for non-nested PARALLEL
-     regions.  This appears to be implied by the semantics of
-     threadprivate variables, but perhaps that's reading too much into
-     things.  Certainly it does prevent any locking problems, since
-     only the initial program thread will modify gomp_threads.  */
+  /* Reuse idle threads of the pool, unless this is a nested team and
+     GOMP_HOT_TEAMS_IDLE is zero.  Every pool is only ever modified by
+     the thread owning it, so there are no locking problems.  */
   if (!nested)
     {
       old_threads_used = pool->threads_used;
@@ -810,7 +1004,8 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
       gomp_init_task (start_data->task, task, icv);
       team->implicit_task[i].icv.nthreads_var = nthreads_var;
       team->implicit_task[i].icv.bind_var = bind_var;
-      start_data->thread_pool = pool;
+      start_data->thread_pool = thr->thread_pool;
+      start_data->dock_pool = pool;
       start_data->nested = nested;
 
       attr = gomp_adjust_thread_attr (attr, &thread_attr);
@@ -874,7 +1069,7 @@ gomp_team_end (void)
      As #pragma omp cancel parallel might get awaited count in
      team->barrier in a inconsistent state, we need to use a different
      counter here.  */
-  gomp_team_barrier_wait_final (&team->barrier);
+  gomp_team_barrier_wait_implicit (thr, team);
   if (__builtin_expect (team->team_cancelled, 0))
     {
       struct gomp_work_share *ws = team->work_shares_to_free;
@@ -894,7 +1089,13 @@ gomp_team_end (void)
   gomp_end_task ();
   thr->ts = team->prev_ts;
 
-  if (__builtin_expect (thr->ts.team != NULL, 0))
+  ompt_callback_parallel_end_t parallel_end
+    = gomp_ompt_callback (parallel_end);
+  if (parallel_end)
+    parallel_end (&team->ompt_parallel_data, gomp_ompt_task_data (thr),
+		  ompt_parallel_invoker_runtime | ompt_parallel_team, NULL);
+
+  if (__builtin_expect (thr->ts.team != NULL, 0) && !team->hot)
     {
 #ifdef HAVE_SYNC_BUILTINS
       __sync_fetch_and_add (&gomp_managed_threads, 1L - team->nthreads);
@@ -907,6 +1108,9 @@ gomp_team_end (void)
 	 and ensures the team can be safely destroyed.  */
       gomp_barrier_wait (&team->barrier);
     }
+  else if (__builtin_expect (team->ompt_enabled, 0))
+    /* Likewise, but only so that the team can be reused.  */
+    gomp_barrier_wait (&team->barrier);
 
   if (__builtin_expect (team->work_shares[0].next_alloc != NULL, 0))
     {
@@ -921,16 +1125,27 @@ gomp_team_end (void)
     }
   gomp_sem_destroy (&team->master_release);
 
-  if (__builtin_expect (thr->ts.team != NULL, 0)
-      || __builtin_expect (team->nthreads == 1, 0))
+  if (__builtin_expect (thr->ts.team != NULL, 0) && !team->hot)
+    free_team (team);
+#ifdef LIBGOMP_USE_PTHREADS
+  else if (team->hot)
+    {
+      struct gomp_thread_pool *pool = thr->nested_pool;
+      gomp_pool_keep_team (pool, team);
+      pool->last_used = omp_get_wtime ();
+    }
+#endif
+  else if (__builtin_expect (team->nthreads == 1, 0))
     free_team (team);
   else
     {
       struct gomp_thread_pool *pool = thr->thread_pool;
-      if (pool->last_team)
-	free_team (pool->last_team);
-      pool->last_team = team;
+      gomp_pool_keep_team (pool, team);
       gomp_release_thread_pool (pool);
+#ifdef LIBGOMP_USE_PTHREADS
+      if (__builtin_expect (thr->nested_pool != NULL, 0))
+	gomp_release_idle_nested_pool (thr);
+#endif
     }
 }
 
@@ -0,0 +1,71 @@
+#include <omp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+int
+main ()
+{
+  omp_alloctrait_t traits[3]
+    = { { omp_atk_alignment, 4096 }, { omp_atk_pinned, omp_atv_true },
+	{ omp_atk_partition, omp_atv_interleaved } };
+  omp_alloctrait_t pool[2]
+    = { { omp_atk_pool_size, 1024 }, { omp_atk_fallback, omp_atv_null_fb } };
+  omp_alloctrait_t bad[1] = { { omp_atk_alignment, 3 } };
+  omp_allocator_handle_t a, b;
+  char *p;
+  void *q, *r;
+
+  if (omp_get_default_allocator () != omp_default_mem_alloc)
+    abort ();
+  if (omp_init_allocator (omp_default_mem_space, 1, bad)
+      != omp_null_allocator)
+    abort ();
+
+  /* Alignment must survive falling back to the default memory if the
+     block can't be pinned.  */
+  a = omp_init_allocator (omp_default_mem_space, 3, traits);
+  if (a == omp_null_allocator)
+    abort ();
+  p = (char *) omp_alloc (100000, a);
+  if (p == NULL || ((uintptr_t) p & 4095) != 0)
+    abort ();
+  memset (p, 1, 100000);
+  omp_free (p, a);
+
+  b = omp_init_allocator (omp_default_mem_space, 2, pool);
+  if (b == omp_null_allocator)
+    abort ();
+  q = omp_alloc (512, b);
+  r = omp_alloc (600, b);
+  if (q == NULL || r != NULL)
+    abort ();
+  omp_free (q, b);
+  r = omp_alloc (600, b);
+  if (r == NULL)
+    abort ();
+  omp_free (r, omp_null_allocator);
+
+  omp_set_default_allocator (b);
+  #pragma omp parallel num_threads (4)
+  {
+    omp_alloctrait_t near[1] = { { omp_atk_partition, omp_atv_nearest } };
+    omp_allocator_handle_t n;
+    int *x;
+
+    if (omp_get_default_allocator () != b)
+      abort ();
+    n = omp_init_allocator (omp_default_mem_space, 1, near);
+    x = (int *) omp_alloc (1000 * sizeof (int), n);
+    if (x == NULL)
+      abort ();
+    x[999] = omp_get_thread_num ();
+    omp_free (x, n);
+    omp_destroy_allocator (n);
+  }
+  omp_set_default_allocator (omp_default_mem_alloc);
+
+  omp_destroy_allocator (a);
+  omp_destroy_allocator (b);
+  return 0;
+}
@@ -0,0 +1,81 @@
+/* { dg-do run } */
+/* { dg-set-target-env-var GOMP_CRITICAL_HINT "contended" } */
+
+/* Check omp_init_lock_with_hint and omp_init_nest_lock_with_hint with
+   all kinds of hints, and the unnamed critical lock made a queued lock
+   through GOMP_CRITICAL_HINT.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+static const omp_lock_hint_t hints[] = {
+  omp_lock_hint_none,
+  omp_lock_hint_uncontended,
+  omp_lock_hint_contended,
+  omp_lock_hint_nonspeculative,
+  omp_lock_hint_speculative,
+  omp_lock_hint_contended | omp_lock_hint_speculative,
+  omp_lock_hint_contended | omp_lock_hint_uncontended
+};
+
+#define N 20000
+
+int
+main ()
+{
+  unsigned int i;
+  int counter, critical_counter = 0;
+
+  for (i = 0; i < sizeof (hints) / sizeof (hints[0]); i++)
+    {
+      omp_lock_t lock;
+      omp_nest_lock_t nest_lock;
+
+      omp_init_lock_with_hint (&lock, hints[i]);
+      omp_init_nest_lock_with_hint (&nest_lock, hints[i]);
+      if (!omp_test_lock (&lock))
+	abort ();
+      if (omp_test_lock (&lock))
+	abort ();
+      omp_unset_lock (&lock);
+
+      counter = 0;
+      #pragma omp parallel num_threads (4)
+      {
+	int j;
+	for (j = 0; j < N; j++)
+	  {
+	    omp_set_lock (&lock);
+	    counter++;
+	    omp_unset_lock (&lock);
+	    omp_set_nest_lock (&nest_lock);
+	    if (omp_test_nest_lock (&nest_lock) != 2)
+	      abort ();
+	    counter++;
+	    omp_unset_nest_lock (&nest_lock);
+	    omp_unset_nest_lock (&nest_lock);
+	    #pragma omp critical
+	    critical_counter++;
+	  }
+	#pragma omp barrier
+	#pragma omp single
+	{
+	  if (counter != 2 * N * omp_get_num_threads ())
+	    abort ();
+	  if (!omp_test_lock (&lock))
+	    abort ();
+	  omp_unset_lock (&lock);
+	  if (omp_test_nest_lock (&nest_lock) != 1)
+	    abort ();
+	  omp_unset_nest_lock (&nest_lock);
+	}
+	#pragma omp single
+	critical_counter -= N * omp_get_num_threads ();
+      }
+      if (critical_counter != 0)
+	abort ();
+      omp_destroy_lock (&lock);
+      omp_destroy_nest_lock (&nest_lock);
+    }
+  return 0;
+}
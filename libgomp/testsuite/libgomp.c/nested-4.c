@@ -0,0 +1,52 @@
+/* Check that nested teams of varying sizes, started over and over again
+   at several nesting levels, get the right number of threads when
+   their threads are kept in hot pools.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int
+main (void)
+{
+  int it, t, e = 0;
+  long sum = 0, expected = 0;
+
+  omp_set_nested (1);
+  omp_set_dynamic (0);
+  for (it = 0; it < 64; it++)
+    {
+      #pragma omp parallel num_threads (3) reduction (+:sum)
+      {
+	int tn1 = omp_get_thread_num ();
+	int n2 = 1 + (it + tn1) % 4;
+	#pragma omp parallel num_threads (n2) firstprivate (tn1) \
+			     reduction (+:sum)
+	{
+	  int i;
+	  if (omp_get_num_threads () != n2
+	      || omp_get_level () != 2
+	      || omp_get_ancestor_thread_num (1) != tn1)
+	    #pragma omp atomic
+	      e++;
+	  #pragma omp for
+	  for (i = 0; i < 100; i++)
+	    sum += i;
+	  #pragma omp parallel num_threads (2) firstprivate (tn1) \
+			       reduction (+:sum)
+	  {
+	    if (omp_get_num_threads () != 2
+		|| omp_get_level () != 3
+		|| omp_get_ancestor_thread_num (1) != tn1)
+	      #pragma omp atomic
+		e++;
+	    sum++;
+	  }
+	}
+      }
+      for (t = 0; t < 3; t++)
+	expected += 4950 + 2 * (1 + (it + t) % 4);
+    }
+  if (e || sum != expected)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,153 @@
+/* Check that a tool linked into the program is activated and that the
+   parallel, implicit task, explicit task and barrier callbacks it
+   registers come in matching pairs.  */
+
+#include <omp.h>
+#include <omp-tools.h>
+#include <stdlib.h>
+
+static int initialized, finalized;
+static int parallel_begin, parallel_end, implicit_begin, implicit_end;
+static int task_create, task_complete, wait_begin, wait_end;
+
+static void
+on_parallel_begin (ompt_data_t *encountering_task_data,
+		   const ompt_frame_t *encountering_task_frame,
+		   ompt_data_t *parallel_data, unsigned int requested_parallelism,
+		   int flags, const void *codeptr_ra)
+{
+  parallel_data->value = 42;
+  __atomic_add_fetch (&parallel_begin, 1, __ATOMIC_RELAXED);
+}
+
+static void
+on_parallel_end (ompt_data_t *parallel_data,
+		 ompt_data_t *encountering_task_data, int flags,
+		 const void *codeptr_ra)
+{
+  if (parallel_data->value != 42)
+    abort ();
+  __atomic_add_fetch (&parallel_end, 1, __ATOMIC_RELAXED);
+}
+
+static void
+on_implicit_task (ompt_scope_endpoint_t endpoint, ompt_data_t *parallel_data,
+		  ompt_data_t *task_data, unsigned int actual_parallelism,
+		  unsigned int index, int flags)
+{
+  if (endpoint == ompt_scope_begin)
+    {
+      if (parallel_data->value != 42 || index >= actual_parallelism)
+	abort ();
+      task_data->value = index + 1;
+      __atomic_add_fetch (&implicit_begin, 1, __ATOMIC_RELAXED);
+    }
+  else
+    {
+      if (task_data->value == 0)
+	abort ();
+      __atomic_add_fetch (&implicit_end, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void
+on_task_create (ompt_data_t *encountering_task_data,
+		const ompt_frame_t *encountering_task_frame,
+		ompt_data_t *new_task_data, int flags, int has_dependences,
+		const void *codeptr_ra)
+{
+  new_task_data->value = 7;
+  __atomic_add_fetch (&task_create, 1, __ATOMIC_RELAXED);
+}
+
+static void
+on_task_schedule (ompt_data_t *prior_task_data,
+		  ompt_task_status_t prior_task_status,
+		  ompt_data_t *next_task_data)
+{
+  if (prior_task_status == ompt_task_complete)
+    {
+      if (prior_task_data->value != 7)
+	abort ();
+      __atomic_add_fetch (&task_complete, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void
+on_sync_region_wait (ompt_sync_region_t kind, ompt_scope_endpoint_t endpoint,
+		     ompt_data_t *parallel_data, ompt_data_t *task_data,
+		     const void *codeptr_ra)
+{
+  if (endpoint == ompt_scope_begin)
+    __atomic_add_fetch (&wait_begin, 1, __ATOMIC_RELAXED);
+  else
+    __atomic_add_fetch (&wait_end, 1, __ATOMIC_RELAXED);
+}
+
+static int
+tool_initialize (ompt_function_lookup_t lookup, int initial_device_num,
+		 ompt_data_t *tool_data)
+{
+  ompt_set_callback_t set_callback
+    = (ompt_set_callback_t) lookup ("ompt_set_callback");
+  if (set_callback == NULL
+      || set_callback (ompt_callback_parallel_begin,
+		       (ompt_callback_t) on_parallel_begin) != ompt_set_always
+      || set_callback (ompt_callback_parallel_end,
+		       (ompt_callback_t) on_parallel_end) != ompt_set_always
+      || set_callback (ompt_callback_implicit_task,
+		       (ompt_callback_t) on_implicit_task) != ompt_set_always
+      || set_callback (ompt_callback_task_create,
+		       (ompt_callback_t) on_task_create) != ompt_set_always
+      || set_callback (ompt_callback_task_schedule,
+		       (ompt_callback_t) on_task_schedule) != ompt_set_always
+      || set_callback (ompt_callback_sync_region_wait,
+		       (ompt_callback_t) on_sync_region_wait) != ompt_set_always)
+    abort ();
+  initialized = 1;
+  return 1;
+}
+
+static void
+tool_finalize (ompt_data_t *tool_data)
+{
+  finalized = 1;
+}
+
+ompt_start_tool_result_t *
+ompt_start_tool (unsigned int omp_version, const char *runtime_version)
+{
+  static ompt_start_tool_result_t result
+    = { tool_initialize, tool_finalize, { 0 } };
+  return &result;
+}
+
+int
+main ()
+{
+  int i, nthreads = 0;
+
+  if (!initialized || finalized)
+    abort ();
+  for (i = 0; i < 2; i++)
+    {
+      #pragma omp parallel num_threads (4)
+      {
+	#pragma omp single
+	{
+	  int j;
+	  nthreads += omp_get_num_threads ();
+	  for (j = 0; j < 10; j++)
+	    #pragma omp task
+	    ;
+	}
+	#pragma omp barrier
+      }
+    }
+  if (parallel_begin != 2 || parallel_end != 2
+      || implicit_begin != nthreads || implicit_end != nthreads
+      || task_create != 20 || task_complete != 20
+      || wait_begin == 0 || wait_begin != wait_end)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,49 @@
+/* Mix small, large, alloc and firstprivate mappings so that some host
+   to device copies get coalesced and others don't.  */
+
+extern void abort (void);
+
+int
+main ()
+{
+  int a[10], b[20], c[3000], big[20000], x = 5, y[4], i, err = 0;
+  char s = 'q';
+  for (i = 0; i < 10; i++)
+    a[i] = i;
+  for (i = 0; i < 20; i++)
+    b[i] = 100 + i;
+  for (i = 0; i < 3000; i++)
+    c[i] = 1000 + i;
+  for (i = 0; i < 20000; i++)
+    big[i] = -i;
+  #pragma omp target map(to: a, b, c, big) map(tofrom: x, err) map(alloc: y) \
+		     firstprivate (s)
+  {
+    int j;
+    for (j = 0; j < 10; j++)
+      if (a[j] != j)
+	err = 1;
+    for (j = 0; j < 20; j++)
+      if (b[j] != 100 + j)
+	err = 1;
+    for (j = 0; j < 3000; j++)
+      if (c[j] != 1000 + j)
+	err = 1;
+    for (j = 0; j < 20000; j++)
+      if (big[j] != -j)
+	err = 1;
+    if (s != 'q')
+      err = 1;
+    y[0] = x;
+    x = y[0] + 1;
+  }
+  if (err || x != 6)
+    abort ();
+  #pragma omp target enter data map(to: a[2:3], b[1:2], s)
+  #pragma omp target map(from: x)
+  x = a[3] + b[2] + s;
+  #pragma omp target exit data map(release: a[2:3], b[1:2], s)
+  if (x != 3 + 102 + 'q')
+    abort ();
+  return 0;
+}
@@ -0,0 +1,153 @@
+/* Test the task reduction entry points the way the compiler lowers
+     #pragma omp taskgroup task_reduction (+: sum, hist)
+   with tasks carrying in_reduction (+: sum, hist) clauses, including
+   a nested taskgroup, nested tasks and an orphaned taskgroup.  */
+
+#include <omp.h>
+#include <stdlib.h>
+#include "libgomp_g.h"
+
+#define NBINS 16
+
+long sum, sum2;
+int hist[NBINS];
+
+/* Array descriptor with two variables: SUM at offset 0 and HIST at
+   offset 64.  */
+
+static void
+init_desc (uintptr_t *data, long *psum, int *phist)
+{
+  data[0] = 2;
+  data[1] = 128;
+  data[2] = 64;
+  data[3] = -1;
+  data[4] = 0;
+  data[7] = (uintptr_t) psum;
+  data[8] = 0;
+  data[10] = (uintptr_t) phist;
+  data[11] = 64;
+}
+
+/* Combine the private copies of all NTHREADS threads into the original
+   variables, as done after GOMP_taskgroup_end.  */
+
+static void
+combine (uintptr_t *data, unsigned nthreads)
+{
+  unsigned t;
+  int j;
+
+  for (t = 0; t < nthreads; t++)
+    {
+      char *base = (char *) data[2] + t * data[1];
+      *(long *) data[7] += *(long *) (base + data[8]);
+      for (j = 0; j < NBINS; j++)
+	((int *) data[10])[j] += ((int *) (base + data[11]))[j];
+    }
+}
+
+static void
+task_body (int i, int nested)
+{
+  void *ptrs[2] = { &sum, hist };
+  GOMP_task_reduction_remap (2, 0, ptrs);
+  *(long *) ptrs[0] += i;
+  ((int *) ptrs[1])[i % NBINS]++;
+  if (nested)
+    {
+      /* A task created in a task with in_reduction refers to the
+	 private copy of the creating thread.  */
+      long *priv_sum = ptrs[0];
+      int *priv_hist = ptrs[1];
+      #pragma omp task firstprivate (priv_sum, priv_hist, i)
+      {
+	void *ptrs2[3] = { priv_sum, priv_hist };
+	GOMP_task_reduction_remap (2, 1, ptrs2);
+	if (ptrs2[2] != &sum)
+	  abort ();
+	*(long *) ptrs2[0] += i;
+	((int *) ptrs2[1])[i % NBINS]++;
+      }
+    }
+}
+
+static void
+check (long expected, int even_bins, int odd_bins)
+{
+  int j;
+
+  if (sum != expected)
+    abort ();
+  for (j = 0; j < NBINS; j++)
+    if (hist[j] != ((j & 1) ? odd_bins : even_bins))
+      abort ();
+  sum = 0;
+  for (j = 0; j < NBINS; j++)
+    hist[j] = 0;
+}
+
+int
+main ()
+{
+  uintptr_t data[13], data2[10];
+  int i;
+
+  #pragma omp parallel num_threads (4)
+  #pragma omp single
+  {
+    unsigned nthreads = omp_get_num_threads ();
+    init_desc (data, &sum, hist);
+    GOMP_taskgroup_start ();
+    GOMP_taskgroup_reduction_register (data);
+    for (i = 0; i < 1024; i++)
+      #pragma omp task firstprivate (i)
+      task_body (i, i & 1);
+
+    /* A nested taskgroup with another variable, which still sees the
+       outer task_reduction variables.  */
+    data2[0] = 1;
+    data2[1] = 64;
+    data2[2] = 64;
+    data2[3] = -1;
+    data2[4] = 0;
+    data2[7] = (uintptr_t) &sum2;
+    data2[8] = 0;
+    GOMP_taskgroup_start ();
+    GOMP_taskgroup_reduction_register (data2);
+    for (i = 0; i < 100; i++)
+      #pragma omp task firstprivate (i)
+      {
+	void *ptrs[2] = { &sum2, &sum };
+	GOMP_task_reduction_remap (2, 0, ptrs);
+	*(long *) ptrs[0] += 1;
+	*(long *) ptrs[1] += 1;
+      }
+    GOMP_taskgroup_end ();
+    for (i = 0; i < nthreads; i++)
+      sum2 += *(long *) (data2[2] + i * data2[1]);
+    GOMP_taskgroup_reduction_unregister (data2);
+    if (sum2 != 100)
+      abort ();
+
+    GOMP_taskgroup_end ();
+    combine (data, nthreads);
+    GOMP_taskgroup_reduction_unregister (data);
+    /* 0 + ... + 1023 by all the tasks and the odd ones again by their
+       nested tasks, plus 100 from the inner taskgroup.  */
+    check (1023 * 1024 / 2 + 512 * 512 + 100, 64, 128);
+  }
+
+  /* Orphaned taskgroup.  */
+  init_desc (data, &sum, hist);
+  GOMP_taskgroup_start ();
+  GOMP_taskgroup_reduction_register (data);
+  for (i = 0; i < 64; i++)
+    #pragma omp task firstprivate (i)
+    task_body (i, 0);
+  GOMP_taskgroup_end ();
+  combine (data, 1);
+  GOMP_taskgroup_reduction_unregister (data);
+  check (63 * 64 / 2, 4, 4);
+  return 0;
+}
@@ -217,6 +217,8 @@ gomp_work_share_end (void)
       return;
     }
 
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_barrier_implicit,
+			      ompt_scope_begin);
   bstate = gomp_barrier_wait_start (&team->barrier);
 
   if (gomp_barrier_last_thread (bstate))
@@ -229,6 +231,8 @@ gomp_work_share_end (void)
     }
 
   gomp_team_barrier_wait_end (&team->barrier, bstate);
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_barrier_implicit,
+			      ompt_scope_end);
   thr->ts.last_work_share = NULL;
 }
 
@@ -243,6 +247,8 @@ gomp_work_share_end_cancel (void)
   gomp_barrier_state_t bstate;
 
   /* Cancellable work sharing constructs cannot be orphaned.  */
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_barrier_implicit,
+			      ompt_scope_begin);
   bstate = gomp_barrier_wait_cancel_start (&team->barrier);
 
   if (gomp_barrier_last_thread (bstate))
@@ -255,7 +261,10 @@ gomp_work_share_end_cancel (void)
     }
   thr->ts.last_work_share = NULL;
 
-  return gomp_team_barrier_wait_cancel_end (&team->barrier, bstate);
+  bool ret = gomp_team_barrier_wait_cancel_end (&team->barrier, bstate);
+  gomp_ompt_sync_region_wait (thr, ompt_sync_region_barrier_implicit,
+			      ompt_scope_end);
+  return ret;
 }
 
 /* The current thread is done with its current work sharing construct.
@@ -29,7 +29,14 @@ Boston, MA 02110-1301, USA.  */
    The abstract data implementation is based on generalized Algorithm D
    from Knuth's book "The art of computer programming".  Hash table is
    expanded by creation of new hash table and transferring elements from
-   the old table to the new table. */
+   the old table to the new table.
+
+   Tables created by htab_create_linear_alloc instead have a power of two
+   size and use linear probing, starting at a slot picked by the bits of
+   the scrambled hash value.  They also record the hash value of every
+   element, so that most mismatches are found without calling the
+   comparison function, and so that expanding the table does not call
+   the hash function.  */
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -74,6 +81,7 @@ static hashval_t hash_pointer (const void *);
 static int eq_pointer (const void *, const void *);
 static int htab_expand (htab_t);
 static PTR *find_empty_slot_for_expand (htab_t, hashval_t);
+static size_t higher_power_of_two (size_t);
 
 /* At some point, we could make these be NULL, and modify the
    hash-table routines to handle NULL specially; that would avoid
@@ -273,6 +281,50 @@ htab_mod_m2 (hashval_t hash, htab_t htab)
   return 1 + htab_mod_1 (hash, p->prime - 2, p->inv_m2, p->shift);
 }
 
+/* Return the index of the first slot of HTAB probed for HASH.  */
+
+static inline hashval_t
+htab_first_index (hashval_t hash, htab_t htab)
+{
+  if (htab->hashes)
+    return htab_hash_mix (hash) & (htab_size (htab) - 1);
+  return htab_mod (hash, htab);
+}
+
+/* Return the distance between the slots of HTAB probed for HASH.  */
+
+static inline hashval_t
+htab_probe_step (hashval_t hash, htab_t htab)
+{
+  if (htab->hashes)
+    return 1;
+  return htab_mod_m2 (hash, htab);
+}
+
+/* Return nonzero if ENTRY, in slot INDEX of HTAB, is equal to ELEMENT,
+   whose hash value is HASH.  */
+
+static inline int
+htab_entry_eq (htab_t htab, hashval_t index, const PTR entry,
+	       const PTR element, hashval_t hash)
+{
+  if (htab->hashes && htab->hashes[index] != hash)
+    return 0;
+  return (*htab->eq_f) (entry, element);
+}
+
+/* Return the smallest power of two that is at least N, and at least 8.  */
+
+static size_t
+higher_power_of_two (size_t n)
+{
+  size_t size = 8;
+
+  while (size < n)
+    size *= 2;
+  return size;
+}
+
 /* This function creates table with length slightly longer than given
    source length.  Created hash table is initiated as empty (all the
    hash table entries are HTAB_EMPTY_ENTRY).  The function returns the
@@ -375,6 +427,61 @@ htab_create_typed_alloc (size_t size, htab_hash hash_f, htab_eq eq_f,
 }
 
 
+/*
+
+@deftypefn Supplemental htab_t htab_create_linear_alloc (size_t @var{size}, @
+htab_hash @var{hash_f}, htab_eq @var{eq_f}, htab_del @var{del_f}, @
+htab_alloc @var{alloc_f}, htab_free @var{free_f})
+
+This function creates a hash table like @code{htab_create_alloc}, but
+the table uses linear probing in a power of two number of entries and
+records the hash value of each element.  This makes lookups and
+expansion faster at the cost of an extra @code{hashval_t} per entry.
+Because the hash values are recorded, an element must only be inserted
+through the slot returned for its own hash value.
+
+@end deftypefn
+
+*/
+
+htab_t
+htab_create_linear_alloc (size_t size, htab_hash hash_f, htab_eq eq_f,
+			  htab_del del_f, htab_alloc alloc_f,
+			  htab_free free_f)
+{
+  htab_t result;
+
+  size = higher_power_of_two (size);
+
+  result = (htab_t) (*alloc_f) (1, sizeof (struct htab));
+  if (result == NULL)
+    return NULL;
+  result->entries = (PTR *) (*alloc_f) (size, sizeof (PTR));
+  if (result->entries == NULL)
+    {
+      if (free_f != NULL)
+	(*free_f) (result);
+      return NULL;
+    }
+  result->hashes = (hashval_t *) (*alloc_f) (size, sizeof (hashval_t));
+  if (result->hashes == NULL)
+    {
+      if (free_f != NULL)
+	{
+	  (*free_f) (result->entries);
+	  (*free_f) (result);
+	}
+      return NULL;
+    }
+  result->size = size;
+  result->hash_f = hash_f;
+  result->eq_f = eq_f;
+  result->del_f = del_f;
+  result->alloc_f = alloc_f;
+  result->free_f = free_f;
+  return result;
+}
+
 /* Update the function pointers and allocation parameter in the htab_t.  */
 
 void
@@ -405,6 +512,15 @@ htab_try_create (size_t size, htab_hash hash_f, htab_eq eq_f, htab_del del_f)
   return htab_create_alloc (size, hash_f, eq_f, del_f, calloc, free);
 }
 
+/* Like htab_create, but create a linear probing table.  */
+
+htab_t
+htab_create_linear (size_t size, htab_hash hash_f, htab_eq eq_f,
+		    htab_del del_f)
+{
+  return htab_create_linear_alloc (size, hash_f, eq_f, del_f, xcalloc, free);
+}
+
 /* This function frees all memory allocated for given hash table.
    Naturally the hash table must already exist. */
 
@@ -423,6 +539,8 @@ htab_delete (htab_t htab)
   if (htab->free_f != NULL)
     {
       (*htab->free_f) (entries);
+      if (htab->hashes)
+	(*htab->free_f) (htab->hashes);
       (*htab->free_f) (htab);
     }
   else if (htab->free_with_arg_f != NULL)
@@ -446,8 +564,26 @@ htab_empty (htab_t htab)
       if (entries[i] != HTAB_EMPTY_ENTRY && entries[i] != HTAB_DELETED_ENTRY)
 	(*htab->del_f) (entries[i]);
 
-  /* Instead of clearing megabyte, downsize the table.  */
-  if (size > 1024*1024 / sizeof (PTR))
+  /* Instead of clearing megabyte, downsize the table.  The recorded
+     hash values of a linear probing table need not be cleared, since
+     they are only looked at for entries in use.  */
+  if (htab->hashes && size > 1024*1024 / sizeof (PTR))
+    {
+      size_t nsize = higher_power_of_two (1024 / sizeof (PTR));
+      PTR *nentries = (PTR *) (*htab->alloc_f) (nsize, sizeof (PTR));
+      hashval_t *nhashes
+	= (hashval_t *) (*htab->alloc_f) (nsize, sizeof (hashval_t));
+
+      if (htab->free_f != NULL)
+	{
+	  (*htab->free_f) (htab->entries);
+	  (*htab->free_f) (htab->hashes);
+	}
+      htab->entries = nentries;
+      htab->hashes = nhashes;
+      htab->size = nsize;
+    }
+  else if (size > 1024*1024 / sizeof (PTR))
     {
       int nindex = higher_prime_index (1024 / sizeof (PTR));
       int nsize = prime_tab[nindex].prime;
@@ -480,7 +616,7 @@ htab_empty (htab_t htab)
 static PTR *
 find_empty_slot_for_expand (htab_t htab, hashval_t hash)
 {
-  hashval_t index = htab_mod (hash, htab);
+  hashval_t index = htab_first_index (hash, htab);
   size_t size = htab_size (htab);
   PTR *slot = htab->entries + index;
   hashval_t hash2;
@@ -490,7 +626,7 @@ find_empty_slot_for_expand (htab_t htab, hashval_t hash)
   else if (*slot == HTAB_DELETED_ENTRY)
     abort ();
 
-  hash2 = htab_mod_m2 (hash, htab);
+  hash2 = htab_probe_step (hash, htab);
   for (;;)
     {
       index += hash2;
@@ -520,10 +656,12 @@ htab_expand (htab_t htab)
   PTR *olimit;
   PTR *p;
   PTR *nentries;
+  hashval_t *ohashes, *nhashes;
   size_t nsize, osize, elts;
   unsigned int oindex, nindex;
 
   oentries = htab->entries;
+  ohashes = htab->hashes;
   oindex = htab->size_prime_index;
   osize = htab->size;
   olimit = oentries + osize;
@@ -533,8 +671,16 @@ htab_expand (htab_t htab)
      too full or too empty.  */
   if (elts * 2 > osize || (elts * 8 < osize && osize > 32))
     {
-      nindex = higher_prime_index (elts * 2);
-      nsize = prime_tab[nindex].prime;
+      if (ohashes)
+	{
+	  nindex = oindex;
+	  nsize = higher_power_of_two (elts * 2);
+	}
+      else
+	{
+	  nindex = higher_prime_index (elts * 2);
+	  nsize = prime_tab[nindex].prime;
+	}
     }
   else
     {
@@ -549,7 +695,19 @@ htab_expand (htab_t htab)
     nentries = (PTR *) (*htab->alloc_f) (nsize, sizeof (PTR *));
   if (nentries == NULL)
     return 0;
+  nhashes = NULL;
+  if (ohashes)
+    {
+      nhashes = (hashval_t *) (*htab->alloc_f) (nsize, sizeof (hashval_t));
+      if (nhashes == NULL)
+	{
+	  if (htab->free_f != NULL)
+	    (*htab->free_f) (nentries);
+	  return 0;
+	}
+    }
   htab->entries = nentries;
+  htab->hashes = nhashes;
   htab->size = nsize;
   htab->size_prime_index = nindex;
   htab->n_elements -= htab->n_deleted;
@@ -562,7 +720,17 @@ htab_expand (htab_t htab)
 
       if (x != HTAB_EMPTY_ENTRY && x != HTAB_DELETED_ENTRY)
 	{
-	  PTR *q = find_empty_slot_for_expand (htab, (*htab->hash_f) (x));
+	  PTR *q;
+
+	  if (ohashes)
+	    {
+	      hashval_t hash = ohashes[p - oentries];
+
+	      q = find_empty_slot_for_expand (htab, hash);
+	      nhashes[q - nentries] = hash;
+	    }
+	  else
+	    q = find_empty_slot_for_expand (htab, (*htab->hash_f) (x));
 
 	  *q = x;
 	}
@@ -572,7 +740,11 @@ htab_expand (htab_t htab)
   while (p < olimit);
 
   if (htab->free_f != NULL)
-    (*htab->free_f) (oentries);
+    {
+      (*htab->free_f) (oentries);
+      if (ohashes)
+	(*htab->free_f) (ohashes);
+    }
   else if (htab->free_with_arg_f != NULL)
     (*htab->free_with_arg_f) (htab->alloc_arg, oentries);
   return 1;
@@ -590,14 +762,15 @@ htab_find_with_hash (htab_t htab, const PTR element, hashval_t hash)
 
   htab->searches++;
   size = htab_size (htab);
-  index = htab_mod (hash, htab);
+  index = htab_first_index (hash, htab);
 
   entry = htab->entries[index];
   if (entry == HTAB_EMPTY_ENTRY
-      || (entry != HTAB_DELETED_ENTRY && (*htab->eq_f) (entry, element)))
+      || (entry != HTAB_DELETED_ENTRY
+	  && htab_entry_eq (htab, index, entry, element, hash)))
     return entry;
 
-  hash2 = htab_mod_m2 (hash, htab);
+  hash2 = htab_probe_step (hash, htab);
   for (;;)
     {
       htab->collisions++;
@@ -607,7 +780,8 @@ htab_find_with_hash (htab_t htab, const PTR element, hashval_t hash)
 
       entry = htab->entries[index];
       if (entry == HTAB_EMPTY_ENTRY
-	  || (entry != HTAB_DELETED_ENTRY && (*htab->eq_f) (entry, element)))
+	  || (entry != HTAB_DELETED_ENTRY
+	      && htab_entry_eq (htab, index, entry, element, hash)))
 	return entry;
     }
 }
@@ -646,7 +820,7 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
       size = htab_size (htab);
     }
 
-  index = htab_mod (hash, htab);
+  index = htab_first_index (hash, htab);
 
   htab->searches++;
   first_deleted_slot = NULL;
@@ -656,10 +830,10 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
     goto empty_entry;
   else if (entry == HTAB_DELETED_ENTRY)
     first_deleted_slot = &htab->entries[index];
-  else if ((*htab->eq_f) (entry, element))
+  else if (htab_entry_eq (htab, index, entry, element, hash))
     return &htab->entries[index];
       
-  hash2 = htab_mod_m2 (hash, htab);
+  hash2 = htab_probe_step (hash, htab);
   for (;;)
     {
       htab->collisions++;
@@ -675,7 +849,7 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
 	  if (!first_deleted_slot)
 	    first_deleted_slot = &htab->entries[index];
 	}
-      else if ((*htab->eq_f) (entry, element))
+      else if (htab_entry_eq (htab, index, entry, element, hash))
 	return &htab->entries[index];
     }
 
@@ -687,10 +861,14 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
     {
       htab->n_deleted--;
       *first_deleted_slot = HTAB_EMPTY_ENTRY;
+      if (htab->hashes)
+	htab->hashes[first_deleted_slot - htab->entries] = hash;
       return first_deleted_slot;
     }
 
   htab->n_elements++;
+  if (htab->hashes)
+    htab->hashes[index] = hash;
   return &htab->entries[index];
 }
 
@@ -980,18 +1158,40 @@ iterative_hash (const PTR k_in /* the key */,
   return c;
 }
 
-/* Returns a hash code for pointer P. Simplified version of evahash */
+/*
+
+@deftypefn Supplemental hashval_t htab_hash_mix (hashval_t @var{hash})
+
+Scramble the bits of @var{hash} so that every bit of the result
+depends on every bit of @var{hash}, as for the final step of a hash
+function.  Different values of @var{hash} give different results.
+
+@end deftypefn
+
+*/
+
+/* This is the finalizer of MurmurHash3 by Austin Appleby, which is in
+   the public domain.  */
+
+hashval_t
+htab_hash_mix (hashval_t hash)
+{
+  hash &= 0xffffffff;
+  hash ^= hash >> 16;
+  hash = (hash * 0x85ebca6b) & 0xffffffff;
+  hash ^= hash >> 13;
+  hash = (hash * 0xc2b2ae35) & 0xffffffff;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/* Returns a hash code for pointer P.  */
 
 static hashval_t
 hash_pointer (const PTR p)
 {
   intptr_t v = (intptr_t) p;
-  unsigned a, b, c;
 
-  a = b = 0x9e3779b9;
-  a += v >> (sizeof (intptr_t) * CHAR_BIT / 2);
-  b += v & (((intptr_t) 1 << (sizeof (intptr_t) * CHAR_BIT / 2)) - 1);
-  c = 0x42135234;
-  mix (a, b, c);
-  return c;
+  return htab_hash_mix ((hashval_t) v
+			^ (hashval_t) (v >> (sizeof (intptr_t) * CHAR_BIT / 2)));
 }
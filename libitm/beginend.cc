@@ -43,6 +43,87 @@ unsigned GTM::gtm_thread::number_of_threads = 0;
 /* ??? Move elsewhere when we figure out library initialization.  */
 uint64_t GTM::gtm_spin_count_var = 1000;
 
+atomic<uint32_t> GTM::gtm_htm_site_skip[GTM_HTM_SITES];
+
+#ifdef USE_HTM_FASTPATH
+// Adaptive retry policy for the HTM fastpath.  A HW transaction that
+// aborts for a persistent reason, typically because it exceeds the HW
+// capacity, is unlikely to ever succeed at the same transaction site.
+// So after such an abort, the site skips HTM for its next 2^penalty
+// transactions.  The penalty grows with every persistent abort and
+// decays whenever a skipping period runs out, so that sites which only
+// sometimes abort persistently keep using HTM most of the time.
+// Transient aborts (conflicts) are retried up to htm_fastpath times
+// with exponential backoff.  Sites are hashed into a small table by the
+// address that called _ITM_beginTransaction; colliding sites merely
+// share their statistics.
+static atomic<uint32_t> htm_site_penalty[GTM_HTM_SITES];
+static const uint32_t htm_max_penalty = 12;
+
+static atomic<gtm_word> htm_conflict_aborts;
+static atomic<gtm_word> htm_persistent_aborts;
+static atomic<gtm_word> htm_skipped;
+static atomic<gtm_word> htm_fallbacks;
+
+static inline uint32_t
+htm_site_index (const gtm_jmpbuf *jb)
+{
+  return (htm_jmpbuf_site (jb) >> 2) & (GTM_HTM_SITES - 1);
+}
+
+// Accounts for a transaction at site IX that skipped HTM.
+static void
+htm_site_skip_taken (uint32_t ix)
+{
+  uint32_t skip = gtm_htm_site_skip[ix].load (memory_order_relaxed);
+
+  htm_skipped.fetch_add (1, memory_order_relaxed);
+  if (skip > 0
+      && gtm_htm_site_skip[ix].compare_exchange_strong (skip, skip - 1,
+							memory_order_relaxed)
+      && skip == 1)
+    {
+      uint32_t penalty = htm_site_penalty[ix].load (memory_order_relaxed);
+      if (penalty > 0)
+	htm_site_penalty[ix].store (penalty - 1, memory_order_relaxed);
+    }
+}
+
+// Accounts for a persistent abort of a HW transaction at site IX.
+static void
+htm_site_persistent_abort (uint32_t ix)
+{
+  uint32_t penalty = htm_site_penalty[ix].load (memory_order_relaxed);
+
+  htm_persistent_aborts.fetch_add (1, memory_order_relaxed);
+  htm_fallbacks.fetch_add (1, memory_order_relaxed);
+  if (penalty < htm_max_penalty)
+    htm_site_penalty[ix].store (++penalty, memory_order_relaxed);
+  gtm_htm_site_skip[ix].store (1u << penalty, memory_order_relaxed);
+}
+
+// Waits before the RETRIES-th retry after a transient abort.
+static void
+htm_backoff (uint32_t retries)
+{
+  for (uint32_t i = 16u << (retries < 8 ? retries : 8); i; i--)
+    cpu_relax ();
+}
+#endif
+
+void ITM_REGPARM
+_ITM_getHTMStatistics (_ITM_HTMStatistics *stats)
+{
+#ifdef USE_HTM_FASTPATH
+  stats->conflict_aborts = htm_conflict_aborts.load (memory_order_relaxed);
+  stats->persistent_aborts = htm_persistent_aborts.load (memory_order_relaxed);
+  stats->skipped = htm_skipped.load (memory_order_relaxed);
+  stats->fallbacks = htm_fallbacks.load (memory_order_relaxed);
+#else
+  memset (stats, 0, sizeof (*stats));
+#endif
+}
+
 #ifdef HAVE_64BIT_SYNC_BUILTINS
 static atomic<_ITM_transactionId_t> global_tid;
 #else
@@ -201,9 +282,16 @@ GTM::gtm_thread::begin_transaction (uint32_t prop, const gtm_jmpbuf *jb)
       // Note that the snapshot of htm_fastpath that we take here could be
       // outdated, and a different method group than dispatch_htm may have
       // been chosen in the meantime.  Therefore, take care not not touch
-      // anything besides the serial lock, which is independent of method
-      // groups.
-      for (uint32_t t = serial_lock.get_htm_fastpath(); t; t--)
+      // anything besides the serial lock and the HTM statistics, which are
+      // independent of method groups.
+      uint32_t htm_site = htm_site_index(jb);
+      uint32_t retries = serial_lock.get_htm_fastpath();
+      if (gtm_htm_site_skip[htm_site].load(memory_order_relaxed) != 0)
+	{
+	  htm_site_skip_taken(htm_site);
+	  retries = 0;
+	}
+      for (uint32_t t = retries; t; t--)
 	{
 	  uint32_t ret = htm_begin();
 	  if (htm_begin_success(ret))
@@ -223,9 +311,19 @@ GTM::gtm_thread::begin_transaction (uint32_t prop, const gtm_jmpbuf *jb)
 		    a_runUninstrumentedCode : a_runInstrumentedCode;
 	    }
 	  // The transaction has aborted.  Don't retry if it's unlikely that
-	  // retrying the transaction will be successful.
+	  // retrying the transaction will be successful, and don't even try
+	  // HTM for a while at this site.
+	  if (htm_abort_is_persistent(ret))
+	    {
+	      htm_site_persistent_abort(htm_site);
+	      break;
+	    }
 	  if (!htm_abort_should_retry(ret))
-	    break;
+	    {
+	      htm_fallbacks.fetch_add(1, memory_order_relaxed);
+	      break;
+	    }
+	  htm_conflict_aborts.fetch_add(1, memory_order_relaxed);
 	  // Check whether the HTM fastpath has been disabled.
 	  if (!serial_lock.get_htm_fastpath())
 	    break;
@@ -254,6 +352,10 @@ GTM::gtm_thread::begin_transaction (uint32_t prop, const gtm_jmpbuf *jb)
 	      // we have retried so often that we should go serial to avoid
 	      // starvation.
 	    }
+	  else
+	    htm_backoff(retries - t);
+	  if (t == 1)
+	    htm_fallbacks.fetch_add(1, memory_order_relaxed);
 	}
     }
 #else
@@ -266,8 +368,17 @@ GTM::gtm_thread::begin_transaction (uint32_t prop, const gtm_jmpbuf *jb)
   // HTM fastpath aborted, and that we thus have to decide whether to retry
   // the fastpath (returning a_tryHTMFastPath) or just proceed with the
   // fallback method.
-  if (likely(serial_lock.get_htm_fastpath() && (prop & pr_HTMRetryableAbort)))
+  // pr_HTMPersistentAbort and pr_HTMSiteSkipped state that the custom
+  // fastpath gave up on HTM right away, because the HW transaction
+  // aborted persistently or because the site's statistics said so.
+  if (unlikely(prop & pr_HTMSiteSkipped))
+    htm_site_skip_taken(htm_site_index(jb));
+  else if (unlikely(prop & pr_HTMPersistentAbort))
+    htm_site_persistent_abort(htm_site_index(jb));
+  else if (likely(serial_lock.get_htm_fastpath()
+		  && (prop & pr_HTMRetryableAbort)))
     {
+      htm_conflict_aborts.fetch_add(1, memory_order_relaxed);
       tx = gtm_thr();
       if (unlikely(tx == NULL))
         {
@@ -295,9 +406,12 @@ GTM::gtm_thread::begin_transaction (uint32_t prop, const gtm_jmpbuf *jb)
 	      serial_lock.read_lock(tx);
 	      serial_lock.read_unlock(tx);
 	    }
+	  else
+	    htm_backoff(serial_lock.get_htm_fastpath() - tx->restart_total);
 	  // Let ITM_beginTransaction retry the custom HTM fastpath.
 	  return a_tryHTMFastPath;
 	}
+      htm_fallbacks.fetch_add(1, memory_order_relaxed);
     }
  stop_custom_htm_fastpath:
 #endif
@@ -660,6 +774,7 @@ GTM::gtm_thread::trycommit ()
 	      while (it->shared_state.load(memory_order_acquire) < priv_time)
 		cpu_relax();
 	    }
+	  abi_disp()->privatization_safe (priv_time);
 	}
 
       // After ensuring privatization safety, we are now truly inactive and
@@ -128,6 +128,19 @@ htm_abort_should_retry (uint32_t begin_ret)
   return begin_ret != _TBEGIN_PERSISTENT;
 }
 
+static inline bool
+htm_abort_is_persistent (uint32_t begin_ret)
+{
+  return begin_ret == _TBEGIN_PERSISTENT;
+}
+
+/* Returns the address that called _ITM_beginTransaction.  */
+static inline uintptr_t
+htm_jmpbuf_site (const gtm_jmpbuf *jb)
+{
+  return jb->pc;
+}
+
 /* Returns true iff a hardware transaction is currently being executed.  */
 static inline bool
 htm_transaction_active (void)
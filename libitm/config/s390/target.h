@@ -118,6 +118,20 @@ htm_abort_should_retry (uint32_t begin_ret)
   return begin_ret == _HTM_TBEGIN_TRANSIENT;
 }
 
+static inline bool
+htm_abort_is_persistent (uint32_t begin_ret)
+{
+  return begin_ret == _HTM_TBEGIN_PERSISTENT;
+}
+
+/* Returns the address that called _ITM_beginTransaction, which is in the
+   saved r14.  */
+static inline uintptr_t
+htm_jmpbuf_site (const gtm_jmpbuf *jb)
+{
+  return jb->__gregs[8];
+}
+
 static inline bool
 htm_transaction_active ()
 {
@@ -126,6 +126,26 @@ htm_abort_should_retry (uint32_t begin_ret)
   return begin_ret & _XABORT_RETRY;
 }
 
+// Returns true iff retrying will not help, which is mostly the case when
+// the transaction exceeds the HW capacity.  Explicit aborts come from a
+// busy serial lock, which is transient.
+static inline bool
+htm_abort_is_persistent (uint32_t begin_ret)
+{
+  return !(begin_ret & (_XABORT_RETRY | _XABORT_EXPLICIT));
+}
+
+// Returns the address that called _ITM_beginTransaction.
+static inline uintptr_t
+htm_jmpbuf_site (const gtm_jmpbuf *jb)
+{
+#ifdef __x86_64__
+  return jb->rip;
+#else
+  return jb->eip;
+#endif
+}
+
 /* Returns true iff a hardware transaction is currently being executed.  */
 static inline bool
 htm_transaction_active ()
@@ -295,6 +295,9 @@ public:
   // this transaction cannot be the reason why other transactions cannot
   // ensure privatization safety.
   virtual bool snapshot_most_recent() = 0;
+  // Called after privatization safety has been ensured for PRIV_TIME, as
+  // requested by trycommit(), and before the transaction becomes inactive.
+  virtual void privatization_safe(gtm_word priv_time) { }
 
   // Return an alternative method that is compatible with the current
   // method but supports closed nesting. Return zero if there is none.
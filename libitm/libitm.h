@@ -101,7 +101,9 @@ typedef enum
    /* These are not part of the ABI but used for custom HTM fast paths.  See
       ITM_beginTransaction and gtm_thread::begin_transaction.  */
    pr_HTMRetryableAbort		= 0x800000,
-   pr_HTMRetriedAfterAbort	= 0x1000000
+   pr_HTMRetriedAfterAbort	= 0x1000000,
+   pr_HTMPersistentAbort	= 0x2000000,
+   pr_HTMSiteSkipped		= 0x4000000
 } _ITM_codeProperties;
 
 /* Result from startTransaction that describes what actions to take.
@@ -168,6 +170,21 @@ extern void *_ITM_calloc (size_t, size_t)
 
 extern  void _ITM_free (void *) ITM_PURE;
 
+/* Counts of how HW transactions started by the HTM fast path ended, if
+   they did not commit, since the program started.  */
+typedef struct
+{
+  uint64_t conflict_aborts;	/* Transient aborts, which may be retried.  */
+  uint64_t persistent_aborts;	/* Aborts that retrying will not fix, such
+				   as exceeding the HW capacity.  */
+  uint64_t skipped;		/* Transactions that did not try HTM because
+				   their site aborted persistently before.  */
+  uint64_t fallbacks;		/* Transactions that tried HTM and then ran
+				   in another mode.  */
+} _ITM_HTMStatistics;
+
+extern void _ITM_getHTMStatistics (_ITM_HTMStatistics *) ITM_REGPARM;
+
 
 /* The following typedefs exist to make the macro expansions below work
    properly.  They are not part of any API.  */
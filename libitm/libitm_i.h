@@ -344,6 +344,16 @@ extern abi_dispatch *dispatch_gl_wt();
 extern abi_dispatch *dispatch_ml_wt();
 extern abi_dispatch *dispatch_htm();
 
+// The number of transaction sites the HTM fastpath keeps statistics for;
+// see beginend.cc.  Must be a power of two.  Duplicated in some of the
+// ITM_beginTransaction implementations.
+#define GTM_HTM_SITES 256
+
+// For each transaction site, the number of transactions that will skip
+// the HTM fastpath.  Accessed from assembly language.
+extern atomic<uint32_t> gtm_htm_site_skip[GTM_HTM_SITES]
+	__asm__(UPFX "gtm_htm_site_skip");
+
 
 } // namespace GTM
 
@@ -69,6 +69,14 @@ struct ml_mg : public method_group
   atomic<gtm_word>* orecs __attribute__((aligned(HW_CACHELINE_SIZE)));
   char tailpadding[HW_CACHELINE_SIZE - sizeof(atomic<gtm_word>*)];
 
+  // The largest snapshot time for which privatization safety has already
+  // been ensured by some committing transaction.  Read-only transactions
+  // whose snapshot is not more recent than that do not need to wait for
+  // other threads on commit.  It is on its own cache line because it is
+  // read by every read-only commit but written only after update commits.
+  atomic<gtm_word> priv_safe_time __attribute__((aligned(HW_CACHELINE_SIZE)));
+  char tailpadding2[HW_CACHELINE_SIZE - sizeof(atomic<gtm_word>)];
+
   // Location-to-orec mapping.  Stripes of 32B mapped to 2^16 orecs using
   // multiplicative hashing.  See Section 5.2.2 of Torvald Riegel's PhD thesis
   // for the background on this choice of hash function and parameters:
@@ -77,8 +85,15 @@ struct ml_mg : public method_group
   // less space overhead and just 32b multiplication).
   // We may want to check and potentially change these settings once we get
   // better or just more benchmarks.
-  static const gtm_word L2O_ORECS_BITS = 16;
-  static const gtm_word L2O_ORECS = 1 << L2O_ORECS_BITS;
+  // The number of orecs can be changed with the ITM_ORECS_BITS environment
+  // variable; it is read when the method group is first initialized.
+  // Workloads with large data sets and many threads can reduce false
+  // conflicts due to hash collisions by using more orecs.
+  static const gtm_word L2O_ORECS_BITS_DEFAULT = 16;
+  static const gtm_word L2O_ORECS_BITS_MIN = 10;
+  static const gtm_word L2O_ORECS_BITS_MAX = 24;
+  static gtm_word L2O_ORECS_BITS;
+  static gtm_word L2O_ORECS;
   // An iterator over the orecs covering the region [addr,addr+len).
   struct orec_iterator
   {
@@ -115,15 +130,44 @@ struct ml_mg : public method_group
     bool reached_end() { return orec == orec_end; }
   };
 
+  static void parse_orecs_bits()
+  {
+    const char *env = getenv("ITM_ORECS_BITS");
+    if (env == NULL)
+      return;
+    char *end;
+    unsigned long bits = strtoul(env, &end, 10);
+    if (end == env || *end != '\0'
+	|| bits < L2O_ORECS_BITS_MIN || bits > L2O_ORECS_BITS_MAX)
+      {
+	GTM_error("Invalid ITM_ORECS_BITS value: %s", env);
+	return;
+      }
+    L2O_ORECS_BITS = bits;
+    L2O_ORECS = (gtm_word)1 << bits;
+  }
+
   virtual void init()
   {
+    // We only need to parse the environment on the first initialization;
+    // the orec iterators of concurrent transactions are not affected
+    // because this is executed while holding the serial lock.
+    static bool parsed_env = false;
+    if (!parsed_env)
+      {
+	parse_orecs_bits();
+	parsed_env = true;
+      }
     // We assume that an atomic<gtm_word> is backed by just a gtm_word, so
-    // starting with zeroed memory is fine.
+    // starting with zeroed memory is fine.  Allocate the orecs on separate
+    // cache lines so that the first and last orecs are not falsely shared
+    // with unrelated data.
     orecs = (atomic<gtm_word>*) xcalloc(
         sizeof(atomic<gtm_word>) * L2O_ORECS, true);
-    // This store is only executed while holding the serial lock, so relaxed
-    // memory order is sufficient here.
+    // These stores are only executed while holding the serial lock, so
+    // relaxed memory order is sufficient here.
     time.store(0, memory_order_relaxed);
+    priv_safe_time.store(0, memory_order_relaxed);
   }
 
   virtual void fini()
@@ -138,10 +182,14 @@ struct ml_mg : public method_group
     // This store is only executed while holding the serial lock, so relaxed
     // memory order is sufficient here.  Same holds for the memset.
     time.store(0, memory_order_relaxed);
+    priv_safe_time.store(0, memory_order_relaxed);
     memset(orecs, 0, sizeof(atomic<gtm_word>) * L2O_ORECS);
   }
 };
 
+gtm_word ml_mg::L2O_ORECS_BITS = ml_mg::L2O_ORECS_BITS_DEFAULT;
+gtm_word ml_mg::L2O_ORECS = (gtm_word)1 << ml_mg::L2O_ORECS_BITS_DEFAULT;
+
 static ml_mg o_ml_mg;
 
 
@@ -527,7 +575,16 @@ public:
         // we at least can run transactions such as this one, and in the
         // meantime the transaction producing this commit time might have
         // finished ensuring privatization safety for it.
-        priv_time = tx->shared_state.load(memory_order_relaxed);
+        // If some other transaction has already ensured privatization safety
+        // for a time at least as recent as our snapshot, this also holds for
+        // our snapshot, and we do not have to look at the other threads at
+        // all.  The acquire MO synchronizes with the release MO store in
+        // privatization_safe().
+        gtm_word snapshot = tx->shared_state.load(memory_order_relaxed);
+        if (snapshot <= o_ml_mg.priv_safe_time.load(memory_order_acquire))
+          priv_time = 0;
+        else
+          priv_time = snapshot;
         return true;
       }
 
@@ -637,6 +694,19 @@ public:
     return true;
   }
 
+  virtual void privatization_safe(gtm_word priv_time)
+  {
+    // Remember the most recent time for which privatization safety has
+    // been ensured (see trycommit()).  We use release MO so that read-only
+    // transactions which rely on this synchronize with the acquire MO loads
+    // of all the other threads' shared_state done by our caller.
+    gtm_word t = o_ml_mg.priv_safe_time.load(memory_order_relaxed);
+    while (t < priv_time
+	   && !o_ml_mg.priv_safe_time.compare_exchange_weak(t, priv_time,
+		memory_order_release, memory_order_relaxed))
+      ;
+  }
+
   virtual bool supports(unsigned number_of_threads)
   {
     // Each txn can commit and fail and rollback once before checking for
@@ -83,10 +83,16 @@ xmalloc (size_t size, bool separate_cl)
 void *
 xcalloc (size_t size, bool separate_cl)
 {
-  // TODO Use posix_memalign if separate_cl is true, or some other allocation
-  // method that will avoid sharing cache lines with data used by other
-  // threads.
-  void *r = calloc (1, size);
+  void *r;
+#ifdef HAVE_POSIX_MEMALIGN
+  if (separate_cl)
+    {
+      r = xmalloc (size, true);
+      memset (r, 0, size);
+      return r;
+    }
+#endif
+  r = calloc (1, size);
   if (r == 0)
     GTM_fatal ("Out of memory allocating %lu bytes", (unsigned long) size);
   return r;
@@ -492,6 +492,37 @@ move_bounds (void *dst, const void *src, size_t n)
   return;
 }
 
+/* Bounds tables are allocated by the kernel on the first bounds store
+   into the memory they cover, and each allocation costs a #BR trap.
+   __mpx_prefault_bounds_tables allocates all bounds tables covering
+   N bytes starting at PTR at once, so that code storing many pointers
+   into a large region does not trap on the hot path.
+   It returns 0 on success and -1 if some table could not be
+   allocated.  */
+__attribute__ ((bnd_legacy)) int
+__mpx_prefault_bounds_tables (const void *ptr, size_t n)
+{
+  bd_type bd = (bd_type)get_bd ();
+  mpx_pointer addr_start, addr_end;
+  unsigned long bd_index;
+
+  if (!(bd))
+    return -1;
+
+  if (n == 0)
+    return 0;
+
+  addr_start.pointer = (char *) ptr;
+  addr_end.pointer = (char *) ptr + n - 1;
+
+  for (bd_index = addr_start.l1index; bd_index <= addr_end.l1index;
+       bd_index++)
+    if (!get_bt (bd_index, bd))
+      return -1;
+
+  return 0;
+}
+
 static void *
 mpx_wrapper_memmove (void *dst, const void *src, size_t n)
 {
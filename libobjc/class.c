@@ -844,6 +844,9 @@ __objc_update_classes_with_methods (struct objc_method *method_a, struct objc_me
 	  node = node->next;
 	}
     }
+
+  /* Call site caches may hold the old implementations.  */
+  __objc_invalidate_method_caches ();
 }
 
 /* Resolve super/subclass links for all classes.  The only thing we
@@ -51,6 +51,7 @@ extern void __objc_init_dispatch_tables (void); /* (objc-dispatch.c) */
 extern void __objc_install_premature_dtable (Class); /* (objc-dispatch.c) */
 extern void __objc_resolve_class_links (void);  /* (objc-class.c) */
 extern void __objc_update_dispatch_table_for_class (Class);/* (objc-msg.c) */
+extern void __objc_invalidate_method_caches (void); /* (objc-msg.c) */
 
 extern int  __objc_init_thread_system (void);    /* thread.c */
 extern int  __objc_fini_thread_system (void);    /* thread.c */
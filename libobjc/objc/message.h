@@ -104,6 +104,28 @@ struct objc_super
    super->self was in class super->super_class.  */
 objc_EXPORT IMP objc_msg_lookup_super (struct objc_super *super, SEL sel);
 
+/* Cache of the last method implementation found at a message send
+   site.  The compiler, when invoked with -fobjc-call-site-cache,
+   generates a zero-initialized one of these for each message send
+   and passes it to objc_msg_lookup_cached().  The fields are private
+   to the runtime.  */
+struct objc_method_cache
+{
+  unsigned long version; /* Dispatch version the entry is valid for.  */
+  Class class_;          /* Class of the receiver the entry was filled for.  */
+  IMP imp;               /* The method implementation.  */
+};
+
+/* This is used by the compiler instead of objc_msg_lookup () when
+   compiling with -fobjc-call-site-cache.  It returns the same
+   implementation as objc_msg_lookup (receiver, op), but first checks
+   if 'cache' holds the implementation for the class of 'receiver',
+   in which case the dispatch table is not looked at.  The entry is
+   invalidated whenever any dispatch table changes, for example
+   because methods are added or replaced.  */
+objc_EXPORT IMP objc_msg_lookup_cached (id receiver, SEL op,
+					struct objc_method_cache *cache);
+
 /* Hooks for method forwarding.  They make it easy to substitute the
    built-in forwarding with one based on a library, such as ffi, that
    implement closures, thereby avoiding gcc's __builtin_apply
@@ -464,6 +464,82 @@ objc_msg_lookup_super (struct objc_super *super, SEL sel)
     return (IMP)nil_method;
 }
 
+/* The dispatch version stamps the entries of the call site caches
+   used by objc_msg_lookup_cached.  It is always even, and is
+   incremented (under the runtime lock) after any change to a dispatch
+   table, which invalidates all the cache entries at once.  It starts
+   at 2 so that zero-initialized caches are never valid.  */
+static unsigned long __objc_dispatch_version = 2;  /* !T:MUTEX */
+
+/* Odd version marking a cache entry that is being written.  */
+#define METHOD_CACHE_BUSY 1
+
+void
+__objc_invalidate_method_caches (void)
+{
+  __atomic_store_n (&__objc_dispatch_version, __objc_dispatch_version + 2,
+		    __ATOMIC_RELEASE);
+}
+
+/* Like objc_msg_lookup, but first try the call site cache CACHE.
+   The cache is read without locking, in the way of a sequence lock:
+   the entry is only used if its version is the current dispatch
+   version both before and after reading the class and the
+   implementation.  Entries are only filled from installed dispatch
+   tables (so never while +initialize is running) and only when the
+   runtime lock can be taken without waiting, which serializes the
+   writers.  A send site that sees many classes keeps the first class
+   it cached until the next invalidation rather than refilling the
+   entry on every send.  */
+IMP
+objc_msg_lookup_cached (id receiver, SEL op, struct objc_method_cache *cache)
+{
+  unsigned long version, entry_version;
+  Class class;
+  IMP result;
+
+  if (! receiver)
+    return (IMP)nil_method;
+
+  class = receiver->class_pointer;
+  version = __atomic_load_n (&__objc_dispatch_version, __ATOMIC_ACQUIRE);
+  entry_version = __atomic_load_n (&cache->version, __ATOMIC_ACQUIRE);
+  if (entry_version == version)
+    {
+      Class cached_class = __atomic_load_n (&cache->class_, __ATOMIC_RELAXED);
+      result = __atomic_load_n (&cache->imp, __ATOMIC_RELAXED);
+      __atomic_thread_fence (__ATOMIC_ACQUIRE);
+      if (cached_class == class
+	  && __atomic_load_n (&cache->version, __ATOMIC_RELAXED) == version)
+	return result;
+
+      /* The entry is current, but for another class.  */
+      return objc_msg_lookup (receiver, op);
+    }
+
+  result = sarray_get_safe (class->dtable, (sidx)op->sel_id);
+  if (result == 0)
+    return get_implementation (receiver, class, op);
+
+  if (objc_mutex_trylock (__objc_runtime_mutex) > 0)
+    {
+      /* The dispatch tables can not change while we hold the lock, so
+	 RESULT is only still valid if no invalidation happened since
+	 VERSION was read.  */
+      if (__objc_dispatch_version == version)
+	{
+	  __atomic_store_n (&cache->version, METHOD_CACHE_BUSY,
+			    __ATOMIC_RELAXED);
+	  __atomic_thread_fence (__ATOMIC_RELEASE);
+	  __atomic_store_n (&cache->class_, class, __ATOMIC_RELAXED);
+	  __atomic_store_n (&cache->imp, result, __ATOMIC_RELAXED);
+	  __atomic_store_n (&cache->version, version, __ATOMIC_RELEASE);
+	}
+      objc_mutex_unlock (__objc_runtime_mutex);
+    }
+  return result;
+}
+
 void
 __objc_init_dispatch_tables ()
 {
@@ -589,6 +665,8 @@ __objc_update_dispatch_table_for_class (Class class)
     for (next = class->subclass_list; next; next = next->sibling_class)
       __objc_update_dispatch_table_for_class (next);
 
+  __objc_invalidate_method_caches ();
+
   objc_mutex_unlock (__objc_runtime_mutex);
 }
 
@@ -0,0 +1,41 @@
+/* GCC Quad-Precision Math Library
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+This file is part of the libquadmath library.
+
+Libquadmath is free software; you can redistribute it and/or
+modify it under the terms of the GNU Library General Public
+License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+
+Libquadmath is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Library General Public License for more details.
+
+You should have received a copy of the GNU Library General Public
+License along with libquadmath; see the file COPYING.LIB.  If
+not, write to the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+Boston, MA 02110-1301, USA.  */
+
+#include "quadmath-imp.h"
+
+/* FUNC_n (x, y, n) stores FUNC (x[i]) in y[i] for each i < n.  The
+   results are the same as those of the scalar function, and X and Y
+   may be the same array.  */
+
+#define BATCHQ(func)						\
+void								\
+func ## _n (const __float128 *x, __float128 *y, size_t n)	\
+{								\
+  size_t i;							\
+								\
+  for (i = 0; i < n; i++)					\
+    y[i] = func (x[i]);						\
+}
+
+BATCHQ (cosq)
+BATCHQ (expq)
+BATCHQ (logq)
+BATCHQ (sinq)
+BATCHQ (sqrtq)
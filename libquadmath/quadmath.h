@@ -108,6 +108,13 @@ extern __float128 y1q (__float128) __quadmath_throw;
 extern __float128 ynq (int, __float128) __quadmath_throw;
 
 
+/* Prototypes for array versions of real functions */
+extern void cosq_n (const __float128 *, __float128 *, size_t) __quadmath_throw;
+extern void expq_n (const __float128 *, __float128 *, size_t) __quadmath_throw;
+extern void logq_n (const __float128 *, __float128 *, size_t) __quadmath_throw;
+extern void sinq_n (const __float128 *, __float128 *, size_t) __quadmath_throw;
+extern void sqrtq_n (const __float128 *, __float128 *, size_t) __quadmath_throw;
+
 /* Prototypes for complex functions */
 extern __float128 cabsq (__complex128) __quadmath_throw;
 extern __float128 cargq (__complex128) __quadmath_throw;
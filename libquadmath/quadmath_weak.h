@@ -103,6 +103,12 @@ __qmath3 (y0q)
 __qmath3 (y1q)
 __qmath3 (ynq)
 
+/* Prototypes for array versions of real functions.  */
+__qmath3 (cosq_n)
+__qmath3 (expq_n)
+__qmath3 (logq_n)
+__qmath3 (sinq_n)
+__qmath3 (sqrtq_n)
 
 /* Prototypes for complex functions.  */
 __qmath3 (cabsq)
@@ -54,6 +54,13 @@
 #include <sys/uio.h>
 #endif
 
+// Pick up mmap for __gnu_cxx::mmap_filebuf.
+#if defined __has_include
+# if __has_include(<sys/mman.h>)
+#  include <sys/mman.h>
+# endif
+#endif
+
 #if defined(_GLIBCXX_HAVE_S_ISREG) || defined(_GLIBCXX_HAVE_S_IFREG)
 # include <sys/stat.h>
 # ifdef _GLIBCXX_HAVE_S_ISREG
@@ -294,6 +301,39 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     return __ret;
   }
 
+  // Like xsgetn, but a single read fills __s1 and then __s2, so that a
+  // caller reading directly into its own storage can refill its buffer
+  // with the same system call.
+  streamsize
+  __basic_file<char>::xsgetn_2(char* __s1, streamsize __n1,
+			       char* __s2, streamsize __n2)
+  {
+#ifdef _GLIBCXX_HAVE_WRITEV
+    struct iovec __iov[2];
+    __iov[0].iov_base = __s1;
+    __iov[0].iov_len = __n1;
+    __iov[1].iov_base = __s2;
+    __iov[1].iov_len = __n2;
+
+    streamsize __ret;
+    do
+      __ret = readv(this->fd(), __iov, 2);
+    while (__ret == -1L && errno == EINTR);
+    return __ret;
+#else
+    return xsgetn(__s1, __n1);
+#endif
+  }
+
+  void
+  __basic_file<char>::advise_sequential() throw ()
+  {
+#if defined(_GLIBCXX_HAVE_UNISTD_H) && defined(POSIX_FADV_SEQUENTIAL)
+    // Only a hint: ask the kernel for more aggressive read-ahead.
+    posix_fadvise(this->fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  }
+
   streamsize
   __basic_file<char>::xsputn(const char* __s, streamsize __n)
   { return xwrite(this->fd(), __s, __n); }
@@ -378,3 +418,65 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 _GLIBCXX_END_NAMESPACE_VERSION
 } // namespace
 
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  // Support for <ext/mmap_filebuf.h>: map all of the regular file
+  // __name read-only.  An empty file is opened but not mapped.
+  bool
+  __map_file(const char* __name, const void** __addr,
+	     std::size_t* __len) throw ()
+  {
+#if defined(MAP_FAILED) \
+    && (defined(_GLIBCXX_HAVE_S_ISREG) || defined(_GLIBCXX_HAVE_S_IFREG))
+    int __fd;
+    do
+      __fd = ::open(__name, O_RDONLY);
+    while (__fd == -1 && errno == EINTR);
+    if (__fd == -1)
+      return false;
+
+    bool __ret = false;
+    struct stat __buffer;
+    if (fstat(__fd, &__buffer) == 0 && _GLIBCXX_ISREG(__buffer.st_mode)
+	&& __buffer.st_size >= 0
+	&& (unsigned long long)__buffer.st_size
+	   <= std::numeric_limits<std::size_t>::max())
+      {
+	*__addr = 0;
+	*__len = __buffer.st_size;
+	if (*__len == 0)
+	  __ret = true;
+	else
+	  {
+	    void* __p = mmap(0, *__len, PROT_READ, MAP_PRIVATE, __fd, 0);
+	    if (__p != MAP_FAILED)
+	      {
+#ifdef POSIX_MADV_SEQUENTIAL
+		posix_madvise(__p, *__len, POSIX_MADV_SEQUENTIAL);
+#endif
+		*__addr = __p;
+		__ret = true;
+	      }
+	  }
+      }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(__fd);
+    return __ret;
+#else
+    return false;
+#endif
+  }
+
+  void
+  __unmap_file(const void* __addr, std::size_t __len) throw ()
+  {
+#ifdef MAP_FAILED
+    if (__len)
+      munmap(const_cast<void*>(__addr), __len);
+#endif
+  }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
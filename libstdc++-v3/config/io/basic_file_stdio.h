@@ -114,6 +114,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       streamsize
       xsgetn(char* __s, streamsize __n);
 
+      streamsize
+      xsgetn_2(char* __s1, streamsize __n1, char* __s2, streamsize __n2);
+
+      void
+      advise_sequential() throw ();
+
       streamoff
       seekoff(streamoff __off, ios_base::seekdir __way) throw ();
 
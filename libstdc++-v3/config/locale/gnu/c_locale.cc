@@ -41,11 +41,96 @@ namespace std _GLIBCXX_VISIBILITY(default)
 {
 _GLIBCXX_BEGIN_NAMESPACE_VERSION
 
+namespace
+{
+  // Powers of ten that are exact in double.
+  const double __exact_pow10[] =
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  // num_get collects floating-point values as plain decimal strings.
+  // When the significand and the power of ten of such a string are both
+  // exact in _Tp, a single rounded multiplication or division gives the
+  // value strtod would, without going through the C library.  Returns
+  // false for any other string.
+  template<typename _Tp>
+    bool
+    __convert_exact(const char* __s, _Tp& __v, int __max_pow10)
+    {
+#if __FLT_EVAL_METHOD__ == 0
+      const bool __neg = *__s == '-';
+      if (*__s == '-' || *__s == '+')
+	++__s;
+
+      unsigned long long __m = 0;
+      int __digits = 0;
+      int __exp = 0;
+      bool __found = false;
+      for (; *__s >= '0' && *__s <= '9'; ++__s)
+	{
+	  __found = true;
+	  if ((__m || *__s != '0') && ++__digits > 19)
+	    return false;
+	  __m = __m * 10 + (*__s - '0');
+	}
+      if (*__s == '.')
+	for (++__s; *__s >= '0' && *__s <= '9'; ++__s)
+	  {
+	    __found = true;
+	    if ((__m || *__s != '0') && ++__digits > 19)
+	      return false;
+	    __m = __m * 10 + (*__s - '0');
+	    --__exp;
+	  }
+      if (!__found)
+	return false;
+
+      if (*__s == 'e' || *__s == 'E')
+	{
+	  ++__s;
+	  const bool __eneg = *__s == '-';
+	  if (*__s == '-' || *__s == '+')
+	    ++__s;
+	  if (*__s < '0' || *__s > '9')
+	    return false;
+	  int __e = 0;
+	  for (; *__s >= '0' && *__s <= '9'; ++__s)
+	    {
+	      if (__e > 1000)
+		return false;
+	      __e = __e * 10 + (*__s - '0');
+	    }
+	  __exp += __eneg ? -__e : __e;
+	}
+
+      if (*__s != '\0'
+	  || (__m >> numeric_limits<_Tp>::digits) != 0
+	  || __exp < -__max_pow10 || __exp > __max_pow10)
+	return false;
+
+      _Tp __r = _Tp(__m);
+      if (__exp < 0)
+	__r /= _Tp(__exact_pow10[-__exp]);
+      else
+	__r *= _Tp(__exact_pow10[__exp]);
+      __v = __neg ? -__r : __r;
+      return true;
+#else
+      return false;
+#endif
+    }
+} // anonymous namespace
+
   template<>
     void
     __convert_to_v(const char* __s, float& __v, ios_base::iostate& __err,
 		   const __c_locale& __cloc) throw()
     {
+      if (__convert_exact(__s, __v, 10))
+	return;
+
       char* __sanity;
       __v = __strtof_l(__s, &__sanity, __cloc);
 
@@ -73,6 +158,9 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __convert_to_v(const char* __s, double& __v, ios_base::iostate& __err,
 		   const __c_locale& __cloc) throw()
     {
+      if (__convert_exact(__s, __v, 22))
+	return;
+
       char* __sanity;
       __v = __strtod_l(__s, &__sanity, __cloc);
 
@@ -57,6 +57,14 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _M_futex_wait_until(unsigned *__addr, unsigned __val, bool __has_timeout,
 	chrono::seconds __s, chrono::nanoseconds __ns);
 
+#ifdef _GLIBCXX_USE_CLOCK_MONOTONIC
+    // Returns false iff a timeout occurred.  The timeout is measured
+    // against chrono::steady_clock.
+    bool
+    _M_futex_wait_until_steady(unsigned *__addr, unsigned __val,
+	bool __has_timeout, chrono::seconds __s, chrono::nanoseconds __ns);
+#endif
+
     // This can be executed after the object has been destroyed.
     static void _M_futex_notify_all(unsigned* __addr);
   };
@@ -65,6 +73,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
   class __atomic_futex_unsigned : __atomic_futex_unsigned_base
   {
     typedef chrono::system_clock __clock_t;
+#ifdef _GLIBCXX_USE_CLOCK_MONOTONIC
+    typedef chrono::steady_clock __steady_clock_t;
+#else
+    typedef chrono::system_clock __steady_clock_t;
+#endif
 
     // This must be lock-free and at offset 0.
     atomic<unsigned> _M_data;
@@ -81,15 +94,36 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     }
 
   private:
+    // Re-read the value a bounded number of times before the caller goes
+    // to sleep, because it is usually about to change.  Returns true if
+    // the value has become the operand's value (if equal is true) or a
+    // different one (if equal is false), and updates __i in any case.
+    bool
+    _M_spin(unsigned& __i, unsigned __operand, bool __equal,
+	    memory_order __mo)
+    {
+      for (int __n = 0; __n < 64; ++__n)
+	{
+#if defined __i386__ || defined __x86_64__
+	  __builtin_ia32_pause();
+#endif
+	  __i = _M_data.load(__mo);
+	  if (((__i & ~_Waiter_bit) == __operand) == __equal)
+	    return true;
+	}
+      return false;
+    }
+
     // If a timeout occurs, returns a current value after the timeout;
     // otherwise, returns the operand's value if equal is true or a different
     // value if equal is false.
     // The assumed value is the caller's assumption about the current value
     // when making the call.
+    // The timeout is measured against steady_clock if __steady is true.
     unsigned
     _M_load_and_test_until(unsigned __assumed, unsigned __operand,
 	bool __equal, memory_order __mo, bool __has_timeout,
-	chrono::seconds __s, chrono::nanoseconds __ns)
+	chrono::seconds __s, chrono::nanoseconds __ns, bool __steady = false)
     {
       for (;;)
 	{
@@ -99,9 +133,17 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	  // modification order (store_notify uses an atomic RMW operation too),
 	  // and the futex syscalls synchronize between themselves.
 	  _M_data.fetch_or(_Waiter_bit, memory_order_relaxed);
-	  bool __ret = _M_futex_wait_until((unsigned*)(void*)&_M_data,
-					   __assumed | _Waiter_bit,
-					   __has_timeout, __s, __ns);
+	  bool __ret;
+#ifdef _GLIBCXX_USE_CLOCK_MONOTONIC
+	  if (__steady)
+	    __ret = _M_futex_wait_until_steady((unsigned*)(void*)&_M_data,
+					       __assumed | _Waiter_bit,
+					       __has_timeout, __s, __ns);
+	  else
+#endif
+	    __ret = _M_futex_wait_until((unsigned*)(void*)&_M_data,
+					__assumed | _Waiter_bit,
+					__has_timeout, __s, __ns);
 	  // Fetch the current value after waiting (clears _Waiter_bit).
 	  __assumed = _M_load(__mo);
 	  if (!__ret || ((__operand == __assumed) == __equal))
@@ -140,6 +182,20 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	  true, __s.time_since_epoch(), __ns);
     }
 
+#ifdef _GLIBCXX_USE_CLOCK_MONOTONIC
+    template<typename _Dur>
+    unsigned
+    _M_load_and_test_until_impl(unsigned __assumed, unsigned __operand,
+	bool __equal, memory_order __mo,
+	const chrono::time_point<__steady_clock_t, _Dur>& __atime)
+    {
+      auto __s = chrono::time_point_cast<chrono::seconds>(__atime);
+      auto __ns = chrono::duration_cast<chrono::nanoseconds>(__atime - __s);
+      return _M_load_and_test_until(__assumed, __operand, __equal, __mo,
+	  true, __s.time_since_epoch(), __ns, true);
+    }
+#endif
+
   public:
 
     _GLIBCXX_ALWAYS_INLINE unsigned
@@ -148,7 +204,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       unsigned __i = _M_load(__mo);
       if ((__i & ~_Waiter_bit) != __val)
 	return (__i & ~_Waiter_bit);
-      // TODO Spin-wait first.
+      if (_M_spin(__i, __val, false, __mo))
+	return (__i & ~_Waiter_bit);
       return _M_load_and_test(__i, __val, false, __mo);
     }
 
@@ -158,7 +215,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       unsigned __i = _M_load(__mo);
       if ((__i & ~_Waiter_bit) == __val)
 	return;
-      // TODO Spin-wait first.
+      if (_M_spin(__i, __val, true, __mo))
+	return;
       _M_load_and_test(__i, __val, true, __mo);
     }
 
@@ -168,8 +226,10 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       _M_load_when_equal_for(unsigned __val, memory_order __mo,
 	  const chrono::duration<_Rep, _Period>& __rtime)
       {
+	// Relative timeouts must not be affected by changes to the
+	// system clock.
 	return _M_load_when_equal_until(__val, __mo,
-					__clock_t::now() + __rtime);
+					__steady_clock_t::now() + __rtime);
       }
 
     // Returns false iff a timeout occurred.
@@ -195,10 +255,29 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       unsigned __i = _M_load(__mo);
       if ((__i & ~_Waiter_bit) == __val)
 	return true;
-      // TODO Spin-wait first.  Ignore effect on timeout.
+      // Ignore the effect of spinning on the timeout.
+      if (_M_spin(__i, __val, true, __mo))
+	return true;
+      __i = _M_load_and_test_until_impl(__i, __val, true, __mo, __atime);
+      return (__i & ~_Waiter_bit) == __val;
+    }
+
+#ifdef _GLIBCXX_USE_CLOCK_MONOTONIC
+    // Returns false iff a timeout occurred.
+    template<typename _Duration>
+    _GLIBCXX_ALWAYS_INLINE bool
+    _M_load_when_equal_until(unsigned __val, memory_order __mo,
+	const chrono::time_point<__steady_clock_t, _Duration>& __atime)
+    {
+      unsigned __i = _M_load(__mo);
+      if ((__i & ~_Waiter_bit) == __val)
+	return true;
+      if (_M_spin(__i, __val, true, __mo))
+	return true;
       __i = _M_load_and_test_until_impl(__i, __val, true, __mo, __atime);
       return (__i & ~_Waiter_bit) == __val;
     }
+#endif
 
     _GLIBCXX_ALWAYS_INLINE void
     _M_store_notify_all(unsigned __val, memory_order __mo)
@@ -6120,6 +6120,39 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     { };
 #endif
 
+#if __cplusplus > 201402L && _GLIBCXX_USE_CXX11_ABI
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _CharT, typename _Traits = char_traits<_CharT>>
+      using basic_string = std::basic_string<_CharT, _Traits,
+					     polymorphic_allocator<_CharT>>;
+    using string    = basic_string<char>;
+#ifdef _GLIBCXX_USE_C99_STDINT_TR1
+    using u16string = basic_string<char16_t>;
+    using u32string = basic_string<char32_t>;
+#endif
+#ifdef _GLIBCXX_USE_WCHAR_T
+    using wstring   = basic_string<wchar_t>;
+#endif
+  } // namespace pmr
+
+  /// std::hash specialization for strings using a polymorphic_allocator.
+  template<typename _CharT>
+    struct hash<pmr::basic_string<_CharT>>
+    : public __hash_base<size_t, pmr::basic_string<_CharT>>
+    {
+      size_t
+      operator()(const pmr::basic_string<_CharT>& __s) const noexcept
+      { return std::_Hash_impl::hash(__s.data(),
+                                     __s.length() * sizeof(_CharT)); }
+    };
+
+  template<typename _CharT>
+    struct __is_fast_hash<hash<pmr::basic_string<_CharT>>> : std::false_type
+    { };
+#endif // C++17
+
 _GLIBCXX_END_NAMESPACE_VERSION
 
 #if __cplusplus > 201103L
@@ -1248,9 +1248,14 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	{
 	  __pos = std::min(size_type(__size - __n), __pos);
 	  const _CharT* __data = _M_data();
+	  if (__n == 0)
+	    return __pos;
+	  // Only call compare where the first chars are equal.
+	  const _CharT __elem0 = __s[0];
 	  do
 	    {
-	      if (traits_type::compare(__data + __pos, __s, __n) == 0)
+	      if (traits_type::eq(__data[__pos], __elem0)
+		  && traits_type::compare(__data + __pos, __s, __n) == 0)
 		return __pos;
 	    }
 	  while (__pos-- > 0);
@@ -1275,6 +1280,85 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       return npos;
     }
 
+  // Table of a set of chars, for the find_*_of members of std::string:
+  // testing a char is then a lookup instead of a search of the set.
+  template<typename _CharT, typename _Traits>
+    struct __string_char_set
+    {
+      static const bool _S_enabled = false;
+
+      __string_char_set(const _CharT*, size_t)
+      { }
+
+      bool
+      _M_contains(_CharT) const
+      { return false; }
+    };
+
+  template<>
+    struct __string_char_set<char, char_traits<char>>
+    {
+      static const bool _S_enabled = true;
+
+      __string_char_set(const char* __s, size_t __n)
+      {
+	__builtin_memset(_M_bits, 0, sizeof(_M_bits));
+	for (; __n; --__n, ++__s)
+	  {
+	    const unsigned char __c = *__s;
+	    _M_bits[__c / 8] |= 1u << (__c % 8);
+	  }
+      }
+
+      bool
+      _M_contains(char __ch) const
+      {
+	const unsigned char __c = __ch;
+	return _M_bits[__c / 8] & (1u << (__c % 8));
+      }
+
+    private:
+      unsigned char _M_bits[256 / 8];
+    };
+
+  // Common part of the find_*_of members: the index of the first char of
+  // __data[__pos, __size), or of the last one of __data[0, __pos] if
+  // _Backward, that is in the set [__s, __s + __n) if _In, or that is not
+  // in it otherwise.
+  template<bool _In, bool _Backward, typename _Traits, typename _CharT>
+    inline size_t
+    __str_find_of(const _CharT* __data, size_t __size, size_t __pos,
+		  const _CharT* __s, size_t __n)
+    {
+      typedef __string_char_set<_CharT, _Traits> _Set;
+      if (_Backward && __size && __pos >= __size)
+	__pos = __size - 1;
+      if (__pos >= __size)
+	return size_t(-1);
+
+      // Searching the set is faster when the result is close, after a few
+      // chars building a table of the set pays for itself.
+      size_t __probes = 8;
+      for (;;)
+	{
+	  if (_Set::_S_enabled && __n > 1 && __probes-- == 0)
+	    {
+	      const _Set __set(__s, __n);
+	      for (;;)
+		{
+		  if (__set._M_contains(__data[__pos]) == _In)
+		    return __pos;
+		  if (_Backward ? __pos-- == 0 : ++__pos == __size)
+		    return size_t(-1);
+		}
+	    }
+	  if (bool(_Traits::find(__s, __n, __data[__pos])) == _In)
+	    return __pos;
+	  if (_Backward ? __pos-- == 0 : ++__pos == __size)
+	    return size_t(-1);
+	}
+    }
+
   template<typename _CharT, typename _Traits, typename _Alloc>
     typename basic_string<_CharT, _Traits, _Alloc>::size_type
     basic_string<_CharT, _Traits, _Alloc>::
@@ -1282,13 +1366,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _GLIBCXX_NOEXCEPT
     {
       __glibcxx_requires_string_len(__s, __n);
-      for (; __n && __pos < this->size(); ++__pos)
-	{
-	  const _CharT* __p = traits_type::find(__s, __n, _M_data()[__pos]);
-	  if (__p)
-	    return __pos;
-	}
-      return npos;
+      if (__n == 0)
+	return npos;
+      if (__n == 1)
+	return find(__s[0], __pos);
+      return std::__str_find_of<true, false, _Traits>(_M_data(), this->size(),
+						     __pos, __s, __n);
     }
 
   template<typename _CharT, typename _Traits, typename _Alloc>
@@ -1298,19 +1381,10 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _GLIBCXX_NOEXCEPT
     {
       __glibcxx_requires_string_len(__s, __n);
-      size_type __size = this->size();
-      if (__size && __n)
-	{
-	  if (--__size > __pos)
-	    __size = __pos;
-	  do
-	    {
-	      if (traits_type::find(__s, __n, _M_data()[__size]))
-		return __size;
-	    }
-	  while (__size-- != 0);
-	}
-      return npos;
+      if (__n == 0)
+	return npos;
+      return std::__str_find_of<true, true, _Traits>(_M_data(), this->size(),
+						     __pos, __s, __n);
     }
 
   template<typename _CharT, typename _Traits, typename _Alloc>
@@ -1320,10 +1394,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _GLIBCXX_NOEXCEPT
     {
       __glibcxx_requires_string_len(__s, __n);
-      for (; __pos < this->size(); ++__pos)
-	if (!traits_type::find(__s, __n, _M_data()[__pos]))
-	  return __pos;
-      return npos;
+      return std::__str_find_of<false, false, _Traits>(_M_data(), this->size(),
+						     __pos, __s, __n);
     }
 
   template<typename _CharT, typename _Traits, typename _Alloc>
@@ -1344,19 +1416,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _GLIBCXX_NOEXCEPT
     {
       __glibcxx_requires_string_len(__s, __n);
-      size_type __size = this->size();
-      if (__size)
-	{
-	  if (--__size > __pos)
-	    __size = __pos;
-	  do
-	    {
-	      if (!traits_type::find(__s, __n, _M_data()[__size]))
-		return __size;
-	    }
-	  while (__size--);
-	}
-      return npos;
+      return std::__str_find_of<false, true, _Traits>(_M_data(), this->size(),
+						     __pos, __s, __n);
     }
 
   template<typename _CharT, typename _Traits, typename _Alloc>
@@ -564,10 +564,19 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       static const char_type*
       find(const char_type* __s, size_t __n, const char_type& __a)
       {
+#if defined(_GLIBCXX_USE_WCHAR_T) && __SIZEOF_WCHAR_T__ == 4
+	// wmemchr is usually vectorized, and only compares the values.
+	if (__n == 0)
+	  return 0;
+	return reinterpret_cast<const char_type*>(
+	    wmemchr(reinterpret_cast<const wchar_t*>(__s),
+		    static_cast<wchar_t>(__a), __n));
+#else
 	for (size_t __i = 0; __i < __n; ++__i)
 	  if (eq(__s[__i], __a))
 	    return __s + __i;
 	return 0;
+#endif
       }
 
       static char_type*
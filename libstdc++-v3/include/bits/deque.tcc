@@ -1106,6 +1106,256 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
     }
 #endif
 
+  template<typename _Tp, typename _Ref, typename _Ptr, typename _Up>
+    _Deque_iterator<_Tp, _Ref, _Ptr>
+    find(_Deque_iterator<_Tp, _Ref, _Ptr> __first,
+	 _Deque_iterator<_Tp, _Ref, _Ptr> __last, const _Up& __val)
+    {
+      typedef _Deque_iterator<_Tp, _Ref, _Ptr> _Self;
+      typedef typename _Self::_Elt_pointer _Elt_pointer;
+
+      if (__first._M_node != __last._M_node)
+	{
+	  for (; __first._M_cur != __first._M_last; ++__first._M_cur)
+	    if (static_cast<_Ref>(*__first._M_cur) == __val)
+	      return __first;
+
+	  for (typename _Self::_Map_pointer __node = __first._M_node + 1;
+	       __node < __last._M_node; ++__node)
+	    {
+	      const _Elt_pointer __end = *__node + _Self::_S_buffer_size();
+	      for (_Elt_pointer __cur = *__node; __cur != __end; ++__cur)
+		if (static_cast<_Ref>(*__cur) == __val)
+		  {
+		    __first._M_set_node(__node);
+		    __first._M_cur = __cur;
+		    return __first;
+		  }
+	    }
+	  __first = __last;
+	  __first._M_cur = __first._M_first;
+	}
+
+      for (; __first._M_cur != __last._M_cur; ++__first._M_cur)
+	if (static_cast<_Ref>(*__first._M_cur) == __val)
+	  break;
+      return __first;
+    }
+
+  template<typename _Tp, typename _Ref, typename _Ptr, typename _Function>
+    _Function
+    for_each(_Deque_iterator<_Tp, _Ref, _Ptr> __first,
+	     _Deque_iterator<_Tp, _Ref, _Ptr> __last, _Function __f)
+    {
+      typedef _Deque_iterator<_Tp, _Ref, _Ptr> _Self;
+      typedef typename _Self::_Elt_pointer _Elt_pointer;
+
+      if (__first._M_node != __last._M_node)
+	{
+	  for (_Elt_pointer __cur = __first._M_cur; __cur != __first._M_last;
+	       ++__cur)
+	    __f(static_cast<_Ref>(*__cur));
+
+	  for (typename _Self::_Map_pointer __node = __first._M_node + 1;
+	       __node < __last._M_node; ++__node)
+	    {
+	      const _Elt_pointer __end = *__node + _Self::_S_buffer_size();
+	      for (_Elt_pointer __cur = *__node; __cur != __end; ++__cur)
+		__f(static_cast<_Ref>(*__cur));
+	    }
+	  __first = __last;
+	  __first._M_cur = __first._M_first;
+	}
+
+      for (_Elt_pointer __cur = __first._M_cur; __cur != __last._M_cur; ++__cur)
+	__f(static_cast<_Ref>(*__cur));
+      return _GLIBCXX_MOVE(__f);
+    }
+
+  template<typename _Tp, typename _OI>
+    _OI
+    copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*> __first,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*> __last, _OI __result)
+    {
+      typedef _Deque_iterator<_Tp, const _Tp&, const _Tp*> _Self;
+
+      if (__first._M_node != __last._M_node)
+	{
+	  __result = std::copy(static_cast<const _Tp*>(__first._M_cur),
+			       static_cast<const _Tp*>(__first._M_last),
+			       __result);
+
+	  for (typename _Self::_Map_pointer __node = __first._M_node + 1;
+	       __node < __last._M_node; ++__node)
+	    __result = std::copy(static_cast<const _Tp*>(*__node),
+				 static_cast<const _Tp*>(*__node
+							 + _Self::_S_buffer_size()),
+				 __result);
+
+	  return std::copy(static_cast<const _Tp*>(__last._M_first),
+			   static_cast<const _Tp*>(__last._M_cur), __result);
+	}
+
+      return std::copy(static_cast<const _Tp*>(__first._M_cur),
+		       static_cast<const _Tp*>(__last._M_cur), __result);
+    }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    __copy_to_deque(_II __first, _II __last,
+		    _Deque_iterator<_Tp, _Tp&, _Tp*> __result,
+		    std::input_iterator_tag)
+    {
+      for (; __first != __last; ++__first, (void)++__result)
+	*__result = *__first;
+      return __result;
+    }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    __copy_to_deque(_II __first, _II __last,
+		    _Deque_iterator<_Tp, _Tp&, _Tp*> __result,
+		    std::random_access_iterator_tag)
+    {
+      typedef typename _Deque_iterator<_Tp, _Tp&, _Tp*>::difference_type
+	difference_type;
+
+      difference_type __len = __last - __first;
+      while (__len > 0)
+	{
+	  const difference_type __clen
+	    = std::min(__len, difference_type(__result._M_last
+					      - __result._M_cur));
+	  std::copy(__first, __first + __clen, __result._M_cur);
+	  __first += __clen;
+	  __result += __clen;
+	  __len -= __clen;
+	}
+      return __result;
+    }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    copy(_II __first, _II __last, _Deque_iterator<_Tp, _Tp&, _Tp*> __result)
+    {
+      return _GLIBCXX_STD_C::__copy_to_deque(__first, __last, __result,
+				  std::__iterator_category(__first));
+    }
+
+  template<typename _Tp, typename _Up>
+    _Deque_iterator<_Up, _Up&, _Up*>
+    copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*> __first,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*> __last,
+	 _Deque_iterator<_Up, _Up&, _Up*> __result)
+    {
+      typedef typename _Deque_iterator<_Up, _Up&, _Up*>::difference_type
+	difference_type;
+
+      difference_type __len = __last - __first;
+      while (__len > 0)
+	{
+	  const difference_type __clen
+	    = std::min(__len, std::min(__first._M_last - __first._M_cur,
+				       __result._M_last - __result._M_cur));
+	  std::copy(static_cast<const _Tp*>(__first._M_cur),
+		    static_cast<const _Tp*>(__first._M_cur + __clen),
+		    __result._M_cur);
+	  __first += __clen;
+	  __result += __clen;
+	  __len -= __clen;
+	}
+      return __result;
+    }
+
+#if __cplusplus >= 201103L
+  template<typename _Tp, typename _OI>
+    _OI
+    move(_Deque_iterator<_Tp, const _Tp&, const _Tp*> __first,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*> __last, _OI __result)
+    {
+      typedef _Deque_iterator<_Tp, const _Tp&, const _Tp*> _Self;
+
+      if (__first._M_node != __last._M_node)
+	{
+	  __result = std::move(__first._M_cur, __first._M_last, __result);
+
+	  for (typename _Self::_Map_pointer __node = __first._M_node + 1;
+	       __node < __last._M_node; ++__node)
+	    __result = std::move(*__node, *__node + _Self::_S_buffer_size(),
+				 __result);
+
+	  return std::move(__last._M_first, __last._M_cur, __result);
+	}
+
+      return std::move(__first._M_cur, __last._M_cur, __result);
+    }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    __move_to_deque(_II __first, _II __last,
+		    _Deque_iterator<_Tp, _Tp&, _Tp*> __result,
+		    std::input_iterator_tag)
+    {
+      for (; __first != __last; ++__first, (void)++__result)
+	*__result = std::move(*__first);
+      return __result;
+    }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    __move_to_deque(_II __first, _II __last,
+		    _Deque_iterator<_Tp, _Tp&, _Tp*> __result,
+		    std::random_access_iterator_tag)
+    {
+      typedef typename _Deque_iterator<_Tp, _Tp&, _Tp*>::difference_type
+	difference_type;
+
+      difference_type __len = __last - __first;
+      while (__len > 0)
+	{
+	  const difference_type __clen
+	    = std::min(__len, difference_type(__result._M_last
+					      - __result._M_cur));
+	  std::move(__first, __first + __clen, __result._M_cur);
+	  __first += __clen;
+	  __result += __clen;
+	  __len -= __clen;
+	}
+      return __result;
+    }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    move(_II __first, _II __last, _Deque_iterator<_Tp, _Tp&, _Tp*> __result)
+    {
+      return _GLIBCXX_STD_C::__move_to_deque(__first, __last, __result,
+				  std::__iterator_category(__first));
+    }
+
+  template<typename _Tp, typename _Up>
+    _Deque_iterator<_Up, _Up&, _Up*>
+    move(_Deque_iterator<_Tp, const _Tp&, const _Tp*> __first,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*> __last,
+	 _Deque_iterator<_Up, _Up&, _Up*> __result)
+    {
+      typedef typename _Deque_iterator<_Up, _Up&, _Up*>::difference_type
+	difference_type;
+
+      difference_type __len = __last - __first;
+      while (__len > 0)
+	{
+	  const difference_type __clen
+	    = std::min(__len, std::min(__first._M_last - __first._M_cur,
+				       __result._M_last - __result._M_cur));
+	  std::move(__first._M_cur, __first._M_cur + __clen, __result._M_cur);
+	  __first += __clen;
+	  __result += __clen;
+	  __len -= __clen;
+	}
+      return __result;
+    }
+#endif
+
 _GLIBCXX_END_NAMESPACE_CONTAINER
 } // namespace std
 
@@ -1430,6 +1430,19 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
     { __lx.swap(__ly); }
 
 _GLIBCXX_END_NAMESPACE_CONTAINER
+
+#if __cplusplus > 201402L && !defined _GLIBCXX_DEBUG \
+    && !defined _GLIBCXX_PROFILE
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Tp>
+      using forward_list
+	= _GLIBCXX_STD_C::forward_list<_Tp, polymorphic_allocator<_Tp>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif // _FORWARD_LIST_H
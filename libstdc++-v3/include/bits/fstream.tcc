@@ -187,6 +187,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	      _M_allocate_internal_buffer();
 	      _M_mode = __mode;
 
+	      // A buffer larger than the default, requested with
+	      // setbuf(0, n), is a sign of mostly sequential reads.
+	      if (_M_buf_size > BUFSIZ
+		  && !(__mode & (ios_base::out | ios_base::app)))
+		_M_file.advise_sequential();
+
 	      // Setup initial buffer to 'uncommitted' mode.
 	      _M_reading = false;
 	      _M_writing = false;
@@ -677,17 +683,29 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
  	     }
  
  	   // Need to loop in case of short reads (relatively common
- 	   // with pipes).
+ 	   // with pipes).  When buffered, each read also refills the
+ 	   // buffer with whatever follows the requested chars.
  	   streamsize __len;
+	   streamsize __extra = 0;
  	   for (;;)
  	     {
- 	       __len = _M_file.xsgetn(reinterpret_cast<char*>(__s),
- 				      __n);
+	       if (_M_buf_size > 1)
+		 __len = _M_file.xsgetn_2(reinterpret_cast<char*>(__s), __n,
+					  reinterpret_cast<char*>(_M_buf),
+					  __buflen);
+	       else
+		 __len = _M_file.xsgetn(reinterpret_cast<char*>(__s), __n);
  	       if (__len == -1)
  		 __throw_ios_failure(__N("basic_filebuf::xsgetn "
  					 "error reading the file"));
  	       if (__len == 0)
  		 break;
+
+	       if (__len > __n)
+		 {
+		   __extra = __len - __n;
+		   __len = __n;
+		 }
  
  	       __n -= __len;
  	       __ret += __len;
@@ -699,7 +717,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
  
  	   if (__n == 0)
  	     {
- 	       _M_set_buffer(0);
+ 	       _M_set_buffer(__extra);
  	       _M_reading = true;
  	     }
  	   else if (__len == 0)
@@ -774,6 +792,13 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	{
 	  if (__s == 0 && __n == 0)
 	    _M_buf_size = 1;
+	  else if (__s == 0 && __n > 0)
+	    {
+	      // Also implementation-defined: an internal buffer of __n
+	      // positions is allocated by open instead of the default one.
+	      _M_buf = 0;
+	      _M_buf_size = __n;
+	    }
 	  else if (__s && __n > 0)
 	    {
 	      // This is implementation-defined behavior, and assumes that
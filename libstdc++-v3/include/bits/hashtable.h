@@ -1008,6 +1008,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	    {
 	      // Replacement allocator cannot free existing storage.
 	      this->_M_deallocate_nodes(_M_begin());
+	      this->_M_release_spare_nodes();
 	      _M_before_begin._M_nxt = nullptr;
 	      _M_deallocate_buckets();
 	      _M_buckets = nullptr;
@@ -1155,6 +1156,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _M_move_assign(_Hashtable&& __ht, std::true_type)
     {
       this->_M_deallocate_nodes(_M_begin());
+      this->_M_release_spare_nodes();
       _M_deallocate_buckets();
       __hashtable_base::operator=(std::move(__ht));
       _M_rehash_policy = __ht._M_rehash_policy;
@@ -1169,6 +1171,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       _M_before_begin._M_nxt = __ht._M_before_begin._M_nxt;
       _M_element_count = __ht._M_element_count;
       std::__alloc_on_move(this->_M_node_allocator(), __ht._M_node_allocator());
+#if _GLIBCXX_HASHTABLE_RECYCLE_NODES
+      // The allocators are now equal, the spare nodes can follow the other
+      // ones.
+      this->_M_spare_nodes = __ht._M_spare_nodes;
+      __ht._M_spare_nodes = nullptr;
+#endif
 
       // Fix buckets containing the _M_before_begin pointers that can't be
       // moved.
@@ -1361,7 +1369,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	       _H1, _H2, _Hash, _RehashPolicy, _Traits>::
     ~_Hashtable() noexcept
     {
-      clear();
+      this->_M_deallocate_nodes(_M_begin());
       _M_deallocate_buckets();
     }
 
@@ -1382,6 +1390,9 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       this->_M_swap(__x);
 
       std::__alloc_on_swap(this->_M_node_allocator(), __x._M_node_allocator());
+#if _GLIBCXX_HASHTABLE_RECYCLE_NODES
+      std::swap(this->_M_spare_nodes, __x._M_spare_nodes);
+#endif
       std::swap(_M_rehash_policy, __x._M_rehash_policy);
 
       // Deal properly with potentially moved instances.
@@ -2035,7 +2046,9 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	       _H1, _H2, _Hash, _RehashPolicy, _Traits>::
     clear() noexcept
     {
-      this->_M_deallocate_nodes(_M_begin());
+      // When _GLIBCXX_HASHTABLE_RECYCLE_NODES is defined the nodes are kept
+      // and reused by the following insertions, like the buckets are.
+      this->_M_recycle_nodes(_M_begin());
       __builtin_memset(_M_buckets, 0, _M_bucket_count * sizeof(__bucket_type));
       _M_element_count = 0;
       _M_before_begin._M_nxt = nullptr;
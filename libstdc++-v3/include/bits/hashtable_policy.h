@@ -1992,6 +1992,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
   /**
    * This type deals with all allocation and keeps an allocator instance through
    * inheritance to benefit from EBO when possible.
+   *
+   * When _GLIBCXX_HASHTABLE_RECYCLE_NODES is defined to a non-zero value the
+   * nodes released by clear() are kept and reused by the next insertions,
+   * which helps containers that are cleared and refilled over and over.
+   * This changes the layout of the unordered containers, so the macro must
+   * have the same value in all the translation units sharing them.
    */
   template<typename _NodeAlloc>
     struct _Hashtable_alloc : private _Hashtable_ebo_helper<0, _NodeAlloc>
@@ -2016,8 +2022,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       using __bucket_alloc_traits = std::allocator_traits<__bucket_alloc_type>;
 
       _Hashtable_alloc() = default;
+#if _GLIBCXX_HASHTABLE_RECYCLE_NODES
+      // The spare nodes belong to one container, copies don't share them.
+      _Hashtable_alloc(const _Hashtable_alloc& __x)
+	: __ebo_node_alloc(static_cast<const __ebo_node_alloc&>(__x))
+	{ }
+
+      _Hashtable_alloc(_Hashtable_alloc&& __x)
+	: __ebo_node_alloc(static_cast<__ebo_node_alloc&&>(__x)),
+	  _M_spare_nodes(__x._M_spare_nodes)
+	{ __x._M_spare_nodes = nullptr; }
+
+      ~_Hashtable_alloc()
+      { _M_release_spare_nodes(); }
+#else
       _Hashtable_alloc(const _Hashtable_alloc&) = default;
       _Hashtable_alloc(_Hashtable_alloc&&) = default;
+#endif
 
       template<typename _Alloc>
 	_Hashtable_alloc(_Alloc&& __a)
@@ -2043,6 +2064,28 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       void
       _M_deallocate_nodes(__node_type* __n);
 
+#if _GLIBCXX_HASHTABLE_RECYCLE_NODES
+      // Destroy the values of the linked list of nodes pointed to by __n
+      // and keep the nodes for later calls to _M_allocate_node.
+      void
+      _M_recycle_nodes(__node_type* __n);
+
+      // Deallocate the nodes kept by _M_recycle_nodes.
+      void
+      _M_release_spare_nodes();
+
+      // Nodes whose values have been destroyed, linked through _M_nxt.
+      __node_type* _M_spare_nodes = nullptr;
+#else
+      void
+      _M_recycle_nodes(__node_type* __n)
+      { _M_deallocate_nodes(__n); }
+
+      void
+      _M_release_spare_nodes()
+      { }
+#endif
+
       __bucket_type*
       _M_allocate_buckets(std::size_t __n);
 
@@ -2057,6 +2100,17 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       typename _Hashtable_alloc<_NodeAlloc>::__node_type*
       _Hashtable_alloc<_NodeAlloc>::_M_allocate_node(_Args&&... __args)
       {
+#if _GLIBCXX_HASHTABLE_RECYCLE_NODES
+	if (__node_type* __n = _M_spare_nodes)
+	  {
+	    __value_alloc_type __a(_M_node_allocator());
+	    __value_alloc_traits::construct(__a, __n->_M_valptr(),
+					    std::forward<_Args>(__args)...);
+	    _M_spare_nodes = __n->_M_next();
+	    __n->_M_nxt = nullptr;
+	    return __n;
+	  }
+#endif
 	auto __nptr = __node_alloc_traits::allocate(_M_node_allocator(), 1);
 	__node_type* __n = std::__addressof(*__nptr);
 	__try
@@ -2098,6 +2152,37 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	}
     }
 
+#if _GLIBCXX_HASHTABLE_RECYCLE_NODES
+  template<typename _NodeAlloc>
+    void
+    _Hashtable_alloc<_NodeAlloc>::_M_recycle_nodes(__node_type* __n)
+    {
+      __value_alloc_type __a(_M_node_allocator());
+      while (__n)
+	{
+	  __node_type* __tmp = __n;
+	  __n = __n->_M_next();
+	  __value_alloc_traits::destroy(__a, __tmp->_M_valptr());
+	  __tmp->_M_nxt = _M_spare_nodes;
+	  _M_spare_nodes = __tmp;
+	}
+    }
+
+  template<typename _NodeAlloc>
+    void
+    _Hashtable_alloc<_NodeAlloc>::_M_release_spare_nodes()
+    {
+      typedef typename __node_alloc_traits::pointer _Ptr;
+      while (__node_type* __n = _M_spare_nodes)
+	{
+	  _M_spare_nodes = __n->_M_next();
+	  auto __ptr = std::pointer_traits<_Ptr>::pointer_to(*__n);
+	  __n->~__node_type();
+	  __node_alloc_traits::deallocate(_M_node_allocator(), __ptr, 1);
+	}
+    }
+#endif
+
   template<typename _NodeAlloc>
     typename _Hashtable_alloc<_NodeAlloc>::__bucket_type*
     _Hashtable_alloc<_NodeAlloc>::_M_allocate_buckets(std::size_t __n)
@@ -1585,6 +1585,19 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     // Construct and return valid scanf format for floating point types.
     static void
     _S_format_float(const ios_base& __io, char* __fptr, char __mod) throw();
+
+    // Write __v to __out as the format built by _S_format_float would,
+    // from the shortest decimal representation of __v, when that is
+    // exact at precision __prec.  Returns the length, or -1 if the
+    // value has to go through the C library.
+    static int
+    _S_format_float_shortest(const ios_base& __io, char* __out, int __size,
+			     streamsize __prec, double __v) throw();
+
+    static int
+    _S_format_float_shortest(const ios_base&, char*, int, streamsize,
+			     long double) throw()
+    { return -1; }
   };
 
   template<typename _CharT>
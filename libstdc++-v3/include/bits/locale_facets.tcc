@@ -1001,12 +1001,18 @@ _GLIBCXX_BEGIN_NAMESPACE_LDBL
 	// for non-ios_base::fixed outputs)
 	int __cs_size = __max_digits * 3;
 	char* __cs = static_cast<char*>(__builtin_alloca(__cs_size));
-	if (__use_prec)
-	  __len = std::__convert_from_v(_S_get_c_locale(), __cs, __cs_size,
-					__fbuf, __prec, __v);
-	else
-	  __len = std::__convert_from_v(_S_get_c_locale(), __cs, __cs_size,
-					__fbuf, __v);
+	// Most values are exact at the requested precision and need no
+	// call to the C library.
+	__len = _S_format_float_shortest(__io, __cs, __cs_size, __prec, __v);
+	if (__len < 0)
+	  {
+	    if (__use_prec)
+	      __len = std::__convert_from_v(_S_get_c_locale(), __cs, __cs_size,
+					    __fbuf, __prec, __v);
+	    else
+	      __len = std::__convert_from_v(_S_get_c_locale(), __cs, __cs_size,
+					    __fbuf, __v);
+	  }
 
 	// If the buffer was not large enough, try again with the correct size.
 	if (__len >= __cs_size)
@@ -401,7 +401,50 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       const _UIntType __upper_mask = (~_UIntType()) << __r;
       const _UIntType __lower_mask = ~__upper_mask;
 
-      for (size_t __k = 0; __k < (__n - __m); ++__k)
+      size_t __k = 0;
+#ifdef __SSE2__
+      // Twist several words at a time.  Each word only depends on the
+      // words after it and on words at least __n - __m before it, so
+      // this gives the same results as the scalar loops below as long as
+      // a vector is not longer than __n - __m words.
+#ifdef __AVX2__
+      typedef _UIntType __vec_type __attribute__((__vector_size__(32)));
+#else
+      typedef _UIntType __vec_type __attribute__((__vector_size__(16)));
+#endif
+      const size_t __lanes = sizeof(__vec_type) / sizeof(_UIntType);
+      if (__n - __m >= __lanes)
+	{
+	  __vec_type __x, __x1, __xm, __y;
+	  for (; __k + __lanes <= __n - __m; __k += __lanes)
+	    {
+	      __builtin_memcpy(&__x, _M_x + __k, sizeof(__x));
+	      __builtin_memcpy(&__x1, _M_x + __k + 1, sizeof(__x1));
+	      __builtin_memcpy(&__xm, _M_x + __k + __m, sizeof(__xm));
+	      __y = (__x & __upper_mask) | (__x1 & __lower_mask);
+	      __x = __xm ^ (__y >> 1) ^ (-(__y & 1) & __a);
+	      __builtin_memcpy(_M_x + __k, &__x, sizeof(__x));
+	    }
+	  for (; __k < __n - __m; ++__k)
+	    {
+	      _UIntType __y = ((_M_x[__k] & __upper_mask)
+			       | (_M_x[__k + 1] & __lower_mask));
+	      _M_x[__k] = (_M_x[__k + __m] ^ (__y >> 1)
+			   ^ ((__y & 0x01) ? __a : 0));
+	    }
+	  for (; __k + __lanes <= __n - 1; __k += __lanes)
+	    {
+	      __builtin_memcpy(&__x, _M_x + __k, sizeof(__x));
+	      __builtin_memcpy(&__x1, _M_x + __k + 1, sizeof(__x1));
+	      __builtin_memcpy(&__xm, _M_x + __k - (__n - __m), sizeof(__xm));
+	      __y = (__x & __upper_mask) | (__x1 & __lower_mask);
+	      __x = __xm ^ (__y >> 1) ^ (-(__y & 1) & __a);
+	      __builtin_memcpy(_M_x + __k, &__x, sizeof(__x));
+	    }
+	}
+#endif
+
+      for (; __k < (__n - __m); ++__k)
         {
 	  _UIntType __y = ((_M_x[__k] & __upper_mask)
 			   | (_M_x[__k + 1] & __lower_mask));
@@ -409,7 +452,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 		       ^ ((__y & 0x01) ? __a : 0));
         }
 
-      for (size_t __k = (__n - __m); __k < (__n - 1); ++__k)
+      for (; __k < (__n - 1); ++__k)
 	{
 	  _UIntType __y = ((_M_x[__k] & __upper_mask)
 			   | (_M_x[__k + 1] & __lower_mask));
@@ -3322,6 +3365,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       const size_t __log2r = std::log(__r) / std::log(2.0L);
       const size_t __m = std::max<size_t>(1UL,
 					  (__b + __log2r - 1UL) / __log2r);
+      // When the range is a power of two, as for mt19937, __tmp can be
+      // scaled exactly in _RealType instead of in long double.
+      typedef typename _UniformRandomNumberGenerator::result_type _UIntType;
+      const _UIntType __range = __urng.max() - __urng.min();
+      const bool __r_pow2 = (__range & (__range + 1)) == 0;
       _RealType __ret;
       do
 	{
@@ -3330,7 +3378,10 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	  for (size_t __k = __m; __k != 0; --__k)
 	    {
 	      __sum += _RealType(__urng() - __urng.min()) * __tmp;
-	      __tmp *= __r;
+	      if (__r_pow2)
+		__tmp *= _RealType(__r);
+	      else
+		__tmp *= __r;
 	    }
 	  __ret = __sum / __tmp;
 	}
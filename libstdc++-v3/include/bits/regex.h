@@ -2798,6 +2798,23 @@ _GLIBCXX_BEGIN_NAMESPACE_CXX11
   //@} // group regex
 
 _GLIBCXX_END_NAMESPACE_CXX11
+
+#if __cplusplus > 201402L && _GLIBCXX_USE_CXX11_ABI
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _BidirectionalIterator>
+      using match_results
+	= std::match_results<_BidirectionalIterator, polymorphic_allocator<
+				sub_match<_BidirectionalIterator>>>;
+    using cmatch  = match_results<const char*>;
+    using smatch  = match_results<string::const_iterator>;
+#ifdef _GLIBCXX_USE_WCHAR_T
+    using wcmatch = match_results<const wchar_t*>;
+    using wsmatch = match_results<wstring::const_iterator>;
+#endif
+  } // namespace pmr
+#endif // C++17
 _GLIBCXX_END_NAMESPACE_VERSION
 } // namespace
 
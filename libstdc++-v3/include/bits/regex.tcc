@@ -60,27 +60,64 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       for (auto& __it : __res)
 	__it.matched = false;
 
-      bool __ret;
-      if ((__re.flags() & regex_constants::__polynomial)
-	  || (__policy == _RegexExecutorPolicy::_S_alternate
-	      && !__re._M_automaton->_M_has_backref))
+      bool __ret = false;
+      bool __run_executor = true;
+      _BiIter __first = __s;
+      const _DFA* __dfa = __re._M_automaton->_M_dfa.get();
+      if (__dfa && __policy == _RegexExecutorPolicy::_S_auto
+	  && !(__flags & regex_constants::match_not_null))
 	{
-	  _Executor<_BiIter, _Alloc, _TraitsT, false>
-	    __executor(__s, __e, __m, __re, __flags);
+	  // Reject the inputs that don't match without running an executor.
+	  // When there is a match, the executor is only run from where the
+	  // leftmost match begins, to find its end and the sub-matches.
 	  if (__match_mode)
-	    __ret = __executor._M_match();
+	    {
+	      if (!__dfa->_M_match(__s, __e))
+		__run_executor = false;
+	      else if (__re._M_automaton->_M_sub_count() == 1)
+		{
+		  __res[0].first = __s;
+		  __res[0].second = __e;
+		  __res[0].matched = true;
+		  __ret = true;
+		  __run_executor = false;
+		}
+	    }
+	  else if (!__dfa->_M_search(__first, __e,
+				     __flags & regex_constants::match_continuous))
+	    __run_executor = false;
 	  else
-	    __ret = __executor._M_search();
+	    {
+	      if (__first != __s)
+		__flags |= regex_constants::match_prev_avail;
+	      __flags |= regex_constants::match_continuous;
+	    }
 	}
-      else
+
+      if (__run_executor)
 	{
-	  _Executor<_BiIter, _Alloc, _TraitsT, true>
-	    __executor(__s, __e, __m, __re, __flags);
-	  if (__match_mode)
-	    __ret = __executor._M_match();
+	  if ((__re.flags() & regex_constants::__polynomial)
+	      || (__policy == _RegexExecutorPolicy::_S_alternate
+		  && !__re._M_automaton->_M_has_backref))
+	    {
+	      _Executor<_BiIter, _Alloc, _TraitsT, false>
+		__executor(__first, __e, __m, __re, __flags);
+	      if (__match_mode)
+		__ret = __executor._M_match();
+	      else
+		__ret = __executor._M_search();
+	    }
 	  else
-	    __ret = __executor._M_search();
+	    {
+	      _Executor<_BiIter, _Alloc, _TraitsT, true>
+		__executor(__first, __e, __m, __re, __flags);
+	      if (__match_mode)
+		__ret = __executor._M_match();
+	      else
+		__ret = __executor._M_search();
+	    }
 	}
+
       if (__ret)
 	{
 	  for (auto& __it : __res)
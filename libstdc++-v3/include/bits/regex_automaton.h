@@ -33,6 +33,12 @@
 #define _GLIBCXX_REGEX_STATE_LIMIT 100000
 #endif
 
+// This macro defines the maximal state number of the DFA built for a char
+// regex.  Regexes needing more states are only run by the NFA executors.
+#ifndef _GLIBCXX_REGEX_DFA_STATE_LIMIT
+#define _GLIBCXX_REGEX_DFA_STATE_LIMIT 512
+#endif
+
 namespace std _GLIBCXX_VISIBILITY(default)
 {
 namespace __detail
@@ -181,6 +187,91 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       }
     };
 
+  /**
+   *  A deterministic automaton recognizing the same strings as a char NFA
+   *  without back-references or assertions.  It is built when the regex
+   *  is compiled and tells, in a single table-driven pass over the input,
+   *  whether and where the regex matches; the executors only run to
+   *  compute the sub-matches.
+   *
+   *  The chars are mapped to classes of chars that no matcher of the NFA
+   *  tells apart, so the matchers are called only while building the DFA.
+   */
+  struct _DFA
+  {
+    typedef int _StateT;
+
+    // The state that can't reach an accepting state anymore.
+    static constexpr _StateT _S_dead = 0;
+
+    _StateT
+    _M_next(_StateT __s, char __c) const
+    {
+      return _M_trans[__s * _M_class_count
+		      + _M_class[static_cast<unsigned char>(__c)]];
+    }
+
+    bool
+    _M_accepts(_StateT __s) const
+    { return _M_accepting[__s]; }
+
+    // Whether the whole of [__s, __e) is matched.
+    template<typename _BiIter>
+      bool
+      _M_match(_BiIter __s, _BiIter __e) const;
+
+    // Whether a substring of [__s, __e) is matched, or a prefix of it if
+    // __continuous is true.  On success __s is moved to the leftmost
+    // position a match begins at.
+    template<typename _BiIter>
+      bool
+      _M_search(_BiIter& __s, _BiIter __e, bool __continuous) const;
+
+    // Whether a match begins at __s.
+    template<typename _BiIter>
+      bool
+      _M_match_prefix(_BiIter __s, _BiIter __e) const;
+
+    // Position of the first __c in [__s, __e), or __e.
+    template<typename _BiIter>
+      static _BiIter
+      _S_find(_BiIter __s, _BiIter __e, char __c)
+      {
+	while (__s != __e && *__s != __c)
+	  ++__s;
+	return __s;
+      }
+
+    static const char*
+    _S_find(const char* __s, const char* __e, char __c)
+    {
+      auto __p = static_cast<const char*>(__builtin_memchr(__s, __c,
+							    __e - __s));
+      return __p ? __p : __e;
+    }
+
+    static char*
+    _S_find(char* __s, char* __e, char __c)
+    { return __s + (_S_find((const char*)__s, (const char*)__e, __c) - __s); }
+
+    template<typename _Ptr, typename _Container>
+      static __gnu_cxx::__normal_iterator<_Ptr, _Container>
+      _S_find(__gnu_cxx::__normal_iterator<_Ptr, _Container> __s,
+	      __gnu_cxx::__normal_iterator<_Ptr, _Container> __e, char __c)
+      { return __s + (_S_find(__s.base(), __e.base(), __c) - __s.base()); }
+
+    unsigned char		_M_class[256];
+    std::size_t			_M_class_count;
+    // _M_trans[__s * _M_class_count + __class] is the next state.
+    std::vector<_StateT>	_M_trans;
+    std::vector<unsigned char>	_M_accepting;
+    // Start states for matching at a given position and for searching.
+    _StateT			_M_start;
+    _StateT			_M_search_start;
+    // The only char a match can begin with, or -1.
+    int				_M_first_char;
+  };
+
   struct _NFA_base
   {
     typedef size_t                              _SizeT;
@@ -340,12 +431,25 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       void
       _M_eliminate_dummy();
 
+      // Build _M_dfa if the NFA can be turned into a small enough DFA.
+      void
+      _M_build_dfa()
+      { _M_build_dfa(is_same<_Char_type, char>()); }
+
+      void
+      _M_build_dfa(false_type)
+      { }
+
+      void
+      _M_build_dfa(true_type);
+
 #ifdef _GLIBCXX_DEBUG
       std::ostream&
       _M_dot(std::ostream& __ostr) const;
 #endif
     public:
       _TraitsT                  _M_traits;
+      std::unique_ptr<_DFA>     _M_dfa;
     };
 
   /// Describes a sequence of one or more %_State, its current start
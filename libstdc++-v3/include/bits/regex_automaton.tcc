@@ -189,6 +189,216 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	}
     }
 
+  template<typename _TraitsT>
+    void
+    _NFA<_TraitsT>::_M_build_dfa(true_type)
+    {
+      for (const auto& __st : *this)
+	switch (__st._M_opcode())
+	  {
+	  case _S_opcode_alternative:
+	  case _S_opcode_repeat:
+	  case _S_opcode_subexpr_begin:
+	  case _S_opcode_subexpr_end:
+	  case _S_opcode_dummy:
+	  case _S_opcode_match:
+	  case _S_opcode_accept:
+	    break;
+	  default:
+	    return;
+	  }
+
+      // The chars accepted by every matcher.
+      std::vector<_StateIdT> __matchers;
+      std::vector<std::bitset<256>> __accepted;
+      for (size_t __i = 0; __i < this->size(); ++__i)
+	if ((*this)[__i]._M_opcode() == _S_opcode_match)
+	  {
+	    const auto& __m = (*this)[__i]._M_get_matcher();
+	    std::bitset<256> __b;
+	    for (unsigned __c = 0; __c < 256; ++__c)
+	      __b[__c] = __m(static_cast<char>(__c));
+	    __matchers.push_back(__i);
+	    __accepted.push_back(__b);
+	  }
+
+      std::unique_ptr<_DFA> __dfa(new _DFA);
+
+      // Chars that no matcher tells apart share a class.
+      std::map<std::vector<bool>, unsigned char> __class_of;
+      std::vector<unsigned char> __class_char;
+      for (unsigned __c = 0; __c < 256; ++__c)
+	{
+	  std::vector<bool> __sig(__matchers.size());
+	  for (size_t __i = 0; __i < __matchers.size(); ++__i)
+	    __sig[__i] = __accepted[__i][__c];
+	  auto __ins = __class_of.insert({std::move(__sig),
+					  (unsigned char)__class_char.size()});
+	  if (__ins.second)
+	    __class_char.push_back(__c);
+	  __dfa->_M_class[__c] = __ins.first->second;
+	}
+      const size_t __nclasses = __class_char.size();
+      __dfa->_M_class_count = __nclasses;
+
+      std::vector<size_t> __match_index(this->size(), size_t(-1));
+      for (size_t __i = 0; __i < __matchers.size(); ++__i)
+	__match_index[__matchers[__i]] = __i;
+
+      // A DFA state is the set of matchers that can consume the next char,
+      // followed by -1 for an accepting state and by -2 for the states
+      // that restart the regex at every position, used for searching.
+      typedef std::vector<_StateIdT> _Key;
+      std::map<_Key, _DFA::_StateT> __ids;
+      std::vector<_Key> __keys;
+      std::vector<size_t> __visited(this->size());
+      size_t __visit = 0;
+
+      auto __state = [&](std::vector<_StateIdT>& __stack, bool __search)
+	-> _DFA::_StateT
+	{
+	  if (__search)
+	    __stack.push_back(this->_M_start());
+	  _Key __key;
+	  bool __accepting = false;
+	  ++__visit;
+	  while (!__stack.empty())
+	    {
+	      _StateIdT __i = __stack.back();
+	      __stack.pop_back();
+	      if (__i < 0 || __visited[__i] == __visit)
+		continue;
+	      __visited[__i] = __visit;
+	      const auto& __st = (*this)[__i];
+	      switch (__st._M_opcode())
+		{
+		case _S_opcode_match:
+		  __key.push_back(__i);
+		  break;
+		case _S_opcode_accept:
+		  __accepting = true;
+		  break;
+		case _S_opcode_alternative:
+		case _S_opcode_repeat:
+		  __stack.push_back(__st._M_alt);
+		  // Fall through.
+		default:
+		  __stack.push_back(__st._M_next);
+		}
+	    }
+	  std::sort(__key.begin(), __key.end());
+	  if (__accepting)
+	    __key.push_back(-1);
+	  if (__search)
+	    __key.push_back(-2);
+	  auto __ins = __ids.insert({__key, _DFA::_StateT(__keys.size())});
+	  if (__ins.second)
+	    {
+	      __keys.push_back(std::move(__key));
+	      __dfa->_M_accepting.push_back(__accepting);
+	    }
+	  return __ins.first->second;
+	};
+
+      std::vector<_StateIdT> __stack;
+      __state(__stack, false);
+      __glibcxx_assert(__keys.size() == 1 && __keys[0].empty());
+      __stack.push_back(this->_M_start());
+      __dfa->_M_start = __state(__stack, false);
+      __dfa->_M_search_start = __state(__stack, true);
+
+      for (size_t __s = 0; __s < __keys.size(); ++__s)
+	{
+	  if (__keys.size() > _GLIBCXX_REGEX_DFA_STATE_LIMIT)
+	    return;
+	  // __keys may be reallocated by __state().
+	  const _Key __key = __keys[__s];
+	  const bool __search = !__key.empty() && __key.back() == -2;
+	  for (size_t __k = 0; __k < __nclasses; ++__k)
+	    {
+	      for (_StateIdT __i : __key)
+		if (__i >= 0 && __accepted[__match_index[__i]][__class_char[__k]])
+		  __stack.push_back((*this)[__i]._M_next);
+	      __dfa->_M_trans.push_back(__state(__stack, __search));
+	    }
+	}
+
+      __dfa->_M_first_char = -1;
+      const _DFA::_StateT __q = __dfa->_M_start;
+      if (!__dfa->_M_accepts(__q))
+	for (unsigned __c = 0; __c < 256; ++__c)
+	  if (__dfa->_M_next(__q, static_cast<char>(__c)) != _DFA::_S_dead)
+	    {
+	      if (__dfa->_M_first_char != -1)
+		{
+		  __dfa->_M_first_char = -1;
+		  break;
+		}
+	      __dfa->_M_first_char = __c;
+	    }
+
+      _M_dfa = std::move(__dfa);
+    }
+
+  template<typename _BiIter>
+    bool
+    _DFA::_M_match(_BiIter __s, _BiIter __e) const
+    {
+      _StateT __q = _M_start;
+      for (; __s != __e && __q != _S_dead; ++__s)
+	__q = _M_next(__q, *__s);
+      return _M_accepts(__q);
+    }
+
+  template<typename _BiIter>
+    bool
+    _DFA::_M_match_prefix(_BiIter __s, _BiIter __e) const
+    {
+      _StateT __q = _M_start;
+      if (_M_accepts(__q))
+	return true;
+      for (; __s != __e; ++__s)
+	{
+	  __q = _M_next(__q, *__s);
+	  if (_M_accepts(__q))
+	    return true;
+	  if (__q == _S_dead)
+	    return false;
+	}
+      return false;
+    }
+
+  template<typename _BiIter>
+    bool
+    _DFA::_M_search(_BiIter& __s, _BiIter __e, bool __continuous) const
+    {
+      if (__continuous)
+	return _M_match_prefix(__s, __e);
+
+      // Find where the first match to end ends...
+      _StateT __q = _M_search_start;
+      _BiIter __end = __s;
+      while (!_M_accepts(__q))
+	{
+	  if (__q == _M_search_start && _M_first_char != -1)
+	    __end = _S_find(__end, __e, char(_M_first_char));
+	  if (__end == __e || __q == _S_dead)
+	    return false;
+	  __q = _M_next(__q, *__end);
+	  ++__end;
+	}
+
+      // ... then the leftmost match begins at or before that position.
+      for (;; ++__s)
+	{
+	  if (_M_first_char != -1)
+	    __s = _S_find(__s, __end, char(_M_first_char));
+	  if (_M_match_prefix(__s, __e))
+	    return true;
+	  __glibcxx_assert(__s != __end);
+	}
+    }
+
   // Just apply DFS on the sequence and re-link their links.
   template<typename _TraitsT>
     _StateSeq<_TraitsT>
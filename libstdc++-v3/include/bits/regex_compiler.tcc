@@ -87,6 +87,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       __r._M_append(_M_nfa->_M_insert_subexpr_end());
       __r._M_append(_M_nfa->_M_insert_accept());
       _M_nfa->_M_eliminate_dummy();
+      _M_nfa->_M_build_dfa();
     }
 
   template<typename _TraitsT>
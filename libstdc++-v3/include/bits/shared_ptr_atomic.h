@@ -322,6 +322,238 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     }
   // @}
 
+#if __cplusplus > 201402L
+  // The value of an atomic<shared_ptr<T>>.  The low bit of the control
+  // block pointer is a spin lock, held only while the two pointers are
+  // read or replaced, so that loads from different objects never contend
+  // and no reference count is ever released with the lock held.
+  template<typename _Tp>
+    class _Sp_atomic
+    {
+      using element_type = typename _Tp::element_type;
+      using __base_type = __shared_ptr<element_type>;
+      using __count_ptr = _Sp_counted_base<__default_lock_policy>*;
+
+      static constexpr __UINTPTR_TYPE__ _S_lock_bit = 1;
+
+    public:
+      constexpr _Sp_atomic() noexcept = default;
+
+      explicit
+      _Sp_atomic(_Tp __r) noexcept
+      {
+	__base_type& __b = __r;
+	_M_ptr = __b._M_ptr;
+	_M_val = reinterpret_cast<__UINTPTR_TYPE__>(__b._M_refcount._M_pi);
+	__b._M_ptr = nullptr;
+	__b._M_refcount._M_pi = nullptr;
+      }
+
+      _Sp_atomic(const _Sp_atomic&) = delete;
+      _Sp_atomic& operator=(const _Sp_atomic&) = delete;
+
+      ~_Sp_atomic()
+      {
+	if (__count_ptr __pi = _S_pi(_M_val.load(memory_order_relaxed)))
+	  __pi->_M_release();
+      }
+
+      _Tp
+      load(memory_order __o) const noexcept
+      {
+	const __UINTPTR_TYPE__ __v = _M_lock(__o);
+	_Tp __ret = _M_copy(__v);
+	_M_unlock(__v, memory_order_release);
+	return __ret;
+      }
+
+      // Exchange the stored value with __r.
+      void
+      swap(_Tp& __r, memory_order __o) noexcept
+      {
+	__base_type& __b = __r;
+	const __UINTPTR_TYPE__ __v = _M_lock(__o);
+	std::swap(_M_ptr, __b._M_ptr);
+	_M_unlock(reinterpret_cast<__UINTPTR_TYPE__>(__b._M_refcount._M_pi),
+		  __o);
+	__b._M_refcount._M_pi = _S_pi(__v);
+      }
+
+      bool
+      compare_exchange_strong(_Tp& __expected, _Tp __desired,
+			      memory_order __o, memory_order __o2) noexcept
+      {
+	__base_type& __e = __expected;
+	const __UINTPTR_TYPE__ __v = _M_lock(__o);
+	if (_M_ptr == __e._M_ptr && _S_pi(__v) == __e._M_refcount._M_pi)
+	  {
+	    // The old value is released by __desired's destructor.
+	    __base_type& __d = __desired;
+	    std::swap(_M_ptr, __d._M_ptr);
+	    _M_unlock(reinterpret_cast<__UINTPTR_TYPE__>(
+			__d._M_refcount._M_pi), __o);
+	    __d._M_refcount._M_pi = _S_pi(__v);
+	    return true;
+	  }
+	// Release the old value of __expected after unlocking.
+	_Tp __cur = _M_copy(__v);
+	_M_unlock(__v, __o2);
+	__expected.swap(__cur);
+	return false;
+      }
+
+    private:
+      static __count_ptr
+      _S_pi(__UINTPTR_TYPE__ __v) noexcept
+      { return reinterpret_cast<__count_ptr>(__v & ~_S_lock_bit); }
+
+      // A new reference to the value, with the lock held.
+      _Tp
+      _M_copy(__UINTPTR_TYPE__ __v) const noexcept
+      {
+	_Tp __ret;
+	__base_type& __b = __ret;
+	__b._M_ptr = _M_ptr;
+	if (__count_ptr __pi = _S_pi(__v))
+	  {
+	    __pi->_M_add_ref_copy();
+	    __b._M_refcount._M_pi = __pi;
+	  }
+	return __ret;
+      }
+
+      // Set the lock bit and return the unlocked value.
+      __UINTPTR_TYPE__
+      _M_lock(memory_order __o) const noexcept
+      {
+	if (__o != memory_order_seq_cst)
+	  __o = memory_order_acquire;
+	__UINTPTR_TYPE__ __v = _M_val.load(memory_order_relaxed);
+	for (unsigned __n = 0;; ++__n)
+	  {
+	    if (!(__v & _S_lock_bit))
+	      {
+		if (_M_val.compare_exchange_weak(__v, __v | _S_lock_bit, __o,
+						 memory_order_relaxed))
+		  return __v;
+	      }
+	    else
+	      {
+#ifdef __GTHREADS
+		if (__n > 16)
+		  __gthread_yield();
+#endif
+		__v = _M_val.load(memory_order_relaxed);
+	      }
+	  }
+      }
+
+      // Store __v, which does not have the lock bit set.
+      void
+      _M_unlock(__UINTPTR_TYPE__ __v, memory_order __o) const noexcept
+      {
+	if (__o != memory_order_seq_cst)
+	  __o = memory_order_release;
+	_M_val.store(__v, __o);
+      }
+
+      element_type*				_M_ptr = nullptr;
+      mutable __atomic_base<__UINTPTR_TYPE__>	_M_val{0};
+    };
+
+  /**
+   *  @brief  Atomic access to a shared_ptr.
+   *
+   *  Unlike the atomic_load etc. functions, which serialize through a
+   *  small pool of mutexes shared by all shared_ptr objects, this only
+   *  ever waits for other threads accessing the same object, and only for
+   *  the time it takes to copy or replace two pointers.
+  */
+  template<typename _Tp>
+    struct atomic<shared_ptr<_Tp>>
+    {
+    public:
+      using value_type = shared_ptr<_Tp>;
+
+      static constexpr bool is_always_lock_free = false;
+
+      bool
+      is_lock_free() const noexcept
+      { return false; }
+
+      constexpr atomic() noexcept = default;
+
+      atomic(shared_ptr<_Tp> __r) noexcept
+      : _M_impl(std::move(__r))
+      { }
+
+      atomic(const atomic&) = delete;
+      void operator=(const atomic&) = delete;
+
+      shared_ptr<_Tp>
+      load(memory_order __o = memory_order_seq_cst) const noexcept
+      { return _M_impl.load(__o); }
+
+      operator shared_ptr<_Tp>() const noexcept
+      { return _M_impl.load(memory_order_seq_cst); }
+
+      void
+      store(shared_ptr<_Tp> __desired,
+	    memory_order __o = memory_order_seq_cst) noexcept
+      { _M_impl.swap(__desired, __o); }
+
+      void
+      operator=(shared_ptr<_Tp> __desired) noexcept
+      { _M_impl.swap(__desired, memory_order_seq_cst); }
+
+      shared_ptr<_Tp>
+      exchange(shared_ptr<_Tp> __desired,
+	       memory_order __o = memory_order_seq_cst) noexcept
+      {
+	_M_impl.swap(__desired, __o);
+	return __desired;
+      }
+
+      bool
+      compare_exchange_strong(shared_ptr<_Tp>& __expected,
+			      shared_ptr<_Tp> __desired,
+			      memory_order __o, memory_order __o2) noexcept
+      {
+	return _M_impl.compare_exchange_strong(__expected,
+					       std::move(__desired), __o, __o2);
+      }
+
+      bool
+      compare_exchange_strong(shared_ptr<_Tp>& __expected,
+			      shared_ptr<_Tp> __desired,
+			      memory_order __o = memory_order_seq_cst) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o,
+				       __cmpexch_failure_order(__o));
+      }
+
+      bool
+      compare_exchange_weak(shared_ptr<_Tp>& __expected,
+			    shared_ptr<_Tp> __desired,
+			    memory_order __o, memory_order __o2) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o,
+				       __o2);
+      }
+
+      bool
+      compare_exchange_weak(shared_ptr<_Tp>& __expected,
+			    shared_ptr<_Tp> __desired,
+			    memory_order __o = memory_order_seq_cst) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o);
+      }
+
+    private:
+      _Sp_atomic<shared_ptr<_Tp>> _M_impl;
+    };
+#endif // C++17
+
   // @} group pointer_abstractions
 
 _GLIBCXX_END_NAMESPACE_VERSION
@@ -1865,28 +1865,6 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 				__gnu_cxx::__ops::__val_comp_iter(__comp));
     }
 
-  /**
-   *  @doctodo
-   *  This controls some aspect of the sort routines.
-  */
-  enum { _S_threshold = 16 };
-
-  /// This is a helper function for the sort routine.
-  template<typename _RandomAccessIterator, typename _Compare>
-    void
-    __final_insertion_sort(_RandomAccessIterator __first,
-			   _RandomAccessIterator __last, _Compare __comp)
-    {
-      if (__last - __first > int(_S_threshold))
-	{
-	  std::__insertion_sort(__first, __first + int(_S_threshold), __comp);
-	  std::__unguarded_insertion_sort(__first + int(_S_threshold), __last,
-					  __comp);
-	}
-      else
-	std::__insertion_sort(__first, __last, __comp);
-    }
-
   /// This is a helper function...
   template<typename _RandomAccessIterator, typename _Compare>
     _RandomAccessIterator
@@ -1931,25 +1909,443 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       std::__sort_heap(__first, __middle, __comp);
     }
 
-  /// This is a helper function for the sort routine.
-  template<typename _RandomAccessIterator, typename _Size, typename _Compare>
+  // Tuning parameters of the sort routine.
+  enum
+    {
+      // Ranges shorter than this are insertion sorted.
+      _S_pdq_insertion_threshold = 24,
+      // Ranges longer than this take the pseudomedian of nine as pivot.
+      _S_pdq_ninther_threshold = 128,
+      // __partial_insertion_sort gives up after this many moves.
+      _S_pdq_partial_insertion_limit = 8,
+      // Elements classified at once by the block partition.
+      _S_pdq_block_size = 64
+    };
+
+  /// Whether __comp on values of type _Tp compiles to a branch-free
+  /// comparison, so that the block partition of sort pays off.
+  template<typename _Compare, typename _Tp>
+    struct __sort_branchless
+    { enum { __value = 0 }; };
+
+  template<typename _Tp>
+    struct __sort_branchless<__gnu_cxx::__ops::_Iter_less_iter, _Tp>
+    { enum { __value = std::__is_arithmetic<_Tp>::__value }; };
+
+  /// This is a helper function for the sort routine.  Sorts
+  /// *__a, *__b and *__c.
+  template<typename _RandomAccessIterator, typename _Compare>
+    inline void
+    __sort3(_RandomAccessIterator __a, _RandomAccessIterator __b,
+	    _RandomAccessIterator __c, _Compare __comp)
+    {
+      if (__comp(__b, __a))
+	std::iter_swap(__a, __b);
+      if (__comp(__c, __b))
+	std::iter_swap(__b, __c);
+      if (__comp(__b, __a))
+	std::iter_swap(__a, __b);
+    }
+
+  /// This is a helper function for the sort routine.  Insertion sort
+  /// which gives up, returning false, once it has moved more than a few
+  /// elements.
+  template<typename _RandomAccessIterator, typename _Compare>
+    bool
+    __partial_insertion_sort(_RandomAccessIterator __first,
+			     _RandomAccessIterator __last, _Compare __comp)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+      typedef typename iterator_traits<_RandomAccessIterator>::difference_type
+	_DistanceType;
+
+      if (__first == __last)
+	return true;
+
+      __decltype(__gnu_cxx::__ops::__val_comp_iter(__comp)) __vcomp
+	= __gnu_cxx::__ops::__val_comp_iter(__comp);
+      _DistanceType __moves = 0;
+      for (_RandomAccessIterator __i = __first + 1; __i != __last; ++__i)
+	{
+	  if (__moves > _DistanceType(_S_pdq_partial_insertion_limit))
+	    return false;
+
+	  _RandomAccessIterator __hole = __i;
+	  _RandomAccessIterator __prev = __i - 1;
+	  if (__comp(__hole, __prev))
+	    {
+	      _ValueType __val = _GLIBCXX_MOVE(*__hole);
+	      do
+		{
+		  *__hole = _GLIBCXX_MOVE(*__prev);
+		  --__hole;
+		}
+	      while (__hole != __first && __vcomp(__val, --__prev));
+	      *__hole = _GLIBCXX_MOVE(__val);
+	      __moves += __i - __hole;
+	    }
+	}
+      return true;
+    }
+
+  /// This is a helper function for the sort routine.  Partitions
+  /// [__first + 1, __last) around the pivot *__first into elements less
+  /// than it and the others, and moves the pivot between them.  Returns
+  /// the pivot's position and whether the range was already partitioned.
+  /// There must be an element not less than the pivot in the range.
+  template<typename _RandomAccessIterator, typename _Compare>
+    pair<_RandomAccessIterator, bool>
+    __partition_right(_RandomAccessIterator __first,
+		      _RandomAccessIterator __last, _Compare __comp)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
+      __decltype(__gnu_cxx::__ops::__iter_comp_val(__comp)) __less_pivot
+	= __gnu_cxx::__ops::__iter_comp_val(__comp);
+      _ValueType __pivot = _GLIBCXX_MOVE(*__first);
+      _RandomAccessIterator __left = __first;
+      _RandomAccessIterator __right = __last;
+
+      while (__less_pivot(++__left, __pivot))
+	{ }
+      // Nothing guards the scan from the right if *__left was the first
+      // element not less than the pivot.
+      if (__left - 1 == __first)
+	while (__left < __right && !__less_pivot(--__right, __pivot))
+	  { }
+      else
+	while (!__less_pivot(--__right, __pivot))
+	  { }
+
+      const bool __already_partitioned = __left >= __right;
+      while (__left < __right)
+	{
+	  std::iter_swap(__left, __right);
+	  while (__less_pivot(++__left, __pivot))
+	    { }
+	  while (!__less_pivot(--__right, __pivot))
+	    { }
+	}
+
+      _RandomAccessIterator __pivot_pos = __left - 1;
+      *__first = _GLIBCXX_MOVE(*__pivot_pos);
+      *__pivot_pos = _GLIBCXX_MOVE(__pivot);
+      return pair<_RandomAccessIterator, bool>(__pivot_pos,
+					       __already_partitioned);
+    }
+
+  /// This is a helper function for __partition_right_branchless.  Swaps
+  /// the __num elements at the offsets __offsets_l from __first with
+  /// those at the offsets __offsets_r back from __last.
+  template<typename _RandomAccessIterator>
     void
-    __introsort_loop(_RandomAccessIterator __first,
-		     _RandomAccessIterator __last,
-		     _Size __depth_limit, _Compare __comp)
+    __swap_offsets(_RandomAccessIterator __first, _RandomAccessIterator __last,
+		   const unsigned char* __offsets_l,
+		   const unsigned char* __offsets_r,
+		   size_t __num, bool __use_swaps)
     {
-      while (__last - __first > int(_S_threshold))
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
+      if (__use_swaps)
 	{
-	  if (__depth_limit == 0)
+	  // Proper swaps keep descending ranges from degrading to
+	  // quadratic behaviour.
+	  for (size_t __i = 0; __i < __num; ++__i)
+	    std::iter_swap(__first + __offsets_l[__i],
+			   __last - __offsets_r[__i]);
+	}
+      else if (__num > 0)
+	{
+	  // Otherwise a cyclic permutation needs fewer moves.
+	  _RandomAccessIterator __l = __first + __offsets_l[0];
+	  _RandomAccessIterator __r = __last - __offsets_r[0];
+	  _ValueType __tmp = _GLIBCXX_MOVE(*__l);
+	  *__l = _GLIBCXX_MOVE(*__r);
+	  for (size_t __i = 1; __i < __num; ++__i)
 	    {
-	      std::__partial_sort(__first, __last, __last, __comp);
+	      __l = __first + __offsets_l[__i];
+	      *__r = _GLIBCXX_MOVE(*__l);
+	      __r = __last - __offsets_r[__i];
+	      *__l = _GLIBCXX_MOVE(*__r);
+	    }
+	  *__r = _GLIBCXX_MOVE(__tmp);
+	}
+    }
+
+  /// This is a helper function for the sort routine.  Like
+  /// __partition_right, but the elements are classified a block at a
+  /// time, recording the offsets of those on the wrong side without
+  /// branching on the comparisons (Edelkamp and Weiss, "BlockQuicksort").
+  template<typename _RandomAccessIterator, typename _Compare>
+    pair<_RandomAccessIterator, bool>
+    __partition_right_branchless(_RandomAccessIterator __first,
+				 _RandomAccessIterator __last,
+				 _Compare __comp)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
+      __decltype(__gnu_cxx::__ops::__iter_comp_val(__comp)) __less_pivot
+	= __gnu_cxx::__ops::__iter_comp_val(__comp);
+      _ValueType __pivot = _GLIBCXX_MOVE(*__first);
+      _RandomAccessIterator __left = __first;
+      _RandomAccessIterator __right = __last;
+
+      while (__less_pivot(++__left, __pivot))
+	{ }
+      if (__left - 1 == __first)
+	while (__left < __right && !__less_pivot(--__right, __pivot))
+	  { }
+      else
+	while (!__less_pivot(--__right, __pivot))
+	  { }
+
+      const bool __already_partitioned = __left >= __right;
+      if (!__already_partitioned)
+	{
+	  std::iter_swap(__left, __right);
+	  ++__left;
+
+	  unsigned char __offsets_l[_S_pdq_block_size]
+	    __attribute__((__aligned__(64)));
+	  unsigned char __offsets_r[_S_pdq_block_size]
+	    __attribute__((__aligned__(64)));
+	  _RandomAccessIterator __base_l = __left;
+	  _RandomAccessIterator __base_r = __right;
+	  size_t __num_l = 0, __num_r = 0, __start_l = 0, __start_r = 0;
+
+	  while (__left < __right)
+	    {
+	      // Fill whichever offset buffers are empty, splitting what is
+	      // left between them when both are.
+	      const size_t __unknown = __right - __left;
+	      const size_t __split_l = __num_l == 0
+		? (__num_r == 0 ? __unknown / 2 : __unknown) : 0;
+	      const size_t __split_r = __num_r == 0 ? __unknown - __split_l : 0;
+
+	      const size_t __n_l = std::min(__split_l,
+					    size_t(_S_pdq_block_size));
+	      for (size_t __i = 0; __i < __n_l; ++__i)
+		{
+		  __offsets_l[__num_l] = __i;
+		  __num_l += !__less_pivot(__left, __pivot);
+		  ++__left;
+		}
+	      const size_t __n_r = std::min(__split_r,
+					    size_t(_S_pdq_block_size));
+	      for (size_t __i = 0; __i < __n_r; )
+		{
+		  __offsets_r[__num_r] = ++__i;
+		  __num_r += __less_pivot(--__right, __pivot);
+		}
+
+	      const size_t __num = std::min(__num_l, __num_r);
+	      std::__swap_offsets(__base_l, __base_r,
+				  __offsets_l + __start_l,
+				  __offsets_r + __start_r,
+				  __num, __num_l == __num_r);
+	      __num_l -= __num;
+	      __num_r -= __num;
+	      __start_l += __num;
+	      __start_r += __num;
+	      if (__num_l == 0)
+		{
+		  __start_l = 0;
+		  __base_l = __left;
+		}
+	      if (__num_r == 0)
+		{
+		  __start_r = 0;
+		  __base_r = __right;
+		}
+	    }
+
+	  // Now only one side has misplaced elements left; move them to
+	  // the boundary.
+	  if (__num_l)
+	    {
+	      while (__num_l--)
+		std::iter_swap(__base_l + __offsets_l[__start_l + __num_l],
+			       --__right);
+	      __left = __right;
+	    }
+	  if (__num_r)
+	    {
+	      while (__num_r--)
+		{
+		  std::iter_swap(__base_r - __offsets_r[__start_r + __num_r],
+				 __left);
+		  ++__left;
+		}
+	    }
+	}
+
+      _RandomAccessIterator __pivot_pos = __left - 1;
+      *__first = _GLIBCXX_MOVE(*__pivot_pos);
+      *__pivot_pos = _GLIBCXX_MOVE(__pivot);
+      return pair<_RandomAccessIterator, bool>(__pivot_pos,
+					       __already_partitioned);
+    }
+
+  /// This is a helper function for the sort routine.  Partitions
+  /// [__first + 1, __last) around the pivot *__first into elements not
+  /// greater than it and the others, and returns the pivot's position.
+  /// Used when the pivot equals the element before __first, i.e. when
+  /// nothing in the range is less than the pivot.
+  template<typename _RandomAccessIterator, typename _Compare>
+    _RandomAccessIterator
+    __partition_left(_RandomAccessIterator __first,
+		     _RandomAccessIterator __last, _Compare __comp)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
+      __decltype(__gnu_cxx::__ops::__val_comp_iter(__comp)) __pivot_less
+	= __gnu_cxx::__ops::__val_comp_iter(__comp);
+      _ValueType __pivot = _GLIBCXX_MOVE(*__first);
+      _RandomAccessIterator __left = __first;
+      _RandomAccessIterator __right = __last;
+
+      while (__pivot_less(__pivot, --__right))
+	{ }
+      if (__right + 1 == __last)
+	while (__left < __right && !__pivot_less(__pivot, ++__left))
+	  { }
+      else
+	while (!__pivot_less(__pivot, ++__left))
+	  { }
+
+      while (__left < __right)
+	{
+	  std::iter_swap(__left, __right);
+	  while (__pivot_less(__pivot, --__right))
+	    { }
+	  while (!__pivot_less(__pivot, ++__left))
+	    { }
+	}
+
+      *__first = _GLIBCXX_MOVE(*__right);
+      *__right = _GLIBCXX_MOVE(__pivot);
+      return __right;
+    }
+
+  /// This is a helper function for the sort routine: pattern-defeating
+  /// quicksort (Peters, "Pattern-defeating Quicksort").  Like introsort
+  /// it falls back to heapsort, here after __bad_allowed unbalanced
+  /// partitions.  It also finishes ranges which a partition found
+  /// already in order with a bounded insertion sort, puts runs of
+  /// elements equal to the previous pivot aside in linear time, and
+  /// shuffles a few elements after an unbalanced partition so that
+  /// patterned input cannot keep choosing bad pivots.  __leftmost is
+  /// false iff *(__first - 1) is not greater than any element of the
+  /// range, which can then be insertion sorted without bounds checks.
+  template<bool _Branchless, typename _RandomAccessIterator,
+	   typename _Size, typename _Compare>
+    void
+    __pdqsort_loop(_RandomAccessIterator __first,
+		   _RandomAccessIterator __last,
+		   _Size __bad_allowed, _Compare __comp,
+		   bool __leftmost = true)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::difference_type
+	_DistanceType;
+
+      while (true)
+	{
+	  const _DistanceType __size = __last - __first;
+	  if (__size < _DistanceType(_S_pdq_insertion_threshold))
+	    {
+	      if (__leftmost)
+		std::__insertion_sort(__first, __last, __comp);
+	      else
+		std::__unguarded_insertion_sort(__first, __last, __comp);
 	      return;
 	    }
-	  --__depth_limit;
-	  _RandomAccessIterator __cut =
-	    std::__unguarded_partition_pivot(__first, __last, __comp);
-	  std::__introsort_loop(__cut, __last, __depth_limit, __comp);
-	  __last = __cut;
+
+	  // Move the pivot to *__first, leaving an element not less than
+	  // it at the end of the range.
+	  const _DistanceType __half = __size / 2;
+	  if (__size > _DistanceType(_S_pdq_ninther_threshold))
+	    {
+	      std::__sort3(__first, __first + __half, __last - 1, __comp);
+	      std::__sort3(__first + 1, __first + (__half - 1), __last - 2,
+			   __comp);
+	      std::__sort3(__first + 2, __first + (__half + 1), __last - 3,
+			   __comp);
+	      std::__sort3(__first + (__half - 1), __first + __half,
+			   __first + (__half + 1), __comp);
+	      std::iter_swap(__first, __first + __half);
+	    }
+	  else
+	    std::__sort3(__first + __half, __first, __last - 1, __comp);
+
+	  // If the pivot equals the previous one, it is the least element
+	  // of the range, and so are all the elements equal to it: they
+	  // need no more sorting.
+	  if (!__leftmost && !__comp(__first - 1, __first))
+	    {
+	      __first = std::__partition_left(__first, __last, __comp) + 1;
+	      continue;
+	    }
+
+	  const pair<_RandomAccessIterator, bool> __part = _Branchless
+	    ? std::__partition_right_branchless(__first, __last, __comp)
+	    : std::__partition_right(__first, __last, __comp);
+	  const _RandomAccessIterator __pivot_pos = __part.first;
+
+	  const _DistanceType __l_size = __pivot_pos - __first;
+	  const _DistanceType __r_size = __last - (__pivot_pos + 1);
+	  if (__l_size < __size / 8 || __r_size < __size / 8)
+	    {
+	      if (--__bad_allowed == 0)
+		{
+		  std::__partial_sort(__first, __last, __last, __comp);
+		  return;
+		}
+
+	      const _DistanceType __t = _S_pdq_insertion_threshold;
+	      const _DistanceType __n = _S_pdq_ninther_threshold;
+	      if (__l_size >= __t)
+		{
+		  const _DistanceType __q = __l_size / 4;
+		  std::iter_swap(__first, __first + __q);
+		  std::iter_swap(__pivot_pos - 1, __pivot_pos - __q);
+		  if (__l_size > __n)
+		    {
+		      std::iter_swap(__first + 1, __first + (__q + 1));
+		      std::iter_swap(__first + 2, __first + (__q + 2));
+		      std::iter_swap(__pivot_pos - 2, __pivot_pos - (__q + 1));
+		      std::iter_swap(__pivot_pos - 3, __pivot_pos - (__q + 2));
+		    }
+		}
+	      if (__r_size >= __t)
+		{
+		  const _DistanceType __q = __r_size / 4;
+		  std::iter_swap(__pivot_pos + 1, __pivot_pos + (1 + __q));
+		  std::iter_swap(__last - 1, __last - __q);
+		  if (__r_size > __n)
+		    {
+		      std::iter_swap(__pivot_pos + 2, __pivot_pos + (2 + __q));
+		      std::iter_swap(__pivot_pos + 3, __pivot_pos + (3 + __q));
+		      std::iter_swap(__last - 2, __last - (1 + __q));
+		      std::iter_swap(__last - 3, __last - (2 + __q));
+		    }
+		}
+	    }
+	  else if (__part.second
+		   && std::__partial_insertion_sort(__first, __pivot_pos,
+						    __comp)
+		   && std::__partial_insertion_sort(__pivot_pos + 1, __last,
+						    __comp))
+	    return;
+
+	  std::__pdqsort_loop<_Branchless>(__first, __pivot_pos,
+					   __bad_allowed, __comp, __leftmost);
+	  __first = __pivot_pos + 1;
+	  __leftmost = false;
 	}
     }
 
@@ -1960,13 +2356,12 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __sort(_RandomAccessIterator __first, _RandomAccessIterator __last,
 	   _Compare __comp)
     {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
       if (__first != __last)
-	{
-	  std::__introsort_loop(__first, __last,
-				std::__lg(__last - __first) * 2,
-				__comp);
-	  std::__final_insertion_sort(__first, __last, __comp);
-	}
+	std::__pdqsort_loop<__sort_branchless<_Compare, _ValueType>::__value>
+	  (__first, __last, std::__lg(__last - __first), __comp);
     }
 
   template<typename _RandomAccessIterator, typename _Size, typename _Compare>
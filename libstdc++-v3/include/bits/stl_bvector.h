@@ -407,6 +407,172 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
       __fill_bvector(__first, __last, __x);
   }
 
+  // The following algorithms work on whole _Bit_type words.
+
+  // Bits [__first, __last) of a word, for 0 <= __first < __last <= word size.
+  inline _Bit_type
+  __bvector_mask(unsigned int __first, unsigned int __last)
+  {
+    return ((~_Bit_type(0) << __first)
+	    & (~_Bit_type(0) >> (int(_S_word_bit) - __last)));
+  }
+
+  // The word of bits starting at bit __off of *__p.  If __off is not zero,
+  // __p[1] must be valid.
+  inline _Bit_type
+  __bvector_load(const _Bit_type* __p, unsigned int __off)
+  {
+    if (__off == 0)
+      return *__p;
+    return (__p[0] >> __off) | (__p[1] << (int(_S_word_bit) - __off));
+  }
+
+  // Store a word of bits starting at bit __off of *__p.
+  inline void
+  __bvector_store(_Bit_type* __p, unsigned int __off, _Bit_type __w)
+  {
+    if (__off == 0)
+      *__p = __w;
+    else
+      {
+	const _Bit_type __lo = ~(~_Bit_type(0) << __off);
+	__p[0] = (__p[0] & __lo) | (__w << __off);
+	__p[1] = (__p[1] & ~__lo) | (__w >> (int(_S_word_bit) - __off));
+      }
+  }
+
+  inline ptrdiff_t
+  __count_bvector(_Bit_iterator_base __first, _Bit_iterator_base __last,
+		  bool __x)
+  {
+    ptrdiff_t __n = 0;
+    _Bit_type* __p = __first._M_p;
+    unsigned int __off = __first._M_offset;
+    if (__p != __last._M_p)
+      {
+	__n = __builtin_popcountl(*__p & (~_Bit_type(0) << __off));
+	for (++__p; __p != __last._M_p; ++__p)
+	  __n += __builtin_popcountl(*__p);
+	__off = 0;
+      }
+    if (__off < __last._M_offset)
+      __n += __builtin_popcountl(*__p
+				 & __bvector_mask(__off, __last._M_offset));
+    return __x ? __n : (__last - __first) - __n;
+  }
+
+  inline ptrdiff_t
+  count(_Bit_iterator __first, _Bit_iterator __last, const bool& __x)
+  { return __count_bvector(__first, __last, __x); }
+
+  inline ptrdiff_t
+  count(_Bit_const_iterator __first, _Bit_const_iterator __last,
+	const bool& __x)
+  { return __count_bvector(__first, __last, __x); }
+
+  inline _Bit_iterator_base
+  __find_bvector(_Bit_iterator_base __first, _Bit_iterator_base __last,
+		 bool __x)
+  {
+    const _Bit_type __flip = __x ? _Bit_type(0) : ~_Bit_type(0);
+    _Bit_type* __p = __first._M_p;
+    unsigned int __off = __first._M_offset;
+    for (; __p != __last._M_p; ++__p, __off = 0)
+      if (_Bit_type __w = (*__p ^ __flip) & (~_Bit_type(0) << __off))
+	return _Bit_iterator_base(__p, __builtin_ctzl(__w));
+    if (__off < __last._M_offset)
+      if (_Bit_type __w = ((*__p ^ __flip)
+			   & __bvector_mask(__off, __last._M_offset)))
+	return _Bit_iterator_base(__p, __builtin_ctzl(__w));
+    return __last;
+  }
+
+  inline _Bit_iterator
+  find(_Bit_iterator __first, _Bit_iterator __last, const bool& __x)
+  {
+    _Bit_iterator_base __i = __find_bvector(__first, __last, __x);
+    return _Bit_iterator(__i._M_p, __i._M_offset);
+  }
+
+  inline _Bit_const_iterator
+  find(_Bit_const_iterator __first, _Bit_const_iterator __last,
+       const bool& __x)
+  {
+    _Bit_iterator_base __i = __find_bvector(__first, __last, __x);
+    return _Bit_const_iterator(__i._M_p, __i._M_offset);
+  }
+
+  // Copies forwards a word at a time, so __result may be before __first
+  // in the same vector, as for std::copy.
+  inline _Bit_iterator
+  __copy_bvector(_Bit_iterator_base __first, _Bit_iterator_base __last,
+		 _Bit_iterator __result)
+  {
+    ptrdiff_t __n = __last - __first;
+    for (; __n >= int(_S_word_bit); __n -= int(_S_word_bit))
+      {
+	__bvector_store(__result._M_p, __result._M_offset,
+			     __bvector_load(__first._M_p,
+						 __first._M_offset));
+	++__first._M_p;
+	++__result._M_p;
+      }
+    _Bit_const_iterator __i(__first._M_p, __first._M_offset);
+    for (; __n > 0; --__n, ++__i, ++__result)
+      *__result = *__i;
+    return __result;
+  }
+
+  inline _Bit_iterator
+  copy(_Bit_iterator __first, _Bit_iterator __last, _Bit_iterator __result)
+  { return __copy_bvector(__first, __last, __result); }
+
+  inline _Bit_iterator
+  copy(_Bit_const_iterator __first, _Bit_const_iterator __last,
+       _Bit_iterator __result)
+  { return __copy_bvector(__first, __last, __result); }
+
+  inline bool
+  __equal_bvector(_Bit_iterator_base __first1, _Bit_iterator_base __last1,
+		  _Bit_iterator_base __first2)
+  {
+    ptrdiff_t __n = __last1 - __first1;
+    for (; __n >= int(_S_word_bit); __n -= int(_S_word_bit))
+      {
+	if (__bvector_load(__first1._M_p, __first1._M_offset)
+	    != __bvector_load(__first2._M_p, __first2._M_offset))
+	  return false;
+	++__first1._M_p;
+	++__first2._M_p;
+      }
+    _Bit_const_iterator __i1(__first1._M_p, __first1._M_offset);
+    _Bit_const_iterator __i2(__first2._M_p, __first2._M_offset);
+    for (; __n > 0; --__n, ++__i1, ++__i2)
+      if (*__i1 != *__i2)
+	return false;
+    return true;
+  }
+
+  inline bool
+  equal(_Bit_iterator __first1, _Bit_iterator __last1,
+	_Bit_iterator __first2)
+  { return __equal_bvector(__first1, __last1, __first2); }
+
+  inline bool
+  equal(_Bit_iterator __first1, _Bit_iterator __last1,
+	_Bit_const_iterator __first2)
+  { return __equal_bvector(__first1, __last1, __first2); }
+
+  inline bool
+  equal(_Bit_const_iterator __first1, _Bit_const_iterator __last1,
+	_Bit_iterator __first2)
+  { return __equal_bvector(__first1, __last1, __first2); }
+
+  inline bool
+  equal(_Bit_const_iterator __first1, _Bit_const_iterator __last1,
+	_Bit_const_iterator __first2)
+  { return __equal_bvector(__first1, __last1, __first2); }
+
   template<typename _Alloc>
     struct _Bvector_base
     {
@@ -1265,6 +1431,16 @@ template<typename _Alloc>
     _M_erase(iterator __first, iterator __last);
   };
 
+  // Compares whole words rather than single bits.
+  template<typename _Alloc>
+    inline bool
+    operator==(const vector<bool, _Alloc>& __x,
+	       const vector<bool, _Alloc>& __y)
+    {
+      return (__x.size() == __y.size()
+	      && __equal_bvector(__x.begin(), __x.end(), __y.begin()));
+    }
+
 _GLIBCXX_END_NAMESPACE_CONTAINER
 } // namespace std
 
@@ -65,6 +65,42 @@
 
 #include <debug/assertions.h>
 
+#ifndef _GLIBCXX_DEQUE_BUF_SIZE
+#define _GLIBCXX_DEQUE_BUF_SIZE 512
+#endif
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  /**
+   *  @brief The number of elements in each node of a std::deque<_Tp>.
+   *
+   *  This is an extension.  By default nodes hold about
+   *  _GLIBCXX_DEQUE_BUF_SIZE bytes, and at least one element.  A program
+   *  may specialize this trait for its own element types, for example to
+   *  put several large elements in each node, or fewer small ones.
+   *
+   *  The value changes the layout of std::deque<_Tp> and its iterators,
+   *  so the specialization must be declared before std::deque<_Tp> is
+   *  used and must be the same in every translation unit.  The value must
+   *  be greater than zero.
+   */
+  template<typename _Tp>
+    struct deque_buffer_size
+    {
+      static const std::size_t value
+	= (sizeof(_Tp) < _GLIBCXX_DEQUE_BUF_SIZE
+	   ? std::size_t(_GLIBCXX_DEQUE_BUF_SIZE / sizeof(_Tp))
+	   : std::size_t(1));
+    };
+
+  template<typename _Tp>
+    const std::size_t deque_buffer_size<_Tp>::value;
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
 namespace std _GLIBCXX_VISIBILITY(default)
 {
 _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
@@ -80,13 +116,10 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
    *  change), but no investigation has been done since inheriting the
    *  SGI code.  Touch _GLIBCXX_DEQUE_BUF_SIZE only if you know what
    *  you are doing, however: changing it breaks the binary
-   *  compatibility!!
+   *  compatibility!!  To change the node size of a single element type
+   *  specialize __gnu_cxx::deque_buffer_size instead.
   */
 
-#ifndef _GLIBCXX_DEQUE_BUF_SIZE
-#define _GLIBCXX_DEQUE_BUF_SIZE 512
-#endif
-
   _GLIBCXX_CONSTEXPR inline size_t
   __deque_buf_size(size_t __size)
   { return (__size < _GLIBCXX_DEQUE_BUF_SIZE
@@ -126,7 +159,7 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
 #endif
 
       static size_t _S_buffer_size() _GLIBCXX_NOEXCEPT
-      { return __deque_buf_size(sizeof(_Tp)); }
+      { return __gnu_cxx::deque_buffer_size<_Tp>::value; }
 
       typedef std::random_access_iterator_tag iterator_category;
       typedef _Tp                             value_type;
@@ -446,6 +479,87 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
 				__result); }
 #endif
 
+  // Segmented versions of more algorithms, which work on one node at a
+  // time and so only check for the end of a node once per node.
+  template<typename _Tp, typename _Ref, typename _Ptr, typename _Up>
+    _Deque_iterator<_Tp, _Ref, _Ptr>
+    find(_Deque_iterator<_Tp, _Ref, _Ptr>, _Deque_iterator<_Tp, _Ref, _Ptr>,
+	 const _Up&);
+
+  template<typename _Tp, typename _Ref, typename _Ptr, typename _Function>
+    _Function
+    for_each(_Deque_iterator<_Tp, _Ref, _Ptr>,
+	     _Deque_iterator<_Tp, _Ref, _Ptr>, _Function);
+
+  // Copying out of a deque.
+  template<typename _Tp, typename _OI>
+    _OI
+    copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*>, _OI);
+
+  template<typename _Tp, typename _OI>
+    inline _OI
+    copy(_Deque_iterator<_Tp, _Tp&, _Tp*> __first,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*> __last, _OI __result)
+    { return std::copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*>(__first),
+		       _Deque_iterator<_Tp, const _Tp&, const _Tp*>(__last),
+		       __result); }
+
+  // Copying into a deque.
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    copy(_II, _II, _Deque_iterator<_Tp, _Tp&, _Tp*>);
+
+  // Copying between deques of different element types.
+  template<typename _Tp, typename _Up>
+    _Deque_iterator<_Up, _Up&, _Up*>
+    copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Up, _Up&, _Up*>);
+
+  template<typename _Tp, typename _Up>
+    inline _Deque_iterator<_Up, _Up&, _Up*>
+    copy(_Deque_iterator<_Tp, _Tp&, _Tp*> __first,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*> __last,
+	 _Deque_iterator<_Up, _Up&, _Up*> __result)
+    { return std::copy(_Deque_iterator<_Tp, const _Tp&, const _Tp*>(__first),
+		       _Deque_iterator<_Tp, const _Tp&, const _Tp*>(__last),
+		       __result); }
+
+#if __cplusplus >= 201103L
+  template<typename _Tp, typename _OI>
+    _OI
+    move(_Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*>, _OI);
+
+  template<typename _Tp, typename _OI>
+    inline _OI
+    move(_Deque_iterator<_Tp, _Tp&, _Tp*> __first,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*> __last, _OI __result)
+    { return std::move(_Deque_iterator<_Tp, const _Tp&, const _Tp*>(__first),
+		       _Deque_iterator<_Tp, const _Tp&, const _Tp*>(__last),
+		       __result); }
+
+  template<typename _II, typename _Tp>
+    _Deque_iterator<_Tp, _Tp&, _Tp*>
+    move(_II, _II, _Deque_iterator<_Tp, _Tp&, _Tp*>);
+
+  template<typename _Tp, typename _Up>
+    _Deque_iterator<_Up, _Up&, _Up*>
+    move(_Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Tp, const _Tp&, const _Tp*>,
+	 _Deque_iterator<_Up, _Up&, _Up*>);
+
+  template<typename _Tp, typename _Up>
+    inline _Deque_iterator<_Up, _Up&, _Up*>
+    move(_Deque_iterator<_Tp, _Tp&, _Tp*> __first,
+	 _Deque_iterator<_Tp, _Tp&, _Tp*> __last,
+	 _Deque_iterator<_Up, _Up&, _Up*> __result)
+    { return std::move(_Deque_iterator<_Tp, const _Tp&, const _Tp*>(__first),
+		       _Deque_iterator<_Tp, const _Tp&, const _Tp*>(__last),
+		       __result); }
+#endif
+
   /**
    *  Deque base class.  This class provides the unified face for %deque's
    *  allocation.  This class's constructor and destructor allocate and
@@ -599,14 +713,16 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
       _M_allocate_node()
       { 
 	typedef __gnu_cxx::__alloc_traits<_Tp_alloc_type> _Traits;
-	return _Traits::allocate(_M_impl, __deque_buf_size(sizeof(_Tp)));
+	return _Traits::allocate(_M_impl,
+				 __gnu_cxx::deque_buffer_size<_Tp>::value);
       }
 
       void
       _M_deallocate_node(_Ptr __p) _GLIBCXX_NOEXCEPT
       {
 	typedef __gnu_cxx::__alloc_traits<_Tp_alloc_type> _Traits;
-	_Traits::deallocate(_M_impl, __p, __deque_buf_size(sizeof(_Tp)));
+	_Traits::deallocate(_M_impl, __p,
+			    __gnu_cxx::deque_buffer_size<_Tp>::value);
       }
 
       _Map_pointer
@@ -681,8 +797,8 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
     _Deque_base<_Tp, _Alloc>::
     _M_initialize_map(size_t __num_elements)
     {
-      const size_t __num_nodes = (__num_elements/ __deque_buf_size(sizeof(_Tp))
-				  + 1);
+      const size_t __num_nodes
+	= (__num_elements / __gnu_cxx::deque_buffer_size<_Tp>::value + 1);
 
       this->_M_impl._M_map_size = std::max((size_t) _S_initial_map_size,
 					   size_t(__num_nodes + 2));
@@ -712,7 +828,7 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
       this->_M_impl._M_start._M_cur = _M_impl._M_start._M_first;
       this->_M_impl._M_finish._M_cur = (this->_M_impl._M_finish._M_first
 					+ __num_elements
-					% __deque_buf_size(sizeof(_Tp)));
+					% __gnu_cxx::deque_buffer_size<_Tp>::value);
     }
 
   template<typename _Tp, typename _Alloc>
@@ -858,7 +974,7 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
 
     protected:
       static size_t _S_buffer_size() _GLIBCXX_NOEXCEPT
-      { return __deque_buf_size(sizeof(_Tp)); }
+      { return __gnu_cxx::deque_buffer_size<_Tp>::value; }
 
       // Functions controlling memory layout, and nothing else.
       using _Base::_M_initialize_map;
@@ -2314,6 +2430,18 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
 #undef _GLIBCXX_DEQUE_BUF_SIZE
 
 _GLIBCXX_END_NAMESPACE_CONTAINER
+
+#if __cplusplus > 201402L && !defined _GLIBCXX_DEBUG \
+    && !defined _GLIBCXX_PROFILE
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Tp>
+      using deque = _GLIBCXX_STD_C::deque<_Tp, polymorphic_allocator<_Tp>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif /* _STL_DEQUE_H */
@@ -1986,6 +1986,18 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 
 _GLIBCXX_END_NAMESPACE_VERSION
 #endif
+
+#if __cplusplus > 201402L && !defined _GLIBCXX_DEBUG \
+    && !defined _GLIBCXX_PROFILE
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Tp>
+      using list = _GLIBCXX_STD_C::list<_Tp, polymorphic_allocator<_Tp>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif /* _STL_LIST_H */
@@ -1451,6 +1451,20 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 _GLIBCXX_END_NAMESPACE_VERSION
 #endif // C++17
 
+
+#if __cplusplus > 201402L && !defined _GLIBCXX_DEBUG \
+    && !defined _GLIBCXX_PROFILE
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Key, typename _Tp, typename _Cmp = std::less<_Key>>
+      using map
+	= _GLIBCXX_STD_C::map<_Key, _Tp, _Cmp,
+			      polymorphic_allocator<pair<const _Key, _Tp>>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif /* _STL_MAP_H */
@@ -1962,6 +1962,26 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 _GLIBCXX_END_NAMESPACE_VERSION
 #endif // C++17
 
+
+#if __cplusplus > 201402L && !defined _GLIBCXX_DEBUG \
+    && !defined _GLIBCXX_PROFILE
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Key, typename _Tp, typename _Hash = std::hash<_Key>,
+	     typename _Pred = std::equal_to<_Key>>
+      using unordered_map
+	= _GLIBCXX_STD_C::unordered_map<_Key, _Tp, _Hash, _Pred,
+					polymorphic_allocator<pair<const _Key, _Tp>>>;
+    template<typename _Key, typename _Tp, typename _Hash = std::hash<_Key>,
+	     typename _Pred = std::equal_to<_Key>>
+      using unordered_multimap
+	= _GLIBCXX_STD_C::unordered_multimap<_Key, _Tp, _Hash, _Pred,
+					     polymorphic_allocator<pair<const _Key, _Tp>>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif /* _UNORDERED_MAP_H */
@@ -1607,6 +1607,26 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 _GLIBCXX_END_NAMESPACE_VERSION
 #endif // C++17
 
+
+#if __cplusplus > 201402L && !defined _GLIBCXX_DEBUG \
+    && !defined _GLIBCXX_PROFILE
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Key, typename _Hash = std::hash<_Key>,
+	     typename _Pred = std::equal_to<_Key>>
+      using unordered_set
+	= _GLIBCXX_STD_C::unordered_set<_Key, _Hash, _Pred,
+					polymorphic_allocator<_Key>>;
+    template<typename _Key, typename _Hash = std::hash<_Key>,
+	     typename _Pred = std::equal_to<_Key>>
+      using unordered_multiset
+	= _GLIBCXX_STD_C::unordered_multiset<_Key, _Hash, _Pred,
+					     polymorphic_allocator<_Key>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif /* _UNORDERED_SET_H */
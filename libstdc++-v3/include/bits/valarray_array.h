@@ -43,6 +43,14 @@ namespace std _GLIBCXX_VISIBILITY(default)
 {
 _GLIBCXX_BEGIN_NAMESPACE_VERSION
 
+  // The elements of the left-hand side of a valarray assignment or
+  // computed assignment must not depend on each other ([valarray.assign],
+  // [valarray.cassign]), so loops storing the values of an expression
+  // can ignore any dependences the compiler cannot rule out.  This avoids
+  // runtime alias checks, and lets loops with an opaque expression be
+  // vectorized at all.
+#define _GLIBCXX_VALARRAY_IVDEP _Pragma("GCC ivdep")
+
   //
   // Helper functions on raw pointers
   //
@@ -538,6 +546,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _Array_augmented_##_Name(_Array<_Tp> __a, size_t __n, _Array<_Tp> __b) \
     {									\
       _Tp* __p = __a._M_data;						\
+      _GLIBCXX_VALARRAY_IVDEP						\
       for (_Tp* __q = __b._M_data; __q < __b._M_data + __n; ++__p, ++__q) \
         *__p _Op##= *__q;						\
     }									\
@@ -548,6 +557,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
                              const _Expr<_Dom, _Tp>& __e, size_t __n)	\
     {									\
       _Tp* __p(__a._M_data);						\
+      _GLIBCXX_VALARRAY_IVDEP						\
       for (size_t __i = 0; __i < __n; ++__i, ++__p)                     \
         *__p _Op##= __e[__i];                                          	\
     }									\
@@ -580,6 +590,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
                              const _Expr<_Dom, _Tp>& __e, size_t __n)	\
     {									\
       _Tp* __p(__a._M_data);						\
+      _GLIBCXX_VALARRAY_IVDEP						\
       for (size_t __i = 0; __i < __n; ++__i, __p += __s)                \
         *__p _Op##= __e[__i];                                          	\
     }									\
@@ -612,6 +623,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
                              const _Expr<_Dom, _Tp>& __e, size_t __n)	\
     {									\
       size_t* __j(__i._M_data);	        				\
+      _GLIBCXX_VALARRAY_IVDEP						\
       for (size_t __k = 0; __k<__n; ++__k, ++__j)			\
         __a._M_data[*__j] _Op##= __e[__k];				\
     }									\
@@ -690,4 +702,6 @@ _GLIBCXX_END_NAMESPACE_VERSION
 
 # include <bits/valarray_array.tcc>
 
+#undef _GLIBCXX_VALARRAY_IVDEP
+
 #endif /* _ARRAY_H */
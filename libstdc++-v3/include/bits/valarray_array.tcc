@@ -142,6 +142,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __valarray_copy(const _Expr<_Dom, _Tp>& __e, size_t __n, _Array<_Tp> __a)
     {
       _Tp* __p (__a._M_data);
+      _GLIBCXX_VALARRAY_IVDEP
       for (size_t __i = 0; __i < __n; ++__i, ++__p)
 	*__p = __e[__i];
     }
@@ -154,6 +155,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 		     _Array<_Tp> __a, size_t __s)
     {
       _Tp* __p (__a._M_data);
+      _GLIBCXX_VALARRAY_IVDEP
       for (size_t __i = 0; __i < __n; ++__i, __p += __s)
 	*__p = __e[__i];
     }
@@ -166,6 +168,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 		    _Array<_Tp> __a, _Array<size_t> __i)
     {
       size_t* __j (__i._M_data);
+      _GLIBCXX_VALARRAY_IVDEP
       for (size_t __k = 0; __k < __n; ++__k, ++__j)
 	__a._M_data[*__j] = __e[__k];
     }
@@ -215,6 +218,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 			      _Array<_Tp> __a)
     {
       _Tp* __p (__a._M_data);
+      // __e cannot refer to the storage being constructed.
+      _GLIBCXX_VALARRAY_IVDEP
       for (size_t __i = 0; __i < __n; ++__i, ++__p)
 	new (__p) _Tp(__e[__i]);
     }
@@ -718,6 +718,19 @@ namespace __debug
     { __lhs.swap(__rhs); }
 
 } // namespace __debug
+
+#if __cplusplus > 201402L
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  namespace pmr
+  {
+    template<typename _Tp> class polymorphic_allocator;
+    template<typename _Key, typename _Tp, typename _Cmp = std::less<_Key>>
+      using map
+	= std::map<_Key, _Tp, _Cmp,
+		   polymorphic_allocator<pair<const _Key, _Tp>>>;
+  } // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+#endif // C++17
 } // namespace std
 
 #endif
@@ -0,0 +1,1019 @@
+// Open-addressing hashtable used by flat_hash_map and flat_hash_set -*- C++ -*-
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/flat_hashtable.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{ext/flat_hash_map}
+ */
+
+#ifndef _EXT_FLAT_HASHTABLE_H
+#define _EXT_FLAT_HASHTABLE_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <utility>
+#include <type_traits>
+#include <bits/stl_algobase.h>
+#include <bits/stl_iterator_base_types.h>
+#include <bits/functexcept.h>
+#include <ext/alloc_traits.h>
+#include <ext/aligned_buffer.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+namespace __flat
+{
+  // The table keeps one control byte per slot.  A full slot stores the
+  // low seven bits of the hash of its key; the other states are
+  // negative so that a whole group of control bytes can be classified
+  // with a few vector instructions.
+  //
+  // The control array has capacity + _Group::_S_width bytes: a sentinel
+  // after the last slot, which stops iteration, and copies of the first
+  // _S_width - 1 bytes, so that a group can be loaded at any slot.
+  typedef signed char _Ctrl;
+
+  enum : _Ctrl
+  {
+    _S_empty = -128,
+    _S_deleted = -2,
+    _S_sentinel = -1
+  };
+
+  inline bool
+  __is_full(_Ctrl __c) noexcept
+  { return __c >= 0; }
+
+  inline bool
+  __is_empty_or_deleted(_Ctrl __c) noexcept
+  { return __c < _S_sentinel; }
+
+  // Set of positions in a group, _Shift is log2 of the bits per position.
+  template<typename _Tp, int _Width, int _Shift>
+    struct _BitMask
+    {
+      _Tp _M_mask;
+
+      explicit
+      operator bool() const noexcept
+      { return _M_mask != 0; }
+
+      unsigned int
+      _M_lowest() const noexcept
+      { return __builtin_ctzll(_M_mask) >> _Shift; }
+
+      void
+      _M_clear_lowest() noexcept
+      { _M_mask &= _M_mask - 1; }
+
+      unsigned int
+      _M_trailing_zeros() const noexcept
+      { return _M_mask ? _M_lowest() : _Width; }
+
+      unsigned int
+      _M_leading_zeros() const noexcept
+      {
+	const int __extra = 8 * sizeof(unsigned long long) - (_Width << _Shift);
+	return _M_mask ? (__builtin_clzll(_M_mask) - __extra) >> _Shift
+		       : _Width;
+      }
+    };
+
+#ifdef __SSE2__
+  // Sixteen control bytes compared at once with SSE2.
+  struct _Group
+  {
+    static const std::size_t _S_width = 16;
+    typedef _BitMask<unsigned int, 16, 0> _Mask;
+
+    explicit
+    _Group(const _Ctrl* __p) noexcept
+    : _M_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__p)))
+    { }
+
+    _Mask
+    _M_match(_Ctrl __h2) const noexcept
+    {
+      return _Mask{ static_cast<unsigned int>(
+	  _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(__h2), _M_ctrl))) };
+    }
+
+    _Mask
+    _M_match_empty() const noexcept
+    { return _M_match(_S_empty); }
+
+    _Mask
+    _M_match_empty_or_deleted() const noexcept
+    {
+      return _Mask{ static_cast<unsigned int>(
+	  _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_S_sentinel),
+					   _M_ctrl))) };
+    }
+
+    unsigned int
+    _M_count_leading_empty_or_deleted() const noexcept
+    { return __builtin_ctz(~_M_match_empty_or_deleted()._M_mask); }
+
+    __m128i _M_ctrl;
+  };
+#else
+  // Eight control bytes compared at once in a 64-bit word.  _M_match can
+  // report a byte following a real match, which only costs an extra key
+  // comparison.
+  struct _Group
+  {
+    static const std::size_t _S_width = 8;
+    typedef _BitMask<unsigned long long, 8, 3> _Mask;
+
+    static const unsigned long long _S_lsbs = 0x0101010101010101ULL;
+    static const unsigned long long _S_msbs = 0x8080808080808080ULL;
+
+    explicit
+    _Group(const _Ctrl* __p) noexcept
+    {
+      __builtin_memcpy(&_M_ctrl, __p, sizeof(_M_ctrl));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      _M_ctrl = __builtin_bswap64(_M_ctrl);
+#endif
+    }
+
+    _Mask
+    _M_match(_Ctrl __h2) const noexcept
+    {
+      const unsigned long long __x
+	= _M_ctrl ^ (_S_lsbs * static_cast<unsigned char>(__h2));
+      return _Mask{ (__x - _S_lsbs) & ~__x & _S_msbs };
+    }
+
+    // Only _S_empty has the high bit set and bit 1 clear.
+    _Mask
+    _M_match_empty() const noexcept
+    { return _Mask{ _M_ctrl & (~_M_ctrl << 6) & _S_msbs }; }
+
+    // _S_sentinel is the only negative value with bit 0 set.
+    _Mask
+    _M_match_empty_or_deleted() const noexcept
+    { return _Mask{ _M_ctrl & (~_M_ctrl << 7) & _S_msbs }; }
+
+    unsigned int
+    _M_count_leading_empty_or_deleted() const noexcept
+    {
+      const unsigned long long __x
+	= ~_M_match_empty_or_deleted()._M_mask & _S_msbs;
+      return __x ? __builtin_ctzll(__x) >> 3 : _S_width;
+    }
+
+    unsigned long long _M_ctrl;
+  };
+#endif
+
+  // Spread the bits of a hash code, so that std::hash of integers,
+  // which is the identity, gives usable slot positions and control bytes.
+  inline std::size_t
+  __mix(std::size_t __h) noexcept
+  {
+#if __SIZEOF_SIZE_T__ == 8 && defined(__SIZEOF_INT128__)
+    const unsigned __int128 __m
+      = static_cast<unsigned __int128>(__h) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<std::size_t>(__m) ^ static_cast<std::size_t>(__m >> 64);
+#elif __SIZEOF_SIZE_T__ == 8
+    __h ^= __h >> 32;
+    __h *= 0x9e3779b97f4a7c15ULL;
+    return __h ^ (__h >> 32);
+#else
+    __h ^= __h >> 16;
+    __h *= 0x9e3779b9UL;
+    return __h ^ (__h >> 16);
+#endif
+  }
+
+  // Triangular probing over groups.  With a capacity of the form 2^n-1
+  // every group is visited once before the sequence repeats.
+  struct _Probe
+  {
+    std::size_t _M_mask;
+    std::size_t _M_offset;
+    std::size_t _M_index;
+
+    _Probe(std::size_t __h1, std::size_t __mask) noexcept
+    : _M_mask(__mask), _M_offset(__h1 & __mask), _M_index(0)
+    { }
+
+    std::size_t
+    _M_at(std::size_t __i) const noexcept
+    { return (_M_offset + __i) & _M_mask; }
+
+    void
+    _M_next() noexcept
+    {
+      _M_index += _Group::_S_width;
+      _M_offset = (_M_offset + _M_index) & _M_mask;
+    }
+  };
+
+  // Maximum number of elements before the table grows: 7/8 of the
+  // capacity, always leaving an empty slot to end unsuccessful probes.
+  inline std::size_t
+  __capacity_to_growth(std::size_t __cap) noexcept
+  { return __cap - std::max<std::size_t>(__cap / 8, 1); }
+
+  // Round up to a valid capacity, 2^n - 1 and at least a group minus one.
+  inline std::size_t
+  __normalize_capacity(std::size_t __n) noexcept
+  {
+    __n = std::max<std::size_t>(__n, _Group::_S_width - 1);
+    return ~std::size_t(0) >> (__builtin_clzll(__n)
+			       - 8 * (sizeof(unsigned long long)
+				      - sizeof(std::size_t)));
+  }
+
+  struct _Select1st
+  {
+    template<typename _Tp>
+      auto
+      operator()(_Tp&& __x) const noexcept
+      -> decltype(std::get<0>(std::forward<_Tp>(__x)))
+      { return std::get<0>(std::forward<_Tp>(__x)); }
+  };
+
+  struct _Identity
+  {
+    template<typename _Tp>
+      _Tp&&
+      operator()(_Tp&& __x) const noexcept
+      { return std::forward<_Tp>(__x); }
+  };
+
+  // Relocation of elements when the table is rehashed.  The key of a
+  // map element is moved despite being const, like node handles do.
+  template<typename _Value>
+    struct _Relocate
+    {
+      static constexpr bool _S_nothrow
+	= std::is_nothrow_move_constructible<_Value>::value;
+
+      template<typename _Alloc>
+	static void
+	_S_move(_Alloc& __a, _Value* __p, _Value& __v)
+	{ __alloc_traits<_Alloc>::construct(__a, __p, std::move(__v)); }
+    };
+
+  template<typename _Key, typename _Tp>
+    struct _Relocate<std::pair<const _Key, _Tp>>
+    {
+      static constexpr bool _S_nothrow
+	= std::is_nothrow_move_constructible<_Key>::value
+	  && std::is_nothrow_move_constructible<_Tp>::value;
+
+      template<typename _Alloc>
+	static void
+	_S_move(_Alloc& __a, std::pair<const _Key, _Tp>* __p,
+		std::pair<const _Key, _Tp>& __v)
+	{
+	  __alloc_traits<_Alloc>::construct(__a, __p,
+	      std::move(const_cast<_Key&>(__v.first)), std::move(__v.second));
+	}
+    };
+
+  template<typename _Value, bool _Const>
+    class _Iterator
+    {
+      template<typename, typename, typename, typename, typename, typename>
+	friend class _Hashtable;
+
+      template<typename, bool>
+	friend class _Iterator;
+
+    public:
+      typedef _Value					value_type;
+      typedef std::ptrdiff_t				difference_type;
+      typedef std::forward_iterator_tag			iterator_category;
+      typedef typename std::conditional<_Const, const _Value*,
+					_Value*>::type	pointer;
+      typedef typename std::conditional<_Const, const _Value&,
+					_Value&>::type	reference;
+
+      _Iterator() noexcept
+      : _M_ctrl(), _M_slot()
+      { }
+
+      template<bool _Const2,
+	       typename = typename std::enable_if<_Const && !_Const2>::type>
+	_Iterator(const _Iterator<_Value, _Const2>& __it) noexcept
+	: _M_ctrl(__it._M_ctrl), _M_slot(__it._M_slot)
+	{ }
+
+      reference
+      operator*() const noexcept
+      { return *_M_slot; }
+
+      pointer
+      operator->() const noexcept
+      { return _M_slot; }
+
+      _Iterator&
+      operator++() noexcept
+      {
+	++_M_ctrl;
+	++_M_slot;
+	_M_skip_empty_or_deleted();
+	return *this;
+      }
+
+      _Iterator
+      operator++(int) noexcept
+      {
+	_Iterator __tmp(*this);
+	++*this;
+	return __tmp;
+      }
+
+      friend bool
+      operator==(const _Iterator& __x, const _Iterator& __y) noexcept
+      { return __x._M_ctrl == __y._M_ctrl; }
+
+      friend bool
+      operator!=(const _Iterator& __x, const _Iterator& __y) noexcept
+      { return __x._M_ctrl != __y._M_ctrl; }
+
+    private:
+      _Iterator(const _Ctrl* __ctrl, _Value* __slot) noexcept
+      : _M_ctrl(__ctrl), _M_slot(__slot)
+      { }
+
+      // Advance to the next full slot or the sentinel.
+      void
+      _M_skip_empty_or_deleted() noexcept
+      {
+	while (__is_empty_or_deleted(*_M_ctrl))
+	  {
+	    const unsigned int __n
+	      = _Group(_M_ctrl)._M_count_leading_empty_or_deleted();
+	    _M_ctrl += __n;
+	    _M_slot += __n;
+	  }
+      }
+
+      const _Ctrl*	_M_ctrl;
+      _Value*		_M_slot;
+    };
+
+  /**
+   *  Open-addressing hashtable storing the elements in one array of
+   *  slots.  Unlike std::_Hashtable there is no allocation per element,
+   *  and a lookup usually touches a group of control bytes and one slot.
+   *  In exchange, rehashing moves the elements, invalidating pointers
+   *  and references as well as iterators.
+   *
+   *  Rehashing gives the strong exception guarantee only if the hash
+   *  function does not throw and the elements are not moved, i.e. they
+   *  are copied because their move constructor may throw.
+   */
+  template<typename _Key, typename _Value, typename _Alloc,
+	   typename _ExtractKey, typename _Hash, typename _Equal>
+    class _Hashtable
+    {
+      typedef __alloc_traits<_Alloc>			_Orig_traits;
+      typedef typename _Orig_traits::template rebind<_Value>::other
+							_Value_alloc;
+      typedef __alloc_traits<_Value_alloc>		_Value_traits;
+      typedef typename _Value_traits::template rebind<_Ctrl>::other
+							_Ctrl_alloc;
+      typedef __alloc_traits<_Ctrl_alloc>		_Ctrl_traits;
+      typedef _Relocate<_Value>				_Reloc;
+
+    public:
+      typedef _Key					key_type;
+      typedef _Value					value_type;
+      typedef _Hash					hasher;
+      typedef _Equal					key_equal;
+      typedef _Alloc					allocator_type;
+      typedef std::size_t				size_type;
+      typedef std::ptrdiff_t				difference_type;
+      typedef _Iterator<_Value, false>			iterator;
+      typedef _Iterator<_Value, true>			const_iterator;
+
+      _Hashtable(size_type __n, const _Hash& __hf, const _Equal& __eql,
+		 const allocator_type& __a)
+      : _M_alloc(__a), _M_hash(__hf), _M_eq(__eql)
+      {
+	if (__n)
+	  _M_resize(__normalize_capacity(__n));
+      }
+
+      _Hashtable(const _Hashtable& __ht)
+      : _Hashtable(__ht,
+		   _Value_traits::_S_select_on_copy(__ht._M_alloc))
+      { }
+
+      _Hashtable(const _Hashtable& __ht, const _Value_alloc& __a)
+      : _M_alloc(__a), _M_hash(__ht._M_hash), _M_eq(__ht._M_eq)
+      { _M_copy_from(__ht); }
+
+      _Hashtable(_Hashtable&& __ht) noexcept
+      : _M_alloc(std::move(__ht._M_alloc)), _M_hash(__ht._M_hash),
+	_M_eq(__ht._M_eq)
+      { _M_steal(__ht); }
+
+      _Hashtable(_Hashtable&& __ht, const _Value_alloc& __a)
+      : _M_alloc(__a), _M_hash(__ht._M_hash), _M_eq(__ht._M_eq)
+      {
+	if (_M_alloc == __ht._M_alloc)
+	  _M_steal(__ht);
+	else
+	  {
+	    reserve(__ht.size());
+	    for (auto& __v : __ht)
+	      _M_insert_unique(_ExtractKey{}(__v), std::move(__v));
+	    __ht.clear();
+	  }
+      }
+
+      ~_Hashtable()
+      { _M_destroy(); }
+
+      _Hashtable&
+      operator=(const _Hashtable& __ht)
+      {
+	if (this != std::__addressof(__ht))
+	  {
+	    _Hashtable __tmp(__ht,
+			     _Value_traits::_S_propagate_on_copy_assign()
+			     ? __ht._M_alloc : _M_alloc);
+	    _M_destroy();
+	    _M_alloc = __tmp._M_alloc;
+	    _M_hash = __tmp._M_hash;
+	    _M_eq = __tmp._M_eq;
+	    _M_steal(__tmp);
+	  }
+	return *this;
+      }
+
+      _Hashtable&
+      operator=(_Hashtable&& __ht)
+      noexcept(_Value_traits::_S_nothrow_move()
+	       && std::is_nothrow_move_assignable<_Hash>::value
+	       && std::is_nothrow_move_assignable<_Equal>::value)
+      {
+	if (this == std::__addressof(__ht))
+	  return *this;
+	_M_hash = std::move(__ht._M_hash);
+	_M_eq = std::move(__ht._M_eq);
+	if (_Value_traits::_S_propagate_on_move_assign()
+	    || _M_alloc == __ht._M_alloc)
+	  {
+	    _M_destroy();
+	    std::__alloc_on_move(_M_alloc, __ht._M_alloc);
+	    _M_steal(__ht);
+	  }
+	else
+	  {
+	    clear();
+	    reserve(__ht.size());
+	    for (auto& __v : __ht)
+	      _M_insert_unique(_ExtractKey{}(__v), std::move(__v));
+	    __ht.clear();
+	  }
+	return *this;
+      }
+
+      void
+      swap(_Hashtable& __ht)
+      noexcept(std::__is_nothrow_swappable<_Hash>::value
+	       && std::__is_nothrow_swappable<_Equal>::value)
+      {
+	using std::swap;
+	std::__alloc_on_swap(_M_alloc, __ht._M_alloc);
+	swap(_M_hash, __ht._M_hash);
+	swap(_M_eq, __ht._M_eq);
+	swap(_M_ctrl, __ht._M_ctrl);
+	swap(_M_slots, __ht._M_slots);
+	swap(_M_size, __ht._M_size);
+	swap(_M_capacity, __ht._M_capacity);
+	swap(_M_growth_left, __ht._M_growth_left);
+      }
+
+      allocator_type
+      get_allocator() const noexcept
+      { return allocator_type(_M_alloc); }
+
+      hasher
+      hash_function() const
+      { return _M_hash; }
+
+      key_equal
+      key_eq() const
+      { return _M_eq; }
+
+      // Iterators.
+      iterator
+      begin() noexcept
+      { return _M_begin<iterator>(); }
+
+      const_iterator
+      begin() const noexcept
+      { return _M_begin<const_iterator>(); }
+
+      iterator
+      end() noexcept
+      { return iterator(_M_ctrl + _M_capacity, _M_slots + _M_capacity); }
+
+      const_iterator
+      end() const noexcept
+      {
+	return const_iterator(_M_ctrl + _M_capacity,
+			      _M_slots + _M_capacity);
+      }
+
+      // Capacity.
+      size_type
+      size() const noexcept
+      { return _M_size; }
+
+      size_type
+      max_size() const noexcept
+      { return _Value_traits::max_size(_M_alloc); }
+
+      size_type
+      capacity() const noexcept
+      { return _M_capacity; }
+
+      float
+      load_factor() const noexcept
+      { return _M_capacity ? float(_M_size) / _M_capacity : 0.0f; }
+
+      // Lookup.
+      iterator
+      find(const key_type& __k)
+      { return _M_iterator_at(_M_find(__k, _M_hash_code(__k))); }
+
+      const_iterator
+      find(const key_type& __k) const
+      { return _M_iterator_at(_M_find(__k, _M_hash_code(__k))); }
+
+      size_type
+      count(const key_type& __k) const
+      { return _M_find(__k, _M_hash_code(__k)) != _M_capacity; }
+
+      // Modifiers.
+
+      // Insert a value built from __args unless an element with key __k
+      // exists.  __k is only used for the lookup, so it can refer into
+      // __args.
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	_M_insert_unique(const key_type& __k, _Args&&... __args)
+	{
+	  const size_type __hash = _M_hash_code(__k);
+	  size_type __i = _M_find(__k, __hash);
+	  if (__i != _M_capacity)
+	    return { _M_iterator_at(__i), false };
+	  __i = _M_prepare_insert(__hash);
+	  _Value_traits::construct(_M_alloc, _M_slots + __i,
+				   std::forward<_Args>(__args)...);
+	  _M_commit_insert(__i, __hash);
+	  return { _M_iterator_at(__i), true };
+	}
+
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	_M_emplace(_Args&&... __args)
+	{
+	  __aligned_buffer<_Value> __buf;
+	  _Value* __tmp = __buf._M_ptr();
+	  _Value_traits::construct(_M_alloc, __tmp,
+				   std::forward<_Args>(__args)...);
+	  struct _Guard
+	  {
+	    _Value_alloc& _M_a;
+	    _Value* _M_p;
+	    ~_Guard() { _Value_traits::destroy(_M_a, _M_p); }
+	  } __guard{ _M_alloc, __tmp };
+	  return _M_insert_unique(_ExtractKey{}(*__tmp), std::move(*__tmp));
+	}
+
+      iterator
+      erase(const_iterator __pos)
+      {
+	const size_type __i = __pos._M_slot - _M_slots;
+	_Value_traits::destroy(_M_alloc, _M_slots + __i);
+	_M_erase_meta(__i);
+	iterator __next(_M_ctrl + __i, _M_slots + __i);
+	__next._M_skip_empty_or_deleted();
+	return __next;
+      }
+
+      iterator
+      erase(const_iterator __first, const_iterator __last)
+      {
+	if (__first == begin() && __last == end())
+	  {
+	    clear();
+	    return end();
+	  }
+	while (__first != __last)
+	  __first = erase(__first);
+	return _M_iterator_at(__last._M_slot - _M_slots);
+      }
+
+      size_type
+      erase(const key_type& __k)
+      {
+	const size_type __i = _M_find(__k, _M_hash_code(__k));
+	if (__i == _M_capacity)
+	  return 0;
+	_Value_traits::destroy(_M_alloc, _M_slots + __i);
+	_M_erase_meta(__i);
+	return 1;
+      }
+
+      void
+      clear() noexcept
+      {
+	if (_M_size)
+	  {
+	    for (size_type __i = 0; __i != _M_capacity; ++__i)
+	      if (__is_full(_M_ctrl[__i]))
+		_Value_traits::destroy(_M_alloc, _M_slots + __i);
+	  }
+	if (_M_capacity)
+	  _M_reset_ctrl();
+	_M_size = 0;
+      }
+
+      void
+      rehash(size_type __n)
+      {
+	if (__n == 0 && _M_capacity == 0)
+	  return;
+	if (__n == 0 && _M_size == 0)
+	  {
+	    _M_destroy();
+	    _M_init_empty();
+	    return;
+	  }
+	// Never less room than needed for the current elements.
+	const size_type __m = _M_size + (_M_size ? (_M_size - 1) / 7 : 0);
+	const size_type __cap = __normalize_capacity(std::max(__n, __m));
+	if (__cap != _M_capacity || _M_growth_left
+				      != __capacity_to_growth(__cap) - _M_size)
+	  _M_resize(__cap);
+      }
+
+      void
+      reserve(size_type __n)
+      {
+	if (__n > _M_size + _M_growth_left)
+	  rehash(__n + (__n - 1) / 7);
+      }
+
+    private:
+      template<typename _It>
+	_It
+	_M_begin() const noexcept
+	{
+	  if (_M_size == 0)
+	    return _It(_M_ctrl + _M_capacity, _M_slots + _M_capacity);
+	  _It __it(_M_ctrl, _M_slots);
+	  __it._M_skip_empty_or_deleted();
+	  return __it;
+	}
+
+      iterator
+      _M_iterator_at(size_type __i) const noexcept
+      { return iterator(_M_ctrl + __i, _M_slots + __i); }
+
+      size_type
+      _M_hash_code(const key_type& __k) const
+      { return __mix(_M_hash(__k)); }
+
+      static size_type
+      _S_h1(size_type __hash) noexcept
+      { return __hash >> 7; }
+
+      static _Ctrl
+      _S_h2(size_type __hash) noexcept
+      { return __hash & 0x7f; }
+
+      // Index of the element with key __k, or the capacity if none.
+      size_type
+      _M_find(const key_type& __k, size_type __hash) const
+      {
+	if (_M_size == 0)
+	  return _M_capacity;
+	_Probe __seq(_S_h1(__hash), _M_capacity);
+	for (;;)
+	  {
+	    _Group __g(_M_ctrl + __seq._M_offset);
+	    for (auto __m = __g._M_match(_S_h2(__hash)); __m;
+		 __m._M_clear_lowest())
+	      {
+		const size_type __i = __seq._M_at(__m._M_lowest());
+		if (_M_eq(__k, _ExtractKey{}(_M_slots[__i])))
+		  return __i;
+	      }
+	    if (__g._M_match_empty())
+	      return _M_capacity;
+	    __seq._M_next();
+	  }
+      }
+
+      size_type
+      _M_find_first_non_full(size_type __hash) const noexcept
+      {
+	_Probe __seq(_S_h1(__hash), _M_capacity);
+	for (;;)
+	  {
+	    _Group __g(_M_ctrl + __seq._M_offset);
+	    auto __m = __g._M_match_empty_or_deleted();
+	    if (__m)
+	      return __seq._M_at(__m._M_lowest());
+	    __seq._M_next();
+	  }
+      }
+
+      // Find a slot for a new element, growing the table if needed.
+      size_type
+      _M_prepare_insert(size_type __hash)
+      {
+	if (_M_capacity == 0)
+	  _M_resize(__normalize_capacity(0));
+	size_type __i = _M_find_first_non_full(__hash);
+	if (_M_growth_left == 0 && _M_ctrl[__i] != _S_deleted)
+	  {
+	    // Only purge the tombstones when they are what fills the table.
+	    if (_M_size <= __capacity_to_growth(_M_capacity) / 2)
+	      _M_resize(_M_capacity);
+	    else
+	      {
+		if (_M_capacity > max_size() / 2)
+		  std::__throw_length_error(
+		      __N("flat_hashtable::_M_prepare_insert"));
+		_M_resize(_M_capacity * 2 + 1);
+	      }
+	    __i = _M_find_first_non_full(__hash);
+	  }
+	return __i;
+      }
+
+      void
+      _M_commit_insert(size_type __i, size_type __hash) noexcept
+      {
+	_M_growth_left -= _M_ctrl[__i] == _S_empty;
+	_M_set_ctrl(__i, _S_h2(__hash));
+	++_M_size;
+      }
+
+      void
+      _M_erase_meta(size_type __i) noexcept
+      {
+	--_M_size;
+	// If the slot is in a run of full slots shorter than a group, no
+	// probe sequence ever went past it and it can become empty again.
+	const size_type __before = (__i - _Group::_S_width) & _M_capacity;
+	const auto __empty_after = _Group(_M_ctrl + __i)._M_match_empty();
+	const auto __empty_before = _Group(_M_ctrl + __before)._M_match_empty();
+	const bool __never_full = __empty_before && __empty_after
+	  && (__empty_after._M_trailing_zeros()
+	      + __empty_before._M_leading_zeros()) < _Group::_S_width;
+	_M_set_ctrl(__i, __never_full ? _S_empty : _S_deleted);
+	_M_growth_left += __never_full;
+      }
+
+      // Set a control byte and its copy after the sentinel.
+      void
+      _M_set_ctrl(size_type __i, _Ctrl __c) noexcept
+      {
+	_M_ctrl[__i] = __c;
+	_M_ctrl[((__i - (_Group::_S_width - 1)) & _M_capacity)
+		+ ((_Group::_S_width - 1) & _M_capacity)] = __c;
+      }
+
+      void
+      _M_reset_ctrl() noexcept
+      {
+	__builtin_memset(_M_ctrl, _S_empty, _M_capacity + _Group::_S_width);
+	_M_ctrl[_M_capacity] = _S_sentinel;
+	_M_growth_left = __capacity_to_growth(_M_capacity);
+      }
+
+      void
+      _M_allocate(size_type __cap)
+      {
+	_Ctrl_alloc __ca(_M_alloc);
+	_Ctrl* __ctrl
+	  = std::__addressof(*_Ctrl_traits::allocate(__ca,
+						     __cap + _Group::_S_width));
+	__try
+	  {
+	    _M_slots
+	      = std::__addressof(*_Value_traits::allocate(_M_alloc, __cap));
+	  }
+	__catch(...)
+	  {
+	    _S_deallocate_ctrl(__ca, __ctrl, __cap);
+	    __throw_exception_again;
+	  }
+	_M_ctrl = __ctrl;
+	_M_capacity = __cap;
+	_M_reset_ctrl();
+      }
+
+      static void
+      _S_deallocate_ctrl(_Ctrl_alloc& __ca, _Ctrl* __ctrl, size_type __cap)
+      {
+	typedef typename _Ctrl_traits::pointer _Ptr;
+	_Ctrl_traits::deallocate(__ca,
+	    std::pointer_traits<_Ptr>::pointer_to(*__ctrl),
+	    __cap + _Group::_S_width);
+      }
+
+      void
+      _M_deallocate() noexcept
+      {
+	if (_M_capacity == 0)
+	  return;
+	typedef typename _Value_traits::pointer _Ptr;
+	_Ctrl_alloc __ca(_M_alloc);
+	_S_deallocate_ctrl(__ca, _M_ctrl, _M_capacity);
+	_Value_traits::deallocate(_M_alloc,
+	    std::pointer_traits<_Ptr>::pointer_to(*_M_slots), _M_capacity);
+      }
+
+      void
+      _M_destroy() noexcept
+      {
+	clear();
+	_M_deallocate();
+      }
+
+      void
+      _M_init_empty() noexcept
+      {
+	_M_ctrl = _S_empty_ctrl();
+	_M_slots = nullptr;
+	_M_size = _M_capacity = _M_growth_left = 0;
+      }
+
+      // Control bytes of a table without storage: just the sentinel.
+      static _Ctrl*
+      _S_empty_ctrl() noexcept
+      {
+	static _Ctrl __sentinel = _S_sentinel;
+	return &__sentinel;
+      }
+
+      void
+      _M_steal(_Hashtable& __ht) noexcept
+      {
+	_M_ctrl = __ht._M_ctrl;
+	_M_slots = __ht._M_slots;
+	_M_size = __ht._M_size;
+	_M_capacity = __ht._M_capacity;
+	_M_growth_left = __ht._M_growth_left;
+	__ht._M_init_empty();
+      }
+
+      // Copy the elements of __ht into the same slots of new storage.
+      void
+      _M_copy_from(const _Hashtable& __ht)
+      {
+	if (__ht._M_size == 0)
+	  return;
+	_M_allocate(__ht._M_capacity);
+	size_type __i = 0;
+	__try
+	  {
+	    for (; __i != _M_capacity; ++__i)
+	      if (__is_full(__ht._M_ctrl[__i]))
+		_Value_traits::construct(_M_alloc, _M_slots + __i,
+					 __ht._M_slots[__i]);
+	  }
+	__catch(...)
+	  {
+	    while (__i--)
+	      if (__is_full(__ht._M_ctrl[__i]))
+		_Value_traits::destroy(_M_alloc, _M_slots + __i);
+	    _M_deallocate();
+	    _M_init_empty();
+	    __throw_exception_again;
+	  }
+	__builtin_memcpy(_M_ctrl, __ht._M_ctrl,
+			 _M_capacity + _Group::_S_width);
+	_M_size = __ht._M_size;
+	_M_growth_left = __ht._M_growth_left;
+      }
+
+      void
+      _M_resize(size_type __cap)
+      {
+	_Ctrl* const __old_ctrl = _M_ctrl;
+	_Value* const __old_slots = _M_slots;
+	const size_type __old_size = _M_size;
+	const size_type __old_cap = _M_capacity;
+	const size_type __old_growth = _M_growth_left;
+	_M_init_empty();
+
+	auto __restore = [&]() noexcept {
+	  _M_ctrl = __old_ctrl;
+	  _M_slots = __old_slots;
+	  _M_size = __old_size;
+	  _M_capacity = __old_cap;
+	  _M_growth_left = __old_growth;
+	};
+
+	__try
+	  {
+	    _M_allocate(__cap);
+	  }
+	__catch(...)
+	  {
+	    __restore();
+	    __throw_exception_again;
+	  }
+
+	size_type __i = 0;
+	__try
+	  {
+	    for (; __i != __old_cap; ++__i)
+	      if (__is_full(__old_ctrl[__i]))
+		{
+		  _Value& __v = __old_slots[__i];
+		  const size_type __hash = _M_hash_code(_ExtractKey{}(__v));
+		  const size_type __j = _M_find_first_non_full(__hash);
+		  if (_Reloc::_S_nothrow)
+		    _Reloc::_S_move(_M_alloc, _M_slots + __j, __v);
+		  else
+		    _Value_traits::construct(_M_alloc, _M_slots + __j,
+					     static_cast<const _Value&>(__v));
+		  _M_commit_insert(__j, __hash);
+		}
+	  }
+	__catch(...)
+	  {
+	    _M_destroy();
+	    __restore();
+	    __throw_exception_again;
+	  }
+
+	if (__old_cap)
+	  {
+	    for (__i = 0; __i != __old_cap; ++__i)
+	      if (__is_full(__old_ctrl[__i]))
+		_Value_traits::destroy(_M_alloc, __old_slots + __i);
+	    typedef typename _Value_traits::pointer _Ptr;
+	    _Ctrl_alloc __ca(_M_alloc);
+	    _S_deallocate_ctrl(__ca, __old_ctrl, __old_cap);
+	    _Value_traits::deallocate(_M_alloc,
+		std::pointer_traits<_Ptr>::pointer_to(*__old_slots), __old_cap);
+	  }
+      }
+
+      _Value_alloc	_M_alloc;
+      _Hash		_M_hash;
+      _Equal		_M_eq;
+      _Ctrl*		_M_ctrl = _S_empty_ctrl();
+      _Value*		_M_slots = nullptr;
+      size_type		_M_size = 0;
+      size_type		_M_capacity = 0;
+      size_type		_M_growth_left = 0;
+    };
+} // namespace __flat
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // C++11
+
+#endif // _EXT_FLAT_HASHTABLE_H
@@ -0,0 +1,239 @@
+// Memory-mapped input file buffer -*- C++ -*-
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/mmap_filebuf.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _MMAP_FILEBUF_H
+#define _MMAP_FILEBUF_H 1
+
+#pragma GCC system_header
+
+#include <streambuf>
+#include <string>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  // Defined in the library, see config/io/basic_file_stdio.cc.
+  bool
+  __map_file(const char*, const void**, std::size_t*) throw ();
+
+  void
+  __unmap_file(const void*, std::size_t) throw ();
+
+  /**
+   *  @brief A read-only file stream buffer over a mapping of the file.
+   *  @ingroup io
+   *
+   *  This GNU extension maps the whole of a regular file into memory
+   *  and uses the mapping as the get area, so the contents are never
+   *  copied into an intermediate buffer and underflow() is only called
+   *  at the end of the file.  open() fails for files which cannot be
+   *  mapped, such as pipes and terminals, and for any mode other than
+   *  input; use a std::basic_filebuf for those.  No conversion is
+   *  done, so it must be instantiated with a narrow character type,
+   *  e.g., mmap_filebuf<char>.
+  */
+  template<typename _CharT, typename _Traits = std::char_traits<_CharT> >
+    class mmap_filebuf : public std::basic_streambuf<_CharT, _Traits>
+    {
+#if __cplusplus >= 201103L
+      static_assert(sizeof(_CharT) == 1,
+		    "mmap_filebuf character type must be one byte");
+#endif
+
+    public:
+      // Types:
+      typedef _CharT				        char_type;
+      typedef _Traits				        traits_type;
+      typedef typename traits_type::int_type		int_type;
+      typedef typename traits_type::pos_type		pos_type;
+      typedef typename traits_type::off_type		off_type;
+      typedef std::size_t                               size_t;
+
+    public:
+      /**
+       * deferred initialization
+      */
+      mmap_filebuf() : _M_data(0), _M_size(0), _M_open(false) { }
+
+      /**
+       *  @param  __s  The name of the file.
+       *  @param  __mode  Must be ios_base::in, optionally with binary
+       *                  or ate.
+      */
+      explicit
+      mmap_filebuf(const char* __s,
+		   std::ios_base::openmode __mode = std::ios_base::in)
+      : _M_data(0), _M_size(0), _M_open(false)
+      { this->open(__s, __mode); }
+
+      /**
+       *  Closes the file, unmapping it.
+      */
+      virtual
+      ~mmap_filebuf()
+      { this->close(); }
+
+      bool
+      is_open() const
+      { return _M_open; }
+
+      /**
+       *  @brief  Maps a file for reading.
+       *  @param  __s  The name of the file.
+       *  @param  __mode  Must be ios_base::in, optionally with binary
+       *                  or ate.
+       *  @return  @c this on success, NULL on failure.
+      */
+      mmap_filebuf*
+      open(const char* __s,
+	   std::ios_base::openmode __mode = std::ios_base::in)
+      {
+	const std::ios_base::openmode __write
+	  = std::ios_base::out | std::ios_base::app | std::ios_base::trunc;
+	if (_M_open || !(__mode & std::ios_base::in) || (__mode & __write))
+	  return 0;
+
+	const void* __addr;
+	size_t __len;
+	if (!__gnu_cxx::__map_file(__s, &__addr, &__len))
+	  return 0;
+
+	_M_data = static_cast<char_type*>(const_cast<void*>(__addr));
+	_M_size = __len;
+	_M_open = true;
+	if (__mode & std::ios_base::ate)
+	  this->setg(_M_data, _M_data + _M_size, _M_data + _M_size);
+	else
+	  this->setg(_M_data, _M_data, _M_data + _M_size);
+	return this;
+      }
+
+#if __cplusplus >= 201103L
+      mmap_filebuf*
+      open(const std::string& __s,
+	   std::ios_base::openmode __mode = std::ios_base::in)
+      { return this->open(__s.c_str(), __mode); }
+#endif
+
+      /**
+       *  @brief  Unmaps the file.
+       *  @return  @c this on success, NULL if no file was open.
+       *
+       *  Pointers obtained from data() are invalidated.
+      */
+      mmap_filebuf*
+      close()
+      {
+	if (!_M_open)
+	  return 0;
+	__gnu_cxx::__unmap_file(_M_data, _M_size);
+	_M_data = 0;
+	_M_size = 0;
+	_M_open = false;
+	this->setg(0, 0, 0);
+	return this;
+      }
+
+      /**
+       *  @return  The contents of the file, or NULL if it is empty.
+      */
+      const char_type*
+      data() const
+      { return _M_data; }
+
+      /**
+       *  @return  The size of the file, in chars.
+      */
+      size_t
+      size() const
+      { return _M_size; }
+
+    protected:
+      virtual std::streamsize
+      showmanyc()
+      { return -1; }
+
+      virtual int_type
+      underflow()
+      {
+	if (this->gptr() < this->egptr())
+	  return traits_type::to_int_type(*this->gptr());
+	return traits_type::eof();
+      }
+
+      virtual pos_type
+      seekoff(off_type __off, std::ios_base::seekdir __way,
+	      std::ios_base::openmode __mode = std::ios_base::in
+					       | std::ios_base::out)
+      {
+	if (!_M_open || !(__mode & std::ios_base::in))
+	  return pos_type(off_type(-1));
+	off_type __base = 0;
+	if (__way == std::ios_base::cur)
+	  __base = this->gptr() - this->eback();
+	else if (__way == std::ios_base::end)
+	  __base = _M_size;
+	return _M_seek(__base + __off);
+      }
+
+      virtual pos_type
+      seekpos(pos_type __pos,
+	      std::ios_base::openmode __mode = std::ios_base::in
+					       | std::ios_base::out)
+      {
+	if (!_M_open || !(__mode & std::ios_base::in))
+	  return pos_type(off_type(-1));
+	return _M_seek(off_type(__pos));
+      }
+
+    private:
+      pos_type
+      _M_seek(off_type __off)
+      {
+	if (__off < 0 || __off > off_type(_M_size))
+	  return pos_type(off_type(-1));
+	this->setg(_M_data, _M_data + __off, _M_data + _M_size);
+	return pos_type(__off);
+      }
+
+      // Not copyable.
+      mmap_filebuf(const mmap_filebuf&);
+
+      mmap_filebuf&
+      operator=(const mmap_filebuf&);
+
+      char_type*	_M_data;
+      size_t		_M_size;
+      bool		_M_open;
+    };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
+
+#endif
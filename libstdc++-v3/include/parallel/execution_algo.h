@@ -0,0 +1,511 @@
+// -*- C++ -*-
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the terms
+// of the GNU General Public License as published by the Free Software
+// Foundation; either version 3, or (at your option) any later
+// version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/**
+ * @file parallel/execution_algo.h
+ * @brief Algorithms taking a C++17 execution policy.
+ *
+ *  The work is split into chunks that run as tasks of the current
+ *  execution_backend.  When compiled with -fopenmp, sorting uses the
+ *  multiway mergesort of the parallel mode unless another backend has
+ *  been installed.  The loops of par_unseq algorithms are marked with
+ *  "omp simd", which takes effect with -fopenmp or -fopenmp-simd.
+ *
+ *  This file is a GNU parallel extension to the Standard C++ Library.
+ *  Do not include it directly; use <execution> instead.
+ */
+
+#ifndef _GLIBCXX_PARALLEL_EXECUTION_ALGO_H
+#define _GLIBCXX_PARALLEL_EXECUTION_ALGO_H 1
+
+#pragma GCC system_header
+
+#include <bits/stl_algobase.h>
+#include <bits/stl_algo.h>
+#include <type_traits>
+#include <parallel/settings.h>
+#include <parallel/execution_backend.h>
+#ifdef _OPENMP
+# include <parallel/base.h>
+# include <parallel/compatibility.h>
+# include <parallel/equally_split.h>
+# include <parallel/sort.h>
+# include <parallel/merge.h>
+#endif
+
+namespace __gnu_parallel
+{
+  // Whether the policy allows running the chunks concurrently.
+  template<typename _ExecutionPolicy>
+    struct __is_parallel_policy : std::false_type { };
+
+  template<>
+    struct __is_parallel_policy<std::execution::parallel_policy>
+    : std::true_type { };
+
+  template<>
+    struct __is_parallel_policy<std::execution::parallel_unsequenced_policy>
+    : std::true_type { };
+
+  // Whether the policy allows vectorizing the loop over a chunk.
+  template<typename _ExecutionPolicy>
+    struct __is_unsequenced_policy : std::false_type { };
+
+  template<>
+    struct __is_unsequenced_policy<
+      std::execution::parallel_unsequenced_policy>
+    : std::true_type { };
+
+  // Whether a sequence of __n elements should be split into tasks,
+  // following the algorithm strategy of the parallel mode.
+  inline bool
+  __execution_parallel_condition(_SequenceIndex __n,
+				 _SequenceIndex __minimal_n,
+				 unsigned int __concurrency) noexcept
+  {
+    const _Settings& __s = _Settings::get();
+    if (__s.algorithm_strategy == force_sequential || __concurrency < 2)
+      return false;
+    return __s.algorithm_strategy == force_parallel || __n >= __minimal_n;
+  }
+
+  // Bounds of the __i-th of __chunks nearly equal parts of [0, __n).
+  template<typename _DifferenceType>
+    inline _DifferenceType
+    __execution_chunk_begin(_DifferenceType __n, std::size_t __chunks,
+			    std::size_t __i) noexcept
+    {
+      const _DifferenceType __q = __n / __chunks, __r = __n % __chunks;
+      const _DifferenceType __d = __i;
+      return __q * __d + std::min(__d, __r);
+    }
+
+  // Call __body(__first, __last) on the chunks of [0, __n).  Exceptions
+  // escaping from __body call std::terminate, as required for the
+  // standard execution policies.
+  template<typename _DifferenceType, typename _Body>
+    void
+    __execution_for(_DifferenceType __n, _SequenceIndex __minimal_n,
+		    _Body& __body) noexcept
+    {
+      execution_backend* __backend = get_execution_backend();
+      const unsigned int __p = __backend->concurrency();
+      if (!__execution_parallel_condition(__n, __minimal_n, __p))
+	{
+	  __body(_DifferenceType(0), __n);
+	  return;
+	}
+
+      // Make more chunks than threads so that a thread which is slowed
+      // down does not hold up the whole algorithm.
+      struct _Arg
+      {
+	_Body*		_M_body;
+	_DifferenceType	_M_n;
+	std::size_t	_M_chunks;
+
+	static void
+	_S_run(void* __p, std::size_t __i) noexcept
+	{
+	  _Arg& __a = *static_cast<_Arg*>(__p);
+	  (*__a._M_body)(__execution_chunk_begin(__a._M_n, __a._M_chunks, __i),
+			 __execution_chunk_begin(__a._M_n, __a._M_chunks,
+						 __i + 1));
+	}
+      };
+
+      std::size_t __chunks = std::size_t(__p) * 4;
+      if (_SequenceIndex(__n) < __chunks)
+	__chunks = __n;
+      _Arg __arg = { &__body, __n, __chunks };
+      __backend->run(__chunks, &_Arg::_S_run, &__arg);
+    }
+
+  template<typename _RAIter, typename _Function, bool _Unseq>
+    struct __execution_for_each_body
+    {
+      _RAIter	_M_first;
+      _Function&	_M_f;
+
+      typedef typename std::iterator_traits<_RAIter>::difference_type
+	_DifferenceType;
+
+      void
+      operator()(_DifferenceType __lo, _DifferenceType __hi)
+      {
+	if (_Unseq)
+	  {
+#	    pragma omp simd
+	    for (_DifferenceType __i = __lo; __i < __hi; ++__i)
+	      _M_f(_M_first[__i]);
+	  }
+	else
+	  for (_DifferenceType __i = __lo; __i < __hi; ++__i)
+	    _M_f(_M_first[__i]);
+      }
+    };
+
+  template<typename _ExecutionPolicy, typename _RAIter, typename _Function>
+    void
+    __execution_for_each(_RAIter __first,
+			 typename std::iterator_traits<_RAIter>::
+			 difference_type __n,
+			 _Function& __f) noexcept
+    {
+      __execution_for_each_body<_RAIter, _Function,
+	__is_unsequenced_policy<_ExecutionPolicy>::value>
+	__body = { __first, __f };
+      if (__is_parallel_policy<_ExecutionPolicy>::value)
+	__execution_for(__n, _Settings::get().for_each_minimal_n, __body);
+      else
+	__body(0, __n);
+    }
+
+  template<typename _FIter, typename _Size, typename _Function>
+    _FIter
+    __execution_for_each_n_seq(_FIter __first, _Size __n,
+			       _Function& __f) noexcept
+    {
+      for (; __n > 0; --__n, (void)++__first)
+	__f(*__first);
+      return __first;
+    }
+
+  template<typename _RAIter1, typename _RAIter2, typename _UnaryOperation,
+	   bool _Unseq>
+    struct __execution_transform1_body
+    {
+      _RAIter1		_M_first;
+      _RAIter2		_M_result;
+      _UnaryOperation&	_M_op;
+
+      typedef typename std::iterator_traits<_RAIter1>::difference_type
+	_DifferenceType;
+
+      void
+      operator()(_DifferenceType __lo, _DifferenceType __hi)
+      {
+	if (_Unseq)
+	  {
+#	    pragma omp simd
+	    for (_DifferenceType __i = __lo; __i < __hi; ++__i)
+	      _M_result[__i] = _M_op(_M_first[__i]);
+	  }
+	else
+	  for (_DifferenceType __i = __lo; __i < __hi; ++__i)
+	    _M_result[__i] = _M_op(_M_first[__i]);
+      }
+    };
+
+  template<typename _RAIter1, typename _RAIter2, typename _RAIter3,
+	   typename _BinaryOperation, bool _Unseq>
+    struct __execution_transform2_body
+    {
+      _RAIter1		_M_first1;
+      _RAIter2		_M_first2;
+      _RAIter3		_M_result;
+      _BinaryOperation&	_M_op;
+
+      typedef typename std::iterator_traits<_RAIter1>::difference_type
+	_DifferenceType;
+
+      void
+      operator()(_DifferenceType __lo, _DifferenceType __hi)
+      {
+	if (_Unseq)
+	  {
+#	    pragma omp simd
+	    for (_DifferenceType __i = __lo; __i < __hi; ++__i)
+	      _M_result[__i] = _M_op(_M_first1[__i], _M_first2[__i]);
+	  }
+	else
+	  for (_DifferenceType __i = __lo; __i < __hi; ++__i)
+	    _M_result[__i] = _M_op(_M_first1[__i], _M_first2[__i]);
+      }
+    };
+
+  template<typename _FIter1, typename _FIter2, typename _UnaryOperation>
+    _FIter2
+    __execution_transform_seq(_FIter1 __first, _FIter1 __last,
+			      _FIter2 __result,
+			      _UnaryOperation& __op) noexcept
+    { return _GLIBCXX_STD_A::transform(__first, __last, __result, __op); }
+
+  template<typename _FIter1, typename _FIter2, typename _FIter3,
+	   typename _BinaryOperation>
+    _FIter3
+    __execution_transform_seq(_FIter1 __first1, _FIter1 __last1,
+			      _FIter2 __first2, _FIter3 __result,
+			      _BinaryOperation& __op) noexcept
+    {
+      return _GLIBCXX_STD_A::transform(__first1, __last1, __first2,
+				       __result, __op);
+    }
+
+  // Sort the chunks of [__first, __first + __n) concurrently, then
+  // merge neighbouring runs in rounds.  Each round halves the number of
+  // runs, the last one is a single merge of the whole sequence.
+  template<bool _Stable, typename _RAIter, typename _Compare>
+    struct __execution_sort_job
+    {
+      typedef typename std::iterator_traits<_RAIter>::difference_type
+	_DifferenceType;
+
+      _RAIter		_M_first;
+      _DifferenceType	_M_n;
+      std::size_t	_M_chunks;
+      std::size_t	_M_width;	// Chunks per run in this round.
+      _Compare&		_M_comp;
+
+      _RAIter
+      _M_bound(std::size_t __i) const noexcept
+      {
+	if (__i >= _M_chunks)
+	  return _M_first + _M_n;
+	return _M_first + __execution_chunk_begin(_M_n, _M_chunks, __i);
+      }
+
+      static void
+      _S_sort(void* __p, std::size_t __i) noexcept
+      {
+	__execution_sort_job& __j = *static_cast<__execution_sort_job*>(__p);
+	if (_Stable)
+	  _GLIBCXX_STD_A::stable_sort(__j._M_bound(__i), __j._M_bound(__i + 1),
+				      __j._M_comp);
+	else
+	  _GLIBCXX_STD_A::sort(__j._M_bound(__i), __j._M_bound(__i + 1),
+			       __j._M_comp);
+      }
+
+      static void
+      _S_merge(void* __p, std::size_t __i) noexcept
+      {
+	__execution_sort_job& __j = *static_cast<__execution_sort_job*>(__p);
+	const std::size_t __lo = __i * 2 * __j._M_width;
+	_GLIBCXX_STD_A::inplace_merge(__j._M_bound(__lo),
+				      __j._M_bound(__lo + __j._M_width),
+				      __j._M_bound(__lo + 2 * __j._M_width),
+				      __j._M_comp);
+      }
+    };
+
+  template<bool _Stable, typename _RAIter, typename _Compare>
+    void
+    __execution_sort_seq(_RAIter __first, _RAIter __last,
+			 _Compare& __comp) noexcept
+    {
+      if (_Stable)
+	_GLIBCXX_STD_A::stable_sort(__first, __last, __comp);
+      else
+	_GLIBCXX_STD_A::sort(__first, __last, __comp);
+    }
+
+  template<bool _Stable, typename _RAIter, typename _Compare>
+    void
+    __execution_sort(_RAIter __first, _RAIter __last,
+		     _Compare& __comp) noexcept
+    {
+      const typename std::iterator_traits<_RAIter>::difference_type
+	__n = __last - __first;
+      const _SequenceIndex __minimal_n = _Settings::get().sort_minimal_n;
+
+#ifdef _OPENMP
+      if (!__execution_backend_slot().load(std::memory_order_acquire))
+	{
+	  if (__execution_parallel_condition(__n, __minimal_n,
+					     omp_get_max_threads()))
+	    __parallel_sort<_Stable>(__first, __last, __comp, parallel_tag());
+	  else
+	    __execution_sort_seq<_Stable>(__first, __last, __comp);
+	  return;
+	}
+#endif
+
+      execution_backend* __backend = get_execution_backend();
+      const unsigned int __p = __backend->concurrency();
+      if (!__execution_parallel_condition(__n, __minimal_n, __p))
+	{
+	  __execution_sort_seq<_Stable>(__first, __last, __comp);
+	  return;
+	}
+
+      // A power of two, so that every merge round pairs all runs.
+      std::size_t __chunks = 1;
+      while (__chunks < __p && _SequenceIndex(__n) >= __chunks * 2)
+	__chunks *= 2;
+
+      typedef __execution_sort_job<_Stable, _RAIter, _Compare> _Job;
+      _Job __job = { __first, __n, __chunks, 1, __comp };
+      __backend->run(__chunks, &_Job::_S_sort, &__job);
+      for (; __job._M_width < __chunks; __job._M_width *= 2)
+	__backend->run(__chunks / (2 * __job._M_width), &_Job::_S_merge,
+		       &__job);
+    }
+} // end namespace __gnu_parallel
+
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  template<typename _ExecutionPolicy, typename _Tp>
+    using __enable_if_execution_policy
+      = typename enable_if<
+	  is_execution_policy<typename decay<_ExecutionPolicy>::type>::value,
+	  _Tp>::type;
+
+  // [alg.foreach]
+  template<typename _ExecutionPolicy, typename _FIter, typename _Function>
+    inline __enable_if_execution_policy<_ExecutionPolicy, void>
+    for_each(_ExecutionPolicy&&, _FIter __first, _FIter __last,
+	     _Function __f)
+    {
+      typedef typename decay<_ExecutionPolicy>::type _Policy;
+      if constexpr (__is_random_access_iter<_FIter>::value)
+	__gnu_parallel::__execution_for_each<_Policy>(__first,
+						      __last - __first, __f);
+      else
+	__gnu_parallel::__execution_for_each_n_seq(__first,
+						   std::distance(__first,
+								 __last),
+						   __f);
+    }
+
+  template<typename _ExecutionPolicy, typename _FIter, typename _Size,
+	   typename _Function>
+    inline __enable_if_execution_policy<_ExecutionPolicy, _FIter>
+    for_each_n(_ExecutionPolicy&&, _FIter __first, _Size __n,
+	       _Function __f)
+    {
+      typedef typename decay<_ExecutionPolicy>::type _Policy;
+      if constexpr (__is_random_access_iter<_FIter>::value)
+	{
+	  if (__n <= 0)
+	    return __first;
+	  typename iterator_traits<_FIter>::difference_type __d = __n;
+	  __gnu_parallel::__execution_for_each<_Policy>(__first, __d, __f);
+	  return __first + __d;
+	}
+      else
+	return __gnu_parallel::__execution_for_each_n_seq(__first, __n, __f);
+    }
+
+  // [alg.transform]
+  template<typename _ExecutionPolicy, typename _FIter1, typename _FIter2,
+	   typename _UnaryOperation>
+    inline __enable_if_execution_policy<_ExecutionPolicy, _FIter2>
+    transform(_ExecutionPolicy&&, _FIter1 __first, _FIter1 __last,
+	      _FIter2 __result, _UnaryOperation __op)
+    {
+      typedef typename decay<_ExecutionPolicy>::type _Policy;
+      if constexpr (__gnu_parallel::__is_parallel_policy<_Policy>::value
+		    && __is_random_access_iter<_FIter1>::value
+		    && __is_random_access_iter<_FIter2>::value)
+	{
+	  const auto __n = __last - __first;
+	  __gnu_parallel::__execution_transform1_body<_FIter1, _FIter2,
+	    _UnaryOperation,
+	    __gnu_parallel::__is_unsequenced_policy<_Policy>::value>
+	    __body = { __first, __result, __op };
+	  __gnu_parallel::__execution_for(__n,
+	      __gnu_parallel::_Settings::get().transform_minimal_n, __body);
+	  return __result + __n;
+	}
+      else
+	return __gnu_parallel::__execution_transform_seq(__first, __last,
+							 __result, __op);
+    }
+
+  template<typename _ExecutionPolicy, typename _FIter1, typename _FIter2,
+	   typename _FIter3, typename _BinaryOperation>
+    inline __enable_if_execution_policy<_ExecutionPolicy, _FIter3>
+    transform(_ExecutionPolicy&&, _FIter1 __first1, _FIter1 __last1,
+	      _FIter2 __first2, _FIter3 __result, _BinaryOperation __op)
+    {
+      typedef typename decay<_ExecutionPolicy>::type _Policy;
+      if constexpr (__gnu_parallel::__is_parallel_policy<_Policy>::value
+		    && __is_random_access_iter<_FIter1>::value
+		    && __is_random_access_iter<_FIter2>::value
+		    && __is_random_access_iter<_FIter3>::value)
+	{
+	  const auto __n = __last1 - __first1;
+	  __gnu_parallel::__execution_transform2_body<_FIter1, _FIter2,
+	    _FIter3, _BinaryOperation,
+	    __gnu_parallel::__is_unsequenced_policy<_Policy>::value>
+	    __body = { __first1, __first2, __result, __op };
+	  __gnu_parallel::__execution_for(__n,
+	      __gnu_parallel::_Settings::get().transform_minimal_n, __body);
+	  return __result + __n;
+	}
+      else
+	return __gnu_parallel::__execution_transform_seq(__first1, __last1,
+							 __first2, __result,
+							 __op);
+    }
+
+  // [alg.sort]
+  template<typename _ExecutionPolicy, typename _RAIter, typename _Compare>
+    inline __enable_if_execution_policy<_ExecutionPolicy, void>
+    sort(_ExecutionPolicy&&, _RAIter __first, _RAIter __last,
+	 _Compare __comp)
+    {
+      typedef typename decay<_ExecutionPolicy>::type _Policy;
+      if constexpr (__gnu_parallel::__is_parallel_policy<_Policy>::value)
+	__gnu_parallel::__execution_sort<false>(__first, __last, __comp);
+      else
+	__gnu_parallel::__execution_sort_seq<false>(__first, __last, __comp);
+    }
+
+  template<typename _ExecutionPolicy, typename _RAIter>
+    inline __enable_if_execution_policy<_ExecutionPolicy, void>
+    sort(_ExecutionPolicy&& __exec, _RAIter __first, _RAIter __last)
+    {
+      std::sort(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+		less<>());
+    }
+
+  // [stable.sort]
+  template<typename _ExecutionPolicy, typename _RAIter, typename _Compare>
+    inline __enable_if_execution_policy<_ExecutionPolicy, void>
+    stable_sort(_ExecutionPolicy&&, _RAIter __first, _RAIter __last,
+		_Compare __comp)
+    {
+      typedef typename decay<_ExecutionPolicy>::type _Policy;
+      if constexpr (__gnu_parallel::__is_parallel_policy<_Policy>::value)
+	__gnu_parallel::__execution_sort<true>(__first, __last, __comp);
+      else
+	__gnu_parallel::__execution_sort_seq<true>(__first, __last, __comp);
+    }
+
+  template<typename _ExecutionPolicy, typename _RAIter>
+    inline __enable_if_execution_policy<_ExecutionPolicy, void>
+    stable_sort(_ExecutionPolicy&& __exec, _RAIter __first, _RAIter __last)
+    {
+      std::stable_sort(std::forward<_ExecutionPolicy>(__exec),
+		       __first, __last, less<>());
+    }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
+
+#endif /* _GLIBCXX_PARALLEL_EXECUTION_ALGO_H */
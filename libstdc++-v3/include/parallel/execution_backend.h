@@ -0,0 +1,322 @@
+// -*- C++ -*-
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the terms
+// of the GNU General Public License as published by the Free Software
+// Foundation; either version 3, or (at your option) any later
+// version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/**
+ * @file parallel/execution_backend.h
+ * @brief Task backends for the C++17 parallel algorithms.
+ *
+ *  The algorithms taking a std::execution policy hand their work to an
+ *  execution_backend as a number of independent tasks.  The default
+ *  backend is a fork-join pool of std::thread workers, so the parallel
+ *  algorithms do not need -fopenmp; a different backend can be
+ *  installed with __gnu_parallel::set_execution_backend().
+ *
+ *  This file is a GNU parallel extension to the Standard C++ Library.
+ */
+
+#ifndef _GLIBCXX_PARALLEL_EXECUTION_BACKEND_H
+#define _GLIBCXX_PARALLEL_EXECUTION_BACKEND_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus >= 201103L
+
+#include <cstddef>
+#include <atomic>
+#include <bits/c++config.h>
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+# include <vector>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+#endif
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace __gnu_parallel
+{
+  /// Interface of the task backends running the parallel algorithms.
+  class execution_backend
+  {
+  public:
+    /// A task.  It is called with the argument passed to run() and the
+    /// index of the task, and must not throw.
+    typedef void (*task_type)(void*, std::size_t);
+
+    virtual
+    ~execution_backend() { }
+
+    /// Number of tasks that can usefully run at the same time.
+    virtual unsigned int
+    concurrency() const noexcept = 0;
+
+    /** @brief Run @c __task(__arg, __i) for every @c __i in [0, @c __n).
+     *
+     *  The tasks may run concurrently and in any order; run() returns
+     *  once all of them have finished.  Tasks can call run() again.  */
+    virtual void
+    run(std::size_t __n, task_type __task, void* __arg) = 0;
+  };
+
+  /// Backend running all tasks in the calling thread.
+  class sequential_backend : public execution_backend
+  {
+  public:
+    unsigned int
+    concurrency() const noexcept
+    { return 1; }
+
+    void
+    run(std::size_t __n, task_type __task, void* __arg)
+    {
+      for (std::size_t __i = 0; __i < __n; ++__i)
+	__task(__arg, __i);
+    }
+  };
+
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+  /** @brief Fork-join pool of std::thread workers.
+   *
+   *  The thread calling run() publishes the job and then takes tasks
+   *  from it like any worker, so nested calls of run() from inside a
+   *  task always make progress even when every worker is busy.  Tasks
+   *  are handed out one at a time from an atomic counter, which
+   *  balances the load when the tasks have different costs.  */
+  class thread_pool : public execution_backend
+  {
+    struct _Job
+    {
+      std::size_t		_M_n;
+      task_type			_M_task;
+      void*			_M_arg;
+      std::atomic<std::size_t>	_M_next;
+      // Workers that took the job and may still touch it.
+      unsigned int		_M_workers;
+      _Job*			_M_prev;
+      _Job*			_M_succ;
+      bool			_M_linked;
+
+      _Job(std::size_t __n, task_type __task, void* __arg)
+      : _M_n(__n), _M_task(__task), _M_arg(__arg), _M_next(0),
+	_M_workers(0), _M_prev(nullptr), _M_succ(nullptr), _M_linked(false)
+      { }
+
+      // Run tasks until none are left.
+      void
+      _M_drain()
+      {
+	std::size_t __i;
+	while ((__i = _M_next.fetch_add(1, std::memory_order_relaxed)) < _M_n)
+	  _M_task(_M_arg, __i);
+      }
+    };
+
+  public:
+    /// Start a pool with @c __nthreads threads, including the caller.
+    explicit
+    thread_pool(unsigned int __nthreads = std::thread::hardware_concurrency())
+    : _M_jobs(nullptr), _M_stop(false)
+    {
+      if (!__gthread_active_p())
+	return;
+      __try
+	{
+	  for (unsigned int __i = 1; __i < __nthreads; ++__i)
+	    _M_threads.emplace_back(&thread_pool::_M_worker, this);
+	}
+      __catch(...)
+	{
+	  // Run with the workers that could be started.
+	}
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+      {
+	std::lock_guard<std::mutex> __l(_M_mx);
+	_M_stop = true;
+      }
+      _M_work_cv.notify_all();
+      for (auto& __t : _M_threads)
+	__t.join();
+    }
+
+    unsigned int
+    concurrency() const noexcept
+    { return _M_threads.size() + 1; }
+
+    void
+    run(std::size_t __n, task_type __task, void* __arg)
+    {
+      if (__n == 0)
+	return;
+      if (__n == 1 || _M_threads.empty())
+	{
+	  for (std::size_t __i = 0; __i < __n; ++__i)
+	    __task(__arg, __i);
+	  return;
+	}
+
+      _Job __job(__n, __task, __arg);
+      {
+	std::lock_guard<std::mutex> __l(_M_mx);
+	_M_link(__job);
+      }
+      _M_work_cv.notify_all();
+
+      __job._M_drain();
+
+      std::unique_lock<std::mutex> __l(_M_mx);
+      _M_unlink(__job);
+      _M_done_cv.wait(__l, [&__job] { return __job._M_workers == 0; });
+    }
+
+  private:
+    // Newest jobs first, so that the tasks of nested calls are finished
+    // before more outer tasks are started.
+    void
+    _M_link(_Job& __job)
+    {
+      __job._M_succ = _M_jobs;
+      if (_M_jobs)
+	_M_jobs->_M_prev = &__job;
+      _M_jobs = &__job;
+      __job._M_linked = true;
+    }
+
+    void
+    _M_unlink(_Job& __job)
+    {
+      if (!__job._M_linked)
+	return;
+      if (__job._M_prev)
+	__job._M_prev->_M_succ = __job._M_succ;
+      else
+	_M_jobs = __job._M_succ;
+      if (__job._M_succ)
+	__job._M_succ->_M_prev = __job._M_prev;
+      __job._M_linked = false;
+    }
+
+    void
+    _M_worker()
+    {
+      std::unique_lock<std::mutex> __l(_M_mx);
+      for (;;)
+	{
+	  _M_work_cv.wait(__l, [this] { return _M_stop || _M_jobs; });
+	  if (_M_stop)
+	    return;
+
+	  _Job& __job = *_M_jobs;
+	  ++__job._M_workers;
+	  __l.unlock();
+	  __job._M_drain();
+	  __l.lock();
+	  // No tasks are left, so nobody else needs to find the job.
+	  _M_unlink(__job);
+	  if (--__job._M_workers == 0)
+	    _M_done_cv.notify_all();
+	}
+    }
+
+    std::mutex			_M_mx;
+    std::condition_variable	_M_work_cv;
+    std::condition_variable	_M_done_cv;
+    _Job*			_M_jobs;
+    bool			_M_stop;
+    std::vector<std::thread>	_M_threads;
+  };
+#endif
+
+#ifdef _OPENMP
+  /// Backend running the tasks of each job in an OpenMP parallel region.
+  class omp_backend : public execution_backend
+  {
+  public:
+    unsigned int
+    concurrency() const noexcept
+    { return omp_get_max_threads(); }
+
+    void
+    run(std::size_t __n, task_type __task, void* __arg)
+    {
+#     pragma omp parallel for schedule(dynamic, 1)
+      for (std::size_t __i = 0; __i < __n; ++__i)
+	__task(__arg, __i);
+    }
+  };
+#endif
+
+  inline std::atomic<execution_backend*>&
+  __execution_backend_slot() noexcept
+  {
+    static std::atomic<execution_backend*> __backend{nullptr};
+    return __backend;
+  }
+
+  /// The backend used when none has been installed.
+  inline execution_backend*
+  __default_execution_backend()
+  {
+#if defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)
+    // Never destroyed, so that parallel algorithms keep working in
+    // destructors of other objects with static storage duration.
+    static thread_pool* __pool = new thread_pool;
+    return __pool;
+#else
+    static sequential_backend __seq;
+    return &__seq;
+#endif
+  }
+
+  /// Return the backend used by the parallel algorithms.
+  inline execution_backend*
+  get_execution_backend()
+  {
+    execution_backend* __b
+      = __execution_backend_slot().load(std::memory_order_acquire);
+    return __b ? __b : __default_execution_backend();
+  }
+
+  /** @brief Make the parallel algorithms use @c __b.
+   *
+   *  A null pointer selects the default thread pool again.  The backend
+   *  must stay alive while any parallel algorithm may use it.
+   *  @return The previously installed backend, or null.  */
+  inline execution_backend*
+  set_execution_backend(execution_backend* __b) noexcept
+  {
+    return __execution_backend_slot().exchange(__b,
+						std::memory_order_acq_rel);
+  }
+} // end namespace __gnu_parallel
+
+#endif // C++11
+
+#endif /* _GLIBCXX_PARALLEL_EXECUTION_BACKEND_H */
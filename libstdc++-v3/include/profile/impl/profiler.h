@@ -357,6 +357,20 @@ namespace __gnu_profile
 #define _GLIBCXX_PROFILE_MEM_PER_DIAGNOSTIC_ENV_VAR \
   "_GLIBCXX_PROFILE_MEM_PER_DIAGNOSTIC"
 #endif
+#ifndef _GLIBCXX_PROFILE_SAMPLE_RATE
+#define _GLIBCXX_PROFILE_SAMPLE_RATE 1
+#endif
+#ifndef _GLIBCXX_PROFILE_SAMPLE_RATE_ENV_VAR
+#define _GLIBCXX_PROFILE_SAMPLE_RATE_ENV_VAR \
+  "_GLIBCXX_PROFILE_SAMPLE_RATE"
+#endif
+#ifndef _GLIBCXX_PROFILE_REPORT_INTERVAL
+#define _GLIBCXX_PROFILE_REPORT_INTERVAL 0
+#endif
+#ifndef _GLIBCXX_PROFILE_REPORT_INTERVAL_ENV_VAR
+#define _GLIBCXX_PROFILE_REPORT_INTERVAL_ENV_VAR \
+  "_GLIBCXX_PROFILE_REPORT_INTERVAL"
+#endif
 
 // Instrumentation hook implementations.
 #include "profile/impl/profiler_hash_func.h"
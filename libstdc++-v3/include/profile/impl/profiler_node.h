@@ -44,11 +44,17 @@ namespace __gnu_profile
   typedef __stack_npt* __stack_t;
 
   std::size_t __stack_max_depth();
+  bool __sample_object();
 
   inline __stack_t
   __get_stack()
   {
 #if defined _GLIBCXX_HAVE_EXECINFO_H
+    // Objects that are not sampled get no context, and therefore no
+    // instrumentation at all.  Decide before paying for the backtrace.
+    if (!__sample_object())
+      return 0;
+
     __try
       {
 	std::size_t __max_depth = __stack_max_depth();
@@ -43,6 +43,7 @@
 #endif
 
 #include <ext/concurrence.h>
+#include <ctime>
 #include <fstream>
 #include <string>
 #include <utility>
@@ -121,6 +122,7 @@ namespace __gnu_profile
   void __trace_list_to_slist_free();  
   void __trace_list_to_vector_free();  
   void __trace_map_to_unordered_map_free();
+  void __report_if_due();
 
   struct __cost_factor
   {
@@ -176,6 +178,12 @@ namespace __gnu_profile
 			       _GLIBCXX_PROFILE_MAX_STACK_DEPTH);
   _GLIBCXX_PROFILE_DEFINE_DATA(std::size_t, _S_max_mem,
 			       _GLIBCXX_PROFILE_MEM_PER_DIAGNOSTIC);
+  _GLIBCXX_PROFILE_DEFINE_DATA(std::size_t, _S_sample_rate,
+			       _GLIBCXX_PROFILE_SAMPLE_RATE);
+  _GLIBCXX_PROFILE_DEFINE_DATA(std::size_t, _S_sample_count, 0);
+  _GLIBCXX_PROFILE_DEFINE_DATA(std::size_t, _S_report_interval,
+			       _GLIBCXX_PROFILE_REPORT_INTERVAL);
+  _GLIBCXX_PROFILE_DEFINE_DATA(std::time_t, _S_next_report, 0);
 
   inline std::size_t
   __stack_max_depth()
@@ -185,6 +193,22 @@ namespace __gnu_profile
   __max_mem()
   { return _GLIBCXX_PROFILE_DATA(_S_max_mem); }
 
+  /** @brief Whether the object being constructed should be instrumented.
+   *
+   * Only one in every _S_sample_rate objects is.  The others never
+   * allocate an object info, so all their hooks are a null test.
+   */
+  inline bool
+  __sample_object()
+  {
+    std::size_t __rate = _GLIBCXX_PROFILE_DATA(_S_sample_rate);
+    if (__rate <= 1)
+      return true;
+
+    return __atomic_fetch_add(&_GLIBCXX_PROFILE_DATA(_S_sample_count), 1,
+			      __ATOMIC_RELAXED) % __rate == 0;
+  }
+
   /** @brief Base class for all trace producers.  */
   template<typename __object_info, typename __stack_info>
     class __trace_base
@@ -258,36 +282,41 @@ namespace __gnu_profile
       if (!__obj_info)
 	return;
 
-      __gnu_cxx::__scoped_lock __lock(this->__trace_mutex);
+      {
+	__gnu_cxx::__scoped_lock __lock(this->__trace_mutex);
 
-      const __object_info& __info = *__obj_info;
-      __stack_t __stack = __info.__stack();
-      typename __stack_table_t::iterator __stack_it
-	= __stack_table.find(__stack);
+	const __object_info& __info = *__obj_info;
+	__stack_t __stack = __info.__stack();
+	typename __stack_table_t::iterator __stack_it
+	  = __stack_table.find(__stack);
     
-      if (__stack_it == __stack_table.end())
-	{
-	  // First occurrence of this call context.
-	  if (__max_mem() == 0 || __stack_table_byte_size < __max_mem()) 
-	    {
-	      __stack_table_byte_size 
-		+= (sizeof(__instruction_address_t) * __size(__stack)
-		    + sizeof(__stack) + sizeof(__stack_info));
-	      __stack_table.insert(make_pair(__stack,
-					     __stack_info(__info)));
-	    }
-	  else
+	if (__stack_it == __stack_table.end())
+	  {
+	    // First occurrence of this call context.
+	    if (__max_mem() == 0 || __stack_table_byte_size < __max_mem()) 
+	      {
+		__stack_table_byte_size 
+		  += (sizeof(__instruction_address_t) * __size(__stack)
+		      + sizeof(__stack) + sizeof(__stack_info));
+		__stack_table.insert(make_pair(__stack,
+					       __stack_info(__info)));
+	      }
+	    else
+	      delete __stack;
+	  }
+	else
+	  {
+	    // Merge object info into info summary for this call context.
+	    __stack_it->second.__merge(__info);
 	    delete __stack;
-	}
-      else
-	{
-	  // Merge object info into info summary for this call context.
-	  __stack_it->second.__merge(__info);
-	  delete __stack;
-	}
+	  }
+
+	delete __obj_info;
+	__objects_byte_size -= sizeof(__object_info);
+      }
 
-      delete __obj_info;
-      __objects_byte_size -= sizeof(__object_info);
+      // Outside the trace lock, __report takes it again.
+      __report_if_due();
     }
 
   template<typename __object_info, typename __stack_info>
@@ -295,6 +324,8 @@ namespace __gnu_profile
     __trace_base<__object_info, __stack_info>::
     __write(FILE* __f)
     {
+      __gnu_cxx::__scoped_lock __lock(this->__trace_mutex);
+
       for (typename __stack_table_t::iterator __it
 	     = __stack_table.begin(); __it != __stack_table.end(); ++__it)
 	if (__it->second.__is_valid())
@@ -312,6 +343,8 @@ namespace __gnu_profile
     __trace_base<__object_info, __stack_info>::
     __collect_warnings(__warning_vector_t& __warnings)
     {
+      __gnu_cxx::__scoped_lock __lock(this->__trace_mutex);
+
       for (typename __stack_table_t::iterator __it
 	     = __stack_table.begin(); __it != __stack_table.end(); ++__it)
 	__warnings.push_back(__warning_data(__it->second.__magnitude(),
@@ -369,6 +402,25 @@ namespace __gnu_profile
 			_GLIBCXX_PROFILE_DATA(_S_max_mem));
   }
 
+  inline void
+  __set_sample_rate()
+  {
+    _GLIBCXX_PROFILE_DATA(_S_sample_rate)
+      = __env_to_size_t(_GLIBCXX_PROFILE_SAMPLE_RATE_ENV_VAR,
+			_GLIBCXX_PROFILE_DATA(_S_sample_rate));
+  }
+
+  inline void
+  __set_report_interval()
+  {
+    _GLIBCXX_PROFILE_DATA(_S_report_interval)
+      = __env_to_size_t(_GLIBCXX_PROFILE_REPORT_INTERVAL_ENV_VAR,
+			_GLIBCXX_PROFILE_DATA(_S_report_interval));
+    if (_GLIBCXX_PROFILE_DATA(_S_report_interval))
+      _GLIBCXX_PROFILE_DATA(_S_next_report)
+	= std::time(0) + _GLIBCXX_PROFILE_DATA(_S_report_interval);
+  }
+
   inline int
   __log_magnitude(float __f)
   {
@@ -472,6 +524,39 @@ namespace __gnu_profile
     std::fclose(__warn_file);
   }
 
+  /** @brief Periodic report, when _S_report_interval seconds have passed
+   *  since the previous one.
+   *
+   * Each report overwrites the previous one with everything collected so
+   * far, so a long running process can be inspected without exiting.  Only
+   * objects already destroyed contribute.
+   */
+  inline void
+  __report_if_due()
+  {
+    std::size_t __interval = _GLIBCXX_PROFILE_DATA(_S_report_interval);
+    if (__interval == 0)
+      return;
+
+    std::time_t __now = std::time(0);
+    std::time_t __next = __atomic_load_n(&_GLIBCXX_PROFILE_DATA(_S_next_report),
+					 __ATOMIC_RELAXED);
+    if (__now < __next)
+      return;
+
+    // Only the thread that moves the deadline forward writes the report.
+    if (!__atomic_compare_exchange_n(&_GLIBCXX_PROFILE_DATA(_S_next_report),
+				     &__next, __now + __interval, false,
+				     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      return;
+
+    if (!__reentrance_guard::__get_in())
+      return;
+
+    __reentrance_guard __get_out;
+    __report();
+  }
+
   inline void
   __report_and_free()
   {
@@ -625,6 +710,8 @@ namespace __gnu_profile
 	  {
 	    __set_max_stack_trace_depth();
 	    __set_max_mem();
+	    __set_sample_rate();
+	    __set_report_interval();
 	    __set_trace_path();
 	    __read_cost_factors(); 
 	    __set_cost_factors();
@@ -67,7 +67,15 @@ __dynamic_cast (const void *src_ptr,    // object started from
 				    -offsetof (vtable_prefix, origin));
   if (whole_prefix->whole_type != whole_type)
     return NULL;
-  
+
+  // If src is the unique public nonvirtual base of dst at offset src2dst
+  // and the whole object is a dst with src at just that offset, there is
+  // nothing to search for.  This is the common down cast to the most
+  // derived type.
+  if (src2dst >= 0 && src2dst == -prefix->whole_object
+      && *whole_type == *dst_type)
+    return const_cast <void *> (whole_ptr);
+
   whole_type->__do_dyncast (src2dst, __class_type_info::__contained_public,
                             dst_type, whole_ptr, src_type, src_ptr, result);
   if (!result.dst_ptr)
@@ -73,6 +73,14 @@ using namespace __cxxabiv1;
 # define EMERGENCY_OBJ_COUNT	4
 #endif
 
+// Exception objects whose allocation, including the exception header,
+// fits into TCACHE_OBJ_SIZE bytes are recycled through a small per-thread
+// cache so that a burst of throws does not hit malloc for every object.
+#if defined _GLIBCXX_HAVE_TLS && defined __GTHREADS && _GLIBCXX_HOSTED
+# define TCACHE_OBJ_SIZE	(EMERGENCY_OBJ_SIZE / 2)
+# define TCACHE_OBJ_COUNT	8
+#endif
+
 namespace __gnu_cxx
 {
   void __freeres();
@@ -116,11 +124,24 @@ namespace
 
   pool::pool()
     {
-      // Allocate the arena - we could add a GLIBCXX_EH_ARENA_SIZE environment
-      // to make this tunable.
+      // Allocate the arena.  Its size can be overridden by setting
+      // GLIBCXX_EH_ARENA_SIZE in the environment to a number of bytes,
+      // zero meaning no emergency pool at all.
       arena_size = (EMERGENCY_OBJ_SIZE * EMERGENCY_OBJ_COUNT
 		    + EMERGENCY_OBJ_COUNT * sizeof (__cxa_dependent_exception));
-      arena = (char *)malloc (arena_size);
+#if _GLIBCXX_HOSTED
+      if (const char *env = std::getenv ("GLIBCXX_EH_ARENA_SIZE"))
+	{
+	  char *end;
+	  unsigned long sz = std::strtoul (env, &end, 0);
+	  if (end != env && *end == '\0')
+	    arena_size = sz;
+	}
+#endif
+      if (arena_size < sizeof (free_entry))
+	arena = NULL;
+      else
+	arena = (char *)malloc (arena_size);
       if (!arena)
 	{
 	  // If the allocation failed go without an emergency pool.
@@ -250,6 +271,90 @@ namespace
   pool emergency_pool;
 }
 
+#ifdef TCACHE_OBJ_SIZE
+extern "C" void *__dso_handle __attribute__ ((__visibility__ ("hidden")));
+
+namespace
+{
+  // Every object handed out by malloc is preceded by its size so that it
+  // can be put back into the cache when freed.  Blocks are interchangeable
+  // between threads, so an exception freed on another thread than the one
+  // that threw it simply ends up in the cache of the freeing thread.
+  struct tcache_entry {
+    std::size_t size;
+    char data[] __attribute__((aligned));
+  };
+
+  enum tcache_state { tcache_unused, tcache_active, tcache_dead };
+
+  struct tcache {
+    void *objs[TCACHE_OBJ_COUNT];
+    unsigned count;
+    tcache_state state;
+  };
+
+  __thread tcache thread_cache;
+
+  void
+  tcache_flush (tcache &c)
+  {
+    while (c.count)
+      free (reinterpret_cast <char *> (c.objs[--c.count])
+	    - offsetof (tcache_entry, data));
+  }
+
+  void
+  tcache_release (void *p)
+  {
+    tcache *c = static_cast<tcache *> (p);
+    tcache_flush (*c);
+    // Objects freed by thread-local destructors running after us
+    // go straight back to malloc.
+    c->state = tcache_dead;
+  }
+
+  void *
+  tcache_allocate (std::size_t size)
+  {
+    tcache_entry *e;
+    if (size <= TCACHE_OBJ_SIZE)
+      {
+	tcache &c = thread_cache;
+	if (c.count)
+	  return c.objs[--c.count];
+	size = TCACHE_OBJ_SIZE;
+      }
+    e = static_cast<tcache_entry *>
+      (malloc (offsetof (tcache_entry, data) + size));
+    if (!e)
+      return NULL;
+    e->size = size;
+    return &e->data;
+  }
+
+  void
+  tcache_free (void *data)
+  {
+    tcache_entry *e = reinterpret_cast <tcache_entry *>
+      (reinterpret_cast <char *> (data) - offsetof (tcache_entry, data));
+    if (e->size == TCACHE_OBJ_SIZE)
+      {
+	tcache &c = thread_cache;
+	if (__builtin_expect (c.state == tcache_unused, false))
+	  c.state = (__cxa_thread_atexit (tcache_release, &c,
+					     &__dso_handle) == 0
+		     ? tcache_active : tcache_dead);
+	if (c.state == tcache_active && c.count < TCACHE_OBJ_COUNT)
+	  {
+	    c.objs[c.count++] = data;
+	    return;
+	  }
+      }
+    free (e);
+  }
+}
+#endif
+
 namespace __gnu_cxx
 {
   void
@@ -260,6 +365,35 @@ namespace __gnu_cxx
 	::free(emergency_pool.arena);
 	emergency_pool.arena = 0;
       }
+#ifdef TCACHE_OBJ_SIZE
+    tcache_flush (thread_cache);
+#endif
+  }
+}
+
+namespace
+{
+  inline void *
+  malloc_exception (std::size_t size)
+  {
+#ifdef TCACHE_OBJ_SIZE
+    return tcache_allocate (size);
+#else
+    return malloc (size);
+#endif
+  }
+
+  inline void
+  free_exception (void *ptr)
+  {
+    if (emergency_pool.in_pool (ptr))
+      emergency_pool.free (ptr);
+    else
+#ifdef TCACHE_OBJ_SIZE
+      tcache_free (ptr);
+#else
+      free (ptr);
+#endif
   }
 }
 
@@ -269,7 +403,7 @@ __cxxabiv1::__cxa_allocate_exception(std::size_t thrown_size) _GLIBCXX_NOTHROW
   void *ret;
 
   thrown_size += sizeof (__cxa_refcounted_exception);
-  ret = malloc (thrown_size);
+  ret = malloc_exception (thrown_size);
 
   if (!ret)
     ret = emergency_pool.allocate (thrown_size);
@@ -287,10 +421,7 @@ extern "C" void
 __cxxabiv1::__cxa_free_exception(void *vptr) _GLIBCXX_NOTHROW
 {
   char *ptr = (char *) vptr - sizeof (__cxa_refcounted_exception);
-  if (emergency_pool.in_pool (ptr))
-    emergency_pool.free (ptr);
-  else
-    free (ptr);
+  free_exception (ptr);
 }
 
 
@@ -300,7 +431,7 @@ __cxxabiv1::__cxa_allocate_dependent_exception() _GLIBCXX_NOTHROW
   __cxa_dependent_exception *ret;
 
   ret = static_cast<__cxa_dependent_exception*>
-    (malloc (sizeof (__cxa_dependent_exception)));
+    (malloc_exception (sizeof (__cxa_dependent_exception)));
 
   if (!ret)
     ret = static_cast <__cxa_dependent_exception*>
@@ -319,8 +450,5 @@ extern "C" void
 __cxxabiv1::__cxa_free_dependent_exception
   (__cxa_dependent_exception *vptr) _GLIBCXX_NOTHROW
 {
-  if (emergency_pool.in_pool (vptr))
-    emergency_pool.free (vptr);
-  else
-    free (vptr);
+  free_exception (vptr);
 }
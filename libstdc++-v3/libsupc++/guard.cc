@@ -46,7 +46,7 @@
 
 // Thread-safe static local initialization support.
 #ifdef __GTHREADS
-# ifndef _GLIBCXX_USE_FUTEX
+# if !defined(_GLIBCXX_USE_FUTEX) && !defined(__GTHREAD_HAS_COND)
 namespace
 {
   // A single mutex controlling all static initializations.
@@ -86,24 +86,54 @@ namespace
 # if defined(__GTHREAD_HAS_COND) && !defined(_GLIBCXX_USE_FUTEX)
 namespace
 {
-  // A single condition variable controlling all static initializations.
-  static __gnu_cxx::__cond* static_cond;  
+  // Guard variables are spread over a small table of mutexes and
+  // condition variables, so that threads waiting for one static to be
+  // initialized do not contend with unrelated initializations.  None of
+  // these is held while the initializer runs.
+  const unsigned guard_lock_count = 16;
+
+  struct guard_lock
+  {
+    __gnu_cxx::__mutex mutex;
+    __gnu_cxx::__cond cond;
+  };
+
+  static guard_lock* guard_locks;
 
   // using a fake type to avoid initializing a static class.
-  typedef char fake_cond_t[sizeof(__gnu_cxx::__cond)]
-  __attribute__ ((aligned(__alignof__(__gnu_cxx::__cond))));
-  fake_cond_t fake_cond;
+  typedef char fake_guard_locks_t[guard_lock_count * sizeof(guard_lock)]
+  __attribute__ ((aligned(__alignof__(guard_lock))));
+  fake_guard_locks_t fake_guard_locks;
 
-  static void init_static_cond()
-  { static_cond =  new (&fake_cond) __gnu_cxx::__cond(); }
+  static void init_guard_locks()
+  {
+    guard_lock* locks = reinterpret_cast<guard_lock*>(&fake_guard_locks);
+    for (unsigned i = 0; i < guard_lock_count; ++i)
+      new (&locks[i]) guard_lock();
+    guard_locks = locks;
+  }
 
-  __gnu_cxx::__cond&
-  get_static_cond()
+  guard_lock&
+  get_guard_lock(__cxxabiv1::__guard* g)
   {
     static __gthread_once_t once = __GTHREAD_ONCE_INIT;
-    __gthread_once(&once, init_static_cond);
-    return *static_cond;
+    __gthread_once(&once, init_guard_locks);
+    __UINTPTR_TYPE__ addr = reinterpret_cast<__UINTPTR_TYPE__>(g);
+    return guard_locks[(addr / sizeof(__cxxabiv1::__guard))
+		       % guard_lock_count];
   }
+
+  // Simple wrapper for exception safety.
+  struct guard_lock_wrapper
+  {
+    guard_lock& lock;
+    explicit guard_lock_wrapper(__cxxabiv1::__guard* g)
+    : lock(get_guard_lock(g))
+    { lock.mutex.lock(); }
+
+    ~guard_lock_wrapper()
+    { lock.mutex.unlock(); }
+  };
 }
 # endif
 
@@ -176,6 +206,11 @@ __set_and_release (__cxxabiv1::__guard *g)
 // like condition variables. For platforms that do not support condition
 // variables, we need to fall back to the old code.
 
+// With condition variables, the guard is hashed onto one of a small table
+// of mutex and condition variable pairs instead of a single global pair,
+// so waiting for a slow initializer only blocks threads interested in the
+// guards that share its slot.
+
 // If _GLIBCXX_USE_FUTEX, no global mutex or condition variable is used,
 // only atomic operations are used together with futex syscall.
 // Valid values of the first integer in guard are:
@@ -302,43 +337,46 @@ namespace __cxxabiv1
 	    syscall (SYS_futex, gi, _GLIBCXX_FUTEX_WAIT, expected, 0);
 	  }
       }
-# else
+# elif defined(__GTHREAD_HAS_COND)
     if (__gthread_active_p ())
       {
-	mutex_wrapper mw;
+	guard_lock_wrapper lw(g);
 
-	while (1)	// When this loop is executing, mutex is locked.
+	while (1)	// When this loop is executing, the lock is held.
 	  {
-#  ifdef __GTHREAD_HAS_COND
 	    // The static is already initialized.
 	    if (_GLIBCXX_GUARD_TEST(g))
-	      return 0;	// The mutex will be unlocked via wrapper
+	      return 0;	// The lock will be released via wrapper.
 
 	    if (init_in_progress_flag(g))
 	      {
 		// The guarded static is currently being initialized by
-		// another thread, so we release mutex and wait for the
-		// condition variable. We will lock the mutex again after
+		// another thread, so we release the lock and wait for the
+		// condition variable. We will hold the lock again after
 		// this.
-		get_static_cond().wait_recursive(&get_static_mutex());
+		lw.lock.cond.wait(&lw.lock.mutex);
 	      }
 	    else
 	      {
 		set_init_in_progress_flag(g, 1);
-		return 1; // The mutex will be unlocked via wrapper.
-	      }
-#  else
-	    // This provides compatibility with older systems not supporting
-	    // POSIX like condition variables.
-	    if (acquire(g))
-	      {
-		mw.unlock = false;
-		return 1; // The mutex still locked.
+		return 1; // The lock will be released via wrapper.
 	      }
-	    return 0; // The mutex will be unlocked via wrapper.
-#  endif
 	  }
       }
+# else
+    if (__gthread_active_p ())
+      {
+	mutex_wrapper mw;
+
+	// This provides compatibility with older systems not supporting
+	// POSIX like condition variables.
+	if (acquire(g))
+	  {
+	    mw.unlock = false;
+	    return 1; // The mutex still locked.
+	  }
+	return 0; // The mutex will be unlocked via wrapper.
+      }
 # endif
 #endif
 
@@ -364,13 +402,13 @@ namespace __cxxabiv1
 #elif defined(__GTHREAD_HAS_COND)
     if (__gthread_active_p())
       {	
-	mutex_wrapper mw;
+	guard_lock_wrapper lw(g);
 
 	set_init_in_progress_flag(g, 0);
 
 	// If we abort, we still need to wake up all other threads waiting for
 	// the condition variable.
-        get_static_cond().broadcast();
+	lw.lock.cond.broadcast();
 	return;
       }	
 #endif
@@ -404,12 +442,12 @@ namespace __cxxabiv1
 #elif defined(__GTHREAD_HAS_COND)
     if (__gthread_active_p())
       {
-	mutex_wrapper mw;
+	guard_lock_wrapper lw(g);
 
 	set_init_in_progress_flag(g, 0);
 	_GLIBCXX_GUARD_SET_AND_RELEASE(g);
 
-        get_static_cond().broadcast();
+	lw.lock.cond.broadcast();
 	return;
       }	
 #endif
@@ -30,12 +30,64 @@
 #include <syscall.h>
 #include <unistd.h>
 #include <sys/time.h>
+#include <time.h>
 #include <errno.h>
 #include <debug/debug.h>
 
 // Constants for the wait/wake futex syscall operations
 const unsigned futex_wait_op = 0;
 const unsigned futex_wake_op = 1;
+const unsigned futex_wait_bitset_op = 9;
+const unsigned futex_clock_realtime_flag = 256;
+const unsigned futex_bitset_match_any = ~0;
+
+namespace
+{
+  // Set once the kernel has rejected FUTEX_WAIT_BITSET, which has taken
+  // absolute timeouts since Linux 2.6.25.
+  std::atomic<bool> futex_bitset_unavailable(false);
+
+  // Wait with an absolute timeout measured on CLOCK_REALTIME if __realtime,
+  // CLOCK_MONOTONIC otherwise.  Returns false iff a timeout occurred, and
+  // sets __done to false if the operation is not supported.
+  bool
+  futex_wait_abs(unsigned* __addr, unsigned __val, bool __realtime,
+		 std::chrono::seconds __s, std::chrono::nanoseconds __ns,
+		 bool& __done)
+  {
+    __done = false;
+    if (futex_bitset_unavailable.load(std::memory_order_relaxed))
+      return true;
+
+    struct timespec rt;
+    rt.tv_sec = __s.count();
+    rt.tv_nsec = __ns.count();
+    // Negative timeouts are rejected with EINVAL.
+    if (rt.tv_sec < 0)
+      {
+	__done = true;
+	return false;
+      }
+
+    const unsigned op = futex_wait_bitset_op
+      | (__realtime ? futex_clock_realtime_flag : 0);
+    if (syscall (SYS_futex, __addr, op, __val, &rt, nullptr,
+		 futex_bitset_match_any) == -1)
+      {
+	if (errno == ENOSYS)
+	  {
+	    futex_bitset_unavailable.store(true, std::memory_order_relaxed);
+	    return true;
+	  }
+	_GLIBCXX_DEBUG_ASSERT(errno == EINTR || errno == EAGAIN
+			      || errno == ETIMEDOUT);
+	__done = true;
+	return errno != ETIMEDOUT;
+      }
+    __done = true;
+    return true;
+  }
+}
 
 namespace std _GLIBCXX_VISIBILITY(default)
 {
@@ -58,6 +110,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       }
     else
       {
+	bool done;
+	const bool ret = futex_wait_abs(__addr, __val, true, __s, __ns, done);
+	if (done)
+	  return ret;
+
 	struct timeval tv;
 	gettimeofday (&tv, NULL);
 	// Convert the absolute timeout value to a relative timeout
@@ -84,6 +141,50 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       }
   }
 
+#ifdef _GLIBCXX_USE_CLOCK_MONOTONIC
+  bool
+  __atomic_futex_unsigned_base::_M_futex_wait_until_steady(unsigned *__addr,
+      unsigned __val,
+      bool __has_timeout, chrono::seconds __s, chrono::nanoseconds __ns)
+  {
+    if (!__has_timeout)
+      return _M_futex_wait_until(__addr, __val, false, __s, __ns);
+
+    bool done;
+    const bool ret = futex_wait_abs(__addr, __val, false, __s, __ns, done);
+    if (done)
+      return ret;
+
+    struct timespec ts;
+#ifdef _GLIBCXX_USE_CLOCK_GETTIME_SYSCALL
+    syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    // Convert the absolute timeout value to a relative timeout
+    struct timespec rt;
+    rt.tv_sec = __s.count() - ts.tv_sec;
+    rt.tv_nsec = __ns.count() - ts.tv_nsec;
+    if (rt.tv_nsec < 0)
+      {
+	rt.tv_nsec += 1000000000;
+	--rt.tv_sec;
+      }
+    // Did we already time out?
+    if (rt.tv_sec < 0)
+      return false;
+
+    if (syscall (SYS_futex, __addr, futex_wait_op, __val, &rt) == -1)
+      {
+	_GLIBCXX_DEBUG_ASSERT(errno == EINTR || errno == EAGAIN
+			      || errno == ETIMEDOUT);
+	if (errno == ETIMEDOUT)
+	  return false;
+      }
+    return true;
+  }
+#endif
+
   void
   __atomic_futex_unsigned_base::_M_futex_notify_all(unsigned* __addr)
   {
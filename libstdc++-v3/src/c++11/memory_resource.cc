@@ -0,0 +1,631 @@
+// <memory_resource> implementation -*- C++ -*-
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+// This file is compiled with -std=gnu++17, see Makefile.am.
+
+#include <memory_resource>
+#include <atomic>
+#include <new>
+
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+namespace pmr
+{
+  namespace
+  {
+    class newdel_res_t final : public memory_resource
+    {
+      void*
+      do_allocate(size_t __bytes, size_t __alignment) override
+      {
+	if (__alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+	  return ::operator new(__bytes, std::align_val_t(__alignment));
+	return ::operator new(__bytes);
+      }
+
+      void
+      do_deallocate(void* __p, size_t __bytes, size_t __alignment) override
+      {
+	if (__alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+	  ::operator delete(__p, __bytes, std::align_val_t(__alignment));
+	else
+	  ::operator delete(__p, __bytes);
+      }
+
+      bool
+      do_is_equal(const memory_resource& __other) const noexcept override
+      { return &__other == this; }
+    };
+
+    class null_res_t final : public memory_resource
+    {
+      void*
+      do_allocate(size_t, size_t) override
+      { std::__throw_bad_alloc(); }
+
+      void
+      do_deallocate(void*, size_t, size_t) override
+      { }
+
+      bool
+      do_is_equal(const memory_resource& __other) const noexcept override
+      { return &__other == this; }
+    };
+
+    // The global resources are never destroyed, so that they can still be
+    // used by the destructors of other static objects.
+    template<typename _Tp>
+      struct constant_init
+      {
+	union {
+	  unsigned char _M_unused;
+	  _Tp _M_obj;
+	};
+
+	constexpr constant_init() : _M_obj() { }
+
+	template<typename _Up>
+	  explicit constexpr constant_init(_Up __arg) : _M_obj(__arg) { }
+
+	~constant_init() { /* Do not destroy _M_obj.  */ }
+      };
+
+    constant_init<newdel_res_t> newdel_res;
+    constant_init<null_res_t> null_res;
+    constant_init<atomic<memory_resource*>> default_res{&newdel_res._M_obj};
+
+    // Round __n up to a multiple of __align, which is a power of two.
+    constexpr size_t
+    aligned_ceil(size_t __n, size_t __align)
+    { return (__n + __align - 1) & ~(__align - 1); }
+
+    // Add __n and __m, throwing bad_alloc on overflow.
+    size_t
+    checked_add(size_t __n, size_t __m)
+    {
+      if (__n > __gnu_cxx::__numeric_traits<size_t>::__max - __m)
+	std::__throw_bad_alloc();
+      return __n + __m;
+    }
+
+    // Position of the highest bit set in __n, which is not zero.
+    inline int
+    log2p(size_t __n)
+    {
+      return __gnu_cxx::__numeric_traits<unsigned long long>::__digits - 1
+	- __builtin_clzll(__n);
+    }
+
+    // Smallest power of two not less than __n, which is not zero and not
+    // greater than the largest power of two representable in size_t.
+    inline size_t
+    bit_ceil(size_t __n)
+    {
+      if (__n <= 1)
+	return 1;
+      return size_t(1) << (log2p(__n - 1) + 1);
+    }
+  } // namespace
+
+  memory_resource::~memory_resource() = default;
+
+  memory_resource*
+  new_delete_resource() noexcept
+  { return &newdel_res._M_obj; }
+
+  memory_resource*
+  null_memory_resource() noexcept
+  { return &null_res._M_obj; }
+
+  memory_resource*
+  set_default_resource(memory_resource* __r) noexcept
+  {
+    if (__r == nullptr)
+      __r = new_delete_resource();
+    return default_res._M_obj.exchange(__r);
+  }
+
+  memory_resource*
+  get_default_resource() noexcept
+  { return default_res._M_obj.load(); }
+
+  // Member functions for std::pmr::monotonic_buffer_resource
+
+  // Each buffer obtained from upstream has one of these at its end,
+  // linking it into the list headed by _M_head.
+  struct monotonic_buffer_resource::_Chunk
+  {
+    // Allocate a buffer of at least __size usable bytes from __r and link
+    // it into the list __head.  Updates __size to the usable size.
+    static void*
+    allocate(memory_resource* __r, size_t& __size, size_t __align,
+	     _Chunk*& __head)
+    {
+      checked_add(__size, alignof(_Chunk) - 1);
+      __size = aligned_ceil(__size, alignof(_Chunk));
+      const size_t __total = checked_add(__size, sizeof(_Chunk));
+      void* __p = __r->allocate(__total, __align);
+      __head = ::new((char*)__p + __size) _Chunk{__total, __align, __head};
+      return __p;
+    }
+
+    // Return every buffer in the list __head to __r.
+    static void
+    release(_Chunk*& __head, memory_resource* __r) noexcept
+    {
+      while (_Chunk* __c = __head)
+	{
+	  __head = __c->_M_next;
+	  void* __p = (char*)(__c + 1) - __c->_M_size;
+	  __r->deallocate(__p, __c->_M_size, __c->_M_align);
+	}
+    }
+
+    size_t _M_size;
+    size_t _M_align;
+    _Chunk* _M_next;
+  };
+
+  monotonic_buffer_resource::~monotonic_buffer_resource() { release(); }
+
+  void
+  monotonic_buffer_resource::_M_new_buffer(size_t __bytes, size_t __alignment)
+  {
+    size_t __size = std::max(__bytes, _M_next_bufsiz);
+    const size_t __align = std::max(__alignment, alignof(max_align_t));
+    _M_current_buf = _Chunk::allocate(_M_upstream, __size, __align, _M_head);
+    _M_avail = __size;
+    if (__size > __gnu_cxx::__numeric_traits<size_t>::__max / _S_growth_factor)
+      _M_next_bufsiz = __gnu_cxx::__numeric_traits<size_t>::__max;
+    else
+      _M_next_bufsiz = __size * _S_growth_factor;
+  }
+
+  void
+  monotonic_buffer_resource::_M_release_buffers() noexcept
+  { _Chunk::release(_M_head, _M_upstream); }
+
+  // Helper types and functions for the pool resources.
+
+  namespace
+  {
+    // Blocks served from the pools are powers of two between these sizes.
+    constexpr size_t min_block_size = 8;
+    constexpr size_t default_largest_block = 4096;
+    constexpr size_t max_largest_block = size_t(1) << 20;
+
+    // Limits for pool_options::max_blocks_per_chunk.
+    constexpr size_t default_blocks_per_chunk = 1024;
+    constexpr size_t max_blocks_per_chunk = size_t(1) << 20;
+
+    // Chunks grow geometrically up to this many bytes, unless a single
+    // block is larger.
+    constexpr size_t max_chunk_bytes = size_t(1) << 22;
+
+    static_assert(min_block_size >= sizeof(void*),
+		  "a free block must be able to hold a pointer");
+
+    pool_options
+    munge_options(pool_options __opts)
+    {
+      if (__opts.max_blocks_per_chunk == 0)
+	__opts.max_blocks_per_chunk = default_blocks_per_chunk;
+      else if (__opts.max_blocks_per_chunk > max_blocks_per_chunk)
+	__opts.max_blocks_per_chunk = max_blocks_per_chunk;
+
+      if (__opts.largest_required_pool_block == 0)
+	__opts.largest_required_pool_block = default_largest_block;
+      else if (__opts.largest_required_pool_block < min_block_size)
+	__opts.largest_required_pool_block = min_block_size;
+      else if (__opts.largest_required_pool_block > max_largest_block)
+	__opts.largest_required_pool_block = max_largest_block;
+      else
+	__opts.largest_required_pool_block
+	  = bit_ceil(__opts.largest_required_pool_block);
+      return __opts;
+    }
+
+    inline int
+    pool_count(const pool_options& __opts)
+    {
+      return log2p(__opts.largest_required_pool_block)
+	- log2p(min_block_size) + 1;
+    }
+  } // namespace
+
+  // A chunk carved into blocks of one pool, with this record at its end.
+  struct __pool_chunk
+  {
+    size_t _M_size;	// Bytes in the chunk, including this record.
+    __pool_chunk* _M_next;
+  };
+
+  // A pool of blocks of size _M_block_sz.  Freed blocks are kept in an
+  // intrusive free list and reused before carving more from the newest
+  // chunk.  Chunks are only returned upstream by release().
+  struct __pool_resource::_Pool
+  {
+    explicit
+    _Pool(size_t __block_size, size_t __max_blocks) noexcept
+    : _M_block_sz(__block_size),
+      _M_max_blocks(std::max<size_t>(1, std::min(__max_blocks,
+					       max_chunk_bytes / __block_size))),
+      _M_next_nblocks(std::max<size_t>(1, std::min(_M_max_blocks,
+						 1024 / __block_size)))
+    { }
+
+    void*
+    try_allocate() noexcept
+    {
+      if (void* __p = _M_free)
+	{
+	  _M_free = *static_cast<void**>(__p);
+	  return __p;
+	}
+      if (_M_bump != _M_end)
+	{
+	  void* __p = _M_bump;
+	  _M_bump += _M_block_sz;
+	  return __p;
+	}
+      return nullptr;
+    }
+
+    void
+    deallocate(void* __p) noexcept
+    {
+      *static_cast<void**>(__p) = _M_free;
+      _M_free = __p;
+    }
+
+    // Get a new chunk from __r and carve the next block from it.
+    void*
+    replenish(memory_resource* __r)
+    {
+      const size_t __bytes = _M_next_nblocks * _M_block_sz;
+      const size_t __total = __bytes + sizeof(__pool_chunk);
+      void* __p = __r->allocate(__total, std::min(_M_block_sz, chunk_align));
+      _M_chunks = ::new((char*)__p + __bytes) __pool_chunk{__total,
+							    _M_chunks};
+      _M_bump = static_cast<char*>(__p) + _M_block_sz;
+      _M_end = static_cast<char*>(__p) + __bytes;
+      if (_M_next_nblocks < _M_max_blocks)
+	_M_next_nblocks = std::min(_M_next_nblocks * 2, _M_max_blocks);
+      return __p;
+    }
+
+    // Return all chunks to __r.
+    void
+    release(memory_resource* __r) noexcept
+    {
+      while (__pool_chunk* __c = _M_chunks)
+	{
+	  _M_chunks = __c->_M_next;
+	  void* __p = (char*)(__c + 1) - __c->_M_size;
+	  __r->deallocate(__p, __c->_M_size,
+			  std::min(_M_block_sz, chunk_align));
+	}
+      _M_free = nullptr;
+      _M_bump = _M_end = nullptr;
+    }
+
+    // Alignment of chunks, which is also the largest alignment a pool
+    // can satisfy.  Larger blocks are aligned to this value only.
+    static constexpr size_t chunk_align = 4096;
+
+    void* _M_free = nullptr;
+    char* _M_bump = nullptr;
+    char* _M_end = nullptr;
+    __pool_chunk* _M_chunks = nullptr;
+    const size_t _M_block_sz;
+    const size_t _M_max_blocks;
+    size_t _M_next_nblocks;
+  };
+
+  // A block too large for the pools, with this record at its end.
+  struct __pool_resource::_BigBlock
+  {
+    _BigBlock* _M_next;
+    _BigBlock* _M_prev;
+    size_t _M_size;	// Bytes allocated, including this record.
+    size_t _M_align;
+
+    // Offset of the record from the start of a block of __bytes.
+    static size_t
+    offset(size_t __bytes) noexcept
+    { return aligned_ceil(__bytes, alignof(_BigBlock)); }
+  };
+
+  __pool_resource::
+  __pool_resource(const pool_options& __opts, memory_resource* __upstream)
+  : _M_opts(munge_options(__opts)), _M_upstream(__upstream),
+    _M_npools(pool_count(_M_opts))
+  { }
+
+  __pool_resource::~__pool_resource() { release(); }
+
+  void*
+  __pool_resource::allocate(size_t __bytes, size_t __alignment)
+  {
+    checked_add(__bytes, alignof(_BigBlock) - 1);
+    const size_t __off = _BigBlock::offset(__bytes);
+    const size_t __total = checked_add(__off, sizeof(_BigBlock));
+    const size_t __align = std::max(__alignment, alignof(_BigBlock));
+    void* __p = _M_upstream->allocate(__total, __align);
+    _BigBlock* __b = ::new((char*)__p + __off)
+      _BigBlock{_M_unpooled, nullptr, __total, __align};
+    if (_M_unpooled)
+      _M_unpooled->_M_prev = __b;
+    _M_unpooled = __b;
+    return __p;
+  }
+
+  void
+  __pool_resource::deallocate(void* __p, size_t __bytes, size_t)
+  {
+    _BigBlock* __b = reinterpret_cast<_BigBlock*>
+      ((char*)__p + _BigBlock::offset(__bytes));
+    if (__b->_M_next)
+      __b->_M_next->_M_prev = __b->_M_prev;
+    if (__b->_M_prev)
+      __b->_M_prev->_M_next = __b->_M_next;
+    else
+      _M_unpooled = __b->_M_next;
+    _M_upstream->deallocate(__p, __b->_M_size, __b->_M_align);
+  }
+
+  void
+  __pool_resource::release() noexcept
+  {
+    while (_BigBlock* __b = _M_unpooled)
+      {
+	_M_unpooled = __b->_M_next;
+	void* __p = (char*)(__b + 1) - __b->_M_size;
+	_M_upstream->deallocate(__p, __b->_M_size, __b->_M_align);
+      }
+  }
+
+  int
+  __pool_resource::_M_pool_index(size_t __bytes, size_t __alignment)
+  const noexcept
+  {
+    if (__alignment > _Pool::chunk_align)
+      return _M_npools;
+    const size_t __n = std::max(__bytes, __alignment);
+    if (__n <= min_block_size)
+      return 0;
+    if (__n > _M_opts.largest_required_pool_block)
+      return _M_npools;
+    return log2p(__n - 1) + 1 - log2p(min_block_size);
+  }
+
+  auto
+  __pool_resource::_M_alloc_pools()
+  -> _Pool*
+  {
+    void* __p = _M_upstream->allocate(_M_npools * sizeof(_Pool),
+				      alignof(_Pool));
+    _Pool* __pools = static_cast<_Pool*>(__p);
+    for (int __i = 0; __i < _M_npools; ++__i)
+      ::new(__pools + __i) _Pool(min_block_size << __i,
+				 _M_opts.max_blocks_per_chunk);
+    return __pools;
+  }
+
+  void
+  __pool_resource::_M_free_pools(_Pool* __pools) noexcept
+  {
+    for (int __i = 0; __i < _M_npools; ++__i)
+      {
+	__pools[__i].release(_M_upstream);
+	__pools[__i].~_Pool();
+      }
+    _M_upstream->deallocate(__pools, _M_npools * sizeof(_Pool),
+			    alignof(_Pool));
+  }
+
+  // Member functions for std::pmr::unsynchronized_pool_resource
+
+  unsynchronized_pool_resource::
+  unsynchronized_pool_resource(const pool_options& __opts,
+			       memory_resource* __upstream)
+  : _M_impl(__opts, __upstream)
+  { }
+
+  unsynchronized_pool_resource::~unsynchronized_pool_resource()
+  { release(); }
+
+  void
+  unsynchronized_pool_resource::release()
+  {
+    if (_M_pools)
+      {
+	_M_impl._M_free_pools(_M_pools);
+	_M_pools = nullptr;
+      }
+    _M_impl.release();
+  }
+
+  void*
+  unsynchronized_pool_resource::do_allocate(size_t __bytes,
+					    size_t __alignment)
+  {
+    const int __i = _M_impl._M_pool_index(__bytes, __alignment);
+    if (__i == _M_impl._M_npools)
+      return _M_impl.allocate(__bytes, __alignment);
+
+    if (__builtin_expect(_M_pools == nullptr, false))
+      _M_pools = _M_impl._M_alloc_pools();
+    if (void* __p = _M_pools[__i].try_allocate())
+      return __p;
+    return _M_pools[__i].replenish(_M_impl.resource());
+  }
+
+  void
+  unsynchronized_pool_resource::do_deallocate(void* __p, size_t __bytes,
+					      size_t __alignment)
+  {
+    const int __i = _M_impl._M_pool_index(__bytes, __alignment);
+    if (__i == _M_impl._M_npools)
+      return _M_impl.deallocate(__p, __bytes, __alignment);
+
+    _GLIBCXX_DEBUG_ASSERT(_M_pools != nullptr);
+    _M_pools[__i].deallocate(__p);
+  }
+
+#ifdef _GLIBCXX_HAS_GTHREADS
+  // Member functions for std::pmr::synchronized_pool_resource
+
+  // Each thread allocating from or deallocating to the resource has its
+  // own set of pools, found through _M_key, so that pooled allocations
+  // only take _M_mx when a pool needs a new chunk from upstream.  A block
+  // may be returned to the pools of a different thread than the one that
+  // allocated it, which is harmless because all chunks are only released
+  // together.  The pools of an exited thread are reused by the next
+  // thread that needs pools, instead of being leaked until release().
+  struct synchronized_pool_resource::_TPools
+  {
+    _Pool* _M_pools = nullptr;
+    _TPools* _M_next = nullptr;
+    // Set by the thread-exit handler once the owning thread is gone.
+    bool _M_exited = false;
+  };
+
+  synchronized_pool_resource::
+  synchronized_pool_resource(const pool_options& __opts,
+			     memory_resource* __upstream)
+  : _M_impl(__opts, __upstream)
+  {
+    if (int __err = __gthread_key_create(&_M_key, _S_thread_exit))
+      __throw_system_error(__err);
+  }
+
+  synchronized_pool_resource::~synchronized_pool_resource()
+  {
+    release();
+    __gthread_key_delete(_M_key);
+    while (_TPools* __t = _M_tpools)
+      {
+	_M_tpools = __t->_M_next;
+	__t->~_TPools();
+	_M_impl.resource()->deallocate(__t, sizeof(_TPools),
+				       alignof(_TPools));
+      }
+  }
+
+  void
+  synchronized_pool_resource::_S_thread_exit(void* __p)
+  {
+    __atomic_store_n(&static_cast<_TPools*>(__p)->_M_exited, true,
+		     __ATOMIC_RELEASE);
+  }
+
+  void
+  synchronized_pool_resource::release()
+  {
+    __gnu_cxx::__scoped_lock __l(_M_mx);
+    for (_TPools* __t = _M_tpools; __t; __t = __t->_M_next)
+      if (__t->_M_pools)
+	{
+	  _M_impl._M_free_pools(__t->_M_pools);
+	  __t->_M_pools = nullptr;
+	}
+    _M_impl.release();
+  }
+
+  auto
+  synchronized_pool_resource::_M_thread_pools()
+  -> _TPools*
+  {
+    if (void* __p = __gthread_getspecific(_M_key))
+      return static_cast<_TPools*>(__p);
+
+    __gnu_cxx::__scoped_lock __l(_M_mx);
+    _TPools* __t = _M_tpools;
+    while (__t && !__atomic_load_n(&__t->_M_exited, __ATOMIC_ACQUIRE))
+      __t = __t->_M_next;
+    if (__t)
+      __t->_M_exited = false;
+    else
+      {
+	void* __p = _M_impl.resource()->allocate(sizeof(_TPools),
+						 alignof(_TPools));
+	__t = ::new(__p) _TPools;
+	__t->_M_next = _M_tpools;
+	_M_tpools = __t;
+      }
+    if (__t->_M_pools == nullptr)
+      __t->_M_pools = _M_impl._M_alloc_pools();
+    __gthread_setspecific(_M_key, __t);
+    return __t;
+  }
+
+  void*
+  synchronized_pool_resource::do_allocate(size_t __bytes, size_t __alignment)
+  {
+    const int __i = _M_impl._M_pool_index(__bytes, __alignment);
+    if (__i == _M_impl._M_npools)
+      {
+	__gnu_cxx::__scoped_lock __l(_M_mx);
+	return _M_impl.allocate(__bytes, __alignment);
+      }
+
+    _TPools* __t = _M_thread_pools();
+    if (__builtin_expect(__t->_M_pools == nullptr, false))
+      {
+	// The pools were freed by release().
+	__gnu_cxx::__scoped_lock __l(_M_mx);
+	__t->_M_pools = _M_impl._M_alloc_pools();
+      }
+    if (void* __p = __t->_M_pools[__i].try_allocate())
+      return __p;
+    __gnu_cxx::__scoped_lock __l(_M_mx);
+    return __t->_M_pools[__i].replenish(_M_impl.resource());
+  }
+
+  void
+  synchronized_pool_resource::do_deallocate(void* __p, size_t __bytes,
+					    size_t __alignment)
+  {
+    const int __i = _M_impl._M_pool_index(__bytes, __alignment);
+    if (__i == _M_impl._M_npools)
+      {
+	__gnu_cxx::__scoped_lock __l(_M_mx);
+	return _M_impl.deallocate(__p, __bytes, __alignment);
+      }
+
+    _TPools* __t = _M_thread_pools();
+    if (__builtin_expect(__t->_M_pools == nullptr, false))
+      {
+	__gnu_cxx::__scoped_lock __l(_M_mx);
+	__t->_M_pools = _M_impl._M_alloc_pools();
+      }
+    __t->_M_pools[__i].deallocate(__p);
+  }
+#endif // _GLIBCXX_HAS_GTHREADS
+
+} // namespace pmr
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
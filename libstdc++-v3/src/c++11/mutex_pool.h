@@ -24,7 +24,7 @@
 
 namespace __gnu_internal _GLIBCXX_VISIBILITY(hidden)
 {
-  const unsigned char mask = 0xf;
+  const unsigned char mask = 0x3f;
   const unsigned char invalid = mask + 1;
 
   /* Returns different instances of __mutex depending on the passed index
@@ -34,7 +34,10 @@ namespace __gnu_internal _GLIBCXX_VISIBILITY(hidden)
   __gnu_cxx::__mutex&
   get_mutex(unsigned char i)
   {
-    static __gnu_cxx::__mutex m[mask + 1];
+    // Give each mutex its own cache line, so that threads locking
+    // different mutexes do not slow each other down.
+    struct alignas(64) padded_mutex : __gnu_cxx::__mutex { };
+    static padded_mutex m[mask + 1];
     return m[i];
   }
 }
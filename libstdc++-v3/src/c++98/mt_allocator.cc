@@ -72,9 +72,21 @@ namespace
     return freelist_mutex;
   }
 
+#ifdef _GLIBCXX_HAVE_TLS
+  // The id stored under freelist._M_key for the calling thread, kept
+  // here as well so that finding it takes no __gthread_getspecific call.
+  __thread uintptr_t thread_id;
+#endif
+
   static void
   _M_destroy_thread_key(void* __id)
   {
+#ifdef _GLIBCXX_HAVE_TLS
+    // Destructors for other keys may still allocate after this, and
+    // must not keep using the id we are about to give back.
+    thread_id = 0;
+#endif
+
     // Return this thread id record to the front of thread_freelist.
     __freelist& freelist = get_freelist();
     {
@@ -630,9 +642,18 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     // returns its id.
     if (__gthread_active_p())
       {
+#ifdef _GLIBCXX_HAVE_TLS
+	uintptr_t _M_id = thread_id;
+	if (__builtin_expect(_M_id != 0, true))
+	  return _M_id >= _M_options._M_max_threads ? 0 : _M_id;
+#endif
 	__freelist& freelist = get_freelist();
 	void* v = __gthread_getspecific(freelist._M_key);
+#ifdef _GLIBCXX_HAVE_TLS
+	_M_id = (uintptr_t)v;
+#else
 	uintptr_t _M_id = (uintptr_t)v;
+#endif
 	if (_M_id == 0)
 	  {
 	    {
@@ -647,6 +668,9 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 
 	    __gthread_setspecific(freelist._M_key, (void*)_M_id);
 	  }
+#ifdef _GLIBCXX_HAVE_TLS
+	thread_id = _M_id;
+#endif
 	return _M_id >= _M_options._M_max_threads ? 0 : _M_id;
       }
 
@@ -39,6 +39,19 @@
 #else
 # error "the <dirent.h> header is needed to build the Filesystem TS"
 #endif
+#ifdef _GLIBCXX_HAVE_FCNTL_H
+# include <fcntl.h>
+#endif
+#ifdef _GLIBCXX_HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+
+// Open subdirectories relative to the parent's descriptor, so that the
+// kernel does not have to resolve the whole path again for every level.
+#if defined(AT_FDCWD) && defined(O_DIRECTORY) \
+  && !defined(_GLIBCXX_FILESYSTEM_IS_WINDOWS)
+# define _GLIBCXX_FILESYSTEM_USE_OPENAT 1
+#endif
 
 #ifdef _GLIBCXX_FILESYSTEM_IS_WINDOWS
 # undef opendir
@@ -79,15 +92,44 @@ namespace
       return (obj & bits) != Bitmask::none;
     }
 
+  // Opens the directory p.  If parent is not null, p is an entry of that
+  // directory and is opened relative to it.
+  inline DIR*
+  open_dirp(const fs::path& p,
+	    const fs::_Dir* parent __attribute__((__unused__)))
+  {
+#ifdef _GLIBCXX_FILESYSTEM_USE_OPENAT
+    if (parent)
+      {
+	int flags = O_RDONLY | O_DIRECTORY;
+# ifdef O_CLOEXEC
+	flags |= O_CLOEXEC;
+# endif
+	const int fd = ::openat(::dirfd(parent->dirp),
+				p.filename().c_str(), flags);
+	if (fd == -1)
+	  return nullptr;
+	if (DIR* dirp = ::fdopendir(fd))
+	  return dirp;
+	const int err = errno;
+	::close(fd);
+	errno = err;
+	return nullptr;
+      }
+#endif
+    return ::opendir(p.c_str());
+  }
+
   // Returns {dirp, p} on success, {} on error (whether ignored or not).
+  // If parent is not null, p must be an entry of that directory.
   inline fs::_Dir
   open_dir(const fs::path& p, fs::directory_options options,
-	   std::error_code* ec)
+	   std::error_code* ec, const fs::_Dir* parent = nullptr)
   {
     if (ec)
       ec->clear();
 
-    if (DIR* dirp = ::opendir(p.c_str()))
+    if (DIR* dirp = open_dirp(p, parent))
       return {dirp, p};
 
     const int err = errno;
@@ -341,7 +383,7 @@ fs::recursive_directory_iterator::increment(error_code& ec) noexcept
 
   if (std::exchange(_M_pending, true) && recurse(top, _M_options, ec))
     {
-      _Dir dir = open_dir(top.entry.path(), _M_options, &ec);
+      _Dir dir = open_dir(top.entry.path(), _M_options, &ec, &top);
       if (ec)
 	{
 	  _M_dirs.reset();
@@ -0,0 +1,125 @@
+// { dg-do run { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-rtems* *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options "-pthread" { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* powerpc-ibm-aix* } }
+// { dg-require-effective-target c++11 }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Exception objects are recycled through a per-thread cache.  Check that
+// objects thrown on one thread can be released on another, and that
+// objects of different sizes are not mixed up.
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <testsuite_hooks.h>
+
+struct big
+{
+  char buf[4096];
+};
+
+void
+test01()
+{
+  std::vector<std::exception_ptr> ptrs;
+  std::thread t([&] {
+    for (int i = 0; i < 100; ++i)
+      {
+	try
+	  {
+	    if (i % 3 == 0)
+	      throw big();
+	    throw std::runtime_error(std::to_string(i));
+	  }
+	catch (...)
+	  {
+	    ptrs.push_back(std::current_exception());
+	  }
+      }
+  });
+  t.join();
+
+  for (int i = 0; i < 100; ++i)
+    {
+      try
+	{
+	  std::rethrow_exception(ptrs[i]);
+	}
+      catch (const std::runtime_error& e)
+	{
+	  VERIFY( i % 3 != 0 );
+	  VERIFY( e.what() == std::to_string(i) );
+	}
+      catch (const big&)
+	{
+	  VERIFY( i % 3 == 0 );
+	}
+    }
+  ptrs.clear();
+
+  for (int i = 0; i < 1000; ++i)
+    {
+      try
+	{
+	  throw i;
+	}
+      catch (int j)
+	{
+	  VERIFY( j == i );
+	}
+    }
+}
+
+void
+test02()
+{
+  std::vector<std::thread> threads;
+  for (int n = 0; n < 4; ++n)
+    threads.emplace_back([] {
+      for (int i = 0; i < 1000; ++i)
+	{
+	  try
+	    {
+	      try
+		{
+		  throw std::string(i % 7, 'x');
+		}
+	      catch (...)
+		{
+		  std::rethrow_exception(std::current_exception());
+		}
+	    }
+	  catch (const std::string& s)
+	    {
+	      VERIFY( s.size() == std::size_t(i % 7) );
+	    }
+	}
+    });
+  for (auto& t : threads)
+    t.join();
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
@@ -0,0 +1,107 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++1z } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <charconv>
+#include <string>
+#include <climits>
+#include <testsuite_hooks.h>
+
+template<typename T>
+  bool
+  check(const std::string& s, T expected, int base = 10,
+	std::size_t len = std::string::npos)
+  {
+    T val = T(42);
+    auto res = std::from_chars(s.data(), s.data() + s.size(), val, base);
+    if (len == std::string::npos)
+      len = s.size();
+    return res.ec == std::errc{} && res.ptr == s.data() + len
+      && val == expected;
+  }
+
+template<typename T>
+  bool
+  check_error(const std::string& s, std::errc ec, std::size_t len,
+	      int base = 10)
+  {
+    T val = T(42);
+    auto res = std::from_chars(s.data(), s.data() + s.size(), val, base);
+    return res.ec == ec && res.ptr == s.data() + len && val == T(42);
+  }
+
+void
+test01()
+{
+  VERIFY( check("0", 0) );
+  VERIFY( check("123", 123) );
+  VERIFY( check("-123", -123) );
+  VERIFY( check("00123", 123) );
+  VERIFY( check("123abc", 123, 10, 3) );
+  VERIFY( check("2147483647", INT_MAX) );
+  VERIFY( check("-2147483648", INT_MIN) );
+  VERIFY( check(std::to_string(ULLONG_MAX), ULLONG_MAX) );
+  VERIFY( check(std::to_string(LLONG_MIN), LLONG_MIN) );
+  VERIFY( check("-128", (signed char)-128) );
+  VERIFY( check("255", (unsigned char)255) );
+}
+
+void
+test02()
+{
+  VERIFY( check("ff", 255, 16) );
+  VERIFY( check("FF", 255, 16) );
+  VERIFY( check("-Ff", -255, 16) );
+  VERIFY( check("0x1", 0, 16, 1) );
+  VERIFY( check("101", 5, 2) );
+  VERIFY( check("1012", 5, 2, 3) );
+  VERIFY( check("zZ", 36 * 35 + 35, 36) );
+  VERIFY( check("777", 511u, 8) );
+  VERIFY( check(std::string(64, '1'), ULLONG_MAX, 2) );
+}
+
+void
+test03()
+{
+  using std::errc;
+  VERIFY( check_error<int>("", errc::invalid_argument, 0) );
+  VERIFY( check_error<int>("-", errc::invalid_argument, 0) );
+  VERIFY( check_error<int>("+1", errc::invalid_argument, 0) );
+  VERIFY( check_error<int>(" 1", errc::invalid_argument, 0) );
+  VERIFY( check_error<int>("a", errc::invalid_argument, 0) );
+  VERIFY( check_error<unsigned>("-1", errc::invalid_argument, 0) );
+  VERIFY( check_error<int>("2147483648", errc::result_out_of_range, 10) );
+  VERIFY( check_error<int>("-2147483649", errc::result_out_of_range, 11) );
+  VERIFY( check_error<unsigned char>("256x", errc::result_out_of_range, 3) );
+  VERIFY( check_error<signed char>("128", errc::result_out_of_range, 3) );
+  VERIFY( check_error<unsigned long long>("18446744073709551616",
+					  errc::result_out_of_range, 20) );
+  VERIFY( check_error<unsigned long long>(std::string(65, '1'),
+					  errc::result_out_of_range, 65, 2) );
+  VERIFY( check_error<long>(std::string(100, '9') + "!",
+			    errc::result_out_of_range, 100) );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
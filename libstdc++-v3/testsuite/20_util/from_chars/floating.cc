@@ -0,0 +1,124 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++1z } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <charconv>
+#include <string>
+#include <cmath>
+#include <testsuite_hooks.h>
+
+template<typename T>
+  bool
+  check(const std::string& s, T expected, std::size_t len,
+	std::chars_format fmt = std::chars_format::general)
+  {
+    T val = T(42);
+    auto res = std::from_chars(s.data(), s.data() + s.size(), val, fmt);
+    return res.ec == std::errc{} && res.ptr == s.data() + len
+      && val == expected && std::signbit(val) == std::signbit(expected);
+  }
+
+void
+test01()
+{
+  VERIFY( check("0", 0.0, 1) );
+  VERIFY( check("-0", -0.0, 2) );
+  VERIFY( check("1.5", 1.5, 3) );
+  VERIFY( check("-1.5e3", -1500.0, 6) );
+  VERIFY( check(".5", 0.5, 2) );
+  VERIFY( check("5.", 5.0, 2) );
+  VERIFY( check("1e", 1.0, 1) );
+  VERIFY( check("1e+", 1.0, 1) );
+  VERIFY( check("1E-2x", 0.01, 4) );
+  VERIFY( check("0.1", 0.1, 3) );
+  VERIFY( check("0.1", 0.1f, 3) );
+  VERIFY( check("0.1", 0.1L, 3) );
+  VERIFY( check("1.7976931348623157e308", 1.7976931348623157e308, 22) );
+  VERIFY( check("4.9406564584124654e-324", 5e-324, 23) );
+  VERIFY( check("123456789012345678901234567890", 1.2345678901234568e29,
+		30) );
+  VERIFY( check("InF", HUGE_VAL, 3) );
+  VERIFY( check("-infinity", -HUGE_VALF, 9) );
+  VERIFY( check("infinit", HUGE_VAL, 3) );
+
+  double d;
+  std::string s = "nan(123)";
+  auto res = std::from_chars(s.data(), s.data() + s.size(), d);
+  VERIFY( res.ptr == s.data() + s.size() && std::isnan(d) );
+  s = "nan(12";
+  res = std::from_chars(s.data(), s.data() + s.size(), d);
+  VERIFY( res.ptr == s.data() + 3 && std::isnan(d) );
+}
+
+void
+test02()
+{
+  using std::chars_format;
+  VERIFY( check("1.5e3", 1.5, 3, chars_format::fixed) );
+  VERIFY( check("1.5e3", 1500.0, 5, chars_format::scientific) );
+  VERIFY( check("1.8p1", 3.0, 5, chars_format::hex) );
+  VERIFY( check("ff", 255.0, 2, chars_format::hex) );
+  VERIFY( check("-1.8p-1", -0.75f, 7, chars_format::hex) );
+  VERIFY( check("0x1p0", 0.0, 1, chars_format::hex) );
+}
+
+void
+test03()
+{
+  using std::errc;
+  const std::string invalid[] = { "", "-", "+1", " 1", ".", "-.", "e5", "x" };
+  for (const std::string& s : invalid)
+    {
+      double d = 42;
+      auto res = std::from_chars(s.data(), s.data() + s.size(), d);
+      VERIFY( res.ec == errc::invalid_argument );
+      VERIFY( res.ptr == s.data() );
+      VERIFY( d == 42 );
+    }
+
+  // Scientific format requires an exponent.
+  std::string s = "1.5";
+  double d = 42;
+  auto res = std::from_chars(s.data(), s.data() + s.size(), d,
+			     std::chars_format::scientific);
+  VERIFY( res.ec == errc::invalid_argument && d == 42 );
+
+  const std::string out_of_range[] = { "1e400", "-1e400", "1e-400" };
+  for (const std::string& s : out_of_range)
+    {
+      d = 42;
+      res = std::from_chars(s.data(), s.data() + s.size(), d);
+      VERIFY( res.ec == errc::result_out_of_range );
+      VERIFY( res.ptr == s.data() + s.size() );
+      VERIFY( d == 42 );
+    }
+
+  float f = 42;
+  s = "1e39";
+  res = std::from_chars(s.data(), s.data() + s.size(), f);
+  VERIFY( res.ec == errc::result_out_of_range && f == 42 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,158 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <memory_resource>
+#include <vector>
+#include <cstdint>
+#include <testsuite_hooks.h>
+
+using std::pmr::memory_resource;
+using std::pmr::polymorphic_allocator;
+using std::pmr::new_delete_resource;
+using std::pmr::null_memory_resource;
+using std::pmr::get_default_resource;
+using std::pmr::set_default_resource;
+
+struct counted_resource : memory_resource
+{
+  std::size_t allocated = 0;
+  std::size_t deallocated = 0;
+
+private:
+  void*
+  do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    allocated += bytes;
+    return new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void
+  do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    deallocated += bytes;
+    new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool
+  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+// Global resources.
+void
+test01()
+{
+  memory_resource* r = new_delete_resource();
+  VERIFY( get_default_resource() == r );
+  VERIFY( *r == *new_delete_resource() );
+  VERIFY( *r != *null_memory_resource() );
+  void* p = r->allocate(5);
+  VERIFY( p != nullptr );
+  r->deallocate(p, 5);
+  p = r->allocate(64, 64);
+  VERIFY( reinterpret_cast<std::uintptr_t>(p) % 64 == 0 );
+  r->deallocate(p, 64, 64);
+
+  bool caught = false;
+  try
+  {
+    null_memory_resource()->allocate(1);
+  }
+  catch (const std::bad_alloc&)
+  {
+    caught = true;
+  }
+  VERIFY( caught );
+
+  counted_resource cr;
+  VERIFY( set_default_resource(&cr) == r );
+  VERIFY( get_default_resource() == &cr );
+  VERIFY( set_default_resource(nullptr) == &cr );
+  VERIFY( get_default_resource() == r );
+}
+
+// polymorphic_allocator with a container.
+void
+test02()
+{
+  counted_resource cr;
+  {
+    std::vector<int, polymorphic_allocator<int>> v(&cr);
+    for (int i = 0; i < 100; ++i)
+      v.push_back(i);
+    VERIFY( v.get_allocator().resource() == &cr );
+    auto v2 = v;
+    VERIFY( v2.get_allocator().resource() == get_default_resource() );
+  }
+  VERIFY( cr.allocated > 0 );
+  VERIFY( cr.allocated == cr.deallocated );
+}
+
+struct uses_alloc
+{
+  using allocator_type = polymorphic_allocator<char>;
+
+  uses_alloc(int i, const allocator_type& a) : val(i), alloc(a) { }
+
+  int val;
+  allocator_type alloc;
+};
+
+// Uses-allocator construction, including for the members of pairs.
+void
+test03()
+{
+  counted_resource cr;
+  polymorphic_allocator<uses_alloc> a(&cr);
+  uses_alloc* p = a.allocate(1);
+  a.construct(p, 1);
+  VERIFY( p->val == 1 );
+  VERIFY( p->alloc.resource() == &cr );
+  a.destroy(p);
+  a.deallocate(p, 1);
+
+  using pair = std::pair<uses_alloc, int>;
+  polymorphic_allocator<pair> pa(&cr);
+  pair* pp = pa.allocate(1);
+  pa.construct(pp, 2, 3);
+  VERIFY( pp->first.val == 2 );
+  VERIFY( pp->first.alloc.resource() == &cr );
+  VERIFY( pp->second == 3 );
+  pa.destroy(pp);
+  pa.construct(pp, std::piecewise_construct, std::make_tuple(4),
+	       std::make_tuple(5));
+  VERIFY( pp->first.val == 4 );
+  VERIFY( pp->first.alloc.resource() == &cr );
+  pa.destroy(pp);
+  pa.deallocate(pp, 1);
+  VERIFY( cr.allocated == cr.deallocated );
+
+  polymorphic_allocator<int> ia(pa);
+  VERIFY( ia == pa );
+  VERIFY( ia != polymorphic_allocator<int>() );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,63 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do compile }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory_resource>
+
+template<typename T>
+  using alloc = std::pmr::polymorphic_allocator<T>;
+
+template<typename T, typename U>
+  constexpr bool same = std::is_same<T, U>::value;
+
+static_assert(same<std::pmr::vector<int>, std::vector<int, alloc<int>>>);
+static_assert(same<std::pmr::deque<int>, std::deque<int, alloc<int>>>);
+static_assert(same<std::pmr::forward_list<int>,
+		   std::forward_list<int, alloc<int>>>);
+static_assert(same<std::pmr::list<int>, std::list<int, alloc<int>>>);
+
+using pair = std::pair<const int, long>;
+static_assert(same<std::pmr::map<int, long>,
+		   std::map<int, long, std::less<int>, alloc<pair>>>);
+static_assert(same<std::pmr::multimap<int, long>,
+		   std::multimap<int, long, std::less<int>, alloc<pair>>>);
+static_assert(same<std::pmr::set<int>,
+		   std::set<int, std::less<int>, alloc<int>>>);
+static_assert(same<std::pmr::multiset<int>,
+		   std::multiset<int, std::less<int>, alloc<int>>>);
+static_assert(same<std::pmr::unordered_map<int, long>,
+		   std::unordered_map<int, long, std::hash<int>,
+				      std::equal_to<int>, alloc<pair>>>);
+static_assert(same<std::pmr::unordered_multimap<int, long>,
+		   std::unordered_multimap<int, long, std::hash<int>,
+					   std::equal_to<int>, alloc<pair>>>);
+static_assert(same<std::pmr::unordered_set<int>,
+		   std::unordered_set<int, std::hash<int>,
+				      std::equal_to<int>, alloc<int>>>);
+static_assert(same<std::pmr::unordered_multiset<int>,
+		   std::unordered_multiset<int, std::hash<int>,
+					   std::equal_to<int>, alloc<int>>>);
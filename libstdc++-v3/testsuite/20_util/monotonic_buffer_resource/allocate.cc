@@ -0,0 +1,122 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <testsuite_hooks.h>
+
+struct counted_resource : std::pmr::memory_resource
+{
+  std::size_t allocs = 0;
+  std::size_t deallocs = 0;
+
+private:
+  void*
+  do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocs;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void
+  do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocs;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool
+  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+bool
+aligned(void* p, std::size_t alignment)
+{ return reinterpret_cast<std::uintptr_t>(p) % alignment == 0; }
+
+// Allocations are served from the initial buffer until it is exhausted.
+void
+test01()
+{
+  counted_resource cr;
+  alignas(16) unsigned char buf[256];
+  std::pmr::monotonic_buffer_resource mr(buf, sizeof(buf), &cr);
+  VERIFY( mr.upstream_resource() == &cr );
+
+  void* p1 = mr.allocate(10, 1);
+  void* p2 = mr.allocate(10, 8);
+  VERIFY( p1 == buf );
+  VERIFY( p2 != p1 );
+  VERIFY( aligned(p2, 8) );
+  VERIFY( (unsigned char*)p2 < buf + sizeof(buf) );
+  mr.deallocate(p1, 10, 1);
+  VERIFY( cr.allocs == 0 );
+
+  void* p3 = mr.allocate(512, 64);
+  VERIFY( aligned(p3, 64) );
+  VERIFY( cr.allocs == 1 );
+
+  mr.release();
+  VERIFY( cr.deallocs == 1 );
+  // After release() the initial buffer is used again.
+  VERIFY( mr.allocate(1, 1) == buf );
+}
+
+// Buffers obtained from upstream grow geometrically.
+void
+test02()
+{
+  counted_resource cr;
+  {
+    std::pmr::monotonic_buffer_resource mr(64, &cr);
+    for (int i = 0; i < 10000; ++i)
+      {
+	void* p = mr.allocate(16, alignof(std::max_align_t));
+	VERIFY( aligned(p, alignof(std::max_align_t)) );
+      }
+    VERIFY( cr.allocs > 1 );
+    VERIFY( cr.allocs < 20 );
+    VERIFY( cr.deallocs == 0 );
+  }
+  VERIFY( cr.deallocs == cr.allocs );
+}
+
+// Zero-sized allocations return distinct pointers.
+void
+test03()
+{
+  std::pmr::monotonic_buffer_resource mr;
+  VERIFY( mr.upstream_resource() == std::pmr::get_default_resource() );
+  void* p1 = mr.allocate(0);
+  void* p2 = mr.allocate(0);
+  VERIFY( p1 != p2 );
+  VERIFY( mr == mr );
+  std::pmr::monotonic_buffer_resource mr2;
+  VERIFY( mr != mr2 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
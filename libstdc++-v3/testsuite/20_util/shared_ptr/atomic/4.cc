@@ -0,0 +1,105 @@
+// { dg-do run { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-rtems* *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17 -pthread" { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* powerpc-ibm-aix* *-*-solaris* } }
+// { dg-require-effective-target c++1z }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// atomic<shared_ptr<T>>
+
+#include <memory>
+#include <thread>
+#include <testsuite_hooks.h>
+
+struct config
+{
+  int a, b;
+  ~config() { a = b = -1; }
+};
+
+void
+test01()
+{
+  using P = std::shared_ptr<config>;
+  std::atomic<P> empty;
+  VERIFY( !empty.load() );
+
+  P p = empty.exchange(std::make_shared<config>(config{5, 5}));
+  VERIFY( !p );
+  p = empty;
+  VERIFY( p->a == 5 && p.use_count() == 2 );
+
+  P e;
+  VERIFY( !empty.compare_exchange_strong(e, nullptr) );
+  VERIFY( e == p );
+  VERIFY( empty.compare_exchange_strong(e, nullptr) );
+  VERIFY( !empty.load() );
+  VERIFY( p.use_count() == 2 );
+  e = nullptr;
+  VERIFY( p.use_count() == 1 );
+
+  empty = p;
+  empty.store(nullptr, std::memory_order_release);
+  VERIFY( p.use_count() == 1 );
+
+  // Equal pointers owned by different control blocks are not equivalent.
+  P alias(P(), p.get());
+  empty = p;
+  VERIFY( !empty.compare_exchange_weak(alias, nullptr) );
+  VERIFY( alias == p && alias.use_count() == 3 );
+}
+
+void
+test02()
+{
+  using P = std::shared_ptr<config>;
+  std::atomic<P> cur(std::make_shared<config>(config{0, 0}));
+
+  auto writer = [&] {
+    for (int i = 0; i < 10000; ++i)
+      cur.store(std::make_shared<config>(config{i, i}));
+  };
+  auto updater = [&] {
+    for (int i = 0; i < 10000; ++i)
+      {
+	P old = cur.load(std::memory_order_acquire);
+	cur.compare_exchange_weak(old,
+				  std::make_shared<config>(config{1, 1}));
+      }
+  };
+  auto reader = [&] {
+    for (int i = 0; i < 10000; ++i)
+      {
+	P p = cur.load(std::memory_order_acquire);
+	VERIFY( p->a == p->b && p->a >= 0 );
+      }
+  };
+  std::thread t1(writer), t2(updater), t3(reader), t4(reader);
+  t1.join();
+  t2.join();
+  t3.join();
+  t4.join();
+  VERIFY( cur.load().use_count() == 2 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
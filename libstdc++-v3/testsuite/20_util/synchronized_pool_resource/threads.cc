@@ -0,0 +1,117 @@
+// { dg-do run { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-rtems* *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17 -pthread" { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17" { target *-*-cygwin *-*-rtems* *-*-darwin* } }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <memory_resource>
+#include <thread>
+#include <vector>
+#include <testsuite_hooks.h>
+
+struct counted_resource : std::pmr::memory_resource
+{
+  std::size_t allocs = 0;
+  std::size_t deallocs = 0;
+
+private:
+  // The synchronized pool resource serializes calls to upstream.
+  void*
+  do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocs;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void
+  do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocs;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool
+  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+// Threads allocating and deallocating concurrently, including blocks
+// allocated by another thread.
+void
+test01()
+{
+  counted_resource cr;
+  {
+    std::pmr::synchronized_pool_resource r(&cr);
+    const int nthreads = 4;
+    const int nblocks = 1000;
+    std::vector<int*> blocks[nthreads];
+
+    auto work = [&](int t)
+    {
+      for (int i = 0; i < nblocks; ++i)
+	{
+	  std::size_t n = (i % 50 + 1) * (i % 7 == 0 ? 100 : 1);
+	  int* p = static_cast<int*>(r.allocate(n * sizeof(int)));
+	  p[0] = p[n - 1] = t;
+	  blocks[t].push_back(p);
+	  if (i % 3 == 0)
+	    {
+	      VERIFY( p[0] == t && p[n - 1] == t );
+	      r.deallocate(p, n * sizeof(int));
+	      blocks[t].back() = nullptr;
+	    }
+	}
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t)
+      threads.emplace_back(work, t);
+    for (auto& th : threads)
+      th.join();
+    threads.clear();
+
+    // Free the remaining blocks from other threads.
+    auto cleanup = [&](int t)
+    {
+      auto& v = blocks[(t + 1) % nthreads];
+      for (int i = 0; i < nblocks; ++i)
+	if (int* p = v[i])
+	  {
+	    std::size_t n = (i % 50 + 1) * (i % 7 == 0 ? 100 : 1);
+	    VERIFY( p[0] == (t + 1) % nthreads );
+	    r.deallocate(p, n * sizeof(int));
+	  }
+    };
+    for (int t = 0; t < nthreads; ++t)
+      threads.emplace_back(cleanup, t);
+    for (auto& th : threads)
+      th.join();
+
+    r.release();
+    VERIFY( cr.deallocs < cr.allocs );
+  }
+  VERIFY( cr.deallocs == cr.allocs );
+}
+
+int
+main()
+{
+  test01();
+}
@@ -0,0 +1,97 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++1z } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <charconv>
+#include <string>
+#include <climits>
+#include <testsuite_hooks.h>
+
+template<typename T>
+  std::string
+  to_string(T val, int base = 10)
+  {
+    char buf[72];
+    auto res = std::to_chars(buf, buf + sizeof(buf), val, base);
+    VERIFY( res.ec == std::errc{} );
+    return std::string(buf, res.ptr);
+  }
+
+void
+test01()
+{
+  VERIFY( to_string(0) == "0" );
+  VERIFY( to_string(7) == "7" );
+  VERIFY( to_string(-7) == "-7" );
+  VERIFY( to_string(1234567890) == "1234567890" );
+  VERIFY( to_string(INT_MIN) == std::to_string(INT_MIN) );
+  VERIFY( to_string(LLONG_MIN) == std::to_string(LLONG_MIN) );
+  VERIFY( to_string(ULLONG_MAX) == std::to_string(ULLONG_MAX) );
+  VERIFY( to_string((signed char)-128) == "-128" );
+  VERIFY( to_string((unsigned char)255) == "255" );
+  VERIFY( to_string(100u) == "100" );
+  VERIFY( to_string(99u) == "99" );
+}
+
+void
+test02()
+{
+  VERIFY( to_string(255, 16) == "ff" );
+  VERIFY( to_string(-255, 16) == "-ff" );
+  VERIFY( to_string(8, 8) == "10" );
+  VERIFY( to_string(5, 2) == "101" );
+  VERIFY( to_string(0, 2) == "0" );
+  VERIFY( to_string(35, 36) == "z" );
+  VERIFY( to_string(36, 36) == "10" );
+  VERIFY( to_string(ULLONG_MAX, 2) == std::string(64, '1') );
+  VERIFY( to_string(LLONG_MIN, 2) == "-1" + std::string(63, '0') );
+  VERIFY( to_string(ULLONG_MAX, 16) == std::string(16, 'f') );
+  VERIFY( to_string(ULLONG_MAX, 36) == "3w5e11264sgsf" );
+  VERIFY( to_string(-1000, 7) == "-2626" );
+}
+
+void
+test03()
+{
+  // The buffer must hold the whole representation.
+  char buf[4] = "xyz";
+  auto res = std::to_chars(buf, buf + 3, 1234);
+  VERIFY( res.ec == std::errc::value_too_large );
+  VERIFY( res.ptr == buf + 3 );
+  res = std::to_chars(buf, buf + 3, -123);
+  VERIFY( res.ec == std::errc::value_too_large );
+  res = std::to_chars(buf, buf, 0);
+  VERIFY( res.ec == std::errc::value_too_large );
+  VERIFY( res.ptr == buf );
+  res = std::to_chars(buf, buf + 3, 255, 16);
+  VERIFY( res.ec == std::errc{} );
+  VERIFY( res.ptr == buf + 2 );
+  VERIFY( buf[0] == 'f' && buf[1] == 'f' && buf[2] == 'z' );
+  res = std::to_chars(buf, buf + 3, -12);
+  VERIFY( res.ec == std::errc{} );
+  VERIFY( std::string(buf, res.ptr) == "-12" );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
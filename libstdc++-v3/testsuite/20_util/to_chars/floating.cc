@@ -0,0 +1,164 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++1z } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <charconv>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <testsuite_hooks.h>
+
+template<typename T>
+  std::string
+  to_string(T val)
+  {
+    char buf[400];
+    auto res = std::to_chars(buf, buf + sizeof(buf), val);
+    VERIFY( res.ec == std::errc{} );
+    return std::string(buf, res.ptr);
+  }
+
+template<typename T>
+  std::string
+  to_string(T val, std::chars_format fmt)
+  {
+    char buf[400];
+    auto res = std::to_chars(buf, buf + sizeof(buf), val, fmt);
+    VERIFY( res.ec == std::errc{} );
+    return std::string(buf, res.ptr);
+  }
+
+template<typename T>
+  std::string
+  to_string(T val, std::chars_format fmt, int precision)
+  {
+    char buf[400];
+    auto res = std::to_chars(buf, buf + sizeof(buf), val, fmt, precision);
+    VERIFY( res.ec == std::errc{} );
+    return std::string(buf, res.ptr);
+  }
+
+// Shortest representations.
+void
+test01()
+{
+  VERIFY( to_string(0.0) == "0" );
+  VERIFY( to_string(-0.0) == "-0" );
+  VERIFY( to_string(0.1) == "0.1" );
+  VERIFY( to_string(0.3) == "0.3" );
+  VERIFY( to_string(0.1 + 0.2) == "0.30000000000000004" );
+  VERIFY( to_string(1.5) == "1.5" );
+  VERIFY( to_string(-2.25) == "-2.25" );
+  VERIFY( to_string(100.0) == "100" );
+  VERIFY( to_string(123456.0) == "123456" );
+  VERIFY( to_string(1e22) == "1e+22" );
+  VERIFY( to_string(1e-7) == "1e-07" );
+  VERIFY( to_string(0.001) == "0.001" );
+  VERIFY( to_string(5e-324) == "5e-324" );
+  VERIFY( to_string(1.7976931348623157e308) == "1.7976931348623157e+308" );
+  VERIFY( to_string(2.2250738585072014e-308) == "2.2250738585072014e-308" );
+  VERIFY( to_string(9007199254740993.0) == "9007199254740992" );
+  VERIFY( to_string(0.1f) == "0.1" );
+  VERIFY( to_string(16777216.0f) == "16777216" );
+  VERIFY( to_string(3.4028235e38f) == "3.4028235e+38" );
+  VERIFY( to_string(1e-45f) == "1e-45" );
+  VERIFY( to_string(std::numeric_limits<double>::infinity()) == "inf" );
+  VERIFY( to_string(-std::numeric_limits<float>::infinity()) == "-inf" );
+  VERIFY( to_string(std::numeric_limits<double>::quiet_NaN()) == "nan" );
+}
+
+void
+test02()
+{
+  using std::chars_format;
+  VERIFY( to_string(1234.5, chars_format::scientific) == "1.2345e+03" );
+  VERIFY( to_string(1e100, chars_format::scientific) == "1e+100" );
+  VERIFY( to_string(1234.5, chars_format::fixed) == "1234.5" );
+  VERIFY( to_string(1e-5, chars_format::fixed) == "0.00001" );
+  // Large values in fixed notation are printed exactly.
+  VERIFY( to_string(1e23, chars_format::fixed) == "99999999999999991611392" );
+  VERIFY( to_string(3e10f, chars_format::fixed) == "30000001024" );
+  VERIFY( to_string(123456.0, chars_format::general) == "123456" );
+  VERIFY( to_string(1234567.0, chars_format::general) == "1.234567e+06" );
+  VERIFY( to_string(1e-4, chars_format::general) == "0.0001" );
+  VERIFY( to_string(1e-5, chars_format::general) == "1e-05" );
+  VERIFY( to_string(1.0, chars_format::hex) == "1p+0" );
+  VERIFY( to_string(-0.75, chars_format::hex) == "-1.8p-1" );
+
+  VERIFY( to_string(0.1, chars_format::fixed, 3) == "0.100" );
+  VERIFY( to_string(2.5, chars_format::scientific, 2) == "2.50e+00" );
+  VERIFY( to_string(1.0 / 3, chars_format::general, 4) == "0.3333" );
+  VERIFY( to_string(1.0, chars_format::hex, 2) == "1.00p+0" );
+  VERIFY( to_string(0.5L, chars_format::fixed, 1) == "0.5" );
+}
+
+// Every representation reads back as the same value.
+template<typename T>
+  void
+  test03()
+  {
+    const int n = std::numeric_limits<T>::digits;
+    for (int i = 0; i < 5000; ++i)
+      {
+	T val = std::ldexp(T(1) + T(std::rand()) / RAND_MAX,
+			   std::rand() % (2 * n + 64) - n - 32);
+	if (i & 1)
+	  val = -val;
+	for (auto fmt : { std::chars_format::scientific,
+			  std::chars_format::fixed,
+			  std::chars_format::general,
+			  std::chars_format::hex })
+	  {
+	    const std::string s = to_string(val, fmt);
+	    T back;
+	    auto res = std::from_chars(s.data(), s.data() + s.size(), back, fmt);
+	    VERIFY( res.ec == std::errc{} );
+	    VERIFY( res.ptr == s.data() + s.size() );
+	    VERIFY( back == val );
+	  }
+      }
+  }
+
+void
+test04()
+{
+  char buf[8];
+  auto res = std::to_chars(buf, buf + 3, 0.125);
+  VERIFY( res.ec == std::errc::value_too_large );
+  VERIFY( res.ptr == buf + 3 );
+  res = std::to_chars(buf, buf + 5, 0.125);
+  VERIFY( res.ec == std::errc{} );
+  VERIFY( res.ptr == buf + 5 );
+  VERIFY( std::memcmp(buf, "0.125", 5) == 0 );
+  res = std::to_chars(buf, buf + 8, 1e300, std::chars_format::fixed, 2);
+  VERIFY( res.ec == std::errc::value_too_large );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03<float>();
+  test03<double>();
+  test03<long double>();
+  test04();
+}
@@ -0,0 +1,160 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do run }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <memory_resource>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <testsuite_hooks.h>
+
+struct counted_resource : std::pmr::memory_resource
+{
+  std::size_t allocs = 0;
+  std::size_t deallocs = 0;
+
+private:
+  void*
+  do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocs;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void
+  do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocs;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool
+  do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+bool
+aligned(void* p, std::size_t alignment)
+{ return reinterpret_cast<std::uintptr_t>(p) % alignment == 0; }
+
+// Options are adjusted to the implementation limits.
+void
+test01()
+{
+  std::pmr::unsynchronized_pool_resource r1;
+  VERIFY( r1.options().max_blocks_per_chunk != 0 );
+  VERIFY( r1.options().largest_required_pool_block != 0 );
+
+  std::pmr::pool_options opts;
+  opts.largest_required_pool_block = 100;
+  std::pmr::unsynchronized_pool_resource r2(opts);
+  VERIFY( r2.options().largest_required_pool_block >= 100 );
+}
+
+// Pooled and unpooled allocations of various sizes and alignments.
+void
+test02()
+{
+  counted_resource cr;
+  {
+    std::pmr::pool_options opts;
+    opts.largest_required_pool_block = 1024;
+    std::pmr::unsynchronized_pool_resource r(opts, &cr);
+    VERIFY( r.upstream_resource() == &cr );
+
+    std::vector<std::pair<void*, std::size_t>> blocks;
+    for (std::size_t n = 1; n <= 4096; n = n * 3 + 1)
+      for (std::size_t a = 1; a <= 256; a *= 2)
+	{
+	  void* p = r.allocate(n, a);
+	  VERIFY( aligned(p, a) );
+	  std::memset(p, 0xff, n);
+	  blocks.push_back({p, n});
+	}
+    // Blocks do not overlap.
+    for (auto& b : blocks)
+      std::memset(b.first, 0, b.second);
+    for (auto& b : blocks)
+      for (std::size_t i = 0; i < b.second; ++i)
+	VERIFY( static_cast<unsigned char*>(b.first)[i] == 0 );
+
+    std::size_t i = 0;
+    for (std::size_t n = 1; n <= 4096; n = n * 3 + 1)
+      for (std::size_t a = 1; a <= 256; a *= 2)
+	r.deallocate(blocks[i++].first, n, a);
+    // Large blocks are returned upstream immediately.
+    VERIFY( cr.deallocs > 0 );
+    VERIFY( cr.deallocs < cr.allocs );
+  }
+  VERIFY( cr.deallocs == cr.allocs );
+}
+
+// Freed blocks are reused and release() returns everything upstream.
+void
+test03()
+{
+  counted_resource cr;
+  std::pmr::unsynchronized_pool_resource r(&cr);
+  void* p = r.allocate(24);
+  r.deallocate(p, 24);
+  const std::size_t allocs = cr.allocs;
+  for (int i = 0; i < 1000; ++i)
+    {
+      void* q = r.allocate(24);
+      VERIFY( q == p );
+      r.deallocate(q, 24);
+    }
+  VERIFY( cr.allocs == allocs );
+
+  for (int i = 0; i < 10000; ++i)
+    r.allocate(i % 200 + 1);
+  r.allocate(100000);
+  r.release();
+  VERIFY( cr.deallocs == cr.allocs );
+
+  // The resource is still usable after release().
+  p = r.allocate(24);
+  r.deallocate(p, 24);
+}
+
+// Containers using the pool resource.
+void
+test04()
+{
+  std::pmr::unsynchronized_pool_resource r;
+  std::vector<std::vector<int, std::pmr::polymorphic_allocator<int>>> v;
+  for (int i = 0; i < 100; ++i)
+    {
+      v.emplace_back(&r);
+      for (int j = 0; j < i; ++j)
+	v.back().push_back(j);
+    }
+  for (int i = 0; i < 100; ++i)
+    for (int j = 0; j < i; ++j)
+      VERIFY( v[i][j] == j );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// 21.4.7.4 - 21.4.7.7 basic_string find_first_of and friends, with sets
+// of several chars, including chars with the high bit set.
+
+#include <string>
+#include <testsuite_hooks.h>
+
+// The results must not depend on whether the set is looked up char by
+// char or through a table.
+template<typename S>
+  void
+  check(const S& str, const S& set)
+  {
+    const auto npos = S::npos;
+    for (std::size_t pos = 0; pos <= str.size() + 1; ++pos)
+      {
+	std::size_t first = npos, first_not = npos;
+	for (std::size_t i = pos; i < str.size(); ++i)
+	  {
+	    bool in = set.find(str[i]) != npos;
+	    if (in && first == npos)
+	      first = i;
+	    if (!in && first_not == npos)
+	      first_not = i;
+	  }
+	VERIFY( str.find_first_of(set, pos) == first );
+	VERIFY( str.find_first_not_of(set, pos) == first_not );
+
+	std::size_t last = npos, last_not = npos;
+	if (!str.empty())
+	  for (std::size_t i = std::min(pos, str.size() - 1) + 1; i-- > 0; )
+	    {
+	      bool in = set.find(str[i]) != npos;
+	      if (in && last == npos)
+		last = i;
+	      if (!in && last_not == npos)
+		last_not = i;
+	    }
+	VERIFY( str.find_last_of(set, pos) == last );
+	VERIFY( str.find_last_not_of(set, pos) == last_not );
+      }
+  }
+
+void
+test01()
+{
+  const std::string str = "GET /index.html HTTP/1.1\r\nHost: a\xe9\xff\x80";
+  const char* sets[] = { "", " ", "\r\n", ":/", "\xff\x80", "aeiou\xe9",
+			 "GET /index.html HTTP/1.1\r\nHost: a" };
+  for (auto set : sets)
+    check(str, std::string(set));
+  check(std::string(), std::string("ab"));
+  check(str, std::string("x\0y", 3));
+  check(std::string("a\0b\0", 4), std::string("\0b", 2));
+}
+
+void
+test02()
+{
+  const std::string str = "abcabcabcab";
+  VERIFY( str.rfind("abc") == 6 );
+  VERIFY( str.rfind("abc", 5) == 3 );
+  VERIFY( str.rfind("cab", 100) == 8 );
+  VERIFY( str.rfind("abd") == std::string::npos );
+  VERIFY( str.rfind("", 4) == 4 );
+  VERIFY( str.rfind("", 100) == str.size() );
+  VERIFY( str.rfind(str) == 0 );
+}
+
+void
+test03()
+{
+  const std::u32string str = U"abc\U0001F600d\xfffe";
+  VERIFY( str.find(U'\U0001F600') == 3 );
+  VERIFY( str.find(U'\xfffe') == 5 );
+  VERIFY( str.find(U'z') == std::u32string::npos );
+  VERIFY( str.find(U"d") == 4 );
+  VERIFY( str.find_first_of(U"\U0001F600d") == 3 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,48 @@
+// { dg-options "-std=gnu++17" }
+// { dg-do compile }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <string>
+#include <regex>
+#include <memory_resource>
+
+#if _GLIBCXX_USE_CXX11_ABI
+
+template<typename T>
+  using alloc = std::pmr::polymorphic_allocator<T>;
+
+template<typename T, typename U>
+  constexpr bool same = std::is_same<T, U>::value;
+
+static_assert(same<std::pmr::string,
+		   std::basic_string<char, std::char_traits<char>,
+				     alloc<char>>>);
+static_assert(same<std::pmr::wstring,
+		   std::basic_string<wchar_t, std::char_traits<wchar_t>,
+				     alloc<wchar_t>>>);
+static_assert(same<std::pmr::smatch,
+		   std::match_results<std::pmr::string::const_iterator,
+				      alloc<std::sub_match<
+					std::pmr::string::const_iterator>>>>);
+static_assert(same<std::pmr::cmatch,
+		   std::match_results<const char*, alloc<std::csub_match>>>);
+
+// pmr strings are hashable.
+std::size_t h = std::hash<std::pmr::string>()(std::pmr::string("abc"));
+#endif
@@ -0,0 +1,62 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 22.2.2.1.1  num_get members
+
+#include <locale>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <testsuite_hooks.h>
+
+// Short decimal values are converted without the C library; the result
+// must be the correctly rounded value.
+void test01()
+{
+  using namespace std;
+
+  const char* strs[] = {
+    "0", "-0", "1", "0.1", "0.3", "-2.5", "123.456", "1e22", "1e23",
+    "9007199254740993", "9007199254740992", "4.35", "1234567890123456789",
+    "0.000001", "1e-22", "1e-23", "3.4028235e38", "1.17549435e-38",
+    "16777217", "0.1e1", "00012.50", "7e-10", "2.2250738585072014e-308"
+  };
+
+  for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i)
+    {
+      istringstream iss(strs[i]);
+      double d = 1.0;
+      iss >> d;
+      VERIFY( !iss.fail() );
+      const double dexp = std::strtod(strs[i], 0);
+      VERIFY( std::memcmp(&d, &dexp, sizeof(d)) == 0 );
+
+      iss.clear();
+      iss.str(strs[i]);
+      float f = 1.0f;
+      iss >> f;
+      const float fexp = std::strtof(strs[i], 0);
+      if (!iss.fail())
+	VERIFY( std::memcmp(&f, &fexp, sizeof(f)) == 0 );
+    }
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 22.2.2.2.1  num_put members
+
+#include <locale>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <testsuite_hooks.h>
+
+// Values with a short decimal representation are formatted without the C
+// library; the output must not change.
+void test01()
+{
+  using namespace std;
+
+  const double values[] = {
+    0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.5, 2.25, 10.0, 100.0, 123.456,
+    -123.456, 1e5, 1e6, 1e7, 1e15, 1e16, 1e-4, 1e-5, 0.001234, 99999.5,
+    999999.5, 3.14159, 2.718281828, 1e100, 1e-100, 12345678901234.0,
+    0.30000000000000004, 9.999999, 0.00009999
+  };
+  const ios_base::fmtflags fields[] = {
+    ios_base::fmtflags(), ios_base::fixed, ios_base::scientific
+  };
+  const ios_base::fmtflags others[] = {
+    ios_base::fmtflags(), ios_base::showpoint, ios_base::showpos,
+    ios_base::uppercase, ios_base::showpoint | ios_base::showpos
+  };
+
+  ostringstream oss;
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    for (size_t f = 0; f < 3; ++f)
+      for (size_t o = 0; o < 5; ++o)
+	for (int prec = 0; prec <= 18; ++prec)
+	  {
+	    const ios_base::fmtflags flags = fields[f] | others[o];
+	    oss.str("");
+	    oss.flags(flags);
+	    oss.precision(prec);
+	    oss << values[i];
+
+	    char fmt[8];
+	    char* p = fmt;
+	    *p++ = '%';
+	    if (flags & ios_base::showpos)
+	      *p++ = '+';
+	    if (flags & ios_base::showpoint)
+	      *p++ = '#';
+	    *p++ = '.';
+	    *p++ = '*';
+	    const bool upper = flags & ios_base::uppercase;
+	    if (fields[f] == ios_base::fixed)
+	      *p++ = 'f';
+	    else if (fields[f] == ios_base::scientific)
+	      *p++ = upper ? 'E' : 'e';
+	    else
+	      *p++ = upper ? 'G' : 'g';
+	    *p = '\0';
+
+	    char expected[512];
+	    std::sprintf(expected, fmt, prec, values[i]);
+	    VERIFY( oss.str() == expected );
+	  }
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
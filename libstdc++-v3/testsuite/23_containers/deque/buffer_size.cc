@@ -0,0 +1,78 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <deque>
+#include <testsuite_hooks.h>
+
+struct Big
+{
+  char data[1000];
+  int value;
+};
+
+struct Small
+{
+  int value;
+};
+
+namespace __gnu_cxx
+{
+  template<>
+    struct deque_buffer_size<Big>
+    { static const std::size_t value = 8; };
+
+  template<>
+    struct deque_buffer_size<Small>
+    { static const std::size_t value = 5; };
+}
+
+template<typename T>
+void
+check(std::size_t node_size)
+{
+  std::deque<T> d;
+  for (int i = 0; i < 100; ++i)
+    {
+      T t;
+      t.value = i;
+      if (i % 2)
+	d.push_back(t);
+      else
+	d.push_front(t);
+    }
+
+  VERIFY( std::size_t(d.begin()._M_last - d.begin()._M_first) == node_size );
+  for (int i = 0; i < 100; ++i)
+    VERIFY( d[i].value == (i < 50 ? 98 - 2 * i : 2 * i - 99) );
+
+  d.erase(d.begin() + 10, d.begin() + 90);
+  VERIFY( d.size() == 20 );
+  VERIFY( d[9].value == 80 && d[10].value == 81 );
+}
+
+void test01()
+{
+  check<Big>(8);
+  check<Small>(5);
+  VERIFY( __gnu_cxx::deque_buffer_size<int>::value == 512 / sizeof(int) );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#define _GLIBCXX_HASHTABLE_RECYCLE_NODES 1
+
+#include <unordered_map>
+#include <string>
+#include <testsuite_hooks.h>
+#include <testsuite_allocator.h>
+
+using __gnu_test::tracker_allocator;
+using __gnu_test::tracker_allocator_counter;
+using __gnu_test::propagating_allocator;
+
+// The nodes released by clear() are reused by the following insertions.
+void test01()
+{
+  typedef tracker_allocator<std::pair<const int, std::string>> alloc_type;
+  typedef std::unordered_map<int, std::string, std::hash<int>,
+			     std::equal_to<int>, alloc_type> test_type;
+
+  tracker_allocator_counter::reset();
+  {
+    test_type m;
+    for (int i = 0; i < 100; ++i)
+      m.emplace(i, std::string(30, 'a' + i % 26));
+    const auto allocs = tracker_allocator_counter::get_allocation_count();
+
+    for (int round = 0; round < 3; ++round)
+      {
+	m.clear();
+	VERIFY( m.empty() );
+	for (int i = 0; i < 100; ++i)
+	  m[i + round] = "x";
+	VERIFY( m.size() == 100 );
+	VERIFY( m[round] == "x" );
+	VERIFY( m.count(round + 99) == 1 );
+      }
+    VERIFY( tracker_allocator_counter::get_allocation_count() == allocs );
+
+    m.clear();
+    m.insert({ { 1, "one" }, { 2, "two" } });
+    VERIFY( m.size() == 2 );
+    VERIFY( m.at(2) == "two" );
+  }
+  VERIFY( tracker_allocator_counter::get_allocation_count()
+	  == tracker_allocator_counter::get_deallocation_count() );
+  VERIFY( tracker_allocator_counter::get_construct_count()
+	  == tracker_allocator_counter::get_destruct_count() );
+}
+
+// Spare nodes are released with the allocator that allocated them.
+template<bool Propagate>
+void test02()
+{
+  typedef propagating_allocator<std::pair<const int, int>, Propagate>
+    alloc_type;
+  typedef std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+			     alloc_type> test_type;
+
+  test_type m1(alloc_type(1));
+  test_type m2(alloc_type(2));
+  for (int i = 0; i < 10; ++i)
+    {
+      m1[i] = i;
+      m2[i] = i;
+    }
+  m1.clear();
+  m2.clear();
+  m2[5] = 5;
+
+  test_type m3(alloc_type(3));
+  m3 = m2;
+  VERIFY( m3.size() == 1 );
+  m3.clear();
+  m3 = std::move(m1);
+  VERIFY( m3.empty() );
+  m3[1] = 1;
+
+  test_type m4(std::move(m2));
+  VERIFY( m4.size() == 1 );
+  m4.clear();
+  m4[2] = 2;
+  m2[3] = 3;
+  VERIFY( m2.size() == 1 );
+}
+
+void test03()
+{
+  typedef propagating_allocator<std::pair<const int, int>, true> alloc_type;
+  typedef std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+			     alloc_type> test_type;
+
+  test_type m1(alloc_type(1));
+  test_type m2(alloc_type(2));
+  for (int i = 0; i < 10; ++i)
+    m1[i] = i;
+  m1.clear();
+  m2[0] = 0;
+  std::swap(m1, m2);
+  VERIFY( m1.size() == 1 );
+  VERIFY( m2.empty() );
+  for (int i = 0; i < 10; ++i)
+    {
+      m1[i] = i;
+      m2[i] = i;
+    }
+  m1.rehash(0);
+  VERIFY( m1.size() == 10 );
+}
+
+int main()
+{
+  test01();
+  test02<false>();
+  test02<true>();
+  test03();
+}
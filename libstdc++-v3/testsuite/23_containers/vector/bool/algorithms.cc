@@ -0,0 +1,123 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// count, find, copy and equal on vector<bool> iterators work a word at
+// a time.  Check them against bit by bit loops for all alignments.
+
+#include <algorithm>
+#include <vector>
+#include <testsuite_hooks.h>
+
+typedef std::vector<bool>::iterator iter;
+typedef std::vector<bool>::const_iterator citer;
+
+unsigned long seed = 1;
+
+bool
+random_bit(int density)
+{
+  seed = (seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+  return (seed >> 16) % 4 < (unsigned long) density;
+}
+
+void
+check(const std::vector<bool>& v, int a, int b)
+{
+  const citer first = v.begin() + a, last = v.begin() + b;
+
+  std::ptrdiff_t ones = 0;
+  citer first_one = last, first_zero = last;
+  for (citer i = first; i != last; ++i)
+    {
+      if (*i)
+	{
+	  ++ones;
+	  if (first_one == last)
+	    first_one = i;
+	}
+      else if (first_zero == last)
+	first_zero = i;
+    }
+
+  VERIFY( std::count(first, last, true) == ones );
+  VERIFY( std::count(first, last, false) == (b - a) - ones );
+  VERIFY( std::find(first, last, true) == first_one );
+  VERIFY( std::find(first, last, false) == first_zero );
+
+  std::vector<bool>& mv = const_cast<std::vector<bool>&>(v);
+  VERIFY( std::count(mv.begin() + a, mv.begin() + b, true) == ones );
+  VERIFY( std::find(mv.begin() + a, mv.begin() + b, false)
+	  == mv.begin() + (first_zero - v.begin()) );
+
+  for (int c = 0; c + (b - a) <= int(v.size()); c += 7)
+    {
+      std::vector<bool> dst(v.size(), c % 2);
+      std::vector<bool> ref(dst);
+      iter r = std::copy(first, last, dst.begin() + c);
+      VERIFY( r == dst.begin() + c + (b - a) );
+      for (int i = 0; i < b - a; ++i)
+	ref[c + i] = v[a + i];
+      VERIFY( dst == ref );
+      VERIFY( std::equal(first, last, dst.begin() + c) );
+      if (b > a)
+	{
+	  dst[c + (b - a) / 2].flip();
+	  VERIFY( !std::equal(first, last, dst.begin() + c) );
+	  VERIFY( !(dst == ref) );
+	}
+    }
+}
+
+void
+test01()
+{
+  for (int n = 0; n < 300; n += 13)
+    for (int density = 0; density <= 4; ++density)
+      {
+	std::vector<bool> v(n);
+	for (int i = 0; i < n; ++i)
+	  v[i] = random_bit(density);
+	for (int a = 0; a <= n; a += 5)
+	  for (int b = a; b <= n; b += 11)
+	    check(v, a, b);
+      }
+}
+
+void
+test02()
+{
+  // Overlapping copy towards the front, as done by erase.
+  std::vector<bool> v(500);
+  for (int i = 0; i < 500; ++i)
+    v[i] = random_bit(2);
+  std::vector<bool> ref(v);
+  std::copy(v.begin() + 70, v.end(), v.begin() + 3);
+  for (int i = 70; i < 500; ++i)
+    ref[i - 67] = bool(ref[i]);
+  VERIFY( v == ref );
+
+  ref.erase(ref.begin() + 5, ref.begin() + 133);
+  v.erase(v.begin() + 5, v.begin() + 133);
+  VERIFY( v == ref );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
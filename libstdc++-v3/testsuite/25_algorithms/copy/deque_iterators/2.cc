@@ -0,0 +1,92 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <vector>
+#include <testsuite_hooks.h>
+
+// Copying into and out of deques from other kinds of ranges.
+void test01()
+{
+  using namespace std;
+
+  deque<long> d;
+  for (long i = 0; i < 500; ++i)
+    d.push_back(i);
+  const deque<long>& cd = d;
+
+  for (unsigned i = 0; i < d.size(); i += 7)
+    for (unsigned j = i; j <= d.size(); j += 13)
+      {
+	vector<long> v(d.size(), -1);
+	vector<long>::iterator r = copy(cd.begin() + i, cd.begin() + j,
+					v.begin() + 3);
+	VERIFY( r == v.begin() + 3 + (j - i) );
+	for (unsigned k = 0; k < v.size(); ++k)
+	  VERIFY( v[k] == (k >= 3 && k < 3 + (j - i) ? long(i + k - 3) : -1) );
+
+	deque<long> d2(d.size() + 3, -1);
+	deque<long>::iterator r2 = copy(v.begin() + 3, v.begin() + 3 + (j - i),
+					d2.begin() + i);
+	VERIFY( r2 == d2.begin() + j );
+	for (unsigned k = 0; k < d2.size(); ++k)
+	  VERIFY( d2[k] == (k >= i && k < j ? long(k) : -1) );
+      }
+}
+
+void test02()
+{
+  using namespace std;
+
+  list<int> l;
+  for (int i = 0; i < 700; ++i)
+    l.push_back(i);
+
+  deque<int> d(800, -1);
+  VERIFY( copy(l.begin(), l.end(), d.begin() + 50) == d.begin() + 750 );
+  for (int i = 0; i < 800; ++i)
+    VERIFY( d[i] == (i >= 50 && i < 750 ? i - 50 : -1) );
+
+  list<int> l2;
+  copy(d.begin() + 50, d.begin() + 750, back_inserter(l2));
+  VERIFY( l2 == l );
+}
+
+void test03()
+{
+  using namespace std;
+
+  // Between deques of different element types.
+  deque<int> d;
+  for (int i = 0; i < 600; ++i)
+    d.push_back(i);
+
+  deque<double> d2(700, -1.0);
+  VERIFY( copy(d.begin() + 5, d.end(), d2.begin() + 17) == d2.begin() + 612 );
+  for (int i = 0; i < 700; ++i)
+    VERIFY( d2[i] == (i >= 17 && i < 612 ? double(i - 12) : -1.0) );
+}
+
+int main()
+{
+  test01();
+  test02();
+  test03();
+  return 0;
+}
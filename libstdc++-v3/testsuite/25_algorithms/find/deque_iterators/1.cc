@@ -0,0 +1,64 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <deque>
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+
+  deque<int> d;
+  for (int i = 0; i < 1000; ++i)
+    d.push_back(i);
+  const deque<int>& cd = d;
+
+  for (int i = 0; i < 1000; i += 7)
+    for (int j = i; j <= 1000; j += 11)
+      {
+	deque<int>::iterator f = d.begin() + i, l = d.begin() + j;
+	for (int k = i; k < j; k += 13)
+	  {
+	    VERIFY( find(f, l, k) == d.begin() + k );
+	    VERIFY( find(cd.begin() + i, cd.begin() + j, k) == cd.begin() + k );
+	  }
+	VERIFY( find(f, l, j) == l );
+	VERIFY( find(f, l, -1) == l );
+	VERIFY( find(cd.begin() + i, cd.begin() + j, -1) == cd.begin() + j );
+      }
+}
+
+void test02()
+{
+  using namespace std;
+
+  // Elements past the front node after push_front.
+  deque<long> d(300, 0);
+  for (int i = 0; i < 300; ++i)
+    d.push_front(i + 1);
+  VERIFY( find(d.begin(), d.end(), 1L) == d.begin() + 299 );
+  VERIFY( find(d.begin(), d.end(), 0L) == d.begin() + 300 );
+  VERIFY( find(d.begin() + 301, d.end(), 1L) == d.end() );
+}
+
+int main()
+{
+  test01();
+  test02();
+  return 0;
+}
@@ -0,0 +1,61 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <deque>
+#include <testsuite_hooks.h>
+
+struct Sum
+{
+  Sum() : total(0), count(0) { }
+  void operator()(long x) { total += x; ++count; }
+  long total;
+  long count;
+};
+
+struct Increment
+{
+  void operator()(long& x) const { ++x; }
+};
+
+void test01()
+{
+  using namespace std;
+
+  deque<long> d;
+  for (long i = 0; i < 1000; ++i)
+    d.push_back(i);
+  const deque<long>& cd = d;
+
+  for (long i = 0; i < 1000; i += 9)
+    for (long j = i; j <= 1000; j += 17)
+      {
+	Sum s = for_each(cd.begin() + i, cd.begin() + j, Sum());
+	VERIFY( s.count == j - i );
+	VERIFY( s.total == (j * (j - 1) - i * (i - 1)) / 2 );
+      }
+
+  for_each(d.begin() + 10, d.end() - 10, Increment());
+  for (long i = 0; i < 1000; ++i)
+    VERIFY( d[i] == (i < 10 || i >= 990 ? i : i + 1) );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
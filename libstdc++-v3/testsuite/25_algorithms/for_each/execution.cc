@@ -0,0 +1,94 @@
+// { dg-do run { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-rtems* *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17 -pthread" { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17" { target *-*-cygwin *-*-rtems* *-*-darwin* } }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <execution>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <vector>
+#include <list>
+#include <testsuite_hooks.h>
+
+void
+test01(const std::vector<int>& v)
+{
+  std::atomic<long> sum{0};
+  std::for_each(std::execution::par, v.begin(), v.end(),
+		[&sum](int i) { sum += i; });
+  VERIFY( sum == long(v.size()) * (long(v.size()) - 1) / 2 );
+
+  std::vector<int> w(v);
+  std::for_each(std::execution::par_unseq, w.begin(), w.end(),
+		[](int& i) { i *= 2; });
+  for (std::size_t i = 0; i < w.size(); ++i)
+    VERIFY( w[i] == 2 * v[i] );
+
+  auto it = std::for_each_n(std::execution::par, w.begin(), 10,
+			    [](int& i) { i = -1; });
+  VERIFY( it == w.begin() + 10 );
+  VERIFY( w[9] == -1 && w[10] == 20 );
+}
+
+void
+test02()
+{
+  // Forward iterators run sequentially.
+  std::list<int> l(100, 1);
+  int sum = 0;
+  std::for_each(std::execution::par, l.begin(), l.end(),
+		[&sum](int i) { sum += i; });
+  VERIFY( sum == 100 );
+  auto it = std::for_each_n(std::execution::seq, l.begin(), 5,
+			    [](int& i) { i = 0; });
+  VERIFY( std::distance(l.begin(), it) == 5 );
+}
+
+void
+test03()
+{
+  // Parallel algorithms called from inside parallel algorithms.
+  std::vector<std::vector<int>> vv(16, std::vector<int>(3000));
+  std::for_each(std::execution::par, vv.begin(), vv.end(),
+		[](std::vector<int>& v) {
+		  std::for_each(std::execution::par, v.begin(), v.end(),
+				[](int& i) { i = 1; });
+		});
+  for (auto& v : vv)
+    VERIFY( std::count(v.begin(), v.end(), 1) == 3000 );
+}
+
+int
+main()
+{
+  std::vector<int> v(100000);
+  std::iota(v.begin(), v.end(), 0);
+
+  test01(v);
+  test02();
+  test03();
+
+  __gnu_parallel::thread_pool pool(4);
+  __gnu_parallel::set_execution_backend(&pool);
+  test01(v);
+  test03();
+  __gnu_parallel::set_execution_backend(nullptr);
+}
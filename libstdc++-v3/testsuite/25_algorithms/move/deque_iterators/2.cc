@@ -0,0 +1,65 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <testsuite_hooks.h>
+
+// Moving into and out of deques from other kinds of ranges.
+void test01()
+{
+  using namespace std;
+
+  vector<unique_ptr<int>> v;
+  for (int i = 0; i < 500; ++i)
+    v.emplace_back(new int(i));
+
+  deque<unique_ptr<int>> d(600);
+  VERIFY( move(v.begin(), v.end(), d.begin() + 20) == d.begin() + 520 );
+  for (int i = 0; i < 500; ++i)
+    {
+      VERIFY( !v[i] );
+      VERIFY( *d[i + 20] == i );
+    }
+
+  VERIFY( move(d.begin() + 20, d.begin() + 520, v.begin()) == v.end() );
+  for (int i = 0; i < 500; ++i)
+    {
+      VERIFY( *v[i] == i );
+      VERIFY( !d[i + 20] );
+    }
+
+  deque<shared_ptr<int>> d2(500);
+  for (int i = 0; i < 500; ++i)
+    d[i].reset(new int(i));
+  move(d.begin(), d.begin() + 500, d2.begin());
+  for (int i = 0; i < 500; ++i)
+    {
+      VERIFY( !d[i] );
+      VERIFY( *d2[i] == i );
+    }
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,81 @@
+// { dg-do run { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-rtems* *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17 -pthread" { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17" { target *-*-cygwin *-*-rtems* *-*-darwin* } }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <execution>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+#include <testsuite_hooks.h>
+
+template<typename Policy>
+  void
+  test01(Policy&& exec)
+  {
+    std::mt19937 g;
+    std::vector<unsigned> v(100001);
+    for (auto& i : v)
+      i = g();
+
+    std::sort(exec, v.begin(), v.end());
+    VERIFY( std::is_sorted(v.begin(), v.end()) );
+    std::sort(exec, v.begin(), v.end(), std::greater<unsigned>());
+    VERIFY( std::is_sorted(v.begin(), v.end(), std::greater<unsigned>()) );
+  }
+
+template<typename Policy>
+  void
+  test02(Policy&& exec)
+  {
+    typedef std::pair<int, int> P;
+    std::mt19937 g;
+    std::vector<P> v(50000);
+    for (std::size_t i = 0; i < v.size(); ++i)
+      v[i] = P(g() % 100, i);
+
+    std::stable_sort(exec, v.begin(), v.end(),
+		     [](const P& l, const P& r) { return l.first < r.first; });
+    for (std::size_t i = 1; i < v.size(); ++i)
+      VERIFY( v[i - 1].first < v[i].first
+	      || (v[i - 1].first == v[i].first
+		  && v[i - 1].second < v[i].second) );
+  }
+
+int
+main()
+{
+  test01(std::execution::seq);
+  test01(std::execution::par);
+  test02(std::execution::par);
+
+  for (unsigned n : { 2, 3, 8 })
+    {
+      __gnu_parallel::thread_pool pool(n);
+      __gnu_parallel::set_execution_backend(&pool);
+      test01(std::execution::par);
+      test01(std::execution::par_unseq);
+      test02(std::execution::par);
+      test02(std::execution::par_unseq);
+      __gnu_parallel::set_execution_backend(nullptr);
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// 25.4.1.1 sort() on inputs with patterns: runs, duplicates and
+// sequences which defeat median-of-three pivots.  Arithmetic types
+// compared with operator< take the block partition path.
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include <testsuite_hooks.h>
+
+std::vector<int>
+make(int n, int pattern)
+{
+  std::vector<int> v(n);
+  unsigned r = 1;
+  for (int i = 0; i < n; ++i)
+    {
+      r = r * 1103515245 + 12345;
+      switch (pattern)
+	{
+	case 0: v[i] = r >> 8; break;
+	case 1: v[i] = i; break;
+	case 2: v[i] = -i; break;
+	case 3: v[i] = (r >> 8) % 4; break;
+	case 4: v[i] = 7; break;
+	case 5: v[i] = i < n / 2 ? i : n - i; break;
+	case 6: v[i] = i % 100 ? i : int(r >> 8); break;
+	case 7: v[i] = i % 2 ? i : -i; break;
+	}
+    }
+  return v;
+}
+
+template<typename T, typename Compare>
+  void
+  check(std::vector<T> v, Compare comp)
+  {
+    std::vector<T> w = v;
+    std::stable_sort(w.begin(), w.end(), comp);
+    std::sort(v.begin(), v.end(), comp);
+    for (std::size_t i = 0; i < v.size(); ++i)
+      VERIFY( !comp(v[i], w[i]) && !comp(w[i], v[i]) );
+  }
+
+void
+test01()
+{
+  const int sizes[] = { 0, 1, 2, 23, 24, 25, 128, 129, 1000, 30000 };
+  for (int n : sizes)
+    for (int p = 0; p < 8; ++p)
+      {
+	std::vector<int> v = make(n, p);
+	check(v, std::less<int>());
+	check(v, std::greater<int>());
+	check(v, [](int a, int b) { return (a & 0xff) < (b & 0xff); });
+
+	std::vector<double> d(v.begin(), v.end());
+	std::vector<double> e = d;
+	std::sort(d.begin(), d.end());
+	std::stable_sort(e.begin(), e.end());
+	VERIFY( d == e );
+
+	std::vector<std::string> s;
+	for (int i : v)
+	  s.push_back(std::to_string(i));
+	check(s, std::less<std::string>());
+      }
+}
+
+int
+main()
+{
+  test01();
+}
@@ -0,0 +1,74 @@
+// { dg-do run { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-rtems* *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17 -pthread" { target *-*-freebsd* *-*-dragonfly* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* powerpc-ibm-aix* } }
+// { dg-options "-std=gnu++17" { target *-*-cygwin *-*-rtems* *-*-darwin* } }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <execution>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <list>
+#include <testsuite_hooks.h>
+
+template<typename Policy>
+  void
+  test01(Policy&& exec)
+  {
+    std::vector<int> v(100000), w(v.size()), x(v.size());
+    std::iota(v.begin(), v.end(), 0);
+
+    auto it = std::transform(exec, v.begin(), v.end(), w.begin(),
+			     [](int i) { return i + 1; });
+    VERIFY( it == w.end() );
+    for (std::size_t i = 0; i < v.size(); ++i)
+      VERIFY( w[i] == v[i] + 1 );
+
+    it = std::transform(exec, v.begin(), v.end(), w.begin(), x.begin(),
+			std::plus<>());
+    VERIFY( it == x.end() );
+    for (std::size_t i = 0; i < v.size(); ++i)
+      VERIFY( x[i] == 2 * v[i] + 1 );
+  }
+
+void
+test02()
+{
+  std::list<int> l(10, 2);
+  std::vector<int> v(10);
+  auto it = std::transform(std::execution::par, l.begin(), l.end(),
+			   v.begin(), [](int i) { return i * i; });
+  VERIFY( it == v.end() );
+  VERIFY( std::count(v.begin(), v.end(), 4) == 10 );
+}
+
+int
+main()
+{
+  test01(std::execution::seq);
+  test01(std::execution::par);
+  test01(std::execution::par_unseq);
+  test02();
+
+  __gnu_parallel::thread_pool pool(3);
+  __gnu_parallel::set_execution_backend(&pool);
+  test01(std::execution::par);
+  test01(std::execution::par_unseq);
+  __gnu_parallel::set_execution_backend(nullptr);
+}
@@ -0,0 +1,88 @@
+// { dg-do run { target c++11 } }
+// { dg-require-cstdint "" }
+//
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 26.5.3.2 Class template mersenne_twister_engine [rand.eng.mers]
+
+// The state may be regenerated several words at a time.  Compare with
+// the definition in [rand.eng.mers], including for parameters where
+// n - m is too small for that.
+
+#include <random>
+#include <sstream>
+#include <vector>
+#include <testsuite_hooks.h>
+
+template<typename Engine>
+  void
+  check(unsigned long seed)
+  {
+    typedef typename Engine::result_type UIntType;
+    const std::size_t w = Engine::word_size, n = Engine::state_size;
+    const std::size_t m = Engine::shift_size, r = Engine::mask_bits;
+    const UIntType wmask = w == std::numeric_limits<UIntType>::digits
+      ? ~UIntType() : (UIntType(1) << w) - 1;
+    const UIntType upper = (~UIntType() << r) & wmask;
+    const UIntType lower = ~upper & wmask;
+
+    Engine e(seed);
+    std::vector<UIntType> x(n);
+    // Read the seeded state through operator<<.
+    std::stringstream ss;
+    ss << e;
+    for (std::size_t i = 0; i < n; ++i)
+      ss >> x[i];
+
+    for (std::size_t i = 0; i < 5 * n + 3; ++i)
+      {
+	const std::size_t k = i % n;
+	UIntType y = (x[k] & upper) | (x[(k + 1) % n] & lower);
+	x[k] = x[(k + m) % n] ^ (y >> 1) ^ ((y & 1) ? Engine::xor_mask : 0);
+	UIntType z = x[k];
+	z ^= (z >> Engine::tempering_u) & Engine::tempering_d;
+	z ^= (z << Engine::tempering_s) & Engine::tempering_b;
+	z ^= (z << Engine::tempering_t) & Engine::tempering_c;
+	z ^= z >> Engine::tempering_l;
+	VERIFY( e() == (z & wmask) );
+      }
+  }
+
+typedef std::mersenne_twister_engine<
+  std::uint_fast32_t, 32, 9, 7, 31, 0x9908b0dfUL, 11, 0xffffffffUL, 7,
+  0x9d2c5680UL, 15, 0xefc60000UL, 18, 1812433253UL> small_gap;
+
+typedef std::mersenne_twister_engine<
+  std::uint32_t, 32, 17, 3, 13, 0x9908b0dfUL, 11, 0xffffffffUL, 7,
+  0x9d2c5680UL, 15, 0xefc60000UL, 18, 1812433253UL> small_shift;
+
+void
+test01()
+{
+  check<std::mt19937>(1);
+  check<std::mt19937>(5489u);
+  check<std::mt19937_64>(7);
+  check<small_gap>(3);
+  check<small_shift>(3);
+}
+
+int
+main()
+{
+  test01();
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 27.8.1.4 Overridden virtual functions
+
+// { dg-require-fileio "" }
+
+#include <fstream>
+#include <testsuite_hooks.h>
+
+// setbuf(0, n) before open selects the size of the internal buffer.
+// Large direct reads also refill it, so the chars after them must be
+// available from the buffer.
+void test01()
+{
+  using namespace std;
+
+  const char* name = "tmp_setbuf4";
+  const int size = 100000;
+  {
+    filebuf out;
+    out.open(name, ios_base::out);
+    for (int i = 0; i < size; ++i)
+      out.sputc(char('a' + i % 23));
+  }
+
+  static char s[size];
+  filebuf fbuf;
+  VERIFY( fbuf.pubsetbuf(0, 65536) == &fbuf );
+  VERIFY( fbuf.open(name, ios_base::in) );
+
+  VERIFY( fbuf.sgetn(s, 10) == 10 );
+  VERIFY( fbuf.in_avail() > 10000 );
+  VERIFY( fbuf.sgetn(s + 10, 70000) == 70000 );
+  VERIFY( fbuf.pubseekoff(0, ios_base::cur) == streampos(70010) );
+  VERIFY( fbuf.sgetc() == char('a' + 70010 % 23) );
+  VERIFY( fbuf.sgetn(s + 70010, size) == size - 70010 );
+  VERIFY( fbuf.sgetc() == filebuf::traits_type::eof() );
+  for (int i = 0; i < size; ++i)
+    VERIFY( s[i] == char('a' + i % 23) );
+
+  VERIFY( fbuf.pubseekpos(12345) == streampos(12345) );
+  VERIFY( fbuf.sgetc() == char('a' + 12345 % 23) );
+  fbuf.close();
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,116 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// char regexes without back-references or assertions are prefiltered by
+// a DFA.  Check that they give the same results as wchar_t regexes, which
+// only use the executors.
+
+#include <regex>
+#include <string>
+#include <testsuite_hooks.h>
+
+using namespace std;
+
+wstring
+widen(const string& s)
+{ return wstring(s.begin(), s.end()); }
+
+void
+check(const char* pattern, regex_constants::syntax_option_type f,
+      const string& s)
+{
+  regex re(pattern, f);
+  wregex wre(widen(pattern), f);
+  const wstring ws = widen(s);
+
+  smatch m;
+  wsmatch wm;
+  VERIFY( regex_match(s, m, re) == regex_match(ws, wm, wre) );
+  if (m.ready() && !m.empty())
+    for (size_t i = 0; i < m.size(); ++i)
+      {
+	VERIFY( m[i].matched == wm[i].matched );
+	VERIFY( m.position(i) == wm.position(i) );
+	VERIFY( m.length(i) == wm.length(i) );
+      }
+
+  bool found = regex_search(s, m, re);
+  VERIFY( found == regex_search(ws, wm, wre) );
+  if (found)
+    {
+      VERIFY( m.size() == wm.size() );
+      for (size_t i = 0; i < m.size(); ++i)
+	{
+	  VERIFY( m[i].matched == wm[i].matched );
+	  VERIFY( m.position(i) == wm.position(i) );
+	  VERIFY( m.length(i) == wm.length(i) );
+	}
+      VERIFY( m.prefix().length() == wm.prefix().length() );
+      VERIFY( m.suffix().length() == wm.suffix().length() );
+    }
+
+  auto flags = regex_constants::match_continuous;
+  VERIFY( regex_search(s, m, re, flags) == regex_search(ws, wm, wre, flags) );
+
+  sregex_iterator it(s.begin(), s.end(), re), end;
+  wsregex_iterator wit(ws.begin(), ws.end(), wre), wend;
+  for (; it != end && wit != wend; ++it, ++wit)
+    {
+      VERIFY( it->position() == wit->position() );
+      VERIFY( it->length() == wit->length() );
+    }
+  VERIFY( it == end && wit == wend );
+}
+
+void
+test01()
+{
+  const char* patterns[] = {
+    "abc", "a|b|c", "ab*c", "a.c", "(a|ab)(c|bcd)(d*)", "[a-c]+x",
+    "x*", "(x?)*y", "a{2,3}", "(ab|a)(bc|c)?", "[^ ]+ [0-9]{3}",
+    "GET|POST", "(\\w+)@(\\w+)\\.com", "z", "", "(a*)(b*)c?",
+    "\\d+\\.\\d+", ".*err.*", "[[:alpha:]]+[[:digit:]]*", "(a+?)(a*)"
+  };
+  const char* inputs[] = {
+    "", "abc", "xxabcxx", "abbbbc", "acb", "abcd", "aabcd", "xay",
+    "zzzzzz", "aaaa", "GET /index.html 200", "user@example.com ok",
+    "12.5 and 3.75", "some error here", "abc123def", "no match at all",
+    "ab\nc", "yyxy"
+  };
+  for (auto p : patterns)
+    for (auto i : inputs)
+      {
+	check(p, regex_constants::ECMAScript, i);
+	check(p, regex_constants::ECMAScript | regex_constants::icase, i);
+      }
+
+  const char* posix_patterns[] = {
+    "abc", "a|ab|abc", "(a|ab)(c|bcd)(d*)", "[a-c]+", "x*", "a.c",
+    "(ab|a)(bc|c)?"
+  };
+  for (auto p : posix_patterns)
+    for (auto i : inputs)
+      check(p, regex_constants::extended, i);
+}
+
+int
+main()
+{
+  test01();
+}
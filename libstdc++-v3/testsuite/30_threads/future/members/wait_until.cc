@@ -47,8 +47,29 @@ void test01()
   VERIFY( std::chrono::system_clock::now() < when );
 }
 
+// Timeouts on the steady clock are waited for on that clock.
+void test02()
+{
+  std::promise<int> p1;
+  std::future<int> f1(p1.get_future());
+
+  auto when = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+  VERIFY( f1.wait_until(when) == std::future_status::timeout );
+  VERIFY( std::chrono::steady_clock::now() >= when );
+
+  when = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+  VERIFY( f1.wait_until(when) == std::future_status::timeout );
+
+  p1.set_value(1);
+
+  when = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  VERIFY( f1.wait_until(when) == std::future_status::ready );
+  VERIFY( std::chrono::steady_clock::now() < when );
+}
+
 int main()
 {
   test01();
+  test02();
   return 0;
 }
@@ -0,0 +1,172 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/flat_hash_map>
+#include <string>
+#include <unordered_map>
+#include <random>
+#include <stdexcept>
+#include <testsuite_hooks.h>
+
+using __gnu_cxx::flat_hash_map;
+
+void
+test01()
+{
+  flat_hash_map<int, int> m;
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+  VERIFY( m.find(1) == m.end() );
+  VERIFY( m.erase(1) == 0 );
+
+  for (int i = 0; i < 1000; ++i)
+    VERIFY( m.emplace(i, i * 2).second );
+  VERIFY( m.size() == 1000 );
+  VERIFY( !m.emplace(5, 0).second );
+  VERIFY( m.load_factor() <= m.max_load_factor() );
+
+  for (int i = 0; i < 1000; ++i)
+    {
+      auto it = m.find(i);
+      VERIFY( it != m.end() && it->first == i && it->second == i * 2 );
+    }
+  VERIFY( m.count(1000) == 0 );
+
+  int n = 0;
+  for (auto& v : m)
+    {
+      VERIFY( v.second == v.first * 2 );
+      ++n;
+    }
+  VERIFY( n == 1000 );
+
+  for (int i = 0; i < 1000; i += 2)
+    VERIFY( m.erase(i) == 1 );
+  VERIFY( m.size() == 500 );
+  for (int i = 0; i < 1000; ++i)
+    VERIFY( m.count(i) == std::size_t(i % 2) );
+
+  m[2000] = 1;
+  VERIFY( m.at(2000) == 1 );
+  bool caught = false;
+  try
+    {
+      m.at(2001);
+    }
+  catch (const std::out_of_range&)
+    {
+      caught = true;
+    }
+  VERIFY( caught );
+}
+
+void
+test02()
+{
+  // Compare with std::unordered_map under random operations, which
+  // leaves tombstones all over the table.
+  flat_hash_map<unsigned, unsigned> m;
+  std::unordered_map<unsigned, unsigned> u;
+  std::mt19937 g;
+  for (int i = 0; i < 200000; ++i)
+    {
+      unsigned k = g() % 5000;
+      switch (g() % 3)
+	{
+	case 0:
+	  VERIFY( m.insert({k, i}).second == u.insert({k, i}).second );
+	  break;
+	case 1:
+	  VERIFY( m.erase(k) == u.erase(k) );
+	  break;
+	case 2:
+	  VERIFY( m.count(k) == u.count(k) );
+	  break;
+	}
+    }
+  VERIFY( m.size() == u.size() );
+  for (auto& v : u)
+    VERIFY( m.at(v.first) == v.second );
+
+  // Erase while iterating.
+  for (auto it = m.begin(); it != m.end();)
+    if (it->first % 3)
+      it = m.erase(it);
+    else
+      ++it;
+  for (auto& v : m)
+    VERIFY( v.first % 3 == 0 );
+}
+
+void
+test03()
+{
+  flat_hash_map<std::string, std::string> m = { { "a", "1" }, { "b", "2" } };
+  auto r = m.try_emplace("c", 3, 'x');
+  VERIFY( r.second && r.first->second == "xxx" );
+  r = m.try_emplace("c", "y");
+  VERIFY( !r.second && r.first->second == "xxx" );
+  r = m.insert_or_assign("c", "z");
+  VERIFY( !r.second && m["c"] == "z" );
+
+  for (int i = 0; i < 100; ++i)
+    m[std::to_string(i)] = std::string(50, 'a' + i % 26);
+
+  flat_hash_map<std::string, std::string> c(m);
+  VERIFY( c == m );
+  c["a"] = "0";
+  VERIFY( c != m );
+
+  flat_hash_map<std::string, std::string> mv(std::move(c));
+  VERIFY( c.empty() && mv.size() == m.size() );
+  c = mv;
+  VERIFY( c == mv );
+  swap(c, m);
+  VERIFY( m == mv );
+
+  m.rehash(10000);
+  VERIFY( m.bucket_count() >= 10000 && m == mv );
+  m.clear();
+  VERIFY( m.empty() && m.begin() == m.end() );
+  m.rehash(0);
+  VERIFY( m.bucket_count() == 0 );
+}
+
+void
+test04()
+{
+  flat_hash_map<int, int> m;
+  m.reserve(1000);
+  const auto n = m.bucket_count();
+  for (int i = 0; i < 1000; ++i)
+    m[i] = i;
+  VERIFY( m.bucket_count() == n );
+
+  m.erase(m.begin(), m.end());
+  VERIFY( m.empty() );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+}
@@ -0,0 +1,87 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/flat_hash_set>
+#include <string>
+#include <testsuite_hooks.h>
+#include <testsuite_allocator.h>
+
+using __gnu_cxx::flat_hash_set;
+
+void
+test01()
+{
+  flat_hash_set<std::string> s = { "one", "two", "three" };
+  VERIFY( s.size() == 3 );
+  VERIFY( !s.insert("two").second );
+  VERIFY( s.insert(std::string("four")).second );
+  VERIFY( s.count("four") == 1 );
+  VERIFY( s.erase("one") == 1 );
+  VERIFY( s.find("one") == s.end() );
+
+  flat_hash_set<std::string> t(s.begin(), s.end());
+  VERIFY( t == s );
+}
+
+void
+test02()
+{
+  // Elements that are only copyable are copied when the table grows.
+  struct X
+  {
+    int i;
+    X(int i) : i(i) { }
+    X(const X& x) : i(x.i) { }
+    bool operator==(const X& x) const { return i == x.i; }
+  };
+  struct H
+  {
+    std::size_t operator()(const X& x) const { return x.i; }
+  };
+
+  flat_hash_set<X, H> s;
+  for (int i = 0; i < 1000; ++i)
+    s.emplace(i);
+  for (int i = 0; i < 1000; ++i)
+    VERIFY( s.count(X(i)) == 1 );
+}
+
+void
+test03()
+{
+  typedef __gnu_test::tracker_allocator<int> alloc_type;
+  typedef __gnu_test::tracker_allocator_counter counter;
+  counter::reset();
+  {
+    flat_hash_set<int, std::hash<int>, std::equal_to<int>, alloc_type> s;
+    for (int i = 0; i < 1000; ++i)
+      s.insert(i);
+    VERIFY( counter::get_allocation_count() != 0 );
+  }
+  VERIFY( counter::get_allocation_count()
+	  == counter::get_deallocation_count() );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
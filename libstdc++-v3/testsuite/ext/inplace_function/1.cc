@@ -0,0 +1,136 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/inplace_function>
+#include <functional>
+#include <string>
+#include <testsuite_hooks.h>
+
+using __gnu_cxx::inplace_function;
+
+int twice(int i) { return 2 * i; }
+
+struct S
+{
+  int m = 5;
+  int get() const { return m; }
+};
+
+int live = 0;
+
+struct Counted
+{
+  Counted() { ++live; }
+  Counted(const Counted&) { ++live; }
+  Counted(Counted&&) noexcept { ++live; }
+  ~Counted() { --live; }
+  int operator()(int i) const { return i + 1; }
+};
+
+void
+test01()
+{
+  inplace_function<int(int)> f;
+  VERIFY( !f );
+  VERIFY( f == nullptr );
+  bool caught = false;
+  try
+    {
+      f(1);
+    }
+  catch (const std::bad_function_call&)
+    {
+      caught = true;
+    }
+  VERIFY( caught );
+
+  f = twice;
+  VERIFY( f(3) == 6 );
+  int (*np)(int) = nullptr;
+  f = np;
+  VERIFY( !f );
+
+  long a = 1, b = 2, c = 3;
+  f = [a, b, c](int i) { return int(a + b + c + i); };
+  VERIFY( f(4) == 10 );
+  inplace_function<int(int)> g = f;
+  VERIFY( g(0) == 6 );
+  VERIFY( f(0) == 6 );
+  inplace_function<int(int)> h = std::move(g);
+  VERIFY( h(1) == 7 );
+  VERIFY( !g );
+
+  inplace_function<int(const S&)> m = &S::get;
+  S s;
+  VERIFY( m(s) == 5 );
+
+  inplace_function<void(int)> v = twice;
+  v(1);
+}
+
+void
+test02()
+{
+  {
+    inplace_function<int(int)> c1 = Counted();
+    VERIFY( live == 1 );
+    inplace_function<int(int)> c2 = c1;
+    VERIFY( live == 2 );
+    c2 = nullptr;
+    VERIFY( live == 1 );
+    c2 = std::move(c1);
+    VERIFY( live == 1 );
+    VERIFY( c2(1) == 2 );
+    VERIFY( !c1 );
+    swap(c1, c2);
+    VERIFY( live == 1 );
+    VERIFY( c1(2) == 3 );
+    VERIFY( !c2 );
+    c2 = c1;
+    c1 = c1;
+    VERIFY( live == 2 );
+  }
+  VERIFY( live == 0 );
+}
+
+void
+test03()
+{
+  // A larger buffer holds a target that the default one would not.
+  std::string str(100, 'x');
+  inplace_function<std::size_t(), 64> f = [str] { return str.size(); };
+  inplace_function<std::size_t(), 64> g = f;
+  VERIFY( f() == 100 );
+  VERIFY( g() == 100 );
+
+  static_assert( !std::is_constructible<inplace_function<int(int)>,
+					std::string>::value,
+		 "target must be callable with the signature" );
+  static_assert( std::is_nothrow_move_constructible<
+		   inplace_function<int(int)>>::value,
+		 "moving never throws" );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,57 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/inplace_function>
+#include <memory>
+#include <testsuite_hooks.h>
+
+using __gnu_cxx::unique_inplace_function;
+
+struct Holder
+{
+  std::unique_ptr<int> p;
+  int operator()() const { return *p; }
+};
+
+void
+test01()
+{
+  static_assert( !std::is_copy_constructible<
+		   unique_inplace_function<int()>>::value,
+		 "move-only wrapper" );
+
+  unique_inplace_function<int()> f = Holder{ std::unique_ptr<int>(new int(42)) };
+  VERIFY( f() == 42 );
+  unique_inplace_function<int()> g = std::move(f);
+  VERIFY( !f );
+  VERIFY( g() == 42 );
+  f = std::move(g);
+  VERIFY( f() == 42 );
+  VERIFY( g == nullptr );
+  swap(f, g);
+  VERIFY( g() == 42 );
+  g = nullptr;
+  VERIFY( !g );
+}
+
+int
+main()
+{
+  test01();
+}
@@ -0,0 +1,106 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// mmap_filebuf.h
+
+// { dg-require-fileio "" }
+
+#include <ext/mmap_filebuf.h>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <cstring>
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+  using __gnu_cxx::mmap_filebuf;
+
+  const char* name = "tmp_mmap_filebuf1";
+  const char* text = "first line\nsecond line\nlast";
+  {
+    ofstream out(name);
+    out << text;
+  }
+
+  mmap_filebuf<char> buf;
+  VERIFY( !buf.is_open() );
+  VERIFY( buf.open(name) == &buf );
+  VERIFY( buf.is_open() );
+  VERIFY( buf.open(name) == 0 );
+  VERIFY( buf.size() == strlen(text) );
+  VERIFY( memcmp(buf.data(), text, buf.size()) == 0 );
+
+  istream in(&buf);
+  string line;
+  VERIFY( getline(in, line) && line == "first line" );
+  VERIFY( in.tellg() == streampos(11) );
+  VERIFY( getline(in, line) && line == "second line" );
+  VERIFY( getline(in, line) && line == "last" );
+  VERIFY( in.eof() );
+  VERIFY( buf.sgetc() == char_traits<char>::eof() );
+
+  in.clear();
+  VERIFY( in.seekg(-4, ios_base::end).tellg() == streampos(23) );
+  VERIFY( buf.sgetc() == 'l' );
+  VERIFY( buf.pubseekoff(1, ios_base::end) == streampos(streamoff(-1)) );
+  VERIFY( buf.pubseekpos(0, ios_base::out) == streampos(streamoff(-1)) );
+  VERIFY( buf.pubseekpos(6) == streampos(6) );
+  char word[4];
+  VERIFY( buf.sgetn(word, 4) == 4 && memcmp(word, "line", 4) == 0 );
+
+  VERIFY( buf.close() == &buf );
+  VERIFY( !buf.is_open() );
+  VERIFY( buf.close() == 0 );
+  VERIFY( buf.sgetc() == char_traits<char>::eof() );
+
+  VERIFY( buf.open(name, ios_base::in | ios_base::ate) == &buf );
+  VERIFY( buf.pubseekoff(0, ios_base::cur) == streampos(27) );
+}
+
+void test02()
+{
+  using namespace std;
+  using __gnu_cxx::mmap_filebuf;
+
+  const char* name = "tmp_mmap_filebuf2";
+  {
+    ofstream out(name);
+  }
+
+  // Empty files are opened but not mapped.
+  mmap_filebuf<char> buf(name);
+  VERIFY( buf.is_open() );
+  VERIFY( buf.size() == 0 );
+  VERIFY( buf.sgetc() == char_traits<char>::eof() );
+
+  // Only input is supported.
+  mmap_filebuf<char> buf2;
+  VERIFY( buf2.open(name, ios_base::out) == 0 );
+  VERIFY( buf2.open(name, ios_base::in | ios_base::out) == 0 );
+  VERIFY( buf2.open("tmp_mmap_filebuf_does_not_exist") == 0 );
+  VERIFY( !buf2.is_open() );
+  VERIFY( buf2.open(".") == 0 );
+}
+
+int main()
+{
+  test01();
+  test02();
+  return 0;
+}
@@ -0,0 +1,52 @@
+// { dg-options "-D_GLIBCXX_PROFILE_SAMPLE_RATE=4" }
+// { dg-do run }
+// { dg-require-profile-mode "" }
+
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include <profile/impl/profiler.h>
+#include <testsuite_hooks.h>
+
+// Only one in _GLIBCXX_PROFILE_SAMPLE_RATE objects gets instrumented.
+void
+test01()
+{
+#if defined _GLIBCXX_HAVE_EXECINFO_H
+  using namespace __gnu_profile;
+
+  int sampled = 0;
+  for (int i = 0; i < 100; ++i)
+    {
+      __container_size_info* info = __trace_vector_size_construct(10);
+      if (info)
+	++sampled;
+      __trace_vector_size_resize(info, 10, 20);
+      __trace_vector_size_destruct(info, 20, 15);
+    }
+
+  VERIFY( sampled == 25 );
+#endif
+}
+
+int
+main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <testsuite_performance.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ext/flat_hash_map>
+
+const int sz = 2000000;
+
+template<typename _Map>
+  void
+  bench(const char* desc, const std::vector<typename _Map::key_type>& keys)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+    std::ostringstream ostr;
+
+    _Map m;
+    start_counters(time, resource);
+    for (int i = 0; i != sz; ++i)
+      m.emplace(keys[i], i);
+    stop_counters(time, resource);
+    ostr << desc << ' ' << sz << " insertions";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+    clear_counters(time, resource);
+
+    // Half of the lookups succeed.  The lookups do not change the map,
+    // so they can be timed over several runs.
+    long found = 0;
+    ostr.str("");
+    ostr << desc << ' ' << sz << " lookups";
+    report_repeated_performance(__FILE__, ostr.str(), [&] {
+	found = 0;
+	for (int i = 0; i != sz; ++i)
+	  found += m.count(keys[i / 2 + (i % 2) * sz]);
+      });
+
+    start_counters(time, resource);
+    for (int i = 0; i != sz; ++i)
+      m.erase(keys[i]);
+    stop_counters(time, resource);
+    ostr.str("");
+    ostr << desc << ' ' << sz << " erasures";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+    if (found != sz / 2)
+      __builtin_abort();
+  }
+
+int
+main()
+{
+  std::vector<unsigned> ikeys(2 * sz);
+  std::vector<std::string> skeys(2 * sz);
+  for (int i = 0; i != 2 * sz; ++i)
+    {
+      // Distinct keys, spread over the whole range.
+      ikeys[i] = unsigned(i) * 2654435761u;
+      skeys[i] = "key" + std::to_string(ikeys[i]);
+    }
+
+  bench<std::unordered_map<unsigned, int>>(
+      "std::unordered_map<unsigned, int>", ikeys);
+  bench<__gnu_cxx::flat_hash_map<unsigned, int>>(
+      "__gnu_cxx::flat_hash_map<unsigned, int>", ikeys);
+  bench<std::unordered_map<std::string, int>>(
+      "std::unordered_map<string, int>", skeys);
+  bench<__gnu_cxx::flat_hash_map<std::string, int>>(
+      "__gnu_cxx::flat_hash_map<string, int>", skeys);
+  return 0;
+}
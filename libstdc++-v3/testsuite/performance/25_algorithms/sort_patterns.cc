@@ -0,0 +1,84 @@
+// Copyright (C) 2017 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <testsuite_performance.h>
+
+// std::sort on inputs other than uniformly random ones.
+
+template<typename Compare>
+  void
+  bench(const char* name, const std::vector<int>& input, Compare comp)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+
+    std::vector<int> v = input;
+    start_counters(time, resource);
+    std::sort(v.begin(), v.end(), comp);
+    stop_counters(time, resource);
+    report_performance(__FILE__, name, time, resource);
+  }
+
+int main()
+{
+  const int max_size = 4000000;
+  std::vector<int> v(max_size);
+
+  // a simple psuedo-random series which does not rely on rand() and friends
+  unsigned r = 0;
+  for (int i = 0; i < max_size; ++i)
+    v[i] = (r = (r + 110211473) * 745988807) % 16;
+  bench("few unique", v, std::less<int>());
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = i < max_size / 2 ? i : max_size - i;
+  bench("organ pipe", v, std::less<int>());
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = i % 1000 ? i : int(r = (r + 110211473) * 745988807);
+  bench("sorted with noise", v, std::less<int>());
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = i % 2 ? i : -i;
+  bench("interleaved", v, std::less<int>());
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = r = (r + 110211473) * 745988807;
+  bench("random", v, std::less<int>());
+  bench("random, greater<>", v, std::greater<int>());
+
+  std::vector<std::string> s;
+  for (int i = 0; i < max_size / 8; ++i)
+    s.push_back(std::to_string(r = (r + 110211473) * 745988807));
+  {
+    using namespace __gnu_test;
+    time_counter time;
+    resource_counter resource;
+    start_counters(time, resource);
+    std::sort(s.begin(), s.end());
+    stop_counters(time, resource);
+    report_performance(__FILE__, "random strings", time, resource);
+  }
+
+  return 0;
+}
@@ -24,10 +24,16 @@
 
 #include <sys/times.h>
 #include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <fstream>
+#include <iostream>
 #include <iomanip>
 #include <typeinfo>
 #include <stdexcept>
@@ -35,6 +41,17 @@
 #include <cxxabi.h>
 #include <testsuite_common_types.h>
 
+#if defined (__linux__) && defined (__has_include)
+# if __has_include(<linux/perf_event.h>)
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <sys/ioctl.h>
+#  ifdef __NR_perf_event_open
+#   define _GLIBCXX_PERFORMANCE_HW_COUNTERS 1
+#  endif
+# endif
+#endif
+
 #if defined (__linux__) || defined (__GLIBC__)
 #include <malloc.h>
 #elif defined (__FreeBSD__)
@@ -72,18 +89,110 @@ extern "C"
 
 namespace __gnu_test
 {
+  // Hardware event counts for this process and the threads it creates,
+  // read through perf_event_open where the kernel allows it.
+  class hardware_counters
+  {
+  public:
+    enum event { cycles, instructions, num_events };
+
+    typedef unsigned long long value_type;
+
+    static hardware_counters&
+    get()
+    {
+      static hardware_counters counters;
+      return counters;
+    }
+
+    // Store the current counts in values, or return false if the
+    // counters are not available.
+    bool
+    read(value_type (&values)[num_events]) const
+    {
+#ifdef _GLIBCXX_PERFORMANCE_HW_COUNTERS
+      for (int i = 0; i < num_events; ++i)
+	if (fd[i] < 0
+	    || ::read(fd[i], &values[i], sizeof(value_type))
+	       != ssize_t(sizeof(value_type)))
+	  return false;
+      return true;
+#else
+      (void) values;
+      return false;
+#endif
+    }
+
+  private:
+    hardware_counters()
+    {
+#ifdef _GLIBCXX_PERFORMANCE_HW_COUNTERS
+      static const unsigned long long config[num_events]
+	= { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS };
+      for (int i = 0; i < num_events; ++i)
+	{
+	  perf_event_attr attr;
+	  memset(&attr, 0, sizeof(attr));
+	  attr.type = PERF_TYPE_HARDWARE;
+	  attr.size = sizeof(attr);
+	  attr.config = config[i];
+	  attr.inherit = 1;
+	  attr.exclude_kernel = 1;
+	  attr.exclude_hv = 1;
+	  fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+#endif
+    }
+
+    ~hardware_counters()
+    {
+#ifdef _GLIBCXX_PERFORMANCE_HW_COUNTERS
+      for (int i = 0; i < num_events; ++i)
+	if (fd[i] >= 0)
+	  close(fd[i]);
+#endif
+    }
+
+    hardware_counters(const hardware_counters&);
+    hardware_counters& operator=(const hardware_counters&);
+
+#ifdef _GLIBCXX_PERFORMANCE_HW_COUNTERS
+    int fd[num_events];
+#endif
+  };
+
   class time_counter
   {
   private:
+    typedef hardware_counters::value_type hw_value;
+
     clock_t	elapsed_begin;
     clock_t	elapsed_end;
     tms		tms_begin;
     tms		tms_end;
+    hw_value	ns_begin;
+    hw_value	ns_end;
+    hw_value	hw_begin[hardware_counters::num_events];
+    hw_value	hw_end[hardware_counters::num_events];
+    bool	hw_valid;
+
+    static hw_value
+    monotonic_ns()
+    {
+#ifdef CLOCK_MONOTONIC
+      timespec ts;
+      if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+	return hw_value(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+#endif
+      tms unused;
+      return hw_value(times(&unused)) * 1000000000ull
+	     / sysconf(_SC_CLK_TCK);
+    }
 
   public:
     explicit
     time_counter() : elapsed_begin(), elapsed_end(), tms_begin(), tms_end()
-    { }
+    { this->clear(); }
 
     void
     clear() throw()
@@ -92,25 +201,34 @@ namespace __gnu_test
       elapsed_end = clock_t();
       tms_begin = tms();
       tms_end = tms();
+      ns_begin = ns_end = 0;
+      memset(hw_begin, 0, sizeof(hw_begin));
+      memset(hw_end, 0, sizeof(hw_end));
+      hw_valid = false;
     }
 
     void
     start()
     {
       this->clear();
+      hw_valid = hardware_counters::get().read(hw_begin);
       elapsed_begin = times(&tms_begin);
       const clock_t err = clock_t(-1);
       if (elapsed_begin == err)
 	std::__throw_runtime_error("time_counter::start");
+      ns_begin = monotonic_ns();
     }
 
     void
     stop()
     {
+      ns_end = monotonic_ns();
       elapsed_end = times(&tms_end);
       const clock_t err = clock_t(-1);
       if (elapsed_end == err)
 	std::__throw_runtime_error("time_counter::stop");
+      if (hw_valid)
+	hw_valid = hardware_counters::get().read(hw_end);
     }
 
     std::size_t
@@ -124,6 +242,30 @@ namespace __gnu_test
     std::size_t
     system_time() const
     { return tms_end.tms_stime - tms_begin.tms_stime; }
+
+    // Elapsed real time in nanoseconds, from a monotonic clock.
+    hw_value
+    real_time_ns() const
+    { return ns_end - ns_begin; }
+
+    // True if cycles() and instructions() hold hardware counts.
+    bool
+    has_hardware_counts() const
+    { return hw_valid; }
+
+    hw_value
+    cycles() const
+    {
+      return (hw_end[hardware_counters::cycles]
+	      - hw_begin[hardware_counters::cycles]);
+    }
+
+    hw_value
+    instructions() const
+    {
+      return (hw_end[hardware_counters::instructions]
+	      - hw_begin[hardware_counters::instructions]);
+    }
   };
 
   class resource_counter
@@ -199,9 +341,156 @@ namespace __gnu_test
     r.clear();
   }
 
+  // Summary of the real times of repeated runs of a benchmark.
+  struct timing_samples
+  {
+    typedef unsigned long long value_type;
+
+    std::vector<value_type> ns;
+
+    value_type
+    min() const
+    { return ns.empty() ? 0 : *std::min_element(ns.begin(), ns.end()); }
+
+    value_type
+    median() const
+    {
+      if (ns.empty())
+	return 0;
+      std::vector<value_type> v(ns);
+      std::sort(v.begin(), v.end());
+      const std::size_t n = v.size();
+      return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    }
+
+    // Median absolute deviation from the median, which unlike the
+    // standard deviation is not thrown off by a few disturbed runs.
+    value_type
+    mad() const
+    {
+      if (ns.empty())
+	return 0;
+      const value_type m = median();
+      timing_samples dev;
+      for (std::size_t i = 0; i < ns.size(); ++i)
+	dev.ns.push_back(ns[i] > m ? ns[i] - m : m - ns[i]);
+      return dev.median();
+    }
+  };
+
+  inline std::string
+  json_escape(const std::string& s)
+  {
+    std::string r;
+    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+      {
+	if (*i == '"' || *i == '\\')
+	  r += '\\';
+	if ((unsigned char)*i < ' ')
+	  {
+	    char buf[8];
+	    std::sprintf(buf, "\\u%04x", (unsigned)(unsigned char)*i);
+	    r += buf;
+	  }
+	else
+	  r += *i;
+      }
+    return r;
+  }
+
+  // Look for the median time of the same test and comment in the file
+  // named by GLIBCXX_PERFORMANCE_BASELINE, as written by an earlier run.
+  // Returns zero when there is no baseline.
+  inline unsigned long long
+  baseline_median_ns(const std::string& testname, const std::string& comment)
+  {
+    const char* name = std::getenv("GLIBCXX_PERFORMANCE_BASELINE");
+    if (!name || !*name)
+      return 0;
+
+    std::ifstream in(name);
+    const std::string key = "{\"test\":\"" + json_escape(testname)
+      + "\",\"comment\":\"" + json_escape(comment) + "\",";
+    const std::string field = "\"median_ns\":";
+    unsigned long long result = 0;
+    std::string line;
+    // Use the last matching record, in case the file has several runs.
+    while (std::getline(in, line))
+      if (line.compare(0, key.size(), key) == 0)
+	{
+	  std::string::size_type pos = line.find(field);
+	  if (pos != std::string::npos)
+	    result = ::strtoull(line.c_str() + pos + field.size(), 0, 10);
+	}
+    return result;
+  }
+
+  // The allowed slowdown relative to the baseline, in percent.
+  inline double
+  regression_threshold()
+  {
+    const char* s = std::getenv("GLIBCXX_PERFORMANCE_THRESHOLD");
+    if (s && *s)
+      return std::strtod(s, 0);
+    return 10.0;
+  }
+
+  // The number of timed runs for report_repeated_performance.
+  inline unsigned
+  repeat_count()
+  {
+    const char* s = std::getenv("GLIBCXX_PERFORMANCE_RUNS");
+    if (s && *s)
+      {
+	unsigned long n = std::strtoul(s, 0, 10);
+	if (n > 0)
+	  return n;
+      }
+    return 5;
+  }
+
+  // Append one JSON record per measurement to libstdc++-performance.json
+  // and compare it with the baseline.  Returns true for a regression.
+  inline bool
+  report_json(const std::string& testname, const std::string& comment,
+	      const time_counter& t, const resource_counter& r,
+	      const timing_samples& samples)
+  {
+    const unsigned long long median = samples.median();
+    const unsigned long long baseline = baseline_median_ns(testname, comment);
+    const bool regression
+      = baseline && median > baseline * (1.0 + regression_threshold() / 100);
+
+    std::ofstream out("libstdc++-performance.json", std::ios_base::app);
+    out << "{\"test\":\"" << json_escape(testname) << "\","
+	<< "\"comment\":\"" << json_escape(comment) << "\","
+	<< "\"runs\":" << samples.ns.size() << ','
+	<< "\"median_ns\":" << median << ','
+	<< "\"min_ns\":" << samples.min() << ','
+	<< "\"mad_ns\":" << samples.mad() << ','
+	<< "\"user_ticks\":" << t.user_time() << ','
+	<< "\"system_ticks\":" << t.system_time() << ','
+	<< "\"memory\":" << r.allocated_memory() << ','
+	<< "\"page_faults\":" << r.hard_page_fault();
+    if (t.has_hardware_counts())
+      out << ",\"cycles\":" << t.cycles()
+	  << ",\"instructions\":" << t.instructions();
+    if (baseline)
+      out << ",\"baseline_ns\":" << baseline
+	  << ",\"regression\":" << (regression ? "true" : "false");
+    out << '}' << std::endl;
+
+    if (regression)
+      std::cerr << "performance regression: " << testname << ": " << comment
+		<< ": " << median << "ns, baseline " << baseline << "ns"
+		<< std::endl;
+    return regression;
+  }
+
   void
   report_performance(const std::string file, const std::string comment,
-		     const time_counter& t, const resource_counter& r)
+		     const time_counter& t, const resource_counter& r,
+		     const timing_samples& samples)
   {
     const char space = ' ';
     const char tab = '\t';
@@ -216,6 +505,8 @@ namespace __gnu_test
       testname.append("-thread");
 #endif
 
+    const bool regression = report_json(testname, comment, t, r, samples);
+
     out.setf(std::ios_base::left);
     out << std::setw(25) << testname << tab;
     out << std::setw(25) << comment << tab;
@@ -226,11 +517,50 @@ namespace __gnu_test
     out << std::setw(4) << t.system_time() << "s" << space;
     out << std::setw(8) << r.allocated_memory() << "mem" << space;
     out << std::setw(4) << r.hard_page_fault() << "pf" << space;
+    if (regression)
+      out << "REGRESSION";
 
     out << std::endl;
     out.close();
   }
 
+  void
+  report_performance(const std::string file, const std::string comment,
+		     const time_counter& t, const resource_counter& r)
+  {
+    timing_samples samples;
+    samples.ns.push_back(t.real_time_ns());
+    report_performance(file, comment, t, r, samples);
+  }
+
+  /**
+   *  Run __f once to warm up, then time GLIBCXX_PERFORMANCE_RUNS more
+   *  runs of it (five by default) and report the median.  The other
+   *  columns of the summary are for the last run.  __f must do the same
+   *  work every time it is called.
+   */
+  template<typename _Func>
+    void
+    report_repeated_performance(const std::string file,
+				const std::string comment, _Func __f)
+    {
+      time_counter time;
+      resource_counter resource;
+      timing_samples samples;
+
+      __f();
+      const unsigned runs = repeat_count();
+      for (unsigned n = 0; n < runs; ++n)
+	{
+	  clear_counters(time, resource);
+	  start_counters(time, resource);
+	  __f();
+	  stop_counters(time, resource);
+	  samples.ns.push_back(time.real_time_ns());
+	}
+      report_performance(file, comment, time, resource, samples);
+    }
+
   void
   report_header(const std::string file, const std::string header)
   {
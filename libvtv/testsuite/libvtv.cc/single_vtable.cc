@@ -0,0 +1,51 @@
+// { dg-do run }
+
+// Virtual calls through classes whose vtable map holds a single
+// vtable take the inline singleton check, the others call into the
+// library.  Make sure both kinds of call sites work.
+
+#include <stdlib.h>
+
+struct Leaf
+{
+  virtual int get () { return 1; }
+};
+
+struct Base
+{
+  virtual int get () { return 2; }
+};
+
+struct Derived : Base
+{
+  virtual int get () { return 3; }
+};
+
+__attribute__ ((noinline)) int
+call_leaf (Leaf *l)
+{
+  return l->get ();
+}
+
+__attribute__ ((noinline)) int
+call_base (Base *b)
+{
+  return b->get ();
+}
+
+int
+main ()
+{
+  Leaf l;
+  Base b;
+  Derived d;
+  int sum = 0;
+
+  for (int i = 0; i < 100; i++)
+    sum += call_leaf (&l) + call_base (&b) + call_base (&d);
+
+  if (sum != 600)
+    abort ();
+
+  return 0;
+}
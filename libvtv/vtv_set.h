@@ -364,7 +364,9 @@ class insert_only_hash_sets
     { return (uintptr_t) s & 1; }
 
     /* Return the representation of a singleton set containing the
-       given key.  */
+       given key.  The compiler's vtable verification pass checks
+       this encoding inline before calling __VLTVerifyVtablePointer,
+       so it must not change.  */
     static insert_only_hash_set *
     singleton_key (key_type key)
     { return (insert_only_hash_set *) ((uintptr_t) key + 1); }
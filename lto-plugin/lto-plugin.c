@@ -159,6 +159,7 @@ static ld_plugin_add_symbols add_symbols;
 
 static struct plugin_file_info *claimed_files = NULL;
 static unsigned int num_claimed_files = 0;
+static unsigned int num_claimed_files_alloc = 0;
 
 /* List of files with offloading.  */
 static struct plugin_offload_file *offload_files;
@@ -374,6 +375,7 @@ free_2 (void)
   free (claimed_files);
   claimed_files = NULL;
   num_claimed_files = 0;
+  num_claimed_files_alloc = 0;
 
   while (offload_files)
     {
@@ -893,7 +895,9 @@ resolve_conflicts (struct plugin_symtab *t, struct plugin_symtab *conflicts)
   htab_delete (symtab);
 }
 
-/* Process one section of an object file.  */
+/* Process one section of an object file: read the symbol table if it
+   is an LTO symbol table section, and note whether it is an offload
+   section, so that a single walk over the sections is enough.  */
 
 static int 
 process_symtab (void *data, const char *name, off_t offset, off_t length)
@@ -902,6 +906,12 @@ process_symtab (void *data, const char *name, off_t offset, off_t length)
   char *s;
   char *secdatastart, *secdata;
 
+  if (!strncmp (name, OFFLOAD_SECTION, OFFLOAD_SECTION_LEN))
+    {
+      obj->offload = 1;
+      return 1;
+    }
+
   if (strncmp (name, LTO_SECTION_PREFIX, LTO_SECTION_PREFIX_LEN) != 0)
     return 1;
 
@@ -944,21 +954,6 @@ err:
   return 0;
 }
 
-/* Find an offload section of an object file.  */
-
-static int
-process_offload_section (void *data, const char *name, off_t offset, off_t len)
-{
-  if (!strncmp (name, OFFLOAD_SECTION, OFFLOAD_SECTION_LEN))
-    {
-      struct plugin_objfile *obj = (struct plugin_objfile *) data;
-      obj->offload = 1;
-      return 0;
-    }
-
-  return 1;
-}
-
 /* Callback used by gold to check if the plugin will claim FILE. Writes
    the result in CLAIMED. */
 
@@ -1018,10 +1013,6 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
       goto err;
     }
 
-  if (obj.objfile)
-    simple_object_find_sections (obj.objfile, process_offload_section,
-				 &obj, &err);
-
   if (obj.found == 0 && obj.offload == 0)
     goto err;
 
@@ -1034,10 +1025,16 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
 			    lto_file.symtab.syms);
       check (status == LDPS_OK, LDPL_FATAL, "could not add symbols");
 
+      /* Grow geometrically; archives can have thousands of members.  */
+      if (num_claimed_files == num_claimed_files_alloc)
+	{
+	  num_claimed_files_alloc = num_claimed_files_alloc * 2 + 16;
+	  claimed_files =
+	    xrealloc (claimed_files,
+		      num_claimed_files_alloc
+		      * sizeof (struct plugin_file_info));
+	}
       num_claimed_files++;
-      claimed_files =
-	xrealloc (claimed_files,
-		  num_claimed_files * sizeof (struct plugin_file_info));
       claimed_files[num_claimed_files - 1] = lto_file;
 
       *claimed = 1;